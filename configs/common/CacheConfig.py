@@ -43,8 +43,44 @@
 
 import m5
 from m5.objects import *
+from m5.util import fatal
 from Caches import *
 
+def partition_cpu(cpu, index, bus, latency):
+    """Put a core, its private caches and everything else below it in
+    the hierarchy on event queue 'index', and connect its cached ports
+    to the shared bus (on queue 0) through queue bridges."""
+
+    if cpu._uncached_slave_ports or cpu._uncached_master_ports:
+        fatal("Event queue partitioning can't bridge the interrupt "
+              "controller ports of %s" % cpu)
+
+    cpu.eventq_index = index
+
+    bridges = []
+    for p in cpu._cached_ports:
+        bridge = QueueBridge(eventq_index=0, delay=latency)
+        exec('cpu.%s = bridge.slave' % p)
+        bridge.master = bus.slave
+        bridges.append(bridge)
+    cpu.eventq_bridges = bridges
+
+def check_partition(options, system):
+    """The queue bridges don't forward snoops, so partitioned cores
+    must not share memory."""
+
+    seen = set()
+    for cpu in system.cpu:
+        for process in cpu.workload:
+            if id(process) in seen:
+                fatal("Event queue partitioning needs one process per core;"
+                      " cores sharing a process aren't kept coherent")
+            seen.add(id(process))
+
+    if options.fast_forward or options.standard_switch or \
+       options.repeat_switch or options.roi_symbol:
+        fatal("Event queue partitioning does not support CPU switching")
+
 def config_cache(options, system):
     if options.cpu_type == "arm_detailed":
         try:
@@ -69,7 +105,8 @@ def config_cache(options, system):
         # bytes (256 bits).
         system.l2 = l2_cache_class(clk_domain=system.cpu_clk_domain,
                                    size=options.l2_size,
-                                   assoc=options.l2_assoc)
+                                   assoc=options.l2_assoc,
+                                   bulk_writeback=options.bulk_writeback)
 
         system.tol2bus = CoherentXBar(clk_domain = system.cpu_clk_domain,
                                       width = 32)
@@ -79,12 +116,17 @@ def config_cache(options, system):
     if options.memchecker:
         system.memchecker = MemChecker()
 
+    # Only the last level may write straight into memory
+    l1_bulk_writeback = options.bulk_writeback and not options.l2cache
+
     for i in xrange(options.num_cpus):
         if options.caches:
             icache = icache_class(size=options.l1i_size,
-                                  assoc=options.l1i_assoc)
+                                  assoc=options.l1i_assoc,
+                                  bulk_writeback=l1_bulk_writeback)
             dcache = dcache_class(size=options.l1d_size,
-                                  assoc=options.l1d_assoc)
+                                  assoc=options.l1d_assoc,
+                                  bulk_writeback=l1_bulk_writeback)
 
             if options.memchecker:
                 dcache_mon = MemCheckerMonitor(warn_only=True)
@@ -117,9 +159,16 @@ def config_cache(options, system):
                 system.cpu[i].dcache_mon = dcache_mon
 
         system.cpu[i].createInterruptController()
-        if options.l2cache:
+        if options.eventq_partition:
+            bus = system.tol2bus if options.l2cache else system.membus
+            partition_cpu(system.cpu[i], i + 1, bus,
+                          options.partition_latency)
+        elif options.l2cache:
             system.cpu[i].connectAllPorts(system.tol2bus, system.membus)
         else:
             system.cpu[i].connectAllPorts(system.membus)
 
+    if options.eventq_partition:
+        check_partition(options, system)
+
     return system
@@ -0,0 +1,288 @@
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Classification of fault injection runs.
+#
+# A golden (fault-free) run records a signature: the target's exit code,
+# a digest of everything it wrote to stdout/stderr, an optional digest
+# of a memory region and the instructions and ticks it took.  A fault
+# run is compared against that signature when its simulation ends and
+# classified as
+#
+#   masked  the target exited like the golden run did
+#   sdc     the target exited normally but its output or memory differs
+#   crash   the target exited with a different code, or the simulator
+#           stopped for any reason other than the ones below
+#   hang    the run outlived the watchdog (a multiple of the golden
+#           run's instruction count and ticks)
+#
+# One JSON line is appended per run to the results file, so campaign
+# results can be read without keeping each run's output directory.
+
+import json
+import os
+
+import m5
+from m5.objects import BaseCPU
+from m5.util import fatal
+
+OUTCOMES = ('masked', 'sdc', 'crash', 'hang', 'detected')
+
+WATCHDOG_CAUSE = "fault run watchdog expired"
+
+# Cause of a cache ECC model stopping the run on an uncorrectable error
+ECC_CAUSE = "uncorrectable cache error"
+
+def isFaultRun(options):
+    return bool(options.FItarget or options.fi_structure or
+                options.fi_fetch_seq_num)
+
+def parseRegion(region):
+    """Parse an '<addr>:<size>' memory region, either part in any base
+    int() accepts with a prefix (e.g. 0x1000:4096)."""
+
+    try:
+        addr, size = region.split(':')
+        return (int(addr, 0), int(size, 0))
+    except ValueError:
+        fatal("Bad --fi-digest-region '%s', expected <addr>:<size>", region)
+
+def checkOptions(options):
+    """Sanity check the outcome options and make the result paths
+    absolute, so that they survive the output directory changing under
+    forked campaign runs."""
+
+    if options.fi_record_signature and not options.fi_signature:
+        fatal("--fi-record-signature needs --fi-signature")
+    if options.fi_record_signature and options.fi_campaign:
+        fatal("--fi-record-signature cannot be combined with --fi-campaign:"
+              " campaign runs need the signature before the golden run ends")
+    if options.fi_results and not options.fi_signature:
+        fatal("--fi-results needs the golden --fi-signature to classify"
+              " runs against")
+    if options.fi_watchdog_factor < 1.0:
+        fatal("--fi-watchdog-factor must be at least 1")
+
+    if options.fi_signature:
+        options.fi_signature = os.path.abspath(options.fi_signature)
+    if options.fi_results:
+        options.fi_results = os.path.abspath(options.fi_results)
+
+def loadSignature(options):
+    """Golden signature the runs of this simulation are classified
+    against, or None if there is none to compare with."""
+
+    if not options.fi_signature or options.fi_record_signature:
+        return None
+    if not os.path.exists(options.fi_signature):
+        fatal("Golden signature %s not found, record it with"
+              " --fi-record-signature", options.fi_signature)
+    return json.load(open(options.fi_signature))
+
+def watchdogTick(options, signature, maxtick):
+    """Tick limit for a fault run: the golden run's ticks scaled by the
+    watchdog factor, capped at maxtick."""
+
+    if not signature:
+        return maxtick
+    return min(maxtick, long(signature["ticks"] * options.fi_watchdog_factor))
+
+def armWatchdog(options, signature, cpu):
+    """Stop the simulation once cpu has committed the watchdog factor
+    times the golden run's instruction count.  A fault that sends the
+    target into an endless loop is then reported as a hang long before
+    the run would reach maxtick."""
+
+    if not signature:
+        return
+    limit = long(signature["insts"] * options.fi_watchdog_factor)
+    remaining = max(limit - cpu.totalInsts(), 1)
+    cpu.scheduleInstStop(0, remaining, WATCHDOG_CAUSE)
+
+def activeCpu(system):
+    """The CPU of system that is running the target, i.e. the first one
+    that is not switched out."""
+
+    for obj in system.descendants():
+        if isinstance(obj, BaseCPU) and not obj.switchedOut():
+            return obj
+    fatal("No active CPU in %s", system.path())
+
+def digests(options, cpu):
+    """(output digest, memory digest) of the process running on cpu."""
+
+    process = cpu.workload[0]
+    mem_digest = None
+    if options.fi_digest_region:
+        addr, size = parseRegion(options.fi_digest_region)
+        mem_digest = process.memoryDigest(addr, size)
+    return (process.outputDigest(), mem_digest)
+
+def recordSignature(options, cpu, exit_event):
+    """Write the golden signature of a fault-free run that just ended."""
+
+    if exit_event.getCause() != "target called exit()":
+        fatal("Golden run ended because '%s', not recording a signature",
+              exit_event.getCause())
+
+    output_digest, mem_digest = digests(options, cpu)
+    signature = {
+        "exit_code": exit_event.getCode(),
+        "output_digest": output_digest,
+        "memory_digest": mem_digest,
+        "memory_region": options.fi_digest_region,
+        "insts": cpu.totalInsts(),
+        "ticks": m5.curTick(),
+    }
+    with open(options.fi_signature, "w") as f:
+        json.dump(signature, f, sort_keys=True)
+        f.write("\n")
+    print "Recorded golden signature in %s" % options.fi_signature
+
+def classify(options, signature, cpu, exit_event):
+    """Outcome of a fault run that just ended."""
+
+    cause = exit_event.getCause()
+    if cause == "fault masked":
+        return "masked"
+    if cause in (WATCHDOG_CAUSE, "simulate() limit reached"):
+        return "hang"
+    if cause == ECC_CAUSE:
+        return "detected"
+    if cause != "target called exit()":
+        return "crash"
+    if exit_event.getCode() != signature["exit_code"]:
+        return "crash"
+
+    if signature.get("memory_region") != options.fi_digest_region:
+        fatal("Golden signature digests region %s, not --fi-digest-region %s",
+              signature.get("memory_region"), options.fi_digest_region)
+    output_digest, mem_digest = digests(options, cpu)
+    if output_digest != signature["output_digest"] or \
+       mem_digest != signature["memory_digest"]:
+        return "sdc"
+    return "masked"
+
+def appendRecord(options, record):
+    """Append one JSON line to the results file.  The line is written
+    with a single write() on an O_APPEND descriptor so that concurrent
+    campaign runs do not interleave their records."""
+
+    line = json.dumps(record, sort_keys=True) + "\n"
+    fd = os.open(options.fi_results, os.O_WRONLY | os.O_APPEND | os.O_CREAT,
+                 0644)
+    try:
+        os.write(fd, line)
+    finally:
+        os.close(fd)
+
+def runRecord(options, run_id, target, target_reg, structure=None,
+              index=None, bit=None):
+    """The fields identifying a fault run in its result record.  The
+    structure fault defaults to that of the --fi-structure or
+    --fi-fetch-* options."""
+
+    if structure is None and options.fi_structure:
+        structure = options.fi_structure
+        index = options.fi_index
+        bit = options.fi_bit
+    elif structure is None and options.fi_fetch_seq_num:
+        structure = "fetch." + options.fi_fetch_field
+        index = options.fi_fetch_seq_num
+        bit = options.fi_fetch_bit
+    return {
+        "run_id": run_id,
+        "config": m5.configHash(),
+        "seed": options.fi_seed,
+        "target": target,
+        "target_reg": target_reg,
+        "structure": structure,
+        "index": index,
+        "bit": bit,
+    }
+
+def tagCampaignStats(record):
+    """Identify the run of record in the --campaign-dir stats it appends
+    from now on."""
+
+    if m5.options.campaign_dir:
+        m5.stats.setCampaignTag(json.dumps(record, sort_keys=True))
+
+def valueDivergence(cpu):
+    """Where the run's committed values first departed from the golden
+    run's (see --fi-value-interval), or None."""
+
+    if not getattr(cpu, "valueTraceInterval", 0):
+        return None
+    report = cpu.valueDivergence()
+    return json.loads(report) if report else None
+
+def finishRun(options, signature, cpu, exit_event, record):
+    """Classify and record a run that just ended.  record identifies the
+    run (see runRecord) and is None for a fault-free run, which records
+    the golden signature if asked to.  Returns the outcome, or None if
+    the run was not classified."""
+
+    if record is None:
+        if options.fi_record_signature:
+            recordSignature(options, cpu, exit_event)
+        return None
+    if signature is None:
+        return None
+
+    outcome = classify(options, signature, cpu, exit_event)
+    print "**** FAULT OUTCOME: %s ****" % outcome
+    if options.fi_results:
+        record = dict(record)
+        record.update({
+            "outcome": outcome,
+            "cause": exit_event.getCause(),
+            "exit_code": exit_event.getCode(),
+            "tick": m5.curTick(),
+            "insts": cpu.totalInsts(),
+            "divergence": valueDivergence(cpu),
+        })
+        appendRecord(options, record)
+    return outcome
+
+def recordLostRun(options, record, status):
+    """Record a forked campaign run that died (e.g. in fatal() or
+    panic()) before it could record its own outcome."""
+
+    if not options.fi_results:
+        return
+    record = dict(record)
+    if os.WIFSIGNALED(status):
+        cause = "killed by signal %d" % os.WTERMSIG(status)
+    else:
+        cause = "simulator exited with status %d" % os.WEXITSTATUS(status)
+    record.update({
+        "outcome": "crash",
+        "cause": cause,
+        "exit_code": None,
+        "tick": None,
+        "insts": None,
+    })
+    appendRecord(options, record)
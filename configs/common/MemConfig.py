@@ -54,8 +54,7 @@ _mem_aliases_all = [
     ("lpddr2_s4_1066_x32", "LPDDR2_S4_1066_x32"),
     ("lpddr3_1600_x32", "LPDDR3_1600_x32"),
     ("wio_200_x128", "WideIO_200_x128"),
-    ("dramsim2", "DRAMSim2"),
-    ("ruby_memory", "RubyMemoryControl")
+    ("dramsim2", "DRAMSim2")
     ]
 
 # Filtered list of aliases. Only aliases for existing memory
@@ -217,11 +216,40 @@ def config_mem(options, system):
             if issubclass(cls, m5.objects.DRAMCtrl) and \
                     options.mem_ranks:
                 mem_ctrl.ranks_per_channel = options.mem_ranks
+            if issubclass(cls, m5.objects.DRAMCtrl) and \
+                    options.mem_idle_refresh_batch:
+                mem_ctrl.idle_refresh_batch = options.mem_idle_refresh_batch
 
             mem_ctrls.append(mem_ctrl)
 
     system.mem_ctrls = mem_ctrls
 
     # Connect the controllers to the membus
-    for i in xrange(len(system.mem_ctrls)):
-        system.mem_ctrls[i].port = system.membus.master
+    if getattr(options, "mem_channel_eventqs", False):
+        partition_mem_ctrls(options, system)
+    else:
+        for i in xrange(len(system.mem_ctrls)):
+            system.mem_ctrls[i].port = system.membus.master
+
+def partition_mem_ctrls(options, system):
+    """
+    Put every memory controller on an event queue of its own, after
+    the ones used by --eventq-partition, and connect it to the membus
+    (on queue 0) through a queue bridge. Memory controllers are never
+    snooped, so the bridges keep the system coherent.
+    """
+
+    first_eventq = 1
+    if getattr(options, "eventq_partition", False):
+        first_eventq += len(system.cpu)
+
+    bridges = []
+    for i, ctrl in enumerate(system.mem_ctrls):
+        ctrl.eventq_index = first_eventq + i
+        bridge = m5.objects.QueueBridge(eventq_index = ctrl.eventq_index,
+                                        slave_eventq_index = 0,
+                                        delay = options.partition_latency)
+        bridge.slave = system.membus.master
+        ctrl.port = bridge.master
+        bridges.append(bridge)
+    system.mem_bridges = bridges
@@ -86,6 +86,134 @@ def addCommonOptions(parser):
                 help = "The source register of the instruction that we want to inject fault on that")
     parser.add_option("--MaxTick", type="long", default="0",
                 help = "Maximum tick, this is used for fault injection")
+    parser.add_option("--fi-seed", type="long", default=0,
+                      help="Campaign seed for fault injection's random"
+                      " choices")
+    parser.add_option("--fi-run-id", type="long", default=0,
+                      help="Run ID within the campaign. A run is"
+                      " reproduced by its seed and run ID")
+    parser.add_option("--fi-structure", type="string", default=None,
+                      help="CPU structure to inject into through the"
+                      " FaultInjector, e.g. int_regs, float_regs, cc_regs"
+                      " (MinorCPU) or phys_int_regs, rob, iq, lq, sq,"
+                      " rename_int (O3CPU), or the absolute path of a cache"
+                      " or memory array, e.g. system.cpu.dcache.data,"
+                      " system.l2.tags, system.mem_ctrls.array, or of the"
+                      " garnet routers or links, e.g."
+                      " system.ruby.network.routers (flit corruption),"
+                      " system.ruby.network.links_drop (packet loss)")
+    parser.add_option("--cache-ecc", type="choice", default="none",
+                      choices=["none", "parity", "secded"],
+                      help="Error protection of the cache data arrays")
+    parser.add_option("--fi-index", type="int", default=-1,
+                      help="Entry of --fi-structure, -1 for random")
+    parser.add_option("--fi-bit", type="int", default=-1,
+                      help="Bit of the --fi-structure entry, -1 for random")
+    parser.add_option("--fi-trigger-seq-num", type="long", default=0,
+                      help="Inject into --fi-structure when this execute"
+                      " sequence number commits")
+    parser.add_option("--fi-trigger-tick", type="long", default=0,
+                      help="Inject into --fi-structure at this tick")
+    parser.add_option("--fi-trace", type="string", default=None,
+                      help="Write fault injection events of each MinorCPU"
+                      " to <cpu>.<file> as a protobuf trace, gzipped if"
+                      " the name ends in .gz. Decode with"
+                      " util/decode_fault_trace.py")
+    parser.add_option("--exec-trace-binary", type="string", default=None,
+                      help="Write every committed instruction to this file"
+                      " as a binary trace instead of the text Exec trace,"
+                      " gzipped if the name ends in .gz. Decode with"
+                      " util/decode_exec_trace.py")
+    parser.add_option("--fi-fetch-seq-num", type="long", default=0,
+                      help="Corrupt the MinorCPU instruction with this fetch"
+                      " sequence number as Fetch2 extracts it")
+    parser.add_option("--fi-fetch-field", type="choice", default="inst",
+                      choices=["inst", "pc"],
+                      help="Flip a bit of the fetched instruction word or of"
+                      " the instruction's PC for --fi-fetch-seq-num")
+    parser.add_option("--fi-fetch-bit", type="int", default=-1,
+                      help="Bit of --fi-fetch-field to flip, -1 for random")
+    parser.add_option("--fi-batch-size", type="int", default=1,
+                      help="Inject this many faults (at most 64) in one run,"
+                      " each with its own outcome in fault_outcomes.txt")
+    parser.add_option("--fi-batch-spacing", type="long", default=0,
+                      help="Seqnums or ticks between the faults of a batch")
+    parser.add_option("--fi-convergence-interval", type="long", default=0,
+                      help="Hash architectural state every N committed"
+                      " instructions and stop injection runs as 'fault"
+                      " masked' once it matches the golden run's")
+    parser.add_option("--fi-convergence-trace", type="string",
+                      default="convergence.txt",
+                      help="Golden run state hash trace for"
+                      " --fi-convergence-interval. Recorded into the output"
+                      " directory, read from this path when checking")
+    parser.add_option("--fi-convergence-record", action="store_true",
+                      default=False,
+                      help="Record the state hash trace (golden run)")
+    parser.add_option("--fi-value-interval", type="long", default=0,
+                      help="Digest the values committed by each N"
+                      " instructions and report where injection runs first"
+                      " diverge from the golden run's digests (MinorCPU)")
+    parser.add_option("--fi-value-trace", type="string",
+                      default="value_trace.bin",
+                      help="Golden run value digest trace for"
+                      " --fi-value-interval. Recorded into the output"
+                      " directory, read from this path when checking")
+    parser.add_option("--fi-value-record", action="store_true",
+                      default=False,
+                      help="Record the value digest trace (golden run)")
+    parser.add_option("--ace-analysis", action="store_true", default=False,
+                      help="Measure register ACE intervals into stats and"
+                      " ace_summary.bin (MinorCPU)")
+    parser.add_option("--protection-eval", action="store_true",
+                      default=False,
+                      help="Split committed ops, cycles, FU and LSQ"
+                      " occupancy and ACE cycles between original,"
+                      " duplicate and checker instructions (MinorCPU,"
+                      " with --ace-analysis for the ACE coverage)")
+    parser.add_option("--protection-annotations", type="string",
+                      default="",
+                      help="File of 'start end class' hex address ranges"
+                      " for --protection-eval")
+    parser.add_option("--protection-symbol", action="append", default=[],
+                      help="'symbol=class' function classified as a whole"
+                      " for --protection-eval (repeatable)")
+    parser.add_option("--fi-restore-nearest", action="store_true",
+                      default=False,
+                      help="Restore the newest cpt.<tick> checkpoint taken"
+                      " at or before --FItarget (a tick) instead of"
+                      " simulating the fault-free prefix")
+    parser.add_option("--fi-campaign", type="string", default=None,
+                      help="File of '<FItarget> <FItargetReg>' or '<seqnum>"
+                      " <index> <structure> <bit>' lines. The golden run"
+                      " forks one child per line and each child injects"
+                      " that fault")
+    parser.add_option("--fi-campaign-jobs", type="int", default=1,
+                      help="Number of campaign children run at once")
+    parser.add_option("--fi-fork-lead", type="long", default=1000,
+                      help="Ticks before each campaign target to fork at")
+    parser.add_option("--fi-campaign-queue", action="store_true",
+                      default=False,
+                      help="Treat --fi-campaign as a work queue shared with"
+                      " other simulators, see util/fi_campaign.py")
+    parser.add_option("--fi-signature", type="string", default=None,
+                      help="Golden run signature (exit code, output and"
+                      " memory digests, length) that fault runs are"
+                      " classified against")
+    parser.add_option("--fi-record-signature", action="store_true",
+                      default=False,
+                      help="Record --fi-signature from this (fault-free)"
+                      " run instead of reading it")
+    parser.add_option("--fi-digest-region", type="string", default=None,
+                      help="<addr>:<size> of target memory to include in"
+                      " the signature, e.g. the program's result buffer")
+    parser.add_option("--fi-watchdog-factor", type="float", default=2.0,
+                      help="Report a fault run as a hang once it has run"
+                      " this many times the golden run's instructions or"
+                      " ticks")
+    parser.add_option("--fi-results", type="string", default=None,
+                      help="Append one JSON line with the outcome of each"
+                      " fault run to this file")
     # Memory Options
     parser.add_option("--list-mem-types",
                       action="callback", callback=_listMemTypes,
@@ -95,8 +223,15 @@ def addCommonOptions(parser):
                       help = "type of memory to use")
     parser.add_option("--mem-channels", type="int", default=1,
                       help = "number of memory channels")
+    parser.add_option("--mem-channel-eventqs", action="store_true",
+                      help = "simulate each memory channel on its own event"
+                      " queue and host thread, bridged to the memory bus"
+                      " with a latency of --partition-latency bus cycles")
     parser.add_option("--mem-ranks", type="int", default=None,
                       help = "number of memory ranks per channel")
+    parser.add_option("--mem-idle-refresh-batch", type="int", default=0,
+                      help = "account for this many DRAM refreshes per"
+                      " event while all cores are quiesced")
     parser.add_option("--mem-size", action="store", type="string",
                       default="512MB",
                       help="Specify the physical memory size (single memory)")
@@ -122,6 +257,10 @@ def addCommonOptions(parser):
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
     parser.add_option("--cacheline_size", type="int", default=64)
+    parser.add_option("--bulk-writeback", action="store_true",
+                      help="Write the dirty lines of the last-level cache "
+                      "straight into memory when draining for a "
+                      "checkpoint or a CPU switch")
 
     # Enable Ruby
     parser.add_option("--ruby", action="store_true")
@@ -159,12 +298,28 @@ def addCommonOptions(parser):
                       help="Enable basic block profiling for SimPoints")
     parser.add_option("--simpoint-interval", type="int", default=10000000,
                       help="SimPoint interval in num of instructions")
+    parser.add_option("--simpoint-binary", action="store_true",
+                      help="Write SimPoint BBVs in the binary format "
+                           "(see util/simpoint_bbv.py)")
     parser.add_option("--take-simpoint-checkpoints", action="store", type="string",
         help="<simpoint file,weight file,interval-length,warmup-length>")
     parser.add_option("--restore-simpoint-checkpoint", action="store_true",
         help="restore from a simpoint checkpoint taken with " +
              "--take-simpoint-checkpoints")
 
+    # Sampled simulation options
+    parser.add_option("--smarts", action="store", type="string",
+        help="sample with <measure,warmup,fast-forward> instructions "
+             "per unit, fast-forwarding on an atomic CPU and measuring "
+             "on --cpu-type")
+    parser.add_option("--smarts-samples", action="store", type="int",
+        default=0, help="stop sampling after <N> samples")
+    parser.add_option("--smarts-confidence", action="store", type="float",
+        default=0.997, help="confidence level of the reported CPI interval")
+    parser.add_option("--smarts-simpoints", action="store", type="string",
+        help="measure the weighted simpoints from <simpoint file,weight "
+             "file,interval-length> instead of sampling systematically")
+
     #SWIFTR moslem
     parser.add_option("--SWIFTR", type="choice", default="no",
                 choices = ["yes","no"],
@@ -173,6 +328,12 @@ def addCommonOptions(parser):
     parser.add_option("--ZDCR", type="choice", default="no",
                 choices = ["yes","no"],
                 help = "program is ZDCR protected")
+    parser.add_option("--SWIFTR-master-regs", type="string", default=None,
+                help = "Mask of the SWIFTR master registers, bit n for"
+                " register n and bit 43 for SP")
+    parser.add_option("--ZDCR-master-regs", type="string", default=None,
+                help = "Mask of the ZDCR master registers, bit n for"
+                " register n and bit 43 for SP")
 
     # Checkpointing options
     ###Note that performing checkpointing via python script files will override
@@ -204,6 +365,12 @@ def addCommonOptions(parser):
     parser.add_option("--repeat-switch", action="store", type="int",
         default=None,
         help="switch back and forth between CPUs with period <N>")
+    parser.add_option("--warm-bpred", action="store_true",
+        help="train the branch predictor of the detailed CPU while "
+             "fast-forwarding")
+    parser.add_option("--fast-switch", action="store_true",
+        help="only drain the CPUs, not the memory system, when "
+             "switching between CPUs with the same memory mode")
     parser.add_option("-s", "--standard-switch", action="store", type="int",
         default=None,
         help="switch from timing to Detailed CPU after warmup period of <N>")
@@ -219,6 +386,70 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_option("--roi-symbol", action="store", type="string",
+        default=None,
+        help="Fast forward with the atomic CPU until the workload first"
+             " reaches this symbol (e.g. main), then switch to --cpu-type")
+    parser.add_option("--roi-exit-symbol", action="store", type="string",
+        default=None,
+        help="Switch back to the atomic CPU when the workload reaches this"
+             " symbol (e.g. exit) after --roi-symbol")
+    parser.add_option("--roi-functions", action="store", type="string",
+        default=None,
+        help="Comma separated functions making up the region of interest"
+             " for fault injection and per-function stats: names, prefixes"
+             " ending in '*' or 're:' regular expressions (default:"
+             " main,FUNC*)")
+    parser.add_option("--region-stats", action="store", type="string",
+        default=None,
+        help="Write the change in every stat over each --roi-functions"
+             " function, and over all the code outside them, to this file"
+             " at exit")
+    parser.add_option("--eventq-backend", type="choice",
+        default="LinkedList", choices=["LinkedList", "TimingWheel"],
+        help="Data structure for the main event queues; TimingWheel scales"
+             " better with many pending events [default: %default]")
+    parser.add_option("--eventq-profile", action="store_true", default=False,
+        help="Write the host time spent on the events of each SimObject to"
+             " eventq_profile.txt, and as flame graph input to"
+             " eventq_profile.folded, at exit")
+    parser.add_option("--host-mem-stats", action="store_true", default=False,
+        help="Report the host memory taken by the tables of each SimObject"
+             " as hostMem stats, and sorted by size in host_mem.txt at exit")
+    parser.add_option("--sim-quantum-adaptive", action="store_true",
+        default=False,
+        help="Adapt the quantum of multi-eventq simulations to the host"
+             " time spent in its barriers, reported in root.quantum stats."
+             " With --sim-quantum-max above the shortest cross-queue"
+             " latency the results depend on host timing and are not"
+             " reproducible; the quanta are logged to quantum_log.txt")
+    parser.add_option("--sim-quantum-replay", type="string", default="",
+        help="Reuse the quanta of an earlier run's quantum_log.txt"
+             " instead of adapting, which reproduces its results")
+    parser.add_option("--sim-quantum-max", type="string", default=None,
+        help="Longest adaptive quantum, e.g. 10ns. Work crossing event"
+             " queues faster is delayed by at most this much [default: the"
+             " shortest cross-queue latency, which delays no work]")
+    parser.add_option("--sim-threads", type="int", default=0,
+        help="Host threads simulating the event queues. With fewer"
+             " threads than queues, idle threads steal queues from busy"
+             " ones [default: one thread per queue]")
+    parser.add_option("--telemetry", action="store_true", default=False,
+        help="Publish the progress of the run as JSON lines on"
+             " telemetry.sock in the output directory")
+    parser.add_option("--telemetry-interval", type="float", default=1.0,
+        help="Host seconds between --telemetry samples [default: %default]")
+    parser.add_option("--eventq-partition", action="store_true",
+        help="Simulate each core and its private caches on its own event"
+             " queue and host thread, bridged to the shared bus. The"
+             " simulation quantum is picked from the bridge latency."
+             " Cores must run separate processes. With Ruby, put each"
+             " router and the controllers attached to it on its own"
+             " queue, synchronized by the links between routers")
+    parser.add_option("--partition-latency", type="int", default=1,
+        help="Latency of the bridges added by --eventq-partition, in CPU"
+             " cycles, and by --mem-channel-eventqs, in memory bus cycles;"
+             " longer latencies allow a longer quantum [default: %default]")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
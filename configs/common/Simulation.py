@@ -44,6 +44,7 @@ from os import getcwd
 from os.path import join as joinpath
 
 import CpuConfig
+import FIOutcome
 import MemConfig
 
 import m5
@@ -78,13 +79,24 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.roi_symbol or options.smarts:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
 
     return (TmpClass, test_mem_mode, CPUClass)
 
+def warmBranchPredictor(fast_cpu, detailed_cpu):
+    """Share the branch predictor of detailed_cpu with fast_cpu, so
+    that the predictors, BTB and RAS are trained by the branches the
+    fast CPU commits while fast-forwarding."""
+    bpred = getattr(detailed_cpu, "branchPred", None)
+    if not isinstance(fast_cpu, BaseSimpleCPU) or \
+            not isinstance(bpred, BranchPredictor):
+        fatal("--warm-bpred needs a simple CPU fast-forwarding for a CPU "
+              "with a branch predictor")
+    fast_cpu.branchPred = bpred
+
 def setMemClass(options):
     """Returns a memory controller class."""
 
@@ -197,6 +209,368 @@ def findCptDir(options, cptdir, testsys):
 
     return cpt_starttick, checkpoint_dir
 
+def setFICheckpointRestore(options):
+    """Point --checkpoint-restore at the newest cpt.<tick> checkpoint
+    taken at or before the fault injection target.
+
+    Fault-free prefixes are identical for every injection run, so a
+    golden run taking periodic checkpoints (--take-checkpoints) lets
+    each injection start from the closest one.  This must be called
+    before setCPUClass() as the chosen number decides the restore CPU.
+    """
+
+    from os.path import isdir
+    from os import listdir
+    import re
+
+    if not options.fi_restore_nearest:
+        return
+
+    if options.checkpoint_restore != None:
+        fatal("--fi-restore-nearest and --checkpoint-restore are exclusive")
+
+    if options.checkpoint_dir:
+        cptdir = options.checkpoint_dir
+    else:
+        cptdir = getcwd()
+
+    if not isdir(cptdir):
+        fatal("checkpoint dir %s does not exist!", cptdir)
+
+    expr = re.compile('cpt\.([0-9]+)$')
+    cpts = []
+    for dir in listdir(cptdir):
+        match = expr.match(dir)
+        if match:
+            cpts.append(long(match.group(1)))
+    cpts.sort()
+
+    earlier = [ tick for tick in cpts if tick <= options.FItarget ]
+    if not earlier:
+        warn("No checkpoint at or before tick %d, simulating from the start",
+             options.FItarget)
+        return
+
+    # findCptDir() counts checkpoints from 1 in tick order
+    options.checkpoint_restore = len(earlier)
+    print "Fault target %d restoring checkpoint at tick %d" % \
+        (options.FItarget, earlier[-1])
+
+def faultSitePath(cpu_name, structure):
+    """Registered name of a --fi-structure: structures of the CPU are
+    relative to it, cache and memory arrays are given by their absolute
+    path (e.g. system.cpu.dcache.data)."""
+
+    if structure.startswith("system."):
+        return structure
+    return "%s.%s" % (cpu_name, structure)
+
+def setFaultInjector(options, cpu, cpu_name):
+    """Configure the FaultInjector of cpu, named cpu_name in the system,
+    from the --fi-* options.  CPU models without an injector are left
+    alone."""
+
+    if not hasattr(cpu, "faultInjector"):
+        return
+
+    if options.fi_trace and hasattr(cpu, "faultTrace"):
+        cpu.faultTrace = "%s.%s" % (cpu_name, options.fi_trace)
+
+    fi = cpu.faultInjector
+    fi.seed = options.fi_seed
+    fi.run_id = options.fi_run_id
+    if m5.options.campaign_dir:
+        # the campaign results record the outcomes instead
+        fi.outcomes_file = ""
+    if options.fi_structure:
+        fi.structure = faultSitePath(cpu_name, options.fi_structure)
+        fi.index = options.fi_index
+        fi.bit = options.fi_bit
+        fi.trigger_seq_num = options.fi_trigger_seq_num
+        fi.trigger_tick = options.fi_trigger_tick
+        fi.batch_size = options.fi_batch_size
+        fi.batch_spacing = options.fi_batch_spacing
+
+def setMemoryFaultSites(options, system):
+    """Register the caches and memories of system as fault sites with
+    the FaultInjector of each CPU, and give the caches the --cache-ecc
+    model.  The routers and links of a garnet network register with the
+    injector given a --fi-structure, or else that of the first CPU.  Call
+    after the caches, memories and network are configured."""
+
+    sites = [obj for obj in system.descendants()
+             if isinstance(obj, (BaseCache, AbstractMemory))]
+    for obj in sites:
+        if isinstance(obj, BaseCache):
+            obj.ecc = options.cache_ecc
+    injectors = []
+    for cpu in system.descendants():
+        if isinstance(cpu, BaseCPU) and hasattr(cpu, "faultInjector"):
+            cpu.faultInjector.memory_sites = sites
+            injectors.append(cpu.faultInjector)
+    injectors = [fi for fi in injectors if fi.structure] or injectors
+    if injectors:
+        for network in system.descendants():
+            if hasattr(network, "fault_injector"):
+                network.fault_injector = injectors[0]
+
+def setDetailedCpuOptions(options, cpu, cpu_name):
+    """Apply the fault injection and analysis options to cpu, named
+    cpu_name in the system.  Options the CPU model has no parameters for
+    are skipped, so this can be applied to the fast-forwarding CPU as well
+    as to the detailed one it switches to."""
+
+    if hasattr(cpu, "FItarget"):
+        cpu.FItarget = options.FItarget
+        cpu.FItargetReg = options.FItargetReg
+        cpu.MaxTick = options.MaxTick
+    if hasattr(cpu, "fetchFaultSeqNum") and options.fi_fetch_seq_num:
+        cpu.fetchFaultSeqNum = options.fi_fetch_seq_num
+        cpu.fetchFaultField = options.fi_fetch_field
+        cpu.fetchFaultBit = options.fi_fetch_bit
+    setFaultInjector(options, cpu, cpu_name)
+    if options.exec_trace_binary:
+        cpu.tracer = ExeTracer(binary_file=options.exec_trace_binary)
+    if hasattr(cpu, "convergenceInterval") and \
+       options.fi_convergence_interval:
+        cpu.convergenceInterval = options.fi_convergence_interval
+        cpu.convergenceTrace = options.fi_convergence_trace
+        cpu.convergenceRecord = options.fi_convergence_record
+    if hasattr(cpu, "valueTraceInterval") and options.fi_value_interval:
+        cpu.valueTraceInterval = options.fi_value_interval
+        cpu.valueTrace = options.fi_value_trace
+        cpu.valueTraceRecord = options.fi_value_record
+    if hasattr(cpu, "aceAnalysis") and options.ace_analysis:
+        cpu.aceAnalysis = True
+    if hasattr(cpu, "protectionEval") and options.protection_eval:
+        cpu.protectionEval = True
+        cpu.protectionAnnotations = options.protection_annotations
+        cpu.protectionSymbols = options.protection_symbol
+    if hasattr(cpu, "enableSWIFTR"):
+        cpu.enableSWIFTR = options.SWIFTR
+        cpu.enableZDCR = options.ZDCR
+        if options.SWIFTR_master_regs:
+            cpu.swiftMasterRegs = int(options.SWIFTR_master_regs, 0)
+        if options.ZDCR_master_regs:
+            cpu.zdcMasterRegs = int(options.ZDCR_master_regs, 0)
+
+# Exit causes of the --roi-symbol and --roi-exit-symbol stops
+ROI_ENTER_CAUSE = "region of interest entered"
+ROI_EXIT_CAUSE = "region of interest exited"
+
+def fastForwardToRoi(options, testsys, switch_cpu_list):
+    """Run the fast-forwarding CPUs until --roi-symbol, then switch to the
+    detailed ones and, with --roi-exit-symbol, arrange to stop when the
+    region of interest is left."""
+
+    testsys.cpu[0].scheduleSymbolStop(options.roi_symbol, ROI_ENTER_CAUSE)
+    print "Switch at symbol:%s" % options.roi_symbol
+    exit_event = m5.simulate()
+    if exit_event.getCause() != ROI_ENTER_CAUSE:
+        fatal("Workload ended before reaching --roi-symbol %s (%s)",
+              options.roi_symbol, exit_event.getCause())
+    print "Switched CPUS @ tick %s" % (m5.curTick())
+
+    m5.switchCpus(testsys, switch_cpu_list)
+    if options.roi_exit_symbol:
+        testsys.cpu[0].scheduleSymbolStop(options.roi_exit_symbol,
+                                          ROI_EXIT_CAUSE)
+
+def leaveRoi(options, testsys, switch_cpu_list, exit_event, maxtick):
+    """If the detailed simulation stopped at --roi-exit-symbol, switch
+    back to the fast-forwarding CPUs and run the workload to its end."""
+
+    if exit_event.getCause() != ROI_EXIT_CAUSE:
+        return exit_event
+
+    print "Left the region of interest @ tick %s" % (m5.curTick())
+    m5.switchCpus(testsys, [(new, old) for (old, new) in switch_cpu_list])
+    return m5.simulate(maxtick - m5.curTick())
+
+def parseFICampaign(filename):
+    """Read the faults of a campaign file, one per line, either as
+
+        <FItarget> <FItargetReg>
+
+    for the MinorCPU register fault of --FItarget (a tick), or as
+
+        <seqnum> <index> <structure> <bit>
+
+    for a FaultInjector fault in entry index of a --fi-structure,
+    injected when the instruction with execute seqnum <seqnum> commits.
+    An index or bit of -1 is chosen at random.  Blank lines and lines
+    starting with # are ignored.  Faults are returned as (target, reg,
+    structure, bit) tuples, structure None for MinorCPU faults, sorted by
+    target.  A campaign can't mix the two kinds."""
+
+    targets = []
+    for lineno, line in enumerate(open(filename)):
+        line = line.split('#', 1)[0].strip()
+        if not line:
+            continue
+        fields = line.split()
+        if len(fields) == 2:
+            targets.append((long(fields[0]), long(fields[1]), None, None))
+        elif len(fields) == 4:
+            targets.append((long(fields[0]), int(fields[1]), fields[2],
+                            int(fields[3])))
+        else:
+            fatal("%s:%d: expected '<FItarget> <FItargetReg>' or"
+                  " '<seqnum> <index> <structure> <bit>'",
+                  filename, lineno + 1)
+
+    if len(set(structure is None for _, _, structure, _ in targets)) > 1:
+        fatal("%s: can't mix MinorCPU and structure faults", filename)
+
+    targets.sort()
+    return targets
+
+def claimFITask(queue):
+    """Claim the next fault of the shared campaign file queue.  The
+    claim counter lives in <queue>.next and is updated under a POSIX
+    lock, so any number of simulators, on any hosts sharing the file
+    system, can pull faults from one queue."""
+
+    import fcntl
+    import os
+
+    fd = os.open(queue + ".next", os.O_RDWR | os.O_CREAT, 0644)
+    try:
+        fcntl.lockf(fd, fcntl.LOCK_EX)
+        text = os.read(fd, 32).strip()
+        claimed = int(text) if text else 0
+        os.lseek(fd, 0, os.SEEK_SET)
+        os.ftruncate(fd, 0)
+        os.write(fd, "%d\n" % (claimed + 1))
+    finally:
+        os.close(fd)
+    return claimed
+
+def runFICampaign(options, maxtick, testsys, signature):
+    """Run the golden (fault-free) simulation and fork one injection run
+    off it for each campaign fault.
+
+    Every child inherits the whole simulator state at the fork point, so
+    the fault-free prefix is simulated only once however many faults are
+    injected.  MinorCPU faults fork just before their target tick.
+    Structure faults have seqnum triggers, which can't be mapped to a
+    tick in advance, so they all fork from the state the simulator was
+    started in (e.g. a restored checkpoint).  Children write their
+    output to fi.<n> under the golden run's output directory and exit
+    when their simulation ends.  Child n injects the nth fault of the
+    campaign file and uses run ID --fi-run-id + n.  At most
+    --fi-campaign-jobs children run at once.
+
+    With --fi-campaign-queue the campaign file is a work queue shared
+    with other simulators (see claimFITask and util/fi_campaign.py):
+    faults are claimed one at a time and the simulator exits, without
+    finishing the golden run, once the queue is empty.
+
+    With --fi-results, each child classifies its run against signature,
+    records the outcome and exits with status 0.  A child that exits
+    with any other status died before recording its outcome and the
+    golden run records it as a crash.
+    """
+
+    import os
+
+    targets = parseFICampaign(options.fi_campaign)
+    children = {}
+    exit_event = None
+
+    def reap(pid, status):
+        seq, record = children.pop(pid)
+        if status != 0 and options.fi_results:
+            warn("Fault injection %d died, recording a crash", seq)
+            FIOutcome.recordLostRun(options, record, status)
+
+    def tasks():
+        if not options.fi_campaign_queue:
+            for task in enumerate(targets):
+                yield task
+            return
+        while True:
+            seq = claimFITask(options.fi_campaign)
+            if seq >= len(targets):
+                return
+            yield (seq, targets[seq])
+
+    for seq, (target, target_reg, structure, bit) in tasks():
+        if structure is None:
+            if target <= m5.curTick():
+                warn("Fault target %d already passed, skipping", target)
+                continue
+
+            fork_tick = max(target - options.fi_fork_lead, m5.curTick())
+            if fork_tick > m5.curTick():
+                exit_event = m5.simulate(fork_tick - m5.curTick())
+                if exit_event.getCause() != "simulate() limit reached":
+                    warn("Golden run ended before fault target %d", target)
+                    break
+                exit_event = None
+
+        while len(children) >= options.fi_campaign_jobs:
+            reap(*os.wait())
+
+        if structure is None:
+            record = FIOutcome.runRecord(options, options.fi_run_id + seq,
+                                         target, target_reg)
+        else:
+            record = FIOutcome.runRecord(options, options.fi_run_id + seq,
+                                         target, None, structure,
+                                         target_reg, bit)
+
+        pid = m5.fork(joinpath("%(parent)s", "fi.%d" % seq))
+        if pid == 0:
+            cpu = FIOutcome.activeCpu(testsys)
+            root = Root.getInstance()
+            for obj in root.descendants():
+                if isinstance(obj, MinorCPU) and structure is None:
+                    obj.retargetFault(target, target_reg)
+                elif isinstance(obj, FaultInjector):
+                    obj.reseed(options.fi_seed, options.fi_run_id + seq)
+            if structure is None:
+                print "**** FAULT INJECTION %d: target %d reg %d ****" % \
+                    (seq, target, target_reg)
+            else:
+                if not hasattr(cpu, "faultInjector"):
+                    fatal("%s has no FaultInjector for %s faults",
+                          cpu.path(), structure)
+                cpu.faultInjector.retarget(
+                    faultSitePath(cpu.path(), structure), target_reg, bit,
+                    target)
+                print "**** FAULT INJECTION %d: seqnum %d %s[%d] bit %d" \
+                    " ****" % (seq, target, structure, target_reg, bit)
+
+            FIOutcome.tagCampaignStats(record)
+            FIOutcome.armWatchdog(options, signature, cpu)
+            child_maxtick = FIOutcome.watchdogTick(options, signature,
+                                                   maxtick)
+            exit_event = m5.simulate(child_maxtick - m5.curTick())
+            print 'Exiting @ tick %i because %s' % \
+                (m5.curTick(), exit_event.getCause())
+            if FIOutcome.finishRun(options, signature, cpu, exit_event,
+                                   record) and options.fi_results:
+                sys.exit(0)
+            sys.exit(exit_event.getCode())
+
+        children[pid] = (seq, record)
+
+    if options.fi_campaign_queue:
+        for pid in children.keys():
+            reap(*os.waitpid(pid, 0))
+        print "**** FAULT QUEUE EMPTY ****"
+        sys.exit(0)
+
+    if exit_event is None:
+        print "**** GOLDEN RUN ****"
+        exit_event = m5.simulate(maxtick - m5.curTick())
+
+    for pid in children.keys():
+        reap(*os.waitpid(pid, 0))
+
+    return exit_event
+
 def scriptCheckpoints(options, maxtick, cptdir):
     if options.at_instruction or options.simpoint:
         checkpoint_inst = int(options.take_checkpoints)
@@ -276,26 +650,11 @@ def benchCheckpoints(options, maxtick, cptdir):
 
     return exit_event
 
-# Set up environment for taking SimPoint checkpoints
-# Expecting SimPoint files generated by SimPoint 3.2
-def parseSimpointAnalysisFile(options, testsys):
+# Read the (interval, weight) pairs from SimPoint 3.2 analysis files
+def readSimpoints(simpoint_filename, weight_filename):
     import re
 
-    simpoint_filename, weight_filename, interval_length, warmup_length = \
-        options.take_simpoint_checkpoints.split(",", 3)
-    print "simpoint analysis file:", simpoint_filename
-    print "simpoint weight file:", weight_filename
-    print "interval length:", interval_length
-    print "warmup length:", warmup_length
-
-    interval_length = int(interval_length)
-    warmup_length = int(warmup_length)
-
-    # Simpoint analysis output starts interval counts with 0.
     simpoints = []
-    simpoint_start_insts = []
-
-    # Read in SimPoint analysis files
     simpoint_file = open(simpoint_filename)
     weight_file = open(weight_filename)
     while True:
@@ -317,6 +676,30 @@ def parseSimpointAnalysisFile(options, testsys):
         else:
             fatal('unrecognized line in simpoint weight file!')
 
+        simpoints.append((interval, weight))
+
+    return simpoints
+
+# Set up environment for taking SimPoint checkpoints
+# Expecting SimPoint files generated by SimPoint 3.2
+def parseSimpointAnalysisFile(options, testsys):
+
+    simpoint_filename, weight_filename, interval_length, warmup_length = \
+        options.take_simpoint_checkpoints.split(",", 3)
+    print "simpoint analysis file:", simpoint_filename
+    print "simpoint weight file:", weight_filename
+    print "interval length:", interval_length
+    print "warmup length:", warmup_length
+
+    interval_length = int(interval_length)
+    warmup_length = int(warmup_length)
+
+    # Simpoint analysis output starts interval counts with 0.
+    simpoints = []
+    simpoint_start_insts = []
+
+    for interval, weight in readSimpoints(simpoint_filename,
+                                          weight_filename):
         if (interval * interval_length - warmup_length > 0):
             starting_inst_count = \
                 interval * interval_length - warmup_length
@@ -401,7 +784,8 @@ def restoreSimpointCheckpoint():
     print 'Exiting @ tick %i because %s' % (m5.curTick(), exit_cause)
     sys.exit(exit_event.getCode())
 
-def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
+def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq,
+                 fast_switch=False):
     print "starting switch loop"
     while True:
         exit_event = m5.simulate(switch_freq)
@@ -410,7 +794,8 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
         if exit_cause != "simulate() limit reached":
             return exit_event
 
-        m5.switchCpus(testsys, repeat_switch_cpu_list)
+        m5.switchCpus(testsys, repeat_switch_cpu_list,
+                      drain_memory=not fast_switch)
 
         tmp_cpu_list = []
         for old_cpu, new_cpu in repeat_switch_cpu_list:
@@ -421,6 +806,157 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def parseSmarts(options):
+    """Returns the (measurement, warmup, fast-forward) lengths in
+    instructions of a sampling unit, and the list of (start
+    instruction, weight) of the samples to measure, which is None when
+    sampling systematically."""
+    try:
+        unit, warmup, ffwd = [int(x) for x in options.smarts.split(",")]
+    except ValueError:
+        fatal("--smarts must be <measure,warmup,fast-forward>")
+    if unit <= 0 or warmup < 0 or ffwd < 0:
+        fatal("Bad --smarts lengths %s", options.smarts)
+
+    if not options.smarts_simpoints:
+        return (unit, warmup, ffwd, None)
+
+    try:
+        simpoint_filename, weight_filename, interval_length = \
+            options.smarts_simpoints.split(",")
+        interval_length = int(interval_length)
+    except ValueError:
+        fatal("--smarts-simpoints must be <simpoint file,weight file,"
+              "interval-length>")
+
+    samples = sorted((interval * interval_length, weight)
+                     for interval, weight in readSimpoints(simpoint_filename,
+                                                           weight_filename))
+    return (unit, warmup, ffwd, samples)
+
+def _normalQuantile(p):
+    """Inverse of the standard normal CDF by bisection."""
+    import math
+    lo, hi = -10.0, 10.0
+    for i in xrange(100):
+        mid = (lo + hi) / 2
+        if 0.5 * (1 + math.erf(mid / math.sqrt(2))) < p:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+def reportSamples(options, samples):
+    """Print and write to smarts.txt the CPI of each sample and the
+    mean CPI with its confidence interval.  Samples are (start
+    instruction, weight, instructions, cycles) tuples; weighted
+    (SimPoint) samples report the weighted mean instead."""
+    import math
+
+    if not samples:
+        warn("No samples were measured")
+        return
+
+    cpis = [cycles / float(insts) for start, weight, insts, cycles
+            in samples]
+    weights = [weight for start, weight, insts, cycles in samples]
+    total_weight = sum(weights)
+    mean = sum(w * c for w, c in zip(weights, cpis)) / total_weight
+    n = len(samples)
+
+    lines = []
+    for i, (start, weight, insts, cycles) in enumerate(samples):
+        lines.append("sample %d: start %d weight %g insts %d cycles %d "
+                     "cpi %.6f" % (i, start, weight, insts, cycles, cpis[i]))
+    if options.smarts_simpoints:
+        lines.append("weighted CPI over %d simpoints: %.6f" % (n, mean))
+    elif n > 1:
+        var = sum((c - mean) ** 2 for c in cpis) / (n - 1)
+        z = _normalQuantile(0.5 + options.smarts_confidence / 2)
+        half = z * math.sqrt(var / n)
+        lines.append("CPI over %d samples: %.6f +- %.6f (%.4f%% at %g "
+                     "confidence), coefficient of variation %.4f" %
+                     (n, mean, half, 100 * half / mean,
+                      options.smarts_confidence, math.sqrt(var) / mean))
+    else:
+        lines.append("CPI over 1 sample: %.6f" % mean)
+
+    out = open(joinpath(m5.options.outdir, "smarts.txt"), "w")
+    for line in lines:
+        print line
+        print >>out, line
+    out.close()
+
+def runSampled(options, testsys, switch_cpu_list, maxtick):
+    """Sampled simulation in the style of SMARTS.
+
+    The fast CPUs (AtomicSimpleCPU, warming the caches) run up to some
+    instructions before each sample, then the detailed CPUs run the
+    detailed warmup and measure a unit.  The stats are dumped for each
+    measured unit.  Instructions are counted on the first CPU.
+    """
+    unit, warmup, ffwd, weighted = parseSmarts(options)
+    fast_cpu, detailed_cpu = switch_cpu_list[0]
+    period = detailed_cpu.clk_domain.clock[0].getValue()
+
+    def insts():
+        return fast_cpu.totalInsts() + detailed_cpu.totalInsts()
+
+    def runFor(cpu, n, cause):
+        if n <= 0:
+            return None
+        cpu.scheduleInstStop(0, n, cause)
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        if exit_event.getCause() != cause:
+            return exit_event
+        return None
+
+    def starts():
+        if weighted is not None:
+            for start, weight in weighted:
+                yield start, weight
+            return
+        start = ffwd + warmup
+        while True:
+            yield start, 1.0
+            start += ffwd + warmup + unit
+
+    samples = []
+    exit_event = None
+    for start, weight in starts():
+        if options.smarts_samples and len(samples) >= options.smarts_samples:
+            break
+        if start < insts():
+            warn("Sample at instruction %d already passed, skipping", start)
+            continue
+
+        exit_event = runFor(fast_cpu, start - warmup - insts(),
+                            "smarts fast-forward")
+        if exit_event:
+            break
+
+        m5.switchCpus(testsys, switch_cpu_list, verbose=False)
+        exit_event = runFor(detailed_cpu, start - insts(), "smarts warmup")
+        if not exit_event:
+            m5.stats.reset()
+            start_tick = m5.curTick()
+            start_insts = insts()
+            exit_event = runFor(detailed_cpu, unit, "smarts measure")
+            m5.stats.dump()
+            if not exit_event:
+                samples.append((start_insts, weight, insts() - start_insts,
+                                (m5.curTick() - start_tick) / period))
+        m5.switchCpus(testsys, [(new, old) for (old, new) in switch_cpu_list],
+                      verbose=False)
+        if exit_event:
+            break
+
+    reportSamples(options, samples)
+
+    if exit_event is None:
+        exit_event = m5.simulate(maxtick - m5.curTick())
+    return exit_event
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -432,6 +968,15 @@ def run(options, root, testsys, cpu_class):
     if options.fast_forward and options.checkpoint_restore != None:
         fatal("Can't specify both --fast-forward and --checkpoint-restore")
 
+    if options.roi_symbol and options.checkpoint_restore != None:
+        fatal("Can't specify both --roi-symbol and --checkpoint-restore")
+
+    if options.roi_exit_symbol and not options.roi_symbol:
+        fatal("--roi-exit-symbol needs --roi-symbol")
+
+    if options.roi_exit_symbol and options.fi_campaign:
+        fatal("Can't specify both --roi-exit-symbol and --fi-campaign")
+
     if options.standard_switch and not options.caches:
         fatal("Must specify --caches when using --standard-switch")
 
@@ -441,6 +986,23 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.smarts:
+        if options.fast_forward or options.roi_symbol or \
+                options.standard_switch or options.repeat_switch or \
+                options.take_checkpoints or options.take_simpoint_checkpoints \
+                or options.fi_campaign:
+            fatal("--smarts can't be combined with other switching, "
+                  "checkpointing or fault injection options")
+        if options.checkpoint_restore != None and \
+                options.restore_with_cpu != "atomic":
+            fatal("--smarts needs --restore-with-cpu=atomic")
+        if not cpu_class:
+            fatal("--smarts needs a detailed --cpu-type")
+    elif options.smarts_simpoints:
+        fatal("--smarts-simpoints needs --smarts")
+
+    FIOutcome.checkOptions(options)
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -468,9 +1030,16 @@ def run(options, root, testsys, cpu_class):
             # Add checker cpu if selected
             if options.checker:
                 switch_cpus[i].addCheckerCpu()
+            # Let the fast CPU train the detailed CPU's predictor
+            if options.warm_bpred:
+                warmBranchPredictor(testsys.cpu[i], switch_cpus[i])
 
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in xrange(np)]
+        for i in xrange(np):
+            setDetailedCpuOptions(options, switch_cpus[i],
+                "system.switch_cpus%s" % ("" if np == 1 else "%d" % i))
+        setMemoryFaultSites(options, testsys)
 
     if options.repeat_switch:
         switch_class = getCPUClass(options.cpu_type)[0]
@@ -576,6 +1145,17 @@ def run(options, root, testsys, cpu_class):
     if options.take_simpoint_checkpoints != None:
         simpoints, interval_length = parseSimpointAnalysisFile(options, testsys)
 
+    root.eventq_backend = options.eventq_backend
+    root.eventq_profile = options.eventq_profile
+    root.host_mem_stats = options.host_mem_stats
+    root.sim_quantum_adaptive = options.sim_quantum_adaptive
+    root.sim_quantum_replay = options.sim_quantum_replay
+    if options.sim_quantum_max:
+        root.sim_quantum_max = options.sim_quantum_max
+    root.sim_threads = options.sim_threads
+    if options.telemetry:
+        root.telemetry = Telemetry(interval=options.telemetry_interval)
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
@@ -616,7 +1196,11 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if cpu_class and options.roi_symbol:
+        if options.fast_forward:
+            fatal("Can't specify both --fast-forward and --roi-symbol")
+        fastForwardToRoi(options, testsys, switch_cpu_list)
+    elif (options.standard_switch or cpu_class) and not options.smarts:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -646,6 +1230,14 @@ def run(options, root, testsys, cpu_class):
                     (testsys.switch_cpus_1[0].max_insts_any_thread)
             m5.switchCpus(testsys, switch_cpu_list1)
 
+    # Fault runs are stopped by the watchdog and classified against the
+    # golden run's signature when they end
+    signature = FIOutcome.loadSignature(options)
+    if FIOutcome.isFaultRun(options):
+        maxtick = FIOutcome.watchdogTick(options, signature, maxtick)
+        FIOutcome.armWatchdog(options, signature,
+                              FIOutcome.activeCpu(testsys))
+
     # If we're taking and restoring checkpoints, use checkpoint_dir
     # option only for finding the checkpoints to restore from.  This
     # lets us test checkpointing by restoring from one set of
@@ -673,6 +1265,15 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint != None:
         restoreSimpointCheckpoint()
 
+    # Fork fault injection runs off the golden run
+    elif options.fi_campaign != None:
+        exit_event = runFICampaign(options, maxtick, testsys, signature)
+
+    # Sampled simulation
+    elif options.smarts:
+        print "**** SAMPLED SIMULATION ****"
+        exit_event = runSampled(options, testsys, switch_cpu_list, maxtick)
+
     else:
         if options.fast_forward:
             m5.stats.reset()
@@ -682,11 +1283,24 @@ def run(options, root, testsys, cpu_class):
         # will occur in the benchmark code it self.
         if options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
-                                      maxtick, options.repeat_switch)
+                                      maxtick, options.repeat_switch,
+                                      options.fast_switch)
         else:
             exit_event = benchCheckpoints(options, maxtick, cptdir)
 
+        if cpu_class and options.roi_exit_symbol:
+            exit_event = leaveRoi(options, testsys, switch_cpu_list,
+                                  exit_event, maxtick)
+
     print 'Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause())
+    record = None
+    if FIOutcome.isFaultRun(options):
+        record = FIOutcome.runRecord(options, options.fi_run_id,
+                                     options.FItarget, options.FItargetReg)
+        FIOutcome.tagCampaignStats(record)
+    FIOutcome.finishRun(options, signature, FIOutcome.activeCpu(testsys),
+                        exit_event, record)
+
     if options.checkpoint_at_end:
         m5.checkpoint(joinpath(cptdir, "cpt.%d"))
 
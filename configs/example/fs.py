@@ -198,8 +198,9 @@ def build_test_system(np):
                 fatal("You cannot use fastmem in combination with caches!")
 
         if options.simpoint_profile:
-            if not options.fastmem:
-                # Atomic CPU checked with fastmem option already
+            if not options.fastmem and TestCPUClass != MinorCPU:
+                # Atomic CPU checked with fastmem option already, the minor
+                # CPU profiles with its own timing
                 fatal("SimPoint generation should be done with atomic cpu and fastmem")
             if np > 1:
                 fatal("SimPoint generation not supported with more than one CPUs")
@@ -208,7 +209,8 @@ def build_test_system(np):
             if options.fastmem:
                 test_sys.cpu[i].fastmem = True
             if options.simpoint_profile:
-                test_sys.cpu[i].addSimPointProbe(options.simpoint_interval)
+                test_sys.cpu[i].addSimPointProbe(options.simpoint_interval,
+                                                 options.simpoint_binary)
             if options.checker:
                 test_sys.cpu[i].addCheckerCpu()
             test_sys.cpu[i].createThreads()
@@ -161,6 +161,7 @@ else:
     sys.exit(1)
 
 
+Simulation.setFICheckpointRestore(options)
 (CPUClass, test_mem_mode, FutureClass) = Simulation.setCPUClass(options)
 CPUClass.numThreads = numThreads
 
@@ -173,6 +174,11 @@ system = System(cpu = [CPUClass(cpu_id=i) for i in xrange(np)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(options.mem_size)],
                 cache_line_size = options.cacheline_size)
+if options.roi_functions:
+    system.roi_functions = options.roi_functions.split(",")
+if options.region_stats:
+    system.region_stats = StatsRegionController(
+        file_name = options.region_stats)
 
 # Create a top-level voltage domain
 system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
@@ -211,8 +217,9 @@ if options.fastmem:
         fatal("You cannot use fastmem in combination with caches!")
 
 if options.simpoint_profile:
-    if not options.fastmem:
-        # Atomic CPU checked with fastmem option already
+    if not options.fastmem and CPUClass != MinorCPU:
+        # Atomic CPU checked with fastmem option already, the minor
+        # CPU profiles with its own timing
         fatal("SimPoint generation should be done with atomic cpu and fastmem")
     if np > 1:
         fatal("SimPoint generation not supported with more than one CPUs")
@@ -229,16 +236,15 @@ for i in xrange(np):
         system.cpu[i].fastmem = True
 
     if options.simpoint_profile:
-        system.cpu[i].addSimPointProbe(options.simpoint_interval)
+        system.cpu[i].addSimPointProbe(options.simpoint_interval,
+                                       options.simpoint_binary)
 
     if options.checker:
         system.cpu[i].addCheckerCpu()
-    system.cpu[i].FItarget  = options.FItarget #moselme ///Fault injection
-    system.cpu[i].FItargetReg = options.FItargetReg #moselme ///Fault injection
-    system.cpu[i].MaxTick =options.MaxTick #moselme ///Fault injection
+    Simulation.setDetailedCpuOptions(options, system.cpu[i],
+        "system.cpu%s" % ("" if np == 1 else "%d" % i))
     system.cpu[i].createThreads()
-system.cpu[i].enableSWIFTR = options.SWIFTR #moslem
-system.cpu[i].enableZDCR = options.ZDCR  #moslem
+
 if options.ruby:
     if not (options.cpu_type == "detailed" or options.cpu_type == "timing"):
         print >> sys.stderr, "Ruby requires TimingSimpleCPU or O3CPU!!"
@@ -272,6 +278,7 @@ else:
     system.system_port = system.membus.slave
     CacheConfig.config_cache(options, system)
     MemConfig.config_mem(options, system)
+    Simulation.setMemoryFaultSites(options, system)
 
 root = Root(full_system = False, system = system)
 Simulation.run(options, root, system, FutureClass)
@@ -173,6 +173,11 @@ system = System(cpu = [CPUClass(cpu_id=i) for i in xrange(np)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(options.mem_size)],
                 cache_line_size = options.cacheline_size)
+if options.roi_functions:
+    system.roi_functions = options.roi_functions.split(",")
+if options.region_stats:
+    system.region_stats = StatsRegionController(
+        file_name = options.region_stats)
 
 # Create a top-level voltage domain
 system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
@@ -211,8 +216,9 @@ if options.fastmem:
         fatal("You cannot use fastmem in combination with caches!")
 
 if options.simpoint_profile:
-    if not options.fastmem:
-        # Atomic CPU checked with fastmem option already
+    if not options.fastmem and CPUClass != MinorCPU:
+        # Atomic CPU checked with fastmem option already, the minor
+        # CPU profiles with its own timing
         fatal("SimPoint generation should be done with atomic cpu and fastmem")
     if np > 1:
         fatal("SimPoint generation not supported with more than one CPUs")
@@ -229,13 +235,16 @@ for i in xrange(np):
         system.cpu[i].fastmem = True
 
     if options.simpoint_profile:
-        system.cpu[i].addSimPointProbe(options.simpoint_interval)
+        system.cpu[i].addSimPointProbe(options.simpoint_interval,
+                                       options.simpoint_binary)
 
     if options.checker:
         system.cpu[i].addCheckerCpu()
     #system.cpu[i].FItarget  = options.FItarget #moselme ///Fault injection
     #system.cpu[i].FItargetReg = options.FItargetReg #moselme ///Fault injection
     #system.cpu[i].MaxTick =options.MaxTick #moselme ///Fault injection
+    Simulation.setDetailedCpuOptions(options, system.cpu[i],
+        "system.cpu%s" % ("" if np == 1 else "%d" % i))
     system.cpu[i].createThreads()
 
 if options.ruby:
@@ -271,6 +280,7 @@ else:
     system.system_port = system.membus.slave
     CacheConfig.config_cache(options, system)
     MemConfig.config_mem(options, system)
+    Simulation.setMemoryFaultSites(options, system)
 
 root = Root(full_system = False, system = system)
 Simulation.run(options, root, system, FutureClass)
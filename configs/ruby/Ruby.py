@@ -85,6 +85,10 @@ def define_options(parser):
     parser.add_option("--random_seed", type="int", default=1234,
                       help="Used for seeding the random number generator")
 
+    parser.add_option("--ruby-coalesce", action="store_true", default=False,
+                      help="Coalesce requests to a line with an outstanding "
+                           "miss in the sequencers")
+
     protocol = buildEnv['PROTOCOL']
     exec "import %s" % protocol
     eval("%s.define_options(parser)" % protocol)
@@ -119,6 +123,8 @@ def setup_memory_controllers(system, ruby, dir_cntrls, options):
             crossbar = NoncoherentXBar()
             crossbars.append(crossbar)
             dir_cntrl.memory = crossbar.slave
+            if getattr(options, "eventq_partition", False):
+                crossbar.eventq_index = dir_cntrl.eventq_index
 
         for r in system.mem_ranges:
             mem_ctrl = MemConfig.create_mem_ctrl(
@@ -126,6 +132,8 @@ def setup_memory_controllers(system, ruby, dir_cntrls, options):
                 int(math.log(options.num_dirs, 2)), options.cacheline_size)
 
             mem_ctrls.append(mem_ctrl)
+            if getattr(options, "eventq_partition", False):
+                mem_ctrl.eventq_index = dir_cntrl.eventq_index
 
             if crossbar != None:
                 mem_ctrl.port = crossbar.master
@@ -140,6 +148,48 @@ def setup_memory_controllers(system, ruby, dir_cntrls, options):
         ruby.crossbars = crossbars
 
 
+def partition_network(options, system, network, cpu_sequencers):
+    """Put each router, and everything attached to it (controllers with
+    their sequencers, CPUs and network interfaces), on an event queue
+    of its own, so that every tile simulates on its own host thread.
+    The links between routers then synchronize the queues, and the
+    quantum is picked from their latency."""
+
+    if options.garnet_network == "flexible":
+        fatal("Event queue partitioning does not support the flexible"
+              " Garnet network")
+
+    queues = {}
+    for i, router in enumerate(network.routers):
+        router.eventq_index = i
+        queues[id(router)] = i
+
+    for i, link in enumerate(network.ext_links):
+        index = queues[id(link.int_node)]
+        link.ext_node.eventq_index = index
+        queues[id(link.ext_node)] = index
+        if options.garnet_network == "fixed":
+            network.netifs[i].eventq_index = index
+            for l in link.network_links + link.credit_links:
+                l.eventq_index = index
+
+    # A fixed Garnet link runs on the queue of the router sending on
+    # it: node_a sends on the first network link and receives the
+    # credits of the second
+    if options.garnet_network == "fixed":
+        for link in network.int_links:
+            a = queues[id(link.node_a)]
+            b = queues[id(link.node_b)]
+            link.network_links[0].eventq_index = a
+            link.credit_links[0].eventq_index = b
+            link.network_links[1].eventq_index = b
+            link.credit_links[1].eventq_index = a
+
+    # The CPUs are connected to their sequencers directly
+    for cpu, seq in zip(getattr(system, 'cpu', []), cpu_sequencers):
+        if id(seq._parent) in queues:
+            cpu.eventq_index = queues[id(seq._parent)]
+
 def create_topology(controllers, options):
     """ Called from create_system in configs/ruby/<protocol>.py
         Must return an object which is a subclass of BaseTopology
@@ -218,6 +268,9 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
         network.enable_fault_model = True
         network.fault_model = FaultModel()
 
+    if getattr(options, "eventq_partition", False):
+        partition_network(options, system, network, cpu_sequencers)
+
     setup_memory_controllers(system, ruby, dir_cntrls, options)
 
     # Connect the cpu sequencers and the piobus
@@ -229,6 +282,11 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
             if buildEnv['TARGET_ISA'] == "x86":
                 cpu_seq.pio_slave_port = piobus.master
 
+    if options.ruby_coalesce:
+        for cpu_seq in cpu_sequencers:
+            if isinstance(cpu_seq, RubySequencer):
+                cpu_seq.coalesce_requests = True
+
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
     ruby.random_seed    = options.random_seed
@@ -52,12 +52,15 @@ class ArmTableWalker(MemObject):
     sys = Param.System(Parent.any, "system object parameter")
     num_squash_per_cycle = Param.Unsigned(2,
             "Number of outstanding walks that can be squashed per cycle")
+    walk_cache_size = Param.Unsigned(32, "Entries of the page-walk cache "
+            "of long-format table descriptors, a power of two or 0 for none")
 
 class ArmTLB(SimObject):
     type = 'ArmTLB'
     cxx_class = 'ArmISA::TLB'
     cxx_header = "arch/arm/tlb.hh"
     size = Param.Int(64, "TLB size")
+    assoc = Param.Int(8, "TLB associativity, 0 for fully associative")
     walker = Param.ArmTableWalker(ArmTableWalker(), "HW Table walker")
     is_stage2 = Param.Bool(False, "Is this a stage 2 TLB?")
 
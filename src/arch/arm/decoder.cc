@@ -162,12 +162,9 @@ Decoder::moreBytes(const PCState &pc, Addr fetchPC, MachInst inst)
     process();
 }
 
-StaticInstPtr
-Decoder::decode(ArmISA::PCState &pc)
+ExtMachInst
+Decoder::takePending(ArmISA::PCState &pc)
 {
-    if (!instDone)
-        return NULL;
-
     const int inst_size((!emi.thumb || emi.bigThumb) ? 4 : 2);
     ExtMachInst this_emi(emi);
 
@@ -181,7 +178,26 @@ Decoder::decode(ArmISA::PCState &pc)
     instDone = false;
     foundIt = false;
 
-    return decode(this_emi, pc.instAddr());
+    return this_emi;
+}
+
+StaticInstPtr
+Decoder::decode(ArmISA::PCState &pc)
+{
+    if (!instDone)
+        return NULL;
+
+    Addr addr = pc.instAddr();
+    return decode(takePending(pc), addr);
+}
+
+StaticInstPtr
+Decoder::decodeUncached(ArmISA::PCState &pc)
+{
+    if (!instDone)
+        return NULL;
+
+    return decodeInst(takePending(pc));
 }
 
 }
@@ -70,7 +70,11 @@ class Decoder
     int fpscrLen;
     int fpscrStride;
 
-    /// A cache of decoded instruction objects.
+    /// A cache of decoded instruction objects.  It is shared by every
+    /// decoder in the process and can't be saved to a file: StaticInsts
+    /// are polymorphic heap objects holding host pointers.  Runs which
+    /// should start with a warm cache can be forked from a warmed up
+    /// parent (m5.fork_at) and inherit it copy-on-write.
     static GenericISA::BasicDecodeCache defaultCache;
 
     /**
@@ -79,6 +83,12 @@ class Decoder
      */
     void process();
 
+    /**
+     * Take the pending instruction out of the decoder, updating pc
+     * with its size and IT state.
+     */
+    ExtMachInst takePending(ArmISA::PCState &pc);
+
     /**
      * Consume bytes by moving the offset into the data word and
      * sanity check the results.
@@ -151,6 +161,19 @@ class Decoder
      */
     StaticInstPtr decode(ArmISA::PCState &pc);
 
+    /**
+     * Decode the pending instruction like decode(ArmISA::PCState)
+     * but without looking it up in, or adding it to, the code cache.
+     * Used to decode deliberately corrupted instruction words
+     * without leaving them in the cache for later fault-free fetches
+     * from the same address.
+     *
+     * @param pc Instruction pointer that we are decoding.
+     * @return A pointer to a new static instruction or NULL if the
+     * decoder isn't ready (see instReady()).
+     */
+    StaticInstPtr decodeUncached(ArmISA::PCState &pc);
+
     /**
      * Decode a pre-decoded machine instruction.
      *
@@ -75,7 +75,6 @@ BranchImmCond64::generateDisassembly(
 {
     std::stringstream ss;
     printMnemonic(ss, "", false, true, condCode);
-    printTarget(ss, pc + imm, symtab);
     return ss.str();
 }
 
@@ -85,10 +84,16 @@ BranchImm64::generateDisassembly(
 {
     std::stringstream ss;
     printMnemonic(ss, "", false);
-    printTarget(ss, pc + imm, symtab);
     return ss.str();
 }
 
+void
+BranchImm64::printPCRelative(
+        std::ostream &os, Addr pc, const SymbolTable *symtab) const
+{
+    printTarget(os, pc + imm, symtab);
+}
+
 std::string
 BranchReg64::generateDisassembly(
         Addr pc, const SymbolTable *symtab) const
@@ -127,10 +132,16 @@ BranchImmReg64::generateDisassembly(
     printMnemonic(ss, "", false);
     printReg(ss, op1);
     ccprintf(ss, ", ");
-    printTarget(ss, pc + imm, symtab);
     return ss.str();
 }
 
+void
+BranchImmReg64::printPCRelative(
+        std::ostream &os, Addr pc, const SymbolTable *symtab) const
+{
+    printTarget(os, pc + imm, symtab);
+}
+
 std::string
 BranchImmImmReg64::generateDisassembly(
         Addr pc, const SymbolTable *symtab) const
@@ -139,8 +150,14 @@ BranchImmImmReg64::generateDisassembly(
     printMnemonic(ss, "", false);
     printReg(ss, op1);
     ccprintf(ss, ", #%#x, ", imm1);
-    printTarget(ss, pc + imm2, symtab);
     return ss.str();
 }
 
+void
+BranchImmImmReg64::printPCRelative(
+        std::ostream &os, Addr pc, const SymbolTable *symtab) const
+{
+    printTarget(os, pc + imm2, symtab);
+}
+
 } // namespace ArmISA
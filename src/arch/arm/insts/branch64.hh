@@ -53,7 +53,9 @@ class BranchImm64 : public ArmStaticInst
     BranchImm64(const char *mnem, ExtMachInst _machInst, OpClass __opClass,
                 int64_t _imm) :
         ArmStaticInst(mnem, _machInst, __opClass), imm(_imm)
-    {}
+    {
+        pcRelativeDisassembly = true;
+    }
 
     ArmISA::PCState branchTarget(const ArmISA::PCState &branchPC) const;
 
@@ -61,6 +63,8 @@ class BranchImm64 : public ArmStaticInst
     using StaticInst::branchTarget;
 
     std::string generateDisassembly(Addr pc, const SymbolTable *symtab) const;
+    void printPCRelative(std::ostream &os, Addr pc,
+                         const SymbolTable *symtab) const;
 };
 
 // Conditionally Branch to a target computed with an immediate
@@ -127,7 +131,9 @@ class BranchImmReg64 : public ArmStaticInst
     BranchImmReg64(const char *mnem, ExtMachInst _machInst, OpClass __opClass,
                    int64_t _imm, IntRegIndex _op1) :
         ArmStaticInst(mnem, _machInst, __opClass), imm(_imm), op1(_op1)
-    {}
+    {
+        pcRelativeDisassembly = true;
+    }
 
     ArmISA::PCState branchTarget(const ArmISA::PCState &branchPC) const;
 
@@ -135,6 +141,8 @@ class BranchImmReg64 : public ArmStaticInst
     using StaticInst::branchTarget;
 
     std::string generateDisassembly(Addr pc, const SymbolTable *symtab) const;
+    void printPCRelative(std::ostream &os, Addr pc,
+                         const SymbolTable *symtab) const;
 };
 
 // Branch to a target computed with two immediates
@@ -151,7 +159,9 @@ class BranchImmImmReg64 : public ArmStaticInst
                       IntRegIndex _op1) :
         ArmStaticInst(mnem, _machInst, __opClass),
         imm1(_imm1), imm2(_imm2), op1(_op1)
-    {}
+    {
+        pcRelativeDisassembly = true;
+    }
 
     ArmISA::PCState branchTarget(const ArmISA::PCState &branchPC) const;
 
@@ -159,6 +169,8 @@ class BranchImmImmReg64 : public ArmStaticInst
     using StaticInst::branchTarget;
 
     std::string generateDisassembly(Addr pc, const SymbolTable *symtab) const;
+    void printPCRelative(std::ostream &os, Addr pc,
+                         const SymbolTable *symtab) const;
 };
 
 }
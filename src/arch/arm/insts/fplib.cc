@@ -41,6 +41,8 @@
 #include <stdint.h>
 
 #include <cassert>
+#include <cmath>
+#include <cstring>
 
 #include "fplib.hh"
 
@@ -1536,6 +1538,189 @@ set_fpscr(FPSCR &fpscr, int flags)
     }
 }
 
+// The host's floating point gives the same results as the routines
+// above when rounding to nearest, if the operands and the result are
+// normal and clear of underflow: flush-to-zero and default NaN then
+// make no difference, and Inexact, the only exception left, is set
+// from the exact error of the operation.  Single precision products
+// and quotients are exact, or correctly rounded, in double precision.
+// None of this holds if the host evaluates in extended precision.
+#if defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ == 0
+#define FPLIB_HOST 1
+#else
+#define FPLIB_HOST 0
+#endif
+
+bool fplibHostArith = true;
+
+static inline float
+fp32_host(uint32_t x)
+{
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+static inline uint32_t
+fp32_bits(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+static inline double
+fp64_host(uint64_t x)
+{
+    double d;
+    memcpy(&d, &x, sizeof(d));
+    return d;
+}
+
+static inline uint64_t
+fp64_bits(double d)
+{
+    uint64_t x;
+    memcpy(&x, &d, sizeof(x));
+    return x;
+}
+
+// Whether a biased exponent is of a normal number larger than the
+// smallest, the only normal result that can be rounded up from a tiny
+// value (for which the routines above flush or signal underflow)
+static inline bool
+fp32_host_normal(uint32_t x)
+{
+    int exp = x >> 23 & 255;
+    return exp > 1 && exp < 255;
+}
+
+static inline bool
+fp64_host_normal(uint64_t x)
+{
+    int exp = x >> 52 & 2047;
+    return exp > 1 && exp < 2047;
+}
+
+// Stricter for double precision products and quotients, whose error
+// is found with a fused multiply-add that must not underflow either
+static inline bool
+fp64_host_moderate(uint64_t x)
+{
+    int exp = x >> 52 & 2047;
+    return exp > 1023 - 480 && exp < 1023 + 480;
+}
+
+static inline bool
+fp_host_mode(FPSCR fpscr)
+{
+    return FPLIB_HOST && fplibHostArith &&
+        (modeConv(fpscr) & 3) == FPLIB_RN;
+}
+
+static bool
+fp32_host_add(uint32_t a, uint32_t b, int neg, FPSCR &fpscr,
+              uint32_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp32_host_normal(a) ||
+        !fp32_host_normal(b))
+        return false;
+    float x = fp32_host(a);
+    float y = fp32_host(neg ? b ^ (uint32_t)1 << 31 : b);
+    float s = x + y;
+    *result = fp32_bits(s);
+    if (!fp32_host_normal(*result))
+        return false;
+    // The rounding error of the sum (Knuth's TwoSum)
+    float yy = s - x;
+    if ((x - (s - yy)) + (y - yy) != 0)
+        fpscr.ixc = 1;
+    return true;
+}
+
+static bool
+fp64_host_add(uint64_t a, uint64_t b, int neg, FPSCR &fpscr,
+              uint64_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp64_host_normal(a) ||
+        !fp64_host_normal(b))
+        return false;
+    double x = fp64_host(a);
+    double y = fp64_host(neg ? b ^ (uint64_t)1 << 63 : b);
+    double s = x + y;
+    *result = fp64_bits(s);
+    if (!fp64_host_normal(*result))
+        return false;
+    double yy = s - x;
+    if ((x - (s - yy)) + (y - yy) != 0)
+        fpscr.ixc = 1;
+    return true;
+}
+
+static bool
+fp32_host_mul(uint32_t a, uint32_t b, FPSCR &fpscr, uint32_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp32_host_normal(a) ||
+        !fp32_host_normal(b))
+        return false;
+    double p = (double)fp32_host(a) * fp32_host(b);
+    float r = p;
+    *result = fp32_bits(r);
+    if (!fp32_host_normal(*result))
+        return false;
+    if (r != p)
+        fpscr.ixc = 1;
+    return true;
+}
+
+static bool
+fp64_host_mul(uint64_t a, uint64_t b, FPSCR &fpscr, uint64_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp64_host_moderate(a) ||
+        !fp64_host_moderate(b))
+        return false;
+    double x = fp64_host(a), y = fp64_host(b);
+    double r = x * y;
+    *result = fp64_bits(r);
+    if (!fp64_host_moderate(*result))
+        return false;
+    if (std::fma(x, y, -r) != 0)
+        fpscr.ixc = 1;
+    return true;
+}
+
+static bool
+fp32_host_div(uint32_t a, uint32_t b, FPSCR &fpscr, uint32_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp32_host_normal(a) ||
+        !fp32_host_normal(b))
+        return false;
+    double x = fp32_host(a), y = fp32_host(b);
+    float r = x / y;
+    *result = fp32_bits(r);
+    if (!fp32_host_normal(*result))
+        return false;
+    if (r * y != x)
+        fpscr.ixc = 1;
+    return true;
+}
+
+static bool
+fp64_host_div(uint64_t a, uint64_t b, FPSCR &fpscr, uint64_t *result)
+{
+    if (!fp_host_mode(fpscr) || !fp64_host_moderate(a) ||
+        !fp64_host_moderate(b))
+        return false;
+    double x = fp64_host(a), y = fp64_host(b);
+    double r = x / y;
+    *result = fp64_bits(r);
+    if (!fp64_host_moderate(*result))
+        return false;
+    if (std::fma(r, y, -x) != 0)
+        fpscr.ixc = 1;
+    return true;
+}
+
 template <>
 bool
 fplibCompareEQ(uint32_t a, uint32_t b, FPSCR &fpscr)
@@ -1614,8 +1799,11 @@ template <>
 uint32_t
 fplibAdd(uint32_t op1, uint32_t op2, FPSCR &fpscr)
 {
+    uint32_t result;
+    if (fp32_host_add(op1, op2, 0, fpscr, &result))
+        return result;
     int flags = 0;
-    uint32_t result = fp32_add(op1, op2, 0, modeConv(fpscr), &flags);
+    result = fp32_add(op1, op2, 0, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -1624,8 +1812,11 @@ template <>
 uint64_t
 fplibAdd(uint64_t op1, uint64_t op2, FPSCR &fpscr)
 {
+    uint64_t result;
+    if (fp64_host_add(op1, op2, 0, fpscr, &result))
+        return result;
     int flags = 0;
-    uint64_t result = fp64_add(op1, op2, 0, modeConv(fpscr), &flags);
+    result = fp64_add(op1, op2, 0, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2035,8 +2226,11 @@ template <>
 uint32_t
 fplibDiv(uint32_t op1, uint32_t op2, FPSCR &fpscr)
 {
+    uint32_t result;
+    if (fp32_host_div(op1, op2, fpscr, &result))
+        return result;
     int flags = 0;
-    uint32_t result = fp32_div(op1, op2, modeConv(fpscr), &flags);
+    result = fp32_div(op1, op2, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2045,8 +2239,11 @@ template <>
 uint64_t
 fplibDiv(uint64_t op1, uint64_t op2, FPSCR &fpscr)
 {
+    uint64_t result;
+    if (fp64_host_div(op1, op2, fpscr, &result))
+        return result;
     int flags = 0;
-    uint64_t result = fp64_div(op1, op2, modeConv(fpscr), &flags);
+    result = fp64_div(op1, op2, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2211,8 +2408,11 @@ template <>
 uint32_t
 fplibMul(uint32_t op1, uint32_t op2, FPSCR &fpscr)
 {
+    uint32_t result;
+    if (fp32_host_mul(op1, op2, fpscr, &result))
+        return result;
     int flags = 0;
-    uint32_t result = fp32_mul(op1, op2, modeConv(fpscr), &flags);
+    result = fp32_mul(op1, op2, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2221,8 +2421,11 @@ template <>
 uint64_t
 fplibMul(uint64_t op1, uint64_t op2, FPSCR &fpscr)
 {
+    uint64_t result;
+    if (fp64_host_mul(op1, op2, fpscr, &result))
+        return result;
     int flags = 0;
-    uint64_t result = fp64_mul(op1, op2, modeConv(fpscr), &flags);
+    result = fp64_mul(op1, op2, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2828,8 +3031,11 @@ template <>
 uint32_t
 fplibSub(uint32_t op1, uint32_t op2, FPSCR &fpscr)
 {
+    uint32_t result;
+    if (fp32_host_add(op1, op2, 1, fpscr, &result))
+        return result;
     int flags = 0;
-    uint32_t result = fp32_add(op1, op2, 1, modeConv(fpscr), &flags);
+    result = fp32_add(op1, op2, 1, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
@@ -2838,8 +3044,11 @@ template <>
 uint64_t
 fplibSub(uint64_t op1, uint64_t op2, FPSCR &fpscr)
 {
+    uint64_t result;
+    if (fp64_host_add(op1, op2, 1, fpscr, &result))
+        return result;
     int flags = 0;
-    uint64_t result = fp64_add(op1, op2, 1, modeConv(fpscr), &flags);
+    result = fp64_add(op1, op2, 1, modeConv(fpscr), &flags);
     set_fpscr0(fpscr, flags);
     return result;
 }
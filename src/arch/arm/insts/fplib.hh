@@ -71,6 +71,13 @@ FPCRRounding(FPSCR &fpscr)
     return (FPRounding)((uint32_t)fpscr >> 22 & 3);
 }
 
+/**
+ * Whether fplibAdd, fplibSub, fplibMul and fplibDiv may use the host's
+ * floating point where it matches the software routines. Clearing it
+ * forces the software routines. Defaults to true.
+ */
+extern bool fplibHostArith;
+
 /** Floating-point absolute value. */
 template <class T>
 T fplibAbs(T op);
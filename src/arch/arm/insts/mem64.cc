@@ -187,7 +187,13 @@ MemoryLiteral64::generateDisassembly(Addr pc, const SymbolTable *symtab) const
     std::stringstream ss;
     printMnemonic(ss, "", false);
     printReg(ss, dest);
-    ccprintf(ss, ", #%d", pc + imm);
     return ss.str();
 }
+
+void
+MemoryLiteral64::printPCRelative(
+        std::ostream &os, Addr pc, const SymbolTable *symtab) const
+{
+    ccprintf(os, ", #%d", pc + imm);
+}
 }
@@ -244,9 +244,13 @@ class MemoryLiteral64 : public Memory64
     MemoryLiteral64(const char *mnem, ExtMachInst _machInst,
                     OpClass __opClass, IntRegIndex _dest, int64_t _imm)
         : Memory64(mnem, _machInst, __opClass, _dest, INTREG_ZERO), imm(_imm)
-    {}
+    {
+        pcRelativeDisassembly = true;
+    }
 
     std::string generateDisassembly(Addr pc, const SymbolTable *symtab) const;
+    void printPCRelative(std::ostream &os, Addr pc,
+                         const SymbolTable *symtab) const;
 };
 }
 
@@ -366,10 +366,10 @@ ArmStaticInst::printTarget(std::ostream &os, Addr target,
                            const SymbolTable *symtab) const
 {
     Addr symbolAddr;
-    std::string symbol;
+    const std::string *symbol;
 
-    if (symtab && symtab->findNearestSymbol(target, symbol, symbolAddr)) {
-        ccprintf(os, "<%s", symbol);
+    if (symtab && (symbol = symtab->nearestSymbol(target, symbolAddr))) {
+        ccprintf(os, "<%s", *symbol);
         if (symbolAddr != target)
             ccprintf(os, "+%d>", target - symbolAddr);
         else
@@ -450,9 +450,9 @@ ArmStaticInst::printMemSymbol(std::ostream &os,
                               const std::string &suffix) const
 {
     Addr symbolAddr;
-    std::string symbol;
-    if (symtab && symtab->findNearestSymbol(addr, symbol, symbolAddr)) {
-        ccprintf(os, "%s%s", prefix, symbol);
+    const std::string *symbol;
+    if (symtab && (symbol = symtab->nearestSymbol(addr, symbolAddr))) {
+        ccprintf(os, "%s%s", prefix, *symbol);
         if (symbolAddr != addr)
             ccprintf(os, "+%d", addr - symbolAddr);
         ccprintf(os, suffix);
@@ -127,7 +127,8 @@ ISA::ISA(Params *p)
     : SimObject(p),
       system(NULL),
       pmu(p->pmu),
-      lookUpMiscReg(NUM_MISCREGS, {0,0})
+      lookUpMiscReg(NUM_MISCREGS, {0,0}),
+      directMiscReg(NUM_MISCREGS, -1)
 {
     SCTLR sctlr;
     sctlr = 0;
@@ -169,10 +170,26 @@ ISA::ISA(Params *p)
     }
 
     preUnflattenMiscReg();
+    initDirectMiscRegs();
 
     clear();
 }
 
+void
+ISA::initDirectMiscRegs()
+{
+    for (int reg = 0; reg < NUM_MISCREGS; reg++) {
+        // The registers that flattenMiscIndex maps by state
+        if (reg == MISCREG_SPSR || miscRegInfo[reg][MISCREG_MUTEX] ||
+            miscRegInfo[reg][MISCREG_BANKED] || reg == MISCREG_SCTLR_EL1)
+            continue;
+        if (lookUpMiscReg[reg].upper > 0)
+            continue;
+        directMiscReg[reg] = lookUpMiscReg[reg].lower > 0 ?
+            lookUpMiscReg[reg].lower : reg;
+    }
+}
+
 const ArmISAParams *
 ISA::params() const
 {
@@ -414,6 +431,9 @@ ISA::readMiscRegNoEffect(int misc_reg) const
 {
     assert(misc_reg < NumMiscRegs);
 
+    if (directMiscReg[misc_reg] >= 0)
+        return miscRegs[directMiscReg[misc_reg]];
+
     int flat_idx = flattenMiscIndex(misc_reg);  // Note: indexes of AArch64
                                                 // registers are left unchanged
     MiscReg val;
@@ -788,6 +808,13 @@ ISA::setMiscRegNoEffect(int misc_reg, const MiscReg &val)
 {
     assert(misc_reg < NumMiscRegs);
 
+    if (directMiscReg[misc_reg] >= 0) {
+        miscRegs[directMiscReg[misc_reg]] = val;
+        DPRINTF(MiscRegs, "Writing to misc reg %d (%d) : %#x\n",
+                misc_reg, directMiscReg[misc_reg], val);
+        return;
+    }
+
     int flat_idx = flattenMiscIndex(misc_reg);  // Note: indexes of AArch64
                                                 // registers are left unchanged
 
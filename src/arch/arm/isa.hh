@@ -164,6 +164,14 @@ namespace ArmISA
         /** Translation table accessible via the value of the register */
         std::vector<struct MiscRegLUTEntry> lookUpMiscReg;
 
+        /**
+         * The entry of miscRegs that holds each register, for those
+         * that are always in the same single one, whatever the mode
+         * and security state; -1 for the banked, muxed and split ones,
+         * which readMiscRegNoEffect and setMiscRegNoEffect flatten.
+         */
+        std::vector<int> directMiscReg;
+
         MiscReg miscRegs[NumMiscRegs];
         const IntRegIndex *intRegMap;
 
@@ -231,6 +239,8 @@ namespace ArmISA
         void tlbiMVA(ThreadContext *tc, MiscReg newVal, bool secure_lookup,
                      bool hyp, uint8_t target_el);
 
+        void initDirectMiscRegs();
+
       public:
         void clear();
         void clear64(const ArmISAParams *p);
@@ -113,6 +113,8 @@ PMU::setMiscReg(int misc_reg, MiscReg val)
     DPRINTF(PMUVerbose, "setMiscReg(%s, 0x%x)\n",
             miscRegName[unflattenMiscReg(misc_reg)], val);
 
+    flushAllEvents();
+
     switch (unflattenMiscReg(misc_reg)) {
       case MISCREG_PMCR_EL0:
       case MISCREG_PMCR:
@@ -221,6 +223,8 @@ PMU::setMiscReg(int misc_reg, MiscReg val)
 MiscReg
 PMU::readMiscReg(int misc_reg)
 {
+    flushAllEvents();
+
     MiscReg val(readMiscRegInt(misc_reg));
     DPRINTF(PMUVerbose, "readMiscReg(%s): 0x%x\n",
             miscRegName[unflattenMiscReg(misc_reg)], val);
@@ -352,16 +356,23 @@ PMU::updateAllCounters()
     }
 }
 
-bool
-PMU::isFiltered(const CounterState &ctr) const
+unsigned
+PMU::filterMode() const
 {
     assert(isa);
 
-    const PMEVTYPER_t filter(ctr.filter);
     const SCR scr(isa->readMiscRegNoEffect(MISCREG_SCR));
     const CPSR cpsr(isa->readMiscRegNoEffect(MISCREG_CPSR));
     const ExceptionLevel el(opModeToEL((OperatingMode)(uint8_t)cpsr.mode));
-    const bool secure(inSecureState(scr, cpsr));
+    return el << 1 | inSecureState(scr, cpsr);
+}
+
+bool
+PMU::isFiltered(const CounterState &ctr, unsigned mode) const
+{
+    const PMEVTYPER_t filter(ctr.filter);
+    const ExceptionLevel el((ExceptionLevel)(mode >> 1));
+    const bool secure(mode & 1);
 
     switch (el) {
       case EL0:
@@ -385,10 +396,28 @@ void
 PMU::handleEvent(CounterId id, uint64_t delta)
 {
     CounterState &ctr(getCounter(id));
+    const unsigned mode(filterMode());
+
+    if (ctr.pending && mode != ctr.pendingMode)
+        flushEvents(id, ctr);
+
+    ctr.pendingMode = mode;
+    ctr.pending += delta;
+    if (ctr.pending >= ctr.pendingLimit)
+        flushEvents(id, ctr);
+}
+
+void
+PMU::flushEvents(CounterId id, CounterState &ctr)
+{
+    uint64_t delta(ctr.pending);
     const bool overflowed(reg_pmovsr & (1 << id));
 
-    if (isFiltered(ctr))
+    ctr.pending = 0;
+    if (!delta || isFiltered(ctr, ctr.pendingMode)) {
+        ctr.pendingLimit = eventsToOverflow(id, ctr);
         return;
+    }
 
     // Handle the "count every 64 cycles" mode
     if (id == PMCCNTR && reg_pmcr.d) {
@@ -398,7 +427,7 @@ PMU::handleEvent(CounterId id, uint64_t delta)
     }
 
     // Add delta and handle (new) overflows
-    if (ctr.add(delta) && !overflowed) {
+    if (delta && ctr.add(delta) && !overflowed) {
         DPRINTF(PMUVerbose, "PMU counter '%i' overflowed.\n", id);
         reg_pmovsr |= (1 << id);
         // Deliver a PMU interrupt if interrupt delivery is enabled
@@ -406,6 +435,34 @@ PMU::handleEvent(CounterId id, uint64_t delta)
         if (reg_pminten  & (1 << id))
             raiseInterrupt();
     }
+    ctr.pendingLimit = eventsToOverflow(id, ctr);
+}
+
+void
+PMU::flushAllEvents()
+{
+    for (CounterId id = 0; id < counters.size(); ++id) {
+        flushEvents(id, counters[id]);
+        counters[id].pendingLimit = 1;
+    }
+    flushEvents(PMCCNTR, cycleCounter);
+    cycleCounter.pendingLimit = 1;
+}
+
+uint64_t
+PMU::eventsToOverflow(CounterId id, const CounterState &ctr) const
+{
+    // Counts until the counter wraps around, saturated for a 64-bit
+    // counter at 0
+    uint64_t counts(ctr.overflow64 ? -ctr.value :
+                    (ULL(1) << 32) - (ctr.value & mask(32)));
+    if (!counts)
+        counts = ~ULL(0);
+
+    if (id == PMCCNTR && reg_pmcr.d)
+        return counts > (~ULL(0) >> 6) ? ~ULL(0) :
+            (counts << 6) - clock_remainder;
+    return counts;
 }
 
 void
@@ -517,6 +574,8 @@ PMU::serialize(std::ostream &os)
 {
     DPRINTF(Checkpoint, "Serializing Arm PMU\n");
 
+    flushAllEvents();
+
     SERIALIZE_SCALAR(reg_pmcr);
     SERIALIZE_SCALAR(reg_pmcnten);
     SERIALIZE_SCALAR(reg_pmselr);
@@ -569,20 +628,22 @@ PMU::CounterState::unserialize(Checkpoint *cp, const std::string &section)
     UNSERIALIZE_SCALAR(value);
     UNSERIALIZE_SCALAR(enabled);
     UNSERIALIZE_SCALAR(overflow64);
+    pending = 0;
+    pendingLimit = 1;
 }
 
 bool
 PMU::CounterState::add(uint64_t delta)
 {
-    const uint64_t msb(1ULL << (overflow64 ? 63 : 31));
     const uint64_t old_value(value);
 
     assert(delta > 0);
 
     value += delta;
 
-    // Overflow if the msb goes from 1 to 0
-    return (old_value & msb) && !(value & msb);
+    // Overflow if the counter wraps around, which a batch of events
+    // may do without ever setting the msb
+    return overflow64 ? value < old_value : (value >> 32) != (old_value >> 32);
 }
 
 } // namespace ArmISA
@@ -324,7 +324,8 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
     struct CounterState {
         CounterState()
             : eventId(0), filter(0), value(0), enabled(false),
-              overflow64(false) {
+              overflow64(false), pending(0), pendingMode(0),
+              pendingLimit(1) {
 
             listeners.reserve(4);
         }
@@ -356,6 +357,16 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
         /** Is this a 64-bit counter? */
         bool overflow64;
 
+      public: /* Events not yet added to the counter */
+        /** Number of events since the last flush */
+        uint64_t pending;
+
+        /** Filter mode (see filterMode()) of the pending events */
+        unsigned pendingMode;
+
+        /** Flush once this many events are pending */
+        uint64_t pendingLimit;
+
       public: /* Configuration */
         /** Probe listeners driving this counter */
         std::vector<ProbeListenerUPtr> listeners;
@@ -365,15 +376,47 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
      * Handle an counting event triggered by a probe.
      *
      * This method is called by the ProbeListener class whenever an
-     * active probe is triggered. Ths method adds the event count from
-     * the probe to the affected counter, checks for overflows, and
-     * delivers an interrupt if needed.
+     * active probe is triggered. The event count from the probe is
+     * batched with the counter's pending events as long as the
+     * filter mode stays the same, and until the count that makes the
+     * counter overflow, so that overflow interrupts are delivered
+     * for the same event as without batching.
      *
      * @param id Counter ID affected by the probe.
      * @param delta Counter increment
      */
     void handleEvent(CounterId id, uint64_t delta);
 
+    /**
+     * Add the pending events of a counter to it, check for overflows,
+     * and deliver an interrupt if needed.
+     *
+     * @param id ID of counter within the PMU.
+     * @param ctr Reference to the counter's state
+     */
+    void flushEvents(CounterId id, CounterState &ctr);
+
+    /**
+     * Flush the pending events of all counters before their state is
+     * accessed. The next event of each counter flushes too, so that
+     * any change that is then made to the counter is seen.
+     */
+    void flushAllEvents();
+
+    /**
+     * Number of events that make a counter overflow.
+     *
+     * @param id ID of counter within the PMU.
+     * @param ctr Counter state instance representing this counter.
+     */
+    uint64_t eventsToOverflow(CounterId id, const CounterState &ctr) const;
+
+    /**
+     * The exception level and security state of the core, which
+     * decide which counters are filtered.
+     */
+    unsigned filterMode() const;
+
     /**
      * Is this a valid counter ID?
      *
@@ -428,9 +471,10 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
      * Check if a counter's settings allow it to be counted.
      *
      * @param ctr Counter state instance representing this counter.
+     * @param mode Filter mode of the core (see filterMode()).
      * @return false if the counter is active, true otherwise.
      */
-    bool isFiltered(const CounterState &ctr) const;
+    bool isFiltered(const CounterState &ctr, unsigned mode) const;
 
     /**
      * Call updateCounter() for each counter in the PMU if the
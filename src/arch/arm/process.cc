@@ -41,6 +41,7 @@
  *          Ali Saidi
  */
 
+#include "arch/arm/decoder.hh"
 #include "arch/arm/isa_traits.hh"
 #include "arch/arm/process.hh"
 #include "arch/arm/types.hh"
@@ -50,6 +51,7 @@
 #include "cpu/thread_context.hh"
 #include "debug/Stack.hh"
 #include "mem/page_table.hh"
+#include "params/LiveProcess.hh"
 #include "sim/byteswap.hh"
 #include "sim/process_impl.hh"
 #include "sim/system.hh"
@@ -59,7 +61,8 @@ using namespace ArmISA;
 
 ArmLiveProcess::ArmLiveProcess(LiveProcessParams *params, ObjectFile *objFile,
                                ObjectFile::Arch _arch)
-    : LiveProcess(params, objFile), arch(_arch)
+    : LiveProcess(params, objFile), arch(_arch),
+      predecode(params->predecode)
 {
 }
 
@@ -121,6 +124,8 @@ ArmLiveProcess64::initState()
 {
     LiveProcess::initState();
     argsInit<uint64_t>(PageBytes, INTREG_SP0);
+    if (predecode)
+        predecodeText();
     for (int i = 0; i < contextIds.size(); i++) {
         ThreadContext * tc = system->getThreadContext(contextIds[i]);
         CPSR cpsr = tc->readMiscReg(MISCREG_CPSR);
@@ -138,6 +143,36 @@ ArmLiveProcess64::initState()
     }
 }
 
+void
+ArmLiveProcess::predecodeText()
+{
+    // Thumb code can't be split into instructions without running
+    // it, and AArch32 text often holds literal pools, which are better
+    // left undecoded.  This is done serially because StaticInstPtr
+    // reference counts and the decode cache aren't thread safe.
+    if (arch != ObjectFile::Arm64) {
+        warn("Only AArch64 text segments are pre-decoded.\n");
+        return;
+    }
+
+    const Addr base = objFile->textBase();
+    const size_t count = objFile->textSize() / sizeof(MachInst);
+    std::vector<MachInst> text(count);
+    initVirtMem.readBlob(base, (uint8_t *)text.data(),
+                         count * sizeof(MachInst));
+
+    Decoder decoder;
+    PCState pc;
+    pc.aarch64(true);
+    pc.nextAArch64(true);
+    for (size_t i = 0; i < count; i++) {
+        pc.set(base + i * sizeof(MachInst));
+        decoder.moreBytes(pc, pc.instAddr(), letoh(text[i]));
+        decoder.decode(pc);
+    }
+    inform("Pre-decoded %d instructions of the text segment.\n", count);
+}
+
 template <class IntType>
 void
 ArmLiveProcess::argsInit(int pageSize, IntRegIndex spIndex)
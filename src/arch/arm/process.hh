@@ -58,10 +58,17 @@ class ArmLiveProcess : public LiveProcess
 {
   protected:
     ObjectFile::Arch arch;
+    bool predecode;
     ArmLiveProcess(LiveProcessParams * params, ObjectFile *objFile,
                    ObjectFile::Arch _arch);
     template<class IntType>
     void argsInit(int pageSize, ArmISA::IntRegIndex spIndex);
+
+    /**
+     * Decode every word of the loaded text segment into the shared
+     * decode cache, so that the run doesn't decode any of it.
+     */
+    void predecodeText();
 };
 
 class ArmLiveProcess32 : public ArmLiveProcess
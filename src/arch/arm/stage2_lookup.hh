@@ -47,6 +47,7 @@
 #include "arch/arm/table_walker.hh"
 #include "arch/arm/tlb.hh"
 #include "mem/request.hh"
+#include "sim/event_pool.hh"
 
 class ThreadContext;
 
@@ -94,6 +95,20 @@ class Stage2LookUp : public BaseTLB::Translation
 
     bool isComplete() const { return complete; }
 
+    TlbEntry *getStage2Te() const { return stage2Te; }
+
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(p, size);
+    }
+
     void markDelayed() {}
 
     void finish(const Fault &fault, RequestPtr req, ThreadContext *tc,
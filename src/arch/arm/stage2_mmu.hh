@@ -44,6 +44,7 @@
 #include "arch/arm/tlb.hh"
 #include "mem/request.hh"
 #include "params/ArmStage2MMU.hh"
+#include "sim/event_pool.hh"
 #include "sim/eventq.hh"
 
 namespace ArmISA {
@@ -91,6 +92,18 @@ class Stage2MMU : public SimObject
         {
             return (parent.stage2Tlb()->translateTiming(&req, tc, this, BaseTLB::Read));
         }
+
+        static void *
+        operator new(size_t size)
+        {
+            return EventPool::allocate(size);
+        }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            EventPool::release(p, size);
+        }
     };
 
     typedef ArmStage2MMUParams Params;
@@ -60,6 +60,7 @@ TableWalker::TableWalker(const Params *p)
       stage2Mmu(NULL), isStage2(p->is_stage2), tlb(NULL),
       currState(NULL), pending(false), masterId(p->sys->getMasterId(name())),
       numSquashable(p->num_squash_per_cycle),
+      walkCache(p->walk_cache_size),
       pendingReqs(0),
       pendingChangeTick(curTick()),
       doL1DescEvent(this), doL2DescEvent(this),
@@ -69,6 +70,10 @@ TableWalker::TableWalker(const Params *p)
 {
     sctlr = 0;
 
+    if (!walkCache.empty() && !isPowerOf2(walkCache.size()))
+        fatal("%s: walk_cache_size must be a power of two\n", name());
+    flushWalkCache();
+
     // Cache system-level properties
     if (FullSystem) {
         armSys = dynamic_cast<ArmSystem *>(p->sys);
@@ -100,7 +105,7 @@ TableWalker::WalkerState::WalkerState() :
     pxnTable(false), stage2Req(false), doingStage2(false),
     stage2Tran(nullptr), timing(false), functional(false),
     mode(BaseTLB::Read), tranType(TLB::NormalTran), l2Desc(l1Desc),
-    delayed(false), tableWalker(nullptr)
+    delayed(false), tableWalker(nullptr), descAddr(0), descSecure(false)
 {
 }
 
@@ -146,10 +151,18 @@ TableWalker::drain(DrainManager *dm)
     }
 }
 
+void
+TableWalker::flushWalkCache()
+{
+    for (auto &entry : walkCache)
+        entry.valid = false;
+}
+
 void
 TableWalker::drainResume()
 {
     Drainable::drainResume();
+    flushWalkCache();
     if (params()->sys->isTimingMode() && currState) {
         delete currState;
         currState = NULL;
@@ -927,48 +940,30 @@ TableWalker::processWalkAArch64()
     currState->longDesc.aarch64 = true;
     currState->longDesc.grainSize = tg;
 
-    if (currState->timing) {
-        Event *event;
-        switch (start_lookup_level) {
-          case L0:
-            event = (Event *) &doL0LongDescEvent;
-            break;
-          case L1:
-            event = (Event *) &doL1LongDescEvent;
-            break;
-          case L2:
-            event = (Event *) &doL2LongDescEvent;
-            break;
-          case L3:
-            event = (Event *) &doL3LongDescEvent;
-            break;
-          default:
-            panic("Invalid table lookup level");
-            break;
-        }
-        port.dmaAction(MemCmd::ReadReq, desc_addr, sizeof(uint64_t),
-                       event, (uint8_t*) &currState->longDesc.data,
-                       currState->tc->getCpuPtr()->clockPeriod(), flag);
-        DPRINTF(TLBVerbose,
-                "Adding to walker fifo: queue size before adding: %d\n",
-                stateQueues[start_lookup_level].size());
-        stateQueues[start_lookup_level].push_back(currState);
-        currState = NULL;
-    } else if (!currState->functional) {
-        port.dmaAction(MemCmd::ReadReq, desc_addr, sizeof(uint64_t),
-                       NULL, (uint8_t*) &currState->longDesc.data,
-                       currState->tc->getCpuPtr()->clockPeriod(), flag);
-        doLongDescriptor();
-        f = currState->fault;
-    } else {
-        RequestPtr req = new Request(desc_addr, sizeof(uint64_t), flag,
-                                     masterId);
-        PacketPtr pkt = new Packet(req, MemCmd::ReadReq);
-        pkt->dataStatic((uint8_t*) &currState->longDesc.data);
-        port.sendFunctional(pkt);
-        doLongDescriptor();
-        delete req;
-        delete pkt;
+    Event *event;
+    switch (start_lookup_level) {
+      case L0:
+        event = (Event *) &doL0LongDescEvent;
+        break;
+      case L1:
+        event = (Event *) &doL1LongDescEvent;
+        break;
+      case L2:
+        event = (Event *) &doL2LongDescEvent;
+        break;
+      case L3:
+        event = (Event *) &doL3LongDescEvent;
+        break;
+      default:
+        panic("Invalid table lookup level");
+        break;
+    }
+
+    bool delayed = fetchDescriptor(desc_addr,
+                                   (uint8_t*)&currState->longDesc.data,
+                                   sizeof(uint64_t), flag, start_lookup_level,
+                                   event, &TableWalker::doLongDescriptor);
+    if (!delayed) {
         f = currState->fault;
     }
 
@@ -1554,6 +1549,16 @@ TableWalker::doLongDescriptor()
         return;
       case LongDescriptor::Table:
         {
+            if (!walkCache.empty()) {
+                WalkCacheEntry &entry = walkCacheSlot(currState->descAddr);
+                entry.addr = currState->descAddr;
+                entry.secure = currState->descSecure;
+                entry.stage2 = currState->stage2Req;
+                entry.vmid = currState->vmid;
+                entry.valid = true;
+                entry.data = currState->longDesc.data;
+            }
+
             // Set hierarchical permission flags
             currState->secureLookup = currState->secureLookup &&
                 currState->longDesc.secureTable();
@@ -1903,6 +1908,35 @@ TableWalker::fetchDescriptor(Addr descAddr, uint8_t *data, int numBytes,
     void (TableWalker::*doDescriptor)())
 {
     bool isTiming = currState->timing;
+    currState->descAddr = descAddr;
+    currState->descSecure = flags.isSet(Request::SECURE);
+
+    // A long-format table descriptor may be in the page-walk cache, in
+    // which case it is at hand the next cycle, without a memory access
+    if (!walkCache.empty() &&
+        data == (uint8_t *)&currState->longDesc.data &&
+        !(isTiming && event->scheduled())) {
+        WalkCacheEntry &entry = walkCacheSlot(descAddr);
+        if (entry.valid && entry.addr == descAddr &&
+            entry.secure == currState->descSecure &&
+            entry.stage2 == currState->stage2Req &&
+            (!entry.stage2 || entry.vmid == currState->vmid)) {
+            DPRINTF(TLBVerbose, "Walk cache hit for descriptor at %#x\n",
+                    descAddr);
+            ++statWalkCacheHits;
+            currState->longDesc.data = entry.data;
+            if (isTiming) {
+                schedule(event, clockEdge(Cycles(1)));
+                if (queueIndex >= 0) {
+                    stateQueues[queueIndex].push_back(currState);
+                    currState = NULL;
+                }
+            } else {
+                (this->*doDescriptor)();
+            }
+            return isTiming;
+        }
+    }
 
     // do the requests for the page table descriptors have to go through the
     // second stage MMU
@@ -2148,6 +2182,12 @@ TableWalker::regStats()
         .flags(Stats::nozero)
         ;
 
+    statWalkCacheHits
+        .name(name() + ".walkCacheHits")
+        .desc("Table descriptors found in the page-walk cache")
+        .flags(Stats::nozero)
+        ;
+
     statSquashedAfter
         .name(name() + ".walksSquashedAfter")
         .desc("Table walks squashed after completion")
@@ -42,6 +42,7 @@
 #define __ARCH_ARM_TABLE_WALKER_HH__
 
 #include <list>
+#include <vector>
 
 #include "arch/arm/miscregs.hh"
 #include "arch/arm/system.hh"
@@ -50,6 +51,7 @@
 #include "mem/mem_object.hh"
 #include "mem/request.hh"
 #include "params/ArmTableWalker.hh"
+#include "sim/event_pool.hh"
 #include "sim/eventq.hh"
 
 class ThreadContext;
@@ -800,6 +802,10 @@ class TableWalker : public MemObject
         /** Page entries walked during service (for stats) */
         unsigned levels;
 
+        /** Address and security of the last descriptor fetched */
+        Addr descAddr;
+        bool descSecure;
+
         void doL1Descriptor();
         void doL2Descriptor();
 
@@ -807,6 +813,19 @@ class TableWalker : public MemObject
 
         WalkerState();
 
+        // A walk state is allocated for every timing TLB miss
+        static void *
+        operator new(size_t size)
+        {
+            return EventPool::allocate(size);
+        }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            EventPool::release(p, size);
+        }
+
         std::string name() const { return tableWalker->name(); }
     };
 
@@ -881,6 +900,32 @@ class TableWalker : public MemObject
      * removed from the pendingQueue per cycle. */
     unsigned numSquashable;
 
+    /**
+     * Page-walk cache: direct mapped, by their physical address, copies
+     * of long-format table descriptors, which point to the next level
+     * and are found by most walks.  Software invalidates the TLB after
+     * changing the tables, and that flushes this cache too.  The
+     * descriptors of walks through the stage 2 MMU are kept by their
+     * intermediate physical address and VMID instead.
+     */
+    struct WalkCacheEntry
+    {
+        Addr addr;
+        bool secure;
+        bool stage2;
+        uint8_t vmid;
+        bool valid;
+        uint64_t data;
+    };
+    std::vector<WalkCacheEntry> walkCache;
+
+    WalkCacheEntry &
+    walkCacheSlot(Addr desc_addr)
+    {
+        return walkCache[((desc_addr >> 3) ^ (desc_addr >> 12)) &
+                         (walkCache.size() - 1)];
+    }
+
     /** Cached copies of system-level properties */
     bool haveSecurity;
     bool _haveLPAE;
@@ -897,6 +942,7 @@ class TableWalker : public MemObject
     Stats::Vector statWalksLongTerminatedAtLevel;
     Stats::Scalar statSquashedBefore;
     Stats::Scalar statSquashedAfter;
+    Stats::Scalar statWalkCacheHits;
     Stats::Histogram statWalkWaitTime;
     Stats::Histogram statWalkServiceTime;
     Stats::Histogram statPendingWalks; // essentially "L" of queueing theory
@@ -931,6 +977,9 @@ class TableWalker : public MemObject
                                           PortID idx = InvalidPortID);
     void regStats();
 
+    /** Drop all the descriptors of the page-walk cache */
+    void flushWalkCache();
+
     /**
      * Allow the MMU (overseeing both stage 1 and stage 2 TLBs) to
      * access the table walker port through the TLB so that it can
@@ -72,13 +72,27 @@ using namespace ArmISA;
 
 TLB::TLB(const ArmTLBParams *p)
     : BaseTLB(p), table(new TlbEntry[p->size]), size(p->size),
+      assoc(p->assoc && p->assoc < p->size ? p->assoc : p->size),
+      numSets(size / assoc),
       isStage2(p->is_stage2), stage2Req(false), _attr(0),
       directToStage2(false), tableWalker(p->walker), stage2Tlb(NULL),
-      stage2Mmu(NULL), rangeMRU(1), bootUncacheability(false),
+      stage2Mmu(NULL), lastUse(p->size, 0), useStamp(0), pageShifts(0),
+      microTlbNext(0), contentStamp(0), bootUncacheability(false),
       aarch64(false), aarch64EL(EL0), isPriv(false), isSecure(false),
       isHyp(false), asid(0), vmid(0), dacr(0),
       miscRegValid(false), curTranType(NormalTran)
 {
+    if (assoc <= 0 || size % assoc != 0 || !isPowerOf2(numSets))
+        fatal("%s: TLB size %d is not a power of two number of sets of "
+              "%d entries\n", name(), size, assoc);
+
+    for (int i = 0; i < 64; i++)
+        pageShiftCount[i] = 0;
+    for (int i = 0; i < MicroTlbSize; i++)
+        microTlb[i] = NULL;
+    for (int i = 0; i < CombinedSize; i++)
+        combined[i].s1Te = NULL;
+
     tableWalker->setTlb(this);
 
     // Cache system-level properties
@@ -134,31 +148,39 @@ TlbEntry*
 TLB::lookup(Addr va, uint16_t asn, uint8_t vmid, bool hyp, bool secure,
             bool functional, bool ignore_asn, uint8_t target_el)
 {
+    auto matches = [&](const TlbEntry &te) {
+        return ignore_asn ? te.match(va, vmid, hyp, secure, target_el) :
+            te.match(va, asn, vmid, hyp, secure, false, target_el);
+    };
 
     TlbEntry *retval = NULL;
 
-    // Maintaining LRU array
-    int x = 0;
-    while (retval == NULL && x < size) {
-        if ((!ignore_asn && table[x].match(va, asn, vmid, hyp, secure, false,
-             target_el)) ||
-            (ignore_asn && table[x].match(va, vmid, hyp, secure, target_el))) {
-            // We only move the hit entry ahead when the position is higher
-            // than rangeMRU
-            if (x > rangeMRU && !functional) {
-                TlbEntry tmp_entry = table[x];
-                for(int i = x; i > 0; i--)
-                    table[i] = table[i - 1];
-                table[0] = tmp_entry;
-                retval = &table[0];
-            } else {
-                retval = &table[x];
-            }
+    for (int i = 0; i < MicroTlbSize; i++) {
+        if (microTlb[i] && matches(*microTlb[i])) {
+            retval = microTlb[i];
             break;
         }
-        ++x;
     }
 
+    // Otherwise probe the set of va for each page size in the TLB
+    for (uint64_t shifts = pageShifts; !retval && shifts;
+         shifts &= shifts - 1) {
+        TlbEntry *set = setOf(va >> findLsbSet(shifts));
+        for (int w = 0; w < assoc; w++) {
+            if (matches(set[w])) {
+                retval = &set[w];
+                if (!functional) {
+                    microTlb[microTlbNext] = retval;
+                    microTlbNext = (microTlbNext + 1) % MicroTlbSize;
+                }
+                break;
+            }
+        }
+    }
+
+    if (retval && !functional)
+        lastUse[retval - table] = ++useStamp;
+
     DPRINTF(TLBVerbose, "Lookup %#x, asn %#x -> %s vmn 0x%x hyp %d secure %d "
             "ppn %#x size: %#x pa: %#x ap:%d ns:%d nstid:%d g:%d asid: %d "
             "el: %d\n",
@@ -184,23 +206,60 @@ TLB::insert(Addr addr, TlbEntry &entry)
             entry.ap, static_cast<uint8_t>(entry.domain), entry.ns, entry.nstid,
             entry.isHyp);
 
-    if (table[size - 1].valid)
+    placeEntry(entry);
+
+    inserts++;
+    ppRefills->notify(1);
+}
+
+TlbEntry *
+TLB::placeEntry(const TlbEntry &entry)
+{
+    // Fill an invalid way of the set, or else evict the least recently
+    // used one
+    TlbEntry *set = setOf(entry.vpn);
+    TlbEntry *victim = set;
+    for (int w = 0; w < assoc; w++) {
+        if (!set[w].valid) {
+            victim = &set[w];
+            break;
+        }
+        if (lastUse[&set[w] - table] < lastUse[victim - table])
+            victim = &set[w];
+    }
+
+    if (victim->valid) {
         DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
                 "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
-                table[size-1].vpn << table[size-1].N, table[size-1].asid,
-                table[size-1].vmid, table[size-1].pfn << table[size-1].N,
-                table[size-1].size, table[size-1].ap, table[size-1].ns,
-                table[size-1].nstid, table[size-1].global, table[size-1].isHyp,
-                table[size-1].el);
+                victim->vpn << victim->N, victim->asid, victim->vmid,
+                victim->pfn << victim->N, victim->size, victim->ap,
+                victim->ns, victim->nstid, victim->global, victim->isHyp,
+                victim->el);
+        invalidateEntry(victim);
+    }
 
-    //inserting to MRU position and evicting the LRU one
+    *victim = entry;
+    addEntry(*victim);
+    contentStamp++;
+    lastUse[victim - table] = ++useStamp;
+    return victim;
+}
 
-    for (int i = size - 1; i > 0; --i)
-        table[i] = table[i-1];
-    table[0] = entry;
+void
+TLB::addEntry(const TlbEntry &te)
+{
+    if (te.valid && pageShiftCount[te.N]++ == 0)
+        pageShifts |= ULL(1) << te.N;
+}
 
-    inserts++;
-    ppRefills->notify(1);
+void
+TLB::invalidateEntry(TlbEntry *te)
+{
+    assert(te->valid && pageShiftCount[te->N] > 0);
+    te->valid = false;
+    contentStamp++;
+    if (--pageShiftCount[te->N] == 0)
+        pageShifts &= ~(ULL(1) << te->N);
 }
 
 void
@@ -231,13 +290,15 @@ TLB::flushAllSecurity(bool secure_lookup, uint8_t target_el, bool ignore_el)
             checkELMatch(target_el, te->el, ignore_el)) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidateEntry(te);
             flushedEntries++;
         }
         ++x;
     }
 
     flushTlb++;
+    _generation++;
+    tableWalker->flushWalkCache();
 
     // If there's a second stage TLB (and we're not it) then flush it as well
     // if we're currently in hyp mode
@@ -260,12 +321,14 @@ TLB::flushAllNs(bool hyp, uint8_t target_el, bool ignore_el)
 
             DPRINTF(TLB, " -  %s\n", te->print());
             flushedEntries++;
-            te->valid = false;
+            invalidateEntry(te);
         }
         ++x;
     }
 
     flushTlb++;
+    _generation++;
+    tableWalker->flushWalkCache();
 
     // If there's a second stage TLB (and we're not it) then flush it as well
     if (!isStage2 && !hyp) {
@@ -281,6 +344,8 @@ TLB::flushMvaAsid(Addr mva, uint64_t asn, bool secure_lookup, uint8_t target_el)
             "secure" : "non-secure"));
     _flushMva(mva, asn, secure_lookup, false, false, target_el);
     flushTlbMvaAsid++;
+    _generation++;
+    tableWalker->flushWalkCache();
 }
 
 void
@@ -298,13 +363,15 @@ TLB::flushAsid(uint64_t asn, bool secure_lookup, uint8_t target_el)
             (te->vmid == vmid || secure_lookup) &&
             checkELMatch(target_el, te->el, false)) {
 
-            te->valid = false;
+            invalidateEntry(te);
             DPRINTF(TLB, " -  %s\n", te->print());
             flushedEntries++;
         }
         ++x;
     }
     flushTlbAsid++;
+    _generation++;
+    tableWalker->flushWalkCache();
 }
 
 void
@@ -314,6 +381,8 @@ TLB::flushMva(Addr mva, bool secure_lookup, bool hyp, uint8_t target_el)
             (secure_lookup ? "secure" : "non-secure"));
     _flushMva(mva, 0xbeef, secure_lookup, hyp, true, target_el);
     flushTlbMva++;
+    _generation++;
+    tableWalker->flushWalkCache();
 }
 
 void
@@ -328,7 +397,7 @@ TLB::_flushMva(Addr mva, uint64_t asn, bool secure_lookup, bool hyp,
     while (te != NULL) {
         if (secure_lookup == !te->nstid) {
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidateEntry(te);
             flushedEntries++;
         }
         te = lookup(mva, asn, vmid, hyp, secure_lookup, false, ignore_asn,
@@ -356,6 +425,7 @@ TLB::drainResume()
     // We might have unserialized something or switched CPUs, so make
     // sure to re-read the misc regs.
     miscRegValid = false;
+    _generation++;
 }
 
 void
@@ -380,6 +450,8 @@ TLB::takeOverFrom(BaseTLB *_otlb)
     } else {
         panic("Incompatible TLB type!");
     }
+
+    _generation++;
 }
 
 void
@@ -412,11 +484,23 @@ TLB::unserialize(Checkpoint *cp, const string &section)
     UNSERIALIZE_SCALAR(stage2Req);
     UNSERIALIZE_SCALAR(bootUncacheability);
 
+    for (int i = 0; i < size; i++) {
+        if (table[i].valid)
+            invalidateEntry(&table[i]);
+    }
+
+    // The entries go back into the sets of their pages, which need
+    // not be where they were when checkpointed
     int num_entries;
     UNSERIALIZE_SCALAR(num_entries);
-    for(int i = 0; i < min(size, num_entries); i++){
-        table[i].unserialize(cp, csprintf("%s.TlbEntry%d", section, i));
+    for (int i = 0; i < num_entries; i++) {
+        TlbEntry te;
+        te.unserialize(cp, csprintf("%s.TlbEntry%d", section, i));
+        if (te.valid)
+            placeEntry(te);
     }
+
+    _generation++;
 }
 
 void
@@ -527,6 +611,11 @@ TLB::regStats()
         .desc("Number of TLB faults due to permissions restrictions")
         ;
 
+    combinedHits
+        .name(name() + ".combined_hits")
+        .desc("Number of stage 2 lookups that reused a merged entry")
+        ;
+
     instAccesses = instHits + instMisses;
     readAccesses = readHits + readMisses;
     writeAccesses = writeHits + writeMisses;
@@ -1411,12 +1500,38 @@ TLB::getResultTe(TlbEntry **te, RequestPtr req, ThreadContext *tc, Mode mode,
             fault = checkPermissions64(s1Te, req, mode, tc);
         else
             fault = checkPermissions(s1Te, req, mode);
-        if (stage2Req & (fault == NoFault)) {
+        CombinedEntry *ce = &combined[(s1Te - table) & (CombinedSize - 1)];
+        if (stage2Req && fault == NoFault && ce->s1Te == s1Te &&
+            ce->stamp == combinedStamp() &&
+            (vaddr_tainted & ~ce->merged.size) == ce->vpage) {
+            // Both stages were looked up and merged before, so only the
+            // stage 2 permissions of this access are left to check
+            Request s2Req;
+            s2Req.setVirt(0, s1Te->pAddr(vaddr_tainted), req->getSize(),
+                          req->getFlags(), req->masterId(), 0);
+            fault = stage2Tlb->checkPermissions(ce->s2Te, &s2Req, mode);
+            if (fault != NoFault) {
+                reinterpret_cast<ArmFault *>(fault.get())->annotate(
+                    ArmFault::OVA, vaddr_tainted);
+                *mergeTe = *s1Te;
+            } else {
+                *mergeTe = ce->merged;
+                combinedHits++;
+            }
+            *te = mergeTe;
+        } else if (stage2Req & (fault == NoFault)) {
             Stage2LookUp *s2Lookup = new Stage2LookUp(this, stage2Tlb, *s1Te,
                 req, translation, mode, timing, functional, curTranType);
             fault = s2Lookup->getTe(tc, mergeTe);
             if (s2Lookup->isComplete()) {
                 *te = mergeTe;
+                if (fault == NoFault) {
+                    ce->s1Te = s1Te;
+                    ce->s2Te = s2Lookup->getStage2Te();
+                    ce->vpage = vaddr_tainted & ~mergeTe->size;
+                    ce->stamp = combinedStamp();
+                    ce->merged = *mergeTe;
+                }
                 // We've finished with the lookup so delete it
                 delete s2Lookup;
             } else {
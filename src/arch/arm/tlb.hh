@@ -44,6 +44,8 @@
 #define __ARCH_ARM_TLB_HH__
 
 
+#include <vector>
+
 #include "arch/arm/isa_traits.hh"
 #include "arch/arm/pagetable.hh"
 #include "arch/arm/utility.hh"
@@ -96,6 +98,8 @@ class TLB : public BaseTLB
   protected:
     TlbEntry* table;     // the Page Table
     int size;            // TLB Size
+    int assoc;           // Entries per set of table
+    int numSets;         // Sets in table, a power of two
     bool isStage2;       // Indicates this TLB is part of the second stage MMU
     bool stage2Req;      // Indicates whether a stage 2 lookup is also required
     uint64_t _attr;      // Memory attributes for last accessed TLB entry
@@ -123,6 +127,7 @@ class TLB : public BaseTLB
     mutable Stats::Scalar prefetchFaults;
     mutable Stats::Scalar domainFaults;
     mutable Stats::Scalar permsFaults;
+    mutable Stats::Scalar combinedHits;
 
     Stats::Formula readAccesses;
     Stats::Formula writeAccesses;
@@ -134,7 +139,45 @@ class TLB : public BaseTLB
     /** PMU probe for TLB refills */
     ProbePoints::PMUUPtr ppRefills;
 
-    int rangeMRU; //On lookup, only move entries ahead when outside rangeMRU
+    // Replacement state: the time of the last use of each entry
+    std::vector<uint64_t> lastUse;
+    uint64_t useStamp;
+
+    // The valid entries of each page size (by log2), and a mask of the
+    // page sizes that have any, which lookups probe in turn
+    uint32_t pageShiftCount[64];
+    uint64_t pageShifts;
+
+    // Fully associative micro-TLB of the entries of the last hits.
+    // An entry it points to may have been replaced since, so a hit is
+    // only taken after a full match.
+    static const int MicroTlbSize = 4;
+    TlbEntry *microTlb[MicroTlbSize];
+    int microTlbNext;
+
+    // Bumped whenever an entry is filled or invalidated
+    uint64_t contentStamp;
+
+    // The merged stage 1 and 2 results of the last lookups through the
+    // stage 2 MMU, indexed by the stage 1 entry they came from.  One is
+    // only used while neither TLB has changed since it was made, and
+    // the stage 2 permissions are still checked for each access.
+    struct CombinedEntry
+    {
+        const TlbEntry *s1Te;
+        TlbEntry *s2Te;
+        Addr vpage;
+        uint64_t stamp;
+        TlbEntry merged;
+    };
+    static const int CombinedSize = 16;
+    CombinedEntry combined[CombinedSize];
+
+    uint64_t
+    combinedStamp() const
+    {
+        return contentStamp + stage2Tlb->contentStamp;
+    }
 
     bool bootUncacheability;
 
@@ -169,6 +212,22 @@ class TLB : public BaseTLB
 
     void insert(Addr vaddr, TlbEntry &pte);
 
+  protected:
+    /** First entry of the set of a page number, at any page size */
+    TlbEntry *
+    setOf(Addr vpn) const
+    {
+        return &table[(vpn & (numSets - 1)) * assoc];
+    }
+
+    /** Put an entry in its set, evicting another if need be */
+    TlbEntry *placeEntry(const TlbEntry &te);
+
+    void addEntry(const TlbEntry &te);
+    void invalidateEntry(TlbEntry *te);
+
+  public:
+
     Fault getTE(TlbEntry **te, RequestPtr req, ThreadContext *tc, Mode mode,
                 Translation *translation, bool timing, bool functional,
                 bool is_secure, ArmTranslationType tranType);
@@ -353,7 +412,19 @@ public:
     {
         return dynamic_cast<const Params *>(_params);
     }
-    inline void invalidateMiscReg() { miscRegValid = false; }
+    inline void invalidateMiscReg()
+    {
+        miscRegValid = false;
+        _generation++;
+    }
+
+    /** Includes the second stage TLB's flushes */
+    uint64_t
+    generation() const M5_ATTR_OVERRIDE
+    {
+        return _generation +
+            (stage2Tlb && !isStage2 ? stage2Tlb->generation() : 0);
+    }
 
 private:
     /** Remove any entries that match both a va and asn
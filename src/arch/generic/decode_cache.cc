@@ -41,18 +41,26 @@ StaticInstPtr
 BasicDecodeCache::decode(TheISA::Decoder *decoder,
         TheISA::ExtMachInst mach_inst, Addr addr)
 {
-    StaticInstPtr &si = decodePages.lookup(addr);
-    if (si && (si->machInst == mach_inst))
-        return si;
+    // Instructions are at least two byte aligned on most ISAs.
+    RecentDecode &recent = recentDecodes[(addr >> 1) % NumRecentDecodes];
+    if (recent.addr == addr && recent.si &&
+            (recent.si->machInst == mach_inst)) {
+        return recent.si;
+    }
 
-    DecodeCache::InstMap::iterator iter = instMap.find(mach_inst);
-    if (iter != instMap.end()) {
-        si = iter->second;
-        return si;
+    StaticInstPtr &si = decodePages.lookup(addr);
+    if (!si || !(si->machInst == mach_inst)) {
+        DecodeCache::InstMap::iterator iter = instMap.find(mach_inst);
+        if (iter != instMap.end()) {
+            si = iter->second;
+        } else {
+            si = decoder->decodeInst(mach_inst);
+            instMap[mach_inst] = si;
+        }
     }
 
-    si = decoder->decodeInst(mach_inst);
-    instMap[mach_inst] = si;
+    recent.addr = addr;
+    recent.si = si;
     return si;
 }
 
@@ -50,7 +50,23 @@ class BasicDecodeCache
     DecodeCache::InstMap instMap;
     DecodeCache::AddrMap<StaticInstPtr> decodePages;
 
+    /// A small direct mapped cache of recent decodes indexed by address
+    /// bits, checked before decodePages.
+    struct RecentDecode
+    {
+        Addr addr;
+        StaticInstPtr si;
+    };
+    static const unsigned NumRecentDecodes = 256;
+    RecentDecode recentDecodes[NumRecentDecodes];
+
   public:
+    BasicDecodeCache()
+    {
+        for (unsigned i = 0; i < NumRecentDecodes; i++)
+            recentDecodes[i].addr = 0;
+    }
+
     /// Decode a machine instruction.
     /// @param mach_inst The binary instruction to decode.
     /// @retval A pointer to the corresponding StaticInst object.
@@ -54,13 +54,25 @@ class BaseTLB : public SimObject
 {
   protected:
     BaseTLB(const Params *p)
-        : SimObject(p)
+        : SimObject(p), _generation(0)
     {}
 
+    /** Bumped by TLBs that track generations, see generation() */
+    uint64_t _generation;
+
   public:
     enum Mode { Read, Write, Execute };
 
   public:
+    /**
+     * A count that changes whenever a translation this TLB has returned
+     * may no longer hold: on flushes and on changes to the translation
+     * context.  Lets clients that keep translations revalidate them with
+     * a single compare.  Only the ARM TLB maintains it; for the others
+     * it never changes.
+     */
+    virtual uint64_t generation() const { return _generation; }
+
     virtual void demapPage(Addr vaddr, uint64_t asn) = 0;
 
     /**
@@ -1201,18 +1201,35 @@ class ISAParser(Grammar):
             self.includes = includes
             self.strings = strings
 
-    def __init__(self, output_dir):
+    def __init__(self, output_dir, cpu_models=['ExecContext']):
         super(ISAParser, self).__init__()
         self.output_dir = output_dir
 
         self.filename = None # for output file watermarking/scaremongering
 
-        self.cpuModels = [
+        # The generic model works with any CPU through the virtual
+        # ExecContext interface.  The others name a concrete (final) exec
+        # context so that the operand accesses of their copy of each
+        # execute() bind statically and can be inlined.
+        known_models = [
             ISAParser.CpuModel('ExecContext',
                                'generic_cpu_exec.cc',
                                '#include "cpu/exec_context.hh"',
                                { "CPU_exec_context" : "ExecContext" }),
+            ISAParser.CpuModel('MinorCPU',
+                               'minor_cpu_exec.cc',
+                               '#include "cpu/minor/exec_context.hh"',
+                               { "CPU_exec_context" : "Minor::ExecContext" }),
+            ISAParser.CpuModel('AtomicSimpleCPU',
+                               'atomic_simple_cpu_exec.cc',
+                               '#include "cpu/simple/atomic.hh"',
+                               { "CPU_exec_context" : "AtomicSimpleCPU" }),
             ]
+        known_models = dict((m.name, m) for m in known_models)
+        for name in cpu_models:
+            if name not in known_models:
+                error('unknown CPU model "%s"' % name)
+        self.cpuModels = [ known_models[name] for name in cpu_models ]
 
         # variable to hold templates
         self.templateMap = {}
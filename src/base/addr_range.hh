@@ -198,6 +198,21 @@ class AddrRange
         return ULL(1) << (intlvHighBit - intlvBits + 1);
     }
 
+    /**
+     * Determine the largest aligned block size that is never split
+     * between stripes, which for hashed interleaving also depends on
+     * the XOR bits.
+     *
+     * @return The size of the blocks that lie in a single stripe
+     */
+    uint64_t stripeGranularity() const
+    {
+        uint8_t high_bit = intlvHighBit;
+        if (hashed() && xorHighBit < intlvHighBit)
+            high_bit = xorHighBit;
+        return ULL(1) << (high_bit - intlvBits + 1);
+    }
+
     /**
      * Determine the number of interleaved address stripes this range
      * is part of.
@@ -206,6 +221,27 @@ class AddrRange
      */
     uint32_t stripes() const { return ULL(1) << intlvBits; }
 
+    /**
+     * Get the interleaving value of an address, i.e. the (optionally
+     * hashed) interleaving bits that select the stripe. Only
+     * meaningful for interleaved ranges.
+     *
+     * @param a Address to extract the interleaving bits from
+     * @return The stripe the address belongs to
+     */
+    uint8_t intlvSelect(const Addr& a) const
+    {
+        uint8_t sel = bits(a, intlvHighBit, intlvHighBit - intlvBits + 1);
+        if (hashed())
+            sel ^= bits(a, xorHighBit, xorHighBit - intlvBits + 1);
+        return sel;
+    }
+
+    /**
+     * Get the interleaving value this range responds to.
+     */
+    uint8_t intlvMatchValue() const { return intlvMatch; }
+
     /**
      * Get the size of the address range. For a case where
      * interleaving is used we make the simplifying assumption that
@@ -334,14 +370,7 @@ class AddrRange
         if (!interleaved()) {
             return in_range;
         } else if (in_range) {
-            if (!hashed()) {
-                return bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ==
-                    intlvMatch;
-            } else {
-                return (bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ^
-                        bits(a, xorHighBit, xorHighBit - intlvBits + 1)) ==
-                    intlvMatch;
-            }
+            return intlvSelect(a) == intlvMatch;
         }
         return false;
     }
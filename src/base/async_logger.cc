@@ -0,0 +1,207 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+
+#include "base/async_logger.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+
+namespace Trace {
+
+/** The logger the calling thread's buffer slot belongs to, and the
+ *  slot */
+static __thread AsyncLogger *threadOwner = NULL;
+static __thread void *threadSlot = NULL;
+
+AsyncLogger::BufferStreambuf::int_type
+AsyncLogger::BufferStreambuf::overflow(int_type c)
+{
+    if (c != traits_type::eof()) {
+        char ch = traits_type::to_char_type(c);
+        logger.append(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+AsyncLogger::BufferStreambuf::xsputn(const char *s, std::streamsize n)
+{
+    logger.append(s, n);
+    return n;
+}
+
+AsyncLogger::AsyncLogger(const std::string &name, size_t buffer_bytes) :
+    stream(simout.find(name)), bufferBytes(buffer_bytes), maxQueued(16),
+    writing(false), stopping(false), streambuf(*this),
+    bufferStream(&streambuf)
+{
+    if (bufferBytes == 0)
+        fatal("Debug trace buffers must be at least one byte\n");
+
+    if (!stream)
+        stream = simout.create(name);
+
+    writer = std::thread(&AsyncLogger::writeLoop, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    flush();
+
+    {
+        std::lock_guard<std::mutex> held(lock);
+        stopping = true;
+    }
+    queued.notify_one();
+    writer.join();
+
+    for (auto i = threadBuffers.begin(); i != threadBuffers.end(); ++i)
+        delete *i;
+    for (auto i = freeBuffers.begin(); i != freeBuffers.end(); ++i)
+        delete *i;
+}
+
+AsyncLogger::Buffer *&
+AsyncLogger::threadBuffer()
+{
+    if (threadOwner != this) {
+        Buffer *buffer = new Buffer;
+        buffer->reserve(bufferBytes);
+
+        std::lock_guard<std::mutex> held(lock);
+        threadBuffers.push_back(buffer);
+        threadOwner = this;
+        threadSlot = &threadBuffers.back();
+    }
+
+    return *static_cast<Buffer **>(threadSlot);
+}
+
+void
+AsyncLogger::handOff(Buffer *&slot, std::unique_lock<std::mutex> &held)
+{
+    /* Let the writer catch up rather than buffer without bound */
+    written.wait(held, [this] { return queue.size() < maxQueued; });
+
+    queue.push_back(slot);
+
+    if (freeBuffers.empty()) {
+        slot = new Buffer;
+        slot->reserve(bufferBytes);
+    } else {
+        slot = freeBuffers.back();
+        freeBuffers.pop_back();
+    }
+
+    queued.notify_one();
+}
+
+void
+AsyncLogger::append(const char *data, size_t size)
+{
+    Buffer *&slot = threadBuffer();
+
+    if (!slot->empty() && slot->size() + size > bufferBytes) {
+        std::unique_lock<std::mutex> held(lock);
+        handOff(slot, held);
+    }
+
+    slot->insert(slot->end(), data, data + size);
+}
+
+void
+AsyncLogger::logMessage(Tick when, const std::string &name,
+                        const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    if (when != MaxTick) {
+        char prefix[32];
+        int length = snprintf(prefix, sizeof(prefix), "%7llu: ",
+                              (unsigned long long)when);
+        append(prefix, length);
+    }
+
+    if (!name.empty()) {
+        append(name.data(), name.size());
+        append(": ", 2);
+    }
+
+    append(message.data(), message.size());
+}
+
+void
+AsyncLogger::writeBuffer(const Buffer &buffer)
+{
+    stream->write(&buffer[0], buffer.size());
+}
+
+void
+AsyncLogger::writeLoop()
+{
+    std::unique_lock<std::mutex> held(lock);
+
+    while (true) {
+        queued.wait(held, [this] { return stopping || !queue.empty(); });
+
+        if (queue.empty())
+            return;
+
+        Buffer *buffer = queue.front();
+        queue.pop_front();
+        writing = true;
+
+        /* Write without holding up the loggers */
+        held.unlock();
+        writeBuffer(*buffer);
+        buffer->clear();
+        held.lock();
+
+        freeBuffers.push_back(buffer);
+        writing = false;
+        written.notify_all();
+    }
+}
+
+void
+AsyncLogger::flush()
+{
+    std::unique_lock<std::mutex> held(lock);
+
+    for (auto i = threadBuffers.begin(); i != threadBuffers.end(); ++i) {
+        if (!(*i)->empty())
+            handOff(*i, held);
+    }
+
+    written.wait(held, [this] { return queue.empty() && !writing; });
+
+    stream->flush();
+}
+
+} // namespace Trace
@@ -0,0 +1,155 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * A debug logger which hands trace output to a background writer thread
+ * so that tracing-enabled runs are not bound by output I/O.
+ */
+
+#ifndef __BASE_ASYNC_LOGGER_HH__
+#define __BASE_ASYNC_LOGGER_HH__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/trace.hh"
+
+namespace Trace {
+
+/** Logger which formats messages into a buffer belonging to the calling
+ *  thread and passes each full buffer to a writer thread, which also
+ *  does the compression of .gz output files.  Messages
+ *  from one thread stay in order, messages from different simulation
+ *  threads are interleaved a buffer at a time.
+ *
+ *  Buffers are flushed by flush(), which Trace::flush calls before
+ *  fatal() or panic() end the simulator, and when the logger is
+ *  replaced or destroyed, which an atexit handler does for normal exits */
+class AsyncLogger : public Logger
+{
+  protected:
+    typedef std::vector<char> Buffer;
+
+    /** streambuf which appends to the calling thread's buffer, behind
+     *  getOstream */
+    class BufferStreambuf : public std::streambuf
+    {
+      protected:
+        AsyncLogger &logger;
+
+      public:
+        BufferStreambuf(AsyncLogger &logger_) : logger(logger_) { }
+
+      protected:
+        int_type overflow(int_type c) M5_ATTR_OVERRIDE;
+        std::streamsize xsputn(const char *s,
+                               std::streamsize n) M5_ATTR_OVERRIDE;
+    };
+
+    /** Output stream, only written by the writer thread */
+    std::ostream *stream;
+
+    /** Bytes each buffer holds before it is handed to the writer */
+    const size_t bufferBytes;
+
+    /** Full buffers the writer may lag behind by before loggers wait */
+    const size_t maxQueued;
+
+    /** Every thread's buffer slot, for flush.  A deque so that slots
+     *  stay put as threads are added.  Guarded by lock */
+    std::deque<Buffer *> threadBuffers;
+
+    /** Full buffers waiting to be written, oldest first */
+    std::deque<Buffer *> queue;
+
+    /** Written buffers for reuse */
+    std::vector<Buffer *> freeBuffers;
+
+    /** The writer is writing a buffer taken off the queue */
+    bool writing;
+
+    /** Tell the writer to finish */
+    bool stopping;
+
+    std::mutex lock;
+
+    /** Signalled when the queue gains a buffer or stopping is set */
+    std::condition_variable queued;
+
+    /** Signalled when the writer finishes writing a buffer */
+    std::condition_variable written;
+
+    BufferStreambuf streambuf;
+    std::ostream bufferStream;
+
+    std::thread writer;
+
+    /** The calling thread's buffer slot, created on first use */
+    Buffer *&threadBuffer();
+
+    /** Append to the calling thread's buffer, handing it to the writer
+     *  first if the data doesn't fit */
+    void append(const char *data, size_t size);
+
+    /** Queue the buffer in slot (which must hold data) and replace it
+     *  with an empty one.  lock must be held */
+    void handOff(Buffer *&slot, std::unique_lock<std::mutex> &held);
+
+    /** Write one buffer to the output */
+    void writeBuffer(const Buffer &buffer);
+
+    /** The writer thread */
+    void writeLoop();
+
+  public:
+    /** Trace to the file name in the output directory (which may be
+     *  cout or cerr), compressed if it ends in .gz */
+    AsyncLogger(const std::string &name, size_t buffer_bytes);
+
+    ~AsyncLogger();
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) M5_ATTR_OVERRIDE;
+
+    std::ostream &getOstream() M5_ATTR_OVERRIDE { return bufferStream; }
+
+    /** Pass every thread's buffered output to the writer and wait for
+     *  it to be written.  Other simulation threads must not be tracing */
+    void flush() M5_ATTR_OVERRIDE;
+};
+
+} // namespace Trace
+
+#endif // __BASE_ASYNC_LOGGER_HH__
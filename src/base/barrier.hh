@@ -40,40 +40,61 @@
 #ifndef __BASE_BARRIER_HH__
 #define __BASE_BARRIER_HH__
 
+#include <atomic>
 #include <condition_variable>
+#include <mutex>
 
+/**
+ * Reusable thread barrier. Threads arriving at the barrier first spin
+ * for a bounded number of iterations, since with one simulation thread
+ * per host core the other threads usually arrive within a short time,
+ * and only then block on a condition variable.
+ */
 class Barrier
 {
   private:
-    /// Mutex to protect access to numLeft and generation
+    /// Mutex and condition variable used once spinning gives up
     std::mutex bMutex;
-    /// Condition variable for waiting on barrier
     std::condition_variable bCond;
     /// Number of threads we should be waiting for before completing the barrier
-    unsigned numWaiting;
+    const unsigned numWaiting;
+    /// Number of polls of the generation before blocking
+    const unsigned spinCount;
     /// Generation of this barrier
-    unsigned generation;
+    std::atomic<unsigned> generation;
     /// Number of threads remaining for the current generation
-    unsigned numLeft;
+    std::atomic<unsigned> numLeft;
 
   public:
-    Barrier(unsigned _numWaiting)
-        : numWaiting(_numWaiting), generation(0), numLeft(_numWaiting)
+    Barrier(unsigned _numWaiting, unsigned _spinCount = 4096)
+        : numWaiting(_numWaiting), spinCount(_spinCount), generation(0),
+          numLeft(_numWaiting)
     {}
 
     bool
     wait()
     {
-        std::unique_lock<std::mutex> lock(bMutex);
-        unsigned int gen = generation;
+        unsigned gen = generation.load(std::memory_order_acquire);
 
-        if (--numLeft == 0) {
-            generation++;
-            numLeft = numWaiting;
+        if (numLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            numLeft.store(numWaiting, std::memory_order_relaxed);
+            {
+                // Bump the generation under the mutex so that a thread
+                // about to block can't miss the notification.
+                std::lock_guard<std::mutex> lock(bMutex);
+                generation.store(gen + 1, std::memory_order_release);
+            }
             bCond.notify_all();
             return true;
         }
-        while (gen == generation)
+
+        for (unsigned i = 0; i < spinCount; ++i) {
+            if (generation.load(std::memory_order_acquire) != gen)
+                return false;
+        }
+
+        std::unique_lock<std::mutex> lock(bMutex);
+        while (generation.load(std::memory_order_acquire) == gen)
             bCond.wait(lock);
         return false;
     }
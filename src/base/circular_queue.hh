@@ -0,0 +1,217 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Fixed-capacity circular queue with std::list-like iterators.
+ */
+
+#ifndef __BASE_CIRCULAR_QUEUE_HH__
+#define __BASE_CIRCULAR_QUEUE_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+/**
+ * A queue that supports push_back, pop_front and pop_back on a ring of
+ * pre-allocated slots, so inserting an element never touches the heap.
+ *
+ * Iterators hold a logical position that is never reused while the
+ * element is in the queue, so, like std::list, an iterator stays valid
+ * until its own element is removed.  The end() iterator is the same
+ * value however many elements are pushed or popped, and decrementing it
+ * yields the last element.  Elements are kept in insertion order and
+ * can be indexed from the front in constant time.
+ */
+template <class T>
+class CircularQueue
+{
+  private:
+    /** Logical position used by end(). */
+    static const size_t npos = std::numeric_limits<size_t>::max();
+
+    std::vector<T> buf;
+
+    /** Logical position of the front element. */
+    size_t _head;
+
+    size_t _size;
+
+    T &at(size_t pos) { return buf[pos % buf.size()]; }
+    const T &at(size_t pos) const { return buf[pos % buf.size()]; }
+
+  public:
+    class iterator : public std::iterator<std::bidirectional_iterator_tag, T>
+    {
+      private:
+        CircularQueue *queue;
+        size_t pos;
+
+        friend class CircularQueue;
+
+        iterator(CircularQueue *q, size_t p) : queue(q), pos(p) { }
+
+      public:
+        iterator() : queue(NULL), pos(npos) { }
+
+        T &operator*() const
+        {
+            assert(pos != npos);
+            return queue->at(pos);
+        }
+
+        T *operator->() const { return &**this; }
+
+        iterator &
+        operator++()
+        {
+            assert(pos != npos);
+            pos = pos + 1 == queue->_head + queue->_size ? npos : pos + 1;
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        iterator &
+        operator--()
+        {
+            if (pos == npos) {
+                assert(queue->_size);
+                pos = queue->_head + queue->_size - 1;
+            } else {
+                assert(pos != queue->_head);
+                --pos;
+            }
+            return *this;
+        }
+
+        iterator
+        operator--(int)
+        {
+            iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool
+        operator==(const iterator &other) const
+        {
+            return queue == other.queue && pos == other.pos;
+        }
+
+        bool operator!=(const iterator &other) const
+        { return !(*this == other); }
+    };
+
+    explicit CircularQueue(size_t capacity = 0)
+        : buf(capacity), _head(0), _size(0)
+    { }
+
+    /** Change the number of slots; the queue must be empty. */
+    void
+    resize(size_t capacity)
+    {
+        assert(empty());
+        buf.assign(capacity, T());
+        _head = 0;
+    }
+
+    size_t capacity() const { return buf.size(); }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size == buf.size(); }
+
+    T &front() { assert(_size); return at(_head); }
+    T &back() { assert(_size); return at(_head + _size - 1); }
+    const T &front() const { assert(_size); return at(_head); }
+    const T &back() const { assert(_size); return at(_head + _size - 1); }
+
+    /** Element at an offset from the front. */
+    T &operator[](size_t idx) { assert(idx < _size); return at(_head + idx); }
+    const T &operator[](size_t idx) const
+    { assert(idx < _size); return at(_head + idx); }
+
+    void
+    push_front(const T &val)
+    {
+        assert(!full());
+        if (_head == 0)
+            _head = buf.size();
+        --_head;
+        at(_head) = val;
+        ++_size;
+    }
+
+    void
+    push_back(const T &val)
+    {
+        assert(!full());
+        at(_head + _size) = val;
+        ++_size;
+    }
+
+    /** Remove the front element, releasing whatever it held. */
+    void
+    pop_front()
+    {
+        assert(_size);
+        at(_head) = T();
+        ++_head;
+        --_size;
+    }
+
+    /** Remove the back element, releasing whatever it held. */
+    void
+    pop_back()
+    {
+        assert(_size);
+        --_size;
+        at(_head + _size) = T();
+    }
+
+    void
+    clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+    iterator begin() { return iterator(this, _size ? _head : npos); }
+    iterator end() { return iterator(this, npos); }
+};
+
+#endif // __BASE_CIRCULAR_QUEUE_HH__
@@ -39,8 +39,51 @@ using namespace std;
 
 namespace cp {
 
+FormatString::FormatString(const char *format)
+    : source(format)
+{
+    std::ostringstream text;
+    Print print(text, format);
+
+    while (print.process()) {
+        Conversion conversion;
+        conversion.text = text.str();
+        conversion.flush = conversion.text.find('\n') != string::npos;
+        conversion.fmt = print.fmt;
+        conversion.end = print.ptr;
+
+        /* A '%' that ends the string took its terminator with it */
+        const bool at_end = print.ptr[-1] == '\0';
+        if (at_end)
+            conversion.end--;
+
+        conversions.push_back(conversion);
+        text.str(string());
+
+        if (at_end)
+            break;
+    }
+}
+
+const FormatString *
+FormatCache::parse(const char *format)
+{
+    const FormatString *p = new FormatString(format);
+    const FormatString *expected = NULL;
+
+    /* Somebody else may have been parsing it at the same time */
+    if (!parsed.compare_exchange_strong(expected, p,
+                                        std::memory_order_acq_rel)) {
+        delete p;
+        p = expected;
+    }
+
+    return p;
+}
+
 Print::Print(std::ostream &stream, const std::string &format)
-    : stream(stream), format(format.c_str()), ptr(format.c_str()), cont(false)
+    : stream(stream), format(format.c_str()), ptr(format.c_str()), cont(false),
+      parsed(NULL), next(0)
 {
     saved_flags = stream.flags();
     saved_fill = stream.fill();
@@ -48,7 +91,17 @@ Print::Print(std::ostream &stream, const std::string &format)
 }
 
 Print::Print(std::ostream &stream, const char *format)
-    : stream(stream), format(format), ptr(format), cont(false)
+    : stream(stream), format(format), ptr(format), cont(false),
+      parsed(NULL), next(0)
+{
+    saved_flags = stream.flags();
+    saved_fill = stream.fill();
+    saved_precision = stream.precision();
+}
+
+Print::Print(std::ostream &stream, const FormatString &format)
+    : stream(stream), format(format.source), ptr(format.source),
+      cont(false), parsed(&format), next(0)
 {
     saved_flags = stream.flags();
     saved_fill = stream.fill();
@@ -59,9 +112,26 @@ Print::~Print()
 {
 }
 
-void
+bool
 Print::process()
 {
+    if (parsed && next < parsed->conversions.size()) {
+        const FormatString::Conversion &conversion =
+            parsed->conversions[next++];
+
+        stream.write(conversion.text.data(), conversion.text.size());
+        if (conversion.flush)
+            stream.flush();
+
+        /* As process_flag() leaves the stream */
+        stream.fill(' ');
+        stream.flags((ios::fmtflags)0);
+
+        fmt = conversion.fmt;
+        ptr = conversion.end;
+        return true;
+    }
+
     fmt.clear();
 
     size_t len;
@@ -71,7 +141,7 @@ Print::process()
           case '%':
             if (ptr[1] != '%') {
                 process_flag();
-                return;
+                return true;
             }
             stream.put('%');
             ptr += 2;
@@ -94,6 +164,8 @@ Print::process()
             break;
         }
     }
+
+    return false;
 }
 
 void
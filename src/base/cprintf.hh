@@ -34,15 +34,71 @@
 #ifndef __BASE_CPRINTF_HH__
 #define __BASE_CPRINTF_HH__
 
+#include <atomic>
 #include <ios>
 #include <iostream>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "base/cprintf_formats.hh"
 
 namespace cp {
 
+/**
+ * A format string parsed once into the literal text and the Format of
+ * each of its conversions, so that printing with it only has to format
+ * the arguments.
+ */
+class FormatString
+{
+  public:
+    struct Conversion
+    {
+        /** The literal text before the conversion, escapes resolved */
+        std::string text;
+        /** The text has a newline, after which the stream is flushed */
+        bool flush;
+        Format fmt;
+        /** Where the format string continues after the conversion */
+        const char *end;
+    };
+
+    /** The string this was parsed from */
+    const char *const source;
+    std::vector<Conversion> conversions;
+
+    explicit FormatString(const char *format);
+};
+
+/**
+ * The parsed format of one call site, e.g. of a DPRINTF, which is made
+ * on the first call.  It can be a static as it needs no construction.
+ */
+class FormatCache
+{
+  protected:
+    std::atomic<const FormatString *> parsed;
+
+    const FormatString *parse(const char *format);
+
+  public:
+    constexpr FormatCache() : parsed(nullptr) { }
+
+    /**
+     * The parsed form of format, or NULL if the call site gave another
+     * string the first time round (and so format isn't a constant).
+     */
+    const FormatString *
+    get(const char *format)
+    {
+        const FormatString *p = parsed.load(std::memory_order_acquire);
+        if (!p)
+            p = parse(format);
+        return p->source == format ? p : NULL;
+    }
+};
+
 struct Print
 {
   protected:
@@ -55,13 +111,21 @@ struct Print
     char saved_fill;
     int saved_precision;
 
+    /** The conversions to use instead of parsing format, if any */
+    const FormatString *parsed;
+    /** The next of the parsed conversions */
+    size_t next;
+
     Format fmt;
-    void process();
+    bool process();
     void process_flag();
 
+    friend class FormatString;
+
   public:
     Print(std::ostream &stream, const std::string &format);
     Print(std::ostream &stream, const char *format);
+    Print(std::ostream &stream, const FormatString &format);
     ~Print();
 
     int
@@ -151,6 +215,16 @@ ccprintf(std::ostream &stream, const char *format, const Args &...args)
 }
 
 
+template<typename ...Args> void
+ccprintf(std::ostream &stream, const cp::FormatString &format,
+         const Args &...args)
+{
+    cp::Print print(stream, format);
+
+    ccprintf(print, args...);
+}
+
+
 template<typename ...Args> void
 cprintf(const char *format, const Args &...args)
 {
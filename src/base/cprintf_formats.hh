@@ -34,6 +34,7 @@
 #include <cstring>
 #include <ostream>
 #include <sstream>
+#include <type_traits>
 
 namespace cp {
 
@@ -82,12 +83,132 @@ _format_char(std::ostream &out, const T &data, Format &fmt)
     out << data;
 }
 
+template <typename T>
+inline bool
+_is_negative(const T &data, std::true_type)
+{
+    return data < 0;
+}
+
+template <typename T>
+inline bool
+_is_negative(const T &data, std::false_type)
+{
+    return false;
+}
+
+/**
+ * Format an integer into a buffer and write that out, which is a lot
+ * cheaper than the stream's own number formatting.  This gives the same
+ * text the stream would, and so leaves the flags whose handling by the
+ * stream has corner cases (showpos, left) and excessive widths to it.
+ *
+ * @return Whether the integer was written.
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               !std::is_same<T, bool>::value, bool>::type
+_format_integer_fast(std::ostream &out, const T &data, const Format &fmt)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    const char *hex_digits =
+        fmt.uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    if (fmt.print_sign || fmt.flush_left || fmt.width > 64)
+        return false;
+
+    /* As with the stream, only decimal is signed */
+    const bool negative = fmt.base == Format::dec &&
+        _is_negative(data, std::is_signed<T>());
+    U value = negative ? U(0) - U(data) : U(data);
+    const bool zero = value == 0;
+
+    char buf[96];
+    char *const end = buf + sizeof(buf);
+    char *ptr = end;
+
+    switch (fmt.base) {
+      case Format::hex:
+        do {
+            *--ptr = hex_digits[value & 0xf];
+            value >>= 4;
+        } while (value);
+        break;
+
+      case Format::oct:
+        do {
+            *--ptr = '0' + (value & 0x7);
+            value >>= 3;
+        } while (value);
+        break;
+
+      case Format::dec:
+        while (value >= 100) {
+            const unsigned pair = (value % 100) * 2;
+            value /= 100;
+            *--ptr = pairs[pair + 1];
+            *--ptr = pairs[pair];
+        }
+        if (value >= 10) {
+            *--ptr = pairs[value * 2 + 1];
+            *--ptr = pairs[value * 2];
+        } else {
+            *--ptr = '0' + value;
+        }
+        break;
+    }
+
+    int width = fmt.width;
+    const char *prefix = "";
+
+    if (negative) {
+        *--ptr = '-';
+    } else if (fmt.alternate_form && fmt.base != Format::dec) {
+        /* See _format_integer: fill_zero puts the base before the
+         * padding and shortens it, otherwise it's showbase */
+        if (fmt.fill_zero) {
+            prefix = fmt.base == Format::hex ? "0x" : "0";
+            width -= std::strlen(prefix);
+        } else if (!zero) {
+            if (fmt.base == Format::hex)
+                *--ptr = fmt.uppercase ? 'X' : 'x';
+            *--ptr = '0';
+        }
+    }
+
+    const char fill = fmt.fill_zero ? '0' : ' ';
+    while (end - ptr < width)
+        *--ptr = fill;
+
+    out << prefix;
+    out.write(ptr, end - ptr);
+
+    return true;
+}
+
+template <typename T>
+inline typename std::enable_if<!std::is_integral<T>::value ||
+                               std::is_same<T, bool>::value, bool>::type
+_format_integer_fast(std::ostream &out, const T &data, const Format &fmt)
+{
+    return false;
+}
+
 template <typename T>
 inline void
 _format_integer(std::ostream &out, const T &data, Format &fmt)
 {
     using namespace std;
 
+    if (_format_integer_fast(out, data, fmt))
+        return;
+
     ios::fmtflags flags(out.flags());
 
     switch (fmt.base) {
@@ -0,0 +1,198 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "base/loader/region_map.hh"
+#include "base/loader/symtab.hh"
+#include "base/misc.hh"
+
+using namespace std;
+
+RegionMap debugRegionMap;
+
+const string RegionMap::noName;
+
+RegionMap::RegionMap() :
+    funcNames(1, "other"), lastHit(NULL)
+{
+    const char *default_patterns[] = { "main", "FUNC*" };
+
+    setROIPatterns(vector<string>(default_patterns, default_patterns + 2));
+}
+
+RegionMap::~RegionMap()
+{
+    clearPatterns();
+}
+
+void
+RegionMap::clearPatterns()
+{
+    for (auto i = patterns.begin(); i != patterns.end(); ++i) {
+        if (i->kind == Pattern::Regex)
+            regfree(&i->regex);
+    }
+    patterns.clear();
+}
+
+void
+RegionMap::setROIPatterns(const vector<string> &roi_patterns)
+{
+    clearPatterns();
+    patterns.reserve(roi_patterns.size());
+
+    for (auto i = roi_patterns.begin(); i != roi_patterns.end(); ++i) {
+        Pattern pattern;
+
+        if (i->compare(0, 3, "re:") == 0) {
+            pattern.kind = Pattern::Regex;
+            pattern.text = i->substr(3);
+            int error = regcomp(&pattern.regex, pattern.text.c_str(),
+                REG_EXTENDED | REG_NOSUB);
+            if (error != 0) {
+                char message[256];
+                regerror(error, &pattern.regex, message, sizeof(message));
+                fatal("Bad region of interest pattern '%s': %s\n",
+                    pattern.text, message);
+            }
+        } else if (!i->empty() && (*i)[i->size() - 1] == '*') {
+            pattern.kind = Pattern::Prefix;
+            pattern.text = i->substr(0, i->size() - 1);
+        } else {
+            pattern.kind = Pattern::Exact;
+            pattern.text = *i;
+        }
+
+        patterns.push_back(pattern);
+    }
+}
+
+unsigned int
+RegionMap::symbolTags(const string &symbol) const
+{
+    unsigned int tags = 0;
+
+    if (symbol == "main")
+        tags |= TagMain;
+    if (symbol.compare(0, 4, "FUNC") == 0)
+        tags |= TagFunc;
+
+    for (auto i = patterns.begin(); i != patterns.end(); ++i) {
+        bool match;
+
+        switch (i->kind) {
+          case Pattern::Exact:
+            match = symbol == i->text;
+            break;
+          case Pattern::Prefix:
+            match = symbol.compare(0, i->text.size(), i->text) == 0;
+            break;
+          default:
+            match = regexec(&i->regex, symbol.c_str(), 0, NULL, 0) == 0;
+            break;
+        }
+
+        if (match) {
+            tags |= TagROI;
+            break;
+        }
+    }
+
+    return tags;
+}
+
+void
+RegionMap::clear()
+{
+    regions.clear();
+    names.clear();
+    funcNames.resize(1);
+    lastHit = NULL;
+}
+
+void
+RegionMap::build(const SymbolTable &symtab)
+{
+    clear();
+
+    const SymbolTable::ATable &addr_table = symtab.getAddrTable();
+
+    regions.reserve(addr_table.size());
+    names.reserve(addr_table.size());
+
+    /* Each symbol covers the addresses up to the next symbol, the last one
+     *  runs to the top of the address space, just as findNearestSymbol
+     *  would have it */
+    SymbolTable::ATable::const_iterator i = addr_table.begin();
+    while (i != addr_table.end()) {
+        SymbolTable::ATable::const_iterator next = i;
+        ++next;
+
+        Region region;
+        region.start = i->first;
+        region.end = (next == addr_table.end() ? MaxAddr : next->first);
+        region.symbol = names.size();
+        region.tags = symbolTags(i->second);
+        region.funcId = otherFuncId;
+        if (region.inROI()) {
+            region.funcId = funcNames.size();
+            funcNames.push_back(i->second);
+        }
+
+        names.push_back(i->second);
+        regions.push_back(region);
+
+        i = next;
+    }
+}
+
+/** Order regions against an address for upper_bound */
+static bool
+addrBeforeRegion(Addr addr, const RegionMap::Region &region)
+{
+    return addr < region.start;
+}
+
+const RegionMap::Region *
+RegionMap::search(Addr addr) const
+{
+    /* Find the first region starting *after* addr, the one before it (if
+     *  any) is the candidate */
+    vector<Region>::const_iterator i = upper_bound(regions.begin(),
+        regions.end(), addr, addrBeforeRegion);
+
+    if (i == regions.begin())
+        return NULL;
+
+    --i;
+    if (!i->contains(addr))
+        return NULL;
+
+    lastHit = &(*i);
+    return lastHit;
+}
@@ -0,0 +1,222 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Flat, sorted map of the code regions (functions) of the loaded binary.
+ * The map is built once from a SymbolTable and answers "which function is
+ * this PC in" and "is this PC in the region of interest" without the
+ * std::map walk and std::string copy that SymbolTable::findNearestSymbol
+ * costs.  The region of interest is the set of functions matching a
+ * list of patterns, by default main() plus every function whose name
+ * starts with "FUNC", which is the naming convention used by the fault
+ * injection workloads.  Each region of interest function also gets a
+ * dense function ID so per-function statistics can be kept in a vector.
+ */
+
+#ifndef __BASE_LOADER_REGION_MAP_HH__
+#define __BASE_LOADER_REGION_MAP_HH__
+
+#include <regex.h>
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+class SymbolTable;
+
+class RegionMap
+{
+  public:
+    /** Region tags, a region can carry more than one tag */
+    enum Tag
+    {
+        /** The region is main() */
+        TagMain = 0x1,
+        /** The region is a FUNC* kernel */
+        TagFunc = 0x2,
+        /** The region matches a region of interest pattern */
+        TagROI = 0x4
+    };
+
+    /** Function ID of everything outside the region of interest */
+    static const unsigned int otherFuncId = 0;
+
+    /** One [start, end) range of the address space, covering the code
+     *  from one symbol up to the next */
+    struct Region
+    {
+        Addr start;
+        Addr end;
+        /** Index of this region's symbol name in names */
+        unsigned int symbol;
+        /** Bitmask of Tag */
+        unsigned int tags;
+        /** Dense ID of the region of interest function this region is,
+         *  otherFuncId outside the region of interest */
+        unsigned int funcId;
+
+        bool inROI() const { return (tags & TagROI) != 0; }
+        bool isMain() const { return (tags & TagMain) != 0; }
+        bool contains(Addr addr) const { return addr >= start && addr < end; }
+    };
+
+  protected:
+    /** Sorted, non-overlapping regions */
+    std::vector<Region> regions;
+
+    /** Symbol names, indexed by Region::symbol */
+    std::vector<std::string> names;
+
+    /** Symbol names by function ID, funcNames[otherFuncId] is "other" */
+    std::vector<std::string> funcNames;
+
+    /** A compiled region of interest pattern */
+    struct Pattern
+    {
+        enum Kind { Exact, Prefix, Regex };
+
+        Kind kind;
+        std::string text;
+        regex_t regex;
+    };
+
+    /** Region of interest patterns, compiled by setROIPatterns */
+    std::vector<Pattern> patterns;
+
+    /** The region returned by the last successful lookup.  Consecutive
+     *  lookups nearly always fall in the same function so this is checked
+     *  before searching */
+    mutable const Region *lastHit;
+
+    /** Name returned for addresses outside any region */
+    static const std::string noName;
+
+    /** Tags for a symbol of the given name */
+    unsigned int symbolTags(const std::string &symbol) const;
+
+    void clearPatterns();
+
+  public:
+    RegionMap();
+
+    ~RegionMap();
+
+    /** Set the patterns selecting the region of interest functions.
+     *  Each is a symbol name, a name prefix ending in '*' or, prefixed
+     *  with "re:", a POSIX extended regular expression.  Patterns are
+     *  compiled here and matched once per symbol as the map is built,
+     *  so they must be set before build to take effect */
+    void setROIPatterns(const std::vector<std::string> &roi_patterns);
+
+    /** Rebuild the map from the contents of symtab.  Any Region pointers
+     *  previously returned by lookup are invalidated, function IDs are
+     *  reassigned */
+    void build(const SymbolTable &symtab);
+
+    void clear();
+
+    bool empty() const { return regions.empty(); }
+    size_t size() const { return regions.size(); }
+
+    /** Find the region containing addr or NULL if the address is before
+     *  the first symbol */
+    const Region *
+    lookup(Addr addr) const
+    {
+        if (lastHit && lastHit->contains(addr))
+            return lastHit;
+
+        return search(addr);
+    }
+
+    /** Is addr in the region of interest */
+    bool
+    inROI(Addr addr) const
+    {
+        const Region *region = lookup(addr);
+        return region && region->inROI();
+    }
+
+    /** Tags of the region containing addr, 0 if there is no region */
+    unsigned int
+    tags(Addr addr) const
+    {
+        const Region *region = lookup(addr);
+        return region ? region->tags : 0;
+    }
+
+    /** Name of a region's symbol.  region may be NULL */
+    const std::string &
+    name(const Region *region) const
+    {
+        return region ? names[region->symbol] : noName;
+    }
+
+    /** Name of the function containing addr, the empty string if there
+     *  is none */
+    const std::string &name(Addr addr) const { return name(lookup(addr)); }
+
+    /** Function ID of the region containing addr, otherFuncId if it is
+     *  outside the region of interest */
+    unsigned int
+    funcId(Addr addr) const
+    {
+        const Region *region = lookup(addr);
+        return region ? region->funcId : otherFuncId;
+    }
+
+    /** Number of function IDs, including otherFuncId */
+    size_t numFuncIds() const { return funcNames.size(); }
+
+    /** Symbol name of a function ID, "other" for otherFuncId */
+    const std::string &funcName(unsigned int func_id) const
+    { return funcNames[func_id]; }
+
+    /** Index of a region in the map, for use as a dense per-function
+     *  index.  region must have been returned by this map */
+    unsigned int
+    indexOf(const Region *region) const
+    {
+        return region - &regions[0];
+    }
+
+    const Region &operator [](unsigned int index) const
+    { return regions[index]; }
+
+  protected:
+    /** Binary search for addr.  Updates lastHit on success */
+    const Region *search(Addr addr) const;
+};
+
+/** Region map built from debugSymbolTable when a binary's symbols are
+ *  loaded */
+extern RegionMap debugRegionMap;
+
+#endif // __BASE_LOADER_REGION_MAP_HH__
@@ -28,8 +28,10 @@
  * Authors: Nathan Binkert
  */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -47,7 +49,27 @@ void
 SymbolTable::clear()
 {
     addrTable.clear();
-    symbolTable.clear();
+    addrOrder.clear();
+    nameIndex.clear();
+    pending.clear();
+    inserted = 0;
+}
+
+uint64_t
+SymbolTable::hostMemUsage() const
+{
+    uint64_t bytes =
+        (addrTable.capacity() + pending.capacity()) *
+        sizeof(ATable::value_type) +
+        addrOrder.capacity() * sizeof(uint64_t) +
+        nameIndex.capacity() * sizeof(size_t);
+
+    for (auto &entry : addrTable)
+        bytes += entry.second.capacity();
+    for (auto &entry : pending)
+        bytes += entry.second.capacity();
+
+    return bytes;
 }
 
 bool
@@ -56,12 +78,113 @@ SymbolTable::insert(Addr address, string symbol)
     if (symbol.empty())
         return false;
 
-    if (!addrTable.insert(make_pair(address, symbol)).second)
-        return false;
+    pending.push_back(make_pair(address, std::move(symbol)));
+    ++inserted;
+    return true;
+}
+
+namespace {
+
+/** Orders indices into a symbol vector by address */
+struct ByAddr
+{
+    const SymbolTable::ATable &table;
+    ByAddr(const SymbolTable::ATable &t) : table(t) {}
+    bool operator()(size_t a, size_t b) const
+    { return table[a].first < table[b].first; }
+};
+
+/** Orders indices into a symbol vector by name, then insertion */
+struct ByName
+{
+    const SymbolTable::ATable &table;
+    const vector<uint64_t> &order;
+    ByName(const SymbolTable::ATable &t, const vector<uint64_t> &o)
+        : table(t), order(o) {}
+    bool operator()(size_t a, size_t b) const
+    {
+        int cmp = table[a].second.compare(table[b].second);
+        return cmp < 0 || (cmp == 0 && order[a] < order[b]);
+    }
+};
+
+/** Compares the name at an index against a name */
+struct NameBefore
+{
+    const SymbolTable::ATable &table;
+    NameBefore(const SymbolTable::ATable &t) : table(t) {}
+    bool operator()(size_t a, const string &name) const
+    { return table[a].second < name; }
+};
 
-    if (!symbolTable.insert(make_pair(symbol, address)).second)
+} // anonymous namespace
+
+void
+SymbolTable::merge() const
+{
+    uint64_t first_seq = inserted - pending.size();
+
+    // order the new symbols by address, in insertion order at each one
+    vector<size_t> sorted(pending.size());
+    iota(sorted.begin(), sorted.end(), 0);
+    stable_sort(sorted.begin(), sorted.end(), ByAddr(pending));
+
+    // merge them in; symbols already in the table were inserted
+    // earlier, so they keep their addresses
+    ATable table;
+    vector<uint64_t> order;
+    table.reserve(addrTable.size() + pending.size());
+    order.reserve(addrTable.size() + pending.size());
+    size_t i = 0, j = 0;
+    while (i < addrTable.size() || j < sorted.size()) {
+        Addr addr;
+        if (j == sorted.size() ||
+            (i < addrTable.size() &&
+             addrTable[i].first <= pending[sorted[j]].first)) {
+            addr = addrTable[i].first;
+            table.push_back(std::move(addrTable[i]));
+            order.push_back(addrOrder[i]);
+            ++i;
+        } else {
+            addr = pending[sorted[j]].first;
+            table.push_back(std::move(pending[sorted[j]]));
+            order.push_back(first_seq + sorted[j]);
+            ++j;
+        }
+
+        // later symbols at the same address are dropped
+        while (j < sorted.size() && pending[sorted[j]].first == addr)
+            ++j;
+    }
+
+    addrTable.swap(table);
+    addrOrder.swap(order);
+    pending.clear();
+
+    // each name refers to the first address it was accepted at
+    nameIndex.resize(addrTable.size());
+    iota(nameIndex.begin(), nameIndex.end(), 0);
+    sort(nameIndex.begin(), nameIndex.end(), ByName(addrTable, addrOrder));
+    size_t names = 0;
+    for (size_t k = 0; k < nameIndex.size(); ++k) {
+        if (names == 0 || addrTable[nameIndex[k]].second !=
+            addrTable[nameIndex[names - 1]].second)
+            nameIndex[names++] = nameIndex[k];
+    }
+    nameIndex.resize(names);
+}
+
+bool
+SymbolTable::findAddress(const string &symbol, Addr &address) const
+{
+    build();
+    vector<size_t>::const_iterator i =
+        lower_bound(nameIndex.begin(), nameIndex.end(), symbol,
+                    NameBefore(addrTable));
+    if (i == nameIndex.end() || addrTable[*i].second != symbol)
         return false;
 
+    address = addrTable[*i].first;
     return true;
 }
 
@@ -110,6 +233,7 @@ SymbolTable::load(const string &filename)
 void
 SymbolTable::serialize(const string &base, ostream &os)
 {
+    build();
     paramOut(os, base + ".size", addrTable.size());
 
     int i = 0;
@@ -32,29 +32,59 @@
 #ifndef __SYMTAB_HH__
 #define __SYMTAB_HH__
 
+#include <algorithm>
 #include <iosfwd>
-#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/types.hh"
 
 class Checkpoint;
+
+/**
+ * Symbols are collected as they are inserted and only sorted into
+ * flat lookup tables when the table is first queried, so loading the
+ * tens of thousands of symbols of a kernel doesn't pay for a balanced
+ * tree insertion (and a second copy of every name) per symbol. As
+ * before, the first symbol inserted at an address wins it, and a name
+ * refers to the first address it was accepted at.
+ */
 class SymbolTable
 {
   public:
-    typedef std::map<Addr, std::string> ATable;
-    typedef std::map<std::string, Addr> STable;
+    /** Symbols sorted by address, at most one per address */
+    typedef std::vector<std::pair<Addr, std::string> > ATable;
 
   private:
-    ATable addrTable;
-    STable symbolTable;
+    mutable ATable addrTable;
+    /** Insertion number of each entry of addrTable */
+    mutable std::vector<uint64_t> addrOrder;
+    /** Indices into addrTable sorted by name, at most one per name */
+    mutable std::vector<size_t> nameIndex;
+    /** Symbols inserted since the tables were built, in order */
+    mutable ATable pending;
+    /** Number of symbols inserted so far */
+    uint64_t inserted;
+
+    /** Merge the pending symbols into the lookup tables */
+    void
+    build() const
+    {
+        if (!pending.empty())
+            merge();
+    }
+
+    void merge() const;
 
-  private:
     bool
     upperBound(Addr addr, ATable::const_iterator &iter) const
     {
+        build();
+
         // find first key *larger* than desired address
-        iter = addrTable.upper_bound(addr);
+        iter = std::upper_bound(addrTable.begin(), addrTable.end(), addr,
+                                addrBefore);
 
         // if very first key is larger, we're out of luck
         if (iter == addrTable.begin())
@@ -63,17 +93,31 @@ class SymbolTable
         return true;
     }
 
+    static bool
+    addrBefore(Addr addr, const ATable::value_type &entry)
+    {
+        return addr < entry.first;
+    }
+
+    static bool
+    entryBefore(const ATable::value_type &entry, Addr addr)
+    {
+        return entry.first < addr;
+    }
+
   public:
-    SymbolTable() {}
-    SymbolTable(const std::string &file) { load(file); }
+    SymbolTable() : inserted(0) {}
+    SymbolTable(const std::string &file) : inserted(0) { load(file); }
     ~SymbolTable() {}
 
     void clear();
     bool insert(Addr address, std::string symbol);
     bool load(const std::string &file);
 
-    const ATable &getAddrTable() const { return addrTable; }
-    const STable &getSymbolTable() const { return symbolTable; }
+    const ATable &getAddrTable() const { build(); return addrTable; }
+
+    /** Host memory taken by the tables and the names, in bytes */
+    uint64_t hostMemUsage() const;
 
   public:
     void serialize(const std::string &base, std::ostream &os);
@@ -84,24 +128,18 @@ class SymbolTable
     bool
     findSymbol(Addr address, std::string &symbol) const
     {
-        ATable::const_iterator i = addrTable.find(address);
-        if (i == addrTable.end())
+        build();
+        ATable::const_iterator i =
+            std::lower_bound(addrTable.begin(), addrTable.end(), address,
+                             entryBefore);
+        if (i == addrTable.end() || i->first != address)
             return false;
 
-        symbol = (*i).second;
+        symbol = i->second;
         return true;
     }
 
-    bool
-    findAddress(const std::string &symbol, Addr &address) const
-    {
-        STable::const_iterator i = symbolTable.find(symbol);
-        if (i == symbolTable.end())
-            return false;
-
-        address = (*i).second;
-        return true;
-    }
+    bool findAddress(const std::string &symbol, Addr &address) const;
 
     /// Find the nearest symbol equal to or less than the supplied
     /// address (e.g., the label for the enclosing function).
@@ -142,6 +180,24 @@ class SymbolTable
     }
 
 
+    /// Find the nearest symbol equal to or less than the supplied
+    /// address without copying its name.
+    /// @param addr     The address to look up.
+    /// @param symaddr  Return reference for symbol address.
+    /// @return The symbol's name, valid until the table is next
+    ///         changed, or NULL if there is none.
+    const std::string *
+    nearestSymbol(Addr addr, Addr &symaddr) const
+    {
+        ATable::const_iterator i;
+        if (!upperBound(addr, i))
+            return NULL;
+
+        --i;
+        symaddr = i->first;
+        return &i->second;
+    }
+
     bool
     findNearestAddr(Addr addr, Addr &symaddr, Addr &nextaddr) const
     {
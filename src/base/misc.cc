@@ -90,6 +90,9 @@ __exit_epilogue(int code,
              "Memory Usage: %ld KBytes\n",
              curTick(), func, file, line, memUsage());
 
+    // buffered trace output leading up to the error is the most useful
+    Trace::flush();
+
     if (code < 0)
         abort();
     else
@@ -0,0 +1,294 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Open-addressed hash map for small keys such as addresses.
+ */
+
+#ifndef __BASE_OPEN_HASH_MAP_HH__
+#define __BASE_OPEN_HASH_MAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * A hash map that stores its entries inline in a power-of-two array of
+ * slots and resolves collisions by linear probing.  The slot of a key
+ * is chosen by Fibonacci hashing, taking the top bits of the key's hash
+ * times 2^64 divided by the golden ratio, so that keys differing only
+ * in their high bits, such as line addresses, spread over all slots.
+ *
+ * Entries are removed by shifting the later entries of their probe
+ * sequence back into the hole, so there are no tombstones and a lookup
+ * stops at the first empty slot.  The map is kept at most max_load
+ * percent full and doubles when an insert would exceed that; a map
+ * sized for its largest population up front never touches the heap.
+ *
+ * Pointers to values and iterators stay valid until the next insert or
+ * erase.  Keys and values must be default constructible and movable.
+ */
+template <class Key, class Value, class Hash = std::hash<Key> >
+class OpenHashMap
+{
+  public:
+    /** A key and its value; the key must not be changed in place. */
+    struct Entry
+    {
+        Key key;
+        Value value;
+    };
+
+  private:
+    struct Slot
+    {
+        Slot() : used(false), entry() { }
+        bool used;
+        Entry entry;
+    };
+
+    /** Number of slots allocated by the first insert, a power of 2. */
+    static const size_t MinSlots = 16;
+
+    std::vector<Slot> slots;
+
+    /** log2 of the number of slots, 0 while no slot is allocated. */
+    unsigned bits;
+
+    size_t _size;
+
+    const unsigned maxLoad;
+
+    Hash hasher;
+
+    size_t
+    home(const Key &key) const
+    {
+        return (uint64_t(hasher(key)) * ULL(0x9e3779b97f4a7c15)) >>
+            (64 - bits);
+    }
+
+    /** Slot holding key, or the empty slot ending its probe. */
+    size_t
+    probe(const Key &key) const
+    {
+        const size_t mask = slots.size() - 1;
+        size_t i = home(key);
+        while (slots[i].used && !(slots[i].entry.key == key))
+            i = (i + 1) & mask;
+        return i;
+    }
+
+    /** Whether n entries fit in num_slots slots. */
+    bool
+    fits(size_t n, size_t num_slots) const
+    {
+        return n * 100 <= num_slots * maxLoad;
+    }
+
+    /** Reallocate num_slots slots and reinsert every entry. */
+    void
+    rehash(size_t num_slots)
+    {
+        std::vector<Slot> old_slots(num_slots);
+        old_slots.swap(slots);
+        bits = 0;
+        while ((size_t(1) << bits) < num_slots)
+            ++bits;
+
+        for (auto &slot : old_slots) {
+            if (slot.used)
+                slots[probe(slot.entry.key)] = std::move(slot);
+        }
+    }
+
+    template <class SlotIter, class E>
+    class Iter : public std::iterator<std::forward_iterator_tag, E>
+    {
+      private:
+        SlotIter cur;
+        SlotIter last;
+
+        void skip() { while (cur != last && !cur->used) ++cur; }
+
+      public:
+        Iter(SlotIter c, SlotIter l) : cur(c), last(l) { skip(); }
+
+        E &operator*() const { return cur->entry; }
+        E *operator->() const { return &cur->entry; }
+
+        Iter &operator++() { ++cur; skip(); return *this; }
+        Iter operator++(int) { Iter it(*this); ++*this; return it; }
+
+        bool operator==(const Iter &other) const { return cur == other.cur; }
+        bool operator!=(const Iter &other) const { return cur != other.cur; }
+    };
+
+  public:
+    typedef Iter<typename std::vector<Slot>::iterator, Entry> iterator;
+    typedef Iter<typename std::vector<Slot>::const_iterator, const Entry>
+        const_iterator;
+
+    /**
+     * @param entries  Entries to make room for up front.
+     * @param max_load Largest percentage of the slots that may be used.
+     * @param hash     Hash function of the keys.
+     */
+    OpenHashMap(size_t entries = 0, unsigned max_load = 50,
+                const Hash &hash = Hash())
+        : bits(0), _size(0), maxLoad(max_load), hasher(hash)
+    {
+        assert(max_load > 0 && max_load < 100);
+        reserve(entries);
+    }
+
+    /** Make room for n entries without growing on insert. */
+    void
+    reserve(size_t n)
+    {
+        if (n == 0 || fits(n, slots.size()))
+            return;
+        size_t num_slots = 2;
+        while (!fits(n, num_slots))
+            num_slots *= 2;
+        rehash(num_slots);
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    /** Number of slots, used or not. */
+    size_t slotCount() const { return slots.size(); }
+
+    /** Host memory held by the slots, in bytes. */
+    size_t hostMemUsage() const { return slots.capacity() * sizeof(Slot); }
+
+    /** The value of key, or NULL if the map does not hold it. */
+    Value *
+    find(const Key &key)
+    {
+        if (_size == 0)
+            return NULL;
+        Slot &slot = slots[probe(key)];
+        return slot.used ? &slot.entry.value : NULL;
+    }
+
+    const Value *
+    find(const Key &key) const
+    {
+        return const_cast<OpenHashMap *>(this)->find(key);
+    }
+
+    /**
+     * Find the value of key, adding a value initialized one if the
+     * map does not hold it yet.
+     *
+     * @return The value and whether it was added.
+     */
+    std::pair<Value *, bool>
+    insert(const Key &key)
+    {
+        if (_size != 0) {
+            Slot &slot = slots[probe(key)];
+            if (slot.used)
+                return std::make_pair(&slot.entry.value, false);
+        }
+
+        if (!fits(_size + 1, slots.size()))
+            rehash(slots.empty() ? MinSlots : 2 * slots.size());
+
+        Slot &slot = slots[probe(key)];
+        slot.used = true;
+        slot.entry.key = key;
+        ++_size;
+        return std::make_pair(&slot.entry.value, true);
+    }
+
+    /**
+     * Remove key and its value.
+     *
+     * @return Whether the map held key.
+     */
+    bool
+    erase(const Key &key)
+    {
+        if (_size == 0)
+            return false;
+
+        size_t hole = probe(key);
+        if (!slots[hole].used)
+            return false;
+
+        // Shift later entries of the probe sequence back into the hole,
+        // unless that would move them before their home slot.
+        const size_t mask = slots.size() - 1;
+        for (size_t next = (hole + 1) & mask; slots[next].used;
+             next = (next + 1) & mask) {
+            size_t next_home = home(slots[next].entry.key);
+            if (((next - next_home) & mask) >= ((next - hole) & mask)) {
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+        }
+        slots[hole] = Slot();
+        --_size;
+        return true;
+    }
+
+    /** Remove every entry, keeping the slots. */
+    void
+    clear()
+    {
+        for (auto &slot : slots)
+            slot = Slot();
+        _size = 0;
+    }
+
+    iterator begin() { return iterator(slots.begin(), slots.end()); }
+    iterator end() { return iterator(slots.end(), slots.end()); }
+
+    const_iterator
+    begin() const
+    {
+        return const_iterator(slots.begin(), slots.end());
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(slots.end(), slots.end());
+    }
+};
+
+#endif // __BASE_OPEN_HASH_MAP_HH__
@@ -74,10 +74,20 @@ OutputDirectory::checkForStdio(const string &name) const
     return NULL;
 }
 
+void
+OutputDirectory::makeDirectory() const
+{
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+        fatal("Failed to create output directory '%s'\n", dir);
+}
+
 ostream *
 OutputDirectory::openFile(const string &filename,
                           ios_base::openmode mode)
 {
+    if (!dir.empty() && filename.compare(0, dir.size(), dir) == 0)
+        makeDirectory();
+
     if (filename.find(".gz", filename.length()-3) < filename.length()) {
         ogzstream *file = new ogzstream(filename.c_str(), mode);
         if (!file->is_open())
@@ -126,14 +136,55 @@ OutputDirectory::close(ostream *openStream) {
 void
 OutputDirectory::setDirectory(const string &d)
 {
-    if (!dir.empty())
-        panic("Output directory already set!\n");
+    const string old_dir = dir;
 
     dir = d;
 
     // guarantee that directory ends with a path separator
     if (dir[dir.size() - 1] != PATH_SEPARATOR)
         dir += PATH_SEPARATOR;
+
+    if (old_dir.empty() || old_dir == dir)
+        return;
+
+    // Move files opened relative to the old directory over to the new
+    // one.  Files opened with absolute paths elsewhere are left alone.
+    map_t relocated;
+    for (map_t::iterator i = files.begin(); i != files.end(); i++) {
+        if (i->first.compare(0, old_dir.size(), old_dir) != 0) {
+            relocated.insert(*i);
+            continue;
+        }
+
+        makeDirectory();
+        const string filename = dir + i->first.substr(old_dir.size());
+        ofstream *fs = dynamic_cast<ofstream*>(i->second);
+        ogzstream *gfs = dynamic_cast<ogzstream*>(i->second);
+        if (fs) {
+            fs->close();
+            fs->clear();
+            fs->open(filename.c_str(), ios::trunc);
+            if (!fs->is_open())
+                fatal("Cannot open file %s", filename);
+        } else if (gfs) {
+            gfs->close();
+            gfs->clear();
+            gfs->open(filename.c_str(), ios::trunc);
+            if (!gfs->is_open())
+                fatal("Cannot open file %s", filename);
+        } else {
+            panic("Unknown stream type for %s\n", i->first);
+        }
+        relocated[filename] = i->second;
+    }
+    files.swap(relocated);
+}
+
+void
+OutputDirectory::flush()
+{
+    for (map_t::iterator i = files.begin(); i != files.end(); i++)
+        i->second->flush();
 }
 
 const string &
@@ -52,6 +52,12 @@ class OutputDirectory
     /** System-specific path separator character */
     static const char PATH_SEPARATOR = '/';
 
+    /**
+     * Creates this directory unless it exists, so that a directory can
+     * be set without creating it until a file is opened in it.
+     */
+    void makeDirectory() const;
+
   protected:
     /**
      * Determines whether given file name corresponds to standard output
@@ -93,10 +99,20 @@ class OutputDirectory
 
     /**
      * Sets name of this directory.
+     *
+     * If the directory has already been set, any files open within the
+     * old directory are reopened (truncated) under the new one. The
+     * stream objects stay the same so references held elsewhere remain
+     * valid. This is used when a forked simulator process moves its
+     * output away from its parent's.
+     *
      * @param dir name of this directory
      */
     void setDirectory(const std::string &dir);
 
+    /** Flushes all open file streams. */
+    void flush();
+
     /**
      * Gets name of this directory.
      * @return name of this directory
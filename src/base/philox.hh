@@ -0,0 +1,166 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Philox4x32-10 counter-based random number generator (Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC'11).
+ */
+
+#ifndef __BASE_PHILOX_HH__
+#define __BASE_PHILOX_HH__
+
+#include "base/types.hh"
+
+/**
+ * A counter-based generator: each output block is a pure function of a
+ * 128 bit counter and a 64 bit key, so streams with different keys or
+ * counter ranges are independent without any shared state and any point
+ * of a stream can be reproduced directly.
+ */
+class Philox
+{
+  public:
+    /** Four 32 bit words of counter or output */
+    struct Block
+    {
+        uint32_t v[4];
+    };
+
+  private:
+    uint64_t key;
+    Block counter;
+
+    /** Unused words of the last generated block */
+    Block buffer;
+    unsigned int buffered;
+
+    static const uint32_t M0 = 0xD2511F53;
+    static const uint32_t M1 = 0xCD9E8D57;
+    static const uint32_t W0 = 0x9E3779B9;
+    static const uint32_t W1 = 0xBB67AE85;
+
+    void
+    increment()
+    {
+        for (int i = 0; i < 4; i++) {
+            if (++counter.v[i] != 0)
+                break;
+        }
+    }
+
+  public:
+    /** The Philox4x32-10 bijection of ctr under key */
+    static Block
+    generate(Block ctr, uint64_t key)
+    {
+        uint32_t k0 = key;
+        uint32_t k1 = key >> 32;
+
+        for (int round = 0; round < 10; round++) {
+            uint64_t p0 = uint64_t(M0) * ctr.v[0];
+            uint64_t p1 = uint64_t(M1) * ctr.v[2];
+
+            Block next;
+            next.v[0] = uint32_t(p1 >> 32) ^ ctr.v[1] ^ k0;
+            next.v[1] = uint32_t(p1);
+            next.v[2] = uint32_t(p0 >> 32) ^ ctr.v[3] ^ k1;
+            next.v[3] = uint32_t(p0);
+            ctr = next;
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        return ctr;
+    }
+
+    /**
+     * @param key_ generator key, e.g. a campaign seed
+     * @param stream upper 64 bits of the counter, e.g. a run ID.  The
+     *        lower 64 bits count generated blocks from 0
+     */
+    Philox(uint64_t key_ = 0, uint64_t stream = 0)
+    {
+        seed(key_, stream);
+    }
+
+    /** Restart from the beginning of the given key and stream */
+    void
+    seed(uint64_t key_, uint64_t stream)
+    {
+        key = key_;
+        counter.v[0] = 0;
+        counter.v[1] = 0;
+        counter.v[2] = stream;
+        counter.v[3] = stream >> 32;
+        buffered = 0;
+    }
+
+    /** The next 32 bit word of the stream */
+    uint32_t
+    next()
+    {
+        if (buffered == 0) {
+            buffer = generate(counter, key);
+            increment();
+            buffered = 4;
+        }
+
+        return buffer.v[--buffered];
+    }
+
+    /** Number of words drawn since the stream was seeded */
+    uint64_t
+    position() const
+    {
+        uint64_t blocks = counter.v[0] | uint64_t(counter.v[1]) << 32;
+        return blocks * 4 - buffered;
+    }
+
+    /** Move to the given position() of the current stream */
+    void
+    seek(uint64_t words)
+    {
+        uint64_t blocks = words / 4;
+        counter.v[0] = blocks;
+        counter.v[1] = blocks >> 32;
+        buffered = 0;
+
+        // draw the words of a partially used block
+        for (unsigned int i = 0; i < words % 4; i++)
+            next();
+    }
+
+    /** A value in [0, bound).  bound must be non-zero */
+    uint32_t
+    random(uint32_t bound)
+    {
+        return (uint64_t(next()) * bound) >> 32;
+    }
+};
+
+#endif // __BASE_PHILOX_HH__
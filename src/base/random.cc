@@ -42,8 +42,6 @@
  *          Andreas Hansson
  */
 
-#include <sstream>
-
 #include "base/misc.hh"
 #include "base/random.hh"
 #include "sim/serialize.hh"
@@ -51,12 +49,12 @@
 Random::Random()
 {
     // default random seed
-    init(5489);
+    init(5489, 0);
 }
 
-Random::Random(uint32_t s)
+Random::Random(uint64_t s, uint64_t stream)
 {
-    init(s);
+    init(s, stream);
 }
 
 Random::~Random()
@@ -64,36 +62,48 @@ Random::~Random()
 }
 
 void
-Random::init(uint32_t s)
+Random::init(uint64_t s)
 {
-    gen.seed(s);
+    init(s, _stream);
 }
 
 void
-Random::serialize(std::ostream &os)
+Random::init(uint64_t s, uint64_t stream)
 {
-    panic("Currently not used anywhere.\n");
+    _seed = s;
+    _stream = stream;
+    gen.philox.seed(s, stream);
+}
 
-    // get the state from the generator
-    std::ostringstream oss;
-    oss << gen;
-    std::string state = oss.str();
-    paramOut(os, "mt_state", state);
+void
+Random::serialize(std::ostream &os)
+{
+    uint64_t seed = _seed;
+    uint64_t stream = _stream;
+    uint64_t position = gen.philox.position();
+    SERIALIZE_SCALAR(seed);
+    SERIALIZE_SCALAR(stream);
+    SERIALIZE_SCALAR(position);
 }
 
 void
 Random::unserialize(Checkpoint *cp, const std::string &section)
 {
-    panic("Currently not used anywhere.\n");
-
     // the random generator state did not use to be part of the
     // checkpoint state, so be forgiving in the unserialization and
     // keep on going if the parameter is not there
-    std::string state;
-    if (optParamIn(cp, section, "mt_state", state)) {
-        std::istringstream iss(state);
-        iss >> gen;
-    }
+    uint64_t seed, stream, position;
+    if (!optParamIn(cp, section, "seed", seed))
+        return;
+    UNSERIALIZE_SCALAR(stream);
+    UNSERIALIZE_SCALAR(position);
+
+    init(seed, stream);
+    gen.philox.seek(position);
 }
 
-Random random_mt;
+__thread Random *_curRandom = NULL;
+// keep clear of the streams of the main event queues, which count up
+// from 0
+Random initRandom(5489, ~0ULL);
+CurRandom random_mt;
@@ -43,7 +43,7 @@
  */
 
 /*
- * Mersenne twister random number generator.
+ * Counter-based random number streams.
  */
 
 #ifndef __BASE_RANDOM_HH__
@@ -53,24 +53,51 @@
 #include <string>
 #include <type_traits>
 
+#include "base/philox.hh"
 #include "base/types.hh"
 
 class Checkpoint;
 
+/**
+ * A random number stream identified by a seed and a stream ID. The
+ * numbers are drawn from a Philox generator, so streams with different
+ * IDs are independent, and the state of a stream is just the number of
+ * words drawn from it, which makes it cheap to checkpoint and restore.
+ */
 class Random
 {
 
   private:
 
-    std::mt19937_64 gen;
+    /** Adapts Philox to the standard distributions */
+    struct Engine
+    {
+        typedef uint32_t result_type;
+
+        Philox philox;
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xffffffff; }
+
+        result_type operator()() { return philox.next(); }
+    };
+
+    uint64_t _seed;
+    uint64_t _stream;
+    Engine gen;
 
   public:
 
     Random();
-    Random(uint32_t s);
+    Random(uint64_t s, uint64_t stream = 0);
     ~Random();
 
-    void init(uint32_t s);
+    /** Restart the current stream from the given seed */
+    void init(uint64_t s);
+    void init(uint64_t s, uint64_t stream);
+
+    uint64_t seed() const { return _seed; }
+    uint64_t stream() const { return _stream; }
 
     /**
      * Use the SFINAE idiom to choose an implementation based on
@@ -106,6 +133,37 @@ class Random
     void unserialize(Checkpoint *cp, const std::string &section);
 };
 
-extern Random random_mt;
+/**
+ * The stream of the event queue the running thread is servicing, set
+ * together with curEventQueue(). Each main event queue owns a stream
+ * of its own, so threads never share generator state.
+ */
+extern __thread Random *_curRandom;
+
+/**
+ * The stream used while no event queue is current, e.g. by objects
+ * drawing numbers in their constructors during configuration.
+ */
+extern Random initRandom;
+
+inline Random &curRandom() { return _curRandom ? *_curRandom : initRandom; }
+inline void curRandom(Random *r) { _curRandom = r; }
+
+/**
+ * Draws from curRandom(), so that code which is not tied to a
+ * particular stream stays deterministic however the simulated system
+ * is partitioned into event queues.
+ */
+class CurRandom
+{
+  public:
+    template <typename T>
+    T random() { return curRandom().random<T>(); }
+
+    template <typename T>
+    T random(T min, T max) { return curRandom().random<T>(min, max); }
+};
+
+extern CurRandom random_mt;
 
 #endif // __BASE_RANDOM_HH__
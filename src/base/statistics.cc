@@ -33,6 +33,8 @@
 #include <list>
 #include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/cprintf.hh"
@@ -68,9 +70,11 @@ statsMap()
 void
 InfoAccess::setInfo(Info *info)
 {
-    if (statsMap().find(this) != statsMap().end())
+    if (_info)
         panic("shouldn't register stat twice!");
 
+    _info = info;
+
     statsList().push_back(info);
 
 #ifndef NDEBUG
@@ -96,17 +100,15 @@ InfoAccess::setInit()
 Info *
 InfoAccess::info()
 {
-    MapType::const_iterator i = statsMap().find(this);
-    assert(i != statsMap().end());
-    return (*i).second;
+    assert(_info);
+    return _info;
 }
 
 const Info *
 InfoAccess::info() const
 {
-    MapType::const_iterator i = statsMap().find(this);
-    assert(i != statsMap().end());
-    return (*i).second;
+    assert(_info);
+    return _info;
 }
 
 StorageParams::~StorageParams()
@@ -462,6 +464,21 @@ Formula::str() const
     return root ? root->str() : "";
 }
 
+uint64_t formulaCacheGen = 0;
+
+void
+beginFormulaCache()
+{
+    static uint64_t lastGen = 0;
+    formulaCacheGen = ++lastGen;
+}
+
+void
+endFormulaCache()
+{
+    formulaCacheGen = 0;
+}
+
 Handler resetHandler = NULL;
 Handler dumpHandler = NULL;
 
@@ -487,6 +504,42 @@ processDumpQueue()
     dumpQueue.process();
 }
 
+void
+prepareStats(bool skip_zero_prereq, unsigned threads)
+{
+    // Filter on the calling thread: checking a prereq may evaluate a
+    // formula, and formula nodes keep shared result caches.
+    vector<Info *> todo;
+    todo.reserve(statsList().size());
+    for (auto info : statsList()) {
+        if (skip_zero_prereq && info->prereq && info->prereq->zero())
+            continue;
+        todo.push_back(info);
+    }
+
+    // Spawning threads doesn't pay off for small stat sets.
+    const size_t min_per_thread = 256;
+    threads = min<size_t>(threads, todo.size() / min_per_thread);
+
+    if (threads <= 1) {
+        for (auto info : todo)
+            info->prepare();
+        return;
+    }
+
+    auto worker = [&todo, threads](unsigned id) {
+        for (size_t i = id; i < todo.size(); i += threads)
+            todo[i]->prepare();
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(worker, i);
+    worker(0);
+    for (auto &t : pool)
+        t.join();
+}
+
 void
 registerResetCallback(Callback *cb)
 {
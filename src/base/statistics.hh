@@ -66,6 +66,7 @@
 #include "base/stats/types.hh"
 #include "base/cast.hh"
 #include "base/cprintf.hh"
+#include "base/hashmap.hh"
 #include "base/intmath.hh"
 #include "base/str.hh"
 #include "base/types.hh"
@@ -168,7 +169,13 @@ struct StorageParams
 
 class InfoAccess
 {
+  private:
+    /** The information class of this statistic, once set up */
+    Info *_info;
+
   protected:
+    InfoAccess() : _info(NULL) {}
+
     /** Set up an info class for this statistic */
     void setInfo(Info *info);
     /** Save Storage class parameters if any */
@@ -1331,6 +1338,137 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
     }
 };
 
+/**
+ * Implementation of a 2-dimensional stat that only keeps storage for
+ * the cells that have been written. It has the same interface as
+ * Vector2dBase, so it can stand in for stats that are very wide but
+ * mostly zero. The cells are still expanded into a dense vector when
+ * the stat is prepared for output.
+ */
+template <class Derived, class Stor>
+class SparseVector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
+{
+  public:
+    typedef Vector2dInfoProxy<Derived> Info;
+    typedef Stor Storage;
+    typedef typename Stor::Params Params;
+    typedef VectorProxy<Derived> Proxy;
+    friend class ScalarProxy<Derived>;
+    friend class VectorProxy<Derived>;
+    friend class DataWrapVec<Derived, Vector2dInfoProxy>;
+    friend class DataWrapVec2d<Derived, Vector2dInfoProxy>;
+
+  protected:
+    size_type x;
+    size_type y;
+    size_type _size;
+    /** The cells written so far, by flat index */
+    m5::hash_map<off_type, Storage> storage;
+    /** Stands in for every cell that has not been written */
+    Storage *zeroStor;
+
+  protected:
+    Storage *
+    data(off_type index)
+    {
+        auto it = storage.find(index);
+        if (it == storage.end())
+            it = storage.emplace(index, Storage(this->info())).first;
+        return &it->second;
+    }
+
+    const Storage *
+    data(off_type index) const
+    {
+        auto it = storage.find(index);
+        return it == storage.end() ? zeroStor : &it->second;
+    }
+
+  public:
+    SparseVector2dBase()
+        : x(0), y(0), _size(0), zeroStor(nullptr)
+    {}
+
+    ~SparseVector2dBase()
+    {
+        delete zeroStor;
+    }
+
+    Derived &
+    init(size_type _x, size_type _y)
+    {
+        assert(_x > 0 && _y > 0 && "sizes must be positive!");
+        assert(!zeroStor && "already initialized");
+
+        Derived &self = this->self();
+        Info *info = this->info();
+
+        x = _x;
+        y = _y;
+        info->x = _x;
+        info->y = _y;
+        _size = x * y;
+
+        zeroStor = new Storage(info);
+
+        this->setInit();
+
+        return self;
+    }
+
+    Proxy
+    operator[](off_type index)
+    {
+        off_type offset = index * y;
+        assert (index >= 0 && offset + y <= size());
+        return Proxy(this->self(), offset, y);
+    }
+
+    size_type
+    size() const
+    {
+        return _size;
+    }
+
+    bool
+    zero() const
+    {
+        for (auto &cell : storage)
+            if (!cell.second.zero())
+                return false;
+        return true;
+    }
+
+    void
+    prepare()
+    {
+        Info *info = this->info();
+
+        info->cvec.assign(size(), Counter());
+        for (auto &cell : storage) {
+            cell.second.prepare(info);
+            info->cvec[cell.first] = cell.second.value();
+        }
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset()
+    {
+        Info *info = this->info();
+        for (auto &cell : storage)
+            cell.second.reset(info);
+    }
+
+    bool
+    check() const
+    {
+        return zeroStor != NULL;
+    }
+};
+
 //////////////////////////////////////////////////////////////////////
 //
 // Non formula statistics
@@ -1494,6 +1632,147 @@ class DistStor
     }
 };
 
+/**
+ * Storage for a distribution stat that only keeps the buckets that
+ * have been sampled. It takes the same parameters as DistStor and
+ * prepares the same data, so it suits distributions with many more
+ * buckets than distinct samples.
+ */
+class SparseDistStor
+{
+  public:
+    /** The parameters are those of a dense distribution. */
+    typedef DistStor::Params Params;
+
+  private:
+    /** The minimum value to track. */
+    Counter min_track;
+    /** The maximum value to track. */
+    Counter max_track;
+    /** The number of entries in each bucket. */
+    Counter bucket_size;
+    /** The number of buckets. */
+    size_type buckets;
+
+    /** The smallest value sampled. */
+    Counter min_val;
+    /** The largest value sampled. */
+    Counter max_val;
+    /** The number of values sampled less than min. */
+    Counter underflow;
+    /** The number of values sampled more than max. */
+    Counter overflow;
+    /** The current sum. */
+    Counter sum;
+    /** The sum of squares. */
+    Counter squares;
+    /** The number of samples. */
+    Counter samples;
+    /** Counter for each bucket sampled, by bucket index. */
+    m5::hash_map<size_type, Counter> cmap;
+
+  public:
+    SparseDistStor(Info *info)
+    {
+        reset(info);
+    }
+
+    /**
+     * Add a value to the distribution for the given number of times.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void
+    sample(Counter val, int number)
+    {
+        if (val < min_track)
+            underflow += number;
+        else if (val > max_track)
+            overflow += number;
+        else {
+            size_type index =
+                (size_type)std::floor((val - min_track) / bucket_size);
+            assert(index < size());
+            cmap[index] += number;
+        }
+
+        if (val < min_val)
+            min_val = val;
+
+        if (val > max_val)
+            max_val = val;
+
+        sum += val * number;
+        squares += val * val * number;
+        samples += number;
+    }
+
+    /**
+     * Return the number of buckets in this distribution.
+     * @return the number of buckets.
+     */
+    size_type size() const { return buckets; }
+
+    /**
+     * Returns true if any calls to sample have been made.
+     * @return True if any values have been sampled.
+     */
+    bool
+    zero() const
+    {
+        return samples == Counter();
+    }
+
+    void
+    prepare(Info *info, DistData &data)
+    {
+        const Params *params = safe_cast<const Params *>(info->storageParams);
+
+        assert(params->type == Dist);
+        data.type = params->type;
+        data.min = params->min;
+        data.max = params->max;
+        data.bucket_size = params->bucket_size;
+
+        data.min_val = (min_val == CounterLimits::max()) ? 0 : min_val;
+        data.max_val = (max_val == CounterLimits::min()) ? 0 : max_val;
+        data.underflow = underflow;
+        data.overflow = overflow;
+
+        data.cvec.assign(params->buckets, Counter());
+        for (auto &bucket : cmap)
+            data.cvec[bucket.first] = bucket.second;
+
+        data.sum = sum;
+        data.squares = squares;
+        data.samples = samples;
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset(Info *info)
+    {
+        const Params *params = safe_cast<const Params *>(info->storageParams);
+        min_track = params->min;
+        max_track = params->max;
+        bucket_size = params->bucket_size;
+        buckets = params->buckets;
+
+        min_val = CounterLimits::max();
+        max_val = CounterLimits::min();
+        underflow = Counter();
+        overflow = Counter();
+
+        cmap.clear();
+
+        sum = Counter();
+        squares = Counter();
+        samples = Counter();
+    }
+};
+
 /**
  * Templatized storage and interface for a histogram stat.
  */
@@ -2046,13 +2325,43 @@ class DistProxy
 //
 //////////////////////////////////////////////////////////////////////
 
+/**
+ * Generation counter for formula result caching. While a dump is in
+ * progress no stat can change, so formula nodes remember the result
+ * vector they computed for the current generation and hand it back on
+ * later calls instead of re-walking their subtree. Zero means caching
+ * is disabled and every call recomputes.
+ */
+extern uint64_t formulaCacheGen;
+
+/** Start a new caching generation (called at the beginning of a dump). */
+void beginFormulaCache();
+
+/** Disable caching again once the dump is complete. */
+void endFormulaCache();
+
 /**
  * Base class for formula statistic node. These nodes are used to build a tree
  * that represents the formula.
  */
 class Node
 {
+  protected:
+    /** Generation in which the cached result was computed. */
+    mutable uint64_t cacheGen;
+
+    bool
+    cached() const
+    {
+        return formulaCacheGen && cacheGen == formulaCacheGen;
+    }
+
+    void setCached() const { cacheGen = formulaCacheGen; }
+
   public:
+    Node() : cacheGen(0) {}
+    virtual ~Node() {}
+
     /**
      * Return the number of nodes in the subtree starting at this node.
      * @return the number of nodes in this subtree.
@@ -2149,10 +2458,21 @@ class VectorStatNode : public Node
 {
   private:
     const VectorInfo *data;
+    mutable const VResult *vresult;
 
   public:
-    VectorStatNode(const VectorInfo *d) : data(d) { }
-    const VResult &result() const { return data->result(); }
+    VectorStatNode(const VectorInfo *d) : data(d), vresult(NULL) { }
+
+    const VResult &
+    result() const
+    {
+        if (!cached()) {
+            vresult = &data->result();
+            setCached();
+        }
+        return *vresult;
+    }
+
     Result total() const { return data->total(); };
 
     size_type size() const { return data->size(); }
@@ -2259,6 +2579,9 @@ class UnaryNode : public Node
     const VResult &
     result() const
     {
+        if (cached())
+            return vresult;
+
         const VResult &lvec = l->result();
         size_type size = lvec.size();
 
@@ -2269,6 +2592,7 @@ class UnaryNode : public Node
         for (off_type i = 0; i < size; ++i)
             vresult[i] = op(lvec[i]);
 
+        setCached();
         return vresult;
     }
 
@@ -2305,6 +2629,9 @@ class BinaryNode : public Node
     const VResult &
     result() const
     {
+        if (cached())
+            return vresult;
+
         Op op;
         const VResult &lvec = l->result();
         const VResult &rvec = r->result();
@@ -2331,6 +2658,7 @@ class BinaryNode : public Node
                 vresult[i] = op(lvec[i], rvec[i]);
         }
 
+        setCached();
         return vresult;
     }
 
@@ -2401,6 +2729,9 @@ class SumNode : public Node
     const VResult &
     result() const
     {
+        if (cached())
+            return vresult;
+
         const VResult &lvec = l->result();
         size_type size = lvec.size();
         assert(size > 0);
@@ -2411,6 +2742,7 @@ class SumNode : public Node
         for (off_type i = 0; i < size; ++i)
             vresult[0] = op(vresult[0], lvec[i]);
 
+        setCached();
         return vresult;
     }
 
@@ -2499,6 +2831,15 @@ class Vector2d : public Vector2dBase<Vector2d, StatStor>
 {
 };
 
+/**
+ * A 2-Dimensional vector of scalar stats that only stores the cells
+ * that are written.
+ * @sa Stat, SparseVector2dBase, StatStor
+ */
+class SparseVector2d : public SparseVector2dBase<SparseVector2d, StatStor>
+{
+};
+
 /**
  * A simple distribution stat.
  * @sa Stat, DistBase, DistStor
@@ -2527,6 +2868,34 @@ class Distribution : public DistBase<Distribution, DistStor>
     }
 };
 
+/**
+ * A distribution stat that only stores the buckets that are sampled.
+ * @sa Stat, DistBase, SparseDistStor
+ */
+class SparseDistribution : public DistBase<SparseDistribution, SparseDistStor>
+{
+  public:
+    /**
+     * Set the parameters of this distribution. @sa DistStor::Params
+     * @param min The minimum value of the distribution.
+     * @param max The maximum value of the distribution.
+     * @param bkt The number of values in each bucket.
+     * @return A reference to this distribution.
+     */
+    SparseDistribution &
+    init(Counter min, Counter max, Counter bkt)
+    {
+        SparseDistStor::Params *params = new SparseDistStor::Params;
+        params->min = min;
+        params->max = max;
+        params->bucket_size = bkt;
+        params->buckets = (size_type)ceil((max - min + 1.0) / bkt);
+        this->setParams(params);
+        this->doInit();
+        return this->self();
+    }
+};
+
 /**
  * A simple histogram stat.
  * @sa Stat, DistBase, HistStor
@@ -2615,6 +2984,37 @@ class VectorDistribution : public VectorDistBase<VectorDistribution, DistStor>
     }
 };
 
+/**
+ * A vector of distributions that only store the buckets that are
+ * sampled.
+ * @sa VectorDistBase, SparseDistStor
+ */
+class SparseVectorDistribution
+    : public VectorDistBase<SparseVectorDistribution, SparseDistStor>
+{
+  public:
+    /**
+     * Initialize storage and parameters for this distribution.
+     * @param size The size of the vector (the number of distributions).
+     * @param min The minimum value of the distribution.
+     * @param max The maximum value of the distribution.
+     * @param bkt The number of values in each bucket.
+     * @return A reference to this distribution.
+     */
+    SparseVectorDistribution &
+    init(size_type size, Counter min, Counter max, Counter bkt)
+    {
+        SparseDistStor::Params *params = new SparseDistStor::Params;
+        params->min = min;
+        params->max = max;
+        params->bucket_size = bkt;
+        params->buckets = (size_type)ceil((max - min + 1.0) / bkt);
+        this->setParams(params);
+        this->doInit(size);
+        return this->self();
+    }
+};
+
 /**
  * This is a vector of StandardDeviation stats.
  * @sa VectorDistBase, SampleStor
@@ -2967,7 +3367,17 @@ class FormulaNode : public Node
     FormulaNode(const Formula &f) : formula(f) {}
 
     size_type size() const { return formula.size(); }
-    const VResult &result() const { formula.result(vec); return vec; }
+
+    const VResult &
+    result() const
+    {
+        if (!cached()) {
+            formula.result(vec);
+            setCached();
+        }
+        return vec;
+    }
+
     Result total() const { return formula.total(); }
 
     std::string str() const { return formula.str(); }
@@ -3246,12 +3656,22 @@ void processResetQueue();
  */
 void processDumpQueue();
 
+/**
+ * Prepare all stats for data access ahead of a dump. Stats whose
+ * prerequisite is zero are left alone when skip_zero_prereq is set,
+ * since outputs that honour prereqs would drop them anyway. With more
+ * than one thread the remaining stats are split between a pool of
+ * worker threads; prepare() only touches a stat's own storage, so
+ * independent stats can be prepared concurrently.
+ */
+void prepareStats(bool skip_zero_prereq, unsigned threads = 1);
+
 std::list<Info *> &statsList();
 
-typedef std::map<const void *, Info *> MapType;
+typedef m5::hash_map<const void *, Info *> MapType;
 MapType &statsMap();
 
-typedef std::map<std::string, Info *> NameMapType;
+typedef m5::hash_map<std::string, Info *> NameMapType;
 NameMapType &nameMap();
 
 bool validateStatName(const std::string &name);
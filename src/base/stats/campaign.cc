@@ -0,0 +1,162 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/campaign.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "base/misc.hh"
+
+namespace Stats {
+
+Campaign::Campaign() :
+    fd(-1)
+{ }
+
+Campaign::~Campaign()
+{
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void
+Campaign::open(const std::string &_filename)
+{
+    if (fd >= 0)
+        panic("campaign stats already open!");
+
+    filename = _filename;
+    fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+        fatal("Unable to open %s for appending: %s\n", filename,
+            strerror(errno));
+
+    Columnar::open(buffer);
+}
+
+bool
+Campaign::valid() const
+{
+    return fd >= 0 && Columnar::valid();
+}
+
+void
+Campaign::begin()
+{
+    /* Every record carries its own schema */
+    schemaWritten = false;
+    entries.clear();
+    widths.clear();
+    buffer.str("");
+
+    Columnar::begin();
+}
+
+void
+Campaign::end()
+{
+    Columnar::end();
+
+    std::string data = buffer.str();
+    uint32_t tag_length = tag.size();
+    uint32_t data_length = data.size();
+
+    std::string record("gem5camp", 8);
+    record.append(reinterpret_cast<const char *>(&tag_length),
+        sizeof(tag_length));
+    record.append(tag);
+    record.append(reinterpret_cast<const char *>(&data_length),
+        sizeof(data_length));
+    record.append(data);
+
+    append(record);
+}
+
+void
+Campaign::append(const std::string &data)
+{
+    struct flock lock;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+
+    /* POSIX locks belong to the process, so forked runs sharing the
+     * descriptor still exclude each other */
+    while (fcntl(fd, F_SETLKW, &lock) < 0) {
+        if (errno != EINTR)
+            fatal("Unable to lock %s: %s\n", filename, strerror(errno));
+    }
+
+    const char *p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd, p, left);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            fatal("Unable to append to %s: %s\n", filename,
+                strerror(errno));
+        }
+        p += written;
+        left -= written;
+    }
+
+    lock.l_type = F_UNLCK;
+    fcntl(fd, F_SETLK, &lock);
+}
+
+static Campaign &
+campaign()
+{
+    static Campaign theCampaign;
+    return theCampaign;
+}
+
+Output *
+initCampaign(const std::string &filename)
+{
+    static bool connected = false;
+
+    if (!connected) {
+        campaign().open(filename);
+        connected = true;
+    }
+
+    return &campaign();
+}
+
+void
+setCampaignTag(const std::string &tag)
+{
+    campaign().setTag(tag);
+}
+
+} // namespace Stats
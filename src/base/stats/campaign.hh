@@ -0,0 +1,93 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_CAMPAIGN_HH__
+#define __BASE_STATS_CAMPAIGN_HH__
+
+#include <sstream>
+#include <string>
+
+#include "base/stats/columnar.hh"
+#include "base/compiler.hh"
+
+namespace Stats {
+
+/**
+ * Statistics output shared by the runs of a campaign.  Every dump
+ * appends one self-contained record to a single file, so that any
+ * number of simulators can report to it without creating files of
+ * their own.  A record is written with one write() under a POSIX lock
+ * of the file, which keeps records whole even on network file systems:
+ *
+ *   char[8]  "gem5camp"
+ *   string   tag identifying the run, see setCampaignTag()
+ *   uint32   length of the columnar data
+ *   a columnar stats file (see Columnar) with a single row
+ *
+ * with strings as a uint32 length and that many characters, in host
+ * byte order.  Only the stats the dump visits are stored, so callers
+ * select the stats by visiting just those.
+ */
+class Campaign : public Columnar
+{
+  protected:
+    /** Descriptor of the shared file */
+    int fd;
+
+    std::string filename;
+    std::string tag;
+
+    /** The columnar data of the record being built */
+    std::ostringstream buffer;
+
+    /** Append data to the shared file under its lock */
+    void append(const std::string &data);
+
+  public:
+    Campaign();
+    ~Campaign();
+
+    void open(const std::string &filename);
+    void setTag(const std::string &_tag) { tag = _tag; }
+
+    // Implement Output
+    bool valid() const M5_ATTR_OVERRIDE;
+    void begin() M5_ATTR_OVERRIDE;
+    void end() M5_ATTR_OVERRIDE;
+};
+
+/** The campaign output appending to filename, which is not relative to
+ *  the output directory and may be shared with other simulators */
+Output *initCampaign(const std::string &filename);
+
+/** Set the tag of the records of the campaign output, e.g. the run's
+ *  configuration hash and ID */
+void setCampaignTag(const std::string &tag);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_CAMPAIGN_HH__
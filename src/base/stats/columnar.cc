@@ -0,0 +1,345 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <cmath>
+#include <ostream>
+
+#include "base/stats/info.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+
+namespace Stats {
+
+static const uint32_t columnarVersion = 1;
+
+Columnar::Columnar() :
+    stream(NULL), schemaWritten(false), current(0), warnedWidth(false)
+{ }
+
+void
+Columnar::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+}
+
+bool
+Columnar::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+bool
+Columnar::noOutput(const Info &info)
+{
+    return !info.flags.isSet(display);
+}
+
+void
+Columnar::begin()
+{
+    current = 0;
+    row.clear();
+    row.push_back(curTick());
+}
+
+void
+Columnar::writeString(const std::string &str)
+{
+    uint32_t length = str.size();
+
+    stream->write(reinterpret_cast<const char *>(&length), sizeof(length));
+    stream->write(str.data(), length);
+}
+
+void
+Columnar::writeSchema()
+{
+    uint32_t num_entries = entries.size();
+    uint32_t row_width = row.size() - 1;
+
+    stream->write("gem5cols", 8);
+    stream->write(reinterpret_cast<const char *>(&columnarVersion),
+        sizeof(columnarVersion));
+    stream->write(reinterpret_cast<const char *>(&num_entries),
+        sizeof(num_entries));
+    stream->write(reinterpret_cast<const char *>(&row_width),
+        sizeof(row_width));
+
+    for (auto i = entries.begin(); i != entries.end(); ++i) {
+        uint8_t kind = i->kind;
+        uint32_t width = i->labels.size();
+
+        writeString(i->name);
+        stream->write(reinterpret_cast<const char *>(&kind), sizeof(kind));
+        stream->write(reinterpret_cast<const char *>(&width),
+            sizeof(width));
+        for (auto label = i->labels.begin(); label != i->labels.end();
+            ++label)
+        {
+            writeString(*label);
+        }
+    }
+
+    /* Only the widths are needed from now on */
+    entries.clear();
+    schemaWritten = true;
+}
+
+void
+Columnar::end()
+{
+    if (!schemaWritten)
+        writeSchema();
+
+    /* Keep the row to the schema should a stat have disappeared */
+    while (current < widths.size())
+        appendValues(std::vector<double>());
+
+    stream->write(reinterpret_cast<const char *>(row.data()),
+        row.size() * sizeof(double));
+    stream->flush();
+}
+
+void
+Columnar::addEntry(const Info &info, Kind kind,
+    const std::vector<std::string> &labels)
+{
+    Entry entry;
+
+    entry.name = info.name;
+    entry.kind = kind;
+    entry.labels = labels;
+    entries.push_back(entry);
+    widths.push_back(labels.size());
+}
+
+void
+Columnar::appendValues(const std::vector<double> &values)
+{
+    if (current >= widths.size())
+        panic("Stats dumped to %s outnumber the schema\n", "columnar");
+
+    size_type width = widths[current];
+    current++;
+
+    if (values.size() != width && !warnedWidth) {
+        warn("Columnar stats: an entry changed width from %d to %d, "
+            "fitting it to the schema\n", width, values.size());
+        warnedWidth = true;
+    }
+
+    for (size_type i = 0; i < width; i++)
+        row.push_back(i < values.size() ? values[i] : NAN);
+}
+
+void
+Columnar::distLabels(const DistData &data, const std::string &prefix,
+    std::vector<std::string> &labels)
+{
+    static const char *fields[] = { "samples", "sum", "squares",
+        "min_val", "max_val", "underflow", "overflow" };
+
+    for (const char *field : fields)
+        labels.push_back(prefix + field);
+
+    for (size_type i = 0; i < data.cvec.size(); i++) {
+        Counter low = data.min + i * data.bucket_size;
+        labels.push_back(prefix + std::to_string((long long)low));
+    }
+}
+
+void
+Columnar::distValues(const DistData &data, std::vector<double> &values)
+{
+    values.push_back(data.samples);
+    values.push_back(data.sum);
+    values.push_back(data.squares);
+    values.push_back(data.min_val);
+    values.push_back(data.max_val);
+    values.push_back(data.underflow);
+    values.push_back(data.overflow);
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+/** A vector element's label: its subname, or its index */
+static std::string
+subname(const std::vector<std::string> &subnames, size_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten)
+        addEntry(info, ScalarKind, std::vector<std::string>(1));
+
+    appendValues(std::vector<double>(1, info.result()));
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten) {
+        std::vector<std::string> labels;
+
+        for (size_type i = 0; i < info.size(); i++)
+            labels.push_back(subname(info.subnames, i));
+        addEntry(info, VectorKind, labels);
+    }
+
+    const VResult &result = info.result();
+    appendValues(std::vector<double>(result.begin(), result.end()));
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten) {
+        std::vector<std::string> labels;
+
+        distLabels(info.data, "", labels);
+        addEntry(info, DistKind, labels);
+    }
+
+    std::vector<double> values;
+    distValues(info.data, values);
+    appendValues(values);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten) {
+        std::vector<std::string> labels;
+
+        for (size_type i = 0; i < info.size(); i++)
+            distLabels(info.data[i], subname(info.subnames, i) + ".",
+                labels);
+        addEntry(info, VectorDistKind, labels);
+    }
+
+    std::vector<double> values;
+    for (size_type i = 0; i < info.size(); i++)
+        distValues(info.data[i], values);
+    appendValues(values);
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten) {
+        std::vector<std::string> labels;
+
+        for (size_type i = 0; i < info.x; i++) {
+            for (size_type j = 0; j < info.y; j++) {
+                labels.push_back(subname(info.subnames, i) + "." +
+                    subname(info.y_subnames, j));
+            }
+        }
+        addEntry(info, Vector2dKind, labels);
+    }
+
+    appendValues(std::vector<double>(info.cvec.begin(), info.cvec.end()));
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten) {
+        std::vector<std::string> labels;
+
+        /* Most formulae are scalars */
+        if (info.size() == 1 && info.subnames.empty()) {
+            labels.push_back("");
+        } else {
+            for (size_type i = 0; i < info.size(); i++)
+                labels.push_back(subname(info.subnames, i));
+        }
+        addEntry(info, FormulaKind, labels);
+    }
+
+    const VResult &result = info.result();
+    appendValues(std::vector<double>(result.begin(), result.end()));
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (!schemaWritten)
+        addEntry(info, SparseHistKind, std::vector<std::string>(1,
+            "samples"));
+
+    appendValues(std::vector<double>(1, info.data.samples));
+}
+
+Output *
+initColumnar(const std::string &filename)
+{
+    static Columnar columnar;
+    static bool connected = false;
+
+    if (!connected) {
+        columnar.open(*simout.create(filename, true));
+        connected = true;
+    }
+
+    return &columnar;
+}
+
+} // namespace Stats
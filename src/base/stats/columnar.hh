@@ -0,0 +1,156 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+#include "base/compiler.hh"
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Time-series statistics output.  The first dump writes a schema of
+ * every displayed stat, then each dump appends one row holding the tick
+ * and every stat's values as fixed-width arrays of doubles, so that
+ * periodic dumps cost a few bytes per value and can be loaded without
+ * parsing.  Written in host byte order:
+ *
+ *   char[8]  "gem5cols"
+ *   uint32   version (1)
+ *   uint32   number of entries
+ *   uint32   values per row, the sum of the entry widths
+ *   entries, each:
+ *     string name
+ *     uint8  kind (Columnar::Kind)
+ *     uint32 width
+ *     width strings labelling the values
+ *   rows, each of 1 + values per row doubles:
+ *     the tick, then the entries' values in schema order
+ *
+ * with strings as a uint32 length and that many characters.  A vector
+ * stat's values are its elements, a distribution's are samples, sum,
+ * squares, min_val, max_val, underflow, overflow and then its buckets,
+ * a vector distribution holds one distribution per element and a 2d
+ * vector is stored row major.  Sparse histograms have no fixed width
+ * and only store their samples.  Every displayed stat is stored even
+ * when its prereq is zero, so that all the rows match the schema.
+ */
+class Columnar : public Output
+{
+  public:
+    enum Kind
+    {
+        ScalarKind,
+        VectorKind,
+        DistKind,
+        VectorDistKind,
+        Vector2dKind,
+        FormulaKind,
+        SparseHistKind
+    };
+
+  protected:
+    std::ostream *stream;
+
+    /** The schema has been written by the first dump */
+    bool schemaWritten;
+
+    /** Entries of the schema being collected by the first dump */
+    struct Entry
+    {
+        std::string name;
+        Kind kind;
+        std::vector<std::string> labels;
+    };
+    std::vector<Entry> entries;
+
+    /** Entry widths, to keep later rows to the schema */
+    std::vector<size_type> widths;
+
+    /** The entry being visited */
+    size_type current;
+
+    /** The row being built */
+    std::vector<double> row;
+
+    /** Has a row not fitting the schema been reported? */
+    bool warnedWidth;
+
+    bool noOutput(const Info &info);
+
+    /** Add an entry to the schema, only on the first dump */
+    void addEntry(const Info &info, Kind kind,
+        const std::vector<std::string> &labels);
+
+    /** Append the values of the next entry to the row, fitted to its
+     *  schema width */
+    void appendValues(const std::vector<double> &values);
+
+    /** The labels and values of a distribution, prefixed by prefix */
+    static void distLabels(const DistData &data, const std::string &prefix,
+        std::vector<std::string> &labels);
+    static void distValues(const DistData &data,
+        std::vector<double> &values);
+
+    void writeString(const std::string &str);
+    void writeSchema();
+
+  public:
+    Columnar();
+
+    void open(std::ostream &stream);
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const VectorInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const DistInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const VectorDistInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const Vector2dInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const FormulaInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const SparseHistInfo &info) M5_ATTR_OVERRIDE;
+
+    // Implement Output
+    bool valid() const M5_ATTR_OVERRIDE;
+    void begin() M5_ATTR_OVERRIDE;
+    void end() M5_ATTR_OVERRIDE;
+};
+
+/** The columnar output to filename in the output directory, gzipped if
+ *  it ends in .gz */
+Output *initColumnar(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_COLUMNAR_HH__
@@ -52,6 +52,12 @@ struct Output
     virtual void end() = 0;
     virtual bool valid() const = 0;
 
+    /**
+     * True if this output never reports stats whose prereq is zero,
+     * which lets the dump skip preparing them.
+     */
+    virtual bool skipsZeroPrereq() const { return false; }
+
     virtual void visit(const ScalarInfo &info) = 0;
     virtual void visit(const VectorInfo &info) = 0;
     virtual void visit(const DistInfo &info) = 0;
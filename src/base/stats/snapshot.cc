@@ -0,0 +1,154 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/snapshot.hh"
+
+#include "base/stats/info.hh"
+
+namespace Stats {
+
+std::list<Info *> &statsList();
+
+Snapshot::Snapshot() : named(false), values(NULL)
+{ }
+
+bool
+Snapshot::noOutput(const Info &info)
+{
+    return !info.flags.isSet(display);
+}
+
+void
+Snapshot::take(std::vector<double> &snapshot)
+{
+    std::list<Info *> &stats = statsList();
+
+    snapshot.clear();
+    values = &snapshot;
+
+    begin();
+    for (auto i = stats.begin(); i != stats.end(); ++i) {
+        (*i)->prepare();
+        (*i)->visit(*this);
+    }
+    end();
+
+    values = NULL;
+}
+
+void
+Snapshot::add(const Info &info, const std::string &subname, double value)
+{
+    if (!named)
+        names_.push_back(subname.empty() ? info.name :
+            info.name + "::" + subname);
+
+    values->push_back(value);
+}
+
+/** A vector element's subname, or its index */
+static std::string
+subname(const std::vector<std::string> &subnames, size_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+void
+Snapshot::addDist(const Info &info, const std::string &prefix,
+    const DistData &data)
+{
+    add(info, prefix + "samples", data.samples);
+    add(info, prefix + "sum", data.sum);
+    add(info, prefix + "squares", data.squares);
+    add(info, prefix + "underflows", data.underflow);
+    add(info, prefix + "overflows", data.overflow);
+
+    for (size_type i = 0; i < data.cvec.size(); i++) {
+        Counter low = data.min + i * data.bucket_size;
+        add(info, prefix + std::to_string((long long)low), data.cvec[i]);
+    }
+}
+
+void
+Snapshot::visit(const ScalarInfo &info)
+{
+    if (!noOutput(info))
+        add(info, "", info.result());
+}
+
+void
+Snapshot::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    const VResult &result = info.result();
+    for (size_type i = 0; i < result.size(); i++)
+        add(info, subname(info.subnames, i), result[i]);
+}
+
+void
+Snapshot::visit(const DistInfo &info)
+{
+    if (!noOutput(info))
+        addDist(info, "", info.data);
+}
+
+void
+Snapshot::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (size_type i = 0; i < info.data.size(); i++)
+        addDist(info, subname(info.subnames, i) + "::", info.data[i]);
+}
+
+void
+Snapshot::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (size_type i = 0; i < info.x; i++) {
+        for (size_type j = 0; j < info.y; j++) {
+            add(info, subname(info.subnames, i) + "::" +
+                subname(info.y_subnames, j), info.cvec[i * info.y + j]);
+        }
+    }
+}
+
+void
+Snapshot::visit(const SparseHistInfo &info)
+{
+    if (!noOutput(info))
+        add(info, "samples", info.data.samples);
+}
+
+} // namespace Stats
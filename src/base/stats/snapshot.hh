@@ -0,0 +1,96 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_SNAPSHOT_HH__
+#define __BASE_STATS_SNAPSHOT_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+#include "base/compiler.hh"
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Copies the values of every displayed, accumulating stat into a flat
+ * vector so that the change in all the stats over an interval is the
+ * difference of two snapshots, without dumping or resetting them.
+ * Formulae are left out as their differences mean nothing (they can be
+ * recomputed from the differences of their operands), as are the
+ * minimum and maximum of distributions.  Values are named as the text
+ * output names them, with "::" before vector subnames and distribution
+ * fields.
+ */
+class Snapshot : public Output
+{
+  protected:
+    /** Value names, collected by the first snapshot */
+    std::vector<std::string> names_;
+    bool named;
+
+    /** Where the snapshot being taken goes */
+    std::vector<double> *values;
+
+    bool noOutput(const Info &info);
+
+    /** Add a value, and its name on the first snapshot */
+    void add(const Info &info, const std::string &subname, double value);
+
+    void addDist(const Info &info, const std::string &prefix,
+        const DistData &data);
+
+  public:
+    Snapshot();
+
+    /** Prepare all the stats and copy their values into snapshot */
+    void take(std::vector<double> &snapshot);
+
+    /** The names of the values in snapshots, once one is taken */
+    const std::vector<std::string> &names() const { return names_; }
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const VectorInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const DistInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const VectorDistInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const Vector2dInfo &info) M5_ATTR_OVERRIDE;
+    void visit(const FormulaInfo &info) M5_ATTR_OVERRIDE { }
+    void visit(const SparseHistInfo &info) M5_ATTR_OVERRIDE;
+
+    // Implement Output
+    bool valid() const M5_ATTR_OVERRIDE { return true; }
+    void begin() M5_ATTR_OVERRIDE { }
+    void end() M5_ATTR_OVERRIDE { named = true; }
+};
+
+} // namespace Stats
+
+#endif // __BASE_STATS_SNAPSHOT_HH__
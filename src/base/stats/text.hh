@@ -72,6 +72,7 @@ class Text : public Output
 
     // Implement Output
     virtual bool valid() const;
+    virtual bool skipsZeroPrereq() const { return true; }
     virtual void begin();
     virtual void end();
 };
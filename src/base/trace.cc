@@ -34,6 +34,7 @@
  */
 
 #include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -78,17 +79,50 @@ output()
     return getDebugLogger()->getOstream();
 }
 
+/** Close the logger as the simulator exits so that buffered loggers
+ *  write everything out */
+static void
+closeDebugLogger()
+{
+    delete debug_logger;
+    debug_logger = NULL;
+}
+
 void
 setDebugLogger(Logger *logger)
 {
-    if (!logger)
+    static bool close_at_exit = false;
+
+    if (!logger) {
         warn("Trying to set debug logger to NULL\n");
-    else
+    } else {
+        if (debug_logger)
+            debug_logger->flush();
         debug_logger = logger;
+
+        if (!close_at_exit) {
+            std::atexit(closeDebugLogger);
+            close_at_exit = true;
+        }
+    }
+}
+
+void
+flush()
+{
+    if (debug_logger)
+        debug_logger->flush();
 }
 
 ObjectMatch ignore;
 
+Logger::LineBuffer &
+Logger::lineBuffer()
+{
+    static thread_local LineBuffer buf;
+    return buf;
+}
+
 void
 Logger::dump(Tick when, const std::string &name, const void *d, int len)
 {
@@ -135,8 +169,10 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     if (!name.empty() && ignore.match(name))
         return;
 
-    if (when != MaxTick)
-        ccprintf(stream, "%7d: ", when);
+    if (when != MaxTick) {
+        static cp::FormatCache when_format;
+        ccprintf(stream, *when_format.get("%7d: "), when);
+    }
 
     if (!name.empty())
         stream << name << ": ";
@@ -36,6 +36,7 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <sstream>
 #include <string>
 
 #include "base/cprintf.hh"
@@ -54,7 +55,46 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /** Reused to format each message rather than setting up a new
+     *  stream every time.  There is one per host thread, as the
+     *  threads of a multi-eventq simulation log concurrently */
+    struct LineBuffer
+    {
+        std::ostringstream line;
+        /** line is in use, so a message formatted while another is
+         *  (by an argument's operator<<) needs a stream of its own */
+        bool busy;
+
+        LineBuffer() : busy(false) { }
+    };
+
+    /** The line buffer of the calling thread */
+    static LineBuffer &lineBuffer();
+
+    template <typename Fmt, typename ...Args>
+    void
+    format(Tick when, const std::string &name, const Fmt &fmt,
+           const Args &...args)
+    {
+        LineBuffer &buf = lineBuffer();
+
+        if (buf.busy) {
+            std::ostringstream nested;
+            ccprintf(nested, fmt, args...);
+            logMessage(when, name, nested.str());
+            return;
+        }
+
+        buf.busy = true;
+        buf.line.str(std::string());
+        ccprintf(buf.line, fmt, args...);
+        buf.busy = false;
+        logMessage(when, name, buf.line.str());
+    }
+
   public:
+    Logger() { }
+
     /** Log a single message */
     template <typename ...Args>
     void dprintf(Tick when, const std::string &name, const char *fmt,
@@ -63,9 +103,38 @@ class Logger
         if (!name.empty() && ignore.match(name))
             return;
 
-        std::ostringstream line;
-        ccprintf(line, fmt, args...);
-        logMessage(when, name, line.str());
+        format(when, name, fmt, args...);
+    }
+
+    /** Log a message from a call site with a constant format, which is
+     *  only parsed the first time (see DPRINTF) */
+    template <size_t N, typename ...Args>
+    void dprintf(Tick when, const std::string &name, cp::FormatCache &cache,
+                 const char (&fmt)[N], const Args &...args)
+    {
+        if (!name.empty() && ignore.match(name))
+            return;
+
+        const cp::FormatString *parsed = cache.get(fmt);
+        if (parsed)
+            format(when, name, *parsed, args...);
+        else
+            format(when, name, fmt, args...);
+    }
+
+    /** Any other format may change from call to call */
+    template <typename Fmt, typename ...Args>
+    void dprintf(Tick when, const std::string &name, cp::FormatCache &cache,
+                 const Fmt &fmt, const Args &...args)
+    {
+        dprintf(when, name, fmt, args...);
+    }
+
+    template <size_t N, typename ...Args>
+    void dprintf(Tick when, const std::string &name, cp::FormatCache &cache,
+                 char (&fmt)[N], const Args &...args)
+    {
+        dprintf(when, name, fmt, args...);
     }
 
     /** Dump a block of data of length len */
@@ -86,6 +155,9 @@ class Logger
     /** Set objects to ignore */
     void setIgnore(ObjectMatch &ignore_) { ignore = ignore_; }
 
+    /** Make sure everything logged so far has reached the output */
+    virtual void flush() { }
+
     virtual ~Logger() { }
 };
 
@@ -116,6 +188,9 @@ std::ostream &output();
 /** Delete the current global logger and assign a new one */
 void setDebugLogger(Logger *logger);
 
+/** Flush the current global logger, e.g. before the simulator stops */
+void flush();
+
 /** Enable debug logging */
 extern bool enabled;
 
@@ -157,10 +232,21 @@ class Named
 // If you desire that the automatic printing not occur, use DPRINTFR
 // (R for raw)
 //
+// The arguments of DPRINTF are only evaluated when the flag is on.
+// Anything computed only to be traced (symbol lookups, disassembly,
+// strings built up in a stream) belongs inside an if (DTRACE(x)) block
+// so that it is skipped as well.  DTRACE(x) is the constant false when
+// tracing is compiled out (gem5.fast) or x is one of the build's
+// STRIP_DEBUG_FLAGS, so such blocks are removed by the compiler.
+//
+// Each call site keeps its format, when that is a literal, parsed in
+// a static cp::FormatCache, so only the arguments are formatted on
+// each call.
+//
 
 #if TRACING_ON
 
-#define DTRACE(x) ((Debug::x) && Trace::enabled)
+#define DTRACE(x) (Debug::x##Traced && (Debug::x) && Trace::enabled)
 
 #define DDUMP(x, data, count) do {                                        \
     using namespace Debug;                                                \
@@ -171,24 +257,27 @@ class Named
 #define DPRINTF(x, ...) do {                                              \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
+        static cp::FormatCache _dprintf_format;                           \
         Trace::getDebugLogger()->dprintf(curTick(), name(),               \
-            __VA_ARGS__);                                                 \
+            _dprintf_format, __VA_ARGS__);                                \
     }                                                                     \
 } while (0)
 
 #define DPRINTFS(x, s, ...) do {                                          \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
+        static cp::FormatCache _dprintf_format;                           \
         Trace::getDebugLogger()->dprintf(curTick(), s->name(),            \
-            __VA_ARGS__);                                                 \
+            _dprintf_format, __VA_ARGS__);                                \
     }                                                                     \
 } while (0)
 
 #define DPRINTFR(x, ...) do {                                             \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
+        static cp::FormatCache _dprintf_format;                           \
         Trace::getDebugLogger()->dprintf((Tick)-1, std::string(),         \
-            __VA_ARGS__);                                                 \
+            _dprintf_format, __VA_ARGS__);                                \
     }                                                                     \
 } while (0)
 
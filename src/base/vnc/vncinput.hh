@@ -202,6 +202,12 @@ class VncInput : public SimObject
             captureFrameBuffer();
     }
 
+    /** Does anything look at the frame buffer contents when it's
+     * marked dirty? Frame buffer devices may skip fetching frames
+     * nobody is going to see.
+     */
+    virtual bool hasConsumer() const { return captureEnabled; }
+
     /** Set the mode of the data the frame buffer will be sending us
      * @param mode the mode
      */
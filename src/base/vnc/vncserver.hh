@@ -318,6 +318,13 @@ class VncServer : public VncInput
         sendFrameBufferUpdate();
     }
 
+    bool
+    hasConsumer() const
+    {
+        return VncInput::hasConsumer() ||
+            (dataFd > 0 && curState == NormalPhase);
+    }
+
     /** Set the mode of the data the frame buffer will be sending us
      * @param mode the mode
      */
@@ -35,6 +35,12 @@ class ExeTracer(InstTracer):
     cxx_class = 'Trace::ExeTracer'
     cxx_header = "cpu/exetrace.hh"
 
+    binary_file = Param.String("", "Write every committed instruction to"
+        " this file as a binary trace (proto/exec.proto) instead of as"
+        " text, gzipped if the name ends in .gz")
+    binary_keyframe = Param.Unsigned(4096, "Records between binary trace"
+        " keyframes, the points a reader can start decoding from")
+
 class IntelTrace(InstTracer):
     type = 'IntelTrace'
     cxx_class = 'Trace::IntelTrace'
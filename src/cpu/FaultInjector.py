@@ -0,0 +1,66 @@
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import SimObject
+
+# A fault target is a structure registered with the injector by the CPU
+# model (e.g. 'system.cpu.int_regs'), an entry and bit of that structure
+# and a trigger.  The injector fires once, when either trigger is met.
+
+class FaultInjector(SimObject):
+    type = 'FaultInjector'
+    cxx_header = 'cpu/fault_injector.hh'
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+    void reseed(uint64_t seed, uint64_t run_id);
+    void retarget(const std::string &structure, int index, int bit,
+        uint64_t trigger_seq_num);
+''')
+
+    seed = Param.UInt64(0, "Campaign seed for random fault choices")
+    run_id = Param.UInt64(0, "Run ID within the campaign.  Runs with the"
+        " same seed and ID make the same choices")
+
+    structure = Param.String("", "Name of the registered structure to"
+        " corrupt (empty for none)")
+    index = Param.Int(-1, "Entry of the structure to corrupt, -1 for a"
+        " random entry")
+    bit = Param.Int(-1, "Bit of the entry to flip, -1 for a random bit")
+    trigger_seq_num = Param.UInt64(0, "Inject as the instruction with"
+        " this execute sequence number commits (0 for no seqnum trigger)")
+    trigger_tick = Param.Tick(0, "Inject at this tick (0 for no tick"
+        " trigger)")
+    batch_size = Param.Unsigned(1, "Faults to inject in one run (at most"
+        " 64), each tracked separately")
+    batch_spacing = Param.UInt64(0, "Seqnums or ticks between the triggers"
+        " of consecutive faults of a batch")
+    outcomes_file = Param.String("fault_outcomes.txt", "File in the output"
+        " directory to write the outcome of each fault to, empty for none")
+    memory_sites = VectorParam.MemObject([], "Caches and memories whose"
+        " arrays to register as fault sites: <cache>.data, <cache>.tags"
+        " and <memory>.array")
@@ -114,7 +114,7 @@ class ActivityRecorder
      *  buffers, so it should have a 1 somewhere in it only if there
      *  is active communication in a time buffer.
      */
-    TimeBuffer<bool> activityBuffer;
+    TimeBuffer<bool, TimeBufferResetZero<bool> > activityBuffer;
 
     /** Longest latency time buffer in the CPU. */
     int longestLatency;
@@ -58,6 +58,7 @@
 #include "cpu/checker/cpu.hh"
 #include "cpu/base.hh"
 #include "cpu/cpuevent.hh"
+#include "cpu/pc_event.hh"
 #include "cpu/profile.hh"
 #include "cpu/thread_context.hh"
 #include "debug/Mwait.hh"
@@ -126,6 +127,7 @@ BaseCPU::BaseCPU(Params *p, bool is_checker)
       _switchedOut(p->switched_out), _cacheLineSize(p->system->cacheLineSize()),
       interrupts(p->interrupts), profileEvent(NULL),
       numThreads(p->numThreads), system(p->system),
+      ppCommitPC(nullptr),
       functionTraceStream(nullptr), currentFunctionStart(0),
       currentFunctionEnd(0), functionEntryTick(0),
       addressMonitor()
@@ -363,6 +365,9 @@ BaseCPU::regProbePoints()
     ppRetiredLoads = pmuProbePoint("RetiredLoads");
     ppRetiredStores = pmuProbePoint("RetiredStores");
     ppRetiredBranches = pmuProbePoint("RetiredBranches");
+
+    ppCommitPC = new ProbePointArg<CommitPCArg>(getProbeManager(),
+                                                "CommitPC");
 }
 
 void
@@ -680,6 +685,17 @@ BaseCPU::scheduleInstStop(ThreadID tid, Counter insts, const char *cause)
     comInstEventQueue[tid]->schedule(event, now + insts);
 }
 
+void
+BaseCPU::scheduleSymbolStop(const char *symbol, const char *cause)
+{
+    Addr addr;
+
+    if (!debugSymbolTable || !debugSymbolTable->findAddress(symbol, addr))
+        fatal("%s: no symbol %s to stop at\n", name(), symbol);
+
+    new ExitPCEvent(&system->pcEventQueue, cause, addr);
+}
+
 AddressMonitor::AddressMonitor() {
     armed = false;
     waiting = false;
@@ -457,6 +457,20 @@ class BaseCPU : public MemObject
      */
     void scheduleLoadStop(ThreadID tid, Counter loads, const char *cause);
 
+    /**
+     * Schedule an event that exits the simulation loops the first time
+     * any CPU of the system reaches a symbol of the workload.
+     *
+     * This method is usually called from the configuration script to
+     * fast-forward to a region of interest (e.g. main) before switching
+     * to a detailed CPU.
+     *
+     * @param symbol Symbol to stop at, looked up in the debug symbol
+     * table.
+     * @param cause Cause to signal in the exit event.
+     */
+    void scheduleSymbolStop(const char *symbol, const char *cause);
+
   public:
     /**
      * @{
@@ -501,6 +515,21 @@ class BaseCPU : public MemObject
     /** Retired branches (any type) */
     ProbePoints::PMUUPtr ppRetiredBranches;
 
+    /** PC and static instruction of a committed instruction */
+    typedef std::pair<Addr, StaticInstPtr> CommitPCArg;
+
+    /**
+     * Committed instruction PC probe point.
+     *
+     * This probe point is triggered for every committed instruction
+     * (or micro-op) with its PC. Unlike the model specific commit
+     * probes, its argument is the same in every CPU model, which lets
+     * PC based profilers like the SimPoint probe attach to any of
+     * them. CPU models should only build the argument if
+     * hasListeners() is true.
+     */
+    ProbePointArg<CommitPCArg> *ppCommitPC;
+
     /** @} */
 
 
@@ -234,6 +234,9 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Store queue index. */
     int16_t sqIdx;
 
+    /** Memory dependence unit entry, -1 when not in the unit. */
+    int memDepIdx;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
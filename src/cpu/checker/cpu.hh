@@ -86,6 +86,13 @@ class Request;
  * Checker's state through any ThreadContext accesses.  This allows the
  * checker to be able to correctly verify instructions, even with
  * external accesses to the ThreadContext that change state.
+ *
+ * Verification happens synchronously on the simulation thread when
+ * the main CPU commits an instruction. The checker can't be moved to
+ * a separate host thread: it reads instructions and data through
+ * functional accesses that must observe memory as it was at commit,
+ * it services the system's PC events, and the dynamic instructions it
+ * inspects are reference counted without any synchronization.
  */
 class CheckerCPU : public BaseCPU, public ExecContext
 {
@@ -243,18 +243,22 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
 
             // If not in the middle of a macro instruction
             if (!curMacroStaticInst) {
-                // set up memory request for instruction fetch
-                memReq = new Request(unverifiedInst->threadNumber, fetch_PC,
-                                     sizeof(MachInst),
-                                     0,
-                                     masterId,
-                                     fetch_PC, thread->contextId(),
-                                     unverifiedInst->threadNumber);
-                memReq->setVirt(0, fetch_PC, sizeof(MachInst),
-                                Request::INST_FETCH, masterId, thread->instAddr());
-
-
-                fault = itb->translateFunctional(memReq, tc, BaseTLB::Execute);
+                // set up memory request for instruction fetch. The
+                // request and packet only live for the duration of
+                // the functional access, so keep them off the heap.
+                Request fetch_req(unverifiedInst->threadNumber, fetch_PC,
+                                  sizeof(MachInst),
+                                  0,
+                                  masterId,
+                                  fetch_PC, thread->contextId(),
+                                  unverifiedInst->threadNumber);
+                fetch_req.setVirt(0, fetch_PC, sizeof(MachInst),
+                                  Request::INST_FETCH, masterId,
+                                  thread->instAddr());
+
+
+                fault = itb->translateFunctional(&fetch_req, tc,
+                                                 BaseTLB::Execute);
 
                 if (fault != NoFault) {
                     if (unverifiedInst->getFault() == NoFault) {
@@ -271,7 +275,6 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
                         advancePC(NoFault);
 
                         // Give up on an ITB fault..
-                        delete memReq;
                         unverifiedInst = NULL;
                         return;
                     } else {
@@ -279,18 +282,14 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
                         // the fault and see if our results match the CPU on
                         // the next tick().
                         fault = unverifiedInst->getFault();
-                        delete memReq;
                         break;
                     }
                 } else {
-                    PacketPtr pkt = new Packet(memReq, MemCmd::ReadReq);
+                    Packet pkt(&fetch_req, MemCmd::ReadReq);
 
-                    pkt->dataStatic(&machInst);
-                    icachePort->sendFunctional(pkt);
+                    pkt.dataStatic(&machInst);
+                    icachePort->sendFunctional(&pkt);
                     machInst = gtoh(machInst);
-
-                    delete memReq;
-                    delete pkt;
                 }
             }
 
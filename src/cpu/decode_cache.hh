@@ -57,6 +57,14 @@ class AddrMap
     struct CachePage {
         Value items[TheISA::PageBytes];
     };
+    // Number of pages in the flat window.
+    static const Addr FlatPages = 512;
+    // Pages in a flat window placed around the first address looked up,
+    // normally the program's entry point in its text segment.  Lookups
+    // in the window only cost an index, skipping the hash_map.
+    CachePage *flat[FlatPages];
+    Addr flatBase;
+    bool flatPlaced;
     // A map of cache pages which allows a sparse mapping.
     typedef typename m5::hash_map<Addr, CachePage *> PageMap;
     typedef typename PageMap::iterator PageIt;
@@ -82,6 +90,22 @@ class AddrMap
     {
         Addr page_addr = addr & ~(TheISA::PageBytes - 1);
 
+        if (!flatPlaced) {
+            // Leave a quarter of the window below the first page.
+            Addr below = (FlatPages / 4) * TheISA::PageBytes;
+            flatBase = page_addr > below ? page_addr - below : 0;
+            flatPlaced = true;
+        }
+
+        // Check the flat window, addresses below it wrap to out of range.
+        Addr flat_index = (page_addr - flatBase) / TheISA::PageBytes;
+        if (flat_index < FlatPages) {
+            CachePage *&page = flat[flat_index];
+            if (!page)
+                page = new CachePage;
+            return page;
+        }
+
         // Check against recent lookups.
         if (recent[0] != pageMap.end()) {
             if (recent[0]->first == page_addr)
@@ -111,9 +135,11 @@ class AddrMap
 
   public:
     /// Constructor
-    AddrMap()
+    AddrMap() : flatBase(0), flatPlaced(false)
     {
         recent[0] = recent[1] = pageMap.end();
+        for (Addr i = 0; i < FlatPages; i++)
+            flat[i] = NULL;
     }
 
     Value &
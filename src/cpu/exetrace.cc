@@ -35,14 +35,26 @@
 
 #include "arch/isa_traits.hh"
 #include "arch/utility.hh"
+#include "base/loader/region_map.hh"
+#include "base/callback.hh"
 #include "base/loader/symtab.hh"
+#include "base/output.hh"
+#include "config/have_protobuf.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
 #include "cpu/exetrace.hh"
+#include "cpu/reg_class.hh"
 #include "cpu/static_inst.hh"
 #include "cpu/thread_context.hh"
 #include "debug/ExecAll.hh"
 #include "enums/OpClass.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/exec.pb.h"
+#include "proto/protoio.hh"
+#endif
 
 using namespace std;
 using namespace TheISA;
@@ -71,14 +83,11 @@ Trace::ExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran, int tick)
 bool srcIsMaster=true;
 bool desIsMaster=true;
 ostream &outs = Trace::output();
-    std::string sym_str,funcName;
+    const std::string *sym_str;
     Addr sym_addr;
     Addr cur_pc = pc.instAddr();
-debugSymbolTable->findNearestSymbol(cur_pc, funcName, sym_addr);
-
 
-//std::cout << "inst->debugEnd = " << inst->debugEnd << " && when  " << when << "\n";
-if ( (funcName == "main" || ((funcName[0] == 'F' && funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))) && (instCount < 1000 ))
+if (debugRegionMap.inROI(cur_pc) && (instCount < 1000 ))
 {
 instCount++;
 unsigned int num_src_regs = inst->numSrcRegs();
@@ -120,10 +129,10 @@ if (desIsMaster && srcIsMaster && printOriginal)
 
     if (debugSymbolTable && Debug::ExecSymbol &&
             (!FullSystem || !inUserMode(thread)) &&
-            debugSymbolTable->findNearestSymbol(cur_pc, sym_str, sym_addr)) {
+            (sym_str = debugSymbolTable->nearestSymbol(cur_pc, sym_addr))) {
+        outs << "@" << *sym_str;
         if (cur_pc != sym_addr)
-            sym_str += csprintf("+%d",cur_pc - sym_addr);
-        outs << "@" << sym_str;
+            ccprintf(outs, "+%d", cur_pc - sym_addr);
     } else {
         outs << "0x" << hex << cur_pc;
     }
@@ -203,10 +212,10 @@ else
 
     if (debugSymbolTable && Debug::ExecSymbol &&
             (!FullSystem || !inUserMode(thread)) &&
-            debugSymbolTable->findNearestSymbol(cur_pc, sym_str, sym_addr)) {
+            (sym_str = debugSymbolTable->nearestSymbol(cur_pc, sym_addr))) {
+        outs << "@" << *sym_str;
         if (cur_pc != sym_addr)
-            sym_str += csprintf("+%d",cur_pc - sym_addr);
-        outs << "@" << sym_str;
+            ccprintf(outs, "+%d", cur_pc - sym_addr);
     } else {
         outs << "0x" << hex << cur_pc;
     }
@@ -288,6 +297,167 @@ Trace::ExeTracerRecord::dump()
     }
 }
 
+ProtoOutputStream *ExeTracer::binaryStream = NULL;
+uint64_t ExeTracer::numBinaryRecords = 0;
+unsigned int ExeTracer::keyframeInterval = 1;
+Addr ExeTracer::lastPc = 0;
+Tick ExeTracer::lastTick = 0;
+InstSeqNum ExeTracer::lastSeqNum = 0;
+Addr ExeTracer::lastMemAddr = 0;
+
+ExeTracer::ExeTracer(const Params *params) : InstTracer(params)
+{
+    if (params->binary_file != "")
+        createBinaryTrace(params->binary_file, params->binary_keyframe);
+}
+
+void
+ExeTracer::createBinaryTrace(const std::string &file_name,
+    unsigned int keyframe_interval)
+{
+    // All the tracers share the trace opened by the first of them
+    if (binaryStream)
+        return;
+
+    if (keyframe_interval == 0)
+        fatal("%s: binary_keyframe must be at least 1\n", name());
+
+#if HAVE_PROTOBUF
+    keyframeInterval = keyframe_interval;
+    binaryStream = new ProtoOutputStream(simout.resolve(file_name));
+
+    ProtoMessage::ExecHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_ver(0);
+    header_msg.set_tick_freq(SimClock::Frequency);
+    header_msg.set_keyframe_interval(keyframeInterval);
+    binaryStream->write(header_msg);
+
+    registerExitCallback(new MakeCallback<ExeTracer,
+        &ExeTracer::closeBinaryTrace>(this));
+#else
+    fatal("%s: binary trace %s needs gem5 built with protobuf support\n",
+        name(), file_name);
+#endif
+}
+
+void
+ExeTracer::closeBinaryTrace()
+{
+#if HAVE_PROTOBUF
+    delete binaryStream;
+#endif
+    binaryStream = NULL;
+}
+
+/** Read the value of a unified index register, returning false for
+ *  registers which have no value to trace */
+static bool
+readTracedReg(ThreadContext *tc, RegIndex reg, uint64_t &value)
+{
+    RegIndex rel_reg;
+
+    if (reg >= TheISA::Max_Reg_Index)
+        return false;
+
+    switch (regIdxToClass(reg, &rel_reg)) {
+      case IntRegClass:
+        value = tc->readIntReg(rel_reg);
+        return true;
+      case FloatRegClass:
+        value = tc->readFloatRegBits(rel_reg);
+        return true;
+      case CCRegClass:
+        value = tc->readCCReg(rel_reg);
+        return true;
+      default:
+        return false;
+    }
+}
+
+void
+ExeBinaryTracerRecord::dump()
+{
+#if HAVE_PROTOBUF
+    if (!ExeTracer::binaryStream)
+        return;
+
+    ProtoMessage::ExecInst msg;
+
+    if (ExeTracer::numBinaryRecords % ExeTracer::keyframeInterval == 0) {
+        msg.set_keyframe(true);
+        ExeTracer::lastPc = 0;
+        ExeTracer::lastTick = 0;
+        ExeTracer::lastSeqNum = 0;
+        ExeTracer::lastMemAddr = 0;
+    }
+    ExeTracer::numBinaryRecords++;
+
+    Addr inst_addr = pc.instAddr();
+    msg.set_pc(static_cast<int64_t>(inst_addr - ExeTracer::lastPc));
+    ExeTracer::lastPc = inst_addr;
+
+    if (staticInst->isMicroop())
+        msg.set_upc(pc.microPC());
+    msg.set_inst(static_cast<uint32_t>(bits(staticInst->machInst, 31, 0)));
+    msg.set_cpuid(thread->cpuId());
+
+    msg.set_tick(static_cast<int64_t>(when - ExeTracer::lastTick));
+    ExeTracer::lastTick = when;
+
+    if (fetch_seq_valid) {
+        msg.set_seq_num(static_cast<int64_t>(fetch_seq -
+            ExeTracer::lastSeqNum));
+        ExeTracer::lastSeqNum = fetch_seq;
+    }
+
+    msg.set_op_class(staticInst->opClass());
+    if (!predicate)
+        msg.set_predicate_false(true);
+
+    // Values are read once the instruction has committed, so sources
+    // the instruction overwrote are left for the reader to recover from
+    // the earlier records
+    int num_dests = staticInst->numDestRegs();
+
+    for (int i = 0; i < staticInst->numSrcRegs(); i++) {
+        RegIndex reg = staticInst->srcRegIdx(i);
+        ProtoMessage::ExecReg *src = msg.add_src();
+        bool overwritten = false;
+        uint64_t value;
+
+        src->set_reg(reg);
+        for (int j = 0; j < num_dests && !overwritten; j++)
+            overwritten = staticInst->destRegIdx(j) == reg;
+        if (!overwritten && readTracedReg(thread, reg, value))
+            src->set_value(value);
+    }
+
+    for (int i = 0; i < num_dests; i++) {
+        RegIndex reg = staticInst->destRegIdx(i);
+        ProtoMessage::ExecReg *dest = msg.add_dest();
+        uint64_t value;
+
+        dest->set_reg(reg);
+        if (readTracedReg(thread, reg, value))
+            dest->set_value(value);
+    }
+
+    if (mem_valid) {
+        msg.set_mem_addr(static_cast<int64_t>(addr -
+            ExeTracer::lastMemAddr));
+        msg.set_mem_size(size);
+        msg.set_mem_flags(flags);
+        ExeTracer::lastMemAddr = addr;
+    }
+
+    if (data_status != DataInvalid)
+        msg.set_data(data.as_int);
+
+    ExeTracer::binaryStream->write(msg);
+#endif
+}
+
 } // namespace Trace
 
 ////////////////////////////////////////////////////////////////////////
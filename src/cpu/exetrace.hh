@@ -40,10 +40,13 @@
 #include "params/ExeTracer.hh"
 #include "sim/insttracer.hh"
 
+class ProtoOutputStream;
 class ThreadContext;
 
 namespace Trace {
 
+class ExeTracer;
+
 class ExeTracerRecord : public InstRecord
 {
   public:
@@ -61,27 +64,82 @@ class ExeTracerRecord : public InstRecord
 
 };
 
+/**
+ * A record that writes every committed instruction and micro-op to the
+ * ExeTracer's binary trace (proto/exec.proto) rather than formatting it
+ * as text.
+ */
+class ExeBinaryTracerRecord : public ExeTracerRecord
+{
+  public:
+    ExeBinaryTracerRecord(ExeTracer &_tracer, Tick _when,
+               ThreadContext *_thread, const StaticInstPtr _staticInst,
+               TheISA::PCState _pc,
+               const StaticInstPtr _macroStaticInst = NULL)
+        : ExeTracerRecord(_when, _thread, _staticInst, _pc,
+            _macroStaticInst), tracer(_tracer)
+    {
+    }
+
+    void dump() M5_ATTR_OVERRIDE;
+
+  protected:
+    ExeTracer &tracer;
+};
+
 class ExeTracer : public InstTracer
 {
   public:
     typedef ExeTracerParams Params;
-    ExeTracer(const Params *params) : InstTracer(params)
-    {}
+    ExeTracer(const Params *params);
 
     InstRecord *
     getInstRecord(Tick when, ThreadContext *tc,
             const StaticInstPtr staticInst, TheISA::PCState pc,
             const StaticInstPtr macroStaticInst = NULL)
     {
-        if (!Debug::ExecEnable)
+        if (!Trace::enabled)
             return NULL;
 
-        if (!Trace::enabled)
+        /* The binary trace doesn't need ExecEnable as it has no text
+         *  options to pick from */
+        if (binaryStream) {
+            return new ExeBinaryTracerRecord(*this, when, tc,
+                staticInst, pc, macroStaticInst);
+        }
+
+        if (!Debug::ExecEnable)
             return NULL;
 
         return new ExeTracerRecord(when, tc,
                 staticInst, pc, macroStaticInst);
     }
+
+  protected:
+    /** One binary trace for all the tracers in the simulation, each
+     *  record carries its CPU ID.  NULL if binary tracing is off */
+    static ProtoOutputStream *binaryStream;
+
+    /** Records written so far, for placing keyframes */
+    static uint64_t numBinaryRecords;
+
+    /** Records between keyframes */
+    static unsigned int keyframeInterval;
+
+    /** The last absolute values of the delta encoded fields */
+    static Addr lastPc;
+    static Tick lastTick;
+    static InstSeqNum lastSeqNum;
+    static Addr lastMemAddr;
+
+    /** Create the binary trace and write its header */
+    void createBinaryTrace(const std::string &file_name,
+        unsigned int keyframe_interval);
+
+    /** Close the binary trace at exit */
+    void closeBinaryTrace();
+
+    friend class ExeBinaryTracerRecord;
 };
 
 } // namespace Trace
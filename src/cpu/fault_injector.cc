@@ -0,0 +1,332 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/registers.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "cpu/fault_injector.hh"
+#include "cpu/mem_fault_sites.hh"
+#include "cpu/thread_context.hh"
+#include "debug/FaultInjector.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/cache/base.hh"
+#include "sim/sim_exit.hh"
+#include "sim/trace_window.hh"
+
+unsigned int
+RegFileFaultSite::numEntries() const
+{
+    switch (regFile) {
+      case IntRegs:
+        return TheISA::NumIntRegs;
+      case FloatRegs:
+        return TheISA::NumFloatRegs;
+      case CCRegs:
+        return TheISA::NumCCRegs;
+    }
+
+    return 0;
+}
+
+unsigned int
+RegFileFaultSite::entryBits() const
+{
+    switch (regFile) {
+      case IntRegs:
+        return sizeof(TheISA::IntReg) * 8;
+      case FloatRegs:
+        return sizeof(TheISA::FloatRegBits) * 8;
+      case CCRegs:
+        return sizeof(TheISA::CCReg) * 8;
+    }
+
+    return 0;
+}
+
+void
+RegFileFaultSite::flipBit(unsigned int index, unsigned int bit,
+    unsigned int fault)
+{
+    switch (regFile) {
+      case IntRegs:
+        thread->setIntReg(index,
+            thread->readIntReg(index) ^ (TheISA::IntReg(1) << bit));
+        break;
+      case FloatRegs:
+        thread->setFloatRegBits(index,
+            thread->readFloatRegBits(index) ^
+            (TheISA::FloatRegBits(1) << bit));
+        break;
+      case CCRegs:
+        thread->setCCReg(index,
+            thread->readCCReg(index) ^ (TheISA::CCReg(1) << bit));
+        break;
+    }
+}
+
+FaultInjector::FaultInjector(const FaultInjectorParams *p) :
+    SimObject(p),
+    rng(p->seed, p->run_id),
+    structure(p->structure),
+    site(NULL),
+    armedSeqNum(false),
+    tracker(NULL),
+    memorySites(p->memory_sites),
+    outcomesFile(p->outcomes_file),
+    injectEvent(this),
+    reportCallback(this),
+    reporting(false)
+{
+    if (structure == "")
+        return;
+
+    if (p->trigger_seq_num == 0 && p->trigger_tick == 0)
+        fatal("%s: fault target %s has no trigger\n", name(), structure);
+
+    if (p->batch_size == 0 || p->batch_size > 64)
+        fatal("%s: batch_size must be between 1 and 64\n", name());
+
+    if (p->batch_size > 1 && p->batch_spacing == 0)
+        fatal("%s: batched faults need a batch_spacing\n", name());
+
+    for (unsigned int fault = 0; fault < p->batch_size; fault++) {
+        FaultTarget target;
+
+        target.index = p->index;
+        target.bit = p->bit;
+        target.seqNum = (p->trigger_seq_num == 0 ? 0 :
+            p->trigger_seq_num + fault * p->batch_spacing);
+        target.tick = (p->trigger_tick == 0 ? 0 :
+            p->trigger_tick + fault * p->batch_spacing);
+        targets.push_back(target);
+    }
+
+    registerExitCallback(&reportCallback);
+    reporting = true;
+}
+
+FaultInjector::~FaultInjector()
+{
+    for (SiteMap::iterator i = sites.begin(); i != sites.end(); ++i)
+        delete i->second;
+}
+
+void
+FaultInjector::registerSite(const std::string &site_name, FaultSite *site)
+{
+    if (sites.find(site_name) != sites.end())
+        fatal("%s: fault site %s registered twice\n", name(), site_name);
+
+    DPRINTF(FaultInjector, "Registered fault site %s: %d x %d bits\n",
+        site_name, site->numEntries(), site->entryBits());
+
+    sites[site_name] = site;
+}
+
+void
+FaultInjector::init()
+{
+    for (unsigned int i = 0; i < memorySites.size(); i++) {
+        MemObject *obj = memorySites[i];
+
+        if (BaseCache *cache = dynamic_cast<BaseCache *>(obj)) {
+            registerSite(cache->name() + ".data",
+                new CacheDataFaultSite(cache));
+            registerSite(cache->name() + ".tags",
+                new CacheTagFaultSite(cache));
+        } else if (AbstractMemory *mem = dynamic_cast<AbstractMemory *>(obj)) {
+            registerSite(mem->name() + ".array", new MemoryFaultSite(mem));
+        } else {
+            fatal("%s: %s is neither a cache nor a memory\n", name(),
+                obj->name());
+        }
+    }
+}
+
+void
+FaultInjector::startup()
+{
+    if (targets.empty())
+        return;
+
+    resolveSite();
+    armNext();
+}
+
+void
+FaultInjector::resolveSite()
+{
+    SiteMap::iterator found = sites.find(structure);
+    if (found == sites.end())
+        fatal("%s: no fault site named %s\n", name(), structure);
+    site = found->second;
+
+    const FaultTarget &target = targets.front();
+    if (target.index >= int(site->numEntries()) ||
+        target.bit >= int(site->entryBits()))
+    {
+        fatal("%s: fault target %s[%d] bit %d out of range\n", name(),
+            structure, target.index, target.bit);
+    }
+}
+
+void
+FaultInjector::retarget(const std::string &structure_, int index, int bit,
+    uint64_t trigger_seq_num)
+{
+    if (!injections.empty())
+        fatal("%s: can't retarget after injecting a fault\n", name());
+
+    if (trigger_seq_num == 0)
+        fatal("%s: fault target %s has no trigger\n", name(), structure_);
+
+    DPRINTF(FaultInjector, "Retargeting to %s[%d] bit %d at seqnum %d\n",
+        structure_, index, bit, trigger_seq_num);
+
+    if (injectEvent.scheduled())
+        deschedule(injectEvent);
+
+    FaultTarget target;
+    target.index = index;
+    target.bit = bit;
+    target.seqNum = trigger_seq_num;
+    target.tick = 0;
+
+    structure = structure_;
+    targets.assign(1, target);
+    resolveSite();
+
+    if (!reporting) {
+        registerExitCallback(&reportCallback);
+        reporting = true;
+    }
+
+    armNext();
+}
+
+void
+FaultInjector::armNext()
+{
+    armedSeqNum = false;
+
+    /* Skip tick targets which are already in the past (after a
+     *  checkpoint restore, for instance) */
+    while (injections.size() < targets.size()) {
+        const FaultTarget &target = targets[injections.size()];
+
+        if (target.tick == 0) {
+            armedSeqNum = true;
+            return;
+        } else if (target.tick >= curTick()) {
+            if (target.seqNum != 0)
+                armedSeqNum = true;
+            schedule(injectEvent, target.tick);
+            return;
+        }
+
+        warn("%s: fault tick %d is in the past, not injecting\n",
+            name(), target.tick);
+        targets.erase(targets.begin() + injections.size());
+    }
+}
+
+void
+FaultInjector::inject(InstSeqNum seq_num)
+{
+    if (injections.size() >= targets.size())
+        return;
+
+    const FaultTarget &target = targets[injections.size()];
+    unsigned int fault = injections.size();
+
+    /* Try not to land a batched fault on an entry which already carries
+     *  another, that would make their outcomes indistinguishable */
+    unsigned int index = target.index;
+    if (target.index < 0) {
+        index = random(site->numEntries());
+        for (unsigned int retry = 0;
+            retry < site->numEntries() && site->isFaulty(index); retry++)
+        {
+            index = random(site->numEntries());
+        }
+    }
+    unsigned int bit = (target.bit < 0 ?
+        random(site->entryBits()) : target.bit);
+
+    Trace::windowFault();
+
+    DPRINTF(FaultInjector, "Injecting fault %d in %s[%d] bit %d\n",
+        fault, structure, index, bit);
+
+    site->flipBit(index, bit, fault);
+
+    Injection injection;
+    injection.tick = curTick();
+    injection.seqNum = seq_num;
+    injection.index = index;
+    injection.bit = bit;
+    injections.push_back(injection);
+
+    if (injectEvent.scheduled())
+        deschedule(injectEvent);
+    armNext();
+}
+
+void
+FaultInjector::reportOutcomes()
+{
+    if (targets.empty() || outcomesFile.empty())
+        return;
+
+    FaultTracker *outcomes = (site && site->tracker() ? site->tracker() :
+        tracker);
+
+    std::ostream *os = simout.create(outcomesFile);
+
+    *os << "# fault tick seqnum structure index bit outcome\n";
+    for (unsigned int fault = 0; fault < targets.size(); fault++) {
+        if (fault < injections.size()) {
+            const Injection &injection = injections[fault];
+
+            *os << fault << ' ' << injection.tick << ' ' <<
+                injection.seqNum << ' ' << structure << ' ' <<
+                injection.index << ' ' << injection.bit << ' ' <<
+                (outcomes ? outcomes->outcome(fault) : "unknown") << '\n';
+        } else {
+            *os << fault << " - - " << structure <<
+                " - - not_injected\n";
+        }
+    }
+
+    simout.close(os);
+}
+
+FaultInjector *
+FaultInjectorParams::create()
+{
+    return new FaultInjector(this);
+}
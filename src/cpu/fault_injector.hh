@@ -0,0 +1,260 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  A fault injector which owns the fault targets and all random choices
+ *  made when injecting, and corrupts structures registered with it by
+ *  the CPU models.
+ */
+
+#ifndef __CPU_FAULT_INJECTOR_HH__
+#define __CPU_FAULT_INJECTOR_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/philox.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "params/FaultInjector.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+class FaultTracker;
+class MemObject;
+
+/**
+ * A structure faults can be injected into: an array of numEntries()
+ * entries of entryBits() bits each.  CPU models register their structures
+ * (register files, ROB, IQ, rename map, ...) with a FaultInjector, which
+ * calls flipBit when a target triggers, so new structures never need
+ * changes in the operand access paths.
+ */
+class FaultSite
+{
+  public:
+    virtual ~FaultSite() { }
+
+    virtual unsigned int numEntries() const = 0;
+    virtual unsigned int entryBits() const = 0;
+
+    /** Invert one bit of one entry.  fault is the number of the fault
+     *  within its batch for sites which track propagation */
+    virtual void flipBit(unsigned int index, unsigned int bit,
+        unsigned int fault) = 0;
+
+    /** Does the entry already carry an injected fault?  Random entry
+     *  choices for batched faults avoid such entries */
+    virtual bool isFaulty(unsigned int index) const { return false; }
+
+    /** Decider of the outcomes of faults in this site, NULL for the
+     *  injector's (the CPU's) tracker */
+    virtual FaultTracker *tracker() { return NULL; }
+};
+
+/** Follows injected faults to decide their outcomes */
+class FaultTracker
+{
+  public:
+    virtual ~FaultTracker() { }
+
+    /** Short outcome (e.g. "masked") of the numbered fault */
+    virtual std::string outcome(unsigned int fault) const = 0;
+};
+
+class ThreadContext;
+
+/** One of the architectural register files of a thread */
+class RegFileFaultSite : public FaultSite
+{
+  public:
+    enum RegFile
+    {
+        IntRegs,
+        FloatRegs,
+        CCRegs
+    };
+
+  protected:
+    ThreadContext *thread;
+    RegFile regFile;
+
+  public:
+    RegFileFaultSite(ThreadContext *thread_, RegFile reg_file) :
+        thread(thread_), regFile(reg_file)
+    { }
+
+    unsigned int numEntries() const;
+    unsigned int entryBits() const;
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+};
+
+/** Compact description of a fault to inject */
+struct FaultTarget
+{
+    /** Entry and bit to flip, negative for a random choice */
+    int index;
+    int bit;
+
+    /** Triggers, 0 when unused */
+    InstSeqNum seqNum;
+    Tick tick;
+};
+
+/**
+ * Source of the fault targets and of every random choice made when
+ * injecting a fault.  Choices come from a counter-based generator keyed
+ * by a campaign seed and a run ID so every injection can be reproduced
+ * from those two numbers and runs with different IDs never share a
+ * stream, however many run in parallel.
+ *
+ * A run can inject a batch of faults into the same structure, each
+ * triggered batch_spacing seqnums or ticks after the last, to amortise
+ * simulator startup over many statistically independent faults.  The
+ * outcome of each is taken from the site's FaultTracker, or else the
+ * CPU's, and written to outcomes_file (fault_outcomes.txt) in the output
+ * directory when simulation ends.
+ *
+ * The common no-fault case costs CPU models a single test of armed()
+ * per committed instruction.
+ */
+class FaultInjector : public SimObject
+{
+  protected:
+    typedef std::map<std::string, FaultSite *> SiteMap;
+
+    /** A fault as actually injected */
+    struct Injection
+    {
+        Tick tick;
+        InstSeqNum seqNum;
+        unsigned int index;
+        unsigned int bit;
+    };
+
+    Philox rng;
+
+    /** Registered structures, by name */
+    SiteMap sites;
+
+    /** Structure name of the targets, resolved into site */
+    std::string structure;
+    FaultSite *site;
+
+    /** The batch of targets in trigger order */
+    std::vector<FaultTarget> targets;
+
+    /** Faults injected so far, the next one to inject is
+     *  targets[injections.size()] */
+    std::vector<Injection> injections;
+
+    /** True while a seqnum trigger is pending */
+    bool armedSeqNum;
+
+    FaultTracker *tracker;
+
+    /** Caches and memories to register the arrays of in init() */
+    const std::vector<MemObject *> memorySites;
+
+    /** Inject the next fault of the batch, seq_num is the seqnum of the
+     *  committing instruction for seqnum triggers */
+    void inject(InstSeqNum seq_num = 0);
+
+    /** Inject on a tick trigger */
+    void injectOnTick() { inject(); }
+
+    /** Set up the trigger of the next fault */
+    void armNext();
+
+    /** Find the site of structure and check the first target fits it */
+    void resolveSite();
+
+    /** File to write the outcomes to, empty for none */
+    const std::string outcomesFile;
+
+    /** Write the outcomes of the batch to outcomesFile */
+    void reportOutcomes();
+
+    EventWrapper<FaultInjector, &FaultInjector::injectOnTick> injectEvent;
+
+    MakeCallback<FaultInjector, &FaultInjector::reportOutcomes>
+        reportCallback;
+
+    /** Has reportCallback been registered? */
+    bool reporting;
+
+  public:
+    FaultInjector(const FaultInjectorParams *p);
+    ~FaultInjector();
+
+    void init();
+    void startup();
+
+    /** Make a structure available as a fault target.  The injector
+     *  takes ownership of site */
+    void registerSite(const std::string &site_name, FaultSite *site);
+
+    /** Set the object which decides fault outcomes */
+    void setTracker(FaultTracker *tracker_) { tracker = tracker_; }
+
+    /** Fast path test: is a seqnum trigger pending? */
+    bool armed() const { return armedSeqNum; }
+
+    /** Tell an armed injector that the instruction with execute
+     *  sequence number seq_num has committed */
+    void
+    commit(InstSeqNum seq_num)
+    {
+        if (seq_num >= targets[injections.size()].seqNum)
+            inject(seq_num);
+    }
+
+    /** Faults in a batch */
+    unsigned int batchSize() const { return targets.size(); }
+
+    /** Faults injected so far */
+    unsigned int numInjected() const { return injections.size(); }
+
+    /** Restart the choice stream for a new run */
+    void reseed(uint64_t seed, uint64_t run_id) { rng.seed(seed, run_id); }
+
+    /** Replace the targets of an injector which has not injected yet by
+     *  a single fault in structure, triggered when the instruction with
+     *  execute seqnum trigger_seq_num commits.  Used by campaign runs
+     *  forked off a warmed-up simulation */
+    void retarget(const std::string &structure, int index, int bit,
+        uint64_t trigger_seq_num);
+
+    /** A choice in [0, bound) */
+    unsigned int random(unsigned int bound) { return rng.random(bound); }
+};
+
+#endif // __CPU_FAULT_INJECTOR_HH__
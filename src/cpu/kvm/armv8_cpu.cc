@@ -0,0 +1,458 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <linux/kvm.h>
+
+#include <cerrno>
+#include <memory>
+
+#include "arch/arm/system.hh"
+#include "arch/arm/utility.hh"
+#include "arch/registers.hh"
+#include "cpu/kvm/armv8_cpu.hh"
+#include "cpu/kvm/base.hh"
+#include "debug/Kvm.hh"
+#include "debug/KvmContext.hh"
+#include "debug/KvmInt.hh"
+#include "sim/pseudo_inst.hh"
+
+using namespace ArmISA;
+
+// Unlike gem5, KVM doesn't count the SP as a normal integer register,
+// which means that we only have 31 X registers.
+static const unsigned NUM_XREGS = 31;
+
+// KVM accesses the vector registers as 128-bit quantities, gem5 as
+// groups of four 32-bit float registers.
+static const unsigned NUM_QREGS = NumFloatV8ArchRegs / 4;
+static const unsigned FP_REGS_PER_QREG = 4;
+
+#define EXTRACT_FIELD(val, name)                        \
+    (((val) & name ## _MASK) >> name ## _SHIFT)
+
+#define CORE_REG(name, size) (                          \
+        KVM_REG_ARM64 | KVM_REG_ARM_CORE |              \
+        KVM_REG_SIZE_ ## size |                         \
+        KVM_REG_ARM_CORE_REG(name))
+
+#define REG_SIZE_IS_U32(id)                             \
+    (((id) & KVM_REG_SIZE_MASK) == KVM_REG_SIZE_U32)
+
+#define INT_REG(name) CORE_REG(name, U64)
+#define SIMD_REG(name) CORE_REG(name, U128)
+
+#define SYS_REG(op0, op1, crn, crm, op2) (                              \
+        KVM_REG_ARM64 | KVM_REG_SIZE_U64 | KVM_REG_ARM64_SYSREG |       \
+        ((uint64_t)(op0) << KVM_REG_ARM64_SYSREG_OP0_SHIFT) |           \
+        ((uint64_t)(op1) << KVM_REG_ARM64_SYSREG_OP1_SHIFT) |           \
+        ((uint64_t)(crn) << KVM_REG_ARM64_SYSREG_CRN_SHIFT) |           \
+        ((uint64_t)(crm) << KVM_REG_ARM64_SYSREG_CRM_SHIFT) |           \
+        ((uint64_t)(op2) << KVM_REG_ARM64_SYSREG_OP2_SHIFT))
+
+#define INTERRUPT_ID(type, vcpu, irq) (                    \
+        ((type) << KVM_ARM_IRQ_TYPE_SHIFT) |               \
+        ((vcpu) << KVM_ARM_IRQ_VCPU_SHIFT) |               \
+        ((irq) << KVM_ARM_IRQ_NUM_SHIFT))
+
+#define INTERRUPT_VCPU_IRQ(vcpu)                                \
+    INTERRUPT_ID(KVM_ARM_IRQ_TYPE_CPU, vcpu, KVM_ARM_IRQ_CPU_IRQ)
+
+#define INTERRUPT_VCPU_FIQ(vcpu)                                \
+    INTERRUPT_ID(KVM_ARM_IRQ_TYPE_CPU, vcpu, KVM_ARM_IRQ_CPU_FIQ)
+
+static uint64_t
+kvmXReg(int num)
+{
+    return INT_REG(regs.regs[0]) +
+        (INT_REG(regs.regs[1]) - INT_REG(regs.regs[0])) * num;
+}
+
+static uint64_t
+kvmFPReg(int num)
+{
+    return SIMD_REG(fp_regs.vregs[0]) +
+        (SIMD_REG(fp_regs.vregs[1]) - SIMD_REG(fp_regs.vregs[0])) * num;
+}
+
+union KvmFPReg {
+    uint32_t s[FP_REGS_PER_QREG];
+    uint64_t d[FP_REGS_PER_QREG / 2];
+    uint8_t data[16];
+};
+
+const std::vector<ArmV8KvmCPU::IntRegInfo> ArmV8KvmCPU::intRegMap = {
+    { INT_REG(regs.sp), INTREG_SP0, "SP(EL0)" },
+    { INT_REG(sp_el1), INTREG_SP1, "SP(EL1)" },
+};
+
+const std::vector<ArmV8KvmCPU::MiscRegInfo> ArmV8KvmCPU::miscRegMap = {
+    { INT_REG(elr_el1), MISCREG_ELR_EL1, "ELR(EL1)" },
+    { INT_REG(spsr[KVM_SPSR_EL1]), MISCREG_SPSR_EL1, "SPSR(EL1)" },
+    { INT_REG(spsr[KVM_SPSR_ABT]), MISCREG_SPSR_ABT, "SPSR(ABT)" },
+    { INT_REG(spsr[KVM_SPSR_UND]), MISCREG_SPSR_UND, "SPSR(UND)" },
+    { INT_REG(spsr[KVM_SPSR_IRQ]), MISCREG_SPSR_IRQ, "SPSR(IRQ)" },
+    { INT_REG(spsr[KVM_SPSR_FIQ]), MISCREG_SPSR_FIQ, "SPSR(FIQ)" },
+    { CORE_REG(fp_regs.fpsr, U32), MISCREG_FPSR, "FPSR" },
+    { CORE_REG(fp_regs.fpcr, U32), MISCREG_FPCR, "FPCR" },
+};
+
+const std::vector<ArmV8KvmCPU::MiscRegInfo> ArmV8KvmCPU::miscRegIdMap = {
+    { SYS_REG(3, 0, 0, 0, 5), MISCREG_MPIDR_EL1, "MPIDR(EL1)" },
+};
+
+const std::set<MiscRegIndex> ArmV8KvmCPU::deviceRegSet = {
+    MISCREG_CNTV_CTL_EL0,
+    MISCREG_CNTV_CVAL_EL0,
+    MISCREG_CNTKCTL_EL1,
+};
+
+ArmV8KvmCPU::ArmV8KvmCPU(ArmV8KvmCPUParams *params)
+    : BaseKvmCPU(params),
+      irqAsserted(false), fiqAsserted(false)
+{
+}
+
+ArmV8KvmCPU::~ArmV8KvmCPU()
+{
+}
+
+void
+ArmV8KvmCPU::startup()
+{
+    BaseKvmCPU::startup();
+
+    /* TODO: This needs to be moved when we start to support VMs with
+     * multiple threads since kvmArmVCpuInit requires that all CPUs in
+     * the VM have been created.
+     */
+    struct kvm_vcpu_init target_config;
+    memset(&target_config, 0, sizeof(target_config));
+
+    vm.kvmArmPreferredTarget(target_config);
+    if (!ArmSystem::highestELIs64(tc))
+        target_config.features[0] |= (1 << KVM_ARM_VCPU_EL1_32BIT);
+    kvmArmVCpuInit(target_config);
+
+    // Make the guest see the same MPIDR as gem5 would have reported
+    // to keep the CPU numbering consistent when switching CPU models.
+    for (const auto &ri : miscRegIdMap) {
+        const uint64_t value(tc->readMiscReg(ri.idx));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        setOneReg(ri.kvm, value);
+    }
+}
+
+Tick
+ArmV8KvmCPU::kvmRun(Tick ticks)
+{
+    bool simFIQ(interrupts->checkRaw(INT_FIQ));
+    bool simIRQ(interrupts->checkRaw(INT_IRQ));
+
+    if (fiqAsserted != simFIQ) {
+        fiqAsserted = simFIQ;
+        DPRINTF(KvmInt, "KVM: Update FIQ state: %i\n", simFIQ);
+        vm.setIRQLine(INTERRUPT_VCPU_FIQ(vcpuID), simFIQ);
+    }
+    if (irqAsserted != simIRQ) {
+        irqAsserted = simIRQ;
+        DPRINTF(KvmInt, "KVM: Update IRQ state: %i\n", simIRQ);
+        vm.setIRQLine(INTERRUPT_VCPU_IRQ(vcpuID), simIRQ);
+    }
+
+    return BaseKvmCPU::kvmRun(ticks);
+}
+
+void
+ArmV8KvmCPU::dump()
+{
+    inform("Integer registers:\n");
+    inform("  PC: %s\n", getAndFormatOneReg(INT_REG(regs.pc)));
+    inform("  PSTATE: %s\n", getAndFormatOneReg(INT_REG(regs.pstate)));
+    for (int i = 0; i < NUM_XREGS; ++i)
+        inform("  X%i: %s\n", i, getAndFormatOneReg(kvmXReg(i)));
+
+    for (const auto &ri : intRegMap)
+        inform("  %s: %s\n", ri.name, getAndFormatOneReg(ri.kvm));
+
+    inform("Vector registers:\n");
+    for (int i = 0; i < NUM_QREGS; ++i)
+        inform("  Q%i: %s\n", i, getAndFormatOneReg(kvmFPReg(i)));
+
+    inform("Misc registers:\n");
+    for (const auto &ri : miscRegMap)
+        inform("  %s: %s\n", ri.name, getAndFormatOneReg(ri.kvm));
+
+    inform("System registers:\n");
+    for (const auto &ri : getSysRegMap())
+        inform("  %s: %s\n", ri.name, getAndFormatOneReg(ri.kvm));
+}
+
+void
+ArmV8KvmCPU::updateKvmState()
+{
+    DPRINTF(KvmContext, "Updating KVM state...\n");
+
+    // The condition flags live in separate CC registers in gem5, fold
+    // them back into PSTATE before handing the state to KVM.
+    CPSR cpsr(tc->readMiscReg(MISCREG_CPSR));
+    cpsr.nz = tc->readCCReg(CCREG_NZ);
+    cpsr.c = tc->readCCReg(CCREG_C);
+    cpsr.v = tc->readCCReg(CCREG_V);
+    if (cpsr.width)
+        cpsr.ge = tc->readCCReg(CCREG_GE);
+    else
+        cpsr.ge = 0;
+    DPRINTF(KvmContext, "  PSTATE := 0x%x\n", (uint64_t)cpsr);
+    setOneReg(INT_REG(regs.pstate), static_cast<uint64_t>(cpsr));
+
+    for (const auto &ri : miscRegMap) {
+        const uint64_t value(tc->readMiscReg(ri.idx));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        if (REG_SIZE_IS_U32(ri.kvm))
+            setOneReg(ri.kvm, static_cast<uint32_t>(value));
+        else
+            setOneReg(ri.kvm, value);
+    }
+
+    // KVM always uses the 64-bit register layout. An AArch32 guest
+    // sees the banked registers through the X register mapping.
+    const bool aarch64(inAArch64(tc));
+    for (int i = 0; i < NUM_XREGS; ++i) {
+        const uint64_t value(aarch64 ?
+                             tc->readIntReg(INTREG_X0 + i) :
+                             tc->readIntRegFlat(IntReg64Map[INTREG_X0 + i]));
+        DPRINTF(KvmContext, "  X%i := 0x%x\n", i, value);
+        setOneReg(kvmXReg(i), value);
+    }
+
+    for (const auto &ri : intRegMap) {
+        const uint64_t value(tc->readIntRegFlat(ri.idx));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        setOneReg(ri.kvm, value);
+    }
+
+    for (int i = 0; i < NUM_QREGS; ++i) {
+        const int reg_base(i * FP_REGS_PER_QREG);
+        KvmFPReg reg;
+        for (int j = 0; j < FP_REGS_PER_QREG; ++j)
+            reg.s[j] = tc->readFloatRegBitsFlat(reg_base + j);
+
+        setOneReg(kvmFPReg(i), reg.data);
+        DPRINTF(KvmContext, "  Q%i := 0x%016x%016x\n", i,
+                reg.d[1], reg.d[0]);
+    }
+
+    for (const auto &ri : getSysRegMap()) {
+        const uint64_t value(tc->readMiscReg(ri.idx));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        setOneReg(ri.kvm, value);
+    }
+
+    setOneReg(INT_REG(regs.pc), (uint64_t)tc->instAddr());
+    DPRINTF(KvmContext, "  PC := 0x%x\n", tc->instAddr());
+}
+
+void
+ArmV8KvmCPU::updateThreadContext()
+{
+    DPRINTF(KvmContext, "Updating gem5 state...\n");
+
+    const CPSR cpsr(getOneRegU64(INT_REG(regs.pstate)));
+    DPRINTF(KvmContext, "  PSTATE := 0x%x\n", (uint64_t)cpsr);
+    tc->setMiscRegNoEffect(MISCREG_CPSR, cpsr);
+    tc->setCCReg(CCREG_NZ, cpsr.nz);
+    tc->setCCReg(CCREG_C, cpsr.c);
+    tc->setCCReg(CCREG_V, cpsr.v);
+    if (cpsr.width)
+        tc->setCCReg(CCREG_GE, cpsr.ge);
+
+    // Update the core misc registers first since they affect how the
+    // other registers are mapped.
+    for (const auto &ri : miscRegMap) {
+        const uint64_t value(REG_SIZE_IS_U32(ri.kvm) ?
+                             getOneRegU32(ri.kvm) : getOneRegU64(ri.kvm));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        tc->setMiscRegNoEffect(ri.idx, value);
+    }
+
+    const bool aarch64(inAArch64(tc));
+    for (int i = 0; i < NUM_XREGS; ++i) {
+        const uint64_t value(getOneRegU64(kvmXReg(i)));
+        DPRINTF(KvmContext, "  X%i := 0x%x\n", i, value);
+        if (aarch64)
+            tc->setIntReg(INTREG_X0 + i, value);
+        else
+            tc->setIntRegFlat(IntReg64Map[INTREG_X0 + i], value);
+    }
+
+    for (const auto &ri : intRegMap) {
+        const uint64_t value(getOneRegU64(ri.kvm));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        tc->setIntRegFlat(ri.idx, value);
+    }
+
+    for (int i = 0; i < NUM_QREGS; ++i) {
+        const int reg_base(i * FP_REGS_PER_QREG);
+        KvmFPReg reg;
+        getOneReg(kvmFPReg(i), reg.data);
+        DPRINTF(KvmContext, "  Q%i := 0x%016x%016x\n", i,
+                reg.d[1], reg.d[0]);
+        for (int j = 0; j < FP_REGS_PER_QREG; ++j)
+            tc->setFloatRegBitsFlat(reg_base + j, reg.s[j]);
+    }
+
+    for (const auto &ri : getSysRegMap()) {
+        const uint64_t value(getOneRegU64(ri.kvm));
+        DPRINTF(KvmContext, "  %s := 0x%x\n", ri.name, value);
+        // Device backed registers (e.g., the virtual timer) need the
+        // side effects to reprogram the device model.
+        if (ri.is_device)
+            tc->setMiscReg(ri.idx, value);
+        else
+            tc->setMiscRegNoEffect(ri.idx, value);
+    }
+
+    // We update the PC state last since PSTATE determines how the
+    // next PC is computed.
+    PCState pc(getOneRegU64(INT_REG(regs.pc)));
+    pc.aarch64(aarch64);
+    pc.nextAArch64(aarch64);
+    pc.thumb(cpsr.t);
+    pc.nextThumb(cpsr.t);
+    DPRINTF(KvmContext, "  PC := 0x%x (t: %i, a64: %i)\n",
+            pc.instAddr(), pc.thumb(), pc.aarch64());
+    tc->pcState(pc);
+}
+
+Tick
+ArmV8KvmCPU::onKvmExitHypercall()
+{
+    // Use the same convention as the 32-bit CPU, but with the
+    // function number in IP0 (X16) instead of IP (R12).
+    const uint64_t reg_ip(getOneRegU64(kvmXReg(16)));
+    const uint8_t func((reg_ip >> 8) & 0xFF);
+    const uint8_t subfunc(reg_ip & 0xFF);
+
+    DPRINTF(Kvm, "KVM Hypercall: 0x%x/0x%x\n", func, subfunc);
+    const uint64_t ret(PseudoInst::pseudoInst(getContext(0), func, subfunc));
+
+    // Just set the return value using the KVM API instead of messing
+    // with the context, see ArmKvmCPU::onKvmExitHypercall().
+    setOneReg(kvmXReg(0), ret);
+
+    return 0;
+}
+
+const ArmV8KvmCPU::RegIndexVector &
+ArmV8KvmCPU::getRegList() const
+{
+    if (_regIndexList.size() == 0) {
+        std::unique_ptr<struct kvm_reg_list> regs;
+        uint64_t i(1);
+
+        do {
+            i <<= 1;
+            regs.reset((struct kvm_reg_list *)
+                       operator new(sizeof(struct kvm_reg_list) +
+                                    i * sizeof(uint64_t)));
+            regs->n = i;
+        } while (!getRegList(*regs));
+        _regIndexList.assign(regs->reg,
+                             regs->reg + regs->n);
+    }
+
+    return _regIndexList;
+}
+
+const std::vector<ArmV8KvmCPU::MiscRegInfo> &
+ArmV8KvmCPU::getSysRegMap() const
+{
+    // Try to use the cached map
+    if (!sysRegMap.empty())
+        return sysRegMap;
+
+    for (const auto &reg : getRegList()) {
+        if ((reg & KVM_REG_ARCH_MASK) != KVM_REG_ARM64 ||
+            (reg & KVM_REG_ARM_COPROC_MASK) != KVM_REG_ARM64_SYSREG)
+            continue;
+
+        const unsigned op0(EXTRACT_FIELD(reg, KVM_REG_ARM64_SYSREG_OP0));
+        const unsigned op1(EXTRACT_FIELD(reg, KVM_REG_ARM64_SYSREG_OP1));
+        const unsigned crn(EXTRACT_FIELD(reg, KVM_REG_ARM64_SYSREG_CRN));
+        const unsigned crm(EXTRACT_FIELD(reg, KVM_REG_ARM64_SYSREG_CRM));
+        const unsigned op2(EXTRACT_FIELD(reg, KVM_REG_ARM64_SYSREG_OP2));
+        const MiscRegIndex idx(decodeAArch64SysReg(op0, op1, crn, crm, op2));
+        if (idx == NUM_MISCREGS)
+            continue;
+
+        const auto &info(miscRegInfo[idx]);
+        const bool writeable(
+            info[MISCREG_USR_NS_WR] || info[MISCREG_USR_S_WR] ||
+            info[MISCREG_PRI_S_WR] || info[MISCREG_PRI_NS_WR] ||
+            info[MISCREG_HYP_WR] ||
+            info[MISCREG_MON_NS0_WR] || info[MISCREG_MON_NS1_WR]);
+        const bool implemented(
+            info[MISCREG_IMPLEMENTED] || info[MISCREG_WARN_NOT_FAIL]);
+
+        // Only add implemented registers that we are going to be able
+        // to write. This also filters out the invariant ID registers
+        // since they are read-only in gem5.
+        if (implemented && writeable)
+            sysRegMap.emplace_back(reg, idx, miscRegName[idx],
+                deviceRegSet.find(idx) != deviceRegSet.end());
+    }
+
+    return sysRegMap;
+}
+
+void
+ArmV8KvmCPU::kvmArmVCpuInit(const struct kvm_vcpu_init &init)
+{
+    if (ioctl(KVM_ARM_VCPU_INIT, (void *)&init) == -1)
+        panic("KVM: Failed to initialize vCPU\n");
+}
+
+bool
+ArmV8KvmCPU::getRegList(struct kvm_reg_list &regs) const
+{
+    if (ioctl(KVM_GET_REG_LIST, (void *)&regs) == -1) {
+        if (errno == E2BIG) {
+            return false;
+        } else {
+            panic("KVM: Failed to get vCPU register list (errno: %i)\n",
+                  errno);
+        }
+    } else {
+        return true;
+    }
+}
+
+ArmV8KvmCPU *
+ArmV8KvmCPUParams::create()
+{
+    return new ArmV8KvmCPU(this);
+}
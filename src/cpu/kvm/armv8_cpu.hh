@@ -0,0 +1,150 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_KVM_ARMV8_CPU_HH__
+#define __CPU_KVM_ARMV8_CPU_HH__
+
+#include <set>
+#include <vector>
+
+#include "cpu/kvm/base.hh"
+#include "params/ArmV8KvmCPU.hh"
+
+/**
+ * AArch64 implementation of a KVM-based hardware virtualized CPU.
+ *
+ * The CPU synchronizes the AArch64 general purpose registers, the
+ * vector register file, PSTATE, the EL1 banked state and every
+ * system register that KVM exposes and gem5 implements with the
+ * ThreadContext. This makes it possible to fast-forward a guest in
+ * KVM and switch to a detailed CPU model (and back) using the normal
+ * CPU switching mechanism.
+ *
+ * Architecture specific limitations:
+ *  * The guest is always started at EL1. KVM does not virtualize EL2
+ *    or EL3, so the system must not be configured to start at a
+ *    higher exception level.
+ *  * Registers that KVM treats as invariant (e.g., the ID registers)
+ *    are read back from KVM but never written.
+ *  * AArch32 guests are supported if the host CPU supports 32-bit
+ *    EL1, but the 32-bit register state is only synchronized through
+ *    the AArch64 view that KVM exports.
+ */
+class ArmV8KvmCPU : public BaseKvmCPU
+{
+  public:
+    ArmV8KvmCPU(ArmV8KvmCPUParams *params);
+    virtual ~ArmV8KvmCPU();
+
+    void startup();
+
+    void dump();
+
+  protected:
+    struct IntRegInfo {
+        IntRegInfo(uint64_t _kvm, IntRegIndex _idx, const char *_name)
+            : kvm(_kvm), idx(_idx), name(_name) {}
+
+        /** KVM ID */
+        const uint64_t kvm;
+        /** gem5 index */
+        const IntRegIndex idx;
+        /** Name in debug output */
+        const char *name;
+    };
+
+    struct MiscRegInfo {
+        MiscRegInfo(uint64_t _kvm, MiscRegIndex _idx, const char *_name,
+                    bool _is_device = false)
+            : kvm(_kvm), idx(_idx), name(_name), is_device(_is_device) {}
+
+        /** KVM ID */
+        const uint64_t kvm;
+        /** gem5 index */
+        const MiscRegIndex idx;
+        /** Name in debug output */
+        const char *name;
+        /** Is the register backed by a device model (e.g., a timer)? */
+        const bool is_device;
+    };
+
+    typedef std::vector<uint64_t> RegIndexVector;
+
+    Tick kvmRun(Tick ticks);
+
+    void updateKvmState();
+    void updateThreadContext();
+
+    Tick onKvmExitHypercall();
+
+    /**
+     * Get a list of registers supported by getOneReg() and setOneReg().
+     */
+    const RegIndexVector &getRegList() const;
+
+    /**
+     * Get the list of system registers that KVM exposes and that can
+     * be mapped to a writable, implemented gem5 system register.
+     *
+     * The list is built on first use and cached afterwards.
+     */
+    const std::vector<MiscRegInfo> &getSysRegMap() const;
+
+    void kvmArmVCpuInit(const struct kvm_vcpu_init &init);
+
+    /** Core integer registers that live outside of X0-X30 */
+    static const std::vector<IntRegInfo> intRegMap;
+    /** Core registers mapped to gem5 misc registers */
+    static const std::vector<MiscRegInfo> miscRegMap;
+    /** ID registers that are forced to the value gem5 reports */
+    static const std::vector<MiscRegInfo> miscRegIdMap;
+    /** System registers that are backed by a device model */
+    static const std::set<MiscRegIndex> deviceRegSet;
+
+  private:
+    /**
+     * Get a list of registers supported by getOneReg() and setOneReg().
+     *
+     * @return False if the number of elements allocated in the list
+     * is too small to hold the complete register list (the required
+     * value is written into n in this case). True on success.
+     */
+    bool getRegList(struct kvm_reg_list &regs) const;
+
+    /** Cached state of the IRQ line */
+    bool irqAsserted;
+    /** Cached state of the FIQ line */
+    bool fiqAsserted;
+
+    /** Cached copy of the list of registers supported by KVM */
+    mutable RegIndexVector _regIndexList;
+
+    /** Cached mapping between KVM system registers and gem5 */
+    mutable std::vector<MiscRegInfo> sysRegMap;
+};
+
+#endif // __CPU_KVM_ARMV8_CPU_HH__
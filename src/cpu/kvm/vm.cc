@@ -488,6 +488,18 @@ KvmVM::setIRQLine(uint32_t irq, bool high)
               errno);
 }
 
+void
+KvmVM::kvmArmPreferredTarget(struct kvm_vcpu_init &target) const
+{
+#if defined(__arm__) || defined(__aarch64__)
+    if (ioctl(KVM_ARM_PREFERRED_TARGET, (void *)&target) == -1)
+        panic("KVM: Failed to get ARM preferred CPU target (errno: %i)\n",
+              errno);
+#else
+    panic("KVM: kvmArmPreferredTarget is unsupported on this platform.\n");
+#endif
+}
+
 int
 KvmVM::createVCPU(long vcpuID)
 {
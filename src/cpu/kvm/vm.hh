@@ -48,6 +48,7 @@
 
 // forward declarations
 struct KvmVMParams;
+struct kvm_vcpu_init;
 class System;
 
 /**
@@ -338,6 +339,16 @@ class KvmVM : public SimObject
     bool hasKernelIRQChip() const { return _hasKernelIRQChip; }
     /** @} */
 
+    /**
+     * Ask the kernel for the vCPU target that best matches the host
+     * CPU using KVM_ARM_PREFERRED_TARGET.
+     *
+     * @note This is only supported on ARM hosts.
+     *
+     * @param target vCPU configuration to fill in
+     */
+    void kvmArmPreferredTarget(struct kvm_vcpu_init &target) const;
+
     struct MemSlot
     {
         MemSlot(uint32_t _num) : num(_num)
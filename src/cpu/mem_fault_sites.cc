@@ -0,0 +1,101 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/mem_fault_sites.hh"
+
+#include <limits>
+
+#include "base/misc.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/cache/base.hh"
+#include "mem/cache/blk.hh"
+
+CacheDataFaultSite::CacheDataFaultSite(BaseCache *cache) :
+    blkSize(cache->getBlockSize())
+{
+    cache->getBlocks(blks);
+}
+
+void
+CacheDataFaultSite::flipBit(unsigned int index, unsigned int bit,
+    unsigned int fault)
+{
+    CacheBlk *blk = blks[index];
+
+    blk->data[bit / 8] ^= 1 << (bit % 8);
+    if (blk->isValid())
+        blk->faultyBits.push_back(bit);
+}
+
+bool
+CacheDataFaultSite::isFaulty(unsigned int index) const
+{
+    return !blks[index]->faultyBits.empty();
+}
+
+CacheTagFaultSite::CacheTagFaultSite(BaseCache *cache_) : cache(cache_)
+{
+    cache->getBlocks(blks);
+}
+
+void
+CacheTagFaultSite::flipBit(unsigned int index, unsigned int bit,
+    unsigned int fault)
+{
+    CacheBlk *blk = blks[index];
+
+    if (bit < 64) {
+        blk->tag ^= Addr(1) << bit;
+        cache->blockTagChanged(blk);
+    } else {
+        blk->status ^= 1 << (bit - 64);
+    }
+}
+
+unsigned int
+MemoryFaultSite::numEntries() const
+{
+    uint64_t words = memory->size() / 8;
+
+    return std::min(words,
+        uint64_t(std::numeric_limits<unsigned int>::max()));
+}
+
+void
+MemoryFaultSite::flipBit(unsigned int index, unsigned int bit,
+    unsigned int fault)
+{
+    uint8_t *store = memory->backingStore();
+
+    if (!store) {
+        warn("%s has no backing store, fault not injected\n",
+            memory->name());
+        return;
+    }
+
+    store[uint64_t(index) * 8 + bit / 8] ^= 1 << (bit % 8);
+}
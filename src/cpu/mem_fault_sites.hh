@@ -0,0 +1,95 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Fault injection sites for the arrays of the classic caches and of
+ *  memories.  See FaultInjector for how sites are registered and
+ *  targeted.
+ */
+
+#ifndef __CPU_MEM_FAULT_SITES_HH__
+#define __CPU_MEM_FAULT_SITES_HH__
+
+#include <vector>
+
+#include "cpu/fault_injector.hh"
+
+class AbstractMemory;
+class BaseCache;
+class CacheBlk;
+
+/** The data array of a cache, one entry per block.  Flips in valid
+ *  blocks are recorded for the cache's ECC model */
+class CacheDataFaultSite : public FaultSite
+{
+  protected:
+    std::vector<CacheBlk *> blks;
+    unsigned int blkSize;
+
+  public:
+    CacheDataFaultSite(BaseCache *cache);
+
+    unsigned int numEntries() const { return blks.size(); }
+    unsigned int entryBits() const { return blkSize * 8; }
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+    bool isFaulty(unsigned int index) const;
+};
+
+/** The tag array of a cache, one entry per block.  Bits [0, 64) of an
+ *  entry are the tag, bits [64, 72) the low status bits (valid,
+ *  writable, readable, dirty, ...) */
+class CacheTagFaultSite : public FaultSite
+{
+  protected:
+    BaseCache *cache;
+    std::vector<CacheBlk *> blks;
+
+  public:
+    CacheTagFaultSite(BaseCache *cache);
+
+    unsigned int numEntries() const { return blks.size(); }
+    unsigned int entryBits() const { return 64 + 8; }
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+};
+
+/** The backing store of a memory, one entry per 64 bit word */
+class MemoryFaultSite : public FaultSite
+{
+  protected:
+    AbstractMemory *memory;
+
+  public:
+    MemoryFaultSite(AbstractMemory *memory_) : memory(memory_) { }
+
+    unsigned int numEntries() const;
+    unsigned int entryBits() const { return 64; }
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+};
+
+#endif // __CPU_MEM_FAULT_SITES_HH__
@@ -47,6 +47,8 @@ from m5.SimObject import SimObject
 from BaseCPU import BaseCPU
 from DummyChecker import DummyChecker
 from BranchPredictor import BranchPredictor
+from FaultInjector import FaultInjector
+from SimPoint import SimPoint
 from TimingExpr import TimingExpr
 
 from FuncUnit import OpClass
@@ -169,6 +171,8 @@ class MinorDefaultFUPool(MinorFUPool):
         MinorDefaultFloatSimdFU(), MinorDefaultMemFU(),
         MinorDefaultMiscFU()]
 
+class MinorFetchFault(Enum): vals = ['inst', 'pc']
+
 class MinorCPU(BaseCPU):
     type = 'MinorCPU'
     cxx_header = "cpu/minor/cpu.hh"
@@ -185,6 +189,13 @@ class MinorCPU(BaseCPU):
     def support_take_over(cls):
         return True
 
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+    void retargetFault(uint64_t target, uint64_t target_reg);
+    std::string valueDivergence();
+''')
+
     fetch1FetchLimit = Param.Unsigned(1,
         "Number of line fetches allowable in flight at once")
     fetch1LineSnapWidth = Param.Unsigned(0,
@@ -259,6 +270,50 @@ class MinorCPU(BaseCPU):
     MaxTick = Param.UInt64(0, "The maximum allowable tick, used for fault injection")
     enableSWIFTR = Param.Bool(False, "SWIFTR is enable")
     enableZDCR = Param.Bool(False, "ZDCR is enable")
+    # Bit n stands for integer register index n, bit 43 for SP
+    swiftMasterRegs = Param.UInt64(0x80061980007, "SWIFT-R master"
+        " registers (X0-X2, X19, X20, X23, X24, X29, X30, SP)")
+    zdcMasterRegs = Param.UInt64(0x8007198003f, "ZDC master registers"
+        " (X0-X5, X19, X20, X23, X24, X28-X30, SP)")
+    faultInjector = Param.FaultInjector(FaultInjector(), "Fault target"
+        " and source of random fault choices")
+    convergenceInterval = Param.UInt64(0, "Committed instructions between"
+        " architectural state hashes for convergence checking (0 disables)")
+    convergenceTrace = Param.String("", "Golden run state hash trace,"
+        " written when convergenceRecord is set and checked against"
+        " otherwise")
+    convergenceRecord = Param.Bool(False, "Record convergenceTrace rather"
+        " than stopping injection runs once their state matches it")
+    aceAnalysis = Param.Bool(False, "Measure register ACE intervals of"
+        " committed instructions")
+    aceSummary = Param.String("ace_summary.bin", "Binary ACE summary file"
+        " written at the end of simulation (empty for none)")
+    protectionEval = Param.Bool(False, "Split committed ops, cycles, FU"
+        " and LSQ occupancy and register ACE cycles between original,"
+        " duplicate and checker instructions")
+    protectionAnnotations = Param.String("", "File of 'start end class'"
+        " hex address ranges classifying instructions as original,"
+        " duplicate or checker (empty for none)")
+    protectionSymbols = VectorParam.String([], "'symbol=class' entries"
+        " classifying whole functions")
+    guestMarkers = Param.Bool(False, "Take the region of interest and"
+        " the arming of fault injection from the guest's roi_begin,"
+        " roi_end and fi_arm m5 ops rather than from the symbols")
+    faultTrace = Param.String("", "Protobuf trace of fault injection"
+        " events, gzipped if the name ends in .gz (empty for none)")
+    valueTraceInterval = Param.UInt64(0, "Committed instructions per"
+        " digest of committed values (0 disables)")
+    valueTrace = Param.String("", "Golden run committed value digests,"
+        " written when valueTraceRecord is set and checked against"
+        " otherwise")
+    valueTraceRecord = Param.Bool(False, "Record valueTrace rather than"
+        " looking for the first divergence from it")
+    fetchFaultSeqNum = Param.UInt64(0, "Fetch sequence number of the"
+        " instruction Fetch2 corrupts (0 disables)")
+    fetchFaultField = Param.MinorFetchFault('inst', "Flip a bit of the"
+        " fetched instruction word or of the instruction's PC")
+    fetchFaultBit = Param.Int(-1, "Bit of fetchFaultField to flip"
+        " (-1 for a random bit)")
 #################################
 
 ##############################################
@@ -273,6 +328,9 @@ class MinorCPU(BaseCPU):
 
     enableIdling = Param.Bool(True,
         "Enable cycle skipping when the processor is idle\n");
+    enableStageSkipping = Param.Bool(True,
+        "Don't evaluate Fetch2 and Decode in cycles where they are empty"
+        " or stalled with no new input")
 
     branchPred = Param.BranchPredictor(BranchPredictor(
         numThreads = Parent.numThreads), "Branch Predictor")
@@ -280,3 +338,9 @@ class MinorCPU(BaseCPU):
     def addCheckerCpu(self):
         print "Checker not yet supported by MinorCPU"
         exit(1)
+
+    def addSimPointProbe(self, interval, binary=False):
+        simpoint = SimPoint()
+        simpoint.interval = interval
+        simpoint.binary = binary
+        self.probeListener = simpoint
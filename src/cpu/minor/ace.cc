@@ -0,0 +1,193 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sstream>
+
+#include "base/loader/region_map.hh"
+#include "base/output.hh"
+#include "cpu/minor/ace.hh"
+#include "cpu/reg_class.hh"
+#include "sim/sim_exit.hh"
+
+namespace Minor
+{
+
+AceAnalysis::AceAnalysis(const std::string &name_,
+    MinorCPUParams &params) :
+    Named(name_),
+    enabled_(params.aceAnalysis),
+    summaryName(params.aceSummary),
+    lastAccess(NumRegs, Cycles(0)),
+    firstCycle(0),
+    lastCycle(0),
+    started(false),
+    summaryCallback(this)
+{
+    if (enabled_ && summaryName != "")
+        registerExitCallback(&summaryCallback);
+}
+
+int
+AceAnalysis::regIndex(TheISA::RegIndex reg_idx) const
+{
+    /* Guard regIdxToClass against out of range indices */
+    if (reg_idx >= TheISA::Max_Reg_Index)
+        return -1;
+
+    TheISA::RegIndex rel_idx;
+
+    switch (regIdxToClass(reg_idx, &rel_idx)) {
+      case IntRegClass:
+        if (rel_idx == TheISA::ZeroReg || rel_idx >= TheISA::NumIntRegs)
+            return -1;
+        return rel_idx;
+      case FloatRegClass:
+        return (rel_idx < TheISA::NumFloatRegs ?
+            FloatRegBase + rel_idx : -1);
+      case CCRegClass:
+        return (rel_idx < TheISA::NumCCRegs ? CCRegBase + rel_idx : -1);
+      default:
+        return -1;
+    }
+}
+
+void
+AceAnalysis::regStats(const std::string &stat_name)
+{
+    /* Give each ROI function a stat, everything else goes in "other" */
+    funcNames.push_back(debugRegionMap.funcName(RegionMap::otherFuncId));
+    for (unsigned int i = 1; enabled_ && i < debugRegionMap.numFuncIds();
+        i++)
+    {
+        funcNames.push_back(debugRegionMap.funcName(i));
+    }
+
+    regAceCycles
+        .init(NumRegs)
+        .name(stat_name + ".regAceCycles")
+        .desc("Cycles each register held a value which was later read")
+        .flags(Stats::total | Stats::nozero);
+
+    for (unsigned int i = 0; i < NumRegs; i++) {
+        std::ostringstream subname;
+
+        if (i < FloatRegBase)
+            subname << "int" << i;
+        else if (i < CCRegBase)
+            subname << "float" << (i - FloatRegBase);
+        else
+            subname << "cc" << (i - CCRegBase);
+        regAceCycles.subname(i, subname.str());
+    }
+
+    funcAceCycles
+        .init(funcNames.size())
+        .name(stat_name + ".funcAceCycles")
+        .desc("Register ACE cycles ending in reads by each function")
+        .flags(Stats::total | Stats::nozero);
+
+    for (unsigned int i = 0; i < funcNames.size(); i++)
+        funcAceCycles.subname(i, funcNames[i]);
+}
+
+Counter
+AceAnalysis::commitInst(const StaticInstPtr &static_inst, Addr pc,
+    Cycles now)
+{
+    Counter inst_ace = 0;
+
+    if (!started) {
+        firstCycle = now;
+        started = true;
+    }
+    lastCycle = now;
+
+    unsigned int func = debugRegionMap.funcId(pc);
+    if (func >= funcNames.size())
+        func = RegionMap::otherFuncId;
+
+    /* Reads end ACE intervals, writes start unACE ones.  Cycles(0) marks
+     *  values from before the analysis whose intervals are unknown */
+    for (int i = 0; i < static_inst->numSrcRegs(); i++) {
+        int reg = regIndex(static_inst->srcRegIdx(i));
+
+        if (reg >= 0) {
+            if (lastAccess[reg] != Cycles(0)) {
+                Counter ace = now - lastAccess[reg];
+
+                regAceCycles[reg] += ace;
+                funcAceCycles[func] += ace;
+                inst_ace += ace;
+            }
+            lastAccess[reg] = now;
+        }
+    }
+
+    for (int i = 0; i < static_inst->numDestRegs(); i++) {
+        int reg = regIndex(static_inst->destRegIdx(i));
+
+        if (reg >= 0)
+            lastAccess[reg] = now;
+    }
+
+    return inst_ace;
+}
+
+void
+AceAnalysis::writeSummary()
+{
+    std::ostream *os = simout.create(summaryName, true);
+
+    uint32_t num_regs = NumRegs;
+    uint32_t num_funcs = funcNames.size();
+    uint64_t cycles = lastCycle - firstCycle;
+
+    os->write("ACE1", 4);
+    os->write(reinterpret_cast<const char *>(&num_regs), sizeof(num_regs));
+    os->write(reinterpret_cast<const char *>(&num_funcs),
+        sizeof(num_funcs));
+    os->write(reinterpret_cast<const char *>(&cycles), sizeof(cycles));
+
+    for (unsigned int i = 0; i < num_regs; i++) {
+        uint64_t ace = regAceCycles[i].value();
+
+        os->write(reinterpret_cast<const char *>(&ace), sizeof(ace));
+    }
+
+    for (unsigned int i = 0; i < num_funcs; i++) {
+        uint32_t length = funcNames[i].size();
+        uint64_t ace = funcAceCycles[i].value();
+
+        os->write(reinterpret_cast<const char *>(&length), sizeof(length));
+        os->write(funcNames[i].data(), length);
+        os->write(reinterpret_cast<const char *>(&ace), sizeof(ace));
+    }
+
+    simout.close(os);
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Architecturally correct execution (ACE) interval analysis of the
+ *  register files of a golden run.
+ */
+
+#ifndef __CPU_MINOR_ACE_HH__
+#define __CPU_MINOR_ACE_HH__
+
+#include <string>
+#include <vector>
+
+#include "arch/registers.hh"
+#include "base/callback.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/minor/trace.hh"
+#include "cpu/static_inst.hh"
+#include "params/MinorCPU.hh"
+
+namespace Minor
+{
+
+/** Measures how long each architectural register of thread 0 holds a
+ *  value which will be read again.  An interval ending in a read of the
+ *  register (write-to-read or read-to-read) is ACE: a fault in the
+ *  register during it would be consumed.  Intervals ending in a write
+ *  are not.  ACE cycles are accumulated per register and per ROI
+ *  function (that of the reading instruction, with all other code in one
+ *  bucket) as stats and, when the simulation ends, as a compact binary
+ *  summary:
+ *
+ *      char magic[4] = "ACE1"
+ *      uint32_t num_regs, num_funcs
+ *      uint64_t cycles                     -- of the analysis
+ *      uint64_t reg_ace[num_regs]          -- int, float then CC regs
+ *      { uint32_t name_length; char name[name_length];
+ *        uint64_t func_ace; } [num_funcs]
+ *
+ *  all in host byte order.  This replaces post-processing RegFileAccess
+ *  traces */
+class AceAnalysis : public Named
+{
+  protected:
+    enum
+    {
+        FloatRegBase = TheISA::NumIntRegs,
+        CCRegBase = FloatRegBase + TheISA::NumFloatRegs,
+        NumRegs = CCRegBase + TheISA::NumCCRegs
+    };
+
+    const bool enabled_;
+
+    /** Summary file name, empty for none */
+    const std::string summaryName;
+
+    /** Cycle of the last access to each register, Cycles(0) for
+     *  registers not yet accessed */
+    std::vector<Cycles> lastAccess;
+
+    /** Cycle of the first analysed instruction */
+    Cycles firstCycle;
+    Cycles lastCycle;
+    bool started;
+
+    /** Names of the debugRegionMap function IDs funcAceCycles was sized
+     *  for */
+    std::vector<std::string> funcNames;
+
+    Stats::Vector regAceCycles;
+    Stats::Vector funcAceCycles;
+
+    /** Dense register index of a unified one, -1 if untracked */
+    int regIndex(TheISA::RegIndex reg_idx) const;
+
+    void writeSummary();
+
+    MakeCallback<AceAnalysis, &AceAnalysis::writeSummary> summaryCallback;
+
+  public:
+    AceAnalysis(const std::string &name_, MinorCPUParams &params);
+
+    bool enabled() const { return enabled_; }
+
+    void regStats(const std::string &stat_name);
+
+    /** Account the register accesses of a committing instruction
+     *  @return The ACE cycles ending in its reads */
+    Counter commitInst(const StaticInstPtr &static_inst, Addr pc,
+        Cycles now);
+};
+
+}
+
+#endif /* __CPU_MINOR_ACE_HH__ */
@@ -50,6 +50,7 @@
 #include <queue>
 #include <sstream>
 
+#include "base/statistics.hh"
 #include "cpu/minor/trace.hh"
 #include "cpu/activity.hh"
 #include "cpu/timebuf.hh"
@@ -155,6 +156,14 @@ class MinorBuffer : public Named, public TimeBuffer<ElemType>
     /** Name to use for the data in a MinorTrace line */
     std::string dataName;
 
+    /** Liveness accounting: bits held by non-bubble elements summed over
+     *  every slot and every evaluated cycle, and the evaluated cycles.
+     *  The pipeline only idles when the buffers are empty, so idle cycles
+     *  add no live bits */
+    Stats::Scalar liveBitCycles;
+    Stats::Scalar liveCycles;
+    Stats::Formula avgLiveBits;
+
   public:
     MinorBuffer(const std::string &name,
         const std::string &data_name,
@@ -180,6 +189,46 @@ class MinorBuffer : public Named, public TimeBuffer<ElemType>
         return ret;
     }
 
+    /** Account the live bits held in the buffer this cycle.  Call once
+     *  per cycle, before advancing.  ElemType must provide
+     *  unsigned int liveBits() */
+    void
+    accountLiveness()
+    {
+        unsigned int bits = 0;
+
+        for (int i = -this->past; i <= this->future; i++) {
+            const ElemType &datum = (*this)[i];
+
+            if (!BubbleTraits::isBubble(datum))
+                bits += datum.liveBits();
+        }
+
+        liveBitCycles += bits;
+        liveCycles++;
+    }
+
+    void
+    regStats()
+    {
+        liveBitCycles
+            .name(name() + ".live_bit_cycles")
+            .desc("Bit-cycles of live data held in the buffer")
+            ;
+
+        liveCycles
+            .name(name() + ".live_cycles")
+            .desc("Cycles over which live_bit_cycles was accounted")
+            ;
+
+        avgLiveBits
+            .name(name() + ".avg_live_bits")
+            .desc("Average live bits held in the buffer per cycle")
+            ;
+
+        avgLiveBits = liveBitCycles / liveCycles;
+    }
+
     /** Report buffer states from 'slot' 'from' to 'to'.  For example 0,-1
       * will produce two slices with current (just assigned) and last (one
       * advance() old) slices with the current (0) one on the left.
@@ -271,7 +320,14 @@ class Latch
 
     void minorTrace() const { buffer.minorTrace(); }
 
-    void evaluate() { buffer.advance(); }
+    void regStats() { buffer.regStats(); }
+
+    void
+    evaluate()
+    {
+        buffer.accountLiveness();
+        buffer.advance();
+    }
 };
 
 /** A pipeline simulating class that will stall (not advance when advance()
@@ -347,6 +403,7 @@ class SelfStallingPipeline : public MinorBuffer<ElemType, ReportTraits>
     {
         bool data_at_end = isPopable();
 
+        this->accountLiveness();
         if (!stalled) {
             TimeBuffer<ElemType>::advance();
             /* If there was data at the end of the pipe that has now been
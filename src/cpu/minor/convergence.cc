@@ -0,0 +1,211 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <fstream>
+
+#include "arch/isa_traits.hh"
+#include "arch/registers.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "cpu/minor/convergence.hh"
+#include "cpu/simple_thread.hh"
+#include "debug/MinorConvergence.hh"
+
+namespace Minor
+{
+
+const Addr Convergence::pageBytes = TheISA::PageBytes;
+
+/** 64 bit FNV-1a, seeded with the hash so far */
+static uint64_t
+hashBytes(uint64_t hash, const void *bytes, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(bytes);
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= ULL(1099511628211);
+    }
+
+    return hash;
+}
+
+static const uint64_t hashSeed = ULL(14695981039346656037);
+
+template <typename T>
+static uint64_t
+hashValue(uint64_t hash, T value)
+{
+    return hashBytes(hash, &value, sizeof(value));
+}
+
+Convergence::ShadowPage::ShadowPage() :
+    data(pageBytes, 0), written(pageBytes, 0), hash(0), stale(false)
+{ }
+
+Convergence::Convergence(const std::string &name_,
+    MinorCPUParams &params) :
+    Named(name_),
+    interval(params.convergenceInterval),
+    record(params.convergenceRecord),
+    memHash(0),
+    numInsts(0),
+    traceOut(NULL),
+    goldenIndex(0)
+{
+    if (!enabled())
+        return;
+
+    const std::string &trace = params.convergenceTrace;
+
+    if (trace == "")
+        fatal("%s: convergenceInterval needs a convergenceTrace\n", name_);
+
+    if (record) {
+        traceOut = simout.create(trace);
+    } else {
+        std::ifstream in(trace.c_str());
+        if (!in)
+            fatal("%s: can't open convergence trace: %s\n", name_, trace);
+
+        Counter count;
+        uint64_t hash;
+        while (in >> std::dec >> count >> std::hex >> hash)
+            golden.push_back(std::make_pair(count, hash));
+
+        DPRINTF(MinorConvergence, "Read %d golden hashes from %s\n",
+            golden.size(), trace);
+    }
+}
+
+Convergence::~Convergence()
+{
+    if (traceOut)
+        simout.close(traceOut);
+}
+
+void
+Convergence::recordStore(Addr vaddr, unsigned int size, const uint8_t *data)
+{
+    while (size != 0) {
+        Addr page_addr = vaddr & ~(pageBytes - 1);
+        unsigned int offset = vaddr - page_addr;
+        unsigned int chunk = std::min<Addr>(size, pageBytes - offset);
+
+        ShadowPage &page = pages[page_addr];
+
+        std::copy(data, data + chunk, page.data.begin() + offset);
+        std::fill(page.written.begin() + offset,
+            page.written.begin() + offset + chunk, 1);
+
+        /* New pages start with a hash of 0 so need no special case */
+        if (!page.stale) {
+            memHash -= page.hash;
+            page.stale = true;
+            stalePages.push_back(page_addr);
+        }
+
+        vaddr += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void
+Convergence::rehashPages()
+{
+    for (auto i = stalePages.begin(); i != stalePages.end(); ++i) {
+        ShadowPage &page = pages[*i];
+
+        uint64_t hash = hashValue(hashSeed, *i);
+        hash = hashBytes(hash, &page.data[0], pageBytes);
+        hash = hashBytes(hash, &page.written[0], pageBytes);
+
+        page.hash = hash;
+        page.stale = false;
+        memHash += hash;
+    }
+
+    stalePages.clear();
+}
+
+uint64_t
+Convergence::stateHash(SimpleThread *thread)
+{
+    /* All the flat registers, of every mode, in one pass */
+    uint64_t hash = hashBytes(hashSeed, &thread->archRegs(),
+        sizeof(SimpleThread::ArchRegs));
+
+    TheISA::PCState pc = thread->pcState();
+    hash = hashValue(hash, pc.instAddr());
+    hash = hashValue(hash, pc.nextInstAddr());
+
+    rehashPages();
+
+    return hashValue(hash, memHash);
+}
+
+bool
+Convergence::commitInst(SimpleThread *thread, bool check)
+{
+    numInsts++;
+
+    if (numInsts % interval != 0)
+        return false;
+
+    if (record) {
+        uint64_t hash = stateHash(thread);
+
+        ccprintf(*traceOut, "%d %016x\n", numInsts, hash);
+        return false;
+    }
+
+    /* Skip golden samples we've already passed */
+    while (goldenIndex < golden.size() &&
+        golden[goldenIndex].first < numInsts)
+    {
+        goldenIndex++;
+    }
+
+    if (!check || goldenIndex == golden.size() ||
+        golden[goldenIndex].first != numInsts)
+    {
+        return false;
+    }
+
+    uint64_t hash = stateHash(thread);
+    bool converged = hash == golden[goldenIndex].second;
+
+    DPRINTF(MinorConvergence, "Insts: %d hash: %016x golden: %016x%s\n",
+        numInsts, hash, golden[goldenIndex].second,
+        (converged ? " converged" : ""));
+
+    return converged;
+}
+
+}
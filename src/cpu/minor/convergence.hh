@@ -0,0 +1,155 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Architectural state convergence checking for fault injection runs.
+ *  A golden (fault-free) run records a hash of the register file and of
+ *  all stored-to memory every N committed instructions.  An injection run
+ *  compares its own hashes at the same instruction counts and can stop
+ *  as soon as they match as the fault has then been masked.
+ */
+
+#ifndef __CPU_MINOR_CONVERGENCE_HH__
+#define __CPU_MINOR_CONVERGENCE_HH__
+
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/minor/trace.hh"
+#include "mem/se_translating_port_proxy.hh"
+#include "params/MinorCPU.hh"
+
+class SimpleThread;
+
+namespace Minor
+{
+
+/** Hashes architectural state at regular committed instruction counts
+ *  and either records those hashes or checks them against a recording.
+ *
+ *  Memory state is tracked as a shadow copy of the stored bytes of each
+ *  page written since simulation start rather than by reading memory so
+ *  that stores still in the store buffer are accounted for and no memory
+ *  accesses are needed.  The shadow sees committed stores and, in SE
+ *  mode, the writes of emulated system calls through the threads'
+ *  memory proxies.  Pages or bytes written by only one of two runs make
+ *  their hashes differ so a match is never claimed for a diverged
+ *  memory image.  Writes made by devices or by other CPUs are not seen,
+ *  so a full system run can be reported as converged while its memory
+ *  differs.  The golden and checked runs must start from the same point
+ *  (tick 0 or the same checkpoint) */
+class Convergence : public Named,
+    public SETranslatingPortProxy::WriteObserver
+{
+  protected:
+    /** Bytes and written-byte mask for one page stored to */
+    class ShadowPage
+    {
+      public:
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> written;
+
+        /** Hash of this page as last included in memHash.  0 for pages
+         *  which have never been hashed */
+        uint64_t hash;
+
+        /** Written since hash was last computed */
+        bool stale;
+
+        ShadowPage();
+    };
+
+    typedef std::unordered_map<Addr, ShadowPage> PageMap;
+
+    /** Committed instructions between samples, 0 to disable */
+    const Counter interval;
+
+    /** Record hashes to trace rather than check against them */
+    const bool record;
+
+    /** Shadow memory image, by virtual page address */
+    PageMap pages;
+
+    /** Sum of the hashes of all non-stale pages */
+    uint64_t memHash;
+
+    /** Pages with stale hashes */
+    std::vector<Addr> stalePages;
+
+    /** Committed instructions so far */
+    Counter numInsts;
+
+    /** Recording output stream */
+    std::ostream *traceOut;
+
+    /** Golden run hashes, by ascending instruction count */
+    std::vector<std::pair<Counter, uint64_t> > golden;
+
+    /** Next element of golden to compare against */
+    unsigned int goldenIndex;
+
+    /** The page size used for shadowing */
+    static const Addr pageBytes;
+
+    /** Hash the current register file and memory image */
+    uint64_t stateHash(SimpleThread *thread);
+
+    /** Bring memHash up to date with writes since the last sample */
+    void rehashPages();
+
+  public:
+    Convergence(const std::string &name_, MinorCPUParams &params);
+
+    ~Convergence();
+
+    bool enabled() const { return interval != 0; }
+
+    /** Note a store of size bytes of data to vaddr */
+    void recordStore(Addr vaddr, unsigned int size, const uint8_t *data);
+
+    /** Note a write made through a thread's memory proxy */
+    void
+    proxyWrite(Addr addr, const uint8_t *p, int size)
+    {
+        recordStore(addr, size, p);
+    }
+
+    /** Count one committed (macro-)instruction.  For recording runs, this
+     *  writes a hash to the trace every interval instructions.  For
+     *  checking runs with check set, returns true if the state now
+     *  matches the golden run's at the same instruction count */
+    bool commitInst(SimpleThread *thread, bool check);
+};
+
+}
+
+#endif /* __CPU_MINOR_CONVERGENCE_HH__ */
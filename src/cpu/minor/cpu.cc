@@ -38,6 +38,7 @@
  */
 
 #include "arch/utility.hh"
+#include "base/loader/region_map.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/minor/dyn_inst.hh"
 #include "cpu/minor/fetch1.hh"
@@ -45,10 +46,14 @@
 #include "debug/Drain.hh"
 #include "debug/MinorCPU.hh"
 #include "debug/Quiesce.hh"
+#include "sim/guest_roi.hh"
 
 MinorCPU::MinorCPU(MinorCPUParams *params) :
     BaseCPU(params),
-    drainManager(NULL)
+    drainManager(NULL),
+    faultInjector(params->faultInjector),
+    ppExecuteOccupancy(NULL), ppIssue(NULL), ppLSQAllocate(NULL),
+    ppLSQFree(NULL), ppCommit(NULL), occupancyListener(NULL)
 {
     /* This is only written for one thread at the moment */
     Minor::MinorThread *thread;
@@ -83,6 +88,7 @@ MinorCPU::MinorCPU(MinorCPUParams *params) :
 MinorCPU::~MinorCPU()
 {
     delete pipeline;
+    delete occupancyListener;
 
     for (ThreadID thread_id = 0; thread_id < threads.size(); thread_id++) {
         delete threads[thread_id];
@@ -106,8 +112,26 @@ MinorCPU::init()
         ThreadContext *tc = getContext(thread_id);
 
         tc->initMemProxies(tc);
+
+        /* System calls write memory behind the pipeline's back */
+        if (!FullSystem && pipeline->getConvergence().enabled())
+            tc->getMemProxy().setWriteObserver(&pipeline->getConvergence());
     }
 
+    /* Make the register files available as fault injection targets */
+    ThreadContext *tc = getContext(0);
+    Minor::Taint &taint = pipeline->getTaint();
+    faultInjector->registerSite(name() + ".int_regs",
+        new Minor::TaintedRegFileFaultSite(tc, RegFileFaultSite::IntRegs,
+            taint));
+    faultInjector->registerSite(name() + ".float_regs",
+        new Minor::TaintedRegFileFaultSite(tc, RegFileFaultSite::FloatRegs,
+            taint));
+    faultInjector->registerSite(name() + ".cc_regs",
+        new Minor::TaintedRegFileFaultSite(tc, RegFileFaultSite::CCRegs,
+            taint));
+    faultInjector->setTracker(&taint);
+
     /* Initialise CPUs (== threads in the ISA) */
     if (FullSystem && !params()->switched_out) {
         for (ThreadID thread_id = 0; thread_id < threads.size(); thread_id++)
@@ -125,8 +149,37 @@ void
 MinorCPU::regStats()
 {
     BaseCPU::regStats();
-    stats.regStats(name(), *this);
+    const MinorCPUParams *p = dynamic_cast<const MinorCPUParams *>(params());
+
+    stats.regStats(name(), *this,
+        p->executeInputBufferSize,
+        p->executeLSQRequestsQueueSize + p->executeLSQTransfersQueueSize +
+            p->executeLSQStoreBufferSize,
+        p->executeFuncUnits->funcUnits.size());
     pipeline->regStats();
+    pipeline->getAce().regStats(name() + ".ace");
+    pipeline->getProtection().regStats(name() + ".protection");
+}
+
+void
+MinorCPU::regProbePoints()
+{
+    BaseCPU::regProbePoints();
+
+    ppExecuteOccupancy = new ProbePointArg<Minor::ExecuteOccupancy>(
+        getProbeManager(), "ExecuteOccupancy");
+    ppIssue = new ProbePointArg<Minor::MinorDynInstPtr>(
+        getProbeManager(), "Issue");
+    ppLSQAllocate = new ProbePointArg<Minor::MinorDynInstPtr>(
+        getProbeManager(), "LSQAllocate");
+    ppLSQFree = new ProbePointArg<Minor::MinorDynInstPtr>(
+        getProbeManager(), "LSQFree");
+    ppCommit = new ProbePointArg<Minor::MinorDynInstPtr>(
+        getProbeManager(), "Commit");
+
+    occupancyListener =
+        new ProbeListenerArg<MinorCPU, Minor::ExecuteOccupancy>(
+            this, "ExecuteOccupancy", &MinorCPU::countOccupancy);
 }
 
 void
@@ -150,6 +203,9 @@ MinorCPU::serialize(std::ostream &os)
 {
     pipeline->serialize(os);
     BaseCPU::serialize(os);
+
+    bool fiInsertedToMain = pipeline->insertedToMain();
+    SERIALIZE_SCALAR(fiInsertedToMain);
 }
 
 void
@@ -157,6 +213,18 @@ MinorCPU::unserialize(Checkpoint *cp, const std::string &section)
 {
     pipeline->unserialize(cp, section);
     BaseCPU::unserialize(cp, section);
+
+    /* Checkpoints taken by other CPU models don't carry the injector's
+     *  state so guess it from where the thread is */
+    bool fiInsertedToMain;
+    if (!UNSERIALIZE_OPT_SCALAR(fiInsertedToMain)) {
+        const MinorCPUParams *p =
+            dynamic_cast<const MinorCPUParams *>(params());
+        fiInsertedToMain = p->guestMarkers ?
+            guestROI.fiArmed(getContext(0)->contextId()) :
+            debugRegionMap.inROI(threads[0]->pcState().instAddr());
+    }
+    pipeline->setInsertedToMain(fiInsertedToMain);
 }
 
 Addr
@@ -275,6 +343,21 @@ MinorCPU::takeOverFrom(BaseCPU *old_cpu)
     /* Don't think I need to do anything here */
 }
 
+void
+MinorCPU::retargetFault(uint64_t target, uint64_t target_reg)
+{
+    DPRINTF(MinorCPU, "Retargeting fault injection to: %d reg: %d\n",
+        target, target_reg);
+
+    pipeline->retargetFault(target, target_reg);
+}
+
+std::string
+MinorCPU::valueDivergence()
+{
+    return pipeline->valueDivergence();
+}
+
 void
 MinorCPU::activateContext(ThreadID thread_id)
 {
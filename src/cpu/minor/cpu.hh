@@ -49,7 +49,9 @@
 #include "cpu/minor/activity.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/base.hh"
+#include "cpu/fault_injector.hh"
 #include "cpu/simple_thread.hh"
+#include "sim/probe/probe.hh"
 #include "params/MinorCPU.hh"
 
 namespace Minor
@@ -58,6 +60,10 @@ namespace Minor
  *  pipeline and cpu */
 class Pipeline;
 
+/** Forward declared for the probe point argument types */
+class MinorDynInst;
+typedef RefCountingPtr<MinorDynInst> MinorDynInstPtr;
+
 /** Minor will use the SimpleThread state for now */
 typedef SimpleThread MinorThread;
 };
@@ -116,6 +122,10 @@ class MinorCPU : public BaseCPU
      *  draining is complete */
     DrainManager *drainManager;
 
+    /** Fault target and random choices for fault injection, shared by
+     *  all the stages */
+    FaultInjector *faultInjector;
+
   protected:
      /** Return a reference to the data port. */
     MasterPort &getDataPort();
@@ -142,6 +152,32 @@ class MinorCPU : public BaseCPU
     /** Stats interface from SimObject (by way of BaseCPU) */
     void regStats();
 
+    /** Pipeline probe points.  The dead-interval stats are gathered by a
+     *  listener on ExecuteOccupancy so that the stages only pay for an
+     *  occupancy snapshot when something is listening */
+    /** Execute's occupancy, once per Execute cycle */
+    ProbePointArg<Minor::ExecuteOccupancy> *ppExecuteOccupancy;
+    /** An instruction pushed into an FU pipeline */
+    ProbePointArg<Minor::MinorDynInstPtr> *ppIssue;
+    /** An instruction's memory request entering the LSQ */
+    ProbePointArg<Minor::MinorDynInstPtr> *ppLSQAllocate;
+    /** An instruction's memory request leaving the LSQ */
+    ProbePointArg<Minor::MinorDynInstPtr> *ppLSQFree;
+    /** An instruction committed by Execute */
+    ProbePointArg<Minor::MinorDynInstPtr> *ppCommit;
+
+    /** Probe interface from SimObject (by way of BaseCPU) */
+    void regProbePoints() M5_ATTR_OVERRIDE;
+
+  protected:
+    /** Listener feeding ppExecuteOccupancy to stats */
+    ProbeListenerArg<MinorCPU, Minor::ExecuteOccupancy> *occupancyListener;
+
+    void countOccupancy(const Minor::ExecuteOccupancy &occupancy)
+    { stats.countOccupancy(occupancy); }
+
+  public:
+
     /** Simple inst count interface from BaseCPU */
     Counter totalInsts() const;
     Counter totalOps() const;
@@ -166,6 +202,15 @@ class MinorCPU : public BaseCPU
     void switchOut();
     void takeOverFrom(BaseCPU *old_cpu);
 
+    /** Move the fault-injection target.  Exported to Python so that
+     *  forked campaign runs can each inject a different fault */
+    void retargetFault(uint64_t target, uint64_t target_reg);
+
+    /** The first divergence of this run's committed values from the
+     *  golden run's as a JSON object, or the empty string.  Exported to
+     *  Python for fault run records */
+    std::string valueDivergence();
+
     /** Thread activation interface from BaseCPU. */
     void activateContext(ThreadID thread_id);
     void suspendContext(ThreadID thread_id);
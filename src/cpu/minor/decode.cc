@@ -174,6 +174,7 @@ Decode::evaluate()
                     output_inst->pc = microopPC;
                     output_inst->staticInst = static_micro_inst;
                     output_inst->fault = NoFault;
+                    output_inst->fetchTick = inst->fetchTick;
 
                     /* Allow a predicted next address only on the last
                      *  microop */
@@ -273,6 +274,13 @@ Decode::evaluate()
     inputBuffer.pushTail();
 }
 
+bool
+Decode::canSkipEvaluate()
+{
+    return (*inp.outputWire).isBubble() &&
+        (!getInput() || !nextStageReserve.canReserve());
+}
+
 bool
 Decode::isDrained()
 {
@@ -124,6 +124,10 @@ class Decode : public Named
     /** Pass on input/buffer data to the output if you can */
     void evaluate();
 
+    /** Would evaluate() do nothing this cycle?  True when nothing
+     *  arrives and there's either no input or no space in Execute */
+    bool canSkipEvaluate();
+
     void minorTrace() const;
 
     /** Is this stage drained?  For Decoed, draining is initiated by
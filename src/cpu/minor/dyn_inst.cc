@@ -37,11 +37,15 @@
  * Authors: Andrew Bardsley
  */
 
+#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 
 #include "arch/isa.hh"
 #include "arch/registers.hh"
+#include "base/intmath.hh"
+#include "base/loader/region_map.hh"
+#include "base/misc.hh"
 #include "cpu/minor/dyn_inst.hh"
 #include "cpu/minor/trace.hh"
 #include "cpu/base.hh"
@@ -165,9 +169,7 @@ namespace Minor
 	static void
 		printRegNameminorRegAccess(std::ostringstream &regs_str, TheISA::RegIndex reg, bool isSource, const MinorDynInst* inst) //const MinorDynInstPtr inst)
 		{
-			std::string funcName="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
+			const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 			std::ostringstream os;
 			//os <<"  " << inst->staticInst->disassemble(0)<<":";
 
@@ -228,9 +230,7 @@ namespace Minor
 	static void
 		printRegNameFUs(std::ostringstream &regs_str, TheISA::RegIndex reg, bool isSource, const MinorDynInst* inst) //const MinorDynInstPtr inst)
 		{
-			std::string funcName="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
+			const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 			std::ostringstream os;
 			//os <<"  " << inst->staticInst->disassemble(0)<<":";
 
@@ -293,9 +293,7 @@ namespace Minor
 	static void
 		printRegNameBranchs(std::ostringstream &regs_str3, TheISA::RegIndex reg, bool isSource, const MinorDynInst* inst) //const MinorDynInstPtr inst)
 		{
-			std::string funcName="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
+			const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 			std::ostringstream os;
 			//os <<"  " << inst->staticInst->disassemble(0)<<":";
 
@@ -420,10 +418,9 @@ MinorDynInst::minorTraceInst(const Named &named_object) const
 void
 MinorDynInst::minorRegAccess() const
 {
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(this->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
+	/* Only tracing happens here, skip the register formatting and
+	 *  disassembly unless it's wanted */
+	if (DTRACE(RegFileAccess) && debugRegionMap.inROI(pc.instAddr()))
 	{
 		//DPRINTF(RegFileAccess,  "In function %s:Inst:%s\n", funcName, this->staticInst->disassemble(0));
 		//DPRINTF(RegFileAccess,  "In function %s\n", funcName);
@@ -475,10 +472,7 @@ MinorDynInst::minorRegAccess() const
 void
 MinorDynInst::minorFUregs() const
 {
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(this->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
+	if (DTRACE(FUsREG) && debugRegionMap.inROI(pc.instAddr()))
 	{
 		//DPRINTF(RegFileAccess,  "In function %s:Inst:%s\n", funcName, this->staticInst->disassemble(0));
 		//DPRINTF(RegFileAccess,  "In function %s\n", funcName);
@@ -522,11 +516,12 @@ i++;
 void
 MinorDynInst::minorBranchregs(MinorDynInstPtr lastInstBranchREG) const
 {
+	if (!DTRACE(CMPsREG) && !DTRACE(BranchsREG))
+		return;
+
 std::ostringstream regs_str2;
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(this->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
+	const std::string &funcName = debugRegionMap.name(this->pc.instAddr());
+	if (debugRegionMap.inROI(pc.instAddr()))
 	{
 		//DPRINTF(RegFileAccess,  "In function %s:Inst:%s\n", funcName, this->staticInst->disassemble(0));
 		//DPRINTF(RegFileAccess,  "In function %s\n", funcName);
@@ -568,4 +563,58 @@ MinorDynInst::~MinorDynInst()
 		delete traceData;
 }
 
+namespace
+{
+
+/** A free instruction slot */
+struct FreeInst
+{
+    FreeInst *next;
+};
+
+/** Slots are cache line aligned and carved from chunks of this many */
+const size_t InstLineSize = 64;
+const size_t InstsPerChunk = 64;
+
+__thread FreeInst *freeInsts = NULL;
+
+}
+
+void *
+MinorDynInst::operator new(size_t size)
+{
+    assert(size == sizeof(MinorDynInst));
+
+    if (!freeInsts) {
+        const size_t slot_size = roundUp(sizeof(MinorDynInst), InstLineSize);
+        void *chunk;
+        if (posix_memalign(&chunk, InstLineSize, slot_size * InstsPerChunk))
+            fatal("Can't allocate MinorDynInst pool chunk\n");
+
+        /* Chunks are never freed; their slots are recycled */
+        uint8_t *slots = static_cast<uint8_t *>(chunk);
+        for (size_t i = 0; i < InstsPerChunk; i++) {
+            FreeInst *slot = reinterpret_cast<FreeInst *>(
+                slots + i * slot_size);
+            slot->next = freeInsts;
+            freeInsts = slot;
+        }
+    }
+
+    FreeInst *slot = freeInsts;
+    freeInsts = slot->next;
+    return slot;
+}
+
+void
+MinorDynInst::operator delete(void *p)
+{
+    if (!p)
+        return;
+
+    FreeInst *slot = static_cast<FreeInst *>(p);
+    slot->next = freeInsts;
+    freeInsts = slot;
+}
+
 }
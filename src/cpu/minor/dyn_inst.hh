@@ -154,7 +154,10 @@ std::ostream &operator <<(std::ostream &os, const MinorDynInst &inst);
 /** Dynamic instruction for Minor.
  *  MinorDynInst implements the BubbleIF interface
  *  Has two separate notions of sequence number for pre/post-micro-op
- *  decomposition: fetchSeqNum and execSeqNum */
+ *  decomposition: fetchSeqNum and execSeqNum
+ *  Instances are allocated from a per-thread pool of cache line aligned
+ *  slots (see operator new), and the fields used by every stage come
+ *  first so that they share the slot's first lines */
 class MinorDynInst : public RefCounted
 {
   private:
@@ -164,13 +167,9 @@ class MinorDynInst : public RefCounted
 
   public:
  // std::ostringstream &regs_str3;
-    StaticInstPtr staticInst;
- StaticInstPtr lastInst_BranchREG;
-
     InstId id;
 
-    /** Trace information for this instruction's execution */
-    Trace::InstRecord *traceData;
+    StaticInstPtr staticInst;
 
     /** The fetch address of this instruction */
     TheISA::PCState pc;
@@ -178,6 +177,11 @@ class MinorDynInst : public RefCounted
     /** This is actually a fault masquerading as an instruction */
     Fault fault;
 
+ StaticInstPtr lastInst_BranchREG;
+
+    /** Trace information for this instruction's execution */
+    Trace::InstRecord *traceData;
+
     /** Tried to predict the destination of this inst (if a control
      *  instruction or a sys call) */
     bool triedToPredict;
@@ -227,16 +231,21 @@ class MinorDynInst : public RefCounted
     /** Effective address as set by ExecContext::setEA */
     Addr ea;
 
+    /** Ticks at which this instruction left Fetch2 and was issued (or
+     *  MaxTick if it hasn't been), for the MinorPipeTimeline */
+    Tick fetchTick;
+    Tick issueTick;
+
   public:
     MinorDynInst(InstId id_ = InstId(), Fault fault_ = NoFault) :
-        staticInst(NULL), lastInst_BranchREG(NULL), id(id_), traceData(NULL),
-        pc(TheISA::PCState(0)), fault(fault_),
+        id(id_), staticInst(NULL), pc(TheISA::PCState(0)), fault(fault_),
+        lastInst_BranchREG(NULL), traceData(NULL),
         triedToPredict(false), predictedTaken(false),
         fuIndex(0), inLSQ(false), inStoreBuffer(false),
         canEarlyIssue(false),
         instToWaitFor(0), extraCommitDelay(Cycles(0)),
         extraCommitDelayExpr(NULL), minimumCommitCycle(Cycles(0)),
-        ea(0)
+        ea(0), fetchTick(0), issueTick(MaxTick)
     {  /*regs_str3 << '0';*/ }
 
   public:
@@ -249,6 +258,14 @@ class MinorDynInst : public RefCounted
     /** Is this a fault rather than instruction */
     bool isFault() const { return fault != NoFault; }
 
+    /** Bits of this instruction held by a pipeline register: its machine
+     *  instruction and PC.  Used for latch liveness accounting */
+    unsigned int liveBits() const
+    {
+        return isBubble() ? 0 :
+            (sizeof(TheISA::ExtMachInst) + sizeof(TheISA::PCState)) * 8;
+    }
+
     /** Is this a real instruction */
     bool isInst() const { return !isBubble() && !isFault(); }
 
@@ -283,6 +300,13 @@ void minorBranchregs(MinorDynInstPtr lastInstBranchREG) const;
     void reportData(std::ostream &os) const;
 
     ~MinorDynInst();
+
+    /** Allocate from the calling thread's free list of instructions.
+     *  Every simulated thread only allocates its CPUs' instructions, so
+     *  the list settles at the number in flight in their pipelines and
+     *  needs no locking */
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
 };
 
 /** Print a summary of the instruction */
@@ -53,13 +53,15 @@
 #ifndef __CPU_MINOR_EXEC_CONTEXT_HH__
 #define __CPU_MINOR_EXEC_CONTEXT_HH__
 
+#include <cstring>
+
 #include "cpu/exec_context.hh"
 #include "cpu/minor/execute.hh"
 #include "cpu/minor/pipeline.hh"
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "debug/MinorExecute.hh"
-#include "base/loader/symtab.hh"
+#include "base/loader/region_map.hh"
 #include "debug/faultInjectionTrack.hh"
 #include "debug/RegFileAccess.hh"
 #include "debug/RegPointerFI.hh"
@@ -77,7 +79,7 @@ namespace Minor
 	 *  separates that interface from other classes such as Pipeline, MinorCPU
 	 *  and DynMinorInst and makes it easier to see what state is accessed by it.
 	 */
-	class ExecContext : public ::ExecContext
+	class ExecContext final : public ::ExecContext
 	{
 		public:
 			MinorCPU &cpu;
@@ -128,29 +130,49 @@ namespace Minor
 				}
 			bool inMain(const StaticInst *si)
 			{
-				std::string funcName;
-				Addr sym_addr;
-				debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
-				if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
-					return true;
-				return false;
+				return debugRegionMap.inROI(inst->pc.instAddr());
 			}
 
+			/** Record a fault event of this instruction in the fault
+			 *  trace */
+			void
+				traceFault(FaultTrace::Kind kind,
+						FaultTrace::Structure structure, unsigned int reg,
+						uint64_t old_value, uint64_t new_value)
+				{
+					execute.faultTrace.record(kind, structure,
+							inst->id.execSeqNum, inst->pc.instAddr(), reg,
+							old_value, new_value);
+				}
+
+			static uint64_t
+				floatBits(TheISA::FloatReg val)
+				{
+					TheISA::FloatRegBits bits;
+
+					static_assert(sizeof(bits) == sizeof(val),
+							"FloatReg and FloatRegBits differ in size");
+					std::memcpy(&bits, &val, sizeof(bits));
+					return bits;
+				}
+
 			IntReg
 				readIntRegOperand(const StaticInst *si, int idx)
-				{	//regsiter file
+				{
+					if (!USE_FI || !execute.fiEnabled)
+						return thread.readIntReg(si->srcRegIdx(idx));
+
+					//regsiter file
 					if (execute.faultIsInjected && execute.FItargetReg == si->srcRegIdx(idx) && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::INTEGER)
 					{
-						std::string funcName;
-						Addr sym_addr;
-						debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+						const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 						DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is reading faulty register %s\n which the faulty value is %s\n", funcName, inst->staticInst->disassemble(0), si->srcRegIdx(idx), thread.readIntReg(si->srcRegIdx(idx) ));
+						traceFault(FaultTrace::Read, FaultTrace::IntReg, si->srcRegIdx(idx), thread.readIntReg(si->srcRegIdx(idx)), thread.readIntReg(si->srcRegIdx(idx)));
 					}
 					// registers pointer in pipeline
 					else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == si->srcRegIdx(idx) && execute.pipelineRegisters)
 					{
-						srand (time(0));
-						int faultyIDX = rand()%(34); 
+						int faultyIDX = cpu.faultInjector->random(34); 
 						if(faultyIDX == 33) faultyIDX = NUM_INTREGS;
 						//srand (time(0));
 						//randBit = rand()%62;
@@ -158,42 +180,43 @@ namespace Minor
 						execute.faultIsInjected=true;
 
 						DPRINTF(RegPointerFI, "%s, ponits to I: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), static_cast<unsigned int>(si->srcRegIdx(idx)), static_cast<unsigned int>(faultyIDX));
+						traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->srcRegIdx(idx), si->srcRegIdx(idx), faultyIDX);
 						return thread.readIntReg(faultyIDX);
 
 					}
 					// FUs fault injection for ADDress calculation of memory operands
 					else if (!execute.faultIsInjected && ( execute.FItarget == execute.headOfInFlightInst || execute.FItarget == inst->id.execSeqNum)   && execute.FUsFI )
 					{
-						srand (time(0));
-						int faultyBIT = rand()%(32); 
+						int faultyBIT = cpu.faultInjector->random(32); 
 						int temp = pow (2, faultyBIT);
 						execute.faultIsInjected=true;
 						int faultyval = thread.readIntReg(si->srcRegIdx(idx)) xor temp; 
 if (faultyval < 0) faultyval= -faultyval;
 						DPRINTF(FUsREGfaultInjectionTrack, "%s: true FUs val was: %s\nBecause of faults in FUs registers now the value is %s\n", inst->staticInst->disassemble(0), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::FuValue, si->srcRegIdx(idx), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
 return faultyval;
 					}
 					// fault injection for branchs registers
 					else if (!execute.faultIsInjected && (execute.FItarget == execute.headOfInFlightInst ) /*&&  execute.FItargetReg == si->srcRegIdx(idx)*/ && execute.BranchsFI )
 					{
-						srand (time(0));
-						int faultyBIT = rand()%(32); 
+						int faultyBIT = cpu.faultInjector->random(32); 
 						int temp = pow (2, faultyBIT);
 						execute.faultIsInjected=true;
 						int faultyval = thread.readIntReg(si->srcRegIdx(idx)) xor temp; 
 
 						DPRINTF(BranchsREGfaultInjectionTrack, "%s: true Branch register val was: %s\nBecause of fault now the value is %s\n", inst->staticInst->disassemble(0), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::BranchReg, si->srcRegIdx(idx), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
 								thread.setIntReg(si->srcRegIdx(idx), faultyval);
 					}
 				else if (!execute.faultIsInjected && (execute.FItarget == execute.headOfInFlightInst ) /*&&  execute.FItargetReg == si->srcRegIdx(idx)*/ && execute.CMPsFI && !si->isLoad() && !si->isStore() )
 					{
-						srand (time(0));
-						int faultyBIT = rand()%(32); 
+						int faultyBIT = cpu.faultInjector->random(32); 
 						int temp = pow (2, faultyBIT);
 						execute.faultIsInjected=true;
 						int faultyval = thread.readIntReg(si->srcRegIdx(idx)) xor temp; 
 
 						DPRINTF(CMPsREGfaultInjectionTrack, "%s: true CMP register val was: %s\nBecause of fault now the value is %s\n", inst->staticInst->disassemble(0), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::CmpReg, si->srcRegIdx(idx), thread.readIntReg(si->srcRegIdx(idx)), faultyval);
 								return faultyval;
 					}
 				return thread.readIntReg(si->srcRegIdx(idx));
@@ -204,37 +227,39 @@ return faultyval;
 								readFloatRegOperand(const StaticInst *si, int idx)
 								{
 								int reg_idx = si->srcRegIdx(idx) - TheISA::FP_Reg_Base;
+								if (!USE_FI || !execute.fiEnabled)
+									return thread.readFloatReg(reg_idx);
+
 								//std::cout << "Inst: " << inst->staticInst->disassemble(0) << " reg_idx:" << reg_idx << "\n";
 								if (execute.faultIsInjected && execute.FItargetReg == reg_idx && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::FLOAT)
 								{
-								std::string funcName;
-								Addr sym_addr;
-								debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+								const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 								DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is reading faulty register %s\n which the faulty value is %s\n", funcName, inst->staticInst->disassemble(0), reg_idx, thread.readFloatReg(reg_idx));
+								traceFault(FaultTrace::Read, FaultTrace::FloatReg, si->srcRegIdx(idx), thread.readFloatRegBits(reg_idx), thread.readFloatRegBits(reg_idx));
 								}
 								// registers pointer in pipeline
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.pipelineRegisters)
 								{
-									srand (time(0));
-									int faultyIDX = rand()%(30); 
+									int faultyIDX = cpu.faultInjector->random(30); 
 									//srand (time(0));
 									//randBit = rand()%62;
 									//temp = pow (2, randBit);
 									execute.faultIsInjected=true;
 
 									DPRINTF(RegPointerFI, "%s: Idx(%s), ponits to F: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), reg_idx, static_cast<unsigned int>(reg_idx), static_cast<unsigned int>(faultyIDX));
+									traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->srcRegIdx(idx), si->srcRegIdx(idx), faultyIDX + TheISA::FP_Reg_Base);
 									return thread.readFloatReg(faultyIDX);
 
 								}
 					else if (!execute.faultIsInjected && (execute.FItarget == execute.headOfInFlightInst || execute.FItarget == inst->id.execSeqNum) /*&&  execute.FItargetReg == si->srcRegIdx(idx)*/ && execute.FUsFI )
 					{
-						srand (time(0));
-						int faultyBIT = rand()%(32); 
+						int faultyBIT = cpu.faultInjector->random(32); 
 						int temp = pow (2, faultyBIT);
 						execute.faultIsInjected=true;
 						int faultyval = int(thread.readFloatReg(reg_idx)) xor temp; 
 if (faultyval < 0) faultyval= -faultyval;
 						DPRINTF(FUsREGfaultInjectionTrack, "%s: true FUs val was: %s\nBecause of faults in FUs registers now the value is %s\n", inst->staticInst->disassemble(0), thread.readFloatReg(reg_idx), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::FuValue, si->srcRegIdx(idx), thread.readFloatRegBits(reg_idx), faultyval);
 return faultyval;
 					}
 
@@ -245,37 +270,38 @@ return faultyval;
 							readFloatRegOperandBits(const StaticInst *si, int idx)
 							{
 								int reg_idx = si->srcRegIdx(idx) - TheISA::FP_Reg_Base;
+								if (!USE_FI || !execute.fiEnabled)
+									return thread.readFloatRegBits(reg_idx);
 
 								if (execute.faultIsInjected && execute.FItargetReg == reg_idx && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::FLOAT)
 								{
-									std::string funcName;
-									Addr sym_addr;
-									debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+									const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 									DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is reading faulty register %s\n which the faulty value is %s\n", funcName, inst->staticInst->disassemble(0), reg_idx, thread.readFloatRegBits(reg_idx));
+									traceFault(FaultTrace::Read, FaultTrace::FloatReg, si->srcRegIdx(idx), thread.readFloatRegBits(reg_idx), thread.readFloatRegBits(reg_idx));
 								}
 								// registers pointer in pipeline
 								if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.pipelineRegisters)
 								{
-									srand (time(0));
-									int faultyIDX = rand()%(30); 
+									int faultyIDX = cpu.faultInjector->random(30); 
 									//srand (time(0));
 									//randBit = rand()%62;
 									//temp = pow (2, randBit);
 									execute.faultIsInjected=true;
 
 									DPRINTF(RegPointerFI, "%s: Idx(%s), ponits to F: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), reg_idx, static_cast<unsigned int>(reg_idx), static_cast<unsigned int>(faultyIDX));
+									traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->srcRegIdx(idx), si->srcRegIdx(idx), faultyIDX + TheISA::FP_Reg_Base);
 									return thread.readFloatRegBits(faultyIDX);
 
 								}
 					else if (!execute.faultIsInjected && (execute.FItarget == execute.headOfInFlightInst || execute.FItarget == inst->id.execSeqNum) /*&&  execute.FItargetReg == si->srcRegIdx(idx)*/ && execute.FUsFI )
 					{
-						srand (time(0));
-						int faultyBIT = rand()%(32); 
+						int faultyBIT = cpu.faultInjector->random(32); 
 						int temp = pow (2, faultyBIT);
 						execute.faultIsInjected=true;
 						int faultyval = int(thread.readFloatRegBits(reg_idx)) xor temp; 
 if (faultyval < 0) faultyval= -faultyval;
 						DPRINTF(FUsREGfaultInjectionTrack, "%s: true FUs val was: %s\nBecause of faults in FUs registers now the value is %s\n", inst->staticInst->disassemble(0), thread.readFloatRegBits(reg_idx), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::FuValue, si->srcRegIdx(idx), thread.readFloatRegBits(reg_idx), faultyval);
 return faultyval;
 					}
 								return thread.readFloatRegBits(reg_idx);
@@ -284,35 +310,37 @@ return faultyval;
 						void
 							setIntRegOperand(const StaticInst *si, int idx, IntReg val)
 							{
+								if (!USE_FI || !execute.fiEnabled) {
+									thread.setIntReg(si->destRegIdx(idx), val);
+									return;
+								}
 
 								if (execute.faultIsInjected && execute.FItargetReg == si->destRegIdx(idx) && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::INTEGER)
 								{
-									std::string funcName;
-									Addr sym_addr;
-									debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+									const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 									DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is overwritten the faulty register %s\n, which the faulty value was %s, with %s!\n", funcName, inst->staticInst->disassemble(0), si->destRegIdx(idx), thread.readIntReg(si->destRegIdx(idx)), val);
+									traceFault(FaultTrace::Overwrite, FaultTrace::IntReg, si->destRegIdx(idx), thread.readIntReg(si->destRegIdx(idx)), val);
 									execute.faultGetsMasked=true;
 
 								}
 								// registers pointer in pipeline
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == si->destRegIdx(idx) && execute.pipelineRegisters)
 								{
-									srand (time(0));
-									int faultyIDX = rand()%(34); 
+									int faultyIDX = cpu.faultInjector->random(34); 
 									if(faultyIDX == 33) faultyIDX = NUM_INTREGS;
 									//randBit = rand()%62;
 									//temp = pow (2, randBit);
 									execute.faultIsInjected=true;
 
 									DPRINTF(RegPointerFI, "%s: Idx(%s), ponits to I: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), idx, static_cast<unsigned int>(si->destRegIdx(idx)), static_cast<unsigned int>(faultyIDX));
+									traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->destRegIdx(idx), si->destRegIdx(idx), faultyIDX);
 									thread.setIntReg(faultyIDX, val);
 									return;
 
 								}
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == si->destRegIdx(idx) && execute.FUsFI && false)
 								{
-									srand (time(0));
-									int faultyBIT = rand()%(32); 
+									int faultyBIT = cpu.faultInjector->random(32); 
 									int temp = pow (2, faultyBIT);
 									execute.faultIsInjected=true;
 									int faultyval = val xor temp; 
@@ -330,36 +358,37 @@ if (faultyval < 0) faultyval= -faultyval;
 									TheISA::FloatReg val)
 							{
 								int reg_idx = si->destRegIdx(idx) - TheISA::FP_Reg_Base;
-
+								if (!USE_FI || !execute.fiEnabled) {
+									thread.setFloatReg(reg_idx, val);
+									return;
+								}
 
 								if (execute.faultIsInjected && execute.FItargetReg == reg_idx && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::FLOAT) 
 								{
-									std::string funcName;
-									Addr sym_addr;
-									debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+									const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 									DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is overwritten the faulty register %s\n which the faulty value was %s, with %s!\n", funcName, inst->staticInst->disassemble(0), reg_idx, thread.readFloatReg(reg_idx), val);
+									traceFault(FaultTrace::Overwrite, FaultTrace::FloatReg, si->destRegIdx(idx), thread.readFloatRegBits(reg_idx), floatBits(val));
 									execute.faultGetsMasked=true;
 
 								}
 								// registers pointer in pipeline
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.pipelineRegisters)
 								{
-									srand (time(0));
-									int faultyIDX = rand()%(NUM_INTREGS); 
+									int faultyIDX = cpu.faultInjector->random(NUM_INTREGS); 
 									//srand (time(0));
 									//randBit = rand()%62;
 									//temp = pow (2, randBit);
 									execute.faultIsInjected=true;
 
 									DPRINTF(RegPointerFI, "%s: Idx(%s), ponits to F: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), idx, static_cast<unsigned int>(reg_idx), static_cast<unsigned int>(faultyIDX));
+									traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->destRegIdx(idx), si->destRegIdx(idx), faultyIDX + TheISA::FP_Reg_Base);
 									thread.setFloatReg(faultyIDX, val);
 									return;
 
 								}
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.FUsFI && false)
 								{
-									srand (time(0));
-									int faultyBIT = rand()%(32); 
+									int faultyBIT = cpu.faultInjector->random(32); 
 									TheISA::FloatReg temp = pow (2, faultyBIT);
 									execute.faultIsInjected=true;
 									TheISA::FloatReg faultyval = (long)val xor (long)temp; 
@@ -378,27 +407,30 @@ if (faultyval < 0) faultyval= -faultyval;
 							{
 
 								int reg_idx = si->destRegIdx(idx) - TheISA::FP_Reg_Base;
+								if (!USE_FI || !execute.fiEnabled) {
+									thread.setFloatRegBits(reg_idx, val);
+									return;
+								}
 								//std::cout << "Inst, " << inst->staticInst->disassemble(0) << " idx, " << idx<< " reg_idx, " << reg_idx << "\n";
 								if (execute.faultIsInjected && execute.FItargetReg == reg_idx && !execute.faultGetsMasked && execute.FItargetRegClass == Execute::regClass::FLOAT) 
 								{
-									std::string funcName;
-									Addr sym_addr;
-									debugSymbolTable->findNearestSymbol(inst->pc.instAddr(), funcName, sym_addr);
+									const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
 									DPRINTF(faultInjectionTrack, "In Function: %s instruction  %s is overwritten the faulty register %s\n which the faulty value was %s, with %s!\n", funcName, inst->staticInst->disassemble(0), reg_idx, thread.readFloatRegBits(reg_idx), val);
+									traceFault(FaultTrace::Overwrite, FaultTrace::FloatReg, si->destRegIdx(idx), thread.readFloatRegBits(reg_idx), val);
 									execute.faultGetsMasked=true;
 
 								}
 								// registers pointer in pipeline
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.pipelineRegisters)
 								{
-									srand (time(0));
-									int faultyIDX = rand()%(NUM_INTREGS); 
+									int faultyIDX = cpu.faultInjector->random(NUM_INTREGS); 
 									//srand (time(0));
 									//randBit = rand()%62;
 									//temp = pow (2, randBit);
 									execute.faultIsInjected=true;
 
 									DPRINTF(RegPointerFI, "%s: Idx(%s), ponits to F: %s\nBecause of faults in pipeline registers now it ponits to %s\n", inst->staticInst->disassemble(0), idx, static_cast<unsigned int>(reg_idx), static_cast<unsigned int>(faultyIDX));
+									traceFault(FaultTrace::Inject, FaultTrace::RegPointer, si->destRegIdx(idx), si->destRegIdx(idx), faultyIDX + TheISA::FP_Reg_Base);
 									thread.setFloatRegBits(faultyIDX, val);
 									return;
 
@@ -406,8 +438,7 @@ if (faultyval < 0) faultyval= -faultyval;
 								//FUs fault injection
 								else if (!execute.faultIsInjected && execute.FItarget == execute.headOfInFlightInst &&  execute.FItargetReg == reg_idx && execute.FUsFI && false)
 								{
-									srand (time(0));
-									int faultyBIT = rand()%(32); 
+									int faultyBIT = cpu.faultInjector->random(32); 
 									TheISA::FloatReg temp = pow (2, faultyBIT);
 									execute.faultIsInjected=true;
  									TheISA::FloatReg faultyval = (long)val xor (long)temp; 
@@ -527,6 +558,8 @@ if (faultyval < 0) faultyval= -faultyval;
 							readCCRegOperand(const StaticInst *si, int idx)
 							{
 								int reg_idx = si->srcRegIdx(idx) - TheISA::CC_Reg_Base;
+								if (!USE_FI || !execute.fiEnabled)
+									return thread.readCCReg(reg_idx);
 
 					if (!execute.faultIsInjected && (execute.FItarget == execute.headOfInFlightInst ) && execute.BranchsFI && execute.FItargetReg ==  reg_idx)
 					{
@@ -537,6 +570,7 @@ if (faultyval < 0) faultyval= -faultyval;
 						int faultyval = !thread.readCCReg(reg_idx); 
 
 						DPRINTF(BranchsREGfaultInjectionTrack, "%s: true CC Branch register val was: %s\nBecause of fault now the value is %s\n", inst->staticInst->disassemble(0), thread.readCCReg(reg_idx), faultyval);
+						traceFault(FaultTrace::Inject, FaultTrace::BranchReg, si->srcRegIdx(idx), thread.readCCReg(reg_idx), faultyval);
 								thread.setCCReg(reg_idx, faultyval);
 					}
 
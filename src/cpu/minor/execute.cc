@@ -64,10 +64,16 @@
 #include "debug/BranchsREGfaultInjectionTrack.hh"
 #include "debug/CMPsREGfaultInjectionTrack.hh"
 #include "debug/UnnecInst.hh"
+#include "sim/guest_roi.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stats_region.hh"
+#include "sim/trace_window.hh"
 
 namespace Minor
 {
 
+	enum Aarch64 {X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15, X16, X17, X18, X19, X20, X21, X22, X23, X24, X25, X26, X27, X28, X29, X30, SP=43 , XZR=31 };
+
 	Execute::Execute(const std::string &name_,
 			MinorCPU &cpu_,
 			MinorCPUParams &params,
@@ -96,12 +102,22 @@ namespace Minor
 				params.executeLSQTransfersQueueSize,
 				params.executeLSQStoreBufferSize,
 				params.executeLSQMaxStoreBufferStoresPerCycle),
-		scoreboard(name_ + ".scoreboard"),
+		scoreboard(name_ + ".scoreboard", *cpu_.faultInjector),
 		FItarget(params.FItarget), //Fault injection
 		FItargetReg(params.FItargetReg), //Fault injection
 		MaxTick(params.MaxTick), //Fault injection
+		fiEnabled(USE_FI && params.FItarget != 0),
+		guestMarkers(params.guestMarkers),
 		enableSWIFT(params.enableSWIFTR),
 		enableZDC(params.enableZDCR),
+		redundantDestMask(0),
+		redundantSrcMask(0),
+		convergence(name_ + ".convergence", params),
+		valueTrace(name_ + ".valueTrace", params),
+		taint(name_ + ".taint", cpu_.cacheLineSize()),
+		ace(name_ + ".ace", params),
+		protection(name_ + ".protection", params),
+		faultTrace(name_ + ".faultTrace", params.faultTrace),
 		inputBuffer(name_ + ".inputBuffer", "insts",
 				params.executeInputBufferSize),
 		inputIndex(0),
@@ -111,6 +127,30 @@ namespace Minor
 		lastPredictionSeqNum(InstId::firstPredictionSeqNum),
 		drainState(NotDraining)
 	{
+		/* Copies go from a master register (an X register or SP) to a
+		 *  slave, any X register not in the master set */
+		const uint64_t x_regs = ULL(0xffffffff);
+		const uint64_t master_regs = x_regs | (ULL(1) << Aarch64::SP);
+
+		if (enableSWIFT) {
+			redundantDestMask |= x_regs & ~params.swiftMasterRegs;
+			redundantSrcMask |= master_regs & params.swiftMasterRegs;
+		}
+		if (enableZDC) {
+			redundantDestMask |= x_regs & ~params.zdcMasterRegs;
+			redundantSrcMask |= master_regs & params.zdcMasterRegs;
+		}
+
+		if (!USE_FI && params.FItarget != 0) {
+			fatal("%s: FItarget is set but fault injection is only"
+					" built into gem5.fi and gem5.debug\n", name_);
+		}
+
+		/* Scoreboard faults hit a random field and bit of the first
+		 *  destination of the target instruction */
+		if (ScoreboardFI && fiEnabled)
+			scoreboard.armFault(FItarget);
+
 		if (commitLimit < 1) {
 			fatal("%s: executeCommitLimit must be >= 1 (%d)\n", name_,
 					commitLimit);
@@ -164,6 +204,8 @@ namespace Minor
 			funcUnits.push_back(fu);
 		}
 
+		occupancy.fuBusy.resize(numFuncUnits, false);
+
 		/** Check that there is a functional unit for all operation classes */
 		for (int op_class = No_OpClass + 1; op_class < Num_OpClass; op_class++) {
 			bool found_fu = false;
@@ -252,24 +294,23 @@ namespace Minor
 
 
 
-				std::string funcName="nothing";
-				Addr sym_addr;
-				debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-				if(inst->staticInst->isControl() && ( (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C') || funcName == "main") )
+				const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
+				if(inst->staticInst->isControl() && debugRegionMap.inROI(inst->pc.instAddr()))
 					DPRINTF(MainPCs, "Func: %s Inst: %s PC:%s:----LastInt:%s\n", funcName, inst->staticInst->disassemble(0), inst->pc.instAddr(),lastInst->staticInst->disassemble(0));
 
 
 
 
 				///////////working area for fault injection on PC
+				Addr truePC = 0;
 				if( !faultIsInjected && (FItargetReg == 1001) && (curTick() == FItarget) && must_branch )
 				{
 
 					faultIsInjected=true;
-					srand (time(0));
-					int randBit = rand()%500;
+					int randBit = cpu.faultInjector->random(500);
 
 					DPRINTF(PCFaultInjectionTrack, "FUNC:%s	Inst:%s: True Pc of Inst was PC:%s\n",funcName, inst->staticInst->disassemble(0), target.instAddr());
+					truePC = target.instAddr();
 					while(randBit)
 					{
 						TheISA::advancePC(target, inst->staticInst);
@@ -283,7 +324,12 @@ namespace Minor
 				thread->pcState(target);
 				////////////s
 				if(faultIsInjected && (FItargetReg == 1001) && (curTick() == FItarget) && must_branch)
+				{
 					DPRINTF(PCFaultInjectionTrack, "FUNC:%s Inst:%s: Faulty Pc of Inst is PC:%s\n",funcName, inst->staticInst->disassemble(0), target.instAddr() );
+					faultTrace.record(FaultTrace::Inject, FaultTrace::Pc,
+							inst->id.execSeqNum, inst->pc.instAddr(), 0,
+							truePC, target.instAddr());
+				}
 				if(faultIsInjected && (FItargetReg == 1001) && (curTick() <= FItarget + 100000 ))
 					DPRINTF(PCFaultInjectionTrack, "Funct: %s Following Inst:%s: PC:%s\n",funcName, inst->staticInst->disassemble(0),inst->pc.instAddr());
 				//////////////e
@@ -437,6 +483,11 @@ namespace Minor
 				fault = inst->staticInst->completeAcc(packet, &context,
 						inst->traceData);
 
+				if (taint.active() && thread_id == 0) {
+					taint.memAccess(response->request.getVaddr(),
+						packet->getSize());
+				}
+
 				if (fault != NoFault) {
 					/* Invoke fault created by instruction completion */
 					DPRINTF(MinorMem, "Fault in memory completeAcc: %s\n",
@@ -445,8 +496,21 @@ namespace Minor
 				} else {
 					/* Stores need to be pushed into the store buffer to finish
 					 *  them off */
-					if (response->needsToBeSentToStoreBuffer())
+					if (response->needsToBeSentToStoreBuffer()) {
+						if (convergence.enabled()) {
+							convergence.recordStore(
+								response->request.getVaddr(),
+								packet->getSize(),
+								packet->getConstPtr<uint8_t>());
+						}
+						if (valueTrace.enabled() && thread_id == 0) {
+							valueTrace.recordStore(
+								response->request.getVaddr(),
+								packet->getSize(),
+								packet->getConstPtr<uint8_t>());
+						}
 						lsq.sendStoreToStoreBuffer(response);
+					}
 				}
 			} else {
 				fatal("There should only ever be reads, "
@@ -675,7 +739,9 @@ namespace Minor
 							/* Mark the destinations for this instruction as
 							 *  busy */
 							scoreboard.markupInstDests(inst, cpu.curCycle() +
-									Cycles(0), cpu.getContext(thread_id), false, ScoreboardFI, FItarget);
+									Cycles(0), cpu.getContext(thread_id), false);
+							if (scoreboard.faultPending(inst->id.execSeqNum))
+								scoreboard.injectFault(inst);
 
 							inst->fuIndex = noCostFUIndex;
 							inst->extraCommitDelay = Cycles(0);
@@ -795,6 +861,12 @@ namespace Minor
 
 								/* Issue to FU */
 								fu->push(fu_inst);
+								inst->issueTick = curTick();
+								if (protection.enabled() && inMain(inst)) {
+									protection.issueInst(protectionClass(inst),
+										fu->description.issueLat);
+								}
+								cpu.ppIssue->notify(inst);
 								/* And start the countdown on activity to allow
 								 *  this instruction to get to the end of its FU */
 								cpu.activityRecorder->activity();
@@ -806,7 +878,9 @@ namespace Minor
 										extra_dest_retire_lat +
 										extra_assumed_lat,
 										cpu.getContext(thread_id),
-										issued_mem_ref && extra_assumed_lat == Cycles(0), ScoreboardFI, FItarget);
+										issued_mem_ref && extra_assumed_lat == Cycles(0));
+								if (scoreboard.faultPending(inst->id.execSeqNum))
+									scoreboard.injectFault(inst);
 
 								/* Push the instruction onto the inFlight queue so
 								 *  it can be committed in order */
@@ -903,76 +977,26 @@ namespace Minor
 		}
 	bool Execute::inMain(MinorDynInstPtr inst)
 	{
-		std::string funcName="nothing";
-		Addr sym_addr;
-		debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-		if(( (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C') || funcName == "main") )
-			return true;
-		return false;
+		if (guestMarkers) {
+			return guestROI.inROI(
+				cpu.getContext(inst->id.threadId)->contextId());
+		}
 
-	}
+		return debugRegionMap.inROI(inst->pc.instAddr());
 
-	enum Aarch64 {X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15, X16, X17, X18, X19, X20, X21, X22, X23, X24, X25, X26, X27, X28, X29, X30, SP=43 , XZR=31 };
-	bool Execute::isSWIFTMasterReg(int reg)
-	{
-		if (reg == Aarch64::X0 || reg == Aarch64::X1 || reg == Aarch64::X2 || reg == Aarch64::X19 || reg == Aarch64::X20 || reg == Aarch64::X23 || reg == Aarch64::X24 || reg == Aarch64::X29 || reg == Aarch64::X30 || reg == Aarch64::SP) return true;
-		return false;
-	}
-	bool Execute::isSWIFTSlaveReg(int reg)
-	{
-		if (isSWIFTMasterReg(reg)) return false;
-		return true;
-	}
-	bool Execute::isZDCMasterReg(int reg)
-	{
-		if (reg == Aarch64::X0 || reg == Aarch64::X1 || reg == Aarch64::X2 || reg == Aarch64::X3 || reg == Aarch64::X4 || reg == Aarch64::X5 || reg == Aarch64::X19 || reg == Aarch64::X20 || reg == Aarch64::X23 || reg == Aarch64::X24 || reg == Aarch64::X28 ||  reg == Aarch64::X29 || reg == Aarch64::X30 || reg == Aarch64::SP) return true;
-		return false;
-	}
-	bool Execute::isZDCSlaveReg(int reg)
-	{
-		if (isZDCMasterReg(reg)) return false;
-		return true;
 	}
+
 	bool Execute::isUnnecessaryInst(MinorDynInstPtr inst)
 	{
-		bool desIsSlave=false;
-		bool srcIsMaster=false;
-		bool oneSrcIsZR=false;
-		if (enableSWIFT && inMain(inst) ){
-			unsigned int num_src_regs = inst->staticInst->numSrcRegs();
-			unsigned int num_dest_regs = inst->staticInst->numDestRegs();
-			unsigned int src_reg = 0, des_reg = 0;
-			while (des_reg < num_dest_regs  && (inst->staticInst->getName() == "sub") ) {
-				if (isSWIFTSlaveReg(inst->staticInst->destRegIdx(des_reg)) && inst->staticInst->destRegIdx(des_reg) < 32) {desIsSlave=true; }
-				des_reg++;
-			}
-			while (src_reg < num_src_regs  && (inst->staticInst->getName() == "sub") ) {
-				if (isSWIFTMasterReg(inst->staticInst->srcRegIdx(src_reg)) && (inst->staticInst->srcRegIdx(src_reg) < 32 || inst->staticInst->srcRegIdx(src_reg) == Aarch64::SP)) {srcIsMaster=true; }
-				if (inst->staticInst->srcRegIdx(src_reg) == Aarch64::XZR) {oneSrcIsZR=true; }
-				src_reg++;
-			}
-
+		const StaticInstPtr &static_inst = inst->staticInst;
 
-		}
-		if (enableZDC && inMain(inst) ){
-			unsigned int num_src_regs = inst->staticInst->numSrcRegs();
-			unsigned int num_dest_regs = inst->staticInst->numDestRegs();
-			unsigned int src_reg = 0, des_reg = 0;
-			while (des_reg < num_dest_regs  && (inst->staticInst->getName() == "sub") ) {
-				if (isZDCSlaveReg(inst->staticInst->destRegIdx(des_reg)) && inst->staticInst->destRegIdx(des_reg) < 32) {desIsSlave=true; }
-				des_reg++;
-			}
-			while (src_reg < num_src_regs  && (inst->staticInst->getName() == "sub")) {
-				if (isZDCMasterReg(inst->staticInst->srcRegIdx(src_reg)) && (inst->staticInst->srcRegIdx(src_reg) < 32 || inst->staticInst->srcRegIdx(src_reg) == Aarch64::SP)) {srcIsMaster=true; }
-				if (inst->staticInst->srcRegIdx(src_reg) == Aarch64::XZR) {oneSrcIsZR=true; }
-				src_reg++;
-			}
-
-
-		}
-		if (desIsSlave && srcIsMaster && oneSrcIsZR )
-			return true;
-		return false;
+		/* The operand masks are cached in the StaticInst so nearly all
+		 *  instructions are rejected by the first test */
+		return static_inst->isSubInst() &&
+			(static_inst->destRegMask() & redundantDestMask) &&
+			(static_inst->srcRegMask() & redundantSrcMask) &&
+			(static_inst->srcRegMask() & (ULL(1) << Aarch64::XZR)) &&
+			inMain(inst);
 
 	}
 
@@ -1024,6 +1048,35 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 
 			MinorThread *thread = cpu.threads[inst->id.threadId];
 
+			/* Propagate the taint of injected faults before any new fault
+			 *  is injected as this instruction commits */
+			if (taint.active() && inst->id.threadId == 0)
+				taint.commitInst(inst->staticInst, inst->pc.instAddr());
+
+			Counter ace_cycles = 0;
+			if (ace.enabled() && inst->id.threadId == 0) {
+				ace_cycles = ace.commitInst(inst->staticInst,
+					inst->pc.instAddr(), cpu.curCycle());
+			}
+
+			if (protection.enabled() && inst->id.threadId == 0) {
+				bool in_roi = inMain(inst);
+				Cycles lsq_cycles(0);
+
+				if (in_roi && inst->isMemRef() && inst->issueTick != MaxTick)
+					lsq_cycles = cpu.ticksToCycles(curTick() - inst->issueTick);
+				protection.commitInst(
+					in_roi ? protectionClass(inst) : ProtectionEval::Original,
+					in_roi, cpu.curCycle(), lsq_cycles, ace_cycles);
+			}
+
+			if (valueTrace.enabled() && inst->id.threadId == 0 &&
+				valueTrace.commitInst(inst, cpu.getContext(0)))
+			{
+				DPRINTF(faultInjectionTrack, "Committed values diverged from"
+					" golden run at inst: %s\n", *inst);
+			}
+
 			/* Increment the many and various inst and op counts in the
 			 *  thread and system */
 			if (!inst->staticInst->isMicroop() || inst->staticInst->isLastMicroop())
@@ -1031,11 +1084,28 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 				thread->numInst++;
 				thread->numInsts++;
 				cpu.stats.numInsts++;
+				unsigned int func_index =
+					cpu.stats.funcIndex(inst->pc.instAddr());
+				cpu.stats.committedInstsFunc[func_index]++;
 				if((enableSWIFT || enableZDC) && isUnnecessaryInst(inst))
 					{
 					cpu.stats.numUnnecessaryInst++;
+					cpu.stats.unnecessaryInstsFunc[func_index]++;
 					DPRINTF(UnnecInst, "%s\n", inst->staticInst->disassemble(0));
 					}
+				/* The only cost of the fault injector when it has no
+				 *  pending seqnum trigger */
+				if (cpu.faultInjector->armed())
+					cpu.faultInjector->commit(inst->id.execSeqNum);
+
+				if (convergence.enabled() &&
+					convergence.commitInst(cpu.threads[inst->id.threadId],
+						faultIsInjected || scoreboard.faultIsInjected))
+				{
+					DPRINTF(faultInjectionTrack, "Fault masked: state"
+						" converged with golden run at inst: %s\n", *inst);
+					exitSimLoop("fault masked");
+				}
 			}
 			thread->numOp++;
 			thread->numOps++;
@@ -1053,6 +1123,13 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 				inst->traceData->setCPSeq(thread->numOp);
 
 			cpu.probeInstCommit(inst->staticInst);
+			cpu.ppCommit->notify(inst);
+			if (cpu.ppCommitPC->hasListeners()) {
+				cpu.ppCommitPC->notify(std::make_pair(
+					inst->pc.instAddr(), inst->staticInst));
+			}
+			Trace::windowCommit(inst->pc.instAddr());
+			statsRegionCommit(inst->pc.instAddr());
 		}
 
 	bool
@@ -1257,12 +1334,8 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 				//if (!(inst->staticInst->isControl()))
 				//lastInst_BranchREG = inst;
 				/////////////////fault injection of pipeline registers
-				std::string funcName="nothing";
-				Addr sym_addr;
-				debugSymbolTable->findNearestSymbol(head_inflight_inst->inst->pc.instAddr() , funcName, sym_addr);
+				const std::string &funcName = debugRegionMap.name(head_inflight_inst->inst->pc.instAddr());
 				headOfInFlightInst = head_inflight_inst->inst->id.execSeqNum;
-//moslem
-//head_inflight_inst->inst->staticInst->debugEnd = FItarget + 100000;
 				if(!test && FItarget == headOfInFlightInst && FUsFI)
 				{
 					DPRINTF(RegPointerFI, "FUNC= %s\nTarget instruction for pipeline registers fault injection is %s\n",funcName, head_inflight_inst->inst->staticInst->disassemble(0));
@@ -1810,171 +1883,77 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 			inputBuffer.pushTail();
 
 			////////////////Fault injection: get the main tickes////////////////////////////////////////////////////////
-			//bool inMain=false;
-			std::string sym_str="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(cpu.getContext(0)->instAddr() , sym_str, sym_addr);
+			/* Every build tracks main and the ROI for the ROI stats and
+			 *  the occupancy snapshot; only the injection below needs
+			 *  gem5.fi.  With guest markers fi_arm stands for reaching
+			 *  main and the ROI is a flag, so there is no lookup at all */
+			const RegionMap::Region *region = !guestMarkers ?
+				debugRegionMap.lookup(cpu.getContext(0)->instAddr()) : NULL;
+			bool in_roi;
 
-			if ( /*(sym_str[0] == 'F' &&  sym_str[1] == 'U' && sym_str[2] == 'N' && sym_str[3] == 'C' )*/ !insertedTomain && sym_str == "main" ){
-				//inMain=true;
+			if (guestMarkers) {
+				int ctx = cpu.getContext(0)->contextId();
 
-				insertedTomain=true;
-				funcName=sym_str;
-			}
-			if (MaxTick && (curTick() > MaxTick))
-			{
-				DPRINTF(faultInjectionTrack, "Some this is wrong! Execution takes too long");
-				if (FItarget) 
-				{
-					fatal("%s: EXIT, too long!!! \n",curTick() );
+				if (!insertedTomain && guestROI.fiArmed(ctx))
+					insertedTomain = true;
+
+				in_roi = guestROI.inROI(ctx);
+			} else {
+				if (!insertedTomain && region && region->isMain()) {
+					insertedTomain=true;
+					roiFunc=region->start;
+					lastPlace=roiFunc;
 				}
+
+				in_roi = insertedTomain && region && region->inROI();
 			}
 
-			if(insertedTomain && ((sym_str[0] == 'F' &&  sym_str[1] == 'U' && sym_str[2] == 'N' && sym_str[3] == 'C') || sym_str == "main" ))
+			if (in_roi && !region)
+				cpu.stats.tickCyclesMain++;
+
+			if (in_roi && region)
 			{
 
 				//////
 				// moslem for printing out the program control flow
-				if ( funcName !=  lastPlace)
+				if ( roiFunc !=  lastPlace)
 				{
-					DPRINTF(printCF, "%d -> %s \n",counter, funcName);
+					DPRINTF(printCF, "%d -> %s \n",counter,
+						debugRegionMap.name(roiFunc));
 					counter++;
-					lastPlace=funcName;
+					lastPlace=roiFunc;
 				}
 				///////////////////
 
-				DPRINTF(TickMain, "FunctionaName:=%s\n",sym_str );
+				DPRINTF(TickMain, "FunctionaName:=%s\n",
+					debugRegionMap.name(region));
 				cpu.stats.tickCyclesMain++;
-				funcName=sym_str;
-				///// dead interval evalution
-				int numberInstinIQ=inputBuffer.getSizeBuffer();
-				int numberEntriesinLSQ=lsq.numValidEntriesInLSQQueues();
+				if (region->funcId < cpu.stats.tickCyclesFunc.size())
+					cpu.stats.tickCyclesFunc[region->funcId]++;
+				roiFunc=region->start;
+			}
 
-				if (need_to_tick || true)
-				{
-					FUPipeline *fu0 = funcUnits[0];
-					if(fu0->alreadyPushed() || !fu0->canInsert() || fu0->stalled)
-						cpu.stats.FU0isBusy++;
-					FUPipeline *fu1 = funcUnits[1];
-					if(fu1->alreadyPushed() || !fu1->canInsert() || fu1->stalled)
-						cpu.stats.FU1isBusy++;
-					FUPipeline *fu2 = funcUnits[2];
-					if(fu2->alreadyPushed() || !fu2->canInsert() || fu2->stalled)
-						cpu.stats.FU2isBusy++;
-					FUPipeline *fu3 = funcUnits[3];
-					if(fu3->alreadyPushed() || !fu3->canInsert() || fu3->stalled)
-						cpu.stats.FU3isBusy++;
-					FUPipeline *fu4 = funcUnits[4];
-					if(fu4->alreadyPushed() || !fu4->canInsert() || fu4->stalled)
-						cpu.stats.FU4isBusy++;
-					FUPipeline *fu5 = funcUnits[5];
-					if(fu5->alreadyPushed() || !fu5->canInsert() || fu5->stalled)
-						cpu.stats.FU5isBusy++;
-					FUPipeline *fu6 = funcUnits[6];
-					if(fu6->alreadyPushed() || !fu6->canInsert() || fu6->stalled)
-						cpu.stats.FU6isBusy++;
-					switch (numberInstinIQ)
-					{
-						case 0:
-							{
-								cpu.stats.Inst0InIQ++;
-								break;
-							}
-						case 1:
-							{
-								cpu.stats.Inst1InIQ++;
-								break;
-							}
-						case 2:
-							{
-								cpu.stats.Inst2InIQ++;
-								break;
-							}
-						case 3:
-							{
-								cpu.stats.Inst3InIQ++;
-								break;
-							}
-						case 4:
-							{
-								cpu.stats.Inst4InIQ++;
-								break;
-							}
-						case 5:
-							{
-								cpu.stats.Inst5InIQ++;
-								break;
-							}
-						case 6:
-							{
-								cpu.stats.Inst6InIQ++;
-								break;
-							}
-						case 7:
-							{
-								cpu.stats.Inst7InIQ++;
-								break;
-							}
+			/* Occupancy snapshot for the ExecuteOccupancy probe.  The
+			 *  dead-interval stats are one listener on it */
+			if (cpu.ppExecuteOccupancy->hasListeners()) {
+				occupancy.inputInsts = inputBuffer.getSizeBuffer();
+				occupancy.lsqEntries = lsq.numValidEntriesInLSQQueues();
 
-					}
-					switch (numberEntriesinLSQ)
-					{
-						case 0:
-							{
-								cpu.stats.Inst0InLSQ++;
-								break;
-							}
-						case 1:
-							{
-								cpu.stats.Inst1InLSQ++;
-								break;
-							}
-						case 2:
-							{
-								cpu.stats.Inst2InLSQ++;
-								break;
-							}
-						case 3:
-							{
-								cpu.stats.Inst3InLSQ++;
-								break;
-							}
-						case 4:
-							{
-								cpu.stats.Inst4InLSQ++;
-								break;
-							}
-						case 5:
-							{
-								cpu.stats.Inst5InLSQ++;
-								break;
-							}
-						case 6:
-							{
-								cpu.stats.Inst6InLSQ++;
-								break;
-							}
-						case 7:
-							{
-								cpu.stats.Inst7InLSQ++;
-								break;
-							}
-						case 8:
-							{
-								cpu.stats.Inst8InLSQ++;
-								break;
-							}
+				for (unsigned int i = 0; i < numFuncUnits; i++) {
+					FUPipeline *fu = funcUnits[i];
 
-					}
+					occupancy.fuBusy[i] = fu->alreadyPushed() ||
+						!fu->canInsert() || fu->stalled;
 				}
+				occupancy.inROI = in_roi;
 
-				/////////////////////
-
+				cpu.ppExecuteOccupancy->notify(occupancy);
 			}
 
 
 			//////////////////////////Inject fault in register file
-			if (FItarget == curTick() && insertedTomain && !faultIsInjected )
+			if (USE_FI && FItarget == curTick() && insertedTomain &&
+				!faultIsInjected)
 			{
 
 				//std::cout << "TheISA::Max_Reg_Index: "<< TheISA::Max_Reg_Index << "\n";
@@ -1987,10 +1966,8 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 					while(!FItargetRegClass)
 					{
 
-						srand (time(0));
-						FItargetReg = rand()%(NUM_INTREGS); 
-						srand (time(0));
-						randBit = rand()%62;
+						FItargetReg = cpu.faultInjector->random(NUM_INTREGS); 
+						randBit = cpu.faultInjector->random(62);
 						temp = pow (2, randBit);
 						if(FItargetReg == 33) FItargetReg = NUM_INTREGS;
 
@@ -2003,10 +1980,8 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 					while(!FItargetRegClass)
 					{
 
-						srand (time(0));
-						FItargetReg = rand()%(80); 
-						srand (time(0));
-						randBit = rand()%62;
+						FItargetReg = cpu.faultInjector->random(80); 
+						randBit = cpu.faultInjector->random(62);
 						temp = pow (2, randBit);
 						maxTry++;
 						//if ((FItargetReg > TheISA::FP_Reg_Base)) {
@@ -2017,7 +1992,7 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 				}
 				else if (FItargetReg < 50) //accept register from Input
 					{
-					randBit = rand()%62;
+					randBit = cpu.faultInjector->random(62);
 						temp = pow (2, randBit);
 					FItargetRegClass = regClass::INTEGER;
 					}
@@ -2044,7 +2019,10 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 							trueValue=cpu.threads[0]->readIntReg(FItargetReg);
 							faultyValue=trueValue xor temp;
 							cpu.threads[0]->setIntReg(FItargetReg, faultyValue);
-							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the integer register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", funcName, FItargetReg, trueValue, randBit,cpu.threads[0]->readIntReg(FItargetReg));
+							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the integer register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", debugRegionMap.name(roiFunc), FItargetReg, trueValue, randBit,cpu.threads[0]->readIntReg(FItargetReg));
+							faultTrace.record(FaultTrace::Inject, FaultTrace::IntReg,
+									headOfInFlightInst, cpu.threads[0]->pcState().instAddr(),
+									FItargetReg, trueValue, faultyValue);
 							ret = true;
 							break;
 						case regClass::FLOAT:
@@ -2052,7 +2030,10 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 							trueValue=cpu.threads[0]->readFloatRegBits(FItargetReg);
 							faultyValue=trueValue xor temp;
 							cpu.threads[0]->setFloatRegBits(FItargetReg, faultyValue);
-							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the float register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", funcName, FItargetReg, trueValue, randBit,cpu.threads[0]->readFloatRegBits(FItargetReg));
+							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the float register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", debugRegionMap.name(roiFunc), FItargetReg, trueValue, randBit,cpu.threads[0]->readFloatRegBits(FItargetReg));
+							faultTrace.record(FaultTrace::Inject, FaultTrace::FloatReg,
+									headOfInFlightInst, cpu.threads[0]->pcState().instAddr(),
+									FItargetReg, trueValue, faultyValue);
 							ret = true;
 							break;
 						case regClass::CC:
@@ -2060,7 +2041,10 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 							trueValue=cpu.threads[0]->readCCReg(FItargetReg);
 							faultyValue=trueValue xor temp;
 							cpu.threads[0]->setCCReg(FItargetReg, faultyValue);
-							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the CC register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", funcName, FItargetReg, trueValue, randBit,cpu.threads[0]->readIntReg(FItargetReg));
+							DPRINTF(faultInjectionTrack, "In Function: %s fault is injected on the CC register %s, true value was %s and the fliped bit is %s, so the faulty value is %s\n", debugRegionMap.name(roiFunc), FItargetReg, trueValue, randBit,cpu.threads[0]->readIntReg(FItargetReg));
+							faultTrace.record(FaultTrace::Inject, FaultTrace::CCReg,
+									headOfInFlightInst, cpu.threads[0]->pcState().instAddr(),
+									FItargetReg, trueValue, faultyValue);
 							ret = true;
 							break;
 						case regClass::MISC:
@@ -2153,6 +2137,13 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 			inFUMemInsts->minorTrace();
 		}
 
+	void
+		Execute::regStats()
+		{
+			for (unsigned int i = 0; i < numFuncUnits; i++)
+				funcUnits[i]->regStats();
+		}
+
 	void
 		Execute::drainResume()
 		{
@@ -2227,6 +2218,23 @@ DPRINTF(faultInjectionTrack, "%s \n",inst->staticInst->disassemble(0));
 				lsq.isDrained();
 		}
 
+	void
+		Execute::retargetFault(long target, long target_reg)
+		{
+			FItarget = target;
+			FItargetReg = target_reg;
+			fiEnabled = USE_FI && target != 0;
+			FItargetRegClass = 0;
+			faultIsInjected = false;
+			faultGetsMasked = false;
+			test = false;
+			if (ScoreboardFI)
+				scoreboard.armFault(FItarget);
+
+			DPRINTF(MinorExecute, "Fault target now %d reg: %d\n",
+				target, target_reg);
+		}
+
 	Execute::~Execute()
 	{
 		for (unsigned int i = 0; i < numFuncUnits; i++)
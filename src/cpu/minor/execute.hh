@@ -47,12 +47,19 @@
 #ifndef __CPU_MINOR_EXECUTE_HH__
 #define __CPU_MINOR_EXECUTE_HH__
 
+#include "base/loader/region_map.hh"
+#include "cpu/minor/ace.hh"
 #include "cpu/minor/buffers.hh"
+#include "cpu/minor/convergence.hh"
 #include "cpu/minor/cpu.hh"
+#include "cpu/minor/fault_trace.hh"
 #include "cpu/minor/func_unit.hh"
 #include "cpu/minor/lsq.hh"
 #include "cpu/minor/pipe_data.hh"
+#include "cpu/minor/protection.hh"
 #include "cpu/minor/scoreboard.hh"
+#include "cpu/minor/taint.hh"
+#include "cpu/minor/value_trace.hh"
 
 namespace Minor
 {
@@ -120,15 +127,25 @@ class Execute : public Named
 
     /** The execution functional units */
     std::vector<FUPipeline *> funcUnits;
+
+    /** Reused snapshot for the ExecuteOccupancy probe point */
+    ExecuteOccupancy occupancy;
   public: /* Public for Pipeline to be able to pass it to Decode */
 ///////////////////////for fault injection
 long FItarget;
 long FItargetReg;
 long MaxTick;
+/** Is an FItarget set?  Guards the injection checks in the operand
+ *  accessors so runs without faults pay for a single branch */
+bool fiEnabled;
 bool insertedTomain=false;
+/** Follow guestROI rather than detecting main and the ROI functions
+ *  by symbol */
+bool guestMarkers;
 bool faultIsInjected=false;
 bool faultGetsMasked=false;
-std::string funcName;
+/** Start address of the ROI function Execute was last seen in */
+Addr roiFunc=0;
 enum regClass
 			{
 				INTEGER = 1,
@@ -149,17 +166,48 @@ bool CMPsFI=false;//for falt injection on CMPs should be set
 bool print=false; //blr test
 bool ScoreboardFI=false; // for fault injection on scoreboard
 
-std::string lastPlace="main"; // moslem for printing out control flow
+Addr lastPlace=0; // moslem for printing out control flow
 int counter=0;
 
 
 bool enableSWIFT;
 bool enableZDC;
 
+/** Registers which the destination and sources of a SWIFT-R/ZDC copy
+ *  must include, from the enabled schemes' master register sets */
+uint64_t redundantDestMask;
+uint64_t redundantSrcMask;
+
+/** Stops injection runs once their state has converged with the golden
+ *  run's */
+Convergence convergence;
+
+/** Locates where injection runs first depart from the golden run's
+ *  committed values */
+ValueTrace valueTrace;
+
+/** Follows the faults injected into the register files so each fault of
+ *  a batch gets its own outcome */
+Taint taint;
+
+/** Register vulnerability intervals of fault-free runs */
+AceAnalysis ace;
+
+/** Overhead and ACE coverage of SWIFT-R/ZDC code by instruction class */
+ProtectionEval protection;
+
+/** Binary trace of injections and of accesses to faulty state */
+FaultTrace faultTrace;
+
 
 MinorDynInstPtr lastInstBranchREG = NULL; // branch REG
 MinorDynInstPtr lastInst = NULL;
 
+/** Re-arm the injector with a new target, forgetting any fault already
+ *  injected.  Used by forked fault-injection campaigns where each child
+ *  continues from a shared fault-free prefix */
+void retargetFault(long target, long target_reg);
+
 ///////////////////////////////////
 
     InputBuffer<ForwardInstData> inputBuffer;
@@ -281,12 +329,18 @@ MinorDynInstPtr lastInst = NULL;
      *  related to the new instruction/op counts */
     void doInstCommitAccounting(MinorDynInstPtr inst);
 //moslem
+/** Is inst a register copy added by SWIFT-R or ZDC: a sub in the ROI
+ *  from a master register and the zero register into a slave register */
 bool isUnnecessaryInst(MinorDynInstPtr inst);
 bool inMain(MinorDynInstPtr inst);
-bool isSWIFTMasterReg(int reg);
-bool isSWIFTSlaveReg(int reg);
-bool isZDCMasterReg(int reg);
-bool isZDCSlaveReg(int reg);
+
+/** The ProtectionEval class of inst */
+ProtectionEval::InstClass
+protectionClass(MinorDynInstPtr inst)
+{
+    return protection.classify(inst->pc.instAddr(),
+        (enableSWIFT || enableZDC) && isUnnecessaryInst(inst));
+}
 
     /** Commit a single instruction.  Returns true if the instruction being
      *  examined was completed (fully executed, discarded, or initiated a
@@ -354,6 +408,9 @@ bool isZDCSlaveReg(int reg);
 
     void minorTrace() const;
 
+    /** Register the liveness stats of the FU pipelines */
+    void regStats();
+
     /** After thread suspension, has Execute been drained of in-flight
      *  instructions and memory accesses. */
     bool isDrained();
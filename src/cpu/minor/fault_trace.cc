@@ -0,0 +1,98 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/minor/fault_trace.hh"
+
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "config/have_protobuf.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/fault.pb.h"
+#include "proto/protoio.hh"
+#endif
+
+namespace Minor
+{
+
+FaultTrace::FaultTrace(const std::string &name_,
+    const std::string &file_name) :
+    Named(name_),
+    stream(NULL),
+    closeCallback(this)
+{
+    if (file_name == "")
+        return;
+
+#if HAVE_PROTOBUF
+    stream = new ProtoOutputStream(simout.resolve(file_name));
+
+    ProtoMessage::FaultHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_ver(0);
+    header_msg.set_tick_freq(SimClock::Frequency);
+    stream->write(header_msg);
+
+    registerExitCallback(&closeCallback);
+#else
+    fatal("%s: fault trace %s needs gem5 built with protobuf support\n",
+        name(), file_name);
+#endif
+}
+
+void
+FaultTrace::closeStream()
+{
+#if HAVE_PROTOBUF
+    delete stream;
+#endif
+    stream = NULL;
+}
+
+void
+FaultTrace::write(Kind kind, Structure structure, InstSeqNum seq_num,
+    Addr pc, unsigned int reg, uint64_t old_value, uint64_t new_value)
+{
+#if HAVE_PROTOBUF
+    ProtoMessage::FaultEvent event;
+
+    event.set_tick(curTick());
+    event.set_seq_num(seq_num);
+    event.set_pc(pc);
+    event.set_structure(
+        static_cast<ProtoMessage::FaultEvent::Structure>(structure));
+    event.set_kind(static_cast<ProtoMessage::FaultEvent::Kind>(kind));
+    event.set_reg(reg);
+    event.set_old_value(old_value);
+    event.set_new_value(new_value);
+    stream->write(event);
+#endif
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Compact binary trace of fault injection events.
+ */
+
+#ifndef __CPU_MINOR_FAULT_TRACE_HH__
+#define __CPU_MINOR_FAULT_TRACE_HH__
+
+#include <string>
+
+#include "base/callback.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/minor/trace.hh"
+#include "sim/trace_window.hh"
+
+class ProtoOutputStream;
+
+namespace Minor
+{
+
+/** Writes fault injection events (FaultEvent messages of
+ *  proto/fault.proto) to a protobuf stream, gzipped if the file name ends
+ *  in .gz.  Each event is a fixed set of fields (tick, seqnum, pc,
+ *  structure, register, old and new value) so recording one costs no
+ *  string formatting, unlike the faultInjectionTrack family of debug
+ *  flags.  Decode with util/decode_fault_trace.py */
+class FaultTrace : public Named
+{
+  public:
+    /** Mirrors FaultEvent::Structure */
+    enum Structure
+    {
+        IntReg, FloatReg, CCReg, RegPointer, FuValue, BranchReg, CmpReg,
+        Pc, LsqSize, LsqAddr, LsqData
+    };
+
+    /** Mirrors FaultEvent::Kind */
+    enum Kind
+    {
+        Inject, Read, Overwrite
+    };
+
+  protected:
+    ProtoOutputStream *stream;
+
+    void closeStream();
+
+    MakeCallback<FaultTrace, &FaultTrace::closeStream> closeCallback;
+
+    void write(Kind kind, Structure structure, InstSeqNum seq_num, Addr pc,
+        unsigned int reg, uint64_t old_value, uint64_t new_value);
+
+  public:
+    /** No trace is written if file_name is empty */
+    FaultTrace(const std::string &name_, const std::string &file_name);
+
+    ~FaultTrace() { closeStream(); }
+
+    bool enabled() const { return stream != NULL; }
+
+    /** Record an event, if tracing.  Injections also act on fault
+     *  triggered trace windows */
+    void
+    record(Kind kind, Structure structure, InstSeqNum seq_num, Addr pc,
+        unsigned int reg, uint64_t old_value, uint64_t new_value)
+    {
+        if (kind == Inject)
+            Trace::windowFault();
+        if (stream)
+            write(kind, structure, seq_num, pc, reg, old_value, new_value);
+    }
+};
+
+}
+
+#endif /* __CPU_MINOR_FAULT_TRACE_HH__ */
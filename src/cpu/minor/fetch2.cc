@@ -41,12 +41,15 @@
 
 #include "arch/decoder.hh"
 #include "arch/utility.hh"
+#include "cpu/fault_injector.hh"
 #include "cpu/minor/fetch2.hh"
 #include "cpu/minor/pipeline.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "sim/trace_window.hh"
 #include "debug/Branch.hh"
 #include "debug/Fetch.hh"
 #include "debug/MinorTrace.hh"
+#include "debug/PCFaultInjectionTrack.hh"
 
 
 
@@ -79,7 +82,11 @@ Fetch2::Fetch2(const std::string &name,
     fetchSeqNum(InstId::firstFetchSeqNum),
     expectedStreamSeqNum(InstId::firstStreamSeqNum),
     predictionSeqNum(InstId::firstPredictionSeqNum),
-    blocked(false)
+    blocked(false),
+    faultSeqNum(0),
+    faultField(Enums::inst),
+    faultBit(-1),
+    faultWordFlipped(false)
 {
     if (outputWidth < 1)
         fatal("%s: decodeInputWidth must be >= 1 (%d)\n", name, outputWidth);
@@ -88,6 +95,104 @@ Fetch2::Fetch2(const std::string &name,
         fatal("%s: fetch2InputBufferSize must be >= 1 (%d)\n", name,
         params.fetch2InputBufferSize);
     }
+
+    armFault(params.fetchFaultSeqNum, params.fetchFaultField,
+        params.fetchFaultBit);
+}
+
+void
+Fetch2::armFault(InstSeqNum seq_num, Enums::MinorFetchFault field, int bit)
+{
+#if THE_ISA != ARM_ISA
+    if (seq_num != 0 && field == Enums::inst) {
+        fatal("%s: instruction word faults need an uncached decode,"
+            " which only ARM provides\n", name());
+    }
+#endif
+
+    faultSeqNum = seq_num;
+    faultField = field;
+    faultBit = bit;
+    faultWordFlipped = false;
+}
+
+/** Pick the bit to flip for a fault, bit if it is in range */
+static unsigned int
+faultBitIn(unsigned int width, int bit, FaultInjector &injector,
+    const std::string &name)
+{
+    if (bit < 0)
+        return injector.random(width);
+
+    if (bit >= int(width)) {
+        warn("%s: fetch fault bit %d out of range, using %d\n", name,
+            bit, bit % width);
+    }
+    return bit % width;
+}
+
+void
+Fetch2::injectInstWordFault(TheISA::MachInst &inst_word)
+{
+    unsigned int bit = faultBitIn(sizeof(TheISA::MachInst) * 8, faultBit,
+        *cpu.faultInjector, name());
+    TheISA::MachInst true_word = inst_word;
+
+    inst_word ^= TheISA::MachInst(1) << bit;
+    faultWordFlipped = true;
+
+    Trace::windowFault();
+
+    DPRINTF(PCFaultInjectionTrack, "Fetch fault: inst fetchSeqNum: %d"
+        " pc: %s word: 0x%x now 0x%x (bit %d)\n", fetchSeqNum, pc,
+        true_word, inst_word, bit);
+}
+
+StaticInstPtr
+Fetch2::decodeFaultyInst(TheISA::Decoder *decoder)
+{
+    /* The fault has had its one chance */
+    faultWordFlipped = false;
+    faultSeqNum = 0;
+
+#if THE_ISA == ARM_ISA
+    return decoder->decodeUncached(pc);
+#else
+    /* Unreachable, armFault refuses word faults for other ISAs */
+    return decoder->decode(pc);
+#endif
+}
+
+void
+Fetch2::injectPcFault(MinorDynInstPtr inst)
+{
+    if (faultField == Enums::inst) {
+        /* The decoder already held the whole instruction when the
+         *  target was reached (the second half of a Thumb word), so its
+         *  word can't be corrupted.  Take the next instruction instead */
+        DPRINTF(PCFaultInjectionTrack, "Fetch fault: inst fetchSeqNum: %d"
+            " was decoded from an earlier word, retargeting to %d\n",
+            fetchSeqNum, fetchSeqNum + 1);
+        faultSeqNum++;
+        return;
+    }
+
+    faultSeqNum = 0;
+
+    unsigned int bit = faultBitIn(sizeof(Addr) * 8, faultBit,
+        *cpu.faultInjector, name());
+    Addr true_pc = inst->pc.instAddr();
+    Addr faulty_pc = true_pc ^ (Addr(1) << bit);
+
+    /* Keep the instruction's size, only where it claims to be moves */
+    inst->pc.npc(faulty_pc + (inst->pc.npc() - inst->pc.pc()));
+    inst->pc.pc(faulty_pc);
+
+    Trace::windowFault();
+
+    DPRINTF(PCFaultInjectionTrack, "Fetch fault: pc fetchSeqNum: %d"
+        " inst: %s pc: 0x%x now 0x%x (bit %d)\n", fetchSeqNum,
+        *inst, true_pc, faulty_pc, bit);
 }
 
 const ForwardLineData *
@@ -343,6 +448,7 @@ Fetch2::evaluate()
                 /* Fetch and prediction sequence numbers originate here */
                 dyn_inst->id.fetchSeqNum = fetchSeqNum;
                 dyn_inst->id.predictionSeqNum = predictionSeqNum;
+                dyn_inst->fetchTick = curTick();
                 /* To complete the set, test that exec sequence number has
                  *  not been set */
                 assert(dyn_inst->id.execSeqNum == 0);
@@ -366,6 +472,12 @@ Fetch2::evaluate()
                     (line + inputIndex)));
 
                 if (!decoder->instReady()) {
+                    if (fetchSeqNum == faultSeqNum &&
+                        faultField == Enums::inst && !faultWordFlipped)
+                    {
+                        injectInstWordFault(inst_word);
+                    }
+
                     decoder->moreBytes(pc,
                         line_in->lineBaseAddr + inputIndex, inst_word);
                     DPRINTF(Fetch, "Offering MachInst to decoder"
@@ -383,18 +495,24 @@ Fetch2::evaluate()
                     /* Fetch and prediction sequence numbers originate here */
                     dyn_inst->id.fetchSeqNum = fetchSeqNum;
                     dyn_inst->id.predictionSeqNum = predictionSeqNum;
+                    dyn_inst->fetchTick = curTick();
                     /* To complete the set, test that exec sequence number
                      *  has not been set */
                     assert(dyn_inst->id.execSeqNum == 0);
 
                     /* Note that the decoder can update the given PC.
                      *  Remember not to assign it until *after* calling
-                     *  decode */
-                    StaticInstPtr decoded_inst = decoder->decode(pc);
+                     *  decode.  A corrupted word must not be left in the
+                     *  decoder's cache */
+                    StaticInstPtr decoded_inst = (faultWordFlipped ?
+                        decodeFaultyInst(decoder) : decoder->decode(pc));
                     dyn_inst->staticInst = decoded_inst;
 
                     dyn_inst->pc = pc;
 
+                    if (fetchSeqNum == faultSeqNum)
+                        injectPcFault(dyn_inst);
+
                     DPRINTF(Fetch, "Instruction extracted from line %s"
                         " lineWidth: %d output_index: %d inputIndex: %d"
                         " pc: %s inst: %s\n",
@@ -443,39 +561,6 @@ Fetch2::evaluate()
                     line_in->lineWidth);
                 }
             }
-/*
-///////////working area for fault injection on PC
-
-std::string funcName="nothing";
-Addr sym_addr;
-debugSymbolTable->findNearestSymbol(dyn_inst->pc.instAddr() , funcName, sym_addr);
-if( (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C') || funcName == "main" )
-	DPRINTF(MainPCs, "Func: %s Inst: %s PC:%s\n", funcName, dyn_inst->staticInst->disassemble(0), dyn_inst->pc.instAddr());
-
-///////////working area for fault injection on PC
-if( !isInjected && (FItargetReg == 1001) && (curTick() > FItarget) )
-{
-isInjected=true;
-						srand (time(0));
-						int randBit = 1;
-
-	DPRINTF(PCFaultInjectionTrack, "True Pc of Inst was PC:%s\n", pc.instAddr());
-while(randBit)
-{
-TheISA::advancePC(pc, decoder->decode(pc));
-randBit--;
-}
-	DPRINTF(PCFaultInjectionTrack, "True Pc of Inst is %s\n",pc.instAddr() );
-						//randBit+=2;
-						//int temp = pow (2, randBit);
-						//long faultyPC = aligned_pc xor temp;
-
-//line_in->lineBaseAddr = line_in->lineBaseAddr xor temp;
- //pc.set(faultyPC + request_size);
-}
-/////////////////////////////
-/////////////////////////////
-*/
 
             if (dyn_inst) {
                 /* Step to next sequence number */
@@ -557,6 +642,24 @@ randBit--;
     inputBuffer.pushTail();
 }
 
+bool
+Fetch2::canSkipEvaluate()
+{
+    if (!(*inp.outputWire).isBubble() || !(*branchInp.outputWire).isBubble())
+        return false;
+
+    const ForwardLineData *line_in = getInput();
+    if (!line_in)
+        return true;
+
+    /* Blocked lines are only looked at to discard mispredicted ones */
+    bool discard_line =
+        expectedStreamSeqNum == line_in->id.streamSeqNum &&
+        predictionSeqNum != line_in->id.predictionSeqNum;
+
+    return !nextStageReserve.canReserve() && !discard_line;
+}
+
 bool
 Fetch2::isDrained()
 {
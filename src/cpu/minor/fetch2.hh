@@ -137,6 +137,21 @@ class Fetch2 : public Named
     /** Blocked indication for report */
     bool blocked;
 
+    /** Fetch seqnum of the instruction to corrupt, 0 when no fault is
+     *  armed.  Cleared once the fault is injected so the only cost in
+     *  the extraction loop is a compare against fetchSeqNum */
+    InstSeqNum faultSeqNum;
+
+    /** Corrupt the fetched machine word or the instruction's PC */
+    Enums::MinorFetchFault faultField;
+
+    /** Bit of faultField to flip, negative for a random bit */
+    int faultBit;
+
+    /** The armed instruction word fault has been applied to a word
+     *  offered to the decoder, whose instruction is yet to be decoded */
+    bool faultWordFlipped;
+
   protected:
     /** Get a piece of data to work on from the inputBuffer, or 0 if there
      *  is no data. */
@@ -158,6 +173,20 @@ class Fetch2 : public Named
      *  carries the prediction to Fetch1 */
     void predictBranch(MinorDynInstPtr inst, BranchData &branch);
 
+    /** Flip the armed bit of inst_word, the machine word about to be
+     *  offered to the decoder for the instruction with faultSeqNum */
+    void injectInstWordFault(TheISA::MachInst &inst_word);
+
+    /** Decode the instruction holding a corrupted word without using
+     *  (or filling) the decoder's instruction cache, and disarm the
+     *  fault */
+    StaticInstPtr decodeFaultyInst(TheISA::Decoder *decoder);
+
+    /** Flip the armed bit of the PC carried by inst, which has
+     *  faultSeqNum.  The instruction executes with, and Execute
+     *  redirects fetch from, the corrupted PC */
+    void injectPcFault(MinorDynInstPtr inst);
+
   public:
     Fetch2(const std::string &name,
         MinorCPU &cpu_,
@@ -169,9 +198,22 @@ class Fetch2 : public Named
         Reservable &next_stage_input_buffer);
 
   public:
+    /** Arm a single bit flip in the instruction word or PC of the
+     *  instruction with fetch seqnum seq_num (0 disarms).  A corrupted
+     *  instruction word is decoded without using the decoder's
+     *  instruction cache so that later fetches of the same address
+     *  decode correctly */
+    void armFault(InstSeqNum seq_num, Enums::MinorFetchFault field,
+        int bit = -1);
+
     /** Pass on input/buffer data to the output if you can */
     void evaluate();
 
+    /** Would evaluate() do nothing this cycle?  True when nothing
+     *  arrives and the input buffer is empty, or blocked with no lines
+     *  left to discard */
+    bool canSkipEvaluate();
+
     void minorTrace() const;
 
     /** Is this stage drained?  For Fetch2, draining is initiated by
@@ -210,6 +210,9 @@ class QueuedInst
     void reportData(std::ostream &os) const;
     bool isBubble() const { return inst->isBubble(); }
 
+    /** Live bits held in an FU pipeline slot */
+    unsigned int liveBits() const { return inst->liveBits(); }
+
     static QueuedInst bubble()
     { return QueuedInst(MinorDynInst::bubble()); }
 };
@@ -42,6 +42,7 @@
 
 #include "arch/locked_mem.hh"
 #include "arch/mmapped_ipr.hh"
+#include "base/loader/region_map.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/minor/exec_context.hh"
 #include "cpu/minor/execute.hh"
@@ -84,7 +85,9 @@ LSQ::LSQRequest::LSQRequest(LSQ &port_, MinorDynInstPtr inst_, bool isLoad_,
     skipped(false),
     issuedToMemory(false),
     state(NotIssued)
-{ }
+{
+    port.cpu.ppLSQAllocate->notify(inst);
+}
 
 LSQ::AddrRangeCoverage
 LSQ::LSQRequest::containsAddrRangeOf(
@@ -293,6 +296,9 @@ LSQ::SplitDataRequest::finish(const Fault &fault_, RequestPtr request_,
 
     assert(request_ == fragmentRequests[expected_fragment_index]);
 
+    if (fault == NoFault)
+        shareTranslation(request_);
+
     /* Wake up next cycle to get things going again in case the
      *  tryToSendToTransfers does take */
     port.cpu.wakeupOnEvent(Pipeline::ExecuteStageId);
@@ -400,6 +406,9 @@ LSQ::SplitDataRequest::makeFragmentRequests()
     fragment_addr = base_addr;
     fragment_size = first_fragment_size;
 
+    fragmentRequests.reserve(numFragments);
+    fragmentPackets.reserve(numFragments);
+
     /* Just past the last address in the request */
     Addr end_addr = base_addr + whole_size;
 
@@ -441,6 +450,32 @@ LSQ::SplitDataRequest::makeFragmentRequests()
     }
 }
 
+void
+LSQ::SplitDataRequest::shareTranslation(Request *translated)
+{
+    Addr page_mask = ~(Addr(TheISA::PageBytes) - 1);
+    Addr translated_vaddr = translated->getVaddr();
+
+    /* Fragments after the first start on line boundaries, so they can't
+     *  take an alignment fault the translated fragment didn't */
+    while (numTranslatedFragments < numFragments) {
+        Request *fragment = fragmentRequests[numTranslatedFragments];
+        Addr vaddr = fragment->getVaddr();
+
+        if ((vaddr & page_mask) != (translated_vaddr & page_mask))
+            break;
+
+        DPRINTFS(MinorMem, (&port), "Sharing translation of 0x%x with"
+            " fragment: %d of request: %s\n", translated_vaddr,
+            numTranslatedFragments, *inst);
+
+        fragment->setPaddr(translated->getPaddr() +
+            (vaddr - translated_vaddr));
+        fragment->setFlags(translated->getFlags());
+        numTranslatedFragments++;
+    }
+}
+
 void
 LSQ::SplitDataRequest::makeFragmentPackets()
 {
@@ -448,6 +483,20 @@ LSQ::SplitDataRequest::makeFragmentPackets()
 
     DPRINTFS(MinorMem, (&port), "Making packets for request: %s\n", *inst);
 
+    /* Make the overall/response packet first so that the fragments can
+     *  carry their parts of its data.  Get the physical address for the
+     *  whole request/packet from the first fragment and accumulate the
+     *  fragments' flags */
+    request.setPaddr(fragmentRequests[0]->getPaddr());
+    for (unsigned int fragment_index = 0; fragment_index < numFragments;
+         fragment_index++)
+    {
+        request.setFlags(fragmentRequests[fragment_index]->getFlags());
+    }
+    makePacket();
+
+    uint8_t *whole_data = packet->getPtr<uint8_t>();
+
     for (unsigned int fragment_index = 0; fragment_index < numFragments;
          fragment_index++)
     {
@@ -460,33 +509,17 @@ LSQ::SplitDataRequest::makeFragmentPackets()
             (fragment->hasPaddr() ? fragment->getPaddr() : 0));
 
         Addr fragment_addr = fragment->getVaddr();
-        unsigned int fragment_size = fragment->getSize();
-
-        uint8_t *request_data = NULL;
-
-        if (!isLoad) {
-            /* Split data for Packets.  Will become the property of the
-             *  outgoing Packets */
-            request_data = new uint8_t[fragment_size];
-            std::memcpy(request_data, data + (fragment_addr - base_addr),
-                fragment_size);
-        }
 
         assert(fragment->hasPaddr());
 
+        /* The fragment packets are deleted before packet, in
+         *  ~SplitDataRequest */
         PacketPtr fragment_packet =
-            makePacketForRequest(*fragment, isLoad, this, request_data);
+            makePacketForRequest(*fragment, isLoad, this,
+                whole_data + (fragment_addr - base_addr), true);
 
         fragmentPackets.push_back(fragment_packet);
-        /* Accumulate flags in parent request */
-        request.setFlags(fragment->getFlags());
     }
-
-    /* Might as well make the overall/response packet here */
-    /* Get the physical address for the whole request/packet from the first
-     *  fragment */
-    request.setPaddr(fragmentRequests[0]->getPaddr());
-    makePacket();
 }
 
 void
@@ -549,24 +582,10 @@ LSQ::SplitDataRequest::retireResponse(PacketPtr response)
         DPRINTFS(MinorMem, (&port), "Fragment has an error, skipping\n");
         setSkipped();
         packet->copyError(response);
-    } else {
-        if (isLoad) {
-            if (!data) {
-                /* For a split transfer, a Packet must be constructed
-                 *  to contain all returning data.  This is that packet's
-                 *  data */
-                data = new uint8_t[request.getSize()];
-            }
-
-            /* Populate the portion of the overall response data represented
-             *  by the response fragment */
-            std::memcpy(
-                data + (response->req->getVaddr() - request.getVaddr()),
-                response->getConstPtr<uint8_t>(),
-                response->req->getSize());
-        }
     }
 
+    /* Load fragments' data has already arrived in place in packet */
+
     /* Complete early if we're skipping are no more in-flight accesses */
     if (skipped && !hasPacketsInMemSystem()) {
         DPRINTFS(MinorMem, (&port), "Completed skipped burst\n");
@@ -587,16 +606,6 @@ LSQ::SplitDataRequest::retireResponse(PacketPtr response)
              packet->needsResponse(), packet->getSize(), request.getSize(),
              response->getSize());
 
-        /* A request can become complete by several paths, this is a sanity
-         *  check to make sure the packet's data is created */
-        if (!data) {
-            data = new uint8_t[request.getSize()];
-        }
-
-        if (isLoad) {
-            DPRINTFS(MinorMem, (&port), "Copying read data\n");
-            std::memcpy(packet->getPtr<uint8_t>(), data, request.getSize());
-        }
         packet->makeResponse();
     }
 
@@ -640,6 +649,7 @@ LSQ::StoreBuffer::deleteRequest(LSQRequestPtr request)
         DPRINTF(MinorMem, "Deleting request: %s %s %s from StoreBuffer\n",
             request, *found, *(request->inst));
         slots.erase(found);
+        filterRequest(request, false);
 
         delete request;
     }
@@ -661,16 +671,60 @@ LSQ::StoreBuffer::insert(LSQRequestPtr request)
         request->setState(LSQRequest::StoreInStoreBuffer);
 
     slots.push_back(request);
+    filterRequest(request, true);
 
     /* Let's try and wake up the processor for the next cycle to step
      *  the store buffer */
     lsq.cpu.wakeupOnEvent(Pipeline::ExecuteStageId);
 }
 
+void
+LSQ::StoreBuffer::filterRequest(LSQRequestPtr request, bool insert)
+{
+    if (!request->request.hasPaddr())
+        return;
+
+    Addr addr = request->request.getPaddr();
+    unsigned int size = request->request.getSize();
+    Addr line = addr / lsq.lineWidth;
+    Addr last_line = (addr + (size ? size - 1 : 0)) / lsq.lineWidth;
+
+    for (; line <= last_line; line++) {
+        uint16_t &count = addrFilter[line % AddrFilterSize];
+
+        if (insert) {
+            count++;
+        } else {
+            assert(count != 0);
+            count--;
+        }
+    }
+}
+
+bool
+LSQ::StoreBuffer::mightForwardToLoad(LSQRequestPtr request) const
+{
+    Addr addr = request->request.getPaddr();
+    unsigned int size = request->request.getSize();
+    Addr line = addr / lsq.lineWidth;
+    Addr last_line = (addr + (size ? size - 1 : 0)) / lsq.lineWidth;
+
+    for (; line <= last_line; line++) {
+        if (addrFilter[line % AddrFilterSize] != 0)
+            return true;
+    }
+
+    return false;
+}
+
 LSQ::AddrRangeCoverage
 LSQ::StoreBuffer::canForwardDataToLoad(LSQRequestPtr request,
     unsigned int &found_slot)
 {
+    /* Most loads touch no line any store in the buffer does */
+    if (!mightForwardToLoad(request))
+        return NoAddrRangeCoverage;
+
     unsigned int slot_index = slots.size() - 1;
     auto i = slots.rbegin();
     AddrRangeCoverage ret = NoAddrRangeCoverage;
@@ -761,6 +815,7 @@ LSQ::StoreBuffer::step()
             numUnissuedAccesses--;
             lsq.clearMemBarrier(barrier->inst);
             slots.pop_front();
+            filterRequest(barrier, false);
 
             delete barrier;
         }
@@ -1346,6 +1401,8 @@ LSQ::~LSQ()
 
 LSQ::LSQRequest::~LSQRequest()
 {
+    port.cpu.ppLSQFree->notify(inst);
+
     if (packet)
         delete packet;
     if (data)
@@ -1484,10 +1541,9 @@ LSQ::pushRequest(MinorDynInstPtr inst, bool isLoad, uint8_t *data,
 
 //////////////////////////////////////////
 ////working area for fault injection on LSQ
-	std::string funcName="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-			if (funcName == "main" || ((funcName[0] == 'F' && funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C')))
+	const std::string &funcName = debugRegionMap.name(inst->pc.instAddr());
+			bool in_roi = debugRegionMap.inROI(inst->pc.instAddr());
+			if (in_roi)
 {
 DPRINTF(LSQaccesses, "FUNC= %s: Inst:%s: SeqNum:%s\n",funcName,inst->staticInst->disassemble(0),inst->id.execSeqNum);
 
@@ -1503,43 +1559,46 @@ DPRINTF(LSQaccesses, "FUNC= %s: Inst:%s: SeqNum:%s\n",funcName,inst->staticInst-
 bool storeIsDone=false;
 	
 
-if ((funcName == "main" || ((funcName[0] == 'F' && funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))) && (execute.FItargetReg == 225))
+if (in_roi && (execute.FItargetReg == 225))
 {
 if (!execute.faultIsInjected && (inst->id.execSeqNum  >= execute.FItarget)  && execute.LSQFI) 
 {
 execute.faultIsInjected=true;
 bool Size=false;
-srand (time(0));
-int temp = rand()%(6);
+int temp = cpu.faultInjector->random(6);
 if(temp == 6) Size=true;
 if (Size) 
 {
-srand (time(0));
-int newSize = rand()%(2);
+unsigned int old_size = size;
+int newSize = cpu.faultInjector->random(2);
 if (newSize) 
 size = size *2;
 else
 size = size /4;
 DPRINTF(LSQtrack, "Func:%s, Target instruction in LSQ is:%s, faulty size is %s\n",funcName, inst->staticInst->disassemble(0), size );
+execute.faultTrace.record(FaultTrace::Inject, FaultTrace::LsqSize,
+    inst->id.execSeqNum, inst->pc.instAddr(), 0, old_size, size);
 
 }
 else if (isLoad || temp < 4)
 {
-srand (time(0));
-int faultyBit = rand()%(12);
+int faultyBit = cpu.faultInjector->random(12);
 if (faultyBit < 2) faultyBit+=3;
 int temp = pow (2, faultyBit);
 DPRINTF(LSQtrack, "Func:%s, Target instruction in LSQ is:%s, true address is 0x%s and faulty address is 0x%s\n",funcName, inst->staticInst->disassemble(0), addr, (addr xor  temp) );
+execute.faultTrace.record(FaultTrace::Inject, FaultTrace::LsqAddr,
+    inst->id.execSeqNum, inst->pc.instAddr(), 0, addr, addr ^ temp);
 addr = addr xor  temp;
 }
 else
 {
 
-srand (time(0));
-int faultyBit = rand()%(3);
+int faultyBit = cpu.faultInjector->random(3);
 request_data = new uint8_t[size];
 std::memset(request_data, faultyBit, size);
 DPRINTF(LSQtrack, "Func:%s, Target instruction is Store:%s, soft error happens on data\n",funcName, inst->staticInst->disassemble(0));
+execute.faultTrace.record(FaultTrace::Inject, FaultTrace::LsqData,
+    inst->id.execSeqNum, inst->pc.instAddr(), 0, 0, faultyBit);
 storeIsDone=true;
 }
 }
@@ -1605,11 +1664,12 @@ LSQ::StoreBuffer::StoreBuffer(std::string name_, LSQ &lsq_,
     slots(),
     numUnissuedAccesses(0)
 {
+    std::fill(addrFilter, addrFilter + AddrFilterSize, 0);
 }
 
 PacketPtr
 makePacketForRequest(Request &request, bool isLoad,
-    Packet::SenderState *sender_state, PacketDataPtr data)
+    Packet::SenderState *sender_state, PacketDataPtr data, bool static_data)
 {
     MemCmd command;
 
@@ -1627,7 +1687,9 @@ makePacketForRequest(Request &request, bool isLoad,
     if (sender_state)
         ret->pushSenderState(sender_state);
 
-    if (isLoad)
+    if (static_data)
+        ret->dataStatic(data);
+    else if (isLoad)
         ret->allocate();
     else
         ret->dataDynamic(data);
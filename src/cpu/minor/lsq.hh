@@ -431,9 +431,15 @@ class LSQ : public Named
         void makeFragmentRequests();
 
         /** Make the packets to go with the requests so they can be sent to
-         *  the memory system */
+         *  the memory system.  The fragment packets carry their parts of
+         *  the overall packet's data in place, so loads need no merging
+         *  copy and stores no split copy */
         void makeFragmentPackets();
 
+        /** Give the fragments following translated in the same page its
+         *  translation, saving them trips through the DTLB */
+        void shareTranslation(Request *translated);
+
         /** Start a loop of do { sendNextFragmentToTranslation ;
          *  translateTiming ; finish } while (numTranslatedFragments !=
          *  numFragments) to complete all this requests' fragments' address
@@ -483,6 +489,24 @@ class LSQ : public Named
          *  memory access */
         unsigned int numUnissuedAccesses;
 
+      protected:
+        /** Number of counters in addrFilter */
+        static const unsigned int AddrFilterSize = 256;
+
+        /** Counts of the translated slots touching each line (hashed by
+         *  line address).  A load whose lines all have a count of zero
+         *  can't be forwarded to, so canForwardDataToLoad can skip its
+         *  walk of slots */
+        uint16_t addrFilter[AddrFilterSize];
+
+        /** Add request's lines to (insert) or remove them from addrFilter.
+         *  Requests without a physical address (barriers) aren't
+         *  entered */
+        void filterRequest(LSQRequestPtr request, bool insert);
+
+        /** Might any slot overlap request? */
+        bool mightForwardToLoad(LSQRequestPtr request) const;
+
       public:
         StoreBuffer(std::string name_, LSQ &lsq_,
             unsigned int store_buffer_size,
@@ -731,9 +755,12 @@ return  inReq+inTra+inSt;
 
 /** Make a suitable packet for the given request.  If the request is a store,
  *  data will be the payload data.  If sender_state is NULL, it won't be
- *  pushed into the packet as senderState */
+ *  pushed into the packet as senderState.  If static_data is set, data
+ *  is used as the packet's data for loads and stores but stays owned by
+ *  the caller */
 PacketPtr makePacketForRequest(Request &request, bool isLoad,
-    Packet::SenderState *sender_state = NULL, PacketDataPtr data = NULL);
+    Packet::SenderState *sender_state = NULL, PacketDataPtr data = NULL,
+    bool static_data = false);
 }
 
 #endif /* __CPU_MINOR_NEW_LSQ_HH__ */
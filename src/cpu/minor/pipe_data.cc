@@ -39,6 +39,8 @@
 
 #include "cpu/minor/pipe_data.hh"
 
+#include <algorithm>
+
 namespace Minor
 {
 
@@ -229,12 +231,13 @@ ForwardLineData::reportData(std::ostream &os) const
 }
 
 ForwardInstData::ForwardInstData(unsigned int width) :
-    numInsts(width)
+    numInsts(width), usedInsts(width)
 {
     bubbleFill();
 }
 
-ForwardInstData::ForwardInstData(const ForwardInstData &src)
+ForwardInstData::ForwardInstData(const ForwardInstData &src) :
+    usedInsts(0)
 {
     *this = src;
 }
@@ -243,6 +246,7 @@ ForwardInstData &
 ForwardInstData::operator =(const ForwardInstData &src)
 {
     numInsts = src.numInsts;
+    usedInsts = std::max(usedInsts, numInsts);
 
     for (unsigned int i = 0; i < src.numInsts; i++)
         insts[i] = src.insts[i];
@@ -256,6 +260,17 @@ ForwardInstData::isBubble() const
     return numInsts == 0 || insts[0]->isBubble();
 }
 
+unsigned int
+ForwardInstData::liveBits() const
+{
+    unsigned int bits = 0;
+
+    for (unsigned int i = 0; i < numInsts; i++)
+        bits += insts[i]->liveBits();
+
+    return bits;
+}
+
 void
 ForwardInstData::bubbleFill()
 {
@@ -268,10 +283,21 @@ ForwardInstData::resize(unsigned int width)
 {
     assert(width < MAX_FORWARD_INSTS);
     numInsts = width;
+    usedInsts = std::max(usedInsts, numInsts);
 
     bubbleFill();
 }
 
+void
+ForwardInstData::reset()
+{
+    for (unsigned int i = 0; i < usedInsts; i++)
+        insts[i] = NULL;
+
+    numInsts = 0;
+    usedInsts = 0;
+}
+
 void
 ForwardInstData::reportData(std::ostream &os) const
 {
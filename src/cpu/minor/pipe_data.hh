@@ -146,6 +146,10 @@ class BranchData /* : public ReportIF, public BubbleIF */
     static BranchData bubble() { return BranchData(); }
     bool isBubble() const { return reason == NoBranch; }
 
+    /** Live bits held in a latch: the branch target */
+    unsigned int liveBits() const
+    { return isBubble() ? 0 : sizeof(TheISA::PCState) * 8; }
+
     /** As static isStreamChange but on this branch data */
     bool isStreamChange() const { return isStreamChange(reason); }
 
@@ -239,6 +243,9 @@ class ForwardLineData /* : public ReportIF, public BubbleIF */
     static ForwardLineData bubble() { return ForwardLineData(); }
     bool isBubble() const { return bubbleFlag; }
 
+    /** Live bits held in a latch: the fetched line */
+    unsigned int liveBits() const { return isBubble() ? 0 : lineWidth * 8; }
+
     /** ReportIF interface */
     void reportData(std::ostream &os) const;
 };
@@ -258,6 +265,10 @@ class ForwardInstData /* : public ReportIF, public BubbleIF */
     /** The number of insts slots that can be expected to be valid insts */
     unsigned int numInsts;
 
+    /** The number of leading insts slots that may hold references.
+     *  Never less than numInsts */
+    unsigned int usedInsts;
+
   public:
     explicit ForwardInstData(unsigned int width = 0);
 
@@ -276,13 +287,28 @@ class ForwardInstData /* : public ReportIF, public BubbleIF */
     /** Fill with bubbles from 0 to width() - 1 */
     void bubbleFill();
 
+    /** Drop the carried insts and return to the default constructed
+     *  (empty) state, touching only the slots used */
+    void reset();
+
     /** BubbleIF interface */
     bool isBubble() const;
 
+    /** Live bits held in a latch: those of the carried insts */
+    unsigned int liveBits() const;
+
     /** ReportIF interface */
     void reportData(std::ostream &os) const;
 };
 
 }
 
+/** Minor's latches reuse ForwardInstData slots rather than rebuilding
+ *  all MAX_FORWARD_INSTS references every cycle */
+template <>
+struct TimeBufferDefaultReset<Minor::ForwardInstData> :
+    public TimeBufferResetInPlace<Minor::ForwardInstData>
+{
+};
+
 #endif /* __CPU_MINOR_PIPE_DATA_HH__ */
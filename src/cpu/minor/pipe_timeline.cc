@@ -0,0 +1,72 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/minor/pipe_timeline.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+MinorPipeTimeline::MinorPipeTimeline(const MinorPipeTimelineParams *params)
+    : ProbeListenerObject(params),
+      timeline(simout.resolve(params->timeline_file.empty() ?
+                              ProbeListenerObject::name() + ".ptl" :
+                              params->timeline_file),
+               { "fetch", "issue", "retire" })
+{
+    // The destructor is not called, so complete the file on exit
+    Callback *cb = new MakeCallback<MinorPipeTimeline,
+        &MinorPipeTimeline::closeTimeline>(this);
+    registerExitCallback(cb);
+}
+
+void
+MinorPipeTimeline::recordCommit(const Minor::MinorDynInstPtr &inst)
+{
+    const int32_t deltas[] = {
+        PipeTimeline::delta(inst->issueTick, inst->fetchTick),
+        PipeTimeline::delta(curTick(), inst->fetchTick)
+    };
+    timeline.record(inst->id.execSeqNum, inst->pc, inst->staticInst,
+                    inst->fetchTick, deltas);
+}
+
+void
+MinorPipeTimeline::regProbeListeners()
+{
+    typedef ProbeListenerArg<MinorPipeTimeline, Minor::MinorDynInstPtr>
+        DynInstListener;
+    listeners.push_back(new DynInstListener(this, "Commit",
+                                            &MinorPipeTimeline::recordCommit));
+}
+
+MinorPipeTimeline *
+MinorPipeTimelineParams::create()
+{
+    return new MinorPipeTimeline(this);
+}
@@ -56,6 +56,7 @@ Pipeline::Pipeline(MinorCPU &cpu_, MinorCPUParams &params) :
     Ticked(cpu_, &(cpu_.BaseCPU::numCycles)),
     cpu(cpu_),
     allow_idling(params.enableIdling),
+    allow_stage_skipping(params.enableStageSkipping),
     f1ToF2(cpu.name() + ".f1ToF2", "lines",
         params.fetch1ToFetch2ForwardDelay),
     f2ToF1(cpu.name() + ".f2ToF1", "prediction",
@@ -119,15 +120,54 @@ Pipeline::minorTrace() const
     activityRecorder.minorTrace();
 }
 
+void
+Pipeline::regStats()
+{
+    Ticked::regStats();
+
+    f1ToF2.regStats();
+    f2ToF1.regStats();
+    f2ToD.regStats();
+    dToE.regStats();
+    eToF1.regStats();
+    execute.regStats();
+
+    skippedEvaluations
+        .name(cpu.name() + ".skippedStageEvaluations")
+        .desc("Number of Fetch2 and Decode evaluations skipped as the"
+            " stage had nothing to do");
+}
+
 void
 Pipeline::evaluate()
 {
     /* Note that it's important to evaluate the stages in order to allow
      *  'immediate', 0-time-offset TimeBuffer activity to be visible from
-     *  later stages to earlier ones in the same cycle */
+     *  later stages to earlier ones in the same cycle.
+     *
+     *  The order matters even with every latch delay at 1 or more, so the
+     *  stages can't be spread over host threads without changing timing:
+     *  Decode, Fetch2 and Fetch1 each reserve space in the next stage's
+     *  input buffer, which that stage has only just drained this cycle;
+     *  all stages share the activity recorder; and Fetch1 and Execute
+     *  both send through their ports into the one event queue */
     execute.evaluate();
-    decode.evaluate();
-    fetch2.evaluate();
+
+    /* Stalled or empty stages in front of Execute needn't be evaluated.
+     *  Execute and Fetch1 are always evaluated as they own the memory
+     *  ports.  MinorTrace reports every stage's state each cycle */
+    bool skip_stages = allow_stage_skipping && !DTRACE(MinorTrace);
+
+    if (skip_stages && decode.canSkipEvaluate())
+        skippedEvaluations++;
+    else
+        decode.evaluate();
+
+    if (skip_stages && fetch2.canSkipEvaluate())
+        skippedEvaluations++;
+    else
+        fetch2.evaluate();
+
     fetch1.evaluate();
 
     if (DTRACE(MinorTrace))
@@ -192,6 +232,12 @@ Pipeline::wakeupFetch()
     execute.wakeupFetch();
 }
 
+void
+Pipeline::retargetFault(long target, long target_reg)
+{
+    execute.retargetFault(target, target_reg);
+}
+
 unsigned int
 Pipeline::drain(DrainManager *manager)
 {
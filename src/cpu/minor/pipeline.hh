@@ -76,6 +76,13 @@ class Pipeline : public Ticked
     /** Allow cycles to be skipped when the pipeline is idle */
     bool allow_idling;
 
+    /** Allow Fetch2 and Decode to skip evaluation in cycles in which
+     *  they would do nothing */
+    bool allow_stage_skipping;
+
+    /** Number of Fetch2 and Decode evaluations skipped */
+    Stats::Scalar skippedEvaluations;
+
     Latch<ForwardLineData> f1ToF2;
     Latch<BranchData> f2ToF1;
     Latch<ForwardInstData> f2ToD;
@@ -133,6 +140,9 @@ class Pipeline : public Ticked
 
     void minorTrace() const;
 
+    /** Register the Ticked stats and the latches' liveness stats */
+    void regStats();
+
     /** Functions below here are BaseCPU operations passed on to pipeline
      *  stages */
 
@@ -141,6 +151,31 @@ class Pipeline : public Ticked
     /** Return the DcachePort belonging to Execute for the CPU */
     MinorCPU::MinorCPUPort &getDataPort();
 
+    /** Re-arm Execute's fault injector, see Execute::retargetFault */
+    void retargetFault(long target, long target_reg);
+
+    /** Execute's first divergence from the golden run's committed
+     *  values, see ValueTrace::divergenceReport */
+    std::string valueDivergence() const
+    { return execute.valueTrace.divergenceReport(); }
+
+    /** Has the injector seen main yet?  Carried in MinorCPU checkpoints
+     *  so restored injection runs behave like ones started from tick 0 */
+    bool insertedToMain() const { return execute.insertedTomain; }
+    void setInsertedToMain(bool inserted)
+    { execute.insertedTomain = inserted; }
+
+    /** The tracker of faults injected into the register files */
+    Minor::Taint &getTaint() { return execute.taint; }
+
+    /** The register ACE interval analysis */
+    Minor::AceAnalysis &getAce() { return execute.ace; }
+
+    Minor::ProtectionEval &getProtection() { return execute.protection; }
+
+    /** The convergence checker, to watch system call memory writes */
+    Minor::Convergence &getConvergence() { return execute.convergence; }
+
     /** To give the activity recorder to the CPU */
     MinorActivityRecorder *getActivityRecorder() { return &activityRecorder; }
 };
@@ -0,0 +1,246 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "base/loader/region_map.hh"
+#include "base/misc.hh"
+#include "cpu/minor/protection.hh"
+
+namespace Minor
+{
+
+static const char *className[ProtectionEval::NumClasses] = {
+    "original", "duplicate", "checker"
+};
+
+ProtectionEval::ProtectionEval(const std::string &name_,
+    MinorCPUParams &params) :
+    Named(name_),
+    enabled_(params.protectionEval),
+    lastStart(0),
+    lastEnd(0),
+    lastClass(Unclassified),
+    lastCommit(0),
+    started(false)
+{
+    if (!enabled_)
+        return;
+
+    if (params.protectionAnnotations != "")
+        loadAnnotations(params.protectionAnnotations);
+
+    for (auto i = params.protectionSymbols.begin();
+        i != params.protectionSymbols.end(); ++i)
+    {
+        std::string::size_type eq = i->find('=');
+
+        if (eq == std::string::npos || eq == 0) {
+            fatal("%s: protectionSymbols entry '%s' is not"
+                " symbol=class\n", name_, *i);
+        }
+        symbols[i->substr(0, eq)] = parseClass(i->substr(eq + 1), *i);
+    }
+}
+
+ProtectionEval::InstClass
+ProtectionEval::parseClass(const std::string &name, const std::string &where)
+{
+    for (unsigned int i = 0; i < NumClasses; i++) {
+        if (name == className[i])
+            return static_cast<InstClass>(i);
+    }
+
+    fatal("Unknown protection class '%s' in '%s', expected original,"
+        " duplicate or checker\n", name, where);
+}
+
+void
+ProtectionEval::loadAnnotations(const std::string &file_name)
+{
+    std::ifstream file(file_name.c_str());
+
+    if (!file)
+        fatal("%s: can't open protection annotations '%s'\n", name(),
+            file_name);
+
+    std::string line;
+    unsigned int line_no = 0;
+
+    while (std::getline(file, line)) {
+        line_no++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        Addr start, end;
+        std::string cls;
+
+        if (!(fields >> std::hex >> start))
+            continue;
+        if (!(fields >> end >> cls) || end <= start) {
+            fatal("%s: %s:%d is not 'start end class'\n", name(),
+                file_name, line_no);
+        }
+
+        auto next = ranges.lower_bound(start);
+        if ((next != ranges.end() && next->first < end) ||
+            (next != ranges.begin() && (--next)->second.end > start))
+        {
+            fatal("%s: %s:%d overlaps an earlier range\n", name(),
+                file_name, line_no);
+        }
+
+        Range &range = ranges[start];
+        range.end = end;
+        range.cls = parseClass(cls, csprintf("%s:%d", file_name, line_no));
+    }
+}
+
+ProtectionEval::InstClass
+ProtectionEval::rangeClass(Addr pc)
+{
+    /* Annotated ranges take precedence, the cached range is clipped to
+     *  the neighbouring annotations otherwise */
+    Addr start = 0;
+    Addr end = MaxAddr;
+
+    auto next = ranges.upper_bound(pc);
+    if (next != ranges.end())
+        end = next->first;
+    if (next != ranges.begin()) {
+        auto range = next;
+        --range;
+
+        if (pc < range->second.end) {
+            lastStart = range->first;
+            lastEnd = range->second.end;
+            return range->second.cls;
+        }
+        start = range->second.end;
+    }
+
+    const RegionMap::Region *region = debugRegionMap.lookup(pc);
+    if (!region) {
+        /* Nothing to cache, the symbols may not be loaded yet */
+        lastStart = lastEnd = 0;
+        return Unclassified;
+    }
+
+    lastStart = std::max(start, region->start);
+    lastEnd = std::min(end, region->end);
+
+    auto symbol = symbols.find(debugRegionMap.name(region));
+    return symbol == symbols.end() ? Unclassified : symbol->second;
+}
+
+void
+ProtectionEval::regStats(const std::string &stat_name)
+{
+    if (!enabled_)
+        return;
+
+    insts
+        .init(NumClasses)
+        .name(stat_name + ".insts")
+        .desc("Ops of each class committed in the region of interest")
+        .flags(Stats::total);
+
+    cycles
+        .init(NumClasses)
+        .name(stat_name + ".cycles")
+        .desc("Cycles from the previous commit to the commit of each"
+            " class' ops")
+        .flags(Stats::total);
+
+    fuCycles
+        .init(NumClasses)
+        .name(stat_name + ".fuCycles")
+        .desc("FU issue cycles of each class, committed or not")
+        .flags(Stats::total);
+
+    lsqCycles
+        .init(NumClasses)
+        .name(stat_name + ".lsqCycles")
+        .desc("Cycles each class' memory references spent from issue to"
+            " commit")
+        .flags(Stats::total);
+
+    aceCycles
+        .init(NumClasses)
+        .name(stat_name + ".aceCycles")
+        .desc("Register ACE cycles ending in reads by each class (needs"
+            " aceAnalysis)")
+        .flags(Stats::total);
+
+    for (unsigned int i = 0; i < NumClasses; i++) {
+        insts.subname(i, className[i]);
+        cycles.subname(i, className[i]);
+        fuCycles.subname(i, className[i]);
+        lsqCycles.subname(i, className[i]);
+        aceCycles.subname(i, className[i]);
+    }
+
+    instOverhead
+        .name(stat_name + ".instOverhead")
+        .desc("Redundant ops committed per original op")
+        .precision(6);
+    instOverhead = (insts[Duplicate] + insts[Checker]) / insts[Original];
+
+    cycleOverhead
+        .name(stat_name + ".cycleOverhead")
+        .desc("Cycles charged to redundant ops per original op cycle")
+        .precision(6);
+    cycleOverhead = (cycles[Duplicate] + cycles[Checker]) /
+        cycles[Original];
+
+    aceCoverage
+        .name(stat_name + ".aceCoverage")
+        .desc("Share of the register ACE cycles ending in redundant reads,"
+            " whose faults the protection sees")
+        .precision(6);
+    aceCoverage = (aceCycles[Duplicate] + aceCycles[Checker]) /
+        Stats::sum(aceCycles);
+}
+
+void
+ProtectionEval::commitInst(InstClass cls, bool in_roi, Cycles now,
+    Cycles lsq_cycles, Counter ace_cycles)
+{
+    if (in_roi) {
+        insts[cls]++;
+        if (started)
+            cycles[cls] += now - lastCommit;
+        lsqCycles[cls] += lsq_cycles;
+        aceCycles[cls] += ace_cycles;
+    }
+
+    lastCommit = now;
+    started = true;
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Single-run evaluation of software redundancy (SWIFT-R, ZDC) for
+ * MinorCPU.
+ */
+
+#ifndef __CPU_MINOR_PROTECTION_HH__
+#define __CPU_MINOR_PROTECTION_HH__
+
+#include <map>
+#include <string>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/minor/trace.hh"
+#include "params/MinorCPU.hh"
+
+namespace Minor
+{
+
+/** Classifies each instruction of the region of interest as original
+ *  code, a duplicate of it or a checker comparing the two, and splits
+ *  the cost and the register vulnerability of a fault-free run between
+ *  the classes.  Classes come from, in order of precedence, the address
+ *  ranges of protectionAnnotations:
+ *
+ *      # start end class, hex addresses, end exclusive
+ *      400a10 400a80 duplicate
+ *
+ *  whole functions named in protectionSymbols ("symbol=class") and, for
+ *  the SWIFT-R/ZDC "sub xzr" checks Execute already recognises, checker.
+ *  Everything else is original.  Committed ops, the cycles since the
+ *  previous commit, FU issue cycles, the LSQ residency of memory
+ *  references and the ACE cycles ending in each class' register reads
+ *  are accumulated per class, so the overhead of the protection and the
+ *  share of the vulnerability its redundant code covers come out of one
+ *  golden run rather than runs with and without protection */
+class ProtectionEval : public Named
+{
+  public:
+    enum InstClass
+    {
+        Original,
+        Duplicate,
+        Checker,
+        NumClasses,
+        /** Not in an annotated range or symbol */
+        Unclassified = NumClasses
+    };
+
+  protected:
+    const bool enabled_;
+
+    /** Annotated [start, end) ranges, by start */
+    struct Range
+    {
+        Addr end;
+        InstClass cls;
+    };
+    std::map<Addr, Range> ranges;
+
+    /** Classes of whole functions */
+    std::map<std::string, InstClass> symbols;
+
+    /** The [start, end) range and class of the last lookup.  Consecutive
+     *  commits nearly always fall in the same range */
+    Addr lastStart;
+    Addr lastEnd;
+    InstClass lastClass;
+
+    /** Cycle of the last commit, in the region of interest or not */
+    Cycles lastCommit;
+    bool started;
+
+    Stats::Vector insts;
+    Stats::Vector cycles;
+    Stats::Vector fuCycles;
+    Stats::Vector lsqCycles;
+    Stats::Vector aceCycles;
+
+    Stats::Formula instOverhead;
+    Stats::Formula cycleOverhead;
+    Stats::Formula aceCoverage;
+
+    static InstClass parseClass(const std::string &name,
+        const std::string &where);
+
+    void loadAnnotations(const std::string &file_name);
+
+    /** Class of the annotated range or symbol containing pc */
+    InstClass rangeClass(Addr pc);
+
+  public:
+    ProtectionEval(const std::string &name_, MinorCPUParams &params);
+
+    bool enabled() const { return enabled_; }
+
+    void regStats(const std::string &stat_name);
+
+    /** Class of the instruction at pc.  is_check is whether Execute
+     *  recognised it as a SWIFT-R/ZDC check */
+    InstClass
+    classify(Addr pc, bool is_check)
+    {
+        if (pc < lastStart || pc >= lastEnd)
+            lastClass = rangeClass(pc);
+
+        if (lastClass != Unclassified)
+            return lastClass;
+        return is_check ? Checker : Original;
+    }
+
+    /** Account the FU cycles of an instruction issued in the region of
+     *  interest, whether or not it commits */
+    void issueInst(InstClass cls, Cycles fu_cycles)
+    { fuCycles[cls] += fu_cycles; }
+
+    /** Account a committing op.  Ops outside the region of interest
+     *  only end the interval the next op is charged with */
+    void commitInst(InstClass cls, bool in_roi, Cycles now,
+        Cycles lsq_cycles, Counter ace_cycles);
+};
+
+}
+
+#endif /* __CPU_MINOR_PROTECTION_HH__ */
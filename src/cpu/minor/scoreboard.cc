@@ -38,6 +38,7 @@
  */
 
 #include "arch/registers.hh"
+#include "base/loader/region_map.hh"
 #include "cpu/minor/scoreboard.hh"
 #include "cpu/reg_class.hh"
 #include "debug/MinorScoreboard.hh"
@@ -114,18 +115,16 @@ flattenRegIndex(TheISA::RegIndex reg, ThreadContext *thread_context)
 
 void
 Scoreboard::markupInstDests(MinorDynInstPtr inst, Cycles retire_time,
-    ThreadContext *thread_context, bool mark_unpredictable, bool executeScoreboardFI, InstSeqNum executeFItarget)
+    ThreadContext *thread_context, bool mark_unpredictable)
 {
+    if (DTRACE(ScoreboardInst) &&
+        debugRegionMap.inROI(inst->pc.instAddr()))
+    {
+        DPRINTF(ScoreboardInst, "FunctionaName:=%s, Inst:%s:%s\n",
+            debugRegionMap.name(inst->pc.instAddr()), inst->id.execSeqNum,
+            inst->staticInst->disassemble(0));
+    }
 
-/////////////moslem fault injection 
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
-	{
-DPRINTF(ScoreboardInst, "FunctionaName:=%s, Inst:%s:%s\n",funcName, inst->id.execSeqNum,inst->staticInst->disassemble(0));
-}
-////////////////////////////////
     if (inst->isFault())
         return;
 
@@ -155,79 +154,111 @@ DPRINTF(ScoreboardInst, "FunctionaName:=%s, Inst:%s:%s\n",funcName, inst->id.exe
                 fuIndices[index] = inst->fuIndex;
             }
 
-/////////////moslem fault injection 
-	debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-	if (((funcName == "main") || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C')) && executeScoreboardFI && !faultIsInjected && executeFItarget == inst->id.execSeqNum)
-	{
-faultIsInjected=true;
-						srand (time(0));
-						int FIsite = rand()%(18);
-if (FIsite < 6)
-{
-srand (time(0));
-int error = rand()%(40);
-int faultyWritingInst = writingInst[index] + error;
-DPRINTF(ScoreboardFaultInjectionTrack, "FunctionaName:=%s, Inst:=%s\n, Fault is injected on the -Writing instruction- field of scoreboard, it was %d now it is %d",funcName, inst->staticInst->disassemble(0), writingInst[index], faultyWritingInst);
-writingInst[index] = faultyWritingInst;
+            if (DTRACE(MinorScoreboard) &&
+                debugRegionMap.inROI(inst->pc.instAddr()))
+            {
+                DPRINTF(MinorScoreboard, "Marking up inst: %s(%s)"
+                    " regIndex: %d final numResults: %d returnCycle: %d"
+                    " and fuIndex:%d\n", *inst,
+                    inst->staticInst->disassemble(0), index,
+                    numResults[index], returnCycle[index],
+                    fuIndices[index]);
+            }
+        } else {
+            /* Use ZeroReg to mark invalid/untracked dests */
+            inst->flatDestRegIdx[dest_index] = TheISA::ZeroReg;
+        }
+    }
 }
-else if (FIsite < 9)
+
+void
+Scoreboard::armFault(InstSeqNum seq_num, int index, FaultField field,
+    int bit)
 {
-srand (time(0));
-int faultyfuIndices = rand()%(10);
-DPRINTF(ScoreboardFaultInjectionTrack, "FunctionaName:=%s, Inst:=%s\n, Fault is injected on the -FU indicate- field of scoreboard, it was %d now it is %d",funcName, inst->staticInst->disassemble(0), fuIndices[index], faultyfuIndices);
-fuIndices[index] = faultyfuIndices;
+    faultSeqNum = seq_num;
+    faultIndex = index;
+    faultField = field;
+    faultBit = bit;
+    faultIsInjected = false;
 }
-else if (FIsite < 12)
+
+/** Width in bits of a scoreboard field */
+static unsigned int
+faultFieldBits(Scoreboard::FaultField field)
 {
-srand (time(0));
-Cycles faultyReturnCycle = Cycles(rand()%(50));
-srand (time(0));
-int t = rand()%(2);
-if (t)
-faultyReturnCycle += returnCycle[index];
-else
-faultyReturnCycle = returnCycle[index] - faultyReturnCycle;
-
-DPRINTF(ScoreboardFaultInjectionTrack, "FunctionaName:=%s, Inst:=%s\n, Fault is injected on the -return cycle- field of scoreboard, it was %d now it is %d",funcName, inst->staticInst->disassemble(0), returnCycle[index], faultyReturnCycle);
-returnCycle[index] = faultyReturnCycle;
+    switch (field) {
+      case Scoreboard::WritingInstField:
+        return sizeof(InstSeqNum) * 8;
+      case Scoreboard::FuIndexField:
+        return sizeof(int) * 8;
+      case Scoreboard::ReturnCycleField:
+        return sizeof(Cycles) * 8;
+      case Scoreboard::NumResultsField:
+        return sizeof(Scoreboard::Index) * 8;
+      default:
+        return 0;
+    }
 }
-else if (FIsite < 14)
+
+void
+Scoreboard::injectFault(MinorDynInstPtr inst)
 {
-int faultynumResults=numResults[index];
-srand (time(0));
-int t = rand()%(2);
-t++;
-if(t%2)
-	faultynumResults++;
-else 
-	faultynumResults--;
-if(faultynumResults < 0 ) faultynumResults =3;
-
-DPRINTF(ScoreboardFaultInjectionTrack, "FunctionaName:=%s, Inst:=%s\n, Fault is injected on the -Num results- field of scoreboard, it was %d now it is %d",funcName, inst->staticInst->disassemble(0), numResults[index], faultynumResults);
-numResults[index] = faultynumResults;
-}
+    /* Whatever happens, the fault has had its one chance */
+    faultIsInjected = true;
 
-}
-////////////////////////////////
-/////////////moslem adds IF
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
-	{
+    if (!debugRegionMap.inROI(inst->pc.instAddr()))
+        return;
 
-            DPRINTF(MinorScoreboard, "Marking up inst: %s(%s)"
-                " regIndex: %d final numResults: %d returnCycle: %d and fuIndex:%d\n",
-               // *inst, index, numResults[index], returnCycle[index]);
-		*inst,inst->staticInst->disassemble(0), index, numResults[index], returnCycle[index], fuIndices[index]);
-}
+    Index index = faultIndex;
+    if (faultIndex < 0) {
+        /* The first destination the markup tracked */
+        StaticInstPtr staticInst = inst->staticInst;
+        unsigned int dest_index = 0;
 
-///////////
-        } else {
-            /* Use ZeroReg to mark invalid/untracked dests */
-            inst->flatDestRegIdx[dest_index] = TheISA::ZeroReg;
+        while (dest_index < staticInst->numDestRegs() &&
+            !findIndex(inst->flatDestRegIdx[dest_index], index))
+        {
+            dest_index++;
+        }
+
+        if (inst->isFault() || dest_index == staticInst->numDestRegs()) {
+            DPRINTF(ScoreboardFaultInjectionTrack, "Inst: %s has no"
+                " scoreboard destination, nothing to corrupt\n", *inst);
+            return;
         }
+    } else if (faultIndex >= int(numRegs)) {
+        warn("%s: scoreboard fault index %d out of range\n", name(),
+            faultIndex);
+        return;
+    }
+
+    FaultField field = (faultField == NumFaultFields ?
+        FaultField(faultInjector.random(NumFaultFields)) : faultField);
+    unsigned int bits = faultFieldBits(field);
+    unsigned int bit = (faultBit < 0 ? faultInjector.random(bits) :
+        faultBit % bits);
+
+    switch (field) {
+      case WritingInstField:
+        writingInst[index] ^= InstSeqNum(1) << bit;
+        break;
+      case FuIndexField:
+        fuIndices[index] ^= 1 << bit;
+        break;
+      case ReturnCycleField:
+        returnCycle[index] = Cycles(uint64_t(returnCycle[index]) ^
+            (uint64_t(1) << bit));
+        break;
+      case NumResultsField:
+        numResults[index] ^= Index(1) << bit;
+        break;
+      default:
+        break;
     }
+
+    DPRINTF(ScoreboardFaultInjectionTrack, "Fault injected in scoreboard"
+        " entry %d field %d bit %d after marking up inst: %s in %s\n",
+        index, field, bit, *inst, debugRegionMap.name(inst->pc.instAddr()));
 }
 
 InstSeqNum
@@ -253,10 +284,7 @@ Scoreboard::execSeqNumToWaitFor(MinorDynInstPtr inst,
         }
     }
 /////////////moslem adds IF
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
+	if (debugRegionMap.inROI(inst->pc.instAddr()))
 	{
     DPRINTF(MinorScoreboard, "Inst: %s(%s) depends on execSeqNum: %d\n",
         *inst, inst->staticInst->disassemble(0), ret);
@@ -293,10 +321,7 @@ Scoreboard::clearInstDests(MinorDynInstPtr inst, bool clear_unpredictable)
                 writingInst[index] = 0;
                 fuIndices[index] = -1;
             }
-	std::string funcName="nothing";
-	Addr sym_addr;
-	debugSymbolTable->findNearestSymbol(inst->pc.instAddr() , funcName, sym_addr);
-	if (funcName == "main" || (funcName[0] == 'F' &&  funcName[1] == 'U' && funcName[2] == 'N' && funcName[3] == 'C'))
+	if (debugRegionMap.inROI(inst->pc.instAddr()))
 	{
             DPRINTF(MinorScoreboard, "Clearing inst: %s(%s)"
                 " regIndex: %d final numResults: %d\n",
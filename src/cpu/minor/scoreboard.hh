@@ -46,6 +46,7 @@
 #ifndef __CPU_MINOR_SCOREBOARD_HH__
 #define __CPU_MINOR_SCOREBOARD_HH__
 
+#include "cpu/fault_injector.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/minor/dyn_inst.hh"
 #include "cpu/minor/trace.hh"
@@ -92,12 +93,36 @@ class Scoreboard : public Named
     /** The execute sequence number of the most recent inst to generate this
      *  register value */
     std::vector<InstSeqNum> writingInst;
-//moslem
 
-bool faultIsInjected=false;
+    /** Fields of an entry which can be corrupted */
+    enum FaultField
+    {
+        WritingInstField,
+        FuIndexField,
+        ReturnCycleField,
+        NumResultsField,
+        NumFaultFields
+    };
+
+    /** Has the armed fault been injected? */
+    bool faultIsInjected;
+
+  protected:
+    /** Source of random choices when corrupting scoreboard entries */
+    FaultInjector &faultInjector;
+
+    /** The armed fault: the execute seqnum of the instruction whose
+     *  markup triggers it (0 when nothing is armed), the scoreboard index
+     *  to corrupt (-1 for the first destination of that instruction),
+     *  the field (NumFaultFields for a random one) and the bit (-1 for a
+     *  random one) */
+    InstSeqNum faultSeqNum;
+    int faultIndex;
+    FaultField faultField;
+    int faultBit;
 
   public:
-    Scoreboard(const std::string &name) :
+    Scoreboard(const std::string &name, FaultInjector &fault_injector) :
         Named(name),
         numRegs(TheISA::NumIntRegs + TheISA::NumCCRegs +
             TheISA::NumFloatRegs),
@@ -105,7 +130,13 @@ bool faultIsInjected=false;
         numUnpredictableResults(numRegs, 0),
         fuIndices(numRegs, 0),
         returnCycle(numRegs, Cycles(0)),
-        writingInst(numRegs, 0)
+        writingInst(numRegs, 0),
+        faultIsInjected(false),
+        faultInjector(fault_injector),
+        faultSeqNum(0),
+        faultIndex(-1),
+        faultField(NumFaultFields),
+        faultBit(-1)
     { }
 
   public:
@@ -119,7 +150,26 @@ bool faultIsInjected=false;
      *  destination registers are marked as being unpredictable without
      *  an estimated retire time */
     void markupInstDests(MinorDynInstPtr inst, Cycles retire_time,
-        ThreadContext *thread_context, bool mark_unpredictable,  bool executeScoreboardFI, InstSeqNum executeFItarget);
+        ThreadContext *thread_context, bool mark_unpredictable);
+
+    /** Arm a single bit flip in field of entry index, applied by
+     *  injectFault once the instruction with execute seqnum seq_num has
+     *  been marked up.  index, field and bit may be left to random
+     *  choice, see faultSeqNum.  Forgets any fault already injected */
+    void armFault(InstSeqNum seq_num, int index = -1,
+        FaultField field = NumFaultFields, int bit = -1);
+
+    /** Should injectFault be called after marking up the instruction with
+     *  this seqnum?  This is the only cost of an armed fault in the
+     *  markup path */
+    bool
+    faultPending(InstSeqNum seq_num) const
+    {
+        return faultSeqNum == seq_num && !faultIsInjected;
+    }
+
+    /** Apply the armed fault.  inst must have just been marked up */
+    void injectFault(MinorDynInstPtr inst);
 
     /** Clear down the dependencies for this instruction.  clear_unpredictable
      *  must match mark_unpredictable for the same inst. */
@@ -42,11 +42,14 @@
 namespace Minor
 {
 
-MinorStats::MinorStats()
+MinorStats::MinorStats() :
+    numFuncs(1)
 { }
 
 void
-MinorStats::regStats(const std::string &name, BaseCPU &baseCpu)
+MinorStats::regStats(const std::string &name, BaseCPU &baseCpu,
+    unsigned int input_buffer_size, unsigned int lsq_size,
+    unsigned int num_fus)
 {
     numInsts
         .name(name + ".committedInsts")
@@ -89,97 +92,76 @@ numUnnecessaryInst
     tickCyclesMain
         .name(name + ".tickCyclesMain")
         .desc("Number of cycles which we spend in Main functions");
-Inst0InIQ
-
-                                .name(name + ".Inst0InIQ")
-                                .desc("The number of tickes that there is 0 instruction in IQ.");
-Inst1InIQ
-
-                                .name(name + ".Inst1InIQ")
-                                .desc("The number of tickes that there is 1 instruction in IQ.");
-Inst2InIQ
-
-                                .name(name + ".Inst2InIQ")
-                                .desc("The number of tickes that there is 2 instruction in IQ.");
-Inst3InIQ
-
-                                .name(name + ".Inst3InIQ")
-                                .desc("The number of tickes that there is 3 instruction in IQ.");
-Inst4InIQ
-
-                                .name(name + ".Inst4InIQ")
-                                .desc("The number of tickes that there is 4 instruction in IQ.");
-Inst5InIQ
-
-                                .name(name + ".Inst5InIQ")
-                                .desc("The number of tickes that there is 5 instruction in IQ.");
-Inst6InIQ
-
-                                .name(name + ".Inst6InIQ")
-                                .desc("The number of tickes that there is 6 instruction in IQ.");
-Inst7InIQ
-
-                                .name(name + ".Inst7InIQ")
-                                .desc("The number of tickes that there is 7 instruction in IQ.");
-//LSQ
-Inst0InLSQ
-
-                                .name(name + ".Inst0InLSQ")
-                                .desc("The number of tickes that there is 0 instruction in LSQ.");
-Inst1InLSQ
-
-                                .name(name + ".Inst1InLSQ")
-                                .desc("The number of tickes that there is 1 instruction in LSQ.");
-Inst2InLSQ
-
-                                .name(name + ".Inst2InLSQ")
-                                .desc("The number of tickes that there is 2 instruction in LSQ.");
-Inst3InLSQ
-
-                                .name(name + ".Inst3InLSQ")
-                                .desc("The number of tickes that there is 3 instruction in LSQ.");
-Inst4InLSQ
-
-                                .name(name + ".Inst4InLSQ")
-                                .desc("The number of tickes that there is 4 instruction in LSQ.");
-Inst5InLSQ
-
-                                .name(name + ".Inst5InLSQ")
-                                .desc("The number of tickes that there is 5 instruction in LSQ.");
-Inst6InLSQ
-
-                                .name(name + ".Inst6InLSQ")
-                                .desc("The number of tickes that there is 6 instruction in LSQ.");
-Inst7InLSQ
-
-                                .name(name + ".Inst7InLSQ")
-                                .desc("The number of tickes that there is 7 instruction in LSQ.");
-Inst8InLSQ
-
-                                .name(name + ".Inst8InLSQ")
-                                .desc("The number of tickes that there is 8 instruction in LSQ.");
-FU0isBusy
-                                .name(name + ".FU0isBusy")
-                                .desc("The number of tickes that functional unit 0 was busy.");
-FU1isBusy
-                                .name(name + ".FU1isBusy")
-                                .desc("The number of tickes that functional unit 1 was busy.");
-FU2isBusy
-                                .name(name + ".FU2isBusy")
-                                .desc("The number of tickes that functional unit 2 was busy.");
-FU3isBusy
-                                .name(name + ".FU3isBusy")
-                                .desc("The number of tickes that functional unit 3 was busy.");
-FU4isBusy
-                                .name(name + ".FU4isBusy")
-                                .desc("The number of tickes that functional unit 4 was busy.");
-FU5isBusy
-                                .name(name + ".FU5isBusy")
-                                .desc("The number of tickes that functional unit 5 was busy.");
-FU6isBusy
-                                .name(name + ".FU6isBusy")
-                                .desc("The number of tickes that functional unit 6 was busy.");
 
+    instsInIQ
+        .init(input_buffer_size + 1)
+        .name(name + ".instsInIQ")
+        .desc("Number of cycles in main with each number of instructions"
+            " in the Execute input buffer");
+
+    instsInLSQ
+        .init(lsq_size + 1)
+        .name(name + ".instsInLSQ")
+        .desc("Number of cycles in main with each number of entries in"
+            " the LSQ queues and store buffer");
+
+    fuBusyCycles
+        .init(num_fus)
+        .name(name + ".fuBusyCycles")
+        .desc("Number of cycles in main that each functional unit was"
+            " busy");
+
+    for (unsigned int i = 0; i <= input_buffer_size; i++)
+        instsInIQ.subname(i, csprintf("%d", i));
+    for (unsigned int i = 0; i <= lsq_size; i++)
+        instsInLSQ.subname(i, csprintf("%d", i));
+    for (unsigned int i = 0; i < num_fus; i++)
+        fuBusyCycles.subname(i, csprintf("FU%d", i));
+
+    numFuncs = debugRegionMap.numFuncIds();
+
+    tickCyclesFunc
+        .init(numFuncs)
+        .name(name + ".tickCyclesFunc")
+        .desc("Number of cycles spent in each region of interest function")
+        .flags(Stats::total | Stats::nozero);
+
+    committedInstsFunc
+        .init(numFuncs)
+        .name(name + ".committedInstsFunc")
+        .desc("Number of instructions committed in each region of interest"
+            " function")
+        .flags(Stats::total | Stats::nozero);
+
+    unnecessaryInstsFunc
+        .init(numFuncs)
+        .name(name + ".unnecessaryCommittedInstsFunc")
+        .desc("Number of SWIFT/ZDC unnecessary instructions committed in"
+            " each region of interest function")
+        .flags(Stats::total | Stats::nozero);
+
+    for (unsigned int i = 0; i < numFuncs; i++) {
+        const std::string &func_name = debugRegionMap.funcName(i);
+
+        tickCyclesFunc.subname(i, func_name);
+        committedInstsFunc.subname(i, func_name);
+        unnecessaryInstsFunc.subname(i, func_name);
+    }
+}
+
+void
+MinorStats::countOccupancy(const ExecuteOccupancy &occupancy)
+{
+    if (!occupancy.inROI)
+        return;
+
+    for (unsigned int i = 0; i < occupancy.fuBusy.size(); i++) {
+        if (occupancy.fuBusy[i])
+            fuBusyCycles[i]++;
+    }
+
+    instsInIQ[occupancy.inputInsts]++;
+    instsInLSQ[occupancy.lsqEntries]++;
 }
 
 };
@@ -46,6 +46,9 @@
 #ifndef __CPU_MINOR_STATS_HH__
 #define __CPU_MINOR_STATS_HH__
 
+#include <vector>
+
+#include "base/loader/region_map.hh"
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "sim/ticked_object.hh"
@@ -53,6 +56,26 @@
 namespace Minor
 {
 
+/** Snapshot of Execute's occupancy, passed to the ExecuteOccupancy
+ *  probe point once per Execute cycle */
+struct ExecuteOccupancy
+{
+    /** Instructions waiting in Execute's input buffer */
+    unsigned int inputInsts;
+
+    /** Entries in the LSQ's requests and transfers queues */
+    unsigned int lsqEntries;
+
+    /** Are these FUs unable to accept an instruction this cycle? */
+    std::vector<bool> fuBusy;
+
+    /** Is the CPU executing in the fault injection region of interest? */
+    bool inROI;
+
+    ExecuteOccupancy() : inputInsts(0), lsqEntries(0), inROI(false)
+    { }
+};
+
 /** Currently unused stats class. */
 class MinorStats
 {
@@ -79,42 +102,48 @@ class MinorStats
     Stats::Formula cpi;
     Stats::Formula ipc;
 /////fault injection
-Stats::Scalar Inst0InIQ;
-Stats::Scalar Inst1InIQ;
-Stats::Scalar Inst2InIQ;
-Stats::Scalar Inst3InIQ;
-Stats::Scalar Inst4InIQ;
-Stats::Scalar Inst5InIQ;
-Stats::Scalar Inst6InIQ;
-Stats::Scalar Inst7InIQ;
-
-Stats::Scalar Inst0InLSQ;
-Stats::Scalar Inst1InLSQ;
-Stats::Scalar Inst2InLSQ;
-Stats::Scalar Inst3InLSQ;
-Stats::Scalar Inst4InLSQ;
-Stats::Scalar Inst5InLSQ;
-Stats::Scalar Inst6InLSQ;
-Stats::Scalar Inst7InLSQ;
-Stats::Scalar Inst8InLSQ;
-
-Stats::Scalar  FU0isBusy;
-Stats::Scalar  FU1isBusy;
-Stats::Scalar  FU2isBusy;
-Stats::Scalar  FU3isBusy;
-Stats::Scalar  FU4isBusy;
-Stats::Scalar  FU5isBusy;
-Stats::Scalar  FU6isBusy;
-
+    /** Cycles in the ROI with each number of instructions in the
+     *  Execute input buffer, LSQ and each FU busy.  Sized from the
+     *  configuration so the dead-interval statistics are right for any
+     *  buffer sizes and FU pool */
+    Stats::Vector instsInIQ;
+    Stats::Vector instsInLSQ;
+    Stats::Vector fuBusyCycles;
 
     Stats::Scalar tickCyclesMain;
+
+    /** Per region of interest function breakdowns, indexed by
+     *  RegionMap function ID */
+    Stats::Vector tickCyclesFunc;
+    Stats::Vector committedInstsFunc;
+    Stats::Vector unnecessaryInstsFunc;
 ///////////////////////
 
+  protected:
+    /** Size of the per-function vectors */
+    unsigned int numFuncs;
+
   public:
     MinorStats();
 
   public:
-    void regStats(const std::string &name, BaseCPU &baseCpu);
+    /** Index into the per-function vectors of the function containing
+     *  pc.  Functions given IDs after the vectors were sized (symbols
+     *  loaded late) count as other */
+    unsigned int
+    funcIndex(Addr pc) const
+    {
+        unsigned int func_id = debugRegionMap.funcId(pc);
+        return func_id < numFuncs ? func_id : RegionMap::otherFuncId;
+    }
+
+    /** Account one cycle of Execute occupancy to the dead-interval
+     *  stats.  Cycles outside the region of interest are not counted */
+    void countOccupancy(const ExecuteOccupancy &occupancy);
+
+    void regStats(const std::string &name, BaseCPU &baseCpu,
+        unsigned int input_buffer_size, unsigned int lsq_size,
+        unsigned int num_fus);
 };
 
 }
@@ -0,0 +1,284 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "base/output.hh"
+#include "cpu/minor/taint.hh"
+#include "cpu/reg_class.hh"
+#include "debug/MinorTaint.hh"
+
+namespace Minor
+{
+
+const char *Taint::eventNames[NumEvents] = {
+    "reached_memory",
+    "reached_branch",
+    "reached_syscall"
+};
+
+Taint::Taint(const std::string &name_, unsigned int line_size) :
+    Named(name_),
+    lineSize(line_size),
+    injected(0),
+    numTainted(0),
+    memAccessPending(false),
+    memAccessAddr(0),
+    memAccessSize(0),
+    eventStream(NULL)
+{
+    std::fill(intTaint, intTaint + TheISA::NumIntRegs, 0);
+    std::fill(floatTaint, floatTaint + TheISA::NumFloatRegs, 0);
+    std::fill(ccTaint, ccTaint + TheISA::NumCCRegs, 0);
+    std::fill(reached, reached + NumEvents, 0);
+}
+
+uint64_t *
+Taint::regTaint(TheISA::RegIndex reg_idx)
+{
+    /* Guard regIdxToClass against out of range indices */
+    if (reg_idx >= TheISA::Max_Reg_Index)
+        return NULL;
+
+    TheISA::RegIndex rel_idx;
+
+    switch (regIdxToClass(reg_idx, &rel_idx)) {
+      case IntRegClass:
+        if (rel_idx == TheISA::ZeroReg || rel_idx >= TheISA::NumIntRegs)
+            return NULL;
+        return &intTaint[rel_idx];
+      case FloatRegClass:
+        return (rel_idx < TheISA::NumFloatRegs ?
+            &floatTaint[rel_idx] : NULL);
+      case CCRegClass:
+        return (rel_idx < TheISA::NumCCRegs ? &ccTaint[rel_idx] : NULL);
+      default:
+        return NULL;
+    }
+}
+
+void
+Taint::setTaint(uint64_t &taint, uint64_t value)
+{
+    if (taint == 0 && value != 0)
+        numTainted++;
+    else if (taint != 0 && value == 0)
+        numTainted--;
+
+    taint = value;
+}
+
+void
+Taint::reach(Event event, uint64_t faults, Addr pc,
+    const StaticInstPtr &static_inst)
+{
+    uint64_t new_faults = faults & ~reached[event];
+
+    if (new_faults == 0)
+        return;
+
+    reached[event] |= new_faults;
+
+    if (!eventStream) {
+        eventStream = simout.create("fault_propagation.txt");
+        *eventStream << "# tick fault event pc inst\n";
+    }
+
+    for (unsigned int fault = 0; fault < 64; fault++) {
+        if (new_faults & (ULL(1) << fault)) {
+            DPRINTF(MinorTaint, "Fault %d %s at pc: %#x\n", fault,
+                eventNames[event], pc);
+
+            *eventStream << curTick() << ' ' << fault << ' ' <<
+                eventNames[event] << ' ' << std::hex << pc << std::dec <<
+                ' ' << static_inst->disassemble(pc) << '\n';
+        }
+    }
+
+    eventStream->flush();
+}
+
+uint64_t
+Taint::readLines(Addr addr, unsigned int size) const
+{
+    uint64_t taint = 0;
+
+    if (lineTaint.empty() || size == 0)
+        return 0;
+
+    for (Addr line = addr & ~Addr(lineSize - 1); line < addr + size;
+        line += lineSize)
+    {
+        LineMap::const_iterator found = lineTaint.find(line);
+
+        if (found != lineTaint.end())
+            taint |= found->second;
+    }
+
+    return taint;
+}
+
+void
+Taint::writeLines(Addr addr, unsigned int size, uint64_t taint)
+{
+    if (size == 0)
+        return;
+
+    for (Addr line = addr & ~Addr(lineSize - 1); line < addr + size;
+        line += lineSize)
+    {
+        if (taint != 0) {
+            lineTaint[line] |= taint;
+        } else if (line >= addr && line + lineSize <= addr + size) {
+            lineTaint.erase(line);
+        }
+    }
+}
+
+void
+Taint::inject(RegFileFaultSite::RegFile reg_file, unsigned int index,
+    unsigned int fault)
+{
+    uint64_t *taint = NULL;
+
+    switch (reg_file) {
+      case RegFileFaultSite::IntRegs:
+        taint = &intTaint[index];
+        break;
+      case RegFileFaultSite::FloatRegs:
+        taint = &floatTaint[index];
+        break;
+      case RegFileFaultSite::CCRegs:
+        taint = &ccTaint[index];
+        break;
+    }
+
+    DPRINTF(MinorTaint, "Fault %d tainted register file %d entry %d\n",
+        fault, reg_file, index);
+
+    injected |= ULL(1) << fault;
+    setTaint(*taint, *taint | (ULL(1) << fault));
+}
+
+void
+Taint::commitInst(const StaticInstPtr &static_inst, Addr pc)
+{
+    uint64_t src_taint = 0;
+
+    for (int i = 0; i < static_inst->numSrcRegs(); i++) {
+        uint64_t *taint = regTaint(static_inst->srcRegIdx(i));
+
+        if (taint)
+            src_taint |= *taint;
+    }
+
+    if (static_inst->isControl() && src_taint != 0)
+        reach(ReachedBranch, src_taint, pc, static_inst);
+
+    if (static_inst->isSyscall()) {
+        /* System call operands are not instruction sources.  The
+         *  argument registers and, on AArch64, the call number register
+         *  X8 follow the argument registers */
+        uint64_t arg_taint = 0;
+
+        for (int i = 0; i <= TheISA::NumArgumentRegs64; i++)
+            arg_taint |= intTaint[i];
+
+        if (arg_taint != 0)
+            reach(ReachedSyscall, arg_taint, pc, static_inst);
+    }
+
+    if (memAccessPending) {
+        memAccessPending = false;
+
+        if (static_inst->isStore()) {
+            if (src_taint != 0)
+                reach(ReachedMemory, src_taint, pc, static_inst);
+            writeLines(memAccessAddr, memAccessSize, src_taint);
+        } else if (static_inst->isLoad()) {
+            src_taint |= readLines(memAccessAddr, memAccessSize);
+        }
+    }
+
+    for (int i = 0; i < static_inst->numDestRegs(); i++) {
+        uint64_t *taint = regTaint(static_inst->destRegIdx(i));
+
+        if (taint)
+            setTaint(*taint, src_taint);
+    }
+}
+
+bool
+Taint::isTainted(RegFileFaultSite::RegFile reg_file,
+    unsigned int index) const
+{
+    switch (reg_file) {
+      case RegFileFaultSite::IntRegs:
+        return intTaint[index] != 0;
+      case RegFileFaultSite::FloatRegs:
+        return floatTaint[index] != 0;
+      case RegFileFaultSite::CCRegs:
+        return ccTaint[index] != 0;
+    }
+
+    return false;
+}
+
+std::string
+Taint::outcome(unsigned int fault) const
+{
+    uint64_t bit = ULL(1) << fault;
+
+    if (!(injected & bit))
+        return "not_injected";
+
+    /* The furthest a fault has got outside the register files */
+    if (reached[ReachedSyscall] & bit)
+        return eventNames[ReachedSyscall];
+    else if (reached[ReachedMemory] & bit)
+        return eventNames[ReachedMemory];
+    else if (reached[ReachedBranch] & bit)
+        return eventNames[ReachedBranch];
+
+    uint64_t live = 0;
+    for (unsigned int i = 0; i < TheISA::NumIntRegs; i++)
+        live |= intTaint[i];
+    for (unsigned int i = 0; i < TheISA::NumFloatRegs; i++)
+        live |= floatTaint[i];
+    for (unsigned int i = 0; i < TheISA::NumCCRegs; i++)
+        live |= ccTaint[i];
+
+    for (LineMap::const_iterator i = lineTaint.begin();
+        i != lineTaint.end(); ++i)
+    {
+        live |= i->second;
+    }
+
+    return (live & bit ? "latent" : "masked");
+}
+
+}
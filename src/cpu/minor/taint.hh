@@ -0,0 +1,187 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Per-fault taint tracking through the architectural registers so that
+ *  several faults injected in one run can be given separate outcomes.
+ */
+
+#ifndef __CPU_MINOR_TAINT_HH__
+#define __CPU_MINOR_TAINT_HH__
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "arch/registers.hh"
+#include "base/types.hh"
+#include "cpu/fault_injector.hh"
+#include "cpu/minor/trace.hh"
+#include "cpu/static_inst.hh"
+
+namespace Minor
+{
+
+/** Taint masks for thread 0's architectural registers and for the
+ *  cache lines it has stored to.  Bit n of a mask is set while the value
+ *  depends on fault n of the injector's batch.  Taint is propagated at
+ *  commit from the union of an instruction's sources (and, for loads,
+ *  the lines read) to all its destinations (and, for stores, the lines
+ *  written) so a value overwritten with untainted data stops carrying
+ *  the fault.
+ *
+ *  The first time a fault reaches memory, the condition or target of a
+ *  control instruction, or the arguments of a system call a line is
+ *  written to fault_propagation.txt so no instruction tracing is needed
+ *  to follow faults.
+ *
+ *  Registers are indexed as StaticInst operands and FItargetReg are,
+ *  before flattening, which is also the indexing the ThreadContext
+ *  accessors used by the register file fault sites take.  Lines are
+ *  indexed by virtual address */
+class Taint : public Named, public FaultTracker
+{
+  protected:
+    /** Places a fault can reach, as bits of a per-fault mask */
+    enum Event
+    {
+        ReachedMemory,
+        ReachedBranch,
+        ReachedSyscall,
+        NumEvents
+    };
+
+    static const char *eventNames[NumEvents];
+
+    uint64_t intTaint[TheISA::NumIntRegs];
+    uint64_t floatTaint[TheISA::NumFloatRegs];
+    uint64_t ccTaint[TheISA::NumCCRegs];
+
+    /** Tainted lines only, by line address */
+    typedef std::unordered_map<Addr, uint64_t> LineMap;
+    LineMap lineTaint;
+
+    const unsigned int lineSize;
+
+    /** Faults which have been injected */
+    uint64_t injected;
+
+    /** Faults which have reached each Event */
+    uint64_t reached[NumEvents];
+
+    /** Number of registers with a non-zero mask */
+    unsigned int numTainted;
+
+    /** The data access of the instruction about to commit, set by
+     *  memAccess */
+    bool memAccessPending;
+    Addr memAccessAddr;
+    unsigned int memAccessSize;
+
+    /** Propagation events, opened on the first event */
+    std::ostream *eventStream;
+
+    /** The mask of a unified register index, NULL for misc and other
+     *  untracked registers */
+    uint64_t *regTaint(TheISA::RegIndex reg_idx);
+
+    /** Set a register's mask keeping numTainted right */
+    void setTaint(uint64_t &taint, uint64_t value);
+
+    /** Note faults reaching an event, reporting the ones which have not
+     *  reached it before */
+    void reach(Event event, uint64_t faults, Addr pc,
+        const StaticInstPtr &static_inst);
+
+    /** Union of the masks of the lines covering an access */
+    uint64_t readLines(Addr addr, unsigned int size) const;
+
+    /** Store taint into the lines covering an access.  Untainted stores
+     *  only clear the taint of lines they completely overwrite */
+    void writeLines(Addr addr, unsigned int size, uint64_t taint);
+
+  public:
+    Taint(const std::string &name_, unsigned int line_size);
+
+    /** Is anything tainted?  When not, commit costs nothing */
+    bool active() const { return numTainted != 0 || !lineTaint.empty(); }
+
+    /** Give the data access of the memory reference instruction which
+     *  is about to commit */
+    void
+    memAccess(Addr addr, unsigned int size)
+    {
+        memAccessPending = true;
+        memAccessAddr = addr;
+        memAccessSize = size;
+    }
+
+    /** Record that fault has been injected into a register */
+    void inject(RegFileFaultSite::RegFile reg_file, unsigned int index,
+        unsigned int fault);
+
+    /** Propagate taint through a committing instruction */
+    void commitInst(const StaticInstPtr &static_inst, Addr pc);
+
+    /** Is the register already carrying a fault? */
+    bool isTainted(RegFileFaultSite::RegFile reg_file,
+        unsigned int index) const;
+
+    std::string outcome(unsigned int fault) const;
+};
+
+/** A register file fault site which taints the corrupted register */
+class TaintedRegFileFaultSite : public RegFileFaultSite
+{
+  protected:
+    Taint &taint;
+
+  public:
+    TaintedRegFileFaultSite(ThreadContext *thread_, RegFile reg_file,
+        Taint &taint_) :
+        RegFileFaultSite(thread_, reg_file), taint(taint_)
+    { }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        RegFileFaultSite::flipBit(index, bit, fault);
+        taint.inject(regFile, index, fault);
+    }
+
+    bool
+    isFaulty(unsigned int index) const
+    {
+        return taint.isTainted(regFile, index);
+    }
+};
+
+}
+
+#endif /* __CPU_MINOR_TAINT_HH__ */
@@ -0,0 +1,189 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fstream>
+
+#include "arch/registers.hh"
+#include "base/cprintf.hh"
+#include "base/loader/region_map.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "cpu/minor/value_trace.hh"
+#include "cpu/reg_class.hh"
+#include "cpu/thread_context.hh"
+#include "debug/MinorValueTrace.hh"
+
+namespace Minor
+{
+
+static const uint64_t digestSeed = ULL(14695981039346656037);
+
+ValueTrace::ValueTrace(const std::string &name_, MinorCPUParams &params) :
+    Named(name_),
+    interval(params.valueTraceInterval),
+    record(params.valueTraceRecord),
+    digest(digestSeed),
+    numInsts(0),
+    traceOut(NULL),
+    diverged_(false)
+{
+    if (!enabled())
+        return;
+
+    const std::string &trace = params.valueTrace;
+
+    if (trace == "")
+        fatal("%s: valueTraceInterval needs a valueTrace\n", name_);
+
+    if (record) {
+        traceOut = simout.create(trace, true);
+    } else {
+        std::ifstream in(trace.c_str(), std::ios::binary);
+        if (!in)
+            fatal("%s: can't open value trace: %s\n", name_, trace);
+
+        uint32_t golden_digest;
+        while (in.read(reinterpret_cast<char *>(&golden_digest),
+            sizeof(golden_digest)))
+        {
+            golden.push_back(golden_digest);
+        }
+
+        DPRINTF(MinorValueTrace, "Read %d golden digests from %s\n",
+            golden.size(), trace);
+    }
+}
+
+ValueTrace::~ValueTrace()
+{
+    if (traceOut)
+        simout.close(traceOut);
+}
+
+void
+ValueTrace::digestBytes(const void *bytes, size_t size)
+{
+    /* 64 bit FNV-1a, as Convergence uses */
+    const uint8_t *p = static_cast<const uint8_t *>(bytes);
+
+    for (size_t i = 0; i < size; i++) {
+        digest ^= p[i];
+        digest *= ULL(1099511628211);
+    }
+}
+
+void
+ValueTrace::recordStore(Addr vaddr, unsigned int size, const uint8_t *data)
+{
+    digestBytes(&vaddr, sizeof(vaddr));
+    digestBytes(data, size);
+}
+
+bool
+ValueTrace::commitInst(MinorDynInstPtr inst, ThreadContext *thread)
+{
+    StaticInstPtr static_inst = inst->staticInst;
+    Addr pc = inst->pc.instAddr();
+
+    digestBytes(&pc, sizeof(pc));
+
+    for (unsigned int i = 0; i < static_inst->numDestRegs(); i++) {
+        TheISA::RegIndex reg = inst->flatDestRegIdx[i];
+        TheISA::RegIndex rel_reg;
+        uint64_t value;
+
+        /* Guard regIdxToClass against out of range indices */
+        if (reg >= TheISA::Max_Reg_Index)
+            continue;
+
+        switch (regIdxToClass(reg, &rel_reg)) {
+          case IntRegClass:
+            value = thread->readIntRegFlat(rel_reg);
+            break;
+          case FloatRegClass:
+            value = thread->readFloatRegBitsFlat(rel_reg);
+            break;
+          case CCRegClass:
+            value = thread->readCCRegFlat(rel_reg);
+            break;
+          default:
+            /* Misc. registers are left to Convergence's state hashes */
+            continue;
+        }
+
+        digestBytes(&reg, sizeof(reg));
+        digestBytes(&value, sizeof(value));
+    }
+
+    if (static_inst->isMicroop() && !static_inst->isLastMicroop())
+        return false;
+
+    numInsts++;
+    if (numInsts % interval != 0)
+        return false;
+
+    bool first_divergence = false;
+    uint32_t closed = digest ^ (digest >> 32);
+    Counter index = numInsts / interval - 1;
+
+    digest = digestSeed;
+
+    if (record) {
+        traceOut->write(reinterpret_cast<const char *>(&closed),
+            sizeof(closed));
+    } else if (!diverged_ && index < golden.size() &&
+        closed != golden[index])
+    {
+        diverged_ = true;
+        first_divergence = true;
+        divergence_.insts = numInsts;
+        divergence_.seqNum = inst->id.execSeqNum;
+        divergence_.pc = pc;
+        divergence_.function = debugRegionMap.name(pc);
+
+        DPRINTF(MinorValueTrace, "Diverged from golden run within insts"
+            " %d to %d, detected at inst: %s function: %s\n",
+            numInsts - interval + 1, numInsts, *inst,
+            divergence_.function);
+
+    }
+
+    return first_divergence;
+}
+
+std::string
+ValueTrace::divergenceReport() const
+{
+    if (!diverged_)
+        return "";
+
+    return csprintf("{\"insts\": %d, \"interval\": %d, \"seq_num\": %d,"
+        " \"pc\": %d, \"function\": \"%s\"}", divergence_.insts, interval,
+        divergence_.seqNum, divergence_.pc, divergence_.function);
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Committed value digests for locating where a fault injection run
+ *  first departs from its golden run.
+ */
+
+#ifndef __CPU_MINOR_VALUE_TRACE_HH__
+#define __CPU_MINOR_VALUE_TRACE_HH__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/minor/dyn_inst.hh"
+#include "cpu/minor/trace.hh"
+#include "params/MinorCPU.hh"
+
+class ThreadContext;
+
+namespace Minor
+{
+
+/** Folds the PC, destination register values and store data of every
+ *  committed instruction into a digest which is closed every interval
+ *  committed (macro-)instructions.  A golden run records the 32 bit
+ *  digest of each interval to a binary trace.  An injection run checks
+ *  each of its own digests as it is closed and reports the first one
+ *  which differs, the first point where the run's committed values
+ *  depart from the golden run's.
+ *
+ *  Unlike Convergence, which compares the whole architectural state at
+ *  sample points, only values produced by committed instructions are
+ *  digested so the cost per instruction is small and the divergence is
+ *  located to within one interval (exactly with an interval of 1).  The
+ *  golden and checked runs must start from the same point */
+class ValueTrace : public Named
+{
+  public:
+    /** Where a run first departed from the golden run */
+    class Divergence
+    {
+      public:
+        /** Committed instructions when it was detected */
+        Counter insts;
+
+        /** The instruction which closed the differing interval */
+        InstSeqNum seqNum;
+        Addr pc;
+        std::string function;
+    };
+
+  protected:
+    /** Committed instructions per digest, 0 to disable */
+    const Counter interval;
+
+    /** Record digests to trace rather than check against them */
+    const bool record;
+
+    /** Digest of the interval so far */
+    uint64_t digest;
+
+    /** Committed instructions so far */
+    Counter numInsts;
+
+    /** Recording output stream */
+    std::ostream *traceOut;
+
+    /** Golden run digests, one per interval */
+    std::vector<uint32_t> golden;
+
+    /** Set when the first divergence has been found */
+    bool diverged_;
+
+    Divergence divergence_;
+
+    /** Fold size bytes into the digest */
+    void digestBytes(const void *bytes, size_t size);
+
+    /** Close the interval which inst ended */
+    void closeInterval(MinorDynInstPtr inst);
+
+  public:
+    ValueTrace(const std::string &name_, MinorCPUParams &params);
+
+    ~ValueTrace();
+
+    bool enabled() const { return interval != 0; }
+
+    /** Note a committed store of size bytes of data to vaddr */
+    void recordStore(Addr vaddr, unsigned int size, const uint8_t *data);
+
+    /** Fold in the PC and destination values of a committing
+     *  instruction, closing the interval if it is the one which
+     *  completes the interval'th macro-instruction.  Returns true if
+     *  this is the instruction at which the run first diverged */
+    bool commitInst(MinorDynInstPtr inst, ThreadContext *thread);
+
+    bool diverged() const { return diverged_; }
+
+    const Divergence &divergence() const { return divergence_; }
+
+    /** The divergence as a JSON object, or the empty string if the run
+     *  has not diverged */
+    std::string divergenceReport() const;
+};
+
+}
+
+#endif /* __CPU_MINOR_VALUE_TRACE_HH__ */
@@ -33,6 +33,7 @@ from BaseCPU import BaseCPU
 from FUPool import *
 from O3Checker import O3Checker
 from BranchPredictor import BranchPredictor
+from FaultInjector import FaultInjector
 
 class DerivO3CPU(BaseCPU):
     type = 'DerivO3CPU'
@@ -110,6 +111,9 @@ class DerivO3CPU(BaseCPU):
     SSITSize = Param.Unsigned(1024, "Store set ID table size")
 
     numRobs = Param.Unsigned(1, "Number of Reorder Buffers");
+    numRenameCheckpoints = Param.Unsigned(16, "Rename map checkpoints taken"
+        " at control instructions, so squashing after one is a single"
+        " restore (0 walks the rename history, as does SMT)")
 
     numPhysIntRegs = Param.Unsigned(256, "Number of physical integer registers")
     numPhysFloatRegs = Param.Unsigned(256, "Number of physical floating point "
@@ -145,6 +149,9 @@ class DerivO3CPU(BaseCPU):
     needsTSO = Param.Bool(buildEnv['TARGET_ISA'] == 'x86',
                           "Enable TSO Memory model")
 
+    faultInjector = Param.FaultInjector(FaultInjector(), "Fault target"
+        " and source of random fault choices")
+
     def addCheckerCpu(self):
         if buildEnv['TARGET_ISA'] in ['arm']:
             from ArmTLB import ArmTLB
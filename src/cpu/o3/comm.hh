@@ -49,6 +49,7 @@
 #include "arch/types.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/timebuf.hh"
 #include "sim/faults.hh"
 
 // Typedef for physical register index type. Although the Impl would be the
@@ -67,6 +68,18 @@ struct DefaultFetchDefaultDecode {
     Fault fetchFault;
     InstSeqNum fetchFaultSN;
     bool clearFetchFault;
+
+    /** Return to the zeroed state of a new time buffer slot */
+    void
+    reset()
+    {
+        for (int i = 0; i < size; ++i)
+            insts[i] = NULL;
+        size = 0;
+        fetchFault = NoFault;
+        fetchFaultSN = 0;
+        clearFetchFault = false;
+    }
 };
 
 /** Struct that defines the information passed from decode to rename. */
@@ -77,6 +90,15 @@ struct DefaultDecodeDefaultRename {
     int size;
 
     DynInstPtr insts[Impl::MaxWidth];
+
+    /** Return to the zeroed state of a new time buffer slot */
+    void
+    reset()
+    {
+        for (int i = 0; i < size; ++i)
+            insts[i] = NULL;
+        size = 0;
+    }
 };
 
 /** Struct that defines the information passed from rename to IEW. */
@@ -87,6 +109,15 @@ struct DefaultRenameDefaultIEW {
     int size;
 
     DynInstPtr insts[Impl::MaxWidth];
+
+    /** Return to the zeroed state of a new time buffer slot */
+    void
+    reset()
+    {
+        for (int i = 0; i < size; ++i)
+            insts[i] = NULL;
+        size = 0;
+    }
 };
 
 /** Struct that defines the information passed from IEW to commit. */
@@ -231,4 +262,25 @@ struct TimeBufStruct {
     bool iewUnblock[Impl::MaxThreads];
 };
 
+/** The instruction queues between the front end stages only carry as
+ *  many instructions as their size, so their slots are reset in place
+ *  rather than rebuilt on every advance */
+template <class Impl>
+struct TimeBufferDefaultReset<DefaultFetchDefaultDecode<Impl> > :
+    public TimeBufferResetInPlace<DefaultFetchDefaultDecode<Impl> >
+{
+};
+
+template <class Impl>
+struct TimeBufferDefaultReset<DefaultDecodeDefaultRename<Impl> > :
+    public TimeBufferResetInPlace<DefaultDecodeDefaultRename<Impl> >
+{
+};
+
+template <class Impl>
+struct TimeBufferDefaultReset<DefaultRenameDefaultIEW<Impl> > :
+    public TimeBufferResetInPlace<DefaultRenameDefaultIEW<Impl> >
+{
+};
+
 #endif //__CPU_O3_COMM_HH__
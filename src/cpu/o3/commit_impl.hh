@@ -49,6 +49,7 @@
 #include <string>
 
 #include "arch/utility.hh"
+#include "base/loader/region_map.hh"
 #include "base/loader/symtab.hh"
 #include "base/cp_annotate.hh"
 #include "config/the_isa.hh"
@@ -63,11 +64,9 @@
 #include "debug/CommitRate.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
-#include "base/loader/symtab.hh"
 
 using namespace std;
 
@@ -1067,6 +1066,11 @@ DefaultCommit<Impl>::commitInsts()
                 // Set the doneSeqNum to the youngest committed instruction.
                 toIEW->commitInfo[tid].doneSeqNum = head_inst->seqNum;
 
+                // The only cost of the fault injector when it has no
+                // pending seqnum trigger.
+                if (tid == 0 && cpu->faultInjector->armed())
+                    cpu->faultInjector->commit(head_inst->seqNum);
+
                 if (tid == 0) {
                     canHandleInterrupts =  (!head_inst->isDelayedCommit()) &&
                                            ((THE_ISA != ALPHA_ISA) ||
@@ -1314,9 +1318,7 @@ DefaultCommit<Impl>::commitHead(DynInstPtr &head_inst, unsigned inst_num)
     rob->retireHead(tid);
 
 #if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        head_inst->commitTick = curTick() - head_inst->fetchTick;
-    }
+    head_inst->commitTick = curTick() - head_inst->fetchTick;
 #endif
 
     // If this was a store, record it for this cycle.
@@ -1391,10 +1393,7 @@ void
 DefaultCommit<Impl>::updateComInstStats(DynInstPtr &inst)
 {
 
-std::string sym_str="nothing";
-Addr sym_addr;
-debugSymbolTable->findNearestSymbol(inst->instAddr() , sym_str, sym_addr);
-if(((sym_str[0] == 'F' &&  sym_str[1] == 'U' && sym_str[2] == 'N' && sym_str[3] == 'C') || sym_str == "main" ))
+if (debugRegionMap.inROI(inst->instAddr()))
 {
     ThreadID tid = inst->threadNumber;
 
@@ -45,10 +45,12 @@
  */
 
 #include "arch/kernel_stats.hh"
+#include "base/loader/region_map.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/checker/thread_context.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/fault_sites.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/o3/thread_context.hh"
 #include "cpu/activity.hh"
@@ -64,7 +66,9 @@
 #include "sim/full_system.hh"
 #include "sim/process.hh"
 #include "sim/stat_control.hh"
+#include "sim/stats_region.hh"
 #include "sim/system.hh"
+#include "sim/trace_window.hh"
 
 #if THE_ISA == ALPHA_ISA
 #include "arch/alpha/osfpal.hh"
@@ -195,9 +199,18 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 
       globalSeqNum(1),
       system(params->system),
+      faultInjector(params->faultInjector),
       drainManager(NULL),
       lastRunningCycle(curCycle())
 {
+    // Enough slots for a full ROB plus everything that can be queued
+    // in front of it; wrong-path fetch beyond that grows the arena.
+    instArena.reserve(sizeof(typename Impl::DynInst),
+                      params->numROBEntries + params->fetchQueueSize +
+                      params->fetchWidth * params->fetchToDecodeDelay +
+                      params->decodeWidth * params->decodeToRenameDelay +
+                      params->renameWidth * params->renameToIEWDelay);
+
     if (!params->switched_out) {
         _status = Running;
     } else {
@@ -535,6 +548,14 @@ FullO3CPU<Impl>::regStats()
         .name(name() + ".tickCyclesMain")
         .desc("number of cycles that we spend in Main")
         .prereq(tickCyclesMain);
+
+    tickCyclesFunc
+        .init(debugRegionMap.numFuncIds())
+        .name(name() + ".tickCyclesFunc")
+        .desc("number of cycles spent in each region of interest function")
+        .flags(Stats::total | Stats::nozero);
+    for (unsigned i = 0; i < tickCyclesFunc.size(); i++)
+        tickCyclesFunc.subname(i, debugRegionMap.funcName(i));
 }
 
 template <class Impl>
@@ -595,11 +616,13 @@ FullO3CPU<Impl>::tick()
 
     tryDrain();
 ////////////////moslem
-			std::string sym_str="nothing";
-			Addr sym_addr;
-			debugSymbolTable->findNearestSymbol(commit.instAddr(0) , sym_str, sym_addr);
-if(((sym_str[0] == 'F' &&  sym_str[1] == 'U' && sym_str[2] == 'N' && sym_str[3] == 'C') || sym_str == "main" ))
-tickCyclesMain++;
+    const RegionMap::Region *region =
+        debugRegionMap.lookup(commit.instAddr(0));
+    if (region && region->inROI()) {
+        tickCyclesMain++;
+        if (region->funcId < tickCyclesFunc.size())
+            tickCyclesFunc[region->funcId]++;
+    }
 
 
 
@@ -632,6 +655,31 @@ FullO3CPU<Impl>::init()
         thread[tid]->noSquashFromTC = false;
 
     commit.setThreads(thread);
+
+    /* Make thread 0's structures available as fault injection targets */
+    faultInjector->registerSite(name() + ".phys_int_regs",
+        new PhysRegFaultSite(regFile, RegFileFaultSite::IntRegs));
+    faultInjector->registerSite(name() + ".phys_float_regs",
+        new PhysRegFaultSite(regFile, RegFileFaultSite::FloatRegs));
+    faultInjector->registerSite(name() + ".phys_cc_regs",
+        new PhysRegFaultSite(regFile, RegFileFaultSite::CCRegs));
+    faultInjector->registerSite(name() + ".rob",
+        new ROBFaultSite<Impl>(rob, 0));
+    faultInjector->registerSite(name() + ".iq",
+        new IQFaultSite<Impl>(iew.instQueue, regFile, 0));
+    faultInjector->registerSite(name() + ".lq",
+        new LQFaultSite<Impl>(iew.ldstQueue.getUnit(0)));
+    faultInjector->registerSite(name() + ".sq",
+        new SQFaultSite<Impl>(iew.ldstQueue.getUnit(0)));
+    faultInjector->registerSite(name() + ".rename_int",
+        new RenameMapFaultSite(renameMap[0], regFile,
+            RegFileFaultSite::IntRegs));
+    faultInjector->registerSite(name() + ".rename_float",
+        new RenameMapFaultSite(renameMap[0], regFile,
+            RegFileFaultSite::FloatRegs));
+    faultInjector->registerSite(name() + ".rename_cc",
+        new RenameMapFaultSite(renameMap[0], regFile,
+            RegFileFaultSite::CCRegs));
 }
 
 template <class Impl>
@@ -1466,6 +1514,8 @@ FullO3CPU<Impl>::instDone(ThreadID tid, DynInstPtr &inst)
     system->instEventQueue.serviceEvents(system->totalNumInsts);
 
     probeInstCommit(inst->staticInst);
+    Trace::windowCommit(inst->instAddr());
+    statsRegionCommit(inst->instAddr());
 }
 
 template <class Impl>
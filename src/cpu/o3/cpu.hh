@@ -58,10 +58,12 @@
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
+#include "cpu/o3/dyn_inst_arena.hh"
 #include "cpu/o3/scoreboard.hh"
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
+#include "cpu/fault_injector.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
 //#include "cpu/o3/thread_context.hh"
@@ -513,6 +515,12 @@ class FullO3CPU : public BaseO3CPU
     int instcount;
 #endif
 
+    /** Slots for the instructions in flight.  Declared ahead of
+     *  everything that can hold an instruction so that it is destroyed
+     *  last.
+     */
+    DynInstArena instArena;
+
     /** List of all the instructions in flight. */
     std::list<DynInstPtr> instList;
 
@@ -666,6 +674,9 @@ class FullO3CPU : public BaseO3CPU
     /** Pointer to the system. */
     System *system;
 
+    /** Fault injector the structures of thread 0 are registered with */
+    FaultInjector *faultInjector;
+
     /** DrainManager to notify when draining has completed. */
     DrainManager *drainManager;
 
@@ -743,6 +754,9 @@ class FullO3CPU : public BaseO3CPU
     Stats::Scalar miscRegfileWrites;
 /// moslem performance 
    Stats::Scalar tickCyclesMain;
+    /** Cycles in each region of interest function, indexed by RegionMap
+     *  function ID */
+    Stats::Vector tickCyclesFunc;
 };
 
 #endif // __CPU_O3_CPU_HH__
@@ -77,7 +77,8 @@ class DependencyGraph
 
     /** Default construction.  Must call resize() prior to use. */
     DependencyGraph()
-        : numEntries(0), memAllocCounter(0), nodesTraversed(0), nodesRemoved(0)
+        : numEntries(0), freeNodes(NULL), memAllocCounter(0),
+          nodesTraversed(0), nodesRemoved(0)
     { }
 
     ~DependencyGraph();
@@ -95,6 +96,10 @@ class DependencyGraph
     void setInst(PhysRegIndex idx, DynInstPtr &new_inst)
     { dependGraph[idx].inst = new_inst; }
 
+    /** Returns the producing instruction of a given register. */
+    DynInstPtr getInst(PhysRegIndex idx) const
+    { return dependGraph[idx].inst; }
+
     /** Clears the producing instruction. */
     void clearInst(PhysRegIndex idx)
     { dependGraph[idx].inst = NULL; }
@@ -116,6 +121,12 @@ class DependencyGraph
     void dump();
 
   private:
+    /** Takes a node off the free list, allocating one if it is empty. */
+    DepEntry *allocEntry();
+
+    /** Returns a node to the free list. */
+    void freeEntry(DepEntry *entry);
+
     /** Array of linked lists.  Each linked list is a list of all the
      *  instructions that depend upon a given register.  The actual
      *  register's index is used to index into the graph; ie all
@@ -127,6 +138,12 @@ class DependencyGraph
     /** Number of linked lists; identical to the number of registers. */
     int numEntries;
 
+    /** Nodes released by instructions that have woken up or been
+     *  squashed.  Reusing them keeps wakeup from hitting the heap for
+     *  every consumer that enters the IQ.
+     */
+    DepEntry *freeNodes;
+
     // Debug variable, remove when done testing.
     unsigned memAllocCounter;
 
@@ -141,6 +158,34 @@ template <class DynInstPtr>
 DependencyGraph<DynInstPtr>::~DependencyGraph()
 {
     delete [] dependGraph;
+
+    while (freeNodes) {
+        DepEntry *next = freeNodes->next;
+        delete freeNodes;
+        freeNodes = next;
+    }
+}
+
+template <class DynInstPtr>
+typename DependencyGraph<DynInstPtr>::DepEntry *
+DependencyGraph<DynInstPtr>::allocEntry()
+{
+    if (!freeNodes)
+        return new DepEntry;
+
+    DepEntry *entry = freeNodes;
+    freeNodes = entry->next;
+    entry->next = NULL;
+    return entry;
+}
+
+template <class DynInstPtr>
+void
+DependencyGraph<DynInstPtr>::freeEntry(DepEntry *entry)
+{
+    entry->inst = NULL;
+    entry->next = freeNodes;
+    freeNodes = entry;
 }
 
 template <class DynInstPtr>
@@ -167,9 +212,7 @@ DependencyGraph<DynInstPtr>::reset()
 
             prev = curr;
             curr = prev->next;
-            prev->inst = NULL;
-
-            delete prev;
+            freeEntry(prev);
         }
 
         if (dependGraph[i].inst) {
@@ -189,7 +232,7 @@ DependencyGraph<DynInstPtr>::insert(PhysRegIndex idx, DynInstPtr &new_inst)
 
     // First create the entry that will be added to the head of the
     // dependency chain.
-    DepEntry *new_entry = new DepEntry;
+    DepEntry *new_entry = allocEntry();
     new_entry->next = dependGraph[idx].next;
     new_entry->inst = new_inst;
 
@@ -232,10 +275,7 @@ DependencyGraph<DynInstPtr>::remove(PhysRegIndex idx,
 
     --memAllocCounter;
 
-    // Could push this off to the destructor of DependencyEntry
-    curr->inst = NULL;
-
-    delete curr;
+    freeEntry(curr);
 }
 
 template <class DynInstPtr>
@@ -248,9 +288,8 @@ DependencyGraph<DynInstPtr>::pop(PhysRegIndex idx)
     if (node) {
         inst = node->inst;
         dependGraph[idx].next = node->next;
-        node->inst = NULL;
         memAllocCounter--;
-        delete node;
+        freeEntry(node);
     }
     return inst;
 }
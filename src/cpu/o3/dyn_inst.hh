@@ -47,6 +47,7 @@
 #include "arch/isa_traits.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_arena.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/base_dyn_inst.hh"
 #include "cpu/inst_seq.hh"
@@ -93,6 +94,22 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /** Allocate from a CPU's instruction arena. */
+    static void *operator new(size_t size, DynInstArena &arena)
+    { return arena.allocate(size); }
+
+    /** Allocate an instruction outside of any arena. */
+    static void *operator new(size_t size)
+    { return DynInstArena::allocateUnpooled(size); }
+
+    /** Only used if the constructor of an arena instruction throws. */
+    static void operator delete(void *p, DynInstArena &arena)
+    { DynInstArena::release(p); }
+
+    /** Hand the slot back to whichever arena it came from. */
+    static void operator delete(void *p)
+    { DynInstArena::release(p); }
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -122,7 +139,8 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
   public:
 #if TRACING_ON
-    /** Tick records used for the pipeline activity viewer. */
+    /** Tick records used for the pipeline activity viewer and the
+     *  O3PipeTimeline, kept whether or not O3PipeView is enabled. */
     Tick fetchTick;	     // instruction fetch is completed.
     int32_t decodeTick;  // instruction enters decode phase
     int32_t renameTick;  // instruction enters rename phase
@@ -0,0 +1,137 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/dyn_inst_arena.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+
+DynInstArena::DynInstArena()
+    : slotSize(0), freeSlots(NULL), numSlots(0), numLive(0)
+{
+}
+
+DynInstArena::~DynInstArena()
+{
+    // Anything still holding an instruction (a probe listener, say)
+    // would be left pointing into freed memory; leak the chunks instead.
+    if (numLive)
+        return;
+
+    for (auto chunk : chunks)
+        free(chunk);
+}
+
+void
+DynInstArena::reserve(size_t obj_size, size_t num_slots)
+{
+    const size_t slot_size = roundUp(HeaderSize + obj_size, SlotAlign);
+
+    if (!slotSize)
+        slotSize = slot_size;
+    else
+        assert(slotSize == slot_size);
+
+    if (num_slots > numSlots)
+        grow(num_slots - numSlots);
+}
+
+void
+DynInstArena::grow(size_t num_slots)
+{
+    void *chunk;
+    if (posix_memalign(&chunk, SlotAlign, slotSize * num_slots))
+        fatal("Can't allocate %d dynamic instruction slots\n", num_slots);
+
+    chunks.push_back(chunk);
+
+    uint8_t *slots = static_cast<uint8_t *>(chunk);
+    for (size_t i = num_slots; i-- > 0; ) {
+        FreeSlot *slot = reinterpret_cast<FreeSlot *>(slots + i * slotSize);
+        slot->next = freeSlots;
+        freeSlots = slot;
+    }
+
+    numSlots += num_slots;
+}
+
+void *
+DynInstArena::allocate(size_t size)
+{
+    if (!slotSize)
+        slotSize = roundUp(HeaderSize + size, SlotAlign);
+
+    assert(HeaderSize + size <= slotSize);
+
+    // Grow by half again so that a CPU running deeper down the wrong
+    // path than its reservation allowed settles after a few chunks.
+    if (!freeSlots)
+        grow(std::max<size_t>(numSlots / 2, 64));
+
+    FreeSlot *slot = freeSlots;
+    freeSlots = slot->next;
+    ++numLive;
+
+    Header *header = reinterpret_cast<Header *>(slot);
+    header->owner = this;
+    return reinterpret_cast<uint8_t *>(slot) + HeaderSize;
+}
+
+void *
+DynInstArena::allocateUnpooled(size_t size)
+{
+    uint8_t *mem = static_cast<uint8_t *>(::operator new(HeaderSize + size));
+    reinterpret_cast<Header *>(mem)->owner = NULL;
+    return mem + HeaderSize;
+}
+
+void
+DynInstArena::release(void *p)
+{
+    if (!p)
+        return;
+
+    uint8_t *mem = static_cast<uint8_t *>(p) - HeaderSize;
+    DynInstArena *owner = reinterpret_cast<Header *>(mem)->owner;
+
+    if (!owner) {
+        ::operator delete(mem);
+        return;
+    }
+
+    assert(owner->numLive);
+    --owner->numLive;
+
+    FreeSlot *slot = reinterpret_cast<FreeSlot *>(mem);
+    slot->next = owner->freeSlots;
+    owner->freeSlots = slot;
+}
@@ -0,0 +1,103 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_DYN_INST_ARENA_HH__
+#define __CPU_O3_DYN_INST_ARENA_HH__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Per-CPU pool of dynamic instruction slots.  The O3 CPU allocates one
+ * DynInst per fetched micro-op, wrong path included, so rather than
+ * going through the global allocator every slot released by a squashed
+ * or committed instruction goes straight back on a free list for the
+ * next fetch.  Slots are cache line aligned and carved from chunks; the
+ * arena only ever grows.
+ *
+ * Every slot starts with a header naming the arena it came from, so an
+ * instruction can be returned to the right arena from its class
+ * operator delete without any handle on its CPU.  Instructions created
+ * without an arena get the same header with a null owner and go back to
+ * the global allocator.
+ */
+class DynInstArena
+{
+  public:
+    DynInstArena();
+    ~DynInstArena();
+
+    /**
+     * Make sure at least num_slots slots of obj_size bytes are
+     * available.  The first call fixes the object size.
+     */
+    void reserve(size_t obj_size, size_t num_slots);
+
+    /** Hand out a slot for an object of the given size. */
+    void *allocate(size_t size);
+
+    /** Allocate an object that does not belong to any arena. */
+    static void *allocateUnpooled(size_t size);
+
+    /** Return an object allocated by either of the above. */
+    static void release(void *p);
+
+    /** Number of slots carved so far. */
+    size_t capacity() const { return numSlots; }
+
+  private:
+    /** Space in front of each object, keeping it suitably aligned. */
+    static const size_t HeaderSize = 16;
+
+    static const size_t SlotAlign = 64;
+
+    struct Header
+    {
+        DynInstArena *owner;
+    };
+
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    void grow(size_t num_slots);
+
+    /** Size of a slot, header included. */
+    size_t slotSize;
+
+    FreeSlot *freeSlots;
+
+    std::vector<void *> chunks;
+
+    size_t numSlots;
+
+    /** Slots currently holding an instruction. */
+    size_t numLive;
+};
+
+#endif // __CPU_O3_DYN_INST_ARENA_HH__
@@ -0,0 +1,106 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/fault_sites.hh"
+
+unsigned int
+RenameMapFaultSite::numEntries() const
+{
+    switch (regClass) {
+      case RegFileFaultSite::FloatRegs:
+        return TheISA::NumFloatRegs;
+      case RegFileFaultSite::CCRegs:
+        return TheISA::NumCCRegs;
+      default:
+        return TheISA::NumIntRegs;
+    }
+}
+
+unsigned int
+RenameMapFaultSite::entryBits() const
+{
+    switch (regClass) {
+      case RegFileFaultSite::FloatRegs:
+        return ceilLog2(regFile.numFloatPhysRegs());
+      case RegFileFaultSite::CCRegs:
+        return ceilLog2(regFile.numCCPhysRegs());
+      default:
+        return ceilLog2(regFile.numIntPhysRegs());
+    }
+}
+
+void
+RenameMapFaultSite::flipBit(unsigned int index, unsigned int bit,
+    unsigned int fault)
+{
+    PhysRegIndex base = 0;
+    unsigned int num_regs = 0;
+    PhysRegIndex old_reg = 0;
+
+    switch (regClass) {
+      case RegFileFaultSite::IntRegs:
+        base = 0;
+        num_regs = regFile.numIntPhysRegs();
+        old_reg = renameMap.lookupInt(index);
+        break;
+      case RegFileFaultSite::FloatRegs:
+        base = regFile.numIntPhysRegs();
+        num_regs = regFile.numFloatPhysRegs();
+        old_reg = renameMap.lookupFloat(index);
+        break;
+      case RegFileFaultSite::CCRegs:
+        base = regFile.numIntPhysRegs() + regFile.numFloatPhysRegs();
+        num_regs = regFile.numCCPhysRegs();
+        old_reg = renameMap.lookupCC(index);
+        break;
+    }
+
+    unsigned int new_offset = (old_reg - base) ^ (1 << bit);
+
+    if (new_offset >= num_regs) {
+        DPRINTF(FaultInjector, "Rename map entry %d: p%d would leave its"
+            " register class\n", index, old_reg);
+        return;
+    }
+
+    PhysRegIndex new_reg = base + new_offset;
+
+    DPRINTF(FaultInjector, "Rename map entry %d: p%d -> p%d\n", index,
+        old_reg, new_reg);
+
+    switch (regClass) {
+      case RegFileFaultSite::IntRegs:
+        renameMap.setIntEntry(index, new_reg);
+        break;
+      case RegFileFaultSite::FloatRegs:
+        renameMap.setFloatEntry(index, new_reg);
+        break;
+      case RegFileFaultSite::CCRegs:
+        renameMap.setCCEntry(index, new_reg);
+        break;
+    }
+}
@@ -0,0 +1,319 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Fault injection sites for the structures of the O3 CPU.  See
+ *  FaultInjector for how sites are registered and targeted.
+ */
+
+#ifndef __CPU_O3_FAULT_SITES_HH__
+#define __CPU_O3_FAULT_SITES_HH__
+
+#include "base/intmath.hh"
+#include "cpu/fault_injector.hh"
+#include "cpu/o3/regfile.hh"
+#include "cpu/o3/rename_map.hh"
+#include "debug/FaultInjector.hh"
+
+/** One class of registers of the physical register file */
+class PhysRegFaultSite : public FaultSite
+{
+  protected:
+    PhysRegFile &regFile;
+    RegFileFaultSite::RegFile regClass;
+
+    /** Unified index of the first register of the class */
+    PhysRegIndex
+    base() const
+    {
+        switch (regClass) {
+          case RegFileFaultSite::FloatRegs:
+            return regFile.numIntPhysRegs();
+          case RegFileFaultSite::CCRegs:
+            return regFile.numIntPhysRegs() + regFile.numFloatPhysRegs();
+          default:
+            return 0;
+        }
+    }
+
+  public:
+    PhysRegFaultSite(PhysRegFile &reg_file,
+        RegFileFaultSite::RegFile reg_class) :
+        regFile(reg_file), regClass(reg_class)
+    { }
+
+    unsigned int
+    numEntries() const
+    {
+        switch (regClass) {
+          case RegFileFaultSite::FloatRegs:
+            return regFile.numFloatPhysRegs();
+          case RegFileFaultSite::CCRegs:
+            return regFile.numCCPhysRegs();
+          default:
+            return regFile.numIntPhysRegs();
+        }
+    }
+
+    unsigned int
+    entryBits() const
+    {
+        switch (regClass) {
+          case RegFileFaultSite::FloatRegs:
+            return sizeof(TheISA::FloatRegBits) * 8;
+          case RegFileFaultSite::CCRegs:
+            return sizeof(TheISA::CCReg) * 8;
+          default:
+            return sizeof(TheISA::IntReg) * 8;
+        }
+    }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        PhysRegIndex reg_idx = base() + index;
+
+        switch (regClass) {
+          case RegFileFaultSite::IntRegs:
+            regFile.setIntReg(reg_idx, regFile.readIntReg(reg_idx) ^
+                (TheISA::IntReg(1) << bit));
+            break;
+          case RegFileFaultSite::FloatRegs:
+            regFile.setFloatRegBits(reg_idx,
+                regFile.readFloatRegBits(reg_idx) ^
+                (TheISA::FloatRegBits(1) << bit));
+            break;
+          case RegFileFaultSite::CCRegs:
+            regFile.setCCReg(reg_idx, regFile.readCCReg(reg_idx) ^
+                (TheISA::CCReg(1) << bit));
+            break;
+        }
+    }
+};
+
+/** The PCs of a thread's ROB entries.  The PC of a committing entry
+ *  becomes the architectural PC */
+template <class Impl>
+class ROBFaultSite : public FaultSite
+{
+  protected:
+    typename Impl::CPUPol::ROB &rob;
+    ThreadID tid;
+
+  public:
+    ROBFaultSite(typename Impl::CPUPol::ROB &rob_, ThreadID tid_) :
+        rob(rob_), tid(tid_)
+    { }
+
+    unsigned int numEntries() const { return rob.getMaxEntries(tid); }
+    unsigned int entryBits() const { return sizeof(Addr) * 8; }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        typename Impl::DynInstPtr inst = rob.getEntry(tid, index);
+
+        if (!inst) {
+            DPRINTF(FaultInjector, "ROB entry %d is empty\n", index);
+            return;
+        }
+
+        TheISA::PCState pc = inst->pcState();
+        pc.set(pc.instAddr() ^ (Addr(1) << bit));
+        inst->pcState(pc);
+    }
+};
+
+/** The renamed source operands of a thread's IQ entries.  Each entry has
+ *  one field per possible source of ceilLog2(physical registers) bits.
+ *  Flips which would leave the operand's register class, and flips into
+ *  entries which have issued or have fewer sources, have no effect.
+ *  The IQ moves waiting operands to the new register's dependency list,
+ *  see InstructionQueue::renameSrcReg */
+template <class Impl>
+class IQFaultSite : public FaultSite
+{
+  protected:
+    typename Impl::CPUPol::IQ &iq;
+    PhysRegFile &regFile;
+    ThreadID tid;
+
+    unsigned int
+    operandBits() const
+    {
+        return ceilLog2(regFile.totalNumPhysRegs());
+    }
+
+    /** Register class of a phys. register, -1 for misc registers */
+    int
+    regClass(PhysRegIndex reg_idx) const
+    {
+        if (reg_idx >= regFile.totalNumPhysRegs())
+            return -1;
+        else if (regFile.isIntPhysReg(reg_idx))
+            return RegFileFaultSite::IntRegs;
+        else if (regFile.isFloatPhysReg(reg_idx))
+            return RegFileFaultSite::FloatRegs;
+        else
+            return RegFileFaultSite::CCRegs;
+    }
+
+  public:
+    IQFaultSite(typename Impl::CPUPol::IQ &iq_, PhysRegFile &reg_file,
+        ThreadID tid_) :
+        iq(iq_), regFile(reg_file), tid(tid_)
+    { }
+
+    unsigned int numEntries() const { return iq.getNumEntries(); }
+
+    unsigned int
+    entryBits() const
+    {
+        return TheISA::MaxInstSrcRegs * operandBits();
+    }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        typename Impl::DynInstPtr inst = iq.getEntry(tid, index);
+        int src = bit / operandBits();
+
+        if (!inst || inst->isIssued() || src >= inst->numSrcRegs()) {
+            DPRINTF(FaultInjector, "IQ entry %d has no waiting source %d\n",
+                index, src);
+            return;
+        }
+
+        PhysRegIndex old_reg = inst->renamedSrcRegIdx(src);
+        PhysRegIndex new_reg = old_reg ^ (1 << (bit % operandBits()));
+
+        if (regClass(old_reg) == -1 ||
+            regClass(new_reg) != regClass(old_reg))
+        {
+            DPRINTF(FaultInjector, "IQ entry %d source %d: p%d -> p%d"
+                " leaves its register class\n", index, src, old_reg,
+                new_reg);
+            return;
+        }
+
+        iq.renameSrcReg(inst, src, new_reg);
+    }
+};
+
+/** The effective addresses of a thread's load queue entries */
+template <class Impl>
+class LQFaultSite : public FaultSite
+{
+  protected:
+    typename Impl::CPUPol::LSQUnit &lsqUnit;
+
+  public:
+    LQFaultSite(typename Impl::CPUPol::LSQUnit &lsq_unit) :
+        lsqUnit(lsq_unit)
+    { }
+
+    unsigned int numEntries() const { return lsqUnit.getMaxLoads(); }
+    unsigned int entryBits() const { return sizeof(Addr) * 8; }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        typename Impl::DynInstPtr inst = lsqUnit.getLoadEntry(index);
+
+        if (!inst) {
+            DPRINTF(FaultInjector, "LQ entry %d is empty\n", index);
+            return;
+        }
+
+        inst->effAddr ^= Addr(1) << bit;
+    }
+};
+
+/** The data of a thread's store queue entries.  Flips beyond the size of
+ *  the store or into stores already written back have no effect */
+template <class Impl>
+class SQFaultSite : public FaultSite
+{
+  protected:
+    typename Impl::CPUPol::LSQUnit &lsqUnit;
+
+  public:
+    SQFaultSite(typename Impl::CPUPol::LSQUnit &lsq_unit) :
+        lsqUnit(lsq_unit)
+    { }
+
+    unsigned int numEntries() const { return lsqUnit.getMaxStores(); }
+
+    unsigned int
+    entryBits() const
+    {
+        return sizeof(((typename Impl::CPUPol::LSQUnit::SQEntry *)0)->data)
+            * 8;
+    }
+
+    void
+    flipBit(unsigned int index, unsigned int bit, unsigned int fault)
+    {
+        typename Impl::CPUPol::LSQUnit::SQEntry *entry =
+            lsqUnit.getStoreEntry(index);
+
+        if (!entry || !entry->inst || entry->completed ||
+            bit >= entry->size * 8u)
+        {
+            DPRINTF(FaultInjector, "SQ entry %d has no data bit %d\n",
+                index, bit);
+            return;
+        }
+
+        entry->data[bit / 8] ^= 1 << (bit % 8);
+    }
+};
+
+/** One register class of a thread's rename map.  Each entry holds the
+ *  index of a physical register of the class in ceilLog2(registers in
+ *  the class) bits, flips which would leave the class have no effect */
+class RenameMapFaultSite : public FaultSite
+{
+  protected:
+    UnifiedRenameMap &renameMap;
+    PhysRegFile &regFile;
+    RegFileFaultSite::RegFile regClass;
+
+  public:
+    RenameMapFaultSite(UnifiedRenameMap &rename_map, PhysRegFile &reg_file,
+        RegFileFaultSite::RegFile reg_class) :
+        renameMap(rename_map), regFile(reg_file), regClass(reg_class)
+    { }
+
+    unsigned int numEntries() const;
+    unsigned int entryBits() const;
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+};
+
+#endif // __CPU_O3_FAULT_SITES_HH__
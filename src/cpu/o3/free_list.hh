@@ -33,7 +33,7 @@
 #define __CPU_O3_FREE_LIST_HH__
 
 #include <iostream>
-#include <queue>
+#include <vector>
 
 #include "base/misc.hh"
 #include "base/trace.hh"
@@ -52,30 +52,72 @@ class SimpleFreeList
 {
   private:
 
-    /** The actual free list */
-    std::queue<PhysRegIndex> freeRegs;
+    /**
+     * The actual free list, a ring of registers from head to tail.
+     * head and tail count the registers ever taken and added, with
+     * the ring size a power of two. Once every register of the class
+     * has been added, the ring is at least that large, so the slots
+     * of the registers taken since any earlier head are never reused
+     * until those registers come back.
+     */
+    std::vector<PhysRegIndex> ring;
+    uint64_t head;
+    uint64_t tail;
+
+    /** Double the ring, keeping the slots of the last registers added */
+    void
+    grow()
+    {
+        std::vector<PhysRegIndex> old_ring(2 * ring.size());
+        old_ring.swap(ring);
+
+        uint64_t old_mask = old_ring.size() - 1;
+        uint64_t mask = ring.size() - 1;
+        uint64_t first = tail > old_ring.size() ? tail - old_ring.size() : 0;
+        for (uint64_t i = first; i < tail; i++)
+            ring[i & mask] = old_ring[i & old_mask];
+    }
 
   public:
 
-    SimpleFreeList() {};
+    SimpleFreeList() : ring(1), head(0), tail(0) {};
 
     /** Add a physical register to the free list */
-    void addReg(PhysRegIndex reg) { freeRegs.push(reg); }
+    void
+    addReg(PhysRegIndex reg)
+    {
+        if (tail - head == ring.size())
+            grow();
+        ring[tail++ & (ring.size() - 1)] = reg;
+    }
 
     /** Get the next available register from the free list */
     PhysRegIndex getReg()
     {
-        assert(!freeRegs.empty());
-        PhysRegIndex free_reg = freeRegs.front();
-        freeRegs.pop();
-        return free_reg;
+        assert(head != tail);
+        return ring[head++ & (ring.size() - 1)];
     }
 
     /** Return the number of free registers on the list. */
-    unsigned numFreeRegs() const { return freeRegs.size(); }
+    unsigned numFreeRegs() const { return tail - head; }
 
     /** True iff there are free registers on the list. */
-    bool hasFreeRegs() const { return !freeRegs.empty(); }
+    bool hasFreeRegs() const { return head != tail; }
+
+    /** The number of registers taken from the list so far */
+    uint64_t position() const { return head; }
+
+    /**
+     * Put back all registers taken since the list was at position,
+     * in the order they were taken. None of them may have been added
+     * back in the meantime.
+     */
+    void
+    rewind(uint64_t position)
+    {
+        assert(position <= head && tail - position <= ring.size());
+        head = position;
+    }
 };
 
 
@@ -139,6 +181,33 @@ class UnifiedFreeList
     /** Returns a pointer to the condition-code free list */
     SimpleFreeList *getCCList() { return &ccList; }
 
+    /** Positions of the per-class free lists, see SimpleFreeList */
+    struct Checkpoint
+    {
+        uint64_t intPos;
+        uint64_t floatPos;
+        uint64_t ccPos;
+    };
+
+    Checkpoint
+    checkpoint() const
+    {
+        Checkpoint cp;
+        cp.intPos = intList.position();
+        cp.floatPos = floatList.position();
+        cp.ccPos = ccList.position();
+        return cp;
+    }
+
+    /** Free again every register taken since cp */
+    void
+    restore(const Checkpoint &cp)
+    {
+        intList.rewind(cp.intPos);
+        floatList.rewind(cp.floatPos);
+        ccList.rewind(cp.ccPos);
+    }
+
     /** Gets a free integer register. */
     PhysRegIndex getIntReg() { return intList.getReg(); }
 
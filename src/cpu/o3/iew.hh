@@ -126,6 +126,7 @@ class DefaultIEW
     /** Probe points. */
     ProbePointArg<DynInstPtr> *ppMispredict;
     ProbePointArg<DynInstPtr> *ppDispatch;
+    ProbePointArg<DynInstPtr> *ppExecute;
 
   public:
     /** Constructs a DefaultIEW with the given parameters. */
@@ -59,7 +59,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -125,6 +124,7 @@ DefaultIEW<Impl>::regProbePoints()
 {
     ppDispatch = new ProbePointArg<DynInstPtr>(cpu->getProbeManager(), "Dispatch");
     ppMispredict = new ProbePointArg<DynInstPtr>(cpu->getProbeManager(), "Mispredict");
+    ppExecute = new ProbePointArg<DynInstPtr>(cpu->getProbeManager(), "Execute");
 }
 
 template <class Impl>
@@ -1231,6 +1231,8 @@ DefaultIEW<Impl>::executeInsts()
             continue;
         }
 
+        ppExecute->notify(inst);
+
         Fault fault = NoFault;
 
         // Execute instruction.
@@ -1585,9 +1587,7 @@ DefaultIEW<Impl>::updateExeInstStats(DynInstPtr &inst)
     iewExecutedInsts++;
 
 #if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        inst->completeTick = curTick() - inst->fetchTick;
-    }
+    inst->completeTick = curTick() - inst->fetchTick;
 #endif
 
     //
@@ -95,7 +95,7 @@ class InstructionQueue
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
     /** FU completion event class. */
-    class FUCompletion : public Event {
+    class FUCompletion : public PooledEvent<> {
       private:
         /** Executing instruction. */
         DynInstPtr inst;
@@ -166,12 +166,24 @@ class InstructionQueue
     /** Returns number of free entries for a thread. */
     unsigned numFreeEntries(ThreadID tid);
 
+    /** Returns the total number of entries. */
+    unsigned getNumEntries() const { return numEntries; }
+
     /** Returns whether or not the IQ is full. */
     bool isFull();
 
     /** Returns whether or not the IQ is full for a specific thread. */
     bool isFull(ThreadID tid);
 
+    /** Returns the index'th oldest instruction of a thread, or NULL if
+     *  the thread has fewer instructions.  Used for fault injection. */
+    DynInstPtr getEntry(ThreadID tid, unsigned index);
+
+    /** Changes a source register of an instruction in the IQ, moving it
+     *  onto the dependency list of the new register if it was waiting.
+     *  Used for fault injection. */
+    void renameSrcReg(DynInstPtr &inst, int src_idx, PhysRegIndex new_reg);
+
     /** Returns if there are any ready instructions in the IQ. */
     bool hasReadyInsts();
 
@@ -363,39 +375,49 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
+    /** Entry for the list age ordering by op class.  The list is
+     *  intrusive: each op class owns exactly one entry, linked to its
+     *  neighbours by op class index, so reordering a ready queue never
+     *  allocates and unlinking it is O(1).
+     */
     struct ListOrderEntry {
-        OpClass queueType;
         InstSeqNum oldestInst;
+        int prev;
+        int next;
     };
 
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
+    /** Link value marking the end (or start) of the age order list. */
+    static const int ListOrderEnd = Num_OpClasses;
+
+    /** Age order of the oldest instruction of each ready queue, indexed
+     *  by op class.  Used to select the oldest instruction available
      *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
      */
-    std::list<ListOrderEntry> listOrder;
+    ListOrderEntry listOrder[Num_OpClasses];
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Oldest op class on the age order list. */
+    int listOrderHead;
+
+    /** Youngest op class on the age order list. */
+    int listOrderTail;
 
     /** Tracks if each ready queue is on the age order list. */
     bool queueOnList[Num_OpClasses];
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
-
     /** Add an op class to the age order list. */
     void addToOrderList(OpClass op_class);
 
+    /** Remove an op class from the age order list. */
+    void removeFromOrderList(OpClass op_class);
+
+    /** Link an op class into the age order list ahead of another entry. */
+    void linkOrderList(OpClass op_class, int before);
+
     /**
      * Called when the oldest instruction has been removed from a ready queue;
      * this places that ready queue into the proper spot in the age order list.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    void moveToYoungerInst(OpClass op_class);
 
     DependencyGraph<DynInstPtr> dependGraph;
 
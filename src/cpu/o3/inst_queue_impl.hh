@@ -62,7 +62,7 @@ using std::list;
 template <class Impl>
 InstructionQueue<Impl>::FUCompletion::FUCompletion(DynInstPtr &_inst,
     int fu_idx, InstructionQueue<Impl> *iq_ptr)
-    : Event(Stat_Event_Pri, AutoDelete),
+    : PooledEvent<>(Stat_Event_Pri, AutoDelete),
       inst(_inst), fuIdx(fu_idx), iqPtr(iq_ptr), freeFU(false)
 {
 }
@@ -408,10 +408,12 @@ InstructionQueue<Impl>::resetState()
         while (!readyInsts[i].empty())
             readyInsts[i].pop();
         queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
+        listOrder[i].prev = ListOrderEnd;
+        listOrder[i].next = ListOrderEnd;
     }
     nonSpecInsts.clear();
-    listOrder.clear();
+    listOrderHead = ListOrderEnd;
+    listOrderTail = ListOrderEnd;
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -543,11 +545,71 @@ InstructionQueue<Impl>::isFull(ThreadID tid)
     }
 }
 
+template <class Impl>
+typename Impl::DynInstPtr
+InstructionQueue<Impl>::getEntry(ThreadID tid, unsigned index)
+{
+    if (index >= instList[tid].size())
+        return NULL;
+
+    ListIt inst_it = instList[tid].begin();
+    std::advance(inst_it, index);
+    return *inst_it;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::renameSrcReg(DynInstPtr &inst, int src_idx,
+                                     PhysRegIndex new_reg)
+{
+    PhysRegIndex old_reg = inst->renamedSrcRegIdx(src_idx);
+
+    // Only instructions inserted speculatively are on the dependency
+    // graph, and only for sources whose producer hasn't completed.
+    bool waiting = !inst->isNonSpeculative() &&
+        !inst->isStoreConditional() &&
+        !inst->isMemBarrier() &&
+        !inst->isWriteBarrier() &&
+        !inst->isReadySrcRegIdx(src_idx) &&
+        old_reg < numPhysRegs &&
+        !regScoreboard[old_reg];
+
+    inst->renameSrcReg(src_idx, new_reg);
+
+    // Sources that were ready stay ready and read whatever the new
+    // register holds at issue.
+    if (!waiting)
+        return;
+
+    dependGraph.remove(old_reg, inst);
+
+    // Only wait on an older producer that is still to complete, so the
+    // instruction can't end up waiting on itself, on a younger
+    // instruction that depends on it, or on a squashed instruction.
+    DynInstPtr producer;
+    if (new_reg < numPhysRegs)
+        producer = dependGraph.getInst(new_reg);
+
+    if (producer && !regScoreboard[new_reg] && !producer->isSquashed() &&
+        producer->seqNum < inst->seqNum) {
+        DPRINTF(IQ, "Instruction PC %s now waits on src reg %i.\n",
+                inst->pcState(), new_reg);
+
+        dependGraph.insert(new_reg, inst);
+    } else {
+        DPRINTF(IQ, "Instruction PC %s src reg %i is ready.\n",
+                inst->pcState(), new_reg);
+
+        inst->markSrcRegReady(src_idx);
+        addIfReady(inst);
+    }
+}
+
 template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
+    if (listOrderHead != ListOrderEnd) {
         return true;
     }
 
@@ -667,55 +729,96 @@ InstructionQueue<Impl>::getInstToExecute()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+InstructionQueue<Impl>::linkOrderList(OpClass op_class, int before)
 {
-    assert(!readyInsts[op_class].empty());
+    ListOrderEntry &entry = listOrder[op_class];
 
-    ListOrderEntry queue_entry;
+    entry.next = before;
+    entry.prev = before == ListOrderEnd ? listOrderTail :
+        listOrder[before].prev;
 
-    queue_entry.queueType = op_class;
+    if (entry.prev == ListOrderEnd) {
+        listOrderHead = op_class;
+    } else {
+        listOrder[entry.prev].next = op_class;
+    }
 
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+    if (before == ListOrderEnd) {
+        listOrderTail = op_class;
+    } else {
+        listOrder[before].prev = op_class;
+    }
+}
 
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
+template <class Impl>
+void
+InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+{
+    assert(!readyInsts[op_class].empty());
+    assert(!queueOnList[op_class]);
 
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
+    InstSeqNum oldest = readyInsts[op_class].top()->seqNum;
+    int list_it = listOrderHead;
+
+    while (list_it != ListOrderEnd) {
+        if (listOrder[list_it].oldestInst > oldest) {
             break;
         }
 
-        list_it++;
+        list_it = listOrder[list_it].next;
     }
 
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
+    listOrder[op_class].oldestInst = oldest;
+    linkOrderList(op_class, list_it);
     queueOnList[op_class] = true;
 }
 
 template <class Impl>
 void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+InstructionQueue<Impl>::removeFromOrderList(OpClass op_class)
+{
+    assert(queueOnList[op_class]);
+
+    ListOrderEntry &entry = listOrder[op_class];
+
+    if (entry.prev == ListOrderEnd) {
+        listOrderHead = entry.next;
+    } else {
+        listOrder[entry.prev].next = entry.next;
+    }
+
+    if (entry.next == ListOrderEnd) {
+        listOrderTail = entry.prev;
+    } else {
+        listOrder[entry.next].prev = entry.prev;
+    }
+
+    entry.prev = ListOrderEnd;
+    entry.next = ListOrderEnd;
+    queueOnList[op_class] = false;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::moveToYoungerInst(OpClass op_class)
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
+    // Unlink the entry, then walk forward from its old successor to the
+    // first entry that is not older than the new oldest instruction and
+    // relink it there.  An entry that stays in place lands right before
+    // its old successor, so the select loop will not revisit it.
+    int next_it = listOrder[op_class].next;
+    InstSeqNum oldest = readyInsts[op_class].top()->seqNum;
+
+    removeFromOrderList(op_class);
+
+    while (next_it != ListOrderEnd &&
+           listOrder[next_it].oldestInst < oldest) {
+        next_it = listOrder[next_it].next;
     }
 
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    listOrder[op_class].oldestInst = oldest;
+    linkOrderList(op_class, next_it);
+    queueOnList[op_class] = true;
 }
 
 template <class Impl>
@@ -770,11 +873,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    int order_it = listOrderHead;
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    while (total_issued < totalWidth && order_it != ListOrderEnd) {
+        OpClass op_class = OpClass(order_it);
+        int next_it = listOrder[order_it].next;
 
         assert(!readyInsts[op_class].empty());
 
@@ -782,19 +885,18 @@ InstructionQueue<Impl>::scheduleReadyInsts()
 
         issuing_inst->isFloating() ? fpInstQueueReads++ : intInstQueueReads++;
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
+        assert(issuing_inst->seqNum == listOrder[op_class].oldestInst);
 
         if (issuing_inst->isSquashed()) {
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
+                moveToYoungerInst(op_class);
             } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+                removeFromOrderList(op_class);
             }
 
-            listOrder.erase(order_it++);
+            order_it = next_it;
 
             ++iqSquashedInstsIssued;
 
@@ -853,10 +955,9 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
+                moveToYoungerInst(op_class);
             } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+                removeFromOrderList(op_class);
             }
 
             issuing_inst->setIssued();
@@ -876,12 +977,12 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
+            order_it = next_it;
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            order_it = next_it;
         }
     }
 
@@ -1040,8 +1141,8 @@ InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
     if (!queueOnList[op_class]) {
         addToOrderList(op_class);
     } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
+               listOrder[op_class].oldestInst) {
+        removeFromOrderList(op_class);
         addToOrderList(op_class);
     }
 
@@ -1404,8 +1505,8 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
         if (!queueOnList[op_class]) {
             addToOrderList(op_class);
         } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
+                   listOrder[op_class].oldestInst) {
+            removeFromOrderList(op_class);
             addToOrderList(op_class);
         }
     }
@@ -1472,17 +1573,16 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
+    int list_order_it = listOrderHead;
     int i = 1;
 
     cprintf("List order: ");
 
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%lli] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
+    while (list_order_it != ListOrderEnd) {
+        cprintf("%i OpClass:%i [sn:%lli] ", i, list_order_it,
+                listOrder[list_order_it].oldestInst);
 
-        ++list_order_it;
+        list_order_it = listOrder[list_order_it].next;
         ++i;
     }
 
@@ -155,6 +155,9 @@ class LSQ {
     DynInstPtr getMemDepViolator(ThreadID tid)
     { return thread[tid].getMemDepViolator(); }
 
+    /** Returns the LSQ unit of a thread. */
+    LSQUnit &getUnit(ThreadID tid) { return thread[tid]; }
+
     /** Returns the head index of the load queue for a specific thread. */
     int getLoadHead(ThreadID tid)
     { return thread[tid].getLoadHead(); }
@@ -248,6 +248,13 @@ class LSQUnit {
     /** Attempts to send a store to the cache. */
     bool sendStore(PacketPtr data_pkt);
 
+    /** Counts a store's blocks into (or out of) the store address
+     *  filter. */
+    void filterStore(int store_idx, bool insert);
+
+    /** Can any store in the SQ overlap the given address range? */
+    bool storesMayAlias(Addr addr, unsigned size) const;
+
     /** Increments the given store index (circular queue). */
     inline void incrStIdx(int &store_idx) const;
     /** Decrements the given store index (circular queue). */
@@ -311,7 +318,7 @@ class LSQUnit {
     };
 
     /** Writeback event, specifically for when stores forward data to loads. */
-    class WritebackEvent : public Event {
+    class WritebackEvent : public PooledEvent<> {
       public:
         /** Constructs a writeback event. */
         WritebackEvent(DynInstPtr &_inst, PacketPtr pkt, LSQUnit *lsq_ptr);
@@ -338,7 +345,8 @@ class LSQUnit {
         /** Constructs an empty store queue entry. */
         SQEntry()
             : inst(NULL), req(NULL), size(0),
-              canWB(0), committed(0), completed(0)
+              canWB(0), committed(0), completed(0), filterAddr(0),
+              inAddrFilter(false)
         {
             std::memset(data, 0, sizeof(data));
         }
@@ -351,7 +359,8 @@ class LSQUnit {
         /** Constructs a store queue entry for a given instruction. */
         SQEntry(DynInstPtr &_inst)
             : inst(_inst), req(NULL), sreqLow(NULL), sreqHigh(NULL), size(0),
-              isSplit(0), canWB(0), committed(0), completed(0), isAllZeros(0)
+              isSplit(0), canWB(0), committed(0), completed(0), isAllZeros(0),
+              filterAddr(0), inAddrFilter(false)
         {
             std::memset(data, 0, sizeof(data));
         }
@@ -379,6 +388,10 @@ class LSQUnit {
          * style instructs (ARM DC ZVA; ALPHA WH64)
          */
         bool isAllZeros;
+        /** The address the store was entered in the address filter with. */
+        Addr filterAddr;
+        /** Whether or not the store is counted in the address filter. */
+        bool inAddrFilter;
     };
 
   private:
@@ -405,6 +418,18 @@ class LSQUnit {
      */
     unsigned depCheckShift;
 
+    /** Number of buckets in the store address filter; a power of two. */
+    static const unsigned SQFilterBuckets = 256;
+
+    /** Addresses are hashed into the filter at this block size. */
+    static const unsigned SQFilterShift = 6;
+
+    /** Number of SQ stores touching each hashed address block.  A load
+     *  whose blocks all have a zero count cannot be forwarded from or
+     *  stalled by any store, so read() skips the SQ search for it.
+     */
+    uint16_t sqAddrFilter[SQFilterBuckets];
+
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
@@ -481,6 +506,9 @@ class LSQUnit {
     /** Total number of loads forwaded from LSQ stores. */
     Stats::Scalar lsqForwLoads;
 
+    /** Total number of loads that skipped the SQ search. */
+    Stats::Scalar lsqForwSearchFiltered;
+
     /** Total number of loads ignored due to invalid addresses. */
     Stats::Scalar invAddrLoads;
 
@@ -518,6 +546,30 @@ class LSQUnit {
     Fault write(Request *req, Request *sreqLow, Request *sreqHigh,
                 uint8_t *data, int store_idx);
 
+    /** Returns the index'th oldest load, or NULL if there are fewer
+     *  loads.  Used for fault injection. */
+    DynInstPtr
+    getLoadEntry(unsigned index)
+    {
+        if (int(index) >= loads)
+            return NULL;
+        return loadQueue[(loadHead + index) % LQEntries];
+    }
+
+    /** Returns the index'th oldest store, or NULL if there are fewer
+     *  stores.  Used for fault injection. */
+    SQEntry *
+    getStoreEntry(unsigned index)
+    {
+        if (int(index) >= stores)
+            return NULL;
+        return &storeQueue[(storeHead + index) % SQEntries];
+    }
+
+    /** Returns the usable sizes of the load and store queues. */
+    unsigned getMaxLoads() const { return LQEntries - 1; }
+    unsigned getMaxStores() const { return SQEntries - 1; }
+
     /** Returns the index of the head load instruction. */
     int getLoadHead() { return loadHead; }
     /** Returns the sequence number of the head load instruction. */
@@ -637,6 +689,13 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
         return NoFault;
     }
 
+    // No store in the SQ touches the blocks this load reads, so there
+    // is nothing to forward from or stall on.
+    if (store_idx != -1 && !storesMayAlias(req->getVaddr(), req->getSize())) {
+        ++lsqForwSearchFiltered;
+        store_idx = -1;
+    }
+
     while (store_idx != -1) {
         // End once we've reached the top of the LSQ
         if (store_idx == storeWBIdx) {
@@ -899,6 +958,11 @@ LSQUnit<Impl>::write(Request *req, Request *sreqLow, Request *sreqHigh,
         storeQueue[store_idx].isSplit = true;
     }
 
+    if (storeQueue[store_idx].inAddrFilter)
+        filterStore(store_idx, false);
+    storeQueue[store_idx].filterAddr = req->getVaddr();
+    filterStore(store_idx, true);
+
     if (!(req->getFlags() & Request::CACHE_BLOCK_ZERO))
         memcpy(storeQueue[store_idx].data, data, size);
 
@@ -46,6 +46,8 @@
 #ifndef __CPU_O3_LSQ_UNIT_IMPL_HH__
 #define __CPU_O3_LSQ_UNIT_IMPL_HH__
 
+#include <algorithm>
+
 #include "arch/generic/debugfaults.hh"
 #include "arch/locked_mem.hh"
 #include "base/str.hh"
@@ -56,14 +58,13 @@
 #include "debug/Activity.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
 template<class Impl>
 LSQUnit<Impl>::WritebackEvent::WritebackEvent(DynInstPtr &_inst, PacketPtr _pkt,
                                               LSQUnit *lsq_ptr)
-    : Event(Default_Pri, AutoDelete),
+    : PooledEvent<>(Default_Pri, AutoDelete),
       inst(_inst), pkt(_pkt), lsqPtr(lsq_ptr)
 {
 }
@@ -192,6 +193,8 @@ LSQUnit<Impl>::resetState()
 
     storeHead = storeWBIdx = storeTail = 0;
 
+    std::fill(sqAddrFilter, sqAddrFilter + SQFilterBuckets, 0);
+
     usedPorts = 0;
 
     retryPkt = NULL;
@@ -221,6 +224,11 @@ LSQUnit<Impl>::regStats()
         .name(name() + ".forwLoads")
         .desc("Number of loads that had data forwarded from stores");
 
+    lsqForwSearchFiltered
+        .name(name() + ".forwSearchFiltered")
+        .desc("Number of loads that no store could alias, so skipped the "
+              "store queue search");
+
     invAddrLoads
         .name(name() + ".invAddrLoads")
         .desc("Number of loads ignored due to an invalid address");
@@ -1048,6 +1056,9 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
             stallingStoreIsn = 0;
         }
 
+        if (storeQueue[store_idx].inAddrFilter)
+            filterStore(store_idx, false);
+
         // Clear the smart pointer to make sure it is decremented.
         storeQueue[store_idx].inst->setSquashed();
         storeQueue[store_idx].inst = NULL;
@@ -1164,6 +1175,9 @@ LSQUnit<Impl>::completeStore(int store_idx)
 
     if (store_idx == storeHead) {
         do {
+            if (storeQueue[storeHead].inAddrFilter)
+                filterStore(storeHead, false);
+
             incrStIdx(storeHead);
 
             --stores;
@@ -1178,10 +1192,8 @@ LSQUnit<Impl>::completeStore(int store_idx)
             storeQueue[store_idx].inst->seqNum, store_idx, storeHead);
 
 #if TRACING_ON
-    if (DTRACE(O3PipeView)) {
-        storeQueue[store_idx].inst->storeTick =
-            curTick() - storeQueue[store_idx].inst->fetchTick;
-    }
+    storeQueue[store_idx].inst->storeTick =
+        curTick() - storeQueue[store_idx].inst->fetchTick;
 #endif
 
     if (isStalled() &&
@@ -1258,6 +1270,46 @@ LSQUnit<Impl>::recvRetry()
     }
 }
 
+template <class Impl>
+void
+LSQUnit<Impl>::filterStore(int store_idx, bool insert)
+{
+    SQEntry &entry = storeQueue[store_idx];
+
+    assert(entry.size);
+    assert(entry.inAddrFilter != insert);
+
+    Addr first = entry.filterAddr >> SQFilterShift;
+    Addr last = (entry.filterAddr + entry.size - 1) >> SQFilterShift;
+
+    for (Addr block = first; block <= last; ++block) {
+        uint16_t &count = sqAddrFilter[block & (SQFilterBuckets - 1)];
+        if (insert) {
+            ++count;
+        } else {
+            assert(count);
+            --count;
+        }
+    }
+
+    entry.inAddrFilter = insert;
+}
+
+template <class Impl>
+bool
+LSQUnit<Impl>::storesMayAlias(Addr addr, unsigned size) const
+{
+    Addr first = addr >> SQFilterShift;
+    Addr last = (addr + size - 1) >> SQFilterShift;
+
+    for (Addr block = first; block <= last; ++block) {
+        if (sqAddrFilter[block & (SQFilterBuckets - 1)])
+            return true;
+    }
+
+    return false;
+}
+
 template <class Impl>
 inline void
 LSQUnit<Impl>::incrStIdx(int &store_idx) const
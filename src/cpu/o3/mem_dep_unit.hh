@@ -43,24 +43,13 @@
 #ifndef __CPU_O3_MEM_DEP_UNIT_HH__
 #define __CPU_O3_MEM_DEP_UNIT_HH__
 
-#include <list>
-#include <memory>
-#include <set>
+#include <utility>
+#include <vector>
 
-#include "base/hashmap.hh"
 #include "base/statistics.hh"
 #include "cpu/inst_seq.hh"
 #include "debug/MemDepUnit.hh"
 
-struct SNHash {
-    size_t operator() (const InstSeqNum &seq_num) const {
-        unsigned a = (unsigned)seq_num;
-        unsigned hash = (((a >> 14) ^ ((a >> 2) & 0xffff))) & 0x7FFFFFFF;
-
-        return hash;
-    }
-};
-
 struct DerivO3CPUParams;
 
 template <class Impl>
@@ -163,56 +152,35 @@ class MemDepUnit
     void dumpLists();
 
   private:
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
-
-    class MemDepEntry;
-
-    typedef std::shared_ptr<MemDepEntry> MemDepEntryPtr;
-
     /** Memory dependence entries that track memory operations, marking
      *  when the instruction is ready to execute and what instructions depend
-     *  upon it.
+     *  upon it. Entries live in a pool and are named by their index,
+     *  which the instruction keeps in memDepIdx, so that inserting and
+     *  finding them allocates nothing once the pool has grown to the
+     *  peak number of memory instructions in flight.
      */
     class MemDepEntry {
       public:
-        /** Constructs a memory dependence entry. */
-        MemDepEntry(DynInstPtr &new_inst)
-            : inst(new_inst), regsReady(false), memDepReady(false),
-              completed(false), squashed(false)
-        {
-#ifdef DEBUG
-            ++memdep_count;
-
-            DPRINTF(MemDepUnit, "Memory dependency entry created.  "
-                    "memdep_count=%i %s\n", memdep_count, inst->pcState());
-#endif
-        }
-
-        /** Frees any pointers. */
-        ~MemDepEntry()
-        {
-            for (int i = 0; i < dependInsts.size(); ++i) {
-                dependInsts[i] = NULL;
-            }
-#ifdef DEBUG
-            --memdep_count;
-
-            DPRINTF(MemDepUnit, "Memory dependency entry deleted.  "
-                    "memdep_count=%i %s\n", memdep_count, inst->pcState());
-#endif
-        }
-
-        /** Returns the name of the memory dependence entry. */
-        std::string name() const { return "memdepentry"; }
-
-        /** The instruction being tracked. */
+        MemDepEntry()
+            : seqNum(0), prev(-1), next(-1), regsReady(false),
+              memDepReady(false), completed(false), squashed(false)
+        { }
+
+        /** The instruction being tracked, NULL if the entry is free. */
         DynInstPtr inst;
 
-        /** The iterator to the instruction's location inside the list. */
-        ListIt listIt;
+        /** Sequence number of the instruction. */
+        InstSeqNum seqNum;
 
-        /** A vector of any dependent instructions. */
-        std::vector<MemDepEntryPtr> dependInsts;
+        /** Neighbours in the thread's instruction list (or the next
+         *  free entry), -1 at the ends. */
+        int prev;
+        int next;
+
+        /** Any dependent instructions, as entries and the sequence
+         *  numbers they were added with, so that a dependent whose entry
+         *  has been freed and reused is not woken. */
+        std::vector<std::pair<int, InstSeqNum> > dependInsts;
 
         /** If the registers are ready or not. */
         bool regsReady;
@@ -222,33 +190,46 @@ class MemDepUnit
         bool completed;
         /** If the instruction is squashed. */
         bool squashed;
-
-        /** For debugging. */
-#ifdef DEBUG
-        static int memdep_count;
-        static int memdep_insert;
-        static int memdep_erase;
-#endif
     };
 
-    /** Finds the memory dependence entry in the hash map. */
-    inline MemDepEntryPtr &findInHash(const DynInstPtr &inst);
+    /** Takes a free entry for inst and appends it to the thread's
+     *  instruction list. */
+    int allocEntry(DynInstPtr &inst);
+
+    /** Unlinks an entry from its instruction list and frees it. */
+    void freeEntry(int idx);
+
+    /** Finds the memory dependence entry of an inserted instruction. */
+    inline MemDepEntry &findEntry(const DynInstPtr &inst);
+
+    /** Finds the entry of a sequence number, -1 if there is none. */
+    inline int findSeqNum(InstSeqNum seq_num) const;
 
     /** Moves an entry to the ready list. */
-    inline void moveToReady(MemDepEntryPtr &ready_inst_entry);
+    inline void moveToReady(MemDepEntry &ready_inst_entry);
+
+    /** The entry pool, only ever grown. */
+    std::vector<MemDepEntry> entries;
 
-    typedef m5::hash_map<InstSeqNum, MemDepEntryPtr, SNHash> MemDepHash;
+    /** Head of the chain of free entries. */
+    int freeEntries;
 
-    typedef typename MemDepHash::iterator MemDepHashIt;
+    /** Number of entries in use. */
+    unsigned numEntries;
 
-    /** A hash map of all memory dependence entries. */
-    MemDepHash memDepHash;
+    /** Entries by sequence number modulo the table size. A younger
+     *  instruction takes the slot of an older one still in flight,
+     *  which then can't be found as a producer and only loses its
+     *  predicted dependents. */
+    std::vector<int> seqTable;
 
-    /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** Oldest and youngest entries of each thread's instructions, in
+     *  program order. */
+    int listHead[Impl::MaxThreads];
+    int listTail[Impl::MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
-    std::list<DynInstPtr> instsToReplay;
+    std::vector<DynInstPtr> instsToReplay;
 
     /** The memory dependence predictor.  It is accessed upon new
      *  instructions being added to the IQ, and responds by telling
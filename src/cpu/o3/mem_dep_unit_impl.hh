@@ -43,8 +43,7 @@
 #ifndef __CPU_O3_MEM_DEP_UNIT_IMPL_HH__
 #define __CPU_O3_MEM_DEP_UNIT_IMPL_HH__
 
-#include <map>
-
+#include "base/intmath.hh"
 #include "cpu/o3/inst_queue.hh"
 #include "cpu/o3/mem_dep_unit.hh"
 #include "debug/MemDepUnit.hh"
@@ -52,45 +51,38 @@
 
 template <class MemDepPred, class Impl>
 MemDepUnit<MemDepPred, Impl>::MemDepUnit()
-    : loadBarrier(false), loadBarrierSN(0), storeBarrier(false),
-      storeBarrierSN(0), iqPtr(NULL)
+    : freeEntries(-1), numEntries(0), loadBarrier(false), loadBarrierSN(0),
+      storeBarrier(false), storeBarrierSN(0), iqPtr(NULL)
 {
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++)
+        listHead[tid] = listTail[tid] = -1;
 }
 
 template <class MemDepPred, class Impl>
 MemDepUnit<MemDepPred, Impl>::MemDepUnit(DerivO3CPUParams *params)
     : _name(params->name + ".memdepunit"),
+      freeEntries(-1), numEntries(0),
+      seqTable(1 << ceilLog2(2 * params->numROBEntries), -1),
       depPred(params->store_set_clear_period, params->SSITSize,
-              params->LFSTSize),
+              params->LFSTSize, params->SQEntries),
       loadBarrier(false), loadBarrierSN(0), storeBarrier(false),
       storeBarrierSN(0), iqPtr(NULL)
 {
     DPRINTF(MemDepUnit, "Creating MemDepUnit object.\n");
+
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++)
+        listHead[tid] = listTail[tid] = -1;
 }
 
 template <class MemDepPred, class Impl>
 MemDepUnit<MemDepPred, Impl>::~MemDepUnit()
 {
     for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
-
-        ListIt inst_list_it = instList[tid].begin();
-
-        MemDepHashIt hash_it;
-
-        while (!instList[tid].empty()) {
-            hash_it = memDepHash.find((*inst_list_it)->seqNum);
-
-            assert(hash_it != memDepHash.end());
-
-            memDepHash.erase(hash_it);
-
-            instList[tid].erase(inst_list_it++);
-        }
+        while (listHead[tid] != -1)
+            freeEntry(listHead[tid]);
     }
 
-#ifdef DEBUG
-    assert(MemDepEntry::memdep_count == 0);
-#endif
+    assert(numEntries == 0);
 }
 
 template <class MemDepPred, class Impl>
@@ -103,7 +95,13 @@ MemDepUnit<MemDepPred, Impl>::init(DerivO3CPUParams *params, ThreadID tid)
     id = tid;
 
     depPred.init(params->store_set_clear_period, params->SSITSize,
-            params->LFSTSize);
+            params->LFSTSize, params->SQEntries);
+
+    // Every memory instruction in flight has a load or store queue
+    // entry, which bounds the pool in all but barrier heavy code.
+    entries.reserve(params->LQEntries + params->SQEntries);
+    seqTable.assign(1 << ceilLog2(2 * params->numROBEntries), -1);
+    instsToReplay.reserve(params->LQEntries + params->SQEntries);
 }
 
 template <class MemDepPred, class Impl>
@@ -131,11 +129,9 @@ template <class MemDepPred, class Impl>
 bool
 MemDepUnit<MemDepPred, Impl>::isDrained() const
 {
-    bool drained = instsToReplay.empty()
-                 && memDepHash.empty()
-                 && instsToReplay.empty();
+    bool drained = instsToReplay.empty() && numEntries == 0;
     for (int i = 0; i < Impl::MaxThreads; ++i)
-        drained = drained && instList[i].empty();
+        drained = drained && listHead[i] == -1;
 
     return drained;
 }
@@ -145,11 +141,9 @@ void
 MemDepUnit<MemDepPred, Impl>::drainSanityCheck() const
 {
     assert(instsToReplay.empty());
-    assert(memDepHash.empty());
+    assert(numEntries == 0);
     for (int i = 0; i < Impl::MaxThreads; ++i)
-        assert(instList[i].empty());
-    assert(instsToReplay.empty());
-    assert(memDepHash.empty());
+        assert(listHead[i] == -1 && listTail[i] == -1);
 }
 
 template <class MemDepPred, class Impl>
@@ -170,23 +164,78 @@ MemDepUnit<MemDepPred, Impl>::setIQ(InstructionQueue<Impl> *iq_ptr)
 }
 
 template <class MemDepPred, class Impl>
-void
-MemDepUnit<MemDepPred, Impl>::insert(DynInstPtr &inst)
+int
+MemDepUnit<MemDepPred, Impl>::allocEntry(DynInstPtr &inst)
 {
     ThreadID tid = inst->threadNumber;
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
-
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(inst->seqNum, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
+    int idx = freeEntries;
+    if (idx != -1) {
+        freeEntries = entries[idx].next;
+    } else {
+        idx = entries.size();
+        entries.push_back(MemDepEntry());
+    }
+    ++numEntries;
+
+    MemDepEntry &entry = entries[idx];
+    entry.inst = inst;
+    entry.seqNum = inst->seqNum;
+    entry.regsReady = entry.memDepReady = false;
+    entry.completed = entry.squashed = false;
+    assert(entry.dependInsts.empty());
+
+    // Append to the thread's list, which stays in program order.
+    entry.prev = listTail[tid];
+    entry.next = -1;
+    if (listTail[tid] != -1)
+        entries[listTail[tid]].next = idx;
+    else
+        listHead[tid] = idx;
+    listTail[tid] = idx;
+
+    seqTable[inst->seqNum & (seqTable.size() - 1)] = idx;
+    inst->memDepIdx = idx;
+
+    return idx;
+}
 
-    instList[tid].push_back(inst);
+template <class MemDepPred, class Impl>
+void
+MemDepUnit<MemDepPred, Impl>::freeEntry(int idx)
+{
+    MemDepEntry &entry = entries[idx];
+    ThreadID tid = entry.inst->threadNumber;
+
+    if (entry.prev != -1)
+        entries[entry.prev].next = entry.next;
+    else
+        listHead[tid] = entry.next;
+    if (entry.next != -1)
+        entries[entry.next].prev = entry.prev;
+    else
+        listTail[tid] = entry.prev;
+
+    // A younger instruction may have taken over the slot.
+    int &slot = seqTable[entry.seqNum & (seqTable.size() - 1)];
+    if (slot == idx)
+        slot = -1;
+
+    entry.inst->memDepIdx = -1;
+    entry.inst = NULL;
+    entry.dependInsts.clear();
+
+    entry.prev = -1;
+    entry.next = freeEntries;
+    freeEntries = idx;
+    --numEntries;
+}
 
-    inst_entry->listIt = --(instList[tid].end());
+template <class MemDepPred, class Impl>
+void
+MemDepUnit<MemDepPred, Impl>::insert(DynInstPtr &inst)
+{
+    int inst_idx = allocEntry(inst);
 
     // Check any barriers and the dependence predictor for any
     // producing memrefs/stores.
@@ -203,29 +252,30 @@ MemDepUnit<MemDepPred, Impl>::insert(DynInstPtr &inst)
         producing_store = depPred.checkInst(inst->instAddr());
     }
 
-    MemDepEntryPtr store_entry = NULL;
+    int store_idx = -1;
 
     // If there is a producing store, try to find the entry.
     if (producing_store != 0) {
         DPRINTF(MemDepUnit, "Searching for producer\n");
-        MemDepHashIt hash_it = memDepHash.find(producing_store);
+        store_idx = findSeqNum(producing_store);
 
-        if (hash_it != memDepHash.end()) {
-            store_entry = (*hash_it).second;
+        if (store_idx != -1) {
             DPRINTF(MemDepUnit, "Proucer found\n");
         }
     }
 
+    MemDepEntry &inst_entry = entries[inst_idx];
+
     // If no store entry, then instruction can issue as soon as the registers
     // are ready.
-    if (!store_entry) {
+    if (store_idx == -1) {
         DPRINTF(MemDepUnit, "No dependency for inst PC "
                 "%s [sn:%lli].\n", inst->pcState(), inst->seqNum);
 
-        inst_entry->memDepReady = true;
+        inst_entry.memDepReady = true;
 
         if (inst->readyToIssue()) {
-            inst_entry->regsReady = true;
+            inst_entry.regsReady = true;
 
             moveToReady(inst_entry);
         }
@@ -236,14 +286,15 @@ MemDepUnit<MemDepPred, Impl>::insert(DynInstPtr &inst)
                 inst->pcState(), producing_store);
 
         if (inst->readyToIssue()) {
-            inst_entry->regsReady = true;
+            inst_entry.regsReady = true;
         }
 
         // Clear the bit saying this instruction can issue.
         inst->clearCanIssue();
 
         // Add this instruction to the list of dependents.
-        store_entry->dependInsts.push_back(inst_entry);
+        entries[store_idx].dependInsts.push_back(
+            std::make_pair(inst_idx, inst->seqNum));
 
         if (inst->isLoad()) {
             ++conflictingLoads;
@@ -270,21 +321,7 @@ template <class MemDepPred, class Impl>
 void
 MemDepUnit<MemDepPred, Impl>::insertNonSpec(DynInstPtr &inst)
 {
-    ThreadID tid = inst->threadNumber;
-
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
-
-    // Insert the MemDepEntry into the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(inst->seqNum, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
-
-    // Add the instruction to the list.
-    instList[tid].push_back(inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    allocEntry(inst);
 
     // Might want to turn this part into an inline function or something.
     // It's shared between both insert functions.
@@ -321,21 +358,7 @@ MemDepUnit<MemDepPred, Impl>::insertBarrier(DynInstPtr &barr_inst)
         DPRINTF(MemDepUnit, "Inserted a write barrier\n");
     }
 
-    ThreadID tid = barr_inst->threadNumber;
-
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(barr_inst);
-
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(barr_sn, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
-
-    // Add the instruction to the instruction list.
-    instList[tid].push_back(barr_inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    allocEntry(barr_inst);
 }
 
 template <class MemDepPred, class Impl>
@@ -346,11 +369,11 @@ MemDepUnit<MemDepPred, Impl>::regsReady(DynInstPtr &inst)
             "instruction PC %s [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
+    MemDepEntry &inst_entry = findEntry(inst);
 
-    inst_entry->regsReady = true;
+    inst_entry.regsReady = true;
 
-    if (inst_entry->memDepReady) {
+    if (inst_entry.memDepReady) {
         DPRINTF(MemDepUnit, "Instruction has its memory "
                 "dependencies resolved, adding it to the ready list.\n");
 
@@ -369,9 +392,7 @@ MemDepUnit<MemDepPred, Impl>::nonSpecInstReady(DynInstPtr &inst)
             "instruction PC %s as ready [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
-
-    moveToReady(inst_entry);
+    moveToReady(findEntry(inst));
 }
 
 template <class MemDepPred, class Impl>
@@ -385,21 +406,17 @@ template <class MemDepPred, class Impl>
 void
 MemDepUnit<MemDepPred, Impl>::replay()
 {
-    DynInstPtr temp_inst;
-
     // For now this replay function replays all waiting memory ops.
-    while (!instsToReplay.empty()) {
-        temp_inst = instsToReplay.front();
-
-        MemDepEntryPtr inst_entry = findInHash(temp_inst);
+    for (int i = 0; i < instsToReplay.size(); ++i) {
+        DynInstPtr &temp_inst = instsToReplay[i];
 
         DPRINTF(MemDepUnit, "Replaying mem instruction PC %s [sn:%lli].\n",
                 temp_inst->pcState(), temp_inst->seqNum);
 
-        moveToReady(inst_entry);
-
-        instsToReplay.pop_front();
+        moveToReady(findEntry(temp_inst));
     }
+
+    instsToReplay.clear();
 }
 
 template <class MemDepPred, class Impl>
@@ -409,21 +426,10 @@ MemDepUnit<MemDepPred, Impl>::completed(DynInstPtr &inst)
     DPRINTF(MemDepUnit, "Completed mem instruction PC %s [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    ThreadID tid = inst->threadNumber;
-
-    // Remove the instruction from the hash and the list.
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
-
-    assert(hash_it != memDepHash.end());
-
-    instList[tid].erase((*hash_it).second->listIt);
-
-    (*hash_it).second = NULL;
-
-    memDepHash.erase(hash_it);
-#ifdef DEBUG
-    MemDepEntry::memdep_erase++;
-#endif
+    // Remove the instruction from the list and free its entry.
+    int idx = inst->memDepIdx;
+    assert(idx >= 0 && entries[idx].inst == inst);
+    freeEntry(idx);
 }
 
 template <class MemDepPred, class Impl>
@@ -456,28 +462,29 @@ MemDepUnit<MemDepPred, Impl>::wakeDependents(DynInstPtr &inst)
         return;
     }
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
+    MemDepEntry &inst_entry = findEntry(inst);
 
-    for (int i = 0; i < inst_entry->dependInsts.size(); ++i ) {
-        MemDepEntryPtr woken_inst = inst_entry->dependInsts[i];
+    for (int i = 0; i < inst_entry.dependInsts.size(); ++i ) {
+        MemDepEntry &woken_inst = entries[inst_entry.dependInsts[i].first];
 
-        if (!woken_inst->inst) {
+        if (!woken_inst.inst ||
+            woken_inst.seqNum != inst_entry.dependInsts[i].second) {
             // Potentially removed mem dep entries could be on this list
             continue;
         }
 
         DPRINTF(MemDepUnit, "Waking up a dependent inst, "
                 "[sn:%lli].\n",
-                woken_inst->inst->seqNum);
+                woken_inst.seqNum);
 
-        if (woken_inst->regsReady && !woken_inst->squashed) {
+        if (woken_inst.regsReady && !woken_inst.squashed) {
             moveToReady(woken_inst);
         } else {
-            woken_inst->memDepReady = true;
+            woken_inst.memDepReady = true;
         }
     }
 
-    inst_entry->dependInsts.clear();
+    inst_entry.dependInsts.clear();
 }
 
 template <class MemDepPred, class Impl>
@@ -486,48 +493,31 @@ MemDepUnit<MemDepPred, Impl>::squash(const InstSeqNum &squashed_num,
                                      ThreadID tid)
 {
     if (!instsToReplay.empty()) {
-        ListIt replay_it = instsToReplay.begin();
-        while (replay_it != instsToReplay.end()) {
-            if ((*replay_it)->threadNumber == tid &&
-                (*replay_it)->seqNum > squashed_num) {
-                instsToReplay.erase(replay_it++);
-            } else {
-                ++replay_it;
+        int kept = 0;
+        for (int i = 0; i < instsToReplay.size(); ++i) {
+            if (instsToReplay[i]->threadNumber != tid ||
+                instsToReplay[i]->seqNum <= squashed_num) {
+                instsToReplay[kept++] = instsToReplay[i];
             }
         }
+        instsToReplay.resize(kept);
     }
 
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
-    MemDepHashIt hash_it;
-
-    while (!instList[tid].empty() &&
-           (*squash_it)->seqNum > squashed_num) {
+    while (listTail[tid] != -1 &&
+           entries[listTail[tid]].seqNum > squashed_num) {
+        MemDepEntry &squash_entry = entries[listTail[tid]];
 
         DPRINTF(MemDepUnit, "Squashing inst [sn:%lli]\n",
-                (*squash_it)->seqNum);
+                squash_entry.seqNum);
 
-        if ((*squash_it)->seqNum == loadBarrierSN)
+        if (squash_entry.seqNum == loadBarrierSN)
               loadBarrier = false;
 
-        if ((*squash_it)->seqNum == storeBarrierSN)
+        if (squash_entry.seqNum == storeBarrierSN)
               storeBarrier = false;
 
-        hash_it = memDepHash.find((*squash_it)->seqNum);
-
-        assert(hash_it != memDepHash.end());
-
-        (*hash_it).second->squashed = true;
-
-        (*hash_it).second = NULL;
-
-        memDepHash.erase(hash_it);
-#ifdef DEBUG
-        MemDepEntry::memdep_erase++;
-#endif
-
-        instList[tid].erase(squash_it--);
+        // Dependents still naming the entry see that it was freed.
+        freeEntry(listTail[tid]);
     }
 
     // Tell the dependency predictor to squash as well.
@@ -557,26 +547,36 @@ MemDepUnit<MemDepPred, Impl>::issue(DynInstPtr &inst)
 }
 
 template <class MemDepPred, class Impl>
-inline typename MemDepUnit<MemDepPred,Impl>::MemDepEntryPtr &
-MemDepUnit<MemDepPred, Impl>::findInHash(const DynInstPtr &inst)
+inline typename MemDepUnit<MemDepPred,Impl>::MemDepEntry &
+MemDepUnit<MemDepPred, Impl>::findEntry(const DynInstPtr &inst)
 {
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
+    assert(inst->memDepIdx >= 0 && inst->memDepIdx < entries.size());
+    assert(entries[inst->memDepIdx].inst == inst);
 
-    assert(hash_it != memDepHash.end());
+    return entries[inst->memDepIdx];
+}
 
-    return (*hash_it).second;
+template <class MemDepPred, class Impl>
+inline int
+MemDepUnit<MemDepPred, Impl>::findSeqNum(InstSeqNum seq_num) const
+{
+    int idx = seqTable[seq_num & (seqTable.size() - 1)];
+
+    if (idx != -1 && entries[idx].seqNum == seq_num)
+        return idx;
+    return -1;
 }
 
 template <class MemDepPred, class Impl>
 inline void
-MemDepUnit<MemDepPred, Impl>::moveToReady(MemDepEntryPtr &woken_inst_entry)
+MemDepUnit<MemDepPred, Impl>::moveToReady(MemDepEntry &woken_inst_entry)
 {
     DPRINTF(MemDepUnit, "Adding instruction [sn:%lli] "
-            "to the ready list.\n", woken_inst_entry->inst->seqNum);
+            "to the ready list.\n", woken_inst_entry.seqNum);
 
-    assert(!woken_inst_entry->squashed);
+    assert(!woken_inst_entry.squashed);
 
-    iqPtr->addReadyMemInst(woken_inst_entry->inst);
+    iqPtr->addReadyMemInst(woken_inst_entry.inst);
 }
 
 
@@ -585,30 +585,29 @@ void
 MemDepUnit<MemDepPred, Impl>::dumpLists()
 {
     for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
-        cprintf("Instruction list %i size: %i\n",
-                tid, instList[tid].size());
+        int size = 0;
+        for (int idx = listHead[tid]; idx != -1; idx = entries[idx].next)
+            ++size;
+
+        cprintf("Instruction list %i size: %i\n", tid, size);
 
-        ListIt inst_list_it = instList[tid].begin();
         int num = 0;
 
-        while (inst_list_it != instList[tid].end()) {
+        for (int idx = listHead[tid]; idx != -1; idx = entries[idx].next) {
+            const DynInstPtr &inst = entries[idx].inst;
             cprintf("Instruction:%i\nPC: %s\n[sn:%i]\n[tid:%i]\nIssued:%i\n"
                     "Squashed:%i\n\n",
-                    num, (*inst_list_it)->pcState(),
-                    (*inst_list_it)->seqNum,
-                    (*inst_list_it)->threadNumber,
-                    (*inst_list_it)->isIssued(),
-                    (*inst_list_it)->isSquashed());
-            inst_list_it++;
+                    num, inst->pcState(),
+                    inst->seqNum,
+                    inst->threadNumber,
+                    inst->isIssued(),
+                    inst->isSquashed());
             ++num;
         }
     }
 
-    cprintf("Memory dependence hash size: %i\n", memDepHash.size());
-
-#ifdef DEBUG
-    cprintf("Memory dependence entries: %i\n", MemDepEntry::memdep_count);
-#endif
+    cprintf("Memory dependence entries: %i of %i\n", numEntries,
+            entries.size());
 }
 
 #endif//__CPU_O3_MEM_DEP_UNIT_IMPL_HH__
@@ -0,0 +1,240 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "cpu/o3/probe/elastic_trace.hh"
+#include "proto/inst_dep_record.pb.h"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+ElasticTrace::ElasticTrace(const ElasticTraceParams *params)
+    : ProbeListenerObject(params),
+      regProducer(TheISA::Max_Reg_Index),
+      committed(0),
+      windowSize(params->window_size),
+      traceStream(NULL)
+{
+    if (windowSize == 0)
+        fatal("%s: window_size must be at least one instruction\n",
+              name());
+
+    std::string filename = simout.resolve(params->trace_file.empty() ?
+                                          ProbeListenerObject::name() +
+                                          ".dep.gz" : params->trace_file);
+    traceStream = new ProtoOutputStream(filename, params->trace_background);
+
+    ProtoMessage::InstDepRecordHeader header_msg;
+    header_msg.set_obj_id(ProbeListenerObject::name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+    header_msg.set_window_size(windowSize);
+    traceStream->write(header_msg);
+
+    for (auto &producer : regProducer)
+        producer.seqNum = 0;
+
+    // As with the CommMonitor, the destructor is not called, so
+    // make sure the trace is flushed on exit
+    Callback* cb = new MakeCallback<ElasticTrace,
+        &ElasticTrace::closeStream>(this);
+    registerExitCallback(cb);
+}
+
+ElasticTrace::~ElasticTrace()
+{
+    closeStream();
+}
+
+void
+ElasticTrace::closeStream()
+{
+    delete traceStream;
+    traceStream = NULL;
+}
+
+void
+ElasticTrace::recordDispatch(const DynInstPtr &dynInst)
+{
+    inFlight[dynInst->seqNum].dispatch = curTick();
+}
+
+void
+ElasticTrace::recordExecute(const DynInstPtr &dynInst)
+{
+    // A memory instruction deferred for a page table walk executes
+    // again, and it is the last attempt that goes to memory
+    inFlight[dynInst->seqNum].execute = curTick();
+}
+
+void
+ElasticTrace::recordComplete(const std::pair<DynInstPtr, PacketPtr> &access)
+{
+    auto it = inFlight.find(access.first->seqNum);
+    if (it != inFlight.end())
+        it->second.complete = curTick();
+}
+
+void
+ElasticTrace::addDep(const Producer &producer,
+                     std::vector<InstSeqNum> &deps, Tick &ready) const
+{
+    // Anything older than the window has long completed in the
+    // replay as well, so leave it out to keep the trace compact
+    if (producer.seqNum == 0 || committed - producer.commitIdx > windowSize)
+        return;
+
+    if (std::find(deps.begin(), deps.end(), producer.seqNum) == deps.end())
+        deps.push_back(producer.seqNum);
+    ready = std::max(ready, producer.complete);
+}
+
+void
+ElasticTrace::recordCommit(const DynInstPtr &dynInst)
+{
+    if (traceStream == NULL)
+        return;
+
+    // Collect the timing of this instruction, and forget about any
+    // older ones, which must have been squashed
+    InFlight timing;
+    auto end = inFlight.upper_bound(dynInst->seqNum);
+    auto it = inFlight.find(dynInst->seqNum);
+    if (it != inFlight.end())
+        timing = it->second;
+    inFlight.erase(inFlight.begin(), end);
+
+    Tick now = curTick();
+    if (timing.dispatch == MaxTick)
+        timing.dispatch = now;
+    if (timing.execute == MaxTick)
+        timing.execute = timing.dispatch;
+
+    ProtoMessage::InstDepRecord rec;
+    rec.set_seq_num(dynInst->seqNum);
+    rec.set_pc(dynInst->instAddr());
+
+    bool is_mem = dynInst->isMemRef() && dynInst->effAddrValid() &&
+        dynInst->readPredicate();
+    bool is_load = is_mem && dynInst->isLoad();
+    bool is_store = is_mem && dynInst->isStore();
+
+    std::vector<InstSeqNum> reg_deps;
+    Tick ready = timing.dispatch;
+    for (int i = 0; i < dynInst->numSrcRegs(); i++) {
+        TheISA::RegIndex idx = dynInst->srcRegIdx(i);
+        if (idx == TheISA::ZeroReg || idx >= TheISA::Misc_Reg_Base)
+            continue;
+        addDep(regProducer[idx], reg_deps, ready);
+    }
+
+    // Drop the stores that have left the window, and depend on the
+    // youngest one overlapping each byte of a load
+    while (!stores.empty() &&
+           committed - stores.front().commitIdx > windowSize)
+        stores.pop_front();
+
+    std::vector<InstSeqNum> mem_deps;
+    if (is_load) {
+        Addr addr = dynInst->physEffAddr;
+        Addr end_addr = addr + dynInst->effSize;
+        for (auto s = stores.rbegin(); s != stores.rend(); ++s) {
+            if (s->addr < end_addr && addr < s->addr + s->size) {
+                addDep(*s, mem_deps, ready);
+                break;
+            }
+        }
+    }
+
+    // Loads that got their data from memory complete when it
+    // arrives, everything else when it executes
+    Tick complete = is_load && timing.complete != MaxTick ?
+        timing.complete : timing.execute;
+
+    if (is_load || is_store) {
+        rec.set_type(is_load ? ProtoMessage::InstDepRecord::LOAD :
+                     ProtoMessage::InstDepRecord::STORE);
+        rec.set_p_addr(dynInst->physEffAddr);
+        rec.set_size(dynInst->effSize);
+        rec.set_flags(dynInst->memReqFlags);
+    } else {
+        rec.set_type(ProtoMessage::InstDepRecord::COMP);
+    }
+
+    for (auto dep : reg_deps)
+        rec.add_reg_dep(dep);
+    for (auto dep : mem_deps)
+        rec.add_mem_dep(dep);
+
+    if (timing.execute > ready)
+        rec.set_comp_delay(timing.execute - ready);
+
+    traceStream->write(rec);
+
+    // Finally make this instruction the producer of its results
+    ++committed;
+
+    Producer self;
+    self.seqNum = dynInst->seqNum;
+    self.commitIdx = committed;
+    self.complete = complete;
+    self.addr = is_store ? dynInst->physEffAddr : 0;
+    self.size = is_store ? dynInst->effSize : 0;
+
+    for (int i = 0; i < dynInst->numDestRegs(); i++) {
+        TheISA::RegIndex idx = dynInst->destRegIdx(i);
+        if (idx == TheISA::ZeroReg || idx >= TheISA::Misc_Reg_Base)
+            continue;
+        regProducer[idx] = self;
+    }
+
+    if (is_store)
+        stores.push_back(self);
+}
+
+void
+ElasticTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<ElasticTrace, DynInstPtr> DynInstListener;
+    typedef ProbeListenerArg<ElasticTrace,
+                             std::pair<DynInstPtr, PacketPtr> > AccessListener;
+    listeners.push_back(new DynInstListener(this, "Dispatch",
+                                            &ElasticTrace::recordDispatch));
+    listeners.push_back(new DynInstListener(this, "Execute",
+                                            &ElasticTrace::recordExecute));
+    listeners.push_back(new AccessListener(this, "DataAccessComplete",
+                                           &ElasticTrace::recordComplete));
+    listeners.push_back(new DynInstListener(this, "Commit",
+                                            &ElasticTrace::recordCommit));
+}
+
+ElasticTrace*
+ElasticTraceParams::create()
+{
+    return new ElasticTrace(this);
+}
@@ -0,0 +1,121 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file This file declares an elastic trace unit which listens to the
+ * dispatch, execute and commit probe points of the O3 pipeline and
+ * records each committed instruction together with its register and
+ * memory dependencies, to be replayed by a TraceCPU.
+ */
+#ifndef __CPU_O3_PROBE_ELASTIC_TRACE_HH__
+#define __CPU_O3_PROBE_ELASTIC_TRACE_HH__
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/impl.hh"
+#include "mem/packet.hh"
+#include "params/ElasticTrace.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+class ElasticTrace : public ProbeListenerObject {
+
+  public:
+    typedef O3CPUImpl::DynInstPtr DynInstPtr;
+
+    ElasticTrace(const ElasticTraceParams *params);
+
+    ~ElasticTrace();
+
+    /** Register the probe listeners. */
+    void regProbeListeners();
+
+    /** Returns the name of the trace. */
+    const std::string name() const
+    { return ProbeListenerObject::name() + ".elastictrace"; }
+
+  private:
+    void recordDispatch(const DynInstPtr &dynInst);
+    void recordExecute(const DynInstPtr &dynInst);
+    void recordComplete(const std::pair<DynInstPtr, PacketPtr> &access);
+    void recordCommit(const DynInstPtr &dynInst);
+
+    /** Flush and close the trace, as the destructor is not called. */
+    void closeStream();
+
+    /** Timing of an instruction that is yet to commit. */
+    struct InFlight
+    {
+        Tick dispatch;
+        Tick execute;
+        Tick complete;
+
+        InFlight() : dispatch(MaxTick), execute(MaxTick), complete(MaxTick)
+        { }
+    };
+
+    /** Last committed writer of a register or a range of memory. */
+    struct Producer
+    {
+        InstSeqNum seqNum;
+        /** Commit count when the producer committed */
+        uint64_t commitIdx;
+        /** When the result was available */
+        Tick complete;
+        Addr addr;
+        unsigned size;
+    };
+
+    /**
+     * Add a producer to the dependencies of a record unless it has
+     * dropped out of the window, tracking the latest completion.
+     */
+    void addDep(const Producer &producer,
+                std::vector<InstSeqNum> &deps, Tick &ready) const;
+
+    /** Instructions dispatched but not committed, by sequence number */
+    std::map<InstSeqNum, InFlight> inFlight;
+
+    /** The last writer of each architectural register */
+    std::vector<Producer> regProducer;
+
+    /** Stores committed within the window, oldest first */
+    std::deque<Producer> stores;
+
+    /** Instructions committed so far */
+    uint64_t committed;
+
+    /** Instructions over which dependencies are tracked */
+    const unsigned windowSize;
+
+    ProtoOutputStream *traceStream;
+
+};
+#endif//__CPU_O3_PROBE_ELASTIC_TRACE_HH__
@@ -0,0 +1,90 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/probe/pipe_timeline.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "sim/sim_exit.hh"
+
+namespace
+{
+
+std::vector<std::string>
+o3Stages()
+{
+    return { "fetch", "decode", "rename", "dispatch", "issue", "complete",
+             "retire", "store" };
+}
+
+}
+
+O3PipeTimeline::O3PipeTimeline(const O3PipeTimelineParams *params)
+    : ProbeListenerObject(params),
+      timeline(simout.resolve(params->timeline_file.empty() ?
+                              ProbeListenerObject::name() + ".ptl" :
+                              params->timeline_file), o3Stages())
+{
+#if !TRACING_ON
+    fatal("%s: the O3 stage ticks are only kept in builds with tracing "
+          "(gem5.opt, gem5.fi or gem5.debug)\n", name());
+#endif
+
+    // The destructor is not called, so complete the file on exit
+    Callback *cb = new MakeCallback<O3PipeTimeline,
+        &O3PipeTimeline::closeTimeline>(this);
+    registerExitCallback(cb);
+}
+
+void
+O3PipeTimeline::recordCommit(const O3CPUImpl::DynInstPtr &dynInst)
+{
+#if TRACING_ON
+    const int32_t deltas[] = {
+        dynInst->decodeTick, dynInst->renameTick, dynInst->dispatchTick,
+        dynInst->issueTick, dynInst->completeTick, dynInst->commitTick,
+        dynInst->storeTick
+    };
+    timeline.record(dynInst->seqNum, dynInst->pcState(),
+                    dynInst->staticInst, dynInst->fetchTick, deltas);
+#endif
+}
+
+void
+O3PipeTimeline::regProbeListeners()
+{
+    typedef ProbeListenerArg<O3PipeTimeline, O3CPUImpl::DynInstPtr>
+        DynInstListener;
+    listeners.push_back(new DynInstListener(this, "Commit",
+                                            &O3PipeTimeline::recordCommit));
+}
+
+O3PipeTimeline *
+O3PipeTimelineParams::create()
+{
+    return new O3PipeTimeline(this);
+}
@@ -0,0 +1,65 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A probe listener that writes the O3 pipeline stage ticks of each
+ * committed instruction to a binary PipeTimeline, a compact
+ * alternative to the O3PipeView debug trace.
+ */
+
+#ifndef __CPU_O3_PROBE_PIPE_TIMELINE_HH__
+#define __CPU_O3_PROBE_PIPE_TIMELINE_HH__
+
+#include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/impl.hh"
+#include "cpu/pipe_timeline.hh"
+#include "params/O3PipeTimeline.hh"
+#include "sim/probe/probe.hh"
+
+class O3PipeTimeline : public ProbeListenerObject
+{
+  public:
+    O3PipeTimeline(const O3PipeTimelineParams *params);
+
+    /** Register the probe listeners. */
+    void regProbeListeners();
+
+    /** Returns the name of the timeline. */
+    const std::string name() const
+    { return ProbeListenerObject::name() + ".timeline"; }
+
+    /** Complete the timeline file */
+    void closeTimeline() { timeline.close(); }
+
+  private:
+    PipeTimeline timeline;
+
+    void recordCommit(const O3CPUImpl::DynInstPtr &dynInst);
+};
+
+#endif // __CPU_O3_PROBE_PIPE_TIMELINE_HH__
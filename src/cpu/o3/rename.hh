@@ -239,6 +239,11 @@ class DefaultRename
     /** Removes a committed instruction's rename history. */
     void removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid);
 
+    /** Checkpoints the rename map and free list after a control
+     * instruction has renamed its destinations, if there is room.
+     */
+    void takeCheckpoint(const DynInstPtr &inst, ThreadID tid);
+
     /** Renames the source registers of an instruction. */
     inline void renameSrcRegs(DynInstPtr &inst, ThreadID tid);
 
@@ -308,6 +313,38 @@ class DefaultRename
      */
     std::list<RenameHistory> historyBuffer[Impl::MaxThreads];
 
+    /** A thread's rename map and the free list positions right after a
+     * control instruction renamed. Squashing the instructions after it
+     * restores both instead of walking the history buffer.
+     */
+    struct RenameCheckpoint {
+        /** The sequence number of the control instruction. */
+        InstSeqNum instSeqNum;
+        /** Copy of the rename map. */
+        RenameMap map;
+        /** Free list heads, the registers taken since need no walk. */
+        typename FreeList::Checkpoint freeList;
+    };
+
+    /** Per-thread rings of checkpoints, oldest first. The maps are
+     * allocated once and copied into, so a checkpoint costs no
+     * allocation.
+     */
+    std::vector<RenameCheckpoint> checkpoints[Impl::MaxThreads];
+
+    /** Index of the oldest checkpoint in the ring. */
+    unsigned checkpointHead[Impl::MaxThreads];
+
+    /** Number of live checkpoints. */
+    unsigned numCheckpoints[Impl::MaxThreads];
+
+    /** The i-th oldest live checkpoint of tid. */
+    RenameCheckpoint &
+    checkpoint(ThreadID tid, unsigned i)
+    {
+        return checkpoints[tid][(checkpointHead[tid] + i) % maxCheckpoints];
+    }
+
     /** Pointer to CPU. */
     O3CPU *cpu;
 
@@ -452,6 +489,11 @@ class DefaultRename
 
     PhysRegIndex maxPhysicalRegs;
 
+    /** Checkpoints per thread; 0, or SMT where the free list is shared,
+     * squashes by walking the history buffer.
+     */
+    unsigned maxCheckpoints;
+
     /** Enum to record the source of a structure full stall.  Can come from
      * either ROB, IQ, LSQ, and it is priortized in that order.
      */
@@ -505,6 +547,10 @@ class DefaultRename
     Stats::Scalar renameCommittedMaps;
     /** Stat for total number of mappings that were undone due to a squash. */
     Stats::Scalar renameUndoneMaps;
+    /** Stat for total number of rename map checkpoints taken. */
+    Stats::Scalar renameCheckpoints;
+    /** Stat for total number of squashes recovered from a checkpoint. */
+    Stats::Scalar renameCheckpointRestores;
     /** Number of serialize instructions handled. */
     Stats::Scalar renamedSerializing;
     /** Number of instructions marked as temporarily serializing. */
@@ -54,7 +54,6 @@
 #include "cpu/reg_class.hh"
 #include "debug/Activity.hh"
 #include "debug/Rename.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -69,7 +68,9 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
       commitWidth(params->commitWidth),
       numThreads(params->numThreads),
       maxPhysicalRegs(params->numPhysIntRegs + params->numPhysFloatRegs
-                      + params->numPhysCCRegs)
+                      + params->numPhysCCRegs),
+      maxCheckpoints(params->numThreads == 1 ?
+                     params->numRenameCheckpoints : 0)
 {
     if (renameWidth > Impl::MaxWidth)
         fatal("renameWidth (%d) is larger than compiled limit (%d),\n"
@@ -78,6 +79,12 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
 
     // @todo: Make into a parameter.
     skidBufferMax = (decodeToRenameDelay + 1) * params->decodeWidth;
+
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        checkpoints[tid].resize(maxCheckpoints);
+        checkpointHead[tid] = 0;
+        numCheckpoints[tid] = 0;
+    }
 }
 
 template <class Impl>
@@ -159,6 +166,14 @@ DefaultRename<Impl>::regStats()
         .name(name() + ".UndoneMaps")
         .desc("Number of HB maps that are undone due to squashing")
         .prereq(renameUndoneMaps);
+    renameCheckpoints
+        .name(name() + ".Checkpoints")
+        .desc("Number of rename map checkpoints taken at control insts")
+        .prereq(renameCheckpoints);
+    renameCheckpointRestores
+        .name(name() + ".CheckpointRestores")
+        .desc("Number of squashes recovered by restoring a checkpoint")
+        .prereq(renameCheckpointRestores);
     renamedSerializing
         .name(name() + ".serializingInsts")
         .desc("count of serializing insts renamed")
@@ -254,6 +269,9 @@ DefaultRename<Impl>::resetStage()
         storesInProgress[tid] = 0;
 
         serializeOnNextInst[tid] = false;
+
+        checkpointHead[tid] = 0;
+        numCheckpoints[tid] = 0;
     }
 }
 
@@ -688,6 +706,9 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
         renameDestRegs(inst, inst->threadNumber);
 
+        if (inst->isControl())
+            takeCheckpoint(inst, tid);
+
         if (inst->isLoad()) {
                 loadsInProgress[tid]++;
         }
@@ -772,9 +793,7 @@ DefaultRename<Impl>::sortInsts()
         DynInstPtr inst = fromDecode->insts[i];
         insts[inst->threadNumber].push_back(inst);
 #if TRACING_ON
-        if (DTRACE(O3PipeView)) {
-            inst->renameTick = curTick() - inst->fetchTick;
-        }
+        inst->renameTick = curTick() - inst->fetchTick;
 #endif
     }
 }
@@ -897,12 +916,44 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
     typename std::list<RenameHistory>::iterator hb_it =
         historyBuffer[tid].begin();
 
+    // Checkpoints of squashed instructions are gone with them
+    while (numCheckpoints[tid] &&
+           checkpoint(tid, numCheckpoints[tid] - 1).instSeqNum >
+           squashed_seq_num) {
+        --numCheckpoints[tid];
+    }
+
     // After a syscall squashes everything, the history buffer may be empty
     // but the ROB may still be squashing instructions.
     if (historyBuffer[tid].empty()) {
         return;
     }
 
+    // A squash after a checkpointed (mispredicted) control instruction
+    // restores the map and the free list as they were right after it,
+    // which leaves only the history entries to drop.
+    if (numCheckpoints[tid] &&
+        checkpoint(tid, numCheckpoints[tid] - 1).instSeqNum ==
+        squashed_seq_num) {
+        const RenameCheckpoint &cp = checkpoint(tid, numCheckpoints[tid] - 1);
+
+        DPRINTF(Rename, "[tid:%u]: Restoring rename checkpoint of "
+                "[sn:%lli].\n", tid, squashed_seq_num);
+
+        *renameMap[tid] = cp.map;
+        freeList->restore(cp.freeList);
+
+        while (!historyBuffer[tid].empty() &&
+               historyBuffer[tid].front().instSeqNum > squashed_seq_num) {
+            historyBuffer[tid].pop_front();
+        }
+
+        ++renameCheckpointRestores;
+        return;
+    }
+
+    bool undone = false;
+
     // Go through the most recent instructions, undoing the mappings
     // they did and freeing up the registers.
     while (!historyBuffer[tid].empty() &&
@@ -925,12 +976,34 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 
             // Put the renamed physical register back on the free list.
             freeList->addReg(hb_it->newPhysReg);
+            undone = true;
         }
 
         historyBuffer[tid].erase(hb_it++);
 
         ++renameUndoneMaps;
     }
+
+    // The registers went back at the tail of the free list, so the
+    // older checkpoints would hand them out twice
+    if (undone)
+        numCheckpoints[tid] = 0;
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::takeCheckpoint(const DynInstPtr &inst, ThreadID tid)
+{
+    if (numCheckpoints[tid] == maxCheckpoints)
+        return;
+
+    RenameCheckpoint &cp = checkpoint(tid, numCheckpoints[tid]);
+    cp.instSeqNum = inst->seqNum;
+    cp.map = *renameMap[tid];
+    cp.freeList = freeList->checkpoint();
+
+    ++numCheckpoints[tid];
+    ++renameCheckpoints;
 }
 
 template<class Impl>
@@ -941,6 +1014,13 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
             "history buffer %u (size=%i), until [sn:%lli].\n",
             tid, tid, historyBuffer[tid].size(), inst_seq_num);
 
+    // Committed control instructions can no longer be squashed after
+    while (numCheckpoints[tid] &&
+           checkpoint(tid, 0).instSeqNum <= inst_seq_num) {
+        checkpointHead[tid] = (checkpointHead[tid] + 1) % maxCheckpoints;
+        --numCheckpoints[tid];
+    }
+
     typename std::list<RenameHistory>::iterator hb_it =
         historyBuffer[tid].end();
 
@@ -49,6 +49,7 @@
 #include <vector>
 
 #include "arch/registers.hh"
+#include "base/circular_queue.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
 
@@ -68,7 +69,8 @@ class ROB
     typedef typename Impl::DynInstPtr DynInstPtr;
 
     typedef std::pair<RegIndex, PhysRegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef CircularQueue<DynInstPtr> InstList;
+    typedef typename InstList::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status {
@@ -184,6 +186,10 @@ class ROB
     unsigned getThreadEntries(ThreadID tid)
     { return threadEntries[tid]; }
 
+    /** Returns the index'th oldest instruction of a thread, or NULL if
+     *  the thread has fewer instructions.  Used for fault injection. */
+    DynInstPtr getEntry(ThreadID tid, unsigned index);
+
     /** Returns if the ROB is full. */
     bool isFull()
     { return numInstsInROB == numEntries; }
@@ -290,8 +296,11 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[Impl::MaxThreads];
 
-    /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** ROB List of Instructions.  Each thread's list is a ring with a
+     *  slot for every ROB entry, so inserting an instruction does not
+     *  allocate.
+     */
+    InstList instList[Impl::MaxThreads];
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
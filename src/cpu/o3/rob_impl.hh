@@ -103,6 +103,10 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
                     "Partitioned, Threshold}");
     }
 
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
+        instList[tid].resize(numEntries);
+    }
+
     resetState();
 }
 
@@ -177,6 +181,16 @@ ROB<Impl>::resetEntries()
     }
 }
 
+template <class Impl>
+typename Impl::DynInstPtr
+ROB<Impl>::getEntry(ThreadID tid, unsigned index)
+{
+    if (index >= instList[tid].size())
+        return NULL;
+
+    return instList[tid][index];
+}
+
 template <class Impl>
 int
 ROB<Impl>::entryAmount(ThreadID num_threads)
@@ -253,9 +267,7 @@ ROB<Impl>::retireHead(ThreadID tid)
     assert(numInstsInROB > 0);
 
     // Get the head ROB instruction.
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = (*head_it);
+    DynInstPtr head_inst = instList[tid].front();
 
     assert(head_inst->readyToCommit());
 
@@ -269,7 +281,7 @@ ROB<Impl>::retireHead(ThreadID tid)
     head_inst->clearInROB();
     head_inst->setCommitted();
 
-    instList[tid].erase(head_it);
+    instList[tid].pop_front();
 
     //Update "Global" Head of ROB
     updateHead();
@@ -555,11 +567,25 @@ template <class Impl>
 typename Impl::DynInstPtr
 ROB<Impl>::findInst(ThreadID tid, InstSeqNum squash_inst)
 {
-    for (InstIt it = instList[tid].begin(); it != instList[tid].end(); it++) {
-        if ((*it)->seqNum == squash_inst) {
-            return *it;
+    // Each thread's list is in program order, so the instruction can be
+    // found by bisecting on sequence number.
+    InstList &insts = instList[tid];
+    size_t lo = 0;
+    size_t hi = insts.size();
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (insts[mid]->seqNum < squash_inst) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+
+    if (lo < insts.size() && insts[lo]->seqNum == squash_inst) {
+        return insts[lo];
+    }
     return NULL;
 }
 
@@ -28,13 +28,16 @@
  * Authors: Kevin Lim
  */
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "cpu/o3/store_set.hh"
 #include "debug/StoreSet.hh"
 
-StoreSet::StoreSet(uint64_t clear_period, int _SSIT_size, int _LFST_size)
+StoreSet::StoreSet(uint64_t clear_period, int _SSIT_size, int _LFST_size,
+                   int store_list_size)
     : clearPeriod(clear_period), SSITSize(_SSIT_size), LFSTSize(_LFST_size)
 {
     DPRINTF(StoreSet, "StoreSet: Creating store set object.\n");
@@ -70,6 +73,8 @@ StoreSet::StoreSet(uint64_t clear_period, int _SSIT_size, int _LFST_size)
     offsetBits = 2;
 
     memOpsPred = 0;
+
+    initStoreList(store_list_size);
 }
 
 StoreSet::~StoreSet()
@@ -77,7 +82,8 @@ StoreSet::~StoreSet()
 }
 
 void
-StoreSet::init(uint64_t clear_period, int _SSIT_size, int _LFST_size)
+StoreSet::init(uint64_t clear_period, int _SSIT_size, int _LFST_size,
+               int store_list_size)
 {
     SSITSize = _SSIT_size;
     LFSTSize = _LFST_size;
@@ -108,8 +114,17 @@ StoreSet::init(uint64_t clear_period, int _SSIT_size, int _LFST_size)
     offsetBits = 2;
 
     memOpsPred = 0;
+
+    initStoreList(store_list_size);
 }
 
+void
+StoreSet::initStoreList(int store_list_size)
+{
+    storeList.resize(1 << ceilLog2(std::max(store_list_size, 1)));
+    storeListTail = 0;
+    storeListSize = 0;
+}
 
 void
 StoreSet::violation(Addr store_PC, Addr load_PC)
@@ -227,7 +242,12 @@ StoreSet::insertStore(Addr store_PC, InstSeqNum store_seq_num, ThreadID tid)
 
         validLFST[store_SSID] = 1;
 
-        storeList[store_seq_num] = store_SSID;
+        StoreListEntry &entry = storeList[storeListTail];
+        entry.seqNum = store_seq_num;
+        entry.ssid = store_SSID;
+        storeListTail = (storeListTail + 1) & (storeList.size() - 1);
+        if (storeListSize < storeList.size())
+            ++storeListSize;
 
         DPRINTF(StoreSet, "Store %#x updated the LFST, SSID: %i\n",
                 store_PC, store_SSID);
@@ -283,12 +303,6 @@ StoreSet::issued(Addr issued_PC, InstSeqNum issued_seq_num, bool is_store)
 
     assert(index < SSITSize);
 
-    SeqNumMapIt store_list_it = storeList.find(issued_seq_num);
-
-    if (store_list_it != storeList.end()) {
-        storeList.erase(store_list_it);
-    }
-
     // Make sure the SSIT still has a valid entry for the issued store.
     if (!validSSIT[index]) {
         return;
@@ -312,27 +326,24 @@ StoreSet::squash(InstSeqNum squashed_num, ThreadID tid)
     DPRINTF(StoreSet, "StoreSet: Squashing until inum %i\n",
             squashed_num);
 
-    int idx;
-    SeqNumMapIt store_list_it = storeList.begin();
-
     //@todo:Fix to only delete from correct thread
-    while (!storeList.empty()) {
-        idx = (*store_list_it).second;
+    while (storeListSize) {
+        unsigned slot = (storeListTail - 1) & (storeList.size() - 1);
+        const StoreListEntry &entry = storeList[slot];
 
-        if ((*store_list_it).first <= squashed_num) {
+        if (entry.seqNum <= squashed_num) {
             break;
         }
 
-        bool younger = LFST[idx] > squashed_num;
-
-        if (validLFST[idx] && younger) {
-            DPRINTF(StoreSet, "Squashed [sn:%lli]\n", LFST[idx]);
-            validLFST[idx] = false;
-
-            storeList.erase(store_list_it++);
-        } else if (!validLFST[idx] && younger) {
-            storeList.erase(store_list_it++);
+        // Issued stores may already have cleared the LFST entry, or a
+        // younger store of the set may have taken it over.
+        if (validLFST[entry.ssid] && LFST[entry.ssid] > squashed_num) {
+            DPRINTF(StoreSet, "Squashed [sn:%lli]\n", LFST[entry.ssid]);
+            validLFST[entry.ssid] = false;
         }
+
+        storeListTail = slot;
+        --storeListSize;
     }
 }
 
@@ -347,21 +358,19 @@ StoreSet::clear()
         validLFST[i] = false;
     }
 
-    storeList.clear();
+    storeListTail = 0;
+    storeListSize = 0;
 }
 
 void
 StoreSet::dump()
 {
-    cprintf("storeList.size(): %i\n", storeList.size());
-    SeqNumMapIt store_list_it = storeList.begin();
-
-    int num = 0;
+    cprintf("storeList.size(): %i\n", storeListSize);
 
-    while (store_list_it != storeList.end()) {
-        cprintf("%i: [sn:%lli] SSID:%i\n",
-                num, (*store_list_it).first, (*store_list_it).second);
-        num++;
-        store_list_it++;
+    // Youngest first, as the list was ordered before.
+    for (unsigned num = 0; num < storeListSize; ++num) {
+        const StoreListEntry &entry =
+            storeList[(storeListTail - 1 - num) & (storeList.size() - 1)];
+        cprintf("%i: [sn:%lli] SSID:%i\n", num, entry.seqNum, entry.ssid);
     }
 }
@@ -31,21 +31,11 @@
 #ifndef __CPU_O3_STORE_SET_HH__
 #define __CPU_O3_STORE_SET_HH__
 
-#include <list>
-#include <map>
-#include <utility>
 #include <vector>
 
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 
-struct ltseqnum {
-    bool operator()(const InstSeqNum &lhs, const InstSeqNum &rhs) const
-    {
-        return lhs > rhs;
-    }
-};
-
 /**
  * Implements a store set predictor for determining if memory
  * instructions are dependent upon each other.  See paper "Memory
@@ -62,14 +52,18 @@ class StoreSet
     /** Default constructor.  init() must be called prior to use. */
     StoreSet() { };
 
-    /** Creates store set predictor with given table sizes. */
-    StoreSet(uint64_t clear_period, int SSIT_size, int LFST_size);
+    /** Creates store set predictor with given table sizes.  The store
+     * list holds at least store_list_size stores, which should cover
+     * every store in flight. */
+    StoreSet(uint64_t clear_period, int SSIT_size, int LFST_size,
+             int store_list_size);
 
     /** Default destructor. */
     ~StoreSet();
 
     /** Initializes the store set predictor with the given table sizes. */
-    void init(uint64_t clear_period, int SSIT_size, int LFST_size);
+    void init(uint64_t clear_period, int SSIT_size, int LFST_size,
+              int store_list_size);
 
     /** Records a memory ordering violation between the younger load
      * and the older store. */
@@ -129,12 +123,29 @@ class StoreSet
     /** Bit vector to tell if the LFST has a valid entry. */
     std::vector<bool> validLFST;
 
-    /** Map of stores that have been inserted into the store set, but
-     * not yet issued or squashed.
+    /** Sizes the store list and resets it. */
+    void initStoreList(int store_list_size);
+
+    /** A store that updated the LFST, kept so that a squash can undo
+     * the update. */
+    struct StoreListEntry
+    {
+        InstSeqNum seqNum;
+        SSID ssid;
+    };
+
+    /** Ring of the stores that updated the LFST, in program order.  A
+     * squash pops the youngest ones; when full, the oldest store is
+     * overwritten, which has committed by then as the ring is at least
+     * as large as the store queue.
      */
-    std::map<InstSeqNum, int, ltseqnum> storeList;
+    std::vector<StoreListEntry> storeList;
+
+    /** Slot of the next store in the store list. */
+    unsigned storeListTail;
 
-    typedef std::map<InstSeqNum, int, ltseqnum>::iterator SeqNumMapIt;
+    /** Number of stores in the store list. */
+    unsigned storeListSize;
 
     /** Number of loads/stores to process before wiping predictor so all
      * entries don't get saturated
@@ -40,6 +40,7 @@
 #include "cpu/thread_context.hh"
 #include "debug/PCEvent.hh"
 #include "sim/core.hh"
+#include "sim/sim_exit.hh"
 #include "sim/system.hh"
 
 using namespace std;
@@ -170,3 +171,18 @@ PanicPCEvent::process(ThreadContext *tc)
     StringWrap name(tc->getCpuPtr()->name() + ".panic_event");
     panic(descr());
 }
+
+ExitPCEvent::ExitPCEvent(PCEventQueue *q, const std::string &cause, Addr pc)
+    : PCEvent(q, cause, pc), fired(false)
+{
+}
+
+void
+ExitPCEvent::process(ThreadContext *tc)
+{
+    if (fired)
+        return;
+
+    fired = true;
+    exitSimLoop(descr());
+}
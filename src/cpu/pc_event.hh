@@ -153,4 +153,16 @@ class PanicPCEvent : public PCEvent
     virtual void process(ThreadContext *tc);
 };
 
+/** Exits the simulation loop, with cause as its cause, the first time
+ *  the PC reaches addr */
+class ExitPCEvent : public PCEvent
+{
+  protected:
+    bool fired;
+
+  public:
+    ExitPCEvent(PCEventQueue *q, const std::string &cause, Addr pc);
+    virtual void process(ThreadContext *tc);
+};
+
 #endif // __PC_EVENT_HH__
@@ -0,0 +1,129 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pipe_timeline.hh"
+
+#include <cstddef>
+#include <cstring>
+
+#include "base/misc.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
+
+const char PipeTimeline::Magic[8] = { 'g', 'e', 'm', '5', 'p', 't', 'l',
+                                      '\0' };
+
+PipeTimeline::PipeTimeline(const std::string &_filename,
+                           const std::vector<std::string> &stage_names)
+    : filename(_filename), numStages(stage_names.size()), numRecords(0)
+{
+    if (numStages == 0 || numStages > MaxStages)
+        fatal("Pipeline timeline %s needs between 1 and %d stages\n",
+              filename, MaxStages);
+
+    stream.open(filename.c_str(),
+                std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+        fatal("Unable to open pipeline timeline %s\n", filename);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = htole(Version);
+    header.recordSize = htole(uint32_t(sizeof(Record)));
+    header.numStages = htole(uint32_t(numStages));
+    header.tickFrequency = htole(uint64_t(SimClock::Frequency));
+    for (unsigned i = 0; i < numStages; i++) {
+        std::strncpy(header.stages[i], stage_names[i].c_str(),
+                     sizeof(header.stages[i]) - 1);
+    }
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+PipeTimeline::~PipeTimeline()
+{
+    close();
+}
+
+void
+PipeTimeline::record(InstSeqNum seq_num, const TheISA::PCState &pc,
+                     const StaticInstPtr &inst, Tick fetch_tick,
+                     const int32_t *deltas, uint16_t flags)
+{
+    if (!stream.is_open())
+        return;
+
+    auto key = std::make_pair(inst.get(), pc.instAddr());
+    auto id = disasmIds.find(key);
+    if (id == disasmIds.end()) {
+        strings.push_back(inst->disassemble(pc.instAddr()));
+        id = disasmIds.insert(std::make_pair(key,
+            std::make_pair(inst, uint32_t(strings.size() - 1)))).first;
+    }
+
+    Record rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.seqNum = htole(uint64_t(seq_num));
+    rec.pc = htole(uint64_t(pc.instAddr()));
+    rec.upc = htole(uint16_t(pc.microPC()));
+    rec.flags = htole(flags);
+    rec.disasm = htole(id->second.second);
+    rec.fetchTick = htole(uint64_t(fetch_tick));
+    for (unsigned i = 0; i < MaxStages - 1; i++)
+        rec.deltas[i] = htole(i + 1 < numStages ? deltas[i] : NoTick);
+    stream.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+    numRecords++;
+}
+
+void
+PipeTimeline::close()
+{
+    if (!stream.is_open())
+        return;
+
+    uint64_t strings_offset = stream.tellp();
+    uint32_t count = htole(uint32_t(strings.size()));
+    stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto &str : strings) {
+        uint32_t len = htole(uint32_t(str.size()));
+        stream.write(reinterpret_cast<const char *>(&len), sizeof(len));
+        stream.write(str.data(), str.size());
+    }
+
+    uint64_t num_records = htole(numRecords);
+    strings_offset = htole(strings_offset);
+    stream.seekp(offsetof(Header, numRecords));
+    stream.write(reinterpret_cast<const char *>(&num_records),
+                 sizeof(num_records));
+    stream.seekp(offsetof(Header, stringsOffset));
+    stream.write(reinterpret_cast<const char *>(&strings_offset),
+                 sizeof(strings_offset));
+    stream.close();
+
+    disasmIds.clear();
+    strings.clear();
+}
@@ -0,0 +1,141 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A compact binary record of when each instruction reached each stage
+ * of a CPU pipeline, written by the O3 and Minor pipeline timeline
+ * probe listeners and read by util/o3-pipeview.py.
+ *
+ * The file is a Header followed by one fixed size Record per
+ * instruction, in the order the instructions were recorded (which, as
+ * they are recorded at commit, is sequence number order), and ends with
+ * a table of the disassembly strings the records refer to.  All fields
+ * are little endian.  The string table is only written when the
+ * timeline is closed; a timeline cut short has a stringsOffset of zero
+ * and its record count is implied by the file size.
+ */
+
+#ifndef __CPU_PIPE_TIMELINE_HH__
+#define __CPU_PIPE_TIMELINE_HH__
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/static_inst.hh"
+
+class PipeTimeline
+{
+  public:
+    /** Stage slots in a record: the fetch tick and the deltas after it */
+    static const unsigned MaxStages = 8;
+
+    /** Delta of a stage the instruction never reached */
+    static const int32_t NoTick = -1;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t numStages;
+        uint32_t reserved;
+        uint64_t tickFrequency;
+        uint64_t numRecords;
+        uint64_t stringsOffset;
+        /** NUL padded stage names, stage 0 being the fetch stage */
+        char stages[MaxStages][16];
+    };
+
+    struct Record
+    {
+        uint64_t seqNum;
+        uint64_t pc;
+        uint16_t upc;
+        uint16_t flags;
+        /** Index of the disassembly in the string table */
+        uint32_t disasm;
+        uint64_t fetchTick;
+        /** Ticks after fetchTick each later stage was reached, or NoTick */
+        int32_t deltas[MaxStages - 1];
+        uint32_t reserved;
+    };
+
+    static const char Magic[8];
+    static const uint32_t Version = 1;
+
+  protected:
+    std::ofstream stream;
+
+    std::string filename;
+
+    unsigned numStages;
+
+    uint64_t numRecords;
+
+    /** Disassembly of each (instruction, pc) recorded so far.  The
+     *  StaticInstPtr keeps the instruction alive so its address can't
+     *  be reused by another */
+    std::map<std::pair<const StaticInst *, Addr>,
+             std::pair<StaticInstPtr, uint32_t> > disasmIds;
+
+    std::vector<std::string> strings;
+
+  public:
+    /** Open filename (already resolved to the output directory) and
+     *  write its header for the given stage names */
+    PipeTimeline(const std::string &filename,
+                 const std::vector<std::string> &stage_names);
+
+    ~PipeTimeline();
+
+    /** Append an instruction's record.  deltas holds numStages - 1
+     *  entries: the ticks after fetch of each later stage */
+    void record(InstSeqNum seq_num, const TheISA::PCState &pc,
+                const StaticInstPtr &inst, Tick fetch_tick,
+                const int32_t *deltas, uint16_t flags = 0);
+
+    /** Write the string table and the final header.  Further records
+     *  are dropped */
+    void close();
+
+    /** The delta of tick after fetch_tick to put in a record */
+    static int32_t
+    delta(Tick tick, Tick fetch_tick)
+    {
+        return tick == MaxTick || tick < fetch_tick ? NoTick :
+            tick - fetch_tick;
+    }
+};
+
+#endif // __CPU_PIPE_TIMELINE_HH__
@@ -56,10 +56,7 @@ LocalBP::LocalBP(const Params *params)
     DPRINTF(Fetch, "index mask: %#x\n", indexMask);
 
     // Setup the array of counters for the local predictor.
-    localCtrs.resize(localPredictorSets);
-
-    for (unsigned i = 0; i < localPredictorSets; ++i)
-        localCtrs[i].setBits(localCtrBits);
+    localCtrs.init(localPredictorSets, localCtrBits);
 
     DPRINTF(Fetch, "local predictor size: %i\n",
             localPredictorSize);
@@ -73,9 +70,7 @@ LocalBP::LocalBP(const Params *params)
 void
 LocalBP::reset()
 {
-    for (unsigned i = 0; i < localPredictorSets; ++i) {
-        localCtrs[i].reset();
-    }
+    localCtrs.reset();
 }
 
 void
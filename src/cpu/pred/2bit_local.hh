@@ -113,7 +113,7 @@ class LocalBP : public BPredUnit
     inline unsigned getLocalIndex(Addr &PC);
 
     /** Array of counters that make up the local predictor. */
-    std::vector<SatCounter> localCtrs;
+    SatCounterTable localCtrs;
 
     /** Size of the local predictor. */
     unsigned localPredictorSize;
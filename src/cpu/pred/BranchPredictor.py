@@ -36,7 +36,7 @@ class BranchPredictor(SimObject):
 
     numThreads = Param.Unsigned(1, "Number of threads")
     predType = Param.String("tournament",
-        "Branch predictor type ('local', 'tournament', 'bi-mode')")
+        "Branch predictor type ('local', 'tournament', 'bi-mode', 'tage')")
     localPredictorSize = Param.Unsigned(2048, "Size of local predictor")
     localCtrBits = Param.Unsigned(2, "Bits per counter")
     localHistoryTableSize = Param.Unsigned(2048, "Size of local history table")
@@ -45,6 +45,17 @@ class BranchPredictor(SimObject):
     choicePredictorSize = Param.Unsigned(8192, "Size of choice predictor")
     choiceCtrBits = Param.Unsigned(2, "Bits of choice counters")
 
+    tageBasePredictorSize = Param.Unsigned(8192,
+        "Size of the TAGE base (bimodal) predictor")
+    tageNumTables = Param.Unsigned(7, "Number of TAGE tagged tables")
+    tageTableBits = Param.Unsigned(10,
+        "Log2 of the number of entries in each TAGE tagged table")
+    tageTagBits = Param.Unsigned(9, "Size of the TAGE tags, in bits")
+    tageMinHist = Param.Unsigned(5,
+        "Global history length of the shortest TAGE table")
+    tageMaxHist = Param.Unsigned(130,
+        "Global history length of the longest TAGE table")
+
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
 
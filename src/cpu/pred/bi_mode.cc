@@ -50,17 +50,9 @@ BiModeBP::BiModeBP(const Params *params)
     if (!isPowerOf2(globalPredictorSize))
         fatal("Invalid global history predictor size.\n");
 
-    choiceCounters.resize(choicePredictorSize);
-    takenCounters.resize(globalPredictorSize);
-    notTakenCounters.resize(globalPredictorSize);
-
-    for (int i = 0; i < choicePredictorSize; ++i) {
-        choiceCounters[i].setBits(choiceCtrBits);
-    }
-    for (int i = 0; i < globalPredictorSize; ++i) {
-        takenCounters[i].setBits(globalCtrBits);
-        notTakenCounters[i].setBits(globalCtrBits);
-    }
+    choiceCounters.init(choicePredictorSize, choiceCtrBits);
+    takenCounters.init(globalPredictorSize, globalCtrBits);
+    notTakenCounters.init(globalPredictorSize, globalCtrBits);
 
     historyRegisterMask = mask(globalHistoryBits);
     choiceHistoryMask = choicePredictorSize - 1;
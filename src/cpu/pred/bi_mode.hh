@@ -87,11 +87,11 @@ class BiModeBP : public BPredUnit
     };
 
     // choice predictors
-    std::vector<SatCounter> choiceCounters;
+    SatCounterTable choiceCounters;
     // taken direction predictors
-    std::vector<SatCounter> takenCounters;
+    SatCounterTable takenCounters;
     // not-taken direction predictors
-    std::vector<SatCounter> notTakenCounters;
+    SatCounterTable notTakenCounters;
 
     unsigned instShiftAmt;
 
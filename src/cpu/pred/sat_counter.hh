@@ -31,6 +31,9 @@
 #ifndef __CPU_PRED_SAT_COUNTER_HH__
 #define __CPU_PRED_SAT_COUNTER_HH__
 
+#include <vector>
+
+#include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/types.hh"
 
@@ -114,4 +117,123 @@ class SatCounter
     uint8_t counter;
 };
 
+/**
+ * A table of saturating counters that all share one width and initial
+ * value, packed into 64-bit words.  Each counter takes the next power of
+ * two bits at or above its width, so a lookup is a shift and a mask and
+ * a word of 2-bit counters holds 32 of them, rather than the 3 bytes
+ * per counter a vector of SatCounter costs.  Indexing returns a small
+ * proxy with the SatCounter interface so tables can be used as before.
+ */
+class SatCounterTable
+{
+  public:
+    /** One counter of the table. */
+    class Ref
+    {
+      public:
+        Ref(SatCounterTable &_table, size_t _idx)
+            : table(_table), idx(_idx)
+        { }
+
+        uint8_t read() const { return table.read(idx); }
+
+        void increment()
+        {
+            uint8_t val = table.read(idx);
+            if (val < table.maxVal)
+                table.write(idx, val + 1);
+        }
+
+        void decrement()
+        {
+            uint8_t val = table.read(idx);
+            if (val > 0)
+                table.write(idx, val - 1);
+        }
+
+        void reset() { table.write(idx, table.initialVal); }
+
+      private:
+        SatCounterTable &table;
+        size_t idx;
+    };
+
+    SatCounterTable()
+        : numCounters(0), slotShift(0), slotsPerWordShift(0),
+          slotMask(0), maxVal(0), initialVal(0)
+    { }
+
+    /**
+     * Size the table, setting every counter to its initial value.
+     * @param num_counters Number of counters.
+     * @param bits How many bits each counter has (1 to 8).
+     * @param initial_val Starting value for each counter.
+     */
+    void
+    init(size_t num_counters, unsigned bits, uint8_t initial_val = 0)
+    {
+        if (bits < 1 || bits > 8)
+            fatal("BP: Counters must have between 1 and 8 bits.");
+
+        maxVal = (1 << bits) - 1;
+        if (initial_val > maxVal)
+            fatal("BP: Initial counter value exceeds max size.");
+
+        numCounters = num_counters;
+        initialVal = initial_val;
+        slotShift = ceilLog2(bits);
+        slotsPerWordShift = 6 - slotShift;
+        slotMask = (ULL(1) << (1 << slotShift)) - 1;
+
+        size_t num_words = (num_counters + (ULL(1) << slotsPerWordShift) - 1)
+            >> slotsPerWordShift;
+        words.assign(num_words, 0);
+        reset();
+    }
+
+    /** Set every counter back to its initial value. */
+    void
+    reset()
+    {
+        uint64_t word = 0;
+        for (unsigned i = 0; i < (1 << slotsPerWordShift); ++i)
+            word |= uint64_t(initialVal) << (i << slotShift);
+        words.assign(words.size(), word);
+    }
+
+    size_t size() const { return numCounters; }
+
+    Ref operator[](size_t idx) { return Ref(*this, idx); }
+
+    uint8_t
+    read(size_t idx) const
+    {
+        assert(idx < numCounters);
+        return (words[idx >> slotsPerWordShift] >> bitOffset(idx)) & slotMask;
+    }
+
+  private:
+    unsigned bitOffset(size_t idx) const
+    { return (idx & ((1 << slotsPerWordShift) - 1)) << slotShift; }
+
+    void
+    write(size_t idx, uint8_t val)
+    {
+        uint64_t &word = words[idx >> slotsPerWordShift];
+        unsigned offset = bitOffset(idx);
+        word = (word & ~(slotMask << offset)) | (uint64_t(val) << offset);
+    }
+
+    std::vector<uint64_t> words;
+    size_t numCounters;
+    /** log2 of the bits each counter occupies */
+    unsigned slotShift;
+    /** log2 of the counters held by each word */
+    unsigned slotsPerWordShift;
+    uint64_t slotMask;
+    uint8_t maxVal;
+    uint8_t initialVal;
+};
+
 #endif // __CPU_PRED_SAT_COUNTER_HH__
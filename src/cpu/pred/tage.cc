@@ -0,0 +1,404 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE branch predictor
+ */
+
+#include "cpu/pred/tage.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+
+void
+TageBP::FoldedHistory::init(unsigned orig_length, unsigned comp_length)
+{
+    comp = 0;
+    origLength = orig_length;
+    compLength = comp_length;
+    outpoint = orig_length % comp_length;
+}
+
+void
+TageBP::FoldedHistory::update(bool in_bit, bool out_bit)
+{
+    comp = (comp << 1) | in_bit;
+    comp ^= unsigned(out_bit) << outpoint;
+    comp ^= comp >> compLength;
+    comp &= mask(compLength);
+}
+
+TageBP::TageBP(const Params *params)
+    : BPredUnit(params), instShiftAmt(params->instShiftAmt),
+      numTables(params->tageNumTables),
+      tableBits(params->tageTableBits),
+      tagBits(params->tageTagBits),
+      histLengths(params->tageNumTables + 1, 0),
+      baseMask(params->tageBasePredictorSize - 1),
+      tables(params->tageNumTables + 1),
+      ghist(HistBufferSize, false),
+      ptGhist(0),
+      useAltOnNewAlloc(0),
+      uResetCount(0),
+      uResetPeriod(ULL(1) << 18),
+      randomState(1)
+{
+    if (numTables < 1 || numTables >= MaxTables)
+        fatal("TAGE: Number of tagged tables must be between 1 and %d.\n",
+              MaxTables - 1);
+    if (tagBits < 2 || tagBits > 16)
+        fatal("TAGE: Tags must be between 2 and 16 bits.\n");
+    if (tableBits < 1 || tableBits > 24)
+        fatal("TAGE: Invalid tagged table size.\n");
+    if (!isPowerOf2(params->tageBasePredictorSize))
+        fatal("TAGE: Invalid base predictor size.\n");
+    if (params->tageMinHist < 1 ||
+        params->tageMaxHist < params->tageMinHist ||
+        params->tageMaxHist >= HistBufferSize / 2)
+        fatal("TAGE: Invalid history lengths.\n");
+
+    baseCounters.init(params->tageBasePredictorSize, 2);
+
+    // History lengths form a geometric series from the shortest to the
+    // longest.
+    for (unsigned i = 1; i <= numTables; ++i) {
+        if (numTables == 1) {
+            histLengths[i] = params->tageMinHist;
+        } else {
+            double ratio = double(params->tageMaxHist) / params->tageMinHist;
+            histLengths[i] = unsigned(params->tageMinHist *
+                std::pow(ratio, double(i - 1) / (numTables - 1)) + 0.5);
+        }
+
+        tables[i].resize(ULL(1) << tableBits);
+        foldedIdx[i].init(histLengths[i], tableBits);
+        foldedTag0[i].init(histLengths[i], tagBits);
+        foldedTag1[i].init(histLengths[i], tagBits - 1);
+    }
+}
+
+void
+TageBP::saveHistory(BPHistory *history) const
+{
+    history->ptGhist = ptGhist;
+    for (unsigned i = 1; i <= numTables; ++i) {
+        history->foldedIdx[i] = foldedIdx[i].comp;
+        history->foldedTag0[i] = foldedTag0[i].comp;
+        history->foldedTag1[i] = foldedTag1[i].comp;
+    }
+}
+
+void
+TageBP::restoreHistory(const BPHistory *history)
+{
+    ptGhist = history->ptGhist;
+    for (unsigned i = 1; i <= numTables; ++i) {
+        foldedIdx[i].comp = history->foldedIdx[i];
+        foldedTag0[i].comp = history->foldedTag0[i];
+        foldedTag1[i].comp = history->foldedTag1[i];
+    }
+}
+
+void
+TageBP::updateGlobalHist(bool taken)
+{
+    ++ptGhist;
+    ghist[ptGhist & (HistBufferSize - 1)] = taken;
+
+    for (unsigned i = 1; i <= numTables; ++i) {
+        bool out_bit = ghistBit(ptGhist - histLengths[i]);
+        foldedIdx[i].update(taken, out_bit);
+        foldedTag0[i].update(taken, out_bit);
+        foldedTag1[i].update(taken, out_bit);
+    }
+}
+
+unsigned
+TageBP::gindex(Addr pc, unsigned bank) const
+{
+    Addr pc_bits = pc >> instShiftAmt;
+    unsigned shift = (tableBits > bank ? tableBits - bank : bank - tableBits)
+        + 1;
+    return (pc_bits ^ (pc_bits >> shift) ^ foldedIdx[bank].comp) &
+        mask(tableBits);
+}
+
+uint16_t
+TageBP::gtag(Addr pc, unsigned bank) const
+{
+    Addr pc_bits = pc >> instShiftAmt;
+    return (pc_bits ^ foldedTag0[bank].comp ^ (foldedTag1[bank].comp << 1)) &
+        mask(tagBits);
+}
+
+bool
+TageBP::basePredict(unsigned idx) const
+{
+    return baseCounters.read(idx) >= 2;
+}
+
+void
+TageBP::ctrUpdate(int8_t &ctr, bool taken, unsigned bits)
+{
+    if (taken) {
+        if (ctr < (1 << (bits - 1)) - 1)
+            ++ctr;
+    } else {
+        if (ctr > -(1 << (bits - 1)))
+            --ctr;
+    }
+}
+
+unsigned
+TageBP::nextRandom()
+{
+    // A 32-bit xorshift keeps allocation decisions reproducible.
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+void
+TageBP::uncondBranch(void * &bpHistory)
+{
+    BPHistory *history = new BPHistory;
+    saveHistory(history);
+    history->condBranch = false;
+    history->hitBank = 0;
+    history->altBank = 0;
+    history->tagePred = true;
+    bpHistory = static_cast<void*>(history);
+    updateGlobalHist(true);
+}
+
+void
+TageBP::squash(void *bpHistory)
+{
+    BPHistory *history = static_cast<BPHistory*>(bpHistory);
+    restoreHistory(history);
+
+    delete history;
+}
+
+/*
+ * The tagged table with the longest history whose entry matches
+ * provides the prediction, the next longest match (or the base
+ * predictor) the alternate prediction.  An entry whose counter is
+ * still weak was most likely allocated recently, and if such entries
+ * have proved less reliable than the alternate, the alternate is used.
+ */
+bool
+TageBP::lookup(Addr branchAddr, void * &bpHistory)
+{
+    BPHistory *history = new BPHistory;
+    saveHistory(history);
+    history->condBranch = true;
+
+    history->baseIdx = (branchAddr >> instShiftAmt) & baseMask;
+    for (unsigned i = 1; i <= numTables; ++i) {
+        history->tableIdx[i] = gindex(branchAddr, i);
+        history->tableTag[i] = gtag(branchAddr, i);
+    }
+
+    history->hitBank = 0;
+    history->altBank = 0;
+    for (unsigned i = numTables; i > 0; --i) {
+        if (tables[i][history->tableIdx[i]].tag == history->tableTag[i]) {
+            history->hitBank = i;
+            break;
+        }
+    }
+    for (unsigned i = history->hitBank; i-- > 1; ) {
+        if (tables[i][history->tableIdx[i]].tag == history->tableTag[i]) {
+            history->altBank = i;
+            break;
+        }
+    }
+
+    bool base_pred = basePredict(history->baseIdx);
+
+    if (history->hitBank > 0) {
+        if (history->altBank > 0) {
+            history->altTaken =
+                tables[history->altBank][history->tableIdx[history->altBank]]
+                .ctr >= 0;
+        } else {
+            history->altTaken = base_pred;
+        }
+
+        const TageEntry &entry =
+            tables[history->hitBank][history->tableIdx[history->hitBank]];
+        history->longestMatchPred = entry.ctr >= 0;
+        history->pseudoNewAlloc = entry.ctr == 0 || entry.ctr == -1;
+
+        if (useAltOnNewAlloc < 0 || !history->pseudoNewAlloc) {
+            history->tagePred = history->longestMatchPred;
+        } else {
+            history->tagePred = history->altTaken;
+        }
+    } else {
+        history->altTaken = base_pred;
+        history->longestMatchPred = base_pred;
+        history->pseudoNewAlloc = false;
+        history->tagePred = base_pred;
+    }
+
+    bpHistory = static_cast<void*>(history);
+    updateGlobalHist(history->tagePred);
+
+    return history->tagePred;
+}
+
+void
+TageBP::btbUpdate(Addr branchAddr, void * &bpHistory)
+{
+    // The branch will be treated as not taken; record that in the
+    // speculative history in place of the prediction.
+    BPHistory *history = static_cast<BPHistory*>(bpHistory);
+    restoreHistory(history);
+    updateGlobalHist(false);
+}
+
+void
+TageBP::updateTables(BPHistory *history, bool taken)
+{
+    const unsigned hit_bank = history->hitBank;
+    const unsigned alt_bank = history->altBank;
+
+    bool alloc = history->tagePred != taken && hit_bank < numTables;
+
+    if (hit_bank > 0 && history->pseudoNewAlloc) {
+        // A weak entry that was right needs no more room.
+        if (history->longestMatchPred == taken)
+            alloc = false;
+
+        // Learn whether new entries or the alternate do better.
+        if (history->longestMatchPred != history->altTaken) {
+            ctrUpdate(useAltOnNewAlloc, history->altTaken == taken, 4);
+        }
+    }
+
+    if (alloc) {
+        // If no longer table has a free entry, age them all so one
+        // will be free next time.
+        uint8_t min_u = 3;
+        for (unsigned i = hit_bank + 1; i <= numTables; ++i) {
+            min_u = std::min(min_u, tables[i][history->tableIdx[i]].u);
+        }
+        if (min_u > 0) {
+            for (unsigned i = hit_bank + 1; i <= numTables; ++i) {
+                --tables[i][history->tableIdx[i]].u;
+            }
+        }
+
+        // Start one table further up now and then so that allocation
+        // doesn't always land in the shortest available table.
+        unsigned start = hit_bank + 1;
+        if ((nextRandom() & 1) && start < numTables)
+            ++start;
+
+        for (unsigned i = start; i <= numTables; ++i) {
+            TageEntry &entry = tables[i][history->tableIdx[i]];
+            if (entry.u == 0) {
+                entry.tag = history->tableTag[i];
+                entry.ctr = taken ? 0 : -1;
+                break;
+            }
+        }
+    }
+
+    // Periodically halve the usefulness counters so that entries that
+    // stop being useful can be replaced.
+    if (++uResetCount % uResetPeriod == 0) {
+        for (unsigned i = 1; i <= numTables; ++i) {
+            for (auto &entry : tables[i])
+                entry.u >>= 1;
+        }
+    }
+
+    if (hit_bank > 0) {
+        TageEntry &entry = tables[hit_bank][history->tableIdx[hit_bank]];
+
+        // An entry not yet proven useful also trains the alternate.
+        if (entry.u == 0) {
+            if (alt_bank > 0) {
+                ctrUpdate(tables[alt_bank][history->tableIdx[alt_bank]].ctr,
+                          taken, 3);
+            } else if (taken) {
+                baseCounters[history->baseIdx].increment();
+            } else {
+                baseCounters[history->baseIdx].decrement();
+            }
+        }
+
+        ctrUpdate(entry.ctr, taken, 3);
+
+        if (history->tagePred != history->altTaken) {
+            if (history->tagePred == taken) {
+                if (entry.u < 3)
+                    ++entry.u;
+            } else if (entry.u > 0) {
+                --entry.u;
+            }
+        }
+    } else if (taken) {
+        baseCounters[history->baseIdx].increment();
+    } else {
+        baseCounters[history->baseIdx].decrement();
+    }
+}
+
+void
+TageBP::update(Addr branchAddr, bool taken, void *bpHistory, bool squashed)
+{
+    if (bpHistory) {
+        BPHistory *history = static_cast<BPHistory*>(bpHistory);
+
+        if (history->condBranch)
+            updateTables(history, taken);
+
+        if (squashed) {
+            // Replay this branch into the history with its real outcome;
+            // the history record is kept until the branch retires.
+            restoreHistory(history);
+            updateGlobalHist(taken);
+        } else {
+            delete history;
+        }
+    }
+}
+
+void
+TageBP::retireSquashed(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    delete history;
+}
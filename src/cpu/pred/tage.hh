@@ -0,0 +1,188 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE branch predictor
+ */
+
+#ifndef __CPU_PRED_TAGE_HH__
+#define __CPU_PRED_TAGE_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/sat_counter.hh"
+
+/**
+ * Implements a TAGE (TAgged GEometric history length) predictor after
+ * Seznec and Michaud.  A PC-indexed bimodal table provides the base
+ * prediction; it is overridden by a set of tagged tables, each indexed
+ * by a hash of the PC and a longer slice of global history, the lengths
+ * forming a geometric series.  The matching table with the longest
+ * history provides the prediction, unless its entry has only just been
+ * allocated and entries in that state have been found to do worse than
+ * the alternate prediction.
+ *
+ * The global history is a circular buffer of outcome bits along with
+ * the folded (compressed) forms of it each table's index and tag hash
+ * use.  Lookups update both speculatively; the per-branch history saves
+ * the buffer position and the folded values so that squashes can
+ * restore them.
+ */
+class TageBP : public BPredUnit
+{
+  public:
+    TageBP(const Params *params);
+    void uncondBranch(void * &bp_history);
+    void squash(void *bp_history);
+    bool lookup(Addr branch_addr, void * &bp_history);
+    void btbUpdate(Addr branch_addr, void * &bp_history);
+    void update(Addr branch_addr, bool taken, void *bp_history, bool squashed);
+    void retireSquashed(void *bp_history);
+
+  private:
+    /** Upper bound on the number of tagged tables. */
+    static const unsigned MaxTables = 16;
+
+    /** Global history bits kept; must exceed the longest history by
+     *  more than the number of branches that can be in flight. */
+    static const unsigned HistBufferSize = 1 << 16;
+
+    /** A tagged table entry. */
+    struct TageEntry
+    {
+        TageEntry() : ctr(0), tag(0), u(0) { }
+
+        /** Signed 3-bit direction counter; taken if >= 0. */
+        int8_t ctr;
+        uint16_t tag;
+        /** 2-bit usefulness counter. */
+        uint8_t u;
+    };
+
+    /**
+     * Global history folded down to a given width by XORing successive
+     * slices of it.  Updated incrementally as bits enter and leave the
+     * history window.
+     */
+    struct FoldedHistory
+    {
+        unsigned comp;
+        unsigned compLength;
+        unsigned origLength;
+        unsigned outpoint;
+
+        void init(unsigned orig_length, unsigned comp_length);
+        void update(bool in_bit, bool out_bit);
+    };
+
+    struct BPHistory {
+        /** Global history position before this branch was added. */
+        uint64_t ptGhist;
+        unsigned foldedIdx[MaxTables];
+        unsigned foldedTag0[MaxTables];
+        unsigned foldedTag1[MaxTables];
+
+        /** Was this a conditional branch? */
+        bool condBranch;
+
+        unsigned baseIdx;
+        unsigned tableIdx[MaxTables];
+        uint16_t tableTag[MaxTables];
+
+        /** Table providing the prediction, 0 for the base predictor. */
+        unsigned hitBank;
+        /** Next matching table with a shorter history. */
+        unsigned altBank;
+
+        bool longestMatchPred;
+        bool altTaken;
+        bool pseudoNewAlloc;
+        bool tagePred;
+    };
+
+    /** Record the current speculative history state in a history. */
+    void saveHistory(BPHistory *history) const;
+
+    /** Rewind the speculative history state to a saved one. */
+    void restoreHistory(const BPHistory *history);
+
+    /** Shift a new outcome into the global history. */
+    void updateGlobalHist(bool taken);
+
+    bool ghistBit(uint64_t pos) const
+    { return ghist[pos & (HistBufferSize - 1)]; }
+
+    unsigned gindex(Addr pc, unsigned bank) const;
+    uint16_t gtag(Addr pc, unsigned bank) const;
+
+    bool basePredict(unsigned idx) const;
+
+    /** Saturating update of a signed counter of the given width. */
+    static void ctrUpdate(int8_t &ctr, bool taken, unsigned bits);
+
+    /** Train the tables with a branch's outcome. */
+    void updateTables(BPHistory *history, bool taken);
+
+    /** Pick a table to try allocating from, for a bit of randomness. */
+    unsigned nextRandom();
+
+    unsigned instShiftAmt;
+
+    unsigned numTables;
+    unsigned tableBits;
+    unsigned tagBits;
+
+    /** History length used by each tagged table, indexed from 1. */
+    std::vector<unsigned> histLengths;
+
+    SatCounterTable baseCounters;
+    unsigned baseMask;
+
+    /** The tagged tables, indexed from 1 like histLengths. */
+    std::vector<std::vector<TageEntry> > tables;
+
+    std::vector<bool> ghist;
+    uint64_t ptGhist;
+
+    FoldedHistory foldedIdx[MaxTables];
+    FoldedHistory foldedTag0[MaxTables];
+    FoldedHistory foldedTag1[MaxTables];
+
+    /** Whether newly allocated entries should defer to the alternate
+     *  prediction; a signed 4-bit counter, defer if >= 0. */
+    int8_t useAltOnNewAlloc;
+
+    /** Branches committed since the usefulness bits were last aged. */
+    uint64_t uResetCount;
+    uint64_t uResetPeriod;
+
+    uint32_t randomState;
+};
+
+#endif // __CPU_PRED_TAGE_HH__
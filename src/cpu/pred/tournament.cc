@@ -70,10 +70,7 @@ TournamentBP::TournamentBP(const Params *params)
     }
 
     //Set up the array of counters for the local predictor
-    localCtrs.resize(localPredictorSize);
-
-    for (int i = 0; i < localPredictorSize; ++i)
-        localCtrs[i].setBits(localCtrBits);
+    localCtrs.init(localPredictorSize, localCtrBits);
 
     localPredictorMask = mask(localHistoryBits);
 
@@ -88,10 +85,7 @@ TournamentBP::TournamentBP(const Params *params)
         localHistoryTable[i] = 0;
 
     //Setup the array of counters for the global predictor
-    globalCtrs.resize(globalPredictorSize);
-
-    for (int i = 0; i < globalPredictorSize; ++i)
-        globalCtrs[i].setBits(globalCtrBits);
+    globalCtrs.init(globalPredictorSize, globalCtrBits);
 
     //Clear the global history
     globalHistory = 0;
@@ -108,10 +102,7 @@ TournamentBP::TournamentBP(const Params *params)
     choiceHistoryMask = choicePredictorSize - 1;
 
     //Setup the array of counters for the choice predictor
-    choiceCtrs.resize(choicePredictorSize);
-
-    for (int i = 0; i < choicePredictorSize; ++i)
-        choiceCtrs[i].setBits(choiceCtrBits);
+    choiceCtrs.init(choicePredictorSize, choiceCtrBits);
 
     //Set up historyRegisterMask
     historyRegisterMask = mask(globalHistoryBits);
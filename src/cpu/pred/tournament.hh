@@ -175,7 +175,7 @@ class TournamentBP : public BPredUnit
     /** Flag for invalid predictor index */
     static const int invalidPredictorIndex = -1;
     /** Local counters. */
-    std::vector<SatCounter> localCtrs;
+    SatCounterTable localCtrs;
 
     /** Number of counters in the local predictor. */
     unsigned localPredictorSize;
@@ -196,7 +196,7 @@ class TournamentBP : public BPredUnit
     unsigned localHistoryBits;
 
     /** Array of counters that make up the global predictor. */
-    std::vector<SatCounter> globalCtrs;
+    SatCounterTable globalCtrs;
 
     /** Number of entries in the global predictor. */
     unsigned globalPredictorSize;
@@ -226,7 +226,7 @@ class TournamentBP : public BPredUnit
     unsigned historyRegisterMask;
 
     /** Array of counters that make up the choice predictor. */
-    std::vector<SatCounter> choiceCtrs;
+    SatCounterTable choiceCtrs;
 
     /** Number of entries in the choice predictor. */
     unsigned choicePredictorSize;
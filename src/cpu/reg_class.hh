@@ -35,6 +35,7 @@
 #include <cstddef>
 
 #include "arch/registers.hh"
+#include "base/random.hh"
 #include "config/the_isa.hh"
 
 /// Enumerate the classes of registers.
@@ -69,8 +70,7 @@ RegClass regIdxToClass(TheISA::RegIndex reg_idx,
 //moslem SWIFT FIX for dijkstra
 while (reg_idx > TheISA::Max_Reg_Index ) 
 {
-	srand (time(0));
-	reg_idx = rand()%(32);
+	reg_idx = random_mt.random<TheISA::RegIndex>(0, 31);
 }
 ////
     assert(reg_idx < TheISA::Max_Reg_Index);
@@ -62,8 +62,20 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    max_cycles_per_tick = Param.Unsigned(1, "Maximum number of cycles "
+        "executed by one tick event.  Cycles after the first only run if "
+        "no other event is scheduled before they start")
+    cache_fetch_translation = Param.Bool(False, "Reuse the last "
+        "instruction fetch translation while fetching from the same page")
+    host_tlb_entries = Param.Unsigned(0, "Entries (a power of 2) in the "
+        "cache of guest pages mapped straight to host memory for plain "
+        "loads and stores, 0 to disable.  The host memory comes from the "
+        "backing store with fastmem, and from memory backdoors otherwise, "
+        "which need the caches to be bypassed or absent.  Accesses it "
+        "serves bypass the DTB and the memory's own stats")
 
-    def addSimPointProbe(self, interval):
+    def addSimPointProbe(self, interval, binary=False):
         simpoint = SimPoint()
         simpoint.interval = interval
+        simpoint.binary = binary
         self.probeListener = simpoint
@@ -48,4 +48,6 @@ class BaseSimpleCPU(BaseCPU):
             print "ERROR: Checker only supported under ARM ISA!"
             exit(1)
 
+    # The predictor may be shared with a detailed CPU this CPU
+    # fast-forwards for, in which case committed branches train it
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
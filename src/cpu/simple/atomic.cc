@@ -108,13 +108,33 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
     : BaseSimpleCPU(p), tickEvent(this), width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      maxCyclesPerTick(p->max_cycles_per_tick),
       drain_manager(NULL),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem), dcache_access(false), dcache_latency(0),
+      fastmem(p->fastmem),
+      cacheFetchTranslation(p->cache_fetch_translation),
+      hostTLBRead(p->host_tlb_entries), hostTLBWrite(p->host_tlb_entries),
+      hostTLBEpoch(1), backdoorRefused(false),
+      dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
     _status = Idle;
+
+    if ((cacheFetchTranslation || p->host_tlb_entries) &&
+        THE_ISA != ARM_ISA) {
+        fatal("%s: cache_fetch_translation and host_tlb_entries need a TLB "
+              "which tracks its generation, only the ARM TLB does\n",
+              name());
+    }
+
+    if (!maxCyclesPerTick)
+        fatal("%s: max_cycles_per_tick must be at least 1\n", name());
+
+    if (p->host_tlb_entries) {
+        if (!isPowerOf2(p->host_tlb_entries))
+            fatal("%s: host_tlb_entries must be a power of 2\n", name());
+    }
 }
 
 
@@ -156,6 +176,11 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // We may have been unserialized, or the memory mode may have
+    // changed under the backdoors
+    dropCachedTranslations();
+    dropBackdoors();
+
     assert(!threadContexts.empty());
     if (threadContexts.size() > 1)
         fatal("The atomic CPU only supports one thread.\n");
@@ -212,6 +237,9 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
     ifetch_req.setThreadContext(_cpuId, 0); // Add thread ID if we add MT
     data_read_req.setThreadContext(_cpuId, 0); // Add thread ID here too
     data_write_req.setThreadContext(_cpuId, 0); // Add thread ID here too
+
+    dropCachedTranslations();
+    dropBackdoors();
 }
 
 void
@@ -334,11 +362,29 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
 
     req->taskId(taskId());
     while (1) {
+        uint8_t *host = hostTLBLookup(hostTLBRead, addr, size, flags);
+
+        if (host) {
+            memcpy(data, host, size);
+            dcache_access = true;
+
+            if (secondAddr <= addr)
+                return NoFault;
+
+            data += size;
+            size = addr + fullSize - secondAddr;
+            addr = secondAddr;
+            continue;
+        }
+
         req->setVirt(0, addr, size, flags, dataMasterId(), thread->pcState().instAddr());
 
         // translate to physical address
         Fault fault = thread->dtb->translateAtomic(req, tc, BaseTLB::Read);
 
+        if (fault == NoFault)
+            hostTLBFill(hostTLBRead, addr, flags, req);
+
         // Now do the access.
         if (fault == NoFault && !req->getFlags().isSet(Request::NO_ACCESS)) {
             Packet pkt(req, MemCmd::ReadReq);
@@ -429,11 +475,30 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
 
     req->taskId(taskId());
     while(1) {
+        uint8_t *host = res ? NULL :
+            hostTLBLookup(hostTLBWrite, addr, size, flags);
+
+        if (host) {
+            memcpy(host, data, size);
+            dcache_access = true;
+
+            if (secondAddr <= addr)
+                return NoFault;
+
+            data += size;
+            size = addr + fullSize - secondAddr;
+            addr = secondAddr;
+            continue;
+        }
+
         req->setVirt(0, addr, size, flags, dataMasterId(), thread->pcState().instAddr());
 
         // translate to physical address
         Fault fault = thread->dtb->translateAtomic(req, tc, BaseTLB::Write);
 
+        if (fault == NoFault && !res)
+            hostTLBFill(hostTLBWrite, addr, flags, req);
+
         // Now do the access.
         if (fault == NoFault) {
             MemCmd cmd = MemCmd::WriteReq; // default
@@ -506,12 +571,201 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
 }
 
 
+void
+AtomicSimpleCPU::dropCachedTranslations()
+{
+    lastFetchTranslation.valid = false;
+    hostTLBEpoch++;
+}
+
+void
+AtomicSimpleCPU::dropBackdoors()
+{
+    backdoors.clear();
+    backdoorRefused = false;
+    hostTLBEpoch++;
+}
+
+uint8_t *
+AtomicSimpleCPU::hostPage(Addr ppage, Tick &latency)
+{
+    Addr last = ppage + TheISA::PageBytes - 1;
+
+    if (fastmem) {
+        for (const auto &store : system->getPhysMem().getBackingStore()) {
+            const AddrRange &range = store.first;
+
+            if (!range.interleaved() && range.contains(ppage) &&
+                range.contains(last)) {
+                latency = 0;
+                return store.second + (ppage - range.start());
+            }
+        }
+        return NULL;
+    }
+
+    for (const auto &backdoor : backdoors) {
+        if (backdoor.range.contains(ppage)) {
+            if (!backdoor.range.contains(last))
+                return NULL;
+            latency = backdoor.latency;
+            return backdoor.hostAddr(ppage);
+        }
+    }
+
+    if (backdoorRefused || !system->isMemAddr(ppage))
+        return NULL;
+
+    MemBackdoor backdoor;
+    if (!dcachePort.sendBackdoorReq(ppage, backdoor)) {
+        DPRINTF(SimpleCPU, "No backdoor for %#x\n", ppage);
+        backdoorRefused = true;
+        return NULL;
+    }
+
+    DPRINTF(SimpleCPU, "Backdoor to %s\n", backdoor.range.to_string());
+    backdoors.push_back(backdoor);
+    if (!backdoor.range.contains(last))
+        return NULL;
+    latency = backdoor.latency;
+    return backdoor.hostAddr(ppage);
+}
+
+uint8_t *
+AtomicSimpleCPU::hostTLBLookup(std::vector<HostTLBEntry> &tlb, Addr addr,
+    unsigned size, unsigned flags)
+{
+    if (tlb.empty())
+        return NULL;
+
+    Addr vpage = addr & ~(Addr(TheISA::PageBytes) - 1);
+    HostTLBEntry &entry = tlb[(vpage / TheISA::PageBytes) & (tlb.size() - 1)];
+
+    if (entry.epoch != hostTLBEpoch || entry.vpage != vpage ||
+        entry.flags != flags ||
+        entry.generation != thread->dtb->generation()) {
+        return NULL;
+    }
+
+#if THE_ISA == ARM_ISA
+    // Leave accesses the DTB might raise an alignment fault for to it
+    if (addr & mask(flags & TheISA::TLB::AlignmentMask))
+        return NULL;
+#endif
+
+    // charge what the backdoor asks for
+    dcache_latency += entry.latency;
+    return entry.host + (addr - vpage);
+}
+
+void
+AtomicSimpleCPU::hostTLBFill(std::vector<HostTLBEntry> &tlb, Addr addr,
+    unsigned flags, Request *req)
+{
+    if (tlb.empty())
+        return;
+
+    if (req->isUncacheable() || req->isMmappedIpr() || req->isLLSC() ||
+        req->isLocked() || req->isSwap() || req->isPrefetch() ||
+        req->isClearLL() ||
+        req->getFlags().isSet(Request::NO_ACCESS |
+                              Request::CACHE_BLOCK_ZERO)) {
+        return;
+    }
+
+    // Stores straight to the backing store don't clear other contexts'
+    // LL/SC reservations
+    if (system->numContexts() != 1)
+        return;
+
+    Addr vpage = addr & ~(Addr(TheISA::PageBytes) - 1);
+    Addr ppage = req->getPaddr() - (addr - vpage);
+
+    Tick latency;
+    uint8_t *host = hostPage(ppage, latency);
+    if (!host)
+        return;
+
+    HostTLBEntry &entry = tlb[(vpage / TheISA::PageBytes) & (tlb.size() - 1)];
+
+    entry.vpage = vpage;
+    entry.host = host;
+    entry.flags = flags;
+    entry.generation = thread->dtb->generation();
+    entry.epoch = hostTLBEpoch;
+    entry.latency = latency;
+}
+
+Fault
+AtomicSimpleCPU::translateFetch()
+{
+    FetchTranslation &last = lastFetchTranslation;
+    Addr vaddr = ifetch_req.getVaddr();
+    Addr vpage = vaddr & ~(Addr(TheISA::PageBytes) - 1);
+
+    if (last.valid && last.vpage == vpage &&
+        last.generation == thread->itb->generation()) {
+        ifetch_req.setPaddr(last.ppage | (vaddr - vpage));
+        ifetch_req.setFlags(last.flags);
+        return NoFault;
+    }
+
+    Fault fault = thread->itb->translateAtomic(&ifetch_req, tc,
+                                               BaseTLB::Execute);
+
+    last.valid = cacheFetchTranslation && fault == NoFault;
+    if (last.valid) {
+        last.vpage = vpage;
+        last.ppage = ifetch_req.getPaddr() - (vaddr - vpage);
+        last.flags = ifetch_req.getFlags();
+        last.generation = thread->itb->generation();
+    }
+
+    return fault;
+}
+
 void
 AtomicSimpleCPU::tick()
 {
     DPRINTF(SimpleCPU, "Tick\n");
 
-    Tick latency = 0;
+    for (unsigned cycle = 1; ; ++cycle) {
+        Tick latency;
+        if (!tickCycle(latency))
+            return;
+
+        if (tryCompleteDrain())
+            return;
+
+        // instruction takes at least one cycle
+        if (latency < clockPeriod())
+            latency = clockPeriod();
+
+        if (_status == Idle)
+            return;
+
+        // Keep executing inside this event if nothing else is due
+        // before the next cycle. Moving the queue's time forward is
+        // then indistinguishable from servicing the rescheduled tick
+        // event, so instruction count and PC events (which are checked
+        // per instruction) and device timing are unaffected.
+        const Tick next_tick = curTick() + latency;
+        EventQueue *eq = eventQueue();
+        if (cycle < maxCyclesPerTick &&
+            (eq->empty() || eq->nextTick() > next_tick)) {
+            eq->setCurTick(next_tick);
+            continue;
+        }
+
+        schedule(tickEvent, next_tick);
+        return;
+    }
+}
+
+bool
+AtomicSimpleCPU::tickCycle(Tick &latency)
+{
+    latency = 0;
 
     for (int i = 0; i < width || locked; ++i) {
         numCycles++;
@@ -525,7 +779,7 @@ AtomicSimpleCPU::tick()
         // We must have just got suspended by a PC event
         if (_status == Idle) {
             tryCompleteDrain();
-            return;
+            return false;
         }
 
         Fault fault = NoFault;
@@ -537,8 +791,7 @@ AtomicSimpleCPU::tick()
         if (needToFetch) {
             ifetch_req.taskId(taskId());
             setupFetchRequest(&ifetch_req);
-            fault = thread->itb->translateAtomic(&ifetch_req, tc,
-                                                 BaseTLB::Execute);
+            fault = translateFetch();
         }
 
         if (fault == NoFault) {
@@ -579,6 +832,10 @@ AtomicSimpleCPU::tick()
                 if (fault == NoFault) {
                     countInst();
                     ppCommit->notify(std::make_pair(thread, curStaticInst));
+                    if (ppCommitPC->hasListeners()) {
+                        ppCommitPC->notify(std::make_pair(
+                            thread->pcState().instAddr(), curStaticInst));
+                    }
                 }
                 else if (traceData && !DTRACE(ExecFaulting)) {
                     delete traceData;
@@ -609,19 +866,21 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        // Anything that may have changed the translation context drops
+        // the cached translations
+        if (fault != NoFault || (curStaticInst &&
+                (curStaticInst->isSerializeAfter() ||
+                 curStaticInst->isNonSpeculative() ||
+                 curStaticInst->isSquashAfter()))) {
+            dropCachedTranslations();
+        }
+
         if(fault != NoFault || !stayAtPC)
             advancePC(fault);
     }
 
-    if (tryCompleteDrain())
-        return;
-
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
-
-    if (_status != Idle)
-        schedule(tickEvent, curTick() + latency);
+    return true;
 }
 
 void
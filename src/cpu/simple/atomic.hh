@@ -47,7 +47,7 @@
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
 
-class AtomicSimpleCPU : public BaseSimpleCPU
+class AtomicSimpleCPU final : public BaseSimpleCPU
 {
   public:
 
@@ -73,6 +73,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool locked;
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
+    /** Cycles executed per tick event while no other event is due */
+    const unsigned maxCyclesPerTick;
 
     /**
      * Drain manager to use when signaling drain completion
@@ -81,9 +83,17 @@ class AtomicSimpleCPU : public BaseSimpleCPU
      */
     DrainManager *drain_manager;
 
-    // main simulation loop (one cycle)
+    // main simulation loop (one or more cycles)
     void tick();
 
+    /**
+     * Execute one cycle (up to width instructions).
+     *
+     * @param latency Set to the stall latency of the cycle
+     * @return false if the CPU was suspended during the cycle
+     */
+    bool tickCycle(Tick &latency);
+
     /**
      * Check if a system is in a drained state.
      *
@@ -165,6 +175,10 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
         virtual Tick recvAtomicSnoop(PacketPtr pkt);
         virtual void recvFunctionalSnoop(PacketPtr pkt);
+
+        /** Backdoors may no longer point where they did */
+        void recvRangeChange()
+        { static_cast<AtomicSimpleCPU *>(cpu)->dropBackdoors(); }
     };
 
 
@@ -172,6 +186,96 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+
+    /**
+     * The last instruction fetch translation, reused while fetching from
+     * the same page so that straight line code takes one ITB translation
+     * per page rather than per instruction.  It holds while the ITB's
+     * generation is unchanged and is dropped after any fault (which
+     * covers SE mode page table changes made by syscalls) and after any
+     * instruction that may change the translation context.
+     */
+    struct FetchTranslation
+    {
+        bool valid;
+        Addr vpage;
+        Addr ppage;
+        /** Request flags added by the translation */
+        Request::Flags flags;
+        uint64_t generation;
+
+        FetchTranslation() : valid(false), vpage(0), ppage(0),
+            flags(0), generation(0)
+        { }
+    };
+
+    const bool cacheFetchTranslation;
+    FetchTranslation lastFetchTranslation;
+
+    /** Translate ifetch_req, from lastFetchTranslation if it covers it */
+    Fault translateFetch();
+
+    /**
+     * A guest virtual page mapped straight to its host backing store.
+     * Plain loads and stores to pages in this cache are done with a
+     * memcpy, bypassing the DTB and the packet path.  The host memory
+     * is found in the system's backing store with fastmem, and through
+     * a backdoor from the memory behind the dcache port otherwise.  Entries
+     * are filled after a successful translation of an ordinary cacheable
+     * access to simulated memory, hit only for accesses with the same
+     * request flags, and are valid for one DTB generation and one
+     * hostTLBEpoch.
+     */
+    struct HostTLBEntry
+    {
+        Addr vpage;
+        uint8_t *host;
+        unsigned flags;
+        uint64_t generation;
+        uint64_t epoch;
+        /** Latency charged per access, from the backdoor */
+        Tick latency;
+
+        HostTLBEntry() : vpage(0), host(NULL), flags(0), generation(0),
+            epoch(0), latency(0)
+        { }
+    };
+
+    /** Direct mapped host TLBs for reads and writes, empty if disabled */
+    std::vector<HostTLBEntry> hostTLBRead;
+    std::vector<HostTLBEntry> hostTLBWrite;
+
+    /** Bumped to drop every host TLB entry, whenever the fetch
+     *  translation is dropped */
+    uint64_t hostTLBEpoch;
+
+    /** Drop the fetch translation and all host TLB entries */
+    void dropCachedTranslations();
+
+    /** Backdoors handed out through the dcache port */
+    std::vector<MemBackdoor> backdoors;
+
+    /** Set once the dcache port refused a backdoor, so it isn't asked
+     *  again until the backdoors are dropped */
+    bool backdoorRefused;
+
+    /** Drop all backdoors, and the host TLB entries using them */
+    void dropBackdoors();
+
+    /** Host address of the physical page ppage, and the latency to
+     *  charge for accessing it, or NULL if there is none */
+    uint8_t *hostPage(Addr ppage, Tick &latency);
+
+    /** Host address of an access of size bytes at addr, or NULL if the
+     *  host TLB doesn't cover it */
+    uint8_t *hostTLBLookup(std::vector<HostTLBEntry> &tlb, Addr addr,
+        unsigned size, unsigned flags);
+
+    /** Enter the page of the translated access req into tlb, if it's an
+     *  access the host TLB can serve */
+    void hostTLBFill(std::vector<HostTLBEntry> &tlb, Addr addr,
+        unsigned flags, Request *req);
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
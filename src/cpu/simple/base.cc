@@ -80,7 +80,9 @@
 #include "sim/sim_events.hh"
 #include "sim/sim_object.hh"
 #include "sim/stats.hh"
+#include "sim/stats_region.hh"
 #include "sim/system.hh"
+#include "sim/trace_window.hh"
 
 using namespace std;
 using namespace TheISA;
@@ -538,6 +540,8 @@ BaseSimpleCPU::postExecute()
 
     // Call CPU instruction commit probes
     probeInstCommit(curStaticInst);
+    Trace::windowCommit(instAddr);
+    statsRegionCommit(instAddr);
 }
 
 void
@@ -46,3 +46,5 @@ class SimPoint(ProbeListenerObject):
 
     interval = Param.UInt64(100000000, "Interval Size (insts)")
     profile_file = Param.String("simpoint.bb.gz", "BBV (output) file")
+    binary = Param.Bool(False, "Write BBVs in the binary format, see "
+                        "util/simpoint_bbv.py for a reader")
@@ -38,8 +38,13 @@
  *          Curtis Dunham
  */
 
+#include <algorithm>
+
 #include "base/output.hh"
 #include "cpu/simple/probes/simpoint.hh"
+#include "sim/byteswap.hh"
+
+const char SimPoint::binaryMagic[8] = { 'g', 'e', 'm', '5', 'B', 'B', 'V', 1 };
 
 SimPoint::SimPoint(const SimPointParams *p)
     : ProbeListenerObject(p),
@@ -47,12 +52,16 @@ SimPoint::SimPoint(const SimPointParams *p)
       intervalCount(0),
       intervalDrift(0),
       simpointStream(NULL),
+      binary(p->binary),
       currentBBV(0, 0),
       currentBBVInstCount(0)
 {
-    simpointStream = simout.create(p->profile_file, false);
+    simpointStream = simout.create(p->profile_file, binary);
     if (!simpointStream)
         fatal("unable to open SimPoint profile_file");
+
+    if (binary)
+        simpointStream->write(binaryMagic, sizeof(binaryMagic));
 }
 
 SimPoint::~SimPoint()
@@ -67,72 +76,71 @@ SimPoint::init()
 void
 SimPoint::regProbeListeners()
 {
-    typedef ProbeListenerArg<SimPoint, std::pair<SimpleThread*,StaticInstPtr>>
+    typedef ProbeListenerArg<SimPoint, BaseCPU::CommitPCArg>
         SimPointListener;
-    listeners.push_back(new SimPointListener(this, "Commit",
+    listeners.push_back(new SimPointListener(this, "CommitPC",
                                              &SimPoint::profile));
 }
 
+uint32_t
+SimPoint::lookupBB(const BasicBlockRange &bb)
+{
+    BBCacheEntry &entry = bbCache[(bb.second >> 1) % bbCacheSize];
+    if (entry.valid && entry.range == bb)
+        return entry.index;
+
+    uint32_t index;
+    auto map_itr = bbMap.find(bb);
+    if (map_itr == bbMap.end()) {
+        // If a new (previously unseen) basic block is found, give it
+        // the next unique id.
+        index = bbInfo.size();
+        bbInfo.push_back(BBInfo());
+        bbInfo.back().insts = currentBBVInstCount;
+        bbInfo.back().count = 0;
+        bbMap.insert(std::make_pair(bb, index));
+    } else {
+        index = map_itr->second;
+    }
+
+    entry.range = bb;
+    entry.index = index;
+    entry.valid = true;
+    return index;
+}
+
 void
-SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
+SimPoint::profile(const BaseCPU::CommitPCArg &p)
 {
-    SimpleThread* thread = p.first;
+    const Addr pc = p.first;
     const StaticInstPtr &inst = p.second;
 
     if (inst->isMicroop() && !inst->isLastMicroop())
         return;
 
     if (!currentBBVInstCount)
-        currentBBV.first = thread->pcState().instAddr();
+        currentBBV.first = pc;
 
     ++intervalCount;
     ++currentBBVInstCount;
 
     // If inst is control inst, assume end of basic block.
     if (inst->isControl()) {
-        currentBBV.second = thread->pcState().instAddr();
-
-        auto map_itr = bbMap.find(currentBBV);
-        if (map_itr == bbMap.end()){
-            // If a new (previously unseen) basic block is found,
-            // add a new unique id, record num of insts and insert into bbMap.
-            BBInfo info;
-            info.id = bbMap.size() + 1;
-            info.insts = currentBBVInstCount;
-            info.count = currentBBVInstCount;
-            bbMap.insert(std::make_pair(currentBBV, info));
-        } else {
-            // If basic block is seen before, just increment the count by the
-            // number of insts in basic block.
-            BBInfo& info = map_itr->second;
-            info.count += currentBBVInstCount;
-        }
+        currentBBV.second = pc;
+
+        // Increment the count by the number of insts in basic block,
+        // remembering which blocks have been executed in this interval.
+        BBInfo &info = bbInfo[lookupBB(currentBBV)];
+        if (!info.count)
+            intervalBBs.push_back(&info - &bbInfo[0]);
+        info.count += currentBBVInstCount;
         currentBBVInstCount = 0;
 
         // Reached end of interval if the sum of the current inst count
         // (intervalCount) and the excessive inst count from the previous
         // interval (intervalDrift) is greater than/equal to the interval size.
         if (intervalCount + intervalDrift >= intervalSize) {
-            // summarize interval and display BBV info
-            std::vector<std::pair<uint64_t, uint64_t> > counts;
-            for (auto map_itr = bbMap.begin(); map_itr != bbMap.end();
-                    ++map_itr) {
-                BBInfo& info = map_itr->second;
-                if (info.count != 0) {
-                    counts.push_back(std::make_pair(info.id, info.count));
-                    info.count = 0;
-                }
-            }
-            std::sort(counts.begin(), counts.end());
-
-            // Print output BBV info
-            *simpointStream << "T";
-            for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
-                    ++cnt_itr) {
-                *simpointStream << ":" << cnt_itr->first
-                                << ":" << cnt_itr->second << " ";
-            }
-            *simpointStream << "\n";
+            dumpInterval();
 
             intervalDrift = (intervalCount + intervalDrift) - intervalSize;
             intervalCount = 0;
@@ -140,6 +148,39 @@ SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
     }
 }
 
+void
+SimPoint::dumpInterval()
+{
+    // Indices are handed out in ID order, so sorting them sorts the
+    // BBV by basic block ID.
+    std::sort(intervalBBs.begin(), intervalBBs.end());
+
+    if (binary) {
+        // Each interval is the number of blocks executed followed by
+        // (ID, count) pairs, all as little endian 64-bit integers.
+        const uint64_t num = htole((uint64_t)intervalBBs.size());
+        simpointStream->write((const char *)&num, sizeof(num));
+        for (auto idx : intervalBBs) {
+            BBInfo &info = bbInfo[idx];
+            const uint64_t pair[2] = { htole((uint64_t)idx + 1),
+                                       htole(info.count) };
+            simpointStream->write((const char *)pair, sizeof(pair));
+            info.count = 0;
+        }
+    } else {
+        // Print output BBV info
+        *simpointStream << "T";
+        for (auto idx : intervalBBs) {
+            BBInfo &info = bbInfo[idx];
+            *simpointStream << ":" << idx + 1 << ":" << info.count << " ";
+            info.count = 0;
+        }
+        *simpointStream << "\n";
+    }
+
+    intervalBBs.clear();
+}
+
 /** SimPoint SimObject */
 SimPoint*
 SimPointParams::create()
@@ -41,8 +41,10 @@
 #ifndef __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 #define __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 
+#include <vector>
+
 #include "base/hashmap.hh"
-#include "cpu/simple_thread.hh"
+#include "cpu/base.hh"
 #include "params/SimPoint.hh"
 #include "sim/probe/probe.hh"
 
@@ -85,9 +87,21 @@ class SimPoint : public ProbeListenerObject
      * Called at every macro inst to increment basic block inst counts and
      * to profile block if end of block.
      */
-    void profile(const std::pair<SimpleThread*, StaticInstPtr>&);
+    void profile(const BaseCPU::CommitPCArg &);
+
+    /** Magic number at the start of a binary BBV file */
+    static const char binaryMagic[8];
 
   private:
+    /**
+     * Look up the index of a basic block in bbInfo, adding the block
+     * if it hasn't been seen before.
+     */
+    uint32_t lookupBB(const BasicBlockRange &bb);
+
+    /** Write the BBV of the interval that just ended */
+    void dumpInterval();
+
     /** SimPoint profiling interval size in instructions */
     const uint64_t intervalSize;
 
@@ -97,19 +111,44 @@ class SimPoint : public ProbeListenerObject
     uint64_t intervalDrift;
     /** Pointer to SimPoint BBV output stream */
     std::ostream *simpointStream;
+    /** Write BBVs in the binary format rather than as text */
+    const bool binary;
 
     /** Basic Block information */
     struct BBInfo {
-        /** Unique ID */
-        uint64_t id;
         /** Num of static insts in BB */
         uint64_t insts;
         /** Accumulated dynamic inst count executed by BB */
         uint64_t count;
     };
 
-    /** Hash table containing all previously seen basic blocks */
-    m5::hash_map<BasicBlockRange, BBInfo> bbMap;
+    /**
+     * All previously seen basic blocks. A block's unique ID is its
+     * index plus one, so the per interval counts live in a dense
+     * array rather than in the hash table.
+     */
+    std::vector<BBInfo> bbInfo;
+    /** Indices of the blocks executed in the current interval */
+    std::vector<uint32_t> intervalBBs;
+
+    /** Hash table mapping previously seen basic blocks to bbInfo */
+    m5::hash_map<BasicBlockRange, uint32_t> bbMap;
+
+    /**
+     * Direct mapped cache in front of bbMap, indexed by the block's
+     * end PC. Loops hit the same few blocks over and over, so this
+     * saves most of the hash table lookups.
+     */
+    struct BBCacheEntry {
+        BBCacheEntry() : range(0, 0), index(0), valid(false) {}
+
+        BasicBlockRange range;
+        uint32_t index;
+        bool valid;
+    };
+    static const unsigned bbCacheSize = 1024;
+    BBCacheEntry bbCache[bbCacheSize];
+
     /** Currently executing basic block */
     BasicBlockRange currentBBV;
     /** inst count in current basic block */
@@ -31,6 +31,8 @@
  *          Kevin Lim
  */
 
+#include <cstdlib>
+#include <new>
 #include <string>
 
 #include "arch/isa_traits.hh"
@@ -106,6 +108,21 @@ SimpleThread::~SimpleThread()
     delete tc;
 }
 
+void *
+SimpleThread::operator new(size_t size)
+{
+    void *p;
+    if (posix_memalign(&p, alignof(SimpleThread), size) != 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void
+SimpleThread::operator delete(void *p)
+{
+    free(p);
+}
+
 void
 SimpleThread::takeOverFrom(ThreadContext *oldContext)
 {
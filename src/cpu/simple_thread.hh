@@ -105,15 +105,25 @@ class SimpleThread : public ThreadState
   public:
     typedef ThreadContext::Status Status;
 
-  protected:
-    union {
-        FloatReg f[TheISA::NumFloatRegs];
-        FloatRegBits i[TheISA::NumFloatRegs];
-    } floatRegs;
-    TheISA::IntReg intRegs[TheISA::NumIntRegs];
+    /**
+     * The flat architectural registers, in one cache line aligned
+     * block, so that a snapshot or hash of them is a single copy or
+     * pass over memory.
+     */
+    struct alignas(64) ArchRegs
+    {
+        TheISA::IntReg intRegs[TheISA::NumIntRegs];
+        union {
+            FloatReg f[TheISA::NumFloatRegs];
+            FloatRegBits i[TheISA::NumFloatRegs];
+        } floatRegs;
 #ifdef ISA_HAS_CC_REGS
-    TheISA::CCReg ccRegs[TheISA::NumCCRegs];
+        TheISA::CCReg ccRegs[TheISA::NumCCRegs];
 #endif
+    };
+
+  protected:
+    ArchRegs regs;
     TheISA::ISA *const isa;    // one "instance" of the current ISA.
 
     TheISA::PCState _pcState;
@@ -148,6 +158,15 @@ class SimpleThread : public ThreadState
 
     virtual ~SimpleThread();
 
+    /**
+     * Keep the alignment of the register block, which plain new does
+     * not promise for over-aligned types.
+     * @{
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
+    /** @} */
+
     virtual void takeOverFrom(ThreadContext *oldContext);
 
     void regStats(const std::string &name);
@@ -225,14 +244,15 @@ class SimpleThread : public ThreadState
     void clearArchRegs()
     {
         _pcState = 0;
-        memset(intRegs, 0, sizeof(intRegs));
-        memset(floatRegs.i, 0, sizeof(floatRegs.i));
-#ifdef ISA_HAS_CC_REGS
-        memset(ccRegs, 0, sizeof(ccRegs));
-#endif
+        // All of the block, padding included, so hashes of it are
+        // deterministic
+        memset(&regs, 0, sizeof(regs));
         isa->clear();
     }
 
+    /** The flat architectural registers, for snapshots and hashes */
+    const ArchRegs &archRegs() const { return regs; }
+
     //
     // New accessors for new decoder.
     //
@@ -252,7 +272,7 @@ class SimpleThread : public ThreadState
         assert(flatIndex < TheISA::NumFloatRegs);
         FloatReg regVal(readFloatRegFlat(flatIndex));
         DPRINTF(FloatRegs, "Reading float reg %d (%d) as %f, %#x.\n",
-                reg_idx, flatIndex, regVal, floatRegs.i[flatIndex]);
+                reg_idx, flatIndex, regVal, regs.floatRegs.i[flatIndex]);
         return regVal;
     }
 
@@ -262,7 +282,7 @@ class SimpleThread : public ThreadState
         assert(flatIndex < TheISA::NumFloatRegs);
         FloatRegBits regVal(readFloatRegBitsFlat(flatIndex));
         DPRINTF(FloatRegs, "Reading float reg %d (%d) bits as %#x, %f.\n",
-                reg_idx, flatIndex, regVal, floatRegs.f[flatIndex]);
+                reg_idx, flatIndex, regVal, regs.floatRegs.f[flatIndex]);
         return regVal;
     }
 
@@ -297,7 +317,7 @@ class SimpleThread : public ThreadState
         assert(flatIndex < TheISA::NumFloatRegs);
         setFloatRegFlat(flatIndex, val);
         DPRINTF(FloatRegs, "Setting float reg %d (%d) to %f, %#x.\n",
-                reg_idx, flatIndex, val, floatRegs.i[flatIndex]);
+                reg_idx, flatIndex, val, regs.floatRegs.i[flatIndex]);
     }
 
     void setFloatRegBits(int reg_idx, FloatRegBits val)
@@ -309,7 +329,7 @@ class SimpleThread : public ThreadState
         if (flatIndex < TheISA::NumFloatRegs)
             setFloatRegBitsFlat(flatIndex, val);
         DPRINTF(FloatRegs, "Setting float reg %d (%d) bits to %#x, %#f.\n",
-                reg_idx, flatIndex, val, floatRegs.f[flatIndex]);
+                reg_idx, flatIndex, val, regs.floatRegs.f[flatIndex]);
     }
 
     void setCCReg(int reg_idx, CCReg val)
@@ -429,20 +449,22 @@ class SimpleThread : public ThreadState
         process->syscall(callnum, tc);
     }
 
-    uint64_t readIntRegFlat(int idx) { return intRegs[idx]; }
-    void setIntRegFlat(int idx, uint64_t val) { intRegs[idx] = val; }
+    uint64_t readIntRegFlat(int idx) { return regs.intRegs[idx]; }
+    void setIntRegFlat(int idx, uint64_t val) { regs.intRegs[idx] = val; }
 
-    FloatReg readFloatRegFlat(int idx) { return floatRegs.f[idx]; }
-    void setFloatRegFlat(int idx, FloatReg val) { floatRegs.f[idx] = val; }
+    FloatReg readFloatRegFlat(int idx) { return regs.floatRegs.f[idx]; }
+    void setFloatRegFlat(int idx, FloatReg val)
+    { regs.floatRegs.f[idx] = val; }
 
-    FloatRegBits readFloatRegBitsFlat(int idx) { return floatRegs.i[idx]; }
+    FloatRegBits readFloatRegBitsFlat(int idx)
+    { return regs.floatRegs.i[idx]; }
     void setFloatRegBitsFlat(int idx, FloatRegBits val) {
-        floatRegs.i[idx] = val;
+        regs.floatRegs.i[idx] = val;
     }
 
 #ifdef ISA_HAS_CC_REGS
-    CCReg readCCRegFlat(int idx) { return ccRegs[idx]; }
-    void setCCRegFlat(int idx, CCReg val) { ccRegs[idx] = val; }
+    CCReg readCCRegFlat(int idx) { return regs.ccRegs[idx]; }
+    void setCCRegFlat(int idx, CCReg val) { regs.ccRegs[idx] = val; }
 #else
     CCReg readCCRegFlat(int idx)
     { panic("readCCRegFlat w/no CC regs!\n"); }
@@ -29,11 +29,18 @@
  *          Nathan Binkert
  */
 
+#include <cstring>
 #include <iostream>
+#include <sstream>
 
 #include "cpu/static_inst.hh"
 #include "sim/core.hh"
 
+#if DEVIRT_EXEC
+#include "cpu/minor/exec_context.hh"
+#include "cpu/simple/atomic.hh"
+#endif
+
 StaticInstPtr StaticInst::nullStaticInstPtr;
 
 using namespace std;
@@ -42,7 +49,37 @@ StaticInst::~StaticInst()
 {
     if (cachedDisassembly)
         delete cachedDisassembly;
+    delete cachedPCDisassembly;
+}
+
+#if DEVIRT_EXEC
+Fault
+StaticInst::execute(Minor::ExecContext *xc,
+                    Trace::InstRecord *traceData) const
+{
+    return execute(static_cast<ExecContext *>(xc), traceData);
+}
+
+Fault
+StaticInst::initiateAcc(Minor::ExecContext *xc,
+                        Trace::InstRecord *traceData) const
+{
+    return initiateAcc(static_cast<ExecContext *>(xc), traceData);
+}
+
+Fault
+StaticInst::completeAcc(Packet *pkt, Minor::ExecContext *xc,
+                        Trace::InstRecord *traceData) const
+{
+    return completeAcc(pkt, static_cast<ExecContext *>(xc), traceData);
+}
+
+Fault
+StaticInst::execute(AtomicSimpleCPU *xc, Trace::InstRecord *traceData) const
+{
+    return execute(static_cast<ExecContext *>(xc), traceData);
 }
+#endif
 
 bool
 StaticInst::hasBranchTarget(const TheISA::PCState &pc, ThreadContext *tc,
@@ -90,7 +127,45 @@ StaticInst::disassemble(Addr pc, const SymbolTable *symtab) const
     if (!cachedDisassembly)
         cachedDisassembly = new string(generateDisassembly(pc, symtab));
 
-    return *cachedDisassembly;
+    if (!pcRelativeDisassembly)
+        return *cachedDisassembly;
+
+    if (!cachedPCDisassembly) {
+        cachedPCDisassembly = new PCDisassembly;
+    } else if (cachedPCDisassembly->pc == pc &&
+               cachedPCDisassembly->symtab == symtab) {
+        return cachedPCDisassembly->text;
+    }
+
+    ostringstream os;
+    os << *cachedDisassembly;
+    printPCRelative(os, pc, symtab);
+
+    cachedPCDisassembly->pc = pc;
+    cachedPCDisassembly->symtab = symtab;
+    cachedPCDisassembly->text = os.str();
+
+    return cachedPCDisassembly->text;
+}
+
+void
+StaticInst::summariseRegs() const
+{
+    _srcRegMask = 0;
+    for (int i = 0; i < _numSrcRegs; i++) {
+        if (_srcRegIdx[i] < 64)
+            _srcRegMask |= ULL(1) << _srcRegIdx[i];
+    }
+
+    _destRegMask = 0;
+    for (int i = 0; i < _numDestRegs; i++) {
+        if (_destRegIdx[i] < 64)
+            _destRegMask |= ULL(1) << _destRegIdx[i];
+    }
+
+    regSummary = RegSummaryValid;
+    if (strcmp(mnemonic, "sub") == 0)
+        regSummary |= RegSummaryIsSub;
 }
 
 void
@@ -40,6 +40,7 @@
 #include "base/misc.hh"
 #include "base/refcnt.hh"
 #include "base/types.hh"
+#include "config/devirt_exec.hh"
 #include "config/the_isa.hh"
 #include "cpu/op_class.hh"
 #include "cpu/static_inst_fwd.hh"
@@ -51,6 +52,13 @@ class Packet;
 
 class ExecContext;
 
+#if DEVIRT_EXEC
+namespace Minor {
+    class ExecContext;
+}
+class AtomicSimpleCPU;
+#endif
+
 class SymbolTable;
 
 namespace Trace {
@@ -101,8 +109,6 @@ class StaticInst : public RefCounted, public StaticInstFlags
     //@}
 
   public:
-//moslem 
-Tick debugEnd;
     /// @name Register information.
     /// The sum of numFPDestRegs() and numIntDestRegs() equals
     /// numDestRegs().  The former two functions are used to track
@@ -180,6 +186,39 @@ Tick debugEnd;
     /// Operation class.  Used to select appropriate function unit in issue.
     OpClass opClass()     const { return _opClass; }
 
+    /// @name Register operand summary.
+    /// Used to classify the redundant instructions added by SWIFT-R and
+    /// ZDC without examining each operand of each committed instruction.
+    /// Computed on first use as the operands are set up by the derived
+    /// classes' constructors.
+    //@{
+    /// Bit n is set if register index n (for n < 64) is a source.
+    uint64_t
+    srcRegMask() const
+    {
+        if (!(regSummary & RegSummaryValid))
+            summariseRegs();
+        return _srcRegMask;
+    }
+    /// Bit n is set if register index n (for n < 64) is a destination.
+    uint64_t
+    destRegMask() const
+    {
+        if (!(regSummary & RegSummaryValid))
+            summariseRegs();
+        return _destRegMask;
+    }
+    /// Is this a plain "sub", the instruction SWIFT-R and ZDC use to
+    /// copy registers?
+    bool
+    isSubInst() const
+    {
+        if (!(regSummary & RegSummaryValid))
+            summariseRegs();
+        return regSummary & RegSummaryIsSub;
+    }
+    //@}
+
 
     /// Return logical index (architectural reg num) of i'th destination reg.
     /// Only the entries from 0 through numDestRegs()-1 are valid.
@@ -232,16 +271,56 @@ Tick debugEnd;
 
     /**
      * String representation of disassembly (lazily evaluated via
-     * disassemble()).
+     * disassemble()).  For a pcRelativeDisassembly instruction this is
+     * only the part that is the same at every pc.
      */
     mutable std::string *cachedDisassembly;
 
+    /**
+     * The disassembly shows something that depends on the pc, e.g. a
+     * branch target.  generateDisassembly() then gives the rest of the
+     * string, which is cached as for any other instruction, and
+     * printPCRelative() the pc-relative end of it.
+     */
+    bool pcRelativeDisassembly;
+
+    /** The whole disassembly at the last pc it was asked for */
+    struct PCDisassembly
+    {
+        Addr pc;
+        const SymbolTable *symtab;
+        std::string text;
+    };
+    mutable PCDisassembly *cachedPCDisassembly;
+
+    /// Register operand summary (lazily evaluated via summariseRegs()).
+    //@{
+    enum {
+        RegSummaryValid = 0x1,
+        RegSummaryIsSub = 0x2
+    };
+    mutable uint8_t regSummary;
+    mutable uint64_t _srcRegMask;
+    mutable uint64_t _destRegMask;
+
+    void summariseRegs() const;
+    //@}
+
     /**
      * Internal function to generate disassembly string.
      */
     virtual std::string
     generateDisassembly(Addr pc, const SymbolTable *symtab) const = 0;
 
+    /**
+     * Print the part of the disassembly at pc that depends on it (see
+     * pcRelativeDisassembly).
+     */
+    virtual void
+    printPCRelative(std::ostream &os, Addr pc,
+                    const SymbolTable *symtab) const
+    { }
+
     /// Constructor.
     /// It's important to initialize everything here to a sane
     /// default, since the decoder generally only overrides
@@ -250,7 +329,9 @@ Tick debugEnd;
     StaticInst(const char *_mnemonic, ExtMachInst _machInst, OpClass __opClass)
         : _opClass(__opClass), _numSrcRegs(0), _numDestRegs(0),
           _numFPDestRegs(0), _numIntDestRegs(0), _numCCDestRegs(0),
-          machInst(_machInst), mnemonic(_mnemonic), cachedDisassembly(0)
+          machInst(_machInst), mnemonic(_mnemonic), cachedDisassembly(0),
+          pcRelativeDisassembly(false), cachedPCDisassembly(0),
+          regSummary(0), _srcRegMask(0), _destRegMask(0)
     { }
 
   public:
@@ -276,6 +357,23 @@ Tick debugEnd;
         panic("completeAcc not defined!");
     }
 
+#if DEVIRT_EXEC
+    /**
+     * Versions of the above for the CPUs whose exec context type the ISA
+     * parser specialises instructions on.  Generated instructions
+     * override these with code that calls the concrete context
+     * directly; any other instruction falls back to its generic method.
+     */
+    virtual Fault execute(Minor::ExecContext *xc,
+                          Trace::InstRecord *traceData) const;
+    virtual Fault initiateAcc(Minor::ExecContext *xc,
+                              Trace::InstRecord *traceData) const;
+    virtual Fault completeAcc(Packet *pkt, Minor::ExecContext *xc,
+                              Trace::InstRecord *traceData) const;
+    virtual Fault execute(AtomicSimpleCPU *xc,
+                          Trace::InstRecord *traceData) const;
+#endif
+
     virtual void advancePC(TheISA::PCState &pcState) const = 0;
 
     /**
@@ -311,8 +409,10 @@ Tick debugEnd;
      * Return string representation of disassembled instruction.
      * The default version of this function will call the internal
      * virtual generateDisassembly() function to get the string,
-     * then cache it in #cachedDisassembly.  If the disassembly
-     * should not be cached, this function should be overridden directly.
+     * then cache it in #cachedDisassembly.  The pc-relative part of
+     * a pcRelativeDisassembly instruction is printed again only when
+     * the pc or symbol table changes.  If the disassembly should not
+     * be cached, this function should be overridden directly.
      */
     virtual const std::string &disassemble(Addr pc,
         const SymbolTable *symtab = 0) const;
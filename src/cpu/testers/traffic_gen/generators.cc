@@ -405,7 +405,7 @@ RandomGen::nextPacketTick(bool elastic, Tick delay) const
 }
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : trace(filename, true)
 {
     init();
 }
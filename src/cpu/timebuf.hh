@@ -34,9 +34,57 @@
 
 #include <cassert>
 #include <cstring>
+#include <new>
 #include <vector>
 
+/**
+ * Slot reset policy that destroys the slot entering the buffer on
+ * advance() and default constructs it again over zeroed storage.
+ */
 template <class T>
+struct TimeBufferReconstruct
+{
+    static void
+    reset(T *slot)
+    {
+        slot->~T();
+        std::memset(slot, 0, sizeof(T));
+        new (slot) T;
+    }
+};
+
+/**
+ * Slot reset policy that reuses the slot in place by calling
+ * T::reset(), which must leave the slot as a zeroed, default
+ * constructed T would be. This suits types carrying large arrays only
+ * part of which is used in any one cycle.
+ */
+template <class T>
+struct TimeBufferResetInPlace
+{
+    static void reset(T *slot) { slot->reset(); }
+};
+
+/**
+ * Slot reset policy for trivially copyable types, which only need
+ * their storage zeroed.
+ */
+template <class T>
+struct TimeBufferResetZero
+{
+    static void reset(T *slot) { std::memset(slot, 0, sizeof(T)); }
+};
+
+/**
+ * The reset policy used by a TimeBuffer of T unless the buffer names
+ * one. Types can specialise this to change their default.
+ */
+template <class T>
+struct TimeBufferDefaultReset : public TimeBufferReconstruct<T>
+{
+};
+
+template <class T, class Reset = TimeBufferDefaultReset<T> >
 class TimeBuffer
 {
   protected:
@@ -60,7 +108,7 @@ class TimeBuffer
     {
         friend class TimeBuffer;
       protected:
-        TimeBuffer<T> *buffer;
+        TimeBuffer<T, Reset> *buffer;
         int index;
 
         void set(int idx)
@@ -69,7 +117,7 @@ class TimeBuffer
             index = idx;
         }
 
-        wire(TimeBuffer<T> *buf, int i)
+        wire(TimeBuffer<T, Reset> *buf, int i)
             : buffer(buf), index(i)
         { }
 
@@ -184,9 +232,7 @@ class TimeBuffer
         int ptr = base + future;
         if (ptr >= (int)size)
             ptr -= size;
-        (reinterpret_cast<T *>(index[ptr]))->~T();
-        std::memset(index[ptr], 0, sizeof(T));
-        new (index[ptr]) T;
+        Reset::reset(reinterpret_cast<T *>(index[ptr]));
     }
 
   protected:
@@ -1,4 +1,3 @@
-# Copyright (c) 2009 Advanced Micro Devices, Inc.
 # All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
@@ -23,35 +22,28 @@
 # THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-#
-# Authors: Steve Reinhardt
-#          Brad Beckmann
 
 from m5.params import *
-from AbstractMemory import AbstractMemory
+from m5.proxy import *
+from MemObject import MemObject
+
+# The TraceCPU replays an instruction dependency trace, as captured by
+# the ElasticTrace probe of the O3 CPU, against the memory system its
+# port is connected to. Records start once the records they depend on
+# have completed, so the timing of the trace adapts to the memory
+# system, which makes it possible to sweep memory-system parameters
+# without simulating the CPU in detail.
+class TraceCPU(MemObject):
+    type = 'TraceCPU'
+    cxx_header = "cpu/trace/trace_cpu.hh"
+
+    # Port used for the loads and stores
+    port = MasterPort("Master port")
 
-class RubyMemoryControl(AbstractMemory):
-    type = 'RubyMemoryControl'
-    cxx_class = 'RubyMemoryControl'
-    cxx_header = "mem/ruby/structures/RubyMemoryControl.hh"
+    # System used to determine the mode of the memory system
+    system = Param.System(Parent.any, "System this CPU is part of")
 
-    banks_per_rank = Param.Int(8, "");
-    ranks_per_dimm = Param.Int(2, "");
-    dimms_per_channel = Param.Int(2, "");
-    bank_bit_0 = Param.Int(8, "");
-    rank_bit_0 = Param.Int(11, "");
-    dimm_bit_0 = Param.Int(12, "");
-    bank_queue_size = Param.Int(12, "");
-    bank_busy_time = Param.Int(11, "");
-    rank_rank_delay = Param.Int(1, "");
-    read_write_delay = Param.Int(2, "");
-    basic_bus_busy_time = Param.Int(2, "");
-    mem_ctl_latency = Param.Cycles(12, "");
-    refresh_period = Param.Cycles(1560, "");
-    tFaw = Param.Int(0, "");
-    mem_random_arbitrate = Param.Int(0, "");
-    mem_fixed_delay = Param.Cycles(0, "");
+    trace_file = Param.String("Instruction dependency trace to replay")
 
-    # single-ported on the system interface side, instantiate with a
-    # crossbar in front of the controller for multiple ports
-    port = SlavePort("Slave port")
+    # Should match the ROB size of the CPU the trace was captured on
+    window_size = Param.Unsigned(192, "Records in flight at any time")
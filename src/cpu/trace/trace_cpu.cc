@@ -0,0 +1,382 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/cast.hh"
+#include "cpu/trace/trace_cpu.hh"
+#include "debug/TraceCPU.hh"
+#include "proto/inst_dep_record.pb.h"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+#include "sim/system.hh"
+
+using namespace std;
+
+unsigned TraceCPU::active = 0;
+
+TraceCPU::TraceCPU(const TraceCPUParams* p)
+    : MemObject(p),
+      system(p->system),
+      masterID(system->getMasterId(name())),
+      trace(p->trace_file, true),
+      windowSize(p->window_size),
+      traceDone(false),
+      port(name() + ".port", *this),
+      retryPkt(NULL),
+      outstanding(0),
+      processEvent(this),
+      drainManager(NULL)
+{
+    if (windowSize == 0)
+        fatal("%s: window_size must be at least one record\n", name());
+
+    ProtoMessage::InstDepRecordHeader header_msg;
+    if (!trace.read(header_msg))
+        fatal("%s: failed to read the header of %s\n", name(),
+              p->trace_file);
+
+    if (header_msg.tick_freq() != SimClock::Frequency)
+        fatal("%s: trace was recorded with a different tick frequency %d\n",
+              name(), header_msg.tick_freq());
+
+    if (header_msg.window_size() > windowSize)
+        warn("%s: window of %d records is smaller than the %d the "
+             "trace was recorded with\n", name(), windowSize,
+             header_msg.window_size());
+
+    active++;
+}
+
+TraceCPU*
+TraceCPUParams::create()
+{
+    return new TraceCPU(this);
+}
+
+BaseMasterPort&
+TraceCPU::getMasterPort(const string& if_name, PortID idx)
+{
+    if (if_name == "port") {
+        return port;
+    } else {
+        return MemObject::getMasterPort(if_name, idx);
+    }
+}
+
+void
+TraceCPU::init()
+{
+    if (!port.isConnected())
+        fatal("The port of %s is not connected!\n", name());
+
+    if (!system->isTimingMode())
+        fatal("%s can only replay its trace in timing mode\n", name());
+}
+
+void
+TraceCPU::startup()
+{
+    schedProcess();
+}
+
+void
+TraceCPU::readRecords()
+{
+    ProtoMessage::InstDepRecord rec;
+    while (!traceDone && window.size() < windowSize) {
+        if (!trace.read(rec)) {
+            DPRINTF(TraceCPU, "Reached the end of the trace\n");
+            traceDone = true;
+            break;
+        }
+
+        window.push_back(Node());
+        Node& node = window.back();
+        node.seqNum = rec.seq_num();
+        node.addr = rec.p_addr();
+        node.size = rec.size();
+        node.compDelay = rec.comp_delay();
+        node.entered = curTick();
+        node.start = MaxTick;
+        node.done = MaxTick;
+        node.issued = false;
+
+        // Only keep the flags that matter to the memory system, and
+        // do not touch the device registers and the like
+        node.flags = rec.flags() & (Request::UNCACHEABLE | Request::SECURE);
+        bool no_access = rec.flags() & (Request::NO_ACCESS |
+                                        Request::MMAPPED_IPR |
+                                        Request::GENERIC_IPR);
+
+        if (rec.type() == ProtoMessage::InstDepRecord::COMP ||
+            no_access || node.size == 0)
+            node.type = Node::Comp;
+        else if (rec.type() == ProtoMessage::InstDepRecord::LOAD)
+            node.type = Node::Load;
+        else
+            node.type = Node::Store;
+
+        node.deps.reserve(rec.reg_dep_size() + rec.mem_dep_size());
+        node.deps.insert(node.deps.end(), rec.reg_dep().begin(),
+                         rec.reg_dep().end());
+        node.deps.insert(node.deps.end(), rec.mem_dep().begin(),
+                         rec.mem_dep().end());
+    }
+}
+
+TraceCPU::Node*
+TraceCPU::findNode(InstSeqNum seq_num)
+{
+    auto it = lower_bound(window.begin(), window.end(), seq_num,
+                          [](const Node& node, InstSeqNum seq) {
+                              return node.seqNum < seq; });
+    return it != window.end() && it->seqNum == seq_num ? &*it : NULL;
+}
+
+bool
+TraceCPU::depsDone(const Node& node, Tick& ready)
+{
+    for (auto dep : node.deps) {
+        // Records that left the window, or were never in the trace,
+        // have long completed
+        Node* producer = findNode(dep);
+        if (producer == NULL)
+            continue;
+        if (producer->done == MaxTick)
+            return false;
+        ready = max(ready, producer->done);
+    }
+    return true;
+}
+
+void
+TraceCPU::process()
+{
+    Tick now = curTick();
+    Tick next = MaxTick;
+
+    do {
+        // Retire in order, making room for new records
+        while (!window.empty() && window.front().done <= now) {
+            window.pop_front();
+            numOps++;
+        }
+
+        readRecords();
+
+        for (auto& node : window) {
+            if (node.done != MaxTick || node.issued)
+                continue;
+
+            if (node.start == MaxTick) {
+                Tick ready = node.entered;
+                if (!depsDone(node, ready))
+                    continue;
+                node.start = ready + node.compDelay;
+            }
+
+            if (node.start > now) {
+                next = min(next, node.start);
+            } else if (node.type == Node::Comp) {
+                // Younger records see this one done in the same pass
+                node.done = node.start;
+            } else if (retryPkt == NULL && drainManager == NULL) {
+                issue(node);
+            }
+        }
+    } while (!window.empty() && window.front().done <= now);
+
+    // Wait for the last stores to be acknowledged before finishing
+    if (window.empty() && traceDone) {
+        if (outstanding != 0)
+            return;
+
+        DPRINTF(TraceCPU, "Replay finished\n");
+        finishTick = now;
+        if (--active == 0)
+            exitSimLoop("end of trace reached");
+        return;
+    }
+
+    if (next != MaxTick && drainManager == NULL)
+        schedule(processEvent, next);
+}
+
+void
+TraceCPU::schedProcess()
+{
+    if (!processEvent.scheduled())
+        schedule(processEvent, curTick());
+    else if (processEvent.when() > curTick())
+        reschedule(processEvent, curTick());
+}
+
+void
+TraceCPU::issue(Node& node)
+{
+    bool is_load = node.type == Node::Load;
+    Request* req = new Request(node.addr, node.size, node.flags, masterID);
+    PacketPtr pkt = new Packet(req, is_load ? MemCmd::ReadReq :
+                               MemCmd::WriteReq);
+
+    uint8_t* pkt_data = new uint8_t[node.size];
+    pkt->dataDynamic(pkt_data);
+    if (!is_load)
+        memset(pkt_data, 0, node.size);
+
+    pkt->pushSenderState(new TraceSenderState(node.seqNum));
+    node.issued = true;
+
+    DPRINTF(TraceCPU, "Issuing %s of record %d to %#x\n",
+            is_load ? "load" : "store", node.seqNum, node.addr);
+
+    if (port.sendTimingReq(pkt)) {
+        sent(pkt);
+    } else {
+        DPRINTF(TraceCPU, "Waiting for a retry\n");
+        retryPkt = pkt;
+    }
+}
+
+void
+TraceCPU::sent(PacketPtr pkt)
+{
+    outstanding++;
+
+    if (pkt->isRead()) {
+        numLoads++;
+        return;
+    }
+
+    // Stores are done as soon as they leave, like with a store buffer
+    numStores++;
+    Node* node = findNode(
+        safe_cast<TraceSenderState*>(pkt->senderState)->seqNum);
+    assert(node != NULL);
+    node->done = curTick();
+}
+
+void
+TraceCPU::recvRetry()
+{
+    assert(retryPkt != NULL);
+
+    numRetries++;
+    PacketPtr pkt = retryPkt;
+    if (port.sendTimingReq(pkt)) {
+        retryPkt = NULL;
+        sent(pkt);
+        if (drainManager == NULL)
+            schedProcess();
+        else
+            checkDrained();
+    }
+}
+
+void
+TraceCPU::recvResponse(PacketPtr pkt)
+{
+    TraceSenderState* state =
+        safe_cast<TraceSenderState*>(pkt->popSenderState());
+
+    if (pkt->isRead()) {
+        Node* node = findNode(state->seqNum);
+        assert(node != NULL);
+        node->done = curTick();
+        DPRINTF(TraceCPU, "Load of record %d completed\n", state->seqNum);
+    }
+
+    assert(outstanding > 0);
+    outstanding--;
+
+    delete state;
+    delete pkt->req;
+    delete pkt;
+
+    if (drainManager == NULL)
+        schedProcess();
+    else
+        checkDrained();
+}
+
+void
+TraceCPU::checkDrained()
+{
+    if (outstanding == 0 && retryPkt == NULL) {
+        drainManager->signalDrainDone();
+        drainManager = NULL;
+    }
+}
+
+unsigned int
+TraceCPU::drain(DrainManager *dm)
+{
+    // Hold on to the records in flight, and stop until resumed
+    if (processEvent.scheduled())
+        deschedule(processEvent);
+
+    if (outstanding == 0 && retryPkt == NULL)
+        return 0;
+
+    drainManager = dm;
+    return 1;
+}
+
+void
+TraceCPU::drainResume()
+{
+    if (!(window.empty() && traceDone))
+        schedProcess();
+}
+
+void
+TraceCPU::regStats()
+{
+    using namespace Stats;
+
+    numOps
+        .name(name() + ".numOps")
+        .desc("Number of records replayed");
+
+    numLoads
+        .name(name() + ".numLoads")
+        .desc("Number of loads sent");
+
+    numStores
+        .name(name() + ".numStores")
+        .desc("Number of stores sent");
+
+    numRetries
+        .name(name() + ".numRetries")
+        .desc("Number of retries");
+
+    finishTick
+        .name(name() + ".finishTick")
+        .desc("Tick at which the end of the trace was reached");
+}
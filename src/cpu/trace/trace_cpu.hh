@@ -0,0 +1,268 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a CPU that replays an instruction dependency trace
+ * captured by the ElasticTrace probe of the O3 CPU.
+ */
+
+#ifndef __CPU_TRACE_TRACE_CPU_HH__
+#define __CPU_TRACE_TRACE_CPU_HH__
+
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "cpu/inst_seq.hh"
+#include "mem/mem_object.hh"
+#include "mem/packet.hh"
+#include "params/TraceCPU.hh"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+
+class System;
+
+/**
+ * The TraceCPU replays the loads and stores of an instruction
+ * dependency trace against the memory system it is connected to. It
+ * keeps a window of records in flight, much like the ROB of the CPU
+ * the trace was captured on. A record starts once all the records it
+ * depends on have completed and its compute delay has passed. Loads
+ * complete when their response comes back, and stores, as if written
+ * to a store buffer, once they are sent. Records leave the window in
+ * order, making room for the next ones. As only the timing of the
+ * memory accesses depends on the memory system, this is enough to
+ * explore the memory hierarchy without the cost of a detailed CPU.
+ */
+class TraceCPU : public MemObject
+{
+
+  private:
+
+    /** A record in the window. */
+    struct Node
+    {
+        enum Type {
+            Comp,
+            Load,
+            Store
+        };
+
+        InstSeqNum seqNum;
+        Type type;
+        Addr addr;
+        unsigned size;
+        Request::FlagsType flags;
+
+        /** Older records this one depends on */
+        std::vector<InstSeqNum> deps;
+
+        /** Time between the dependencies completing and the start */
+        Tick compDelay;
+
+        /** When the record entered the window */
+        Tick entered;
+
+        /** When the record starts, MaxTick until its deps complete */
+        Tick start;
+
+        /** When the record completed, MaxTick until it has */
+        Tick done;
+
+        /** A load or store is with the memory system */
+        bool issued;
+    };
+
+    /** Tags a load with the record it belongs to. */
+    struct TraceSenderState : public Packet::SenderState
+    {
+        InstSeqNum seqNum;
+
+        TraceSenderState(InstSeqNum seq_num) : seqNum(seq_num) { }
+    };
+
+    /**
+     * Top up the window from the trace.
+     */
+    void readRecords();
+
+    /**
+     * Find a record in the window.
+     *
+     * @param seq_num Sequence number of the record
+     * @return The record, or NULL if it is not in the window
+     */
+    Node* findNode(InstSeqNum seq_num);
+
+    /**
+     * Check if the dependencies of a record have all completed.
+     *
+     * @param node Record to check
+     * @param ready Updated with the completion of the latest one
+     * @return True if they have all completed
+     */
+    bool depsDone(const Node& node, Tick& ready);
+
+    /**
+     * Start the records that are ready, retire the completed ones,
+     * and schedule the next time anything is due.
+     */
+    void process();
+
+    /**
+     * Make sure process() runs at the current tick.
+     */
+    void schedProcess();
+
+    /**
+     * Send the access of a load or store to the memory system.
+     *
+     * @param node Record with the access
+     */
+    void issue(Node& node);
+
+    /**
+     * Take note of an access having been sent.
+     *
+     * @param pkt Packet that went out
+     */
+    void sent(PacketPtr pkt);
+
+    /**
+     * Complete the load a response belongs to.
+     *
+     * @param pkt The response
+     */
+    void recvResponse(PacketPtr pkt);
+
+    /**
+     * Receive a retry from the neighbouring port and attempt to
+     * resend the waiting packet.
+     */
+    void recvRetry();
+
+    /**
+     * Signal the drain manager once nothing is outstanding any more.
+     */
+    void checkDrained();
+
+    class TraceCPUPort : public MasterPort
+    {
+      public:
+
+        TraceCPUPort(const std::string& name, TraceCPU& trace_cpu)
+            : MasterPort(name, &trace_cpu), traceCPU(trace_cpu)
+        { }
+
+      protected:
+
+        void recvRetry() { traceCPU.recvRetry(); }
+
+        bool recvTimingResp(PacketPtr pkt)
+        {
+            traceCPU.recvResponse(pkt);
+            return true;
+        }
+
+        void recvTimingSnoopReq(PacketPtr pkt) { }
+
+        void recvFunctionalSnoop(PacketPtr pkt) { }
+
+        Tick recvAtomicSnoop(PacketPtr pkt) { return 0; }
+
+      private:
+
+        TraceCPU& traceCPU;
+
+    };
+
+    /** The instance of system to which the CPU is connected. */
+    System* system;
+
+    /** MasterID used in generated requests. */
+    MasterID masterID;
+
+    /** The trace being replayed */
+    ProtoInputStream trace;
+
+    /** Records in flight before a new one has to wait */
+    const unsigned windowSize;
+
+    /** Records in program order, oldest first */
+    std::deque<Node> window;
+
+    /** There are no more records to read */
+    bool traceDone;
+
+    TraceCPUPort port;
+
+    /** Packet waiting for a retry, if any */
+    PacketPtr retryPkt;
+
+    /** Loads and stores the memory system is yet to respond to */
+    unsigned outstanding;
+
+    EventWrapper<TraceCPU, &TraceCPU::process> processEvent;
+
+    DrainManager* drainManager;
+
+    /** TraceCPUs yet to reach the end of their trace */
+    static unsigned active;
+
+    Stats::Scalar numOps;
+
+    Stats::Scalar numLoads;
+
+    Stats::Scalar numStores;
+
+    Stats::Scalar numRetries;
+
+    Stats::Scalar finishTick;
+
+  public:
+
+    TraceCPU(const TraceCPUParams* p);
+
+    ~TraceCPU() {}
+
+    virtual BaseMasterPort& getMasterPort(const std::string &if_name,
+                                          PortID idx = InvalidPortID);
+
+    void init();
+
+    void startup();
+
+    unsigned int drain(DrainManager *dm);
+
+    void drainResume();
+
+    void regStats();
+
+};
+
+#endif //__CPU_TRACE_TRACE_CPU_HH__
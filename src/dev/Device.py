@@ -49,6 +49,17 @@ class DmaDevice(PioDevice):
     cxx_header = "dev/io_device.hh"
     abstract = True
     dma = MasterPort("DMA port")
+    # Transfers within dma_burst_ranges are sent as packets of up to
+    # dma_burst_size bytes rather than one per cache line.  The ranges
+    # must not be cached on the DMA port's path; lines that
+    # dma_snoop_filter sees cached above it are still sent line by line,
+    # checked both when a transfer is queued and as each burst is sent
+    dma_burst_size = Param.MemorySize('0B', "Largest DMA burst packet, a"
+        " power of two (0 sends cache lines only)")
+    dma_burst_ranges = VectorParam.AddrRange([], "Address ranges DMA"
+        " bursts may target")
+    dma_snoop_filter = Param.SnoopFilter(NULL, "Snoop filter telling"
+        " which lines of a burst are cached and sent line by line")
 
 
 class IsaFake(BasicPioDevice):
@@ -46,6 +46,21 @@ class EtherLink(EtherObject):
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
+class EtherSocketLink(EtherObject):
+    type = 'EtherSocketLink'
+    cxx_header = "dev/ethersocketlink.hh"
+    int0 = SlavePort("interface 0")
+    server = Param.Bool(False,
+        "wait for the peer to connect rather than connect to it")
+    peer_host = Param.String("127.0.0.1", "host running the peer")
+    port = Param.UInt16(3600, "TCP port of the link")
+    connect_retries = Param.Int(60,
+        "times to retry connecting to the peer, a second apart")
+    delay = Param.Latency('10us',
+        "packet transmit delay, also the synchronization quantum")
+    speed = Param.NetworkBandwidth('1Gbps', "link speed")
+    dump = Param.EtherDump(NULL, "dump object")
+
 class EtherBus(EtherObject):
     type = 'EtherBus'
     cxx_header = "dev/etherbus.hh"
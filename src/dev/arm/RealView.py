@@ -161,6 +161,8 @@ class Pl111(AmbaDmaDevice):
     vnc   = Param.VncInput(Parent.any, "Vnc server for remote frame buffer display")
     amba_id = 0x00141111
     enable_capture = Param.Bool(True, "capture frame to system.framebuffer.bmp")
+    fast_scanout = Param.Bool(False, "don't fetch frames that neither "
+                              "capture nor a VNC client will see")
 
 
 class HDLcd(AmbaDmaDevice):
@@ -176,6 +178,8 @@ class HDLcd(AmbaDmaDevice):
                                      "display")
     amba_id = 0x00141000
     enable_capture = Param.Bool(True, "capture frame to system.framebuffer.bmp")
+    fast_scanout = Param.Bool(False, "don't fetch frames that neither "
+                              "capture nor a VNC client will see")
 
 class RealView(Platform):
     type = 'RealView'
@@ -92,14 +92,19 @@ void
 GenericTimer::ArchTimer::setCompareValue(uint64_t val)
 {
     _counterLimit = val;
-    if (_counterLimitReachedEvent.scheduled())
-        _parent->deschedule(_counterLimitReachedEvent);
-    if (counterValue() >= _counterLimit) {
+    uint64_t count = counterValue();
+    if (count >= _counterLimit) {
+        if (_counterLimitReachedEvent.scheduled())
+            _parent->deschedule(_counterLimitReachedEvent);
         counterLimitReached();
     } else {
         _control.istatus = 0;
-        _parent->schedule(_counterLimitReachedEvent,
-             curTick() + (_counterLimit - counterValue()) * _counter->period());
+        // Guests often rewrite the compare value with the deadline
+        // that is already pending; leave the event alone then.
+        Tick when = curTick() + (_counterLimit - count) * _counter->period();
+        if (!_counterLimitReachedEvent.scheduled() ||
+            _counterLimitReachedEvent.when() != when)
+            _parent->reschedule(_counterLimitReachedEvent, when, true);
     }
 }
 
@@ -638,6 +638,18 @@ Pl390::genSwiMask(int cpu)
 void
 Pl390::updateIntState(int hint)
 {
+    // Which interrupts are enabled and pending doesn't depend on the
+    // CPU, so collect them once rather than for every CPU
+    const int words = itLines / INT_BITS_MAX;
+    uint32_t ready[INT_BITS_MAX];
+    bool any_ready = false;
+    for (int x = 0; x < words; x++) {
+        ready[x] = intEnabled[x] & pendingInt[x];
+        any_ready |= ready[x] != 0;
+    }
+
+    bool mp_sys = sys->numRunningContexts() > 1;
+
     for (int cpu = 0; cpu < CPU_MAX; cpu++) {
         if (!cpuEnabled[cpu])
             continue;
@@ -671,24 +683,20 @@ Pl390::updateIntState(int hint)
             }
         }
 
-        bool mp_sys = sys->numRunningContexts() > 1;
-        // Check other ints
-        for (int x = 0; x < (itLines/INT_BITS_MAX); x++) {
-            if (intEnabled[x] & pendingInt[x]) {
-                for (int y = 0; y < INT_BITS_MAX; y++) {
-                   uint32_t int_nm = x * INT_BITS_MAX + y;
-                   DPRINTF(GIC, "Checking for interrupt# %d \n",int_nm);
-                    /* Set current pending int as highest int for current cpu
-                       if the interrupt's priority higher than current prioirty
-                       and if currrent cpu is the target (for mp configs only)
-                     */
-                    if ((bits(intEnabled[x], y) & bits(pendingInt[x], y)) &&
-                        (intPriority[int_nm] < highest_pri))
-                        if ( (!mp_sys) || (cpuTarget[int_nm] & (1 << cpu))) {
-                            highest_pri = intPriority[int_nm];
-                            highest_int = int_nm;
-                        }
-                }
+        // Check other ints, visiting only the ones that are ready
+        for (int x = 0; any_ready && x < words; x++) {
+            for (uint32_t word = ready[x]; word; word &= word - 1) {
+                uint32_t int_nm = x * INT_BITS_MAX + findLsbSet(word);
+                DPRINTF(GIC, "Checking for interrupt# %d \n",int_nm);
+                /* Set current pending int as highest int for current cpu
+                   if the interrupt's priority higher than current prioirty
+                   and if currrent cpu is the target (for mp configs only)
+                 */
+                if (intPriority[int_nm] < highest_pri)
+                    if ( (!mp_sys) || (cpuTarget[int_nm] & (1 << cpu))) {
+                        highest_pri = intPriority[int_nm];
+                        highest_int = int_nm;
+                    }
             }
         }
 
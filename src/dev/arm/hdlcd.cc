@@ -73,7 +73,7 @@ HDLcd::HDLcd(const Params *p)
       fillPixelBufferEvent(this), intEvent(this),
       dmaDoneEventAll(MAX_OUTSTANDING_DMA_REQ_CAPACITY, this),
       dmaDoneEventFree(MAX_OUTSTANDING_DMA_REQ_CAPACITY),
-      enableCapture(p->enable_capture)
+      enableCapture(p->enable_capture), fastScanout(p->fast_scanout)
 {
     pioSize = 0xFFFF;
 
@@ -433,6 +433,27 @@ HDLcd::startFrame()
     // currently only support positive line pitches equal to the line length
     assert(width() * bytesPerPixel() == fb_line_pitch);
 
+    // 2. Schedule first pixelclock read; subsequent reads generated as we go
+    Tick firstPixelReadTick = curTick() + pixelClock * (
+                                  PClksPerLine() * (v_sync.val + 1 +
+                                                    v_back_porch.val + 1) +
+                                  h_sync.val + 1 +
+                                  h_back_porch.val + 1);
+
+    if (fastScanout && !frameConsumed()) {
+        // Nothing will look at this frame, so don't fetch it; just end
+        // it when renderPixel() would have reached the end of it.
+        // This leaves the frame's DMA traffic out of the memory system.
+        DPRINTF(HDLcd, "Frame not consumed, skipping scanout\n");
+        Tick line = pixelClock * (width() - PIXELS_PER_RENDER +
+                                  h_front_porch.val + 1 +
+                                  h_back_porch.val + 1 +
+                                  h_sync.val + 1);
+        schedule(endFrameEvent, firstPixelReadTick + height() * line +
+                 PClksPerLine() * (v_front_porch.val + 1) * pixelClock);
+        return;
+    }
+
     // 1. Start DMA'ing the frame; subsequent transactions created as we go
     dmaCurAddr = dmaStartAddr = fb_base;
     dmaMaxAddr = static_cast<Addr>(width() * height() * bytesPerPixel()) +
@@ -442,12 +463,6 @@ HDLcd::startFrame()
     frameUnderrun = false;
     fillPixelBuffer();
 
-    // 2. Schedule first pixelclock read; subsequent reads generated as we go
-    Tick firstPixelReadTick = curTick() + pixelClock * (
-                                  PClksPerLine() * (v_sync.val + 1 +
-                                                    v_back_porch.val + 1) +
-                                  h_sync.val + 1 +
-                                  h_back_porch.val + 1);
     schedule(renderPixelEvent, firstPixelReadTick);
 }
 
@@ -498,7 +513,7 @@ HDLcd::renderPixel()
 {
     // try to handle multiple pixels at a time; doing so reduces the accuracy
     //   of the underrun detection but lowers simulation overhead
-    const size_t count = 32;
+    const size_t count = PIXELS_PER_RENDER;
     assert(width() % count == 0); // not set up to handle trailing pixels
 
     // have we underrun on this frame anytime before?
@@ -142,6 +142,9 @@ class HDLcd: public AmbaDmaDevice
     /** AXI port width in bytes */
     static const size_t AXI_PORT_WIDTH = 8;
 
+    /** pixels read from the internal buffer per pixel read event */
+    static const size_t PIXELS_PER_RENDER = 32;
+
     /**
      * @name RegisterFieldLayouts
      * Bit layout declarations for multi-field registers.
@@ -476,6 +479,13 @@ class HDLcd: public AmbaDmaDevice
 
     bool enableCapture;
 
+    /** Skip fetching frames that nothing consumes */
+    bool fastScanout;
+
+    /** Will anything look at the frame being scanned out? */
+    bool frameConsumed() const
+    { return enableCapture || (vnc && vnc->hasConsumer()); }
+
   public:
     typedef HDLcdParams Params;
 
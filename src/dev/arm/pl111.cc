@@ -69,7 +69,8 @@ Pl111::Pl111(const Params *p)
       waterMark(0), dmaPendingNum(0), readEvent(this), fillFifoEvent(this),
       dmaDoneEventAll(maxOutstandingDma, this),
       dmaDoneEventFree(maxOutstandingDma),
-      intEvent(this), enableCapture(p->enable_capture)
+      intEvent(this), enableCapture(p->enable_capture),
+      fastScanout(p->fast_scanout)
 {
     pioSize = 0xFFFF;
 
@@ -447,6 +448,18 @@ Pl111::readFramebuffer()
 
     DPRINTF(PL111, " lcd frame buffer size of %d bytes \n", maxAddr);
 
+    if (fastScanout && !frameConsumed()) {
+        // Nothing will look at this frame, so don't fetch it; just
+        // start the next one when it's due. This leaves the frame's
+        // DMA traffic out of the memory system.
+        DPRINTF(PL111, "Frame not consumed, skipping DMA\n");
+        curAddr = maxAddr;
+        if (lcdControl.lcden)
+            schedule(readEvent, clockEdge(ticksToCycles(
+                lcdTiming2.cpl * height * pixelClock)));
+        return;
+    }
+
     fillFifo();
 }
 
@@ -350,6 +350,13 @@ class Pl111: public AmbaDmaDevice
 
     bool enableCapture;
 
+    /** Skip fetching frames that nothing consumes */
+    bool fastScanout;
+
+    /** Will anything look at the frame being scanned out? */
+    bool frameConsumed() const
+    { return enableCapture || (vnc && vnc->hasConsumer()); }
+
   public:
     typedef Pl111Params Params;
 
@@ -181,11 +181,9 @@ Sp804::Timer::restartCounter(uint32_t val)
     else
         time *= bits(val,15,0);
 
-    if (zeroEvent.scheduled()) {
-        DPRINTF(Timer, "-- Event was already schedule, de-scheduling\n");
-        parent->deschedule(zeroEvent);
-    }
-    parent->schedule(zeroEvent, curTick() + time);
+    if (zeroEvent.scheduled())
+        DPRINTF(Timer, "-- Event was already scheduled, moving it\n");
+    parent->reschedule(zeroEvent, curTick() + time, true);
     DPRINTF(Timer, "-- Scheduling new event for: %d\n", curTick() + time);
 }
 
@@ -52,6 +52,39 @@
 
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////
+//
+// Disk image
+//
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset, int count) const
+{
+    uint64_t sector = offset;
+    uint64_t bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        uint64_t got = read(data + bytes, sector + i);
+        bytes += got;
+        if (got != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        int count)
+{
+    uint64_t sector = offset;
+    uint64_t bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        uint64_t put = write(data + bytes, sector + i);
+        bytes += put;
+        if (put != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
@@ -101,6 +134,19 @@ RawDiskImage::size() const
 
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          int count) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -113,16 +159,18 @@ RawDiskImage::read(uint8_t *data, std::streampos offset) const
         panic("Could not seek to location in file");
 
     streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    stream.read((char *)data, count * SectorSize);
 
-    DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageRead, data, SectorSize);
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, count * SectorSize);
 
     return stream.tellg() - pos;
 }
 
 std::streampos
-RawDiskImage::write(const uint8_t *data, std::streampos offset)
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           int count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -137,11 +185,12 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (!stream.good())
         panic("Could not seek to location in file");
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
     streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
+    stream.write((const char *)data, count * SectorSize);
     return stream.tellp() - pos;
 }
 
@@ -169,7 +218,8 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL),
+      sectorCount(0)
 {
     if (filename.empty()) {
         initSectorTable(p->table_size);
@@ -187,13 +237,42 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
+    clearTable();
+}
+
+void
+CowDiskImage::clearTable()
+{
+    if (!table)
+        return;
+
+    ChunkTable::iterator i = table->begin();
+    ChunkTable::iterator end = table->end();
 
     while (i != end) {
         delete (*i).second;
         ++i;
     }
+
+    delete table;
+    table = NULL;
+    sectorCount = 0;
+}
+
+CowDiskImage::Chunk *
+CowDiskImage::findChunk(uint64_t sector) const
+{
+    ChunkTable::const_iterator i = table->find(sector / ChunkSectors);
+    return i == table->end() ? NULL : (*i).second;
+}
+
+CowDiskImage::Chunk *
+CowDiskImage::getChunk(uint64_t sector)
+{
+    Chunk *&chunk = (*table)[sector / ChunkSectors];
+    if (!chunk)
+        chunk = new Chunk;
+    return chunk;
 }
 
 void
@@ -251,19 +330,22 @@ CowDiskImage::open(const string &file)
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
+    clearTable();
+    table = new ChunkTable(sector_count / ChunkSectors + 1);
 
 
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
+        Chunk *chunk = getChunk(offset);
+        int index = offset % ChunkSectors;
+        SafeRead(stream, chunk->data[index], SectorSize);
 
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        assert(!chunk->valid[index]);
+        chunk->valid[index] = true;
     }
+    sectorCount = sector_count;
 
     stream.close();
 
@@ -274,7 +356,7 @@ CowDiskImage::open(const string &file)
 void
 CowDiskImage::initSectorTable(int hash_size)
 {
-    table = new SectorTable(hash_size);
+    table = new ChunkTable(hash_size / ChunkSectors + 1);
 
     initialized = true;
 }
@@ -329,33 +411,53 @@ CowDiskImage::save(const string &file)
 
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
+    SafeWriteSwap(stream, sectorCount);
 
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
+    uint64_t saved = 0;
+    ChunkTable::iterator iter = table->begin();
+    ChunkTable::iterator end = table->end();
 
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
+    for (; iter != end; ++iter) {
+        const Chunk *chunk = (*iter).second;
+        for (int i = 0; i < ChunkSectors; ++i) {
+            if (!chunk->valid[i])
+                continue;
 
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+            SafeWriteSwap(stream, (*iter).first * ChunkSectors + i);
+            SafeWrite(stream, chunk->data[i], SectorSize);
+            ++saved;
+        }
     }
 
+    if (saved != sectorCount)
+        panic("Incorrect Table Size during save of COW disk image");
+
     stream.close();
 }
 
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    ChunkTable::iterator iter = table->begin();
+    ChunkTable::iterator end = table->end();
+
+    for (; iter != end; ++iter) {
+        const Chunk *chunk = (*iter).second;
+        uint64_t base = (*iter).first * ChunkSectors;
+        int i = 0;
+        while (i < ChunkSectors) {
+            if (!chunk->valid[i]) {
+                ++i;
+                continue;
+            }
+
+            // write back each run of valid sectors in one go
+            int run = 1;
+            while (i + run < ChunkSectors && chunk->valid[i + run])
+                ++run;
+            child->writeSectors(chunk->data[i], base + i, run);
+            i += run;
+        }
     }
 }
 
@@ -365,46 +467,104 @@ CowDiskImage::size() const
 
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          int count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    uint64_t sector = offset;
+    if (sector + count - 1 > (uint64_t)size())
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+    uint64_t bytes = 0;
+    int done = 0;
+    while (done < count) {
+        const Chunk *chunk = findChunk(sector);
+        int index = sector % ChunkSectors;
+        int n = min(count - done, ChunkSectors - index);
+
+        // split the part of this chunk into runs of sectors that are
+        // either all held here or all held by the child
+        int i = 0;
+        while (i < n) {
+            bool here = chunk && chunk->valid[index + i];
+            int run = 1;
+            while (i + run < n &&
+                   (chunk && chunk->valid[index + i + run]) == here)
+                ++run;
+
+            if (here) {
+                memcpy(data + bytes, chunk->data[index + i],
+                       run * SectorSize);
+                bytes += run * SectorSize;
+            } else {
+                uint64_t got = child->readSectors(data + bytes, sector + i,
+                                                  run);
+                bytes += got;
+                if (got != run * SectorSize)
+                    return bytes;
+            }
+            i += run;
+        }
+
+        done += n;
+        sector += n;
     }
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, bytes);
+    return bytes;
 }
 
 std::streampos
-CowDiskImage::write(const uint8_t *data, std::streampos offset)
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           int count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (offset > size())
+    uint64_t sector = offset;
+    if (sector + count - 1 > (uint64_t)size())
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
+    const uint8_t *src = data;
+    int done = 0;
+    while (done < count) {
+        Chunk *chunk = getChunk(sector);
+        int index = sector % ChunkSectors;
+        int n = min(count - done, ChunkSectors - index);
+
+        memcpy(chunk->data[index], src, n * SectorSize);
+        for (int i = index; i < index + n; ++i) {
+            if (!chunk->valid[i]) {
+                chunk->valid[i] = true;
+                ++sectorCount;
+            }
+        }
+
+        src += n * SectorSize;
+        done += n;
+        sector += n;
     }
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
@@ -35,6 +35,7 @@
 #ifndef __DISK_IMAGE_HH__
 #define __DISK_IMAGE_HH__
 
+#include <bitset>
 #include <fstream>
 
 #include "base/hashmap.hh"
@@ -64,6 +65,16 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read or write 'count' consecutive sectors starting at sector
+     * 'offset', returning the number of bytes transferred. Images
+     * that can do better than one sector at a time override these.
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       int count) const;
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset, int count);
 };
 
 /**
@@ -89,6 +100,11 @@ class RawDiskImage : public DiskImage
 
     virtual std::streampos read(uint8_t *data, std::streampos offset) const;
     virtual std::streampos write(const uint8_t *data, std::streampos offset);
+
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       int count) const;
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset, int count);
 };
 
 /**
@@ -108,15 +124,30 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMinor;
 
   protected:
-    struct Sector {
-        uint8_t data[SectorSize];
+    /** Number of sectors in each chunk of written data (64kB) */
+    static const int ChunkSectors = 128;
+
+    /**
+     * Written sectors are kept in aligned chunks, so that a run of
+     * sectors costs one lookup and one allocation rather than one
+     * per sector.
+     */
+    struct Chunk {
+        std::bitset<ChunkSectors> valid;
+        uint8_t data[ChunkSectors][SectorSize];
     };
-    typedef m5::hash_map<uint64_t, Sector *> SectorTable;
+    typedef m5::hash_map<uint64_t, Chunk *> ChunkTable;
 
   protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+    ChunkTable *table;
+    /** Number of valid sectors across all chunks */
+    uint64_t sectorCount;
+
+    Chunk *findChunk(uint64_t sector) const;
+    Chunk *getChunk(uint64_t sector);
+    void clearTable();
 
   public:
     typedef CowDiskImageParams Params;
@@ -135,6 +166,11 @@ class CowDiskImage : public DiskImage
 
     virtual std::streampos read(uint8_t *data, std::streampos offset) const;
     virtual std::streampos write(const uint8_t *data, std::streampos offset);
+
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       int count) const;
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset, int count);
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
@@ -43,18 +43,44 @@
  */
 
 #include "base/chunk_generator.hh"
+#include "base/intmath.hh"
 #include "debug/DMA.hh"
 #include "debug/Drain.hh"
 #include "dev/dma_device.hh"
+#include "mem/snoop_filter.hh"
 #include "sim/system.hh"
 
 DmaPort::DmaPort(MemObject *dev, System *s)
     : MasterPort(dev->name() + ".dma", dev), device(dev), sendEvent(this),
       sys(s), masterId(s->getMasterId(dev->name())),
       pendingCount(0), drainManager(NULL),
-      inRetry(false)
+      inRetry(false), burstSize(0), snoopFilter(NULL)
 { }
 
+void
+DmaPort::setBurst(Addr burst_size, const AddrRangeList &ranges,
+                  const SnoopFilter *snoop_filter)
+{
+    fatal_if(burst_size && (!isPowerOf2(burst_size) ||
+                            burst_size < sys->cacheLineSize()),
+             "%s: DMA burst size %d is not a power of two of at least a"
+             " cache line\n", name(), burst_size);
+
+    burstSize = burst_size;
+    burstRanges = ranges;
+    snoopFilter = snoop_filter;
+}
+
+bool
+DmaPort::inBurstRange(Addr addr, Addr size) const
+{
+    for (auto r = burstRanges.begin(); r != burstRanges.end(); ++r) {
+        if (r->contains(addr) && r->contains(addr + size - 1))
+            return true;
+    }
+    return false;
+}
+
 void
 DmaPort::handleResp(PacketPtr pkt, Tick delay)
 {
@@ -114,7 +140,12 @@ DmaPort::recvTimingResp(PacketPtr pkt)
 
 DmaDevice::DmaDevice(const Params *p)
     : PioDevice(p), dmaPort(this, sys)
-{ }
+{
+    dmaPort.setBurst(p->dma_burst_size,
+                     AddrRangeList(p->dma_burst_ranges.begin(),
+                                   p->dma_burst_ranges.end()),
+                     p->dma_snoop_filter);
+}
 
 void
 DmaDevice::init()
@@ -159,7 +190,7 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
     // one DMA request sender state for every action, that is then
     // split into many requests and packets based on the block size,
     // i.e. cache line size
-    DmaReqState *reqState = new DmaReqState(event, size, delay);
+    DmaReqState *reqState = new DmaReqState(event, size, delay, data, addr);
 
     // (functionality added for Table Walker statistics)
     // We're only interested in this when there will only be one request.
@@ -169,21 +200,38 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
 
     DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d\n", addr, size,
             event ? event->scheduled() : -1);
-    for (ChunkGenerator gen(addr, size, sys->cacheLineSize());
-         !gen.done(); gen.next()) {
-        req = new Request(gen.addr(), gen.size(), flag, masterId);
-        req->taskId(ContextSwitchTaskId::DMA);
-        PacketPtr pkt = new Packet(req, cmd);
-
-        // Increment the data pointer on a write
-        if (data)
-            pkt->dataStatic(data + gen.complete());
-
-        pkt->senderState = reqState;
+    const Addr line_size = sys->cacheLineSize();
+    if (burstSize && size > line_size && inBurstRange(addr, size)) {
+        // the lines a cache above the snoop filter knows about must be
+        // snooped one by one, the runs of lines between them go out as
+        // bursts
+        Addr run = addr;
+        for (ChunkGenerator gen(addr, size, line_size); !gen.done();
+             gen.next()) {
+            if (!snoopFilter || !snoopFilter->isCached(gen.addr()))
+                continue;
+
+            for (ChunkGenerator burst(run, gen.addr() - run, burstSize);
+                 !burst.done(); burst.next()) {
+                req = queueChunk(cmd, burst.addr(), burst.size(), data,
+                                 addr, reqState, flag);
+            }
+            req = queueChunk(cmd, gen.addr(), gen.size(), data, addr,
+                             reqState, flag);
+            run = gen.addr() + gen.size();
+        }
 
-        DPRINTF(DMA, "--Queuing DMA for addr: %#x size: %d\n", gen.addr(),
-                gen.size());
-        queueDma(pkt);
+        for (ChunkGenerator burst(run, addr + size - run, burstSize);
+             !burst.done(); burst.next()) {
+            req = queueChunk(cmd, burst.addr(), burst.size(), data, addr,
+                             reqState, flag);
+        }
+    } else {
+        for (ChunkGenerator gen(addr, size, line_size); !gen.done();
+             gen.next()) {
+            req = queueChunk(cmd, gen.addr(), gen.size(), data, addr,
+                             reqState, flag);
+        }
     }
 
     // in zero time also initiate the sending of the packets we have
@@ -194,6 +242,79 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
     return req;
 }
 
+PacketPtr
+DmaPort::createChunk(Packet::Command cmd, Addr addr, unsigned size,
+                     uint8_t *data, Addr start, Packet::SenderState *state,
+                     Request::Flags flag)
+{
+    RequestPtr req = new Request(addr, size, flag, masterId);
+    req->taskId(ContextSwitchTaskId::DMA);
+    PacketPtr pkt = new Packet(req, cmd);
+
+    // Increment the data pointer on a write
+    if (data)
+        pkt->dataStatic(data + (addr - start));
+
+    pkt->senderState = state;
+
+    return pkt;
+}
+
+RequestPtr
+DmaPort::queueChunk(Packet::Command cmd, Addr addr, unsigned size,
+                    uint8_t *data, Addr start, Packet::SenderState *state,
+                    Request::Flags flag)
+{
+    PacketPtr pkt = createChunk(cmd, addr, size, data, start, state, flag);
+
+    DPRINTF(DMA, "--Queuing DMA for addr: %#x size: %d\n", addr, size);
+    queueDma(pkt);
+
+    return pkt->req;
+}
+
+void
+DmaPort::splitCachedBurst()
+{
+    PacketPtr pkt = transmitList.front();
+    const Addr line_size = sys->cacheLineSize();
+
+    if (!snoopFilter || pkt->getSize() <= line_size)
+        return;
+
+    bool cached = false;
+    for (ChunkGenerator gen(pkt->getAddr(), pkt->getSize(), line_size);
+         !gen.done() && !cached; gen.next()) {
+        cached = snoopFilter->isCached(gen.addr());
+    }
+    if (!cached)
+        return;
+
+    DPRINTF(DMA, "Splitting burst at %#x, a line of it is now cached\n",
+            pkt->getAddr());
+
+    DmaReqState *state = dynamic_cast<DmaReqState*>(pkt->senderState);
+    assert(state);
+
+    transmitList.pop_front();
+    pendingCount--;
+
+    // queue the lines in order in place of the burst
+    std::deque<PacketPtr>::size_type pos = 0;
+    for (ChunkGenerator gen(pkt->getAddr(), pkt->getSize(), line_size);
+         !gen.done(); gen.next()) {
+        transmitList.insert(transmitList.begin() + pos++,
+                            createChunk((Packet::Command)pkt->cmd.toInt(),
+                                        gen.addr(), gen.size(),
+                                        state->data, state->start, state,
+                                        pkt->req->getFlags()));
+        pendingCount++;
+    }
+
+    delete pkt->req;
+    delete pkt;
+}
+
 void
 DmaPort::queueDma(PacketPtr pkt)
 {
@@ -209,11 +330,16 @@ DmaPort::trySendTimingReq()
 {
     // send the first packet on the transmit list and schedule the
     // following send if it is successful
+    splitCachedBurst();
     PacketPtr pkt = transmitList.front();
 
     DPRINTF(DMA, "Trying to send %s addr %#x\n", pkt->cmdString(),
             pkt->getAddr());
 
+    // a burst occupies the port for as long as its lines sent one by
+    // one would
+    Cycles send_cycles(divCeil(pkt->getSize(), sys->cacheLineSize()));
+
     inRetry = !sendTimingReq(pkt);
     if (!inRetry) {
         transmitList.pop_front();
@@ -222,9 +348,9 @@ DmaPort::trySendTimingReq()
         if (!transmitList.empty())
             // this should ultimately wait for as many cycles as the
             // device needs to send the packet, but currently the port
-            // does not have any known width so simply wait a single
-            // cycle
-            device->schedule(sendEvent, device->clockEdge(Cycles(1)));
+            // does not have any known width so simply wait a cycle
+            // per cache line
+            device->schedule(sendEvent, device->clockEdge(send_cycles));
     } else {
         DPRINTF(DMA, "-- Failed, waiting for retry\n");
     }
@@ -253,6 +379,7 @@ DmaPort::sendDma()
     } else if (sys->isAtomicMode()) {
         // send everything there is to send in zero time
         while (!transmitList.empty()) {
+            splitCachedBurst();
             PacketPtr pkt = transmitList.front();
             transmitList.pop_front();
 
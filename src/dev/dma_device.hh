@@ -46,11 +46,14 @@
 
 #include <deque>
 
+#include "base/addr_range.hh"
 #include "dev/io_device.hh"
 #include "params/DmaDevice.hh"
 #include "sim/drain.hh"
 #include "sim/system.hh"
 
+class SnoopFilter;
+
 class DmaPort : public MasterPort
 {
   private:
@@ -84,6 +87,41 @@ class DmaPort : public MasterPort
      */
     void handleResp(PacketPtr pkt, Tick delay = 0);
 
+    /** Is [addr, addr + size) within one of the burst ranges */
+    bool inBurstRange(Addr addr, Addr size) const;
+
+    /**
+     * Create the packet of one chunk of a DMA transfer.
+     *
+     * @param data Start of the transfer's data, NULL for none
+     * @param start Start address of the transfer
+     * @return The packet
+     */
+    PacketPtr createChunk(Packet::Command cmd, Addr addr, unsigned size,
+                          uint8_t *data, Addr start,
+                          Packet::SenderState *state,
+                          Request::Flags flag);
+
+    /**
+     * Create the packet of one chunk of a DMA transfer and queue it
+     * for transmission.
+     *
+     * @return The request of the packet
+     */
+    RequestPtr queueChunk(Packet::Command cmd, Addr addr, unsigned size,
+                          uint8_t *data, Addr start,
+                          Packet::SenderState *state,
+                          Request::Flags flag);
+
+    /**
+     * Replace a burst at the front of the transmit list by one packet
+     * per line if any of its lines is now cached above the snoop
+     * filter. The burst was checked when it was queued, but a cache
+     * may have fetched a line since, and a burst is only snooped on
+     * its first line.
+     */
+    void splitCachedBurst();
+
     struct DmaReqState : public Packet::SenderState
     {
         /** Event to call on the device when this transaction (all packets)
@@ -99,15 +137,21 @@ class DmaPort : public MasterPort
         /** Amount to delay completion of dma by */
         const Tick delay;
 
-        DmaReqState(Event *ce, Addr tb, Tick _delay)
-            : completionEvent(ce), totBytes(tb), numBytes(0), delay(_delay)
+        /** Data and start address of the transaction, to split bursts */
+        uint8_t *const data;
+        const Addr start;
+
+        DmaReqState(Event *ce, Addr tb, Tick _delay, uint8_t *_data,
+                    Addr _start)
+            : completionEvent(ce), totBytes(tb), numBytes(0), delay(_delay),
+              data(_data), start(_start)
         {}
     };
 
     /** The device that owns this port. */
     MemObject *device;
 
-    /** Use a deque as we never do any insertion or removal in the middle */
+    /** Use a deque as we only insert or remove at either end */
     std::deque<PacketPtr> transmitList;
 
     /** Event used to schedule a future sending from the transmit list. */
@@ -131,6 +175,15 @@ class DmaPort : public MasterPort
      * send whatever it is that it's sending. */
     bool inRetry;
 
+    /** Largest burst packet, 0 if bursts are disabled */
+    Addr burstSize;
+
+    /** Ranges that bursts may target */
+    AddrRangeList burstRanges;
+
+    /** Optional snoop filter telling which lines are cached */
+    const SnoopFilter *snoopFilter;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt);
@@ -142,6 +195,14 @@ class DmaPort : public MasterPort
 
     DmaPort(MemObject *dev, System *s);
 
+    /**
+     * Send the parts of transfers within ranges that no cache above
+     * snoop_filter holds (all of them if it is NULL) as packets of up
+     * to burst_size bytes rather than one per cache line.
+     */
+    void setBurst(Addr burst_size, const AddrRangeList &ranges,
+                  const SnoopFilter *snoop_filter);
+
     RequestPtr dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                          uint8_t *data, Tick delay, Request::Flags flag = 0);
 
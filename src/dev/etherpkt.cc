@@ -36,6 +36,35 @@
 
 using namespace std;
 
+namespace {
+
+/** Size of the buffers that are kept for reuse */
+const unsigned PooledSize = 16384;
+/** Maximum number of buffers kept per host thread */
+const unsigned MaxPooled = 256;
+
+__thread uint8_t *pooled[MaxPooled];
+__thread unsigned numPooled = 0;
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocate(unsigned size)
+{
+    if (size == PooledSize && numPooled)
+        return pooled[--numPooled];
+    return new uint8_t[size];
+}
+
+void
+EthPacketData::release(uint8_t *buf, unsigned size)
+{
+    if (size == PooledSize && numPooled < MaxPooled)
+        pooled[numPooled++] = buf;
+    else
+        delete [] buf;
+}
+
 void
 EthPacketData::serialize(const string &base, ostream &os)
 {
@@ -59,20 +59,40 @@ class EthPacketData
      */
     unsigned length;
 
+  private:
+    /*
+     * Size of the buffer if it came from allocate(), 0 otherwise
+     */
+    unsigned capacity;
+
+    /*
+     * Frame buffers are allocated and freed at the rate frames go
+     * by, so buffers of the usual size are kept for reuse rather than
+     * returned to the heap.
+     */
+    static uint8_t *allocate(unsigned size);
+    static void release(uint8_t *buf, unsigned size);
+
   public:
     EthPacketData()
-        : data(NULL), length(0)
+        : data(NULL), length(0), capacity(0)
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), length(0)
+        : data(allocate(size)), length(0), capacity(size)
     { }
 
     EthPacketData(std::auto_ptr<uint8_t> d, int l)
-        : data(d.release()), length(l)
+        : data(d.release()), length(l), capacity(0)
     { }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData()
+    {
+        if (capacity)
+            release(data, capacity);
+        else if (data)
+            delete [] data;
+    }
 
   public:
     void serialize(const std::string &base, std::ostream &os);
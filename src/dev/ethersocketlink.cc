@@ -0,0 +1,319 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Ethernet link whose far end is simulated by another gem5 process
+ */
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include "base/misc.hh"
+#include "base/socket.hh"
+#include "base/trace.hh"
+#include "debug/Ethernet.hh"
+#include "debug/EthernetData.hh"
+#include "dev/etherdump.hh"
+#include "dev/ethersocketlink.hh"
+#include "sim/byteswap.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+namespace {
+
+/** Start of the frames of one quantum on the wire */
+struct QuantumHeader
+{
+    uint64_t tick;
+    uint32_t frames;
+} M5_ATTR_PACKED;
+
+/** Start of one frame on the wire, followed by its data */
+struct FrameHeader
+{
+    uint64_t when;
+    uint32_t length;
+} M5_ATTR_PACKED;
+
+template <class T>
+void
+append(vector<uint8_t> &buf, const T &hdr)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&hdr);
+    buf.insert(buf.end(), p, p + sizeof(hdr));
+}
+
+} // anonymous namespace
+
+EtherSocketLink::EtherSocketLink(const Params *p)
+    : EtherObject(p), ticksPerByte(p->speed), linkDelay(p->delay),
+      dump(p->dump), socket(-1), txEvent(this), rxEvent(this),
+      syncEvent(this)
+{
+    if (linkDelay == 0)
+        fatal("%s: the link delay sets the synchronization quantum and "
+              "must not be zero\n", name());
+
+    interface = new Interface(name() + ".int0", this);
+}
+
+EtherSocketLink::~EtherSocketLink()
+{
+    if (socket != -1)
+        close(socket);
+
+    delete interface;
+}
+
+EtherInt *
+EtherSocketLink::getEthPort(const std::string &if_name, int idx)
+{
+    if (if_name != "int0")
+        return NULL;
+    if (interface->getPeer())
+        panic("interface already connected to\n");
+
+    return interface;
+}
+
+void
+EtherSocketLink::connect()
+{
+    const Params *p = params();
+
+    if (p->server) {
+        if (ListenSocket::allDisabled())
+            fatal("All listeners are disabled! %s can't work!", name());
+
+        ListenSocket listener;
+        if (!listener.listen(p->port, true))
+            fatal("%s: can't bind port %d\n", name(), p->port);
+
+        inform("%s: waiting for peer on port %d\n", name(), p->port);
+        socket = listener.accept(true);
+        if (socket == -1)
+            fatal("%s: accept() failed: %s\n", name(), strerror(errno));
+    } else {
+        struct addrinfo hints, *addrs;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        string port = csprintf("%d", p->port);
+        int ret = getaddrinfo(p->peer_host.c_str(), port.c_str(), &hints,
+                              &addrs);
+        if (ret != 0)
+            fatal("%s: can't resolve %s: %s\n", name(), p->peer_host,
+                  gai_strerror(ret));
+
+        // the peer may still be starting up, so keep trying for a bit
+        inform("%s: connecting to %s:%d\n", name(), p->peer_host, p->port);
+        for (int attempt = 0; socket == -1; ++attempt) {
+            int fd = ::socket(addrs->ai_family, addrs->ai_socktype,
+                              addrs->ai_protocol);
+            if (fd < 0)
+                panic("Can't create socket:%s !", strerror(errno));
+
+            if (::connect(fd, addrs->ai_addr, addrs->ai_addrlen) == 0) {
+                socket = fd;
+                break;
+            }
+
+            close(fd);
+            if (attempt == p->connect_retries)
+                fatal("%s: can't connect to %s:%d: %s\n", name(),
+                      p->peer_host, p->port, strerror(errno));
+            sleep(1);
+        }
+        freeaddrinfo(addrs);
+
+        int i = 1;
+        if (::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (char *)&i,
+                         sizeof(i)) < 0)
+            warn("%s: setsockopt() TCP_NODELAY failed!", name());
+    }
+}
+
+void
+EtherSocketLink::init()
+{
+    if (!interface->getPeer())
+        panic("%s: interface not connected\n", name());
+
+    connect();
+}
+
+void
+EtherSocketLink::startup()
+{
+    schedule(syncEvent, curTick() + linkDelay);
+}
+
+void
+EtherSocketLink::sendAll(const void *data, size_t len)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    while (len > 0) {
+        ssize_t ret = write(socket, p, len);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            fatal("%s: write to peer failed: %s\n", name(), strerror(errno));
+        }
+        p += ret;
+        len -= ret;
+    }
+}
+
+bool
+EtherSocketLink::recvAll(void *data, size_t len)
+{
+    uint8_t *p = static_cast<uint8_t *>(data);
+    while (len > 0) {
+        ssize_t ret = read(socket, p, len);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        p += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+bool
+EtherSocketLink::transmit(EthPacketPtr pkt)
+{
+    if (txPacket) {
+        DPRINTF(Ethernet, "packet not sent, link busy\n");
+        return false;
+    }
+
+    DPRINTF(Ethernet, "packet sent: len=%d\n", pkt->length);
+    DDUMP(EthernetData, pkt->data, pkt->length);
+
+    txPacket = pkt;
+    Tick delay = (Tick)ceil(((double)pkt->length * ticksPerByte) + 1.0);
+    schedule(txEvent, curTick() + delay);
+
+    return true;
+}
+
+void
+EtherSocketLink::txDone()
+{
+    if (dump)
+        dump->dump(txPacket);
+
+    Frame frame = { curTick() + linkDelay, txPacket };
+    txFrames.push_back(frame);
+    txPacket = NULL;
+
+    interface->sendDone();
+}
+
+void
+EtherSocketLink::rxDone()
+{
+    Frame &frame = rxFrames.front();
+    assert(frame.when == curTick());
+
+    DPRINTF(Ethernet, "packet received: len=%d\n", frame.packet->length);
+    DDUMP(EthernetData, frame.packet->data, frame.packet->length);
+    interface->sendPacket(frame.packet);
+    rxFrames.pop_front();
+
+    if (!rxFrames.empty())
+        schedule(rxEvent, rxFrames.front().when);
+}
+
+void
+EtherSocketLink::sync()
+{
+    Tick now = curTick();
+
+    // send everything transmitted during the quantum in one message
+    txBuffer.clear();
+    QuantumHeader qhdr = { htobe<uint64_t>(now),
+                           htobe<uint32_t>(txFrames.size()) };
+    append(txBuffer, qhdr);
+    for (auto &frame : txFrames) {
+        FrameHeader fhdr = { htobe<uint64_t>(frame.when),
+                             htobe<uint32_t>(frame.packet->length) };
+        append(txBuffer, fhdr);
+        txBuffer.insert(txBuffer.end(), frame.packet->data,
+                        frame.packet->data + frame.packet->length);
+    }
+    sendAll(txBuffer.data(), txBuffer.size());
+    txFrames.clear();
+
+    // wait for the peer to finish the same quantum
+    if (!recvAll(&qhdr, sizeof(qhdr))) {
+        exitSimLoop(name() + ": peer closed the connection");
+        return;
+    }
+
+    if (betoh(qhdr.tick) != now)
+        panic("%s: out of sync with peer (tick %d != %d)\n", name(),
+              betoh(qhdr.tick), now);
+
+    bool was_empty = rxFrames.empty();
+    for (uint32_t i = 0; i < betoh(qhdr.frames); ++i) {
+        FrameHeader fhdr;
+        if (!recvAll(&fhdr, sizeof(fhdr)))
+            panic("%s: connection to peer lost mid-quantum\n", name());
+
+        unsigned length = betoh(fhdr.length);
+        Frame frame = { betoh(fhdr.when),
+                        make_shared<EthPacketData>(max(length, 16384U)) };
+        frame.packet->length = length;
+        if (!recvAll(frame.packet->data, length))
+            panic("%s: connection to peer lost mid-quantum\n", name());
+
+        // frames sent during a quantum can't arrive before its end
+        assert(frame.when >= now);
+        rxFrames.push_back(frame);
+    }
+
+    if (was_empty && !rxFrames.empty())
+        schedule(rxEvent, rxFrames.front().when);
+
+    schedule(syncEvent, now + linkDelay);
+}
+
+EtherSocketLink *
+EtherSocketLinkParams::create()
+{
+    return new EtherSocketLink(this);
+}
@@ -0,0 +1,138 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Ethernet link whose far end is simulated by another gem5 process
+ */
+
+#ifndef __DEV_ETHERSOCKETLINK_HH__
+#define __DEV_ETHERSOCKETLINK_HH__
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "dev/etherint.hh"
+#include "dev/etherobject.hh"
+#include "dev/etherpkt.hh"
+#include "params/EtherSocketLink.hh"
+#include "sim/eventq.hh"
+
+class EtherDump;
+
+/*
+ * One end of a full duplex ethernet link that connects a simulated
+ * device to a device in another gem5 process, possibly on another
+ * host, over a TCP connection. The two processes advance in lockstep
+ * quanta of one link delay: at the end of every quantum each side
+ * sends the frames it transmitted during the quantum and waits for
+ * the frames of its peer. A frame sent in a quantum can't arrive
+ * before the end of it, so every frame is delivered at exactly the
+ * tick it would be by an EtherLink with the same delay.
+ *
+ * Both processes must start from tick 0, or from checkpoints taken at
+ * the same tick. Frames in flight on the link are not checkpointed.
+ */
+class EtherSocketLink : public EtherObject
+{
+  protected:
+    class Interface : public EtherInt
+    {
+      private:
+        EtherSocketLink *link;
+
+      public:
+        Interface(const std::string &name, EtherSocketLink *l)
+            : EtherInt(name), link(l)
+        { }
+
+        bool recvPacket(EthPacketPtr packet)
+        { return link->transmit(packet); }
+        void sendDone() { peer->sendDone(); }
+        bool isBusy() { return (bool)link->txPacket; }
+    };
+
+    /** A frame and the tick it arrives at the receiving end */
+    struct Frame
+    {
+        Tick when;
+        EthPacketPtr packet;
+    };
+
+    Interface *interface;
+
+    double ticksPerByte;
+    Tick linkDelay;
+    EtherDump *dump;
+
+    /** Connection to the peer process */
+    int socket;
+
+    /** Frame being transmitted by the local device */
+    EthPacketPtr txPacket;
+    void txDone();
+    EventWrapper<EtherSocketLink, &EtherSocketLink::txDone> txEvent;
+
+    /** Frames transmitted in the current quantum */
+    std::vector<Frame> txFrames;
+    /** Wire encoding of a quantum's frames, reused across quanta */
+    std::vector<uint8_t> txBuffer;
+
+    /** Frames from the peer waiting to be delivered, in order */
+    std::deque<Frame> rxFrames;
+    void rxDone();
+    EventWrapper<EtherSocketLink, &EtherSocketLink::rxDone> rxEvent;
+
+    /** Exchange frames with the peer at the end of a quantum */
+    void sync();
+    EventWrapper<EtherSocketLink, &EtherSocketLink::sync> syncEvent;
+
+    bool transmit(EthPacketPtr packet);
+
+    void connect();
+    void sendAll(const void *data, size_t len);
+    bool recvAll(void *data, size_t len);
+
+  public:
+    typedef EtherSocketLinkParams Params;
+    EtherSocketLink(const Params *p);
+    virtual ~EtherSocketLink();
+
+    const Params *
+    params() const
+    {
+        return dynamic_cast<const Params *>(_params);
+    }
+
+    virtual EtherInt *getEthPort(const std::string &if_name, int idx);
+
+    void init();
+    void startup();
+};
+
+#endif // __DEV_ETHERSOCKETLINK_HH__
@@ -459,15 +459,12 @@ IdeDisk::doDmaRead()
 void
 IdeDisk::dmaReadDone()
 {
-    uint32_t bytesWritten = 0;
+    uint32_t sectors = divCeil(curPrd.getByteCount(), SectorSize);
 
     // write the data to the disk image
-    for (bytesWritten = 0; bytesWritten < curPrd.getByteCount();
-         bytesWritten += SectorSize) {
-
-        cmdBytesLeft -= SectorSize;
-        writeDisk(curSector++, (uint8_t *)(dataBuffer + bytesWritten));
-    }
+    cmdBytesLeft -= sectors * SectorSize;
+    writeDisk(curSector, (uint8_t *)dataBuffer, sectors);
+    curSector += sectors;
 
     // check for the EOT
     if (curPrd.getEOT()) {
@@ -484,18 +481,17 @@ IdeDisk::doDmaDataWrite()
 {
     /** @todo we need to figure out what the delay actually will be */
     Tick totalDiskDelay = diskDelay + (curPrd.getByteCount() / SectorSize);
-    uint32_t bytesRead = 0;
+    uint32_t sectors = divCeil(curPrd.getByteCount(), SectorSize);
+    uint32_t bytesRead = sectors * SectorSize;
 
     DPRINTF(IdeDisk, "doDmaWrite, diskDelay: %d totalDiskDelay: %d\n",
             diskDelay, totalDiskDelay);
 
     memset(dataBuffer, 0, MAX_DMA_SIZE);
     assert(cmdBytesLeft <= MAX_DMA_SIZE);
-    while (bytesRead < curPrd.getByteCount()) {
-        readDisk(curSector++, (uint8_t *)(dataBuffer + bytesRead));
-        bytesRead += SectorSize;
-        cmdBytesLeft -= SectorSize;
-    }
+    readDisk(curSector, (uint8_t *)dataBuffer, sectors);
+    curSector += sectors;
+    cmdBytesLeft -= bytesRead;
     DPRINTF(IdeDisk, "doDmaWrite, bytesRead: %d cmdBytesLeft: %d\n",
             bytesRead, cmdBytesLeft);
 
@@ -563,23 +559,23 @@ IdeDisk::dmaWriteDone()
 ///
 
 void
-IdeDisk::readDisk(uint32_t sector, uint8_t *data)
+IdeDisk::readDisk(uint32_t sector, uint8_t *data, int count)
 {
-    uint32_t bytesRead = image->read(data, sector);
+    uint32_t bytesRead = image->readSectors(data, sector, count);
 
-    if (bytesRead != SectorSize)
+    if (bytesRead != count * SectorSize)
         panic("Can't read from %s. Only %d of %d read. errno=%d\n",
-              name(), bytesRead, SectorSize, errno);
+              name(), bytesRead, count * SectorSize, errno);
 }
 
 void
-IdeDisk::writeDisk(uint32_t sector, uint8_t *data)
+IdeDisk::writeDisk(uint32_t sector, uint8_t *data, int count)
 {
-    uint32_t bytesWritten = image->write(data, sector);
+    uint32_t bytesWritten = image->writeSectors(data, sector, count);
 
-    if (bytesWritten != SectorSize)
+    if (bytesWritten != count * SectorSize)
         panic("Can't write to %s. Only %d of %d written. errno=%d\n",
-              name(), bytesWritten, SectorSize, errno);
+              name(), bytesWritten, count * SectorSize, errno);
 }
 
 ////
@@ -36,6 +36,7 @@
 #include <string>
 
 #include "dev/etherpkt.hh"
+#include "sim/event_pool.hh"
 #include "sim/serialize.hh"
 
 class Checkpoint;
@@ -79,11 +80,12 @@ class PacketFifo
 {
   public:
 
-    typedef std::list<PacketFifoEntry> fifo_list;
+    typedef std::list<PacketFifoEntry, EventPoolAllocator<PacketFifoEntry> >
+        fifo_list;
     typedef fifo_list::iterator iterator;
 
   protected:
-    std::list<PacketFifoEntry> fifo;
+    fifo_list fifo;
     uint64_t _counter;
     unsigned _maxsize;
     unsigned _size;
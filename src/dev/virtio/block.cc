@@ -37,6 +37,8 @@
  * Authors: Andreas Sandberg
  */
 
+#include <algorithm>
+
 #include "debug/VIOBlock.hh"
 #include "dev/virtio/block.hh"
 #include "params/VirtIOBlock.hh"
@@ -70,7 +72,8 @@ VirtIOBlock::Status
 VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
                   size_t off_data, size_t size)
 {
-    uint8_t data[size];
+    dataBuffer.resize(std::max(dataBuffer.size(), size));
+    uint8_t *data = dataBuffer.data();
     uint64_t sector(req.sector);
 
     DPRINTF(VIOBlock, "Read request starting @ sector %i (size: %i)\n",
@@ -79,12 +82,10 @@ VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.read(data + offset, sector) != SectorSize) {
-            warn("Failed to read sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    if (image.readSectors(data, sector, size / SectorSize) != size) {
+        warn("Failed to read sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     desc_chain->chainWrite(off_data, data, size);
@@ -96,7 +97,8 @@ VirtIOBlock::Status
 VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
                   size_t off_data, size_t size)
 {
-    uint8_t data[size];
+    dataBuffer.resize(std::max(dataBuffer.size(), size));
+    uint8_t *data = dataBuffer.data();
     uint64_t sector(req.sector);
 
     DPRINTF(VIOBlock, "Write request starting @ sector %i (size: %i)\n",
@@ -108,18 +110,26 @@ VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
 
     desc_chain->chainRead(off_data, data, size);
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.write(data + offset, sector) != SectorSize) {
-            warn("Failed to write sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    if (image.writeSectors(data, sector, size / SectorSize) != size) {
+        warn("Failed to write sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     return S_OK;
 
 }
 
+void
+VirtIOBlock::RequestQueue::onNotify()
+{
+    completed = 0;
+    VirtQueue::onNotify();
+
+    if (completed)
+        parent.kick();
+}
+
 void
 VirtIOBlock::RequestQueue::onNotifyDescriptor(VirtDescriptor *desc)
 {
@@ -162,7 +172,7 @@ VirtIOBlock::RequestQueue::onNotifyDescriptor(VirtDescriptor *desc)
 
     // Tell the guest that we are done with this descriptor.
     produceDescriptor(desc, sizeof(BlkRequest) + data_size + sizeof(Status));
-    parent.kick();
+    ++completed;
 }
 
 VirtIOBlock *
@@ -40,6 +40,8 @@
 #ifndef __DEV_VIRTIO_BLOCK_HH__
 #define __DEV_VIRTIO_BLOCK_HH__
 
+#include <vector>
+
 #include "dev/virtio/base.hh"
 #include "dev/disk_image.hh"
 #include "dev/terminal.hh"
@@ -165,15 +167,22 @@ class VirtIOBlock : public VirtIODeviceBase
     {
       public:
         RequestQueue(PortProxy &proxy, uint16_t size, VirtIOBlock &_parent)
-            : VirtQueue(proxy, size), parent(_parent) {}
+            : VirtQueue(proxy, size), parent(_parent), completed(0) {}
         virtual ~RequestQueue() {}
 
+        /**
+         * Service every pending request chain, then notify the guest
+         * once for the whole batch.
+         */
+        void onNotify();
         void onNotifyDescriptor(VirtDescriptor *desc);
 
         std::string name() const { return parent.name() + ".qRequests"; }
 
       protected:
         VirtIOBlock &parent;
+        /** Number of chains completed in the current batch */
+        unsigned completed;
     };
 
     /** Device I/O request queue */
@@ -181,6 +190,9 @@ class VirtIOBlock : public VirtIODeviceBase
 
     /** Image backing this device */
     DiskImage &image;
+
+    /** Staging buffer for request data, reused across requests */
+    std::vector<uint8_t> dataBuffer;
 };
 
 #endif // __DEV_VIRTIO_BLOCK_HH__
@@ -60,12 +60,24 @@ class CommMonitor(MemObject):
     # Boolean to compress the trace or not.
     trace_compress = Param.Bool(True, "Enable trace compression")
 
+    # Leave the compression and writing of the trace to a separate
+    # thread, so that the simulation only pays for the serialisation
+    trace_background = Param.Bool(False, "Compress and write the trace " \
+                                      "on a background thread")
+
     # packet trace output file, disabled by default
     trace_file = Param.String("", "Packet trace output file")
 
     # control the sample period window length of this monitor
     sample_period = Param.Clock("1ms", "Sample period for histograms")
 
+    # gather the per-packet samples (burst lengths, latencies, ITTs
+    # and addresses) in small local tables and pass them on to the
+    # stats at the end of each sample period and before a stats dump,
+    # so that repeated values only cost one stat update
+    lightweight_stats = Param.Bool(False, "Buffer per-packet samples " \
+                                       "until the end of each sample period")
+
     # for each histogram, set the number of bins and enable the user
     # to disable the measurement, reads and writes use the same
     # parameters
@@ -59,6 +59,11 @@ class AddrMap(Enum): vals = ['RoRaBaChCo', 'RoRaBaCoCh', 'RoCoRaBaCh']
 class PageManage(Enum): vals = ['open', 'open_adaptive', 'close',
                                 'close_adaptive']
 
+# Enum for when the power is evaluated: with DRAMPower at every
+# refresh, with DRAMPower at every stats dump, or with a cheap estimate
+# at every stats dump and with DRAMPower at the end of the simulation
+class DRAMPowerEval(Enum): vals = ['refresh', 'dump', 'exit']
+
 # DRAMCtrl is a single-channel single-ported DRAM controller model
 # that aims to model the most important system-level performance
 # effects of a DRAM without getting into too much detail of the DRAM
@@ -137,6 +142,17 @@ class DRAMCtrl(AbstractMemory):
     # IO and RD/WR termination power by default. This might be added as an
     # additional feature in the future.
 
+    # The commands are buffered per rank when the evaluation is
+    # deferred to the stats dumps or the end of the simulation
+    power_eval = Param.DRAMPowerEval('refresh', "When to evaluate the " \
+                                         "DRAM power")
+
+    # while every core is quiesced and a rank has nothing to do, its
+    # refreshes are accounted for in batches rather than each going
+    # through the refresh and power state machines
+    idle_refresh_batch = Param.Unsigned(0, "Refreshes per event while the "\
+                                            "system is idle, 0 to disable")
+
     # timing behaviour and constraints - all in nanoseconds
 
     # the base clock period of the DRAM
@@ -44,6 +44,12 @@ class MemChecker(SimObject):
     type = 'MemChecker'
     cxx_header = "mem/mem_checker.hh"
 
+    # Only track the lines whose address hashes into the sample, so
+    # the checker can be left on, at the cost of only catching the
+    # violations on those lines
+    sample_ratio = Param.Unsigned(1, "Track one in this many lines, " \
+                                      "chosen by address hash")
+
 class MemCheckerMonitor(MemObject):
     type = 'MemCheckerMonitor'
     cxx_header = "mem/mem_checker_monitor.hh"
@@ -45,6 +45,12 @@ class StackDistCalc(SimObject):
     # enable verification stack
     verify = Param.Bool(False, "Verify behaviuor with reference implementation")
 
+    # spatially hashed sampling
+    sample_ratio = Param.Unsigned(1, "Only track the addresses whose hash "
+                                  "falls in one of this many buckets, and "
+                                  "scale their distances up to match; 1 "
+                                  "tracks every address exactly")
+
     # linear histogram bins and enable/disable
     linear_hist_bins = Param.Unsigned('16', "Bins in linear histograms")
     disable_linear_hists = Param.Bool(False, "Disable linear histograms")
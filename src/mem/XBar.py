@@ -81,5 +81,7 @@ class SnoopFilter(SimObject):
     type = 'SnoopFilter'
     cxx_header = "mem/snoop_filter.hh"
     lookup_latency = Param.Cycles(3, "lookup latency (cycles)")
+    max_capacity = Param.MemorySize('8MB',
+        "Combined size of the caches above, bounding the tracked lines")
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
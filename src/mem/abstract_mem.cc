@@ -76,6 +76,17 @@ AbstractMemory::setBackingStore(uint8_t* pmem_addr)
     pmemAddr = pmem_addr;
 }
 
+bool
+AbstractMemory::getBackdoor(MemBackdoor &backdoor) const
+{
+    if (!pmemAddr)
+        return false;
+
+    backdoor.range = RangeIn(range.start(), range.end());
+    backdoor.ptr = pmemAddr;
+    return true;
+}
+
 void
 AbstractMemory::regStats()
 {
@@ -49,6 +49,7 @@
 #ifndef __ABSTRACT_MEMORY_HH__
 #define __ABSTRACT_MEMORY_HH__
 
+#include "mem/backdoor.hh"
 #include "mem/mem_object.hh"
 #include "params/AbstractMemory.hh"
 #include "sim/stats.hh"
@@ -215,6 +216,21 @@ class AbstractMemory : public MemObject
      */
     void setBackingStore(uint8_t* pmem_addr);
 
+    /**
+     * Get the host memory backing store, NULL if it hasn't been set.
+     */
+    uint8_t *backingStore() const { return pmemAddr; }
+
+    /**
+     * Fill in the range and host address of a backdoor to the whole
+     * memory, leaving the latency to the caller. The stripes of an
+     * interleaved memory share one backing store, so the backdoor
+     * covers the whole interleaved chunk.
+     *
+     * @return false if there is no backing store to hand out
+     */
+    bool getBackdoor(MemBackdoor &backdoor) const;
+
     /**
      * Get the list of locked addresses to allow checkpointing.
      */
@@ -0,0 +1,60 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_BACKDOOR_HH__
+#define __MEM_BACKDOOR_HH__
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+
+/**
+ * A host pointer to a range of simulated memory, handed out through
+ * the ports so that an atomic master can read and write the memory
+ * directly instead of sending packets, like a TLM direct memory
+ * interface. Masters get one with MasterPort::sendBackdoorReq. The
+ * crossbars forward the request, and caches forward it only when they
+ * are bypassed. A backdoor stays valid until the memory system changes
+ * mode or the master sees a range change.
+ */
+struct MemBackdoor
+{
+    /** Range covered, at ptr for range.start() */
+    AddrRange range;
+
+    /** Host address of the start of the range */
+    uint8_t *ptr;
+
+    /** Latency to charge per access */
+    Tick latency;
+
+    MemBackdoor() : ptr(NULL), latency(0) { }
+
+    /** Host address of a simulated address in the range */
+    uint8_t *hostAddr(Addr addr) const { return ptr + (addr - range.start()); }
+};
+
+#endif //__MEM_BACKDOOR_HH__
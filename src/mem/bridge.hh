@@ -51,8 +51,7 @@
 #ifndef __MEM_BRIDGE_HH__
 #define __MEM_BRIDGE_HH__
 
-#include <deque>
-
+#include "base/circular_queue.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "params/Bridge.hh"
@@ -83,8 +82,11 @@ class Bridge : public MemObject
 
       public:
 
-        const Tick tick;
-        const PacketPtr pkt;
+        Tick tick;
+        PacketPtr pkt;
+
+        DeferredPacket() : tick(0), pkt(NULL)
+        { }
 
         DeferredPacket(PacketPtr _pkt, Tick _tick) : tick(_tick), pkt(_pkt)
         { }
@@ -121,10 +123,12 @@ class Bridge : public MemObject
         /**
          * Response packet queue. Response packets are held in this
          * queue for a specified delay to model the processing delay
-         * of the bridge. We use a deque as we need to iterate over
-         * the items for functional accesses.
+         * of the bridge. The queue never holds more than the
+         * reserved responses, so it is a fixed-size ring sized by the
+         * response limit, which we can also iterate over for
+         * functional accesses.
          */
-        std::deque<DeferredPacket> transmitList;
+        CircularQueue<DeferredPacket> transmitList;
 
         /** Counter to track the outstanding responses. */
         unsigned int outstandingResponses;
@@ -233,10 +237,11 @@ class Bridge : public MemObject
         /**
          * Request packet queue. Request packets are held in this
          * queue for a specified delay to model the processing delay
-         * of the bridge.  We use a deque as we need to iterate over
-         * the items for functional accesses.
+         * of the bridge. It is a fixed-size ring sized by the
+         * request limit, which we can also iterate over for
+         * functional accesses.
          */
-        std::deque<DeferredPacket> transmitList;
+        CircularQueue<DeferredPacket> transmitList;
 
         /** Max queue size for request packets */
         const unsigned int reqQueueLimit;
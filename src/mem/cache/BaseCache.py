@@ -44,6 +44,11 @@ from MemObject import MemObject
 from Prefetcher import BasePrefetcher
 from Tags import *
 
+# Error protection of the data array against injected faults: one parity
+# bit per line, or single error correction, double error detection per
+# 64 bit word
+class CacheEcc(Enum): vals = ['none', 'parity', 'secded']
+
 class BaseCache(MemObject):
     type = 'BaseCache'
     cxx_header = "mem/cache/base.hh"
@@ -66,6 +71,12 @@ class BaseCache(MemObject):
     prefetch_on_access = Param.Bool(False,
          "notify the hardware prefetcher on every access (not just misses)")
     prefetcher = Param.BasePrefetcher(NULL,"Prefetcher attached to cache")
+    gather_stores = Param.Bool(False, "post stores that miss behind an "
+        "outstanding store to the same line and gather contiguous ones "
+        "(top level only)")
+    bulk_writeback = Param.Bool(False, "write dirty lines straight into "
+        "the backing store in address order on writeback for drain and "
+        "checkpoint (only correct with nothing but memory below)")
     cpu_side = SlavePort("Port on side closer to CPU")
     mem_side = MasterPort("Port on side closer to MEM")
     addr_ranges = VectorParam.AddrRange([AllMemory], "The address range for the CPU-side port")
@@ -73,3 +84,4 @@ class BaseCache(MemObject):
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
     tags = Param.BaseTags(LRU(), "Tag Store for LRU caches")
+    ecc = Param.CacheEcc('none', "Error protection of the data array")
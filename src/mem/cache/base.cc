@@ -45,11 +45,17 @@
  * Definition of BaseCache functions.
  */
 
+#include <map>
+
 #include "debug/Cache.hh"
 #include "debug/Drain.hh"
+#include "mem/cache/blk.hh"
 #include "mem/cache/tags/fa_lru.hh"
 #include "mem/cache/tags/lru.hh"
 #include "mem/cache/tags/random_repl.hh"
+#include "mem/cache/tags/rrip.hh"
+#include "mem/cache/tags/sector_tags.hh"
+#include "mem/cache/tags/tree_plru.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/cache.hh"
 #include "mem/cache/mshr.hh"
@@ -79,6 +85,7 @@ BaseCache::BaseCache(const Params *p)
       numTarget(p->tgts_per_mshr),
       forwardSnoops(p->forward_snoops),
       isTopLevel(p->is_top_level),
+      ecc(p->ecc),
       blocked(0),
       order(0),
       noTargetMSHR(NULL),
@@ -86,6 +93,7 @@ BaseCache::BaseCache(const Params *p)
       addrRanges(p->addr_ranges.begin(), p->addr_ranges.end()),
       system(p->system)
 {
+    system->registerCachingAgent();
 }
 
 void
@@ -419,6 +427,11 @@ BaseCache::regStats()
         .desc("number of fast writes performed")
         ;
 
+    gatheredStores
+        .name(name() + ".gathered_stores")
+        .desc("number of stores posted and gathered in an MSHR")
+        ;
+
     cacheCopies
         .name(name() + ".cache_copies")
         .desc("number of cache copies performed")
@@ -761,6 +774,71 @@ BaseCache::regStats()
         .desc("Number of misses that were no-allocate")
         ;
 
+    eccCorrected
+        .name(name() + ".ecc_corrected")
+        .desc("Number of injected bit flips corrected by ECC")
+        ;
+
+    eccDetected
+        .name(name() + ".ecc_detected")
+        .desc("Number of uncorrectable errors detected by ECC")
+        ;
+}
+
+void
+BaseCache::checkEcc(CacheBlk *blk)
+{
+    std::vector<unsigned> &bits = blk->faultyBits;
+
+    switch (ecc) {
+      case Enums::none:
+        return;
+
+      case Enums::parity:
+        // One parity bit per line sees any odd number of flips
+        if (bits.size() % 2 == 0)
+            return;
+        break;
+
+      case Enums::secded:
+        {
+            // Single error correction, double error detection per 64
+            // bit word.  Three or more flips in a word may alias a
+            // correctable or clean word and go unnoticed
+            std::map<unsigned, unsigned> flips;
+            for (unsigned i = 0; i < bits.size(); i++)
+                flips[bits[i] / 64]++;
+
+            bool detected = false;
+            unsigned kept = 0;
+            for (unsigned i = 0; i < bits.size(); i++) {
+                unsigned word_flips = flips[bits[i] / 64];
+
+                if (word_flips == 1) {
+                    blk->data[bits[i] / 8] ^= 1 << (bits[i] % 8);
+                    eccCorrected++;
+                    DPRINTF(Cache, "ECC corrected bit %d of block %s\n",
+                            bits[i], blk->print());
+                } else {
+                    detected = detected || word_flips == 2;
+                    bits[kept++] = bits[i];
+                }
+            }
+            bits.resize(kept);
+
+            if (!detected)
+                return;
+        }
+        break;
+
+      default:
+        panic("%s: unknown ECC model %d\n", name(), ecc);
+    }
+
+    eccDetected++;
+    DPRINTF(Cache, "ECC detected an uncorrectable error in block %s\n",
+            blk->print());
+    exitSimLoop("uncorrectable cache error");
 }
 
 unsigned int
@@ -797,6 +875,12 @@ BaseCacheParams::create()
         return new Cache<LRU>(this);
     } else if (dynamic_cast<RandomRepl*>(tags)) {
         return new Cache<RandomRepl>(this);
+    } else if (dynamic_cast<TreePLRU*>(tags)) {
+        return new Cache<TreePLRU>(this);
+    } else if (dynamic_cast<RRIP*>(tags)) {
+        return new Cache<RRIP>(this);
+    } else if (dynamic_cast<SectorTags*>(tags)) {
+        return new Cache<SectorTags>(this);
     } else {
         fatal("No suitable tags selected\n");
     }
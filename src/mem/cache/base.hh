@@ -61,6 +61,7 @@
 #include "base/types.hh"
 #include "debug/Cache.hh"
 #include "debug/CachePort.hh"
+#include "enums/CacheEcc.hh"
 #include "mem/cache/mshr_queue.hh"
 #include "mem/mem_object.hh"
 #include "mem/packet.hh"
@@ -72,6 +73,7 @@
 #include "sim/sim_exit.hh"
 #include "sim/system.hh"
 
+class CacheBlk;
 class MSHR;
 /**
  * A basic cache interface. Implements some common functions for speed.
@@ -295,6 +297,9 @@ class BaseCache : public MemObject
      * side */
     const bool isTopLevel;
 
+    /** Error protection model of the data array */
+    const Enums::CacheEcc ecc;
+
     /**
      * Bit vector of the blocking reasons for the access path.
      * @sa #BlockedCause
@@ -384,6 +389,9 @@ class BaseCache : public MemObject
     /** The number of fast writes (WH64) performed. */
     Stats::Scalar fastWrites;
 
+    /** Number of stores posted and gathered in an MSHR. */
+    Stats::Scalar gatheredStores;
+
     /** The number of cache copies performed. */
     Stats::Scalar cacheCopies;
 
@@ -456,10 +464,24 @@ class BaseCache : public MemObject
 
     Stats::Scalar mshr_no_allocate_misses;
 
+    /** Injected faults corrected by the ECC model */
+    Stats::Scalar eccCorrected;
+    /** Accesses on which the ECC model detected an uncorrectable error */
+    Stats::Scalar eccDetected;
+
     /**
      * @}
      */
 
+    /**
+     * Apply the ECC model to the injected faults of a block whose data is
+     * about to be read.  Correctable faults are undone and an
+     * uncorrectable one ends the simulation.  Faults the model can't see
+     * are left in place.
+     * @param blk A block with faultyBits.
+     */
+    void checkEcc(CacheBlk *blk);
+
     /**
      * Register stats for this object.
      */
@@ -472,6 +494,18 @@ class BaseCache : public MemObject
 
     virtual void init();
 
+    /**
+     * Append every block of the tag store to blks, for the fault
+     * injector.
+     */
+    virtual void getBlocks(std::vector<CacheBlk *> &blks) = 0;
+
+    /**
+     * Tell the tag store that the fault injector changed the tag of a
+     * block returned by getBlocks() so its lookup structures follow.
+     */
+    virtual void blockTagChanged(CacheBlk *blk) = 0;
+
     virtual BaseMasterPort &getMasterPort(const std::string &if_name,
                                           PortID idx = InvalidPortID);
     virtual BaseSlavePort &getSlavePort(const std::string &if_name,
@@ -590,6 +624,16 @@ class BaseCache : public MemObject
 
     virtual bool inMissQueue(Addr addr, bool is_secure) const = 0;
 
+    /**
+     * Occupancy of the MSHRs and write buffers, as a percentage of
+     * their capacity, as a measure of how busy the memory side is.
+     */
+    unsigned missQueueOccupancy() const
+    {
+        return 100 * (mshrQueue.allocated + writeBuffer.allocated) /
+            (mshrQueue.capacity() + writeBuffer.capacity());
+    }
+
     void incMissCount(PacketPtr pkt)
     {
         assert(pkt->req->masterId() < system->maxMasters());
@@ -49,6 +49,7 @@
 #define __CACHE_BLK_HH__
 
 #include <list>
+#include <vector>
 
 #include "base/printable.hh"
 #include "mem/packet.hh"
@@ -126,6 +127,27 @@ class CacheBlk
 
     Tick tickInserted;
 
+    /** When the current contents were brought in.  Unlike tickInserted
+     *  this is not reset by writebacks */
+    Tick tickFilled;
+
+    /** Last read and write of the data since the fill, MaxTick if
+     *  none */
+    Tick tickLastRead;
+    Tick tickLastWrite;
+
+    /** Start of the interval whose contents are still to be read: the
+     *  fill, the last read or the last whole-block overwrite */
+    Tick tickLive;
+
+    /** Ticks of the current residency during which the contents were
+     *  going to be read (ACE), at block granularity */
+    Tick aceTicks;
+
+    /** Offsets, in bits into data, of flips made by injected faults and
+     *  neither overwritten nor corrected since, for the ECC models */
+    std::vector<unsigned> faultyBits;
+
   protected:
     /**
      * Represents that the indicated thread context has a "lock" on
@@ -173,7 +195,8 @@ class CacheBlk
           asid(-1), tag(0), data(0) ,size(0), status(0), whenReady(0),
           set(-1), isTouched(false), refCount(0),
           srcMasterId(Request::invldMasterId),
-          tickInserted(0)
+          tickInserted(0), tickFilled(0), tickLastRead(MaxTick),
+          tickLastWrite(MaxTick), tickLive(0), aceTicks(0)
     {}
 
     /**
@@ -233,9 +256,63 @@ class CacheBlk
     {
         status = 0;
         isTouched = false;
+        faultyBits.clear();
         clearLoadLocks();
     }
 
+    /**
+     * Forget the injected faults in a range of data which has just been
+     * overwritten.
+     * @param offset The first byte overwritten.
+     * @param size The number of bytes overwritten.
+     */
+    void clearFaults(int offset, int size)
+    {
+        unsigned start = offset * 8;
+        unsigned end = (offset + size) * 8;
+        unsigned kept = 0;
+
+        for (unsigned i = 0; i < faultyBits.size(); i++) {
+            if (faultyBits[i] < start || faultyBits[i] >= end)
+                faultyBits[kept++] = faultyBits[i];
+        }
+        faultyBits.resize(kept);
+    }
+
+    /**
+     * Start the AVF accounting of a new residency.
+     */
+    void startResidency()
+    {
+        tickFilled = tickLive = curTick();
+        tickLastRead = tickLastWrite = MaxTick;
+        aceTicks = 0;
+    }
+
+    /**
+     * Account a read of the data: everything since the last read (or
+     * overwrite) was live.
+     */
+    void noteRead()
+    {
+        aceTicks += curTick() - tickLive;
+        tickLive = tickLastRead = curTick();
+    }
+
+    /**
+     * Account a write of the data.  Only an overwrite of the whole
+     * block kills its contents; after a partial write the other bytes
+     * are still live, so it is conservatively ignored.
+     * @param size The number of bytes written.
+     * @param blk_size The size of the block.
+     */
+    void noteWrite(unsigned size, unsigned blk_size)
+    {
+        tickLastWrite = curTick();
+        if (size == blk_size)
+            tickLive = curTick();
+    }
+
     /**
      * Check to see if a block has been written.
      * @return True if the block is dirty.
@@ -39,6 +39,9 @@
 #include "mem/cache/tags/fa_lru.hh"
 #include "mem/cache/tags/lru.hh"
 #include "mem/cache/tags/random_repl.hh"
+#include "mem/cache/tags/rrip.hh"
+#include "mem/cache/tags/sector_tags.hh"
+#include "mem/cache/tags/tree_plru.hh"
 #include "mem/cache/cache_impl.hh"
 
 // Template Instantiations
@@ -47,5 +50,8 @@
 template class Cache<FALRU>;
 template class Cache<LRU>;
 template class Cache<RandomRepl>;
+template class Cache<TreePLRU>;
+template class Cache<RRIP>;
+template class Cache<SectorTags>;
 
 #endif //DOXYGEN_SHOULD_SKIP_THIS
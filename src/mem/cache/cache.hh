@@ -97,6 +97,8 @@ class Cache : public BaseCache
 
         virtual Tick recvAtomic(PacketPtr pkt);
 
+        virtual bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor);
+
         virtual void recvFunctional(PacketPtr pkt);
 
         virtual AddrRangeList getAddrRanges() const;
@@ -190,6 +192,18 @@ class Cache : public BaseCache
      */
     const bool prefetchOnAccess;
 
+    /**
+     * Post stores that miss behind an outstanding store to the same
+     * line, gathering contiguous ones in the MSHR.
+     */
+    const bool gatherStores;
+
+    /**
+     * Write dirty lines directly into the backing store on
+     * memWriteback() rather than sending them down the memory side.
+     */
+    const bool bulkWriteback;
+
     /**
      * @todo this is a temporary workaround until the 4-phase code is committed.
      * upstream caches need this packet until true is returned, so hold it for
@@ -309,6 +323,8 @@ class Cache : public BaseCache
     void memWriteback();
     void memInvalidate();
     bool isDirty() const;
+    void getBlocks(std::vector<CacheBlk *> &blks);
+    void blockTagChanged(CacheBlk *blk);
 
     /**
      * Cache block visitor that writes back dirty cache blocks using
@@ -317,6 +333,17 @@ class Cache : public BaseCache
      * \return Always returns true.
      */
     bool writebackVisitor(BlkType &blk);
+
+    /**
+     * Write back all dirty blocks in one pass sorted by address,
+     * storing them into the physical memory of the system without
+     * going through the memory side port. Lines that are not backed
+     * by physical memory fall back to a functional write.
+     *
+     * @warn Copies of the lines in caches below this one are not
+     * updated, so this is only correct for the last level.
+     */
+    void bulkWritebackBlks();
     /**
      * Cache block visitor that invalidates all blocks in the cache.
      *
@@ -54,6 +54,9 @@
  * Cache definitions.
  */
 
+#include <algorithm>
+#include <utility>
+
 #include "base/misc.hh"
 #include "base/types.hh"
 #include "debug/Cache.hh"
@@ -71,7 +74,9 @@ Cache<TagStore>::Cache(const Params *p)
       tags(dynamic_cast<TagStore*>(p->tags)),
       prefetcher(p->prefetcher),
       doFastWrites(true),
-      prefetchOnAccess(p->prefetch_on_access)
+      prefetchOnAccess(p->prefetch_on_access),
+      gatherStores(p->gather_stores),
+      bulkWriteback(p->bulk_writeback)
 {
     tempBlock = new BlkType();
     tempBlock->data = new uint8_t[blkSize];
@@ -138,8 +143,10 @@ Cache<TagStore>::cmpAndSwap(BlkType *blk, PacketPtr pkt)
             panic("Invalid size for conditional read/write\n");
     }
 
+    blk->noteRead();
     if (overwrite_mem) {
         std::memcpy(blk_data, &overwrite_val, pkt->getSize());
+        blk->noteWrite(pkt->getSize(), blkSize);
         blk->status |= BlkDirty;
     }
 }
@@ -173,6 +180,8 @@ Cache<TagStore>::satisfyCpuSideRequest(PacketPtr pkt, BlkType *blk,
         // Write or WriteInvalidate at the first cache with block in Exclusive
         if (blk->checkWrite(pkt)) {
             pkt->writeDataToBlock(blk->data, blkSize);
+            blk->clearFaults(pkt->getOffset(blkSize), pkt->getSize());
+            blk->noteWrite(pkt->getSize(), blkSize);
         }
         // Always mark the line as dirty even if we are a failed
         // StoreCond so we supply data to any snoops that have
@@ -186,6 +195,7 @@ Cache<TagStore>::satisfyCpuSideRequest(PacketPtr pkt, BlkType *blk,
             blk->trackLoadLocked(pkt);
         }
         pkt->setDataFromBlock(blk->data, blkSize);
+        blk->noteRead();
         if (pkt->getSize() == blkSize) {
             // special handling for coherent block requests from
             // upper-level caches
@@ -355,6 +365,8 @@ Cache<TagStore>::access(PacketPtr pkt, BlkType *&blk,
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
         std::memcpy(blk->data, pkt->getConstPtr<uint8_t>(), blkSize);
+        blk->faultyBits.clear();
+        blk->noteWrite(blkSize, blkSize);
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
         incHitCount(pkt);
         return true;
@@ -363,6 +375,8 @@ Cache<TagStore>::access(PacketPtr pkt, BlkType *&blk,
                                       : blk->isReadable())) {
         // OK to satisfy access
         incHitCount(pkt);
+        if (!blk->faultyBits.empty())
+            checkEcc(blk);
         satisfyCpuSideRequest(pkt, blk);
         return true;
     }
@@ -568,8 +582,11 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
         // hit (for all other request types)
 
         if (prefetcher && (prefetchOnAccess || (blk && blk->wasPrefetched()))) {
-            if (blk)
+            if (blk) {
+                if (blk->wasPrefetched())
+                    prefetcher->prefetchUseful();
                 blk->status &= ~BlkHWPrefetched;
+            }
 
             // Don't notify on SWPrefetch
             if (!pkt->cmd.isSWPrefetch())
@@ -657,6 +674,10 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
             if (pkt) {
                 assert(pkt->req->masterId() < system->maxMasters());
                 mshr_hits[pkt->cmdToIndex()][pkt->req->masterId()]++;
+                // the first demand access joining a prefetch
+                if (prefetcher && mshr->getNumTargets() == 1 &&
+                    mshr->getTarget()->source == MSHR::Target::FromPrefetcher)
+                    prefetcher->prefetchLate();
                 if (mshr->threadNum != 0/*pkt->req->threadId()*/) {
                     mshr->threadNum = -1;
                 }
@@ -665,7 +686,14 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
                 // same address here. It pecifies the latency to allocate an
                 // internal buffer and to schedule an event to the queued
                 // port.
-                mshr->allocateTarget(pkt, clockEdge(forwardLatency), order++);
+                Tick when = clockEdge(forwardLatency);
+                bool posted = gatherStores && isTopLevel &&
+                    mshr->gatherStore(pkt, when, order);
+                if (posted)
+                    gatheredStores++;
+                else
+                    mshr->allocateTarget(pkt, when, order);
+                order++;
                 if (mshr->getNumTargets() == numTarget) {
                     noTargetMSHR = mshr;
                     setBlocked(Blocked_NoTargets);
@@ -687,6 +715,13 @@ Cache<TagStore>::recvTimingReq(PacketPtr pkt)
                     if (!pkt->cmd.isSWPrefetch())
                         next_pf_time = prefetcher->notify(pkt);
                 }
+
+                // the MSHR holds on to the data of a posted store, so
+                // respond to it as if it hit
+                if (posted) {
+                    pkt->makeTimingResponse();
+                    cpuSidePort->schedTimingResp(pkt, clockEdge(lat));
+                }
             }
         } else {
             // no MSHR
@@ -1113,6 +1148,17 @@ Cache<TagStore>::recvTimingResp(PacketPtr pkt)
                 break; // skip response
             }
 
+            // a posted store was responded to when it was gathered,
+            // so all that is left is to write its data
+            if (target->posted) {
+                if (is_fill)
+                    satisfyCpuSideRequest(target->pkt, blk,
+                                          true, mshr->hasPostDowngrade());
+                delete target->pkt->req;
+                delete target->pkt;
+                break;
+            }
+
             // unlike the other packet flows, where data is found in other
             // caches or memory and brought back, write invalidates always
             // have the data right away, so the above check for "is fill?"
@@ -1306,7 +1352,10 @@ Cache<TagStore>::writebackBlk(BlkType *blk)
         writeback->setSupplyExclusive();
     }
     writeback->allocate();
+    if (!blk->faultyBits.empty())
+        checkEcc(blk);
     std::memcpy(writeback->getPtr<uint8_t>(), blk->data, blkSize);
+    blk->noteRead();
 
     blk->status &= ~BlkDirty;
     return writeback;
@@ -1316,6 +1365,11 @@ template<class TagStore>
 void
 Cache<TagStore>::memWriteback()
 {
+    if (bulkWriteback) {
+        bulkWritebackBlks();
+        return;
+    }
+
     WrappedBlkVisitor visitor(*this, &Cache<TagStore>::writebackVisitor);
     tags->forEachBlk(visitor);
 }
@@ -1360,6 +1414,79 @@ Cache<TagStore>::writebackVisitor(BlkType &blk)
     return true;
 }
 
+template<class TagStore>
+void
+Cache<TagStore>::bulkWritebackBlks()
+{
+    std::vector<CacheBlk *> blks;
+    getBlocks(blks);
+
+    std::vector<std::pair<Addr, BlkType *>> dirty;
+    for (auto b : blks) {
+        if (b->isDirty()) {
+            assert(b->isValid());
+            BlkType *blk = static_cast<BlkType *>(b);
+            dirty.emplace_back(tags->regenerateBlkAddr(blk->tag, blk->set),
+                               blk);
+        }
+    }
+
+    // address order keeps the stores into the backing store sequential
+    std::sort(dirty.begin(), dirty.end());
+
+    DPRINTF(Cache, "Bulk writeback of %d dirty blocks\n", dirty.size());
+
+    PhysicalMemory &physmem = system->getPhysMem();
+    for (auto &d : dirty) {
+        BlkType *blk = d.second;
+
+        Request request(d.first, blkSize, 0, Request::funcMasterId);
+        request.taskId(blk->task_id);
+
+        Packet packet(&request, MemCmd::WriteReq);
+        packet.dataStatic(blk->data);
+
+        if (physmem.isMemAddr(d.first))
+            physmem.functionalAccess(&packet);
+        else
+            memSidePort->sendFunctional(&packet);
+
+        blk->status &= ~BlkDirty;
+    }
+}
+
+/** Cache block visitor that collects pointers to all blocks */
+template <typename BlkType>
+class CacheBlkCollector
+{
+  public:
+    CacheBlkCollector(std::vector<CacheBlk *> &_blks) : blks(_blks) {}
+
+    bool operator()(BlkType &blk)
+    {
+        blks.push_back(&blk);
+        return true;
+    }
+
+  private:
+    std::vector<CacheBlk *> &blks;
+};
+
+template<class TagStore>
+void
+Cache<TagStore>::getBlocks(std::vector<CacheBlk *> &blks)
+{
+    CacheBlkCollector<BlkType> collector(blks);
+    tags->forEachBlk(collector);
+}
+
+template<class TagStore>
+void
+Cache<TagStore>::blockTagChanged(CacheBlk *blk)
+{
+    tags->tagChanged(static_cast<BlkType *>(blk));
+}
+
 template<class TagStore>
 bool
 Cache<TagStore>::invalidateVisitor(BlkType &blk)
@@ -1403,6 +1530,19 @@ Cache<TagStore>::allocateBlock(Addr addr, bool is_secure,
 {
     BlkType *blk = tags->findVictim(addr);
 
+    // A sectored tag store also evicts the other valid blocks of the
+    // victim's sector when the sector changes hands.
+    std::vector<BlkType *> siblings;
+    tags->evictionSiblings(addr, blk, siblings);
+    for (auto sib : siblings) {
+        Addr sib_addr = tags->regenerateBlkAddr(sib->tag, sib->set);
+        if (mshrQueue.findMatch(sib_addr, sib->isSecure())) {
+            // too hard to replace a sector with a block in transient
+            // state; allocation failed, block not inserted
+            return NULL;
+        }
+    }
+
     if (blk->isValid()) {
         Addr repl_addr = tags->regenerateBlkAddr(blk->tag, blk->set);
         MSHR *repl_mshr = mshrQueue.findMatch(repl_addr, blk->isSecure());
@@ -1424,9 +1564,25 @@ Cache<TagStore>::allocateBlock(Addr addr, bool is_secure,
                 // Save writeback packet for handling by caller
                 writebacks.push_back(writebackBlk(blk));
             }
+            if (prefetcher && blk->wasPrefetched())
+                prefetcher->prefetchUnused();
         }
     }
 
+    for (auto sib : siblings) {
+        DPRINTF(Cache, "replacement: evicting sector sibling %x (%s): %s\n",
+                tags->regenerateBlkAddr(sib->tag, sib->set),
+                sib->isSecure() ? "s" : "ns",
+                sib->isDirty() ? "writeback" : "clean");
+
+        if (sib->isDirty())
+            writebacks.push_back(writebackBlk(sib));
+        if (prefetcher && sib->wasPrefetched())
+            prefetcher->prefetchUnused();
+        tags->invalidate(sib);
+        sib->invalidate();
+    }
+
     return blk;
 }
 
@@ -1509,6 +1665,7 @@ Cache<TagStore>::handleFill(PacketPtr pkt, BlkType *blk,
     if (pkt->isRead()) {
         assert(pkt->hasData());
         std::memcpy(blk->data, pkt->getConstPtr<uint8_t>(), blkSize);
+        blk->faultyBits.clear();
     }
     // We pay for fillLatency here.
     blk->whenReady = clockEdge() + fillLatency * clockPeriod() +
@@ -1690,6 +1847,7 @@ Cache<TagStore>::handleSnoop(PacketPtr pkt, BlkType *blk,
             pkt->makeAtomicResponse();
             pkt->setDataFromBlock(blk->data, blkSize);
         }
+        blk->noteRead();
     } else if (is_timing && is_deferred) {
         // if it's a deferred timing snoop then we've made a copy of
         // the packet, and so if we're not using that copy to respond
@@ -2119,6 +2277,17 @@ Cache<TagStore>::CpuSidePort::recvAtomic(PacketPtr pkt)
     return cache->recvAtomic(pkt);
 }
 
+template<class TagStore>
+bool
+Cache<TagStore>::CpuSidePort::recvBackdoorReq(Addr addr,
+                                              MemBackdoor &backdoor)
+{
+    // a cache that holds data must see every access
+    if (!cache->system->bypassCaches())
+        return false;
+    return cache->memSidePort->sendBackdoorReq(addr, backdoor);
+}
+
 template<class TagStore>
 void
 Cache<TagStore>::CpuSidePort::recvFunctional(PacketPtr pkt)
@@ -49,6 +49,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -66,7 +67,9 @@ MSHR::MSHR() : readyTime(0), _isUncacheable(false), downstreamPending(false),
                postInvalidate(false), postDowngrade(false),
                queue(NULL), order(0), addr(0),
                size(0), isSecure(false), inService(false),
-               isForward(false), threadNum(InvalidThreadID), data(NULL)
+               isForward(false), threadNum(InvalidThreadID), data(NULL),
+               readyIndex(-1), readySortTime(0), readySeq(0),
+               hashPrev(NULL), hashNext(NULL)
 {
 }
 
@@ -309,6 +312,61 @@ MSHR::allocateTarget(PacketPtr pkt, Tick whenReady, Counter _order)
     }
 }
 
+bool
+MSHR::gatherStore(PacketPtr pkt, Tick whenReady, Counter _order)
+{
+    if (pkt->cmd != MemCmd::WriteReq || pkt->req->isLLSC() ||
+        pkt->req->isLocked() || _isUncacheable || !hasTargets())
+        return false;
+
+    const Target &first = targets.front();
+    if (first.source != Target::FromCPU || !first.pkt->isWrite() ||
+        !first.pkt->needsResponse())
+        return false;
+
+    // the store must not be deferred past the response (see
+    // allocateTarget)
+    if (inService &&
+        (!deferredTargets.empty() || hasPostInvalidate() ||
+         !isPendingDirty() || hasPostDowngrade() || isForward))
+        return false;
+
+    Target &last = targets.back();
+    Addr start = pkt->getAddr();
+    Addr end = start + pkt->getSize();
+    bool merge = last.posted && last.pkt->getAddr() <= end &&
+        start <= last.pkt->getAddr() + last.pkt->getSize();
+    if (merge) {
+        start = std::min(start, last.pkt->getAddr());
+        end = std::max(end, last.pkt->getAddr() + last.pkt->getSize());
+    }
+
+    Request *req = new Request(start, end - start, pkt->req->getFlags(),
+                               pkt->req->masterId());
+    PacketPtr gathered = new Packet(req, MemCmd::WriteReq);
+    gathered->allocate();
+    uint8_t *bytes = gathered->getPtr<uint8_t>();
+
+    if (merge) {
+        std::memcpy(bytes + (last.pkt->getAddr() - start),
+                    last.pkt->getConstPtr<uint8_t>(), last.pkt->getSize());
+        delete last.pkt->req;
+        delete last.pkt;
+        last.pkt = gathered;
+    } else {
+        targets.add(gathered, whenReady, _order, Target::FromCPU, false);
+        targets.back().posted = true;
+    }
+
+    // newer data overwrites the overlap
+    std::memcpy(bytes + (pkt->getAddr() - start),
+                pkt->getConstPtr<uint8_t>(), pkt->getSize());
+
+    DPRINTF(Cache, "%s posted store to %x size %d, gathered %x size %d\n",
+            __func__, pkt->getAddr(), pkt->getSize(), start, end - start);
+    return true;
+}
+
 bool
 MSHR::handleSnoop(PacketPtr pkt, Counter _order)
 {
@@ -52,6 +52,8 @@
 
 #include "base/printable.hh"
 #include "mem/packet.hh"
+#include "sim/event_pool.hh"
+#include "sim/event_pool.hh"
 
 class CacheBlk;
 class MSHRQueue;
@@ -107,18 +109,23 @@ class MSHR : public Packet::SenderState, public Printable
         Source source;  //!< Did request come from cpu, memory, or prefetcher?
         bool markedPending; //!< Did we mark upstream MSHR
                             //!<  as downstreamPending?
+        bool posted; //!< Gathered store the CPU already got a response
+                     //!<  for, owned by the cache
 
         Target(PacketPtr _pkt, Tick _readyTime, Counter _order,
                Source _source, bool _markedPending)
             : recvTime(curTick()), readyTime(_readyTime), order(_order),
-              pkt(_pkt), source(_source), markedPending(_markedPending)
+              pkt(_pkt), source(_source), markedPending(_markedPending),
+              posted(false)
         {}
     };
 
-    class TargetList : public std::list<Target> {
+    class TargetList
+        : public std::list<Target, EventPoolAllocator<Target> > {
+        typedef std::list<Target, EventPoolAllocator<Target> > Base;
         /** Target list iterator. */
-        typedef std::list<Target>::iterator Iterator;
-        typedef std::list<Target>::const_iterator ConstIterator;
+        typedef Base::iterator Iterator;
+        typedef Base::const_iterator ConstIterator;
 
       public:
         bool needsExclusive;
@@ -137,7 +144,7 @@ class MSHR : public Packet::SenderState, public Printable
     };
 
     /** A list of MSHRs. */
-    typedef std::list<MSHR *> List;
+    typedef std::list<MSHR *, EventPoolAllocator<MSHR *> > List;
     /** MSHR list iterator. */
     typedef List::iterator Iterator;
     /** MSHR list const_iterator. */
@@ -194,10 +201,20 @@ class MSHR : public Packet::SenderState, public Printable
     uint8_t *data;
 
     /**
-     * Pointer to this MSHR on the ready list.
-     * @sa MissQueue, MSHRQueue::readyList
+     * Position of this MSHR in the ready heap, -1 if it is not ready.
+     * @sa MSHRQueue::readyHeap
      */
-    Iterator readyIter;
+    int readyIndex;
+
+    /** Ready time this MSHR is ordered by in the ready heap. */
+    Tick readySortTime;
+
+    /** Tie breaker keeping ready MSHRs in insertion order. */
+    Counter readySeq;
+
+    /** Neighbours on the address hash chain of the owning queue. */
+    MSHR *hashPrev;
+    MSHR *hashNext;
 
     /**
      * Pointer to this MSHR on the allocated list.
@@ -239,6 +256,19 @@ class MSHR : public Packet::SenderState, public Printable
      * @param target The target.
      */
     void allocateTarget(PacketPtr target, Tick when, Counter order);
+
+    /**
+     * Try to post a store, gathering it with the last target if that
+     * is a posted store it overlaps or abuts. The data is copied to a
+     * packet owned by the cache, so the caller can respond to the
+     * store straight away. Stores are only posted behind a store that
+     * is still waiting for this MSHR's response, which makes the
+     * posted data visible no later than that store completes.
+     *
+     * @param pkt The store.
+     * @return true if the store was posted
+     */
+    bool gatherStore(PacketPtr pkt, Tick when, Counter order);
     bool handleSnoop(PacketPtr target, Counter order);
 
     /** A simple constructor. */
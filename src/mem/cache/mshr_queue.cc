@@ -45,6 +45,7 @@
  * Definition of MSHRQueue class functions.
  */
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "mem/cache/mshr_queue.hh"
 #include "debug/Drain.hh"
@@ -56,22 +57,53 @@ MSHRQueue::MSHRQueue(const std::string &_label,
                      int _index)
     : label(_label), numEntries(num_entries + reserve - 1),
       numReserve(reserve), demandReserve(demand_reserve),
-      registers(numEntries), drainManager(NULL), allocated(0),
+      registers(numEntries), nextReadySeq(0), frontReadySeq(-1),
+      hashBits(ceilLog2(2 * numEntries)), drainManager(NULL), allocated(0),
       inServiceEntries(0), index(_index)
 {
     for (int i = 0; i < numEntries; ++i) {
         registers[i].queue = this;
         freeList.push_back(&registers[i]);
     }
+
+    readyHeap.reserve(numEntries);
+    HashBucket empty = { NULL, NULL };
+    hashBuckets.assign(1 << hashBits, empty);
+}
+
+void
+MSHRQueue::hashInsert(MSHR *mshr)
+{
+    HashBucket &bucket = hashBuckets[hashIndex(mshr->addr)];
+    mshr->hashPrev = bucket.tail;
+    mshr->hashNext = NULL;
+    if (bucket.tail)
+        bucket.tail->hashNext = mshr;
+    else
+        bucket.head = mshr;
+    bucket.tail = mshr;
+}
+
+void
+MSHRQueue::hashRemove(MSHR *mshr)
+{
+    HashBucket &bucket = hashBuckets[hashIndex(mshr->addr)];
+    if (mshr->hashPrev)
+        mshr->hashPrev->hashNext = mshr->hashNext;
+    else
+        bucket.head = mshr->hashNext;
+    if (mshr->hashNext)
+        mshr->hashNext->hashPrev = mshr->hashPrev;
+    else
+        bucket.tail = mshr->hashPrev;
+    mshr->hashPrev = mshr->hashNext = NULL;
 }
 
 MSHR *
 MSHRQueue::findMatch(Addr addr, bool is_secure) const
 {
-    MSHR::ConstIterator i = allocatedList.begin();
-    MSHR::ConstIterator end = allocatedList.end();
-    for (; i != end; ++i) {
-        MSHR *mshr = *i;
+    MSHR *mshr = hashBuckets[hashIndex(addr)].head;
+    for (; mshr; mshr = mshr->hashNext) {
         if (mshr->addr == addr && mshr->isSecure == is_secure) {
             return mshr;
         }
@@ -85,10 +117,8 @@ MSHRQueue::findMatches(Addr addr, bool is_secure, vector<MSHR*>& matches) const
     // Need an empty vector
     assert(matches.empty());
     bool retval = false;
-    MSHR::ConstIterator i = allocatedList.begin();
-    MSHR::ConstIterator end = allocatedList.end();
-    for (; i != end; ++i) {
-        MSHR *mshr = *i;
+    MSHR *mshr = hashBuckets[hashIndex(addr)].head;
+    for (; mshr; mshr = mshr->hashNext) {
         if (mshr->addr == addr && mshr->isSecure == is_secure) {
             retval = true;
             matches.push_back(mshr);
@@ -102,10 +132,8 @@ bool
 MSHRQueue::checkFunctional(PacketPtr pkt, Addr blk_addr)
 {
     pkt->pushLabel(label);
-    MSHR::ConstIterator i = allocatedList.begin();
-    MSHR::ConstIterator end = allocatedList.end();
-    for (; i != end; ++i) {
-        MSHR *mshr = *i;
+    MSHR *mshr = hashBuckets[hashIndex(blk_addr)].head;
+    for (; mshr; mshr = mshr->hashNext) {
         if (mshr->addr == blk_addr && mshr->checkFunctional(pkt)) {
             pkt->popLabel();
             return true;
@@ -119,40 +147,99 @@ MSHRQueue::checkFunctional(PacketPtr pkt, Addr blk_addr)
 MSHR *
 MSHRQueue::findPending(Addr addr, int size, bool is_secure) const
 {
-    MSHR::ConstIterator i = readyList.begin();
-    MSHR::ConstIterator end = readyList.end();
+    // The heap isn't sorted, so look at every ready entry and keep the
+    // earliest overlapping one.
+    MSHR *earliest = NULL;
+    std::vector<MSHR *>::const_iterator i = readyHeap.begin();
+    std::vector<MSHR *>::const_iterator end = readyHeap.end();
     for (; i != end; ++i) {
         MSHR *mshr = *i;
-        if (mshr->isSecure == is_secure) {
+        if (mshr->isSecure == is_secure &&
+            (!earliest || readyBefore(mshr, earliest))) {
             if (mshr->addr < addr) {
                 if (mshr->addr + mshr->size > addr)
-                    return mshr;
+                    earliest = mshr;
             } else {
                 if (addr + size > mshr->addr)
-                    return mshr;
+                    earliest = mshr;
             }
         }
     }
-    return NULL;
+    return earliest;
 }
 
 
-MSHR::Iterator
-MSHRQueue::addToReadyList(MSHR *mshr)
+void
+MSHRQueue::siftUp(int index)
 {
-    if (readyList.empty() || readyList.back()->readyTime <= mshr->readyTime) {
-        return readyList.insert(readyList.end(), mshr);
+    MSHR *mshr = readyHeap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!readyBefore(mshr, readyHeap[parent]))
+            break;
+        readyHeap[index] = readyHeap[parent];
+        readyHeap[index]->readyIndex = index;
+        index = parent;
     }
+    readyHeap[index] = mshr;
+    mshr->readyIndex = index;
+}
 
-    MSHR::Iterator i = readyList.begin();
-    MSHR::Iterator end = readyList.end();
-    for (; i != end; ++i) {
-        if ((*i)->readyTime > mshr->readyTime) {
-            return readyList.insert(i, mshr);
-        }
+void
+MSHRQueue::siftDown(int index)
+{
+    MSHR *mshr = readyHeap[index];
+    int size = readyHeap.size();
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size &&
+            readyBefore(readyHeap[child + 1], readyHeap[child]))
+            ++child;
+        if (!readyBefore(readyHeap[child], mshr))
+            break;
+        readyHeap[index] = readyHeap[child];
+        readyHeap[index]->readyIndex = index;
+        index = child;
+    }
+    readyHeap[index] = mshr;
+    mshr->readyIndex = index;
+}
+
+void
+MSHRQueue::pushReady(MSHR *mshr)
+{
+    assert(mshr->readyIndex == -1);
+    readyHeap.push_back(mshr);
+    siftUp(readyHeap.size() - 1);
+}
+
+void
+MSHRQueue::addToReadyList(MSHR *mshr)
+{
+    // Entries with the same ready time stay in insertion order. The
+    // ready time is latched here, so later changes to it don't break
+    // the heap, just like they didn't reorder the old sorted list.
+    mshr->readySortTime = mshr->readyTime;
+    mshr->readySeq = nextReadySeq++;
+    pushReady(mshr);
+}
+
+void
+MSHRQueue::removeFromReadyList(MSHR *mshr)
+{
+    int index = mshr->readyIndex;
+    assert(index >= 0 && readyHeap[index] == mshr);
+
+    MSHR *last = readyHeap.back();
+    readyHeap.pop_back();
+    mshr->readyIndex = -1;
+    if (last != mshr) {
+        readyHeap[index] = last;
+        siftUp(index);
+        siftDown(last->readyIndex);
     }
-    assert(false);
-    return end;  // keep stupid compilers happy
 }
 
 
@@ -167,7 +254,8 @@ MSHRQueue::allocate(Addr addr, int size, PacketPtr &pkt,
 
     mshr->allocate(addr, size, pkt, when, order);
     mshr->allocIter = allocatedList.insert(allocatedList.end(), mshr);
-    mshr->readyIter = addToReadyList(mshr);
+    hashInsert(mshr);
+    addToReadyList(mshr);
 
     allocated += 1;
     return mshr;
@@ -184,12 +272,13 @@ MSHR::Iterator
 MSHRQueue::deallocateOne(MSHR *mshr)
 {
     MSHR::Iterator retval = allocatedList.erase(mshr->allocIter);
+    hashRemove(mshr);
     freeList.push_front(mshr);
     allocated--;
     if (mshr->inService) {
         inServiceEntries--;
     } else {
-        readyList.erase(mshr->readyIter);
+        removeFromReadyList(mshr);
     }
     mshr->deallocate();
     if (drainManager && allocated == 0) {
@@ -207,9 +296,10 @@ void
 MSHRQueue::moveToFront(MSHR *mshr)
 {
     if (!mshr->inService) {
-        assert(mshr == *(mshr->readyIter));
-        readyList.erase(mshr->readyIter);
-        mshr->readyIter = readyList.insert(readyList.begin(), mshr);
+        removeFromReadyList(mshr);
+        mshr->readySortTime = 0;
+        mshr->readySeq = frontReadySeq--;
+        pushReady(mshr);
     }
 }
 
@@ -219,7 +309,7 @@ MSHRQueue::markInService(MSHR *mshr, bool pending_dirty_resp)
     if (mshr->markInService(pending_dirty_resp)) {
         deallocate(mshr);
     } else {
-        readyList.erase(mshr->readyIter);
+        removeFromReadyList(mshr);
         inServiceEntries += 1;
     }
 }
@@ -234,7 +324,7 @@ MSHRQueue::markPending(MSHR *mshr)
      * @ todo might want to add rerequests to front of pending list for
      * performance.
      */
-    mshr->readyIter = addToReadyList(mshr);
+    addToReadyList(mshr);
 }
 
 bool
@@ -87,15 +87,57 @@ class MSHRQueue : public Drainable
     std::vector<MSHR> registers;
     /** Holds pointers to all allocated entries. */
     MSHR::List allocatedList;
-    /** Holds pointers to entries that haven't been sent to the bus. */
-    MSHR::List readyList;
+    /**
+     * Entries that haven't been sent to the bus, as a binary min-heap
+     * ordered by the ready time at insertion and then by insertion
+     * order.
+     */
+    std::vector<MSHR *> readyHeap;
+    /** Sequence number of the next entry added to the ready heap. */
+    Counter nextReadySeq;
+    /** Sequence number of the next entry moved to the front. */
+    Counter frontReadySeq;
     /** Holds non allocated entries. */
     MSHR::List freeList;
 
+    /** First and last allocated entry hashing to a bucket. */
+    struct HashBucket
+    {
+        MSHR *head;
+        MSHR *tail;
+    };
+    /**
+     * Allocated entries chained by address, each chain in allocation
+     * order, so lookups by address don't scan every allocated entry.
+     */
+    std::vector<HashBucket> hashBuckets;
+    /** log2 of the number of hash buckets. */
+    unsigned hashBits;
+
     /** Drain manager to inform of a completed drain */
     DrainManager *drainManager;
 
-    MSHR::Iterator addToReadyList(MSHR *mshr);
+    unsigned hashIndex(Addr addr) const
+    {
+        return (addr * ULL(0x9e3779b97f4a7c15)) >> (64 - hashBits);
+    }
+
+    void hashInsert(MSHR *mshr);
+    void hashRemove(MSHR *mshr);
+
+    /** Whether a goes before b on the ready heap. */
+    static bool readyBefore(const MSHR *a, const MSHR *b)
+    {
+        return a->readySortTime < b->readySortTime ||
+            (a->readySortTime == b->readySortTime &&
+             a->readySeq < b->readySeq);
+    }
+
+    void siftUp(int index);
+    void siftDown(int index);
+    void pushReady(MSHR *mshr);
+    void addToReadyList(MSHR *mshr);
+    void removeFromReadyList(MSHR *mshr);
 
 
   public:
@@ -183,7 +225,7 @@ class MSHRQueue : public Drainable
 
     /**
      * Mark the given MSHR as in service. This removes the MSHR from the
-     * readyList or deallocates the MSHR if it does not expect a response.
+     * ready heap or deallocates the MSHR if it does not expect a response.
      *
      * @param mshr The MSHR to mark in service.
      * @param pending_dirty_resp Whether we expect a dirty response
@@ -216,13 +258,16 @@ class MSHRQueue : public Drainable
      */
     bool havePending() const
     {
-        return !readyList.empty();
+        return !readyHeap.empty();
     }
 
     /**
      * Returns true if there are no free entries.
      * @return True if this queue is full.
      */
+    /** The number of entries the queue can hold. */
+    int capacity() const { return numEntries; }
+
     bool isFull() const
     {
         return (allocated > numEntries - numReserve);
@@ -238,20 +283,20 @@ class MSHRQueue : public Drainable
     }
 
     /**
-     * Returns the MSHR at the head of the readyList.
+     * Returns the MSHR at the head of the ready heap.
      * @return The next request to service.
      */
     MSHR *getNextMSHR() const
     {
-        if (readyList.empty() || readyList.front()->readyTime > curTick()) {
+        if (readyHeap.empty() || readyHeap.front()->readyTime > curTick()) {
             return NULL;
         }
-        return readyList.front();
+        return readyHeap.front();
     }
 
     Tick nextMSHRReadyTime() const
     {
-        return readyList.empty() ? MaxTick : readyList.front()->readyTime;
+        return readyHeap.empty() ? MaxTick : readyHeap.front()->readyTime;
     }
 
     unsigned int drain(DrainManager *dm);
@@ -84,6 +84,33 @@ class StridePrefetcher(QueuedPrefetcher):
 
     degree = Param.Int(4, "Number of prefetches to generate")
 
+class StreamPrefetcher(QueuedPrefetcher):
+    type = 'StreamPrefetcher'
+    cxx_class = 'StreamPrefetcher'
+    cxx_header = "mem/cache/prefetch/stream.hh"
+
+    max_conf = Param.Int(7, "Maximum confidence level")
+    thresh_conf = Param.Int(4, "Threshold confidence level")
+    start_conf = Param.Int(4, "Starting confidence for new entries")
+
+    table_sets = Param.Int(16, "Number of sets in PC lookup table")
+    table_assoc = Param.Int(4, "Associativity of PC lookup table")
+    use_master_id = Param.Bool(True, "Use master id based history")
+
+    degree = Param.Int(4, "Initial number of prefetches to generate")
+    min_degree = Param.Int(1, "Lowest degree accuracy throttling picks")
+    max_degree = Param.Int(16, "Highest degree accuracy throttling picks")
+
+    epoch = Param.Unsigned(256, "Prefetch outcomes between throttling "
+                           "decisions")
+    low_accuracy = Param.Percent(40, "Lower the degree below this accuracy")
+    high_accuracy = Param.Percent(75, "Raise the degree above this "
+                                  "accuracy if prefetches are late")
+    late_threshold = Param.Percent(25, "Share of late prefetches that "
+                                   "raises the degree")
+    max_occupancy = Param.Percent(75, "Don't prefetch while the miss "
+                                  "queues are fuller than this")
+
 class TaggedPrefetcher(QueuedPrefetcher):
     type = 'TaggedPrefetcher'
     cxx_class = 'TaggedPrefetcher'
@@ -76,6 +76,28 @@ BasePrefetcher::regStats()
         .name(name() + ".num_hwpf_issued")
         .desc("number of hwpf issued")
         ;
+
+    pfUseful
+        .name(name() + ".pfUseful")
+        .desc("number of demand hits on prefetched blocks")
+        ;
+
+    pfLate
+        .name(name() + ".pfLate")
+        .desc("number of demand misses on prefetches in flight")
+        ;
+
+    pfUnused
+        .name(name() + ".pfUnused")
+        .desc("number of prefetched blocks evicted unused")
+        ;
+
+    pfAccuracy
+        .name(name() + ".pfAccuracy")
+        .desc("fraction of resolved prefetches that were used")
+        ;
+
+    pfAccuracy = (pfUseful + pfLate) / (pfUseful + pfLate + pfUnused);
 }
 
 bool
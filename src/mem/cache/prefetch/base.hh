@@ -105,6 +105,11 @@ class BasePrefetcher : public ClockedObject
 
     Stats::Scalar pfIssued;
 
+    Stats::Scalar pfUseful;
+    Stats::Scalar pfLate;
+    Stats::Scalar pfUnused;
+    Stats::Formula pfAccuracy;
+
   public:
 
     BasePrefetcher(const BasePrefetcherParams *p);
@@ -124,6 +129,15 @@ class BasePrefetcher : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
+    /** A demand access hit a block brought in by a prefetch. */
+    virtual void prefetchUseful() { pfUseful++; }
+
+    /** A demand access missed on a prefetch that is still in flight. */
+    virtual void prefetchLate() { pfLate++; }
+
+    /** A prefetched block was evicted without being accessed. */
+    virtual void prefetchUnused() { pfUnused++; }
+
     virtual void regStats();
 };
 #endif //__MEM_CACHE_PREFETCH_BASE_HH__
@@ -0,0 +1,266 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Stream prefetcher definitions.
+ */
+
+#include <cstdlib>
+
+#include "base/intmath.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/stream.hh"
+#include "mem/cache/base.hh"
+
+StreamPrefetcher::StreamPrefetcher(const StreamPrefetcherParams *p)
+    : QueuedPrefetcher(p),
+      maxConf(p->max_conf),
+      threshConf(p->thresh_conf),
+      startConf(p->start_conf),
+      tableSets(p->table_sets),
+      tableAssoc(p->table_assoc),
+      useMasterId(p->use_master_id),
+      minDegree(p->min_degree),
+      maxDegree(p->max_degree),
+      epochLength(p->epoch),
+      lowAccuracy(p->low_accuracy),
+      highAccuracy(p->high_accuracy),
+      lateThreshold(p->late_threshold),
+      maxOccupancy(p->max_occupancy),
+      table(p->table_sets * p->table_assoc),
+      useCount(0),
+      degree(p->degree),
+      epochUseful(0), epochLate(0), epochUnused(0)
+{
+    // Don't consult stream prefetcher on instruction accesses
+    onInst = false;
+
+    fatal_if(!isPowerOf2(tableSets), "%s: table_sets must be a power "
+             "of 2\n", name());
+    fatal_if(minDegree < 1 || degree < minDegree || degree > maxDegree,
+             "%s: need 1 <= min_degree <= degree <= max_degree\n", name());
+    fatal_if(lowAccuracy > highAccuracy, "%s: low_accuracy is above "
+             "high_accuracy\n", name());
+}
+
+StreamPrefetcher::StreamEntry *
+StreamPrefetcher::lookup(Addr pc, MasterID master_id, bool is_secure,
+                         bool &hit)
+{
+    Addr hash = (pc >> 1) ^ (pc >> (1 + floorLog2(tableSets)));
+    StreamEntry *ways = &table[(hash & (tableSets - 1)) * tableAssoc];
+    StreamEntry *victim = ways;
+
+    for (int w = 0; w < tableAssoc; w++) {
+        StreamEntry *e = &ways[w];
+        if (e->valid && e->pc == pc && e->masterId == master_id &&
+            e->isSecure == is_secure) {
+            hit = true;
+            e->lastUse = ++useCount;
+            return e;
+        }
+
+        // prefer an invalid entry, then the least recently used one
+        if (!e->valid) {
+            if (victim->valid)
+                victim = e;
+        } else if (victim->valid && e->lastUse < victim->lastUse) {
+            victim = e;
+        }
+    }
+
+    hit = false;
+    victim->lastUse = ++useCount;
+    return victim;
+}
+
+void
+StreamPrefetcher::calculatePrefetch(const PacketPtr &pkt,
+                                    std::vector<Addr> &addresses)
+{
+    if (!pkt->req->hasPC()) {
+        DPRINTF(HWPrefetch, "Ignoring request with no PC.\n");
+        return;
+    }
+
+    Addr pkt_addr = pkt->getAddr();
+    Addr blk_addr = pkt_addr & ~(Addr)(blkSize - 1);
+    Addr pc = pkt->req->getPC();
+    bool is_secure = pkt->isSecure();
+    MasterID master_id = useMasterId ? pkt->req->masterId() : 0;
+
+    bool hit;
+    StreamEntry *entry = lookup(pc, master_id, is_secure, hit);
+
+    if (!hit) {
+        DPRINTF(HWPrefetch, "Miss: PC %x pkt_addr %x (%s)\n", pc, pkt_addr,
+                is_secure ? "s" : "ns");
+        entry->pc = pc;
+        entry->masterId = master_id;
+        entry->isSecure = is_secure;
+        entry->valid = true;
+        entry->lastAddr = pkt_addr;
+        entry->frontier = blk_addr;
+        entry->stride = 0;
+        entry->confidence = startConf;
+        return;
+    }
+
+    int new_stride = pkt_addr - entry->lastAddr;
+    bool stride_match = (new_stride == entry->stride);
+
+    if (stride_match && new_stride != 0) {
+        if (entry->confidence < maxConf)
+            entry->confidence++;
+    } else {
+        if (entry->confidence > 0)
+            entry->confidence--;
+        // retrain, and prefetch the new stream from this access on
+        if (entry->confidence < threshConf) {
+            entry->stride = new_stride;
+            entry->frontier = blk_addr;
+        }
+    }
+    entry->lastAddr = pkt_addr;
+
+    DPRINTF(HWPrefetch, "Hit: PC %x pkt_addr %x (%s) stride %d (%s), "
+            "conf %d\n", pc, pkt_addr, is_secure ? "s" : "ns", new_stride,
+            stride_match ? "match" : "change", entry->confidence);
+
+    if (entry->confidence < threshConf || entry->stride == 0)
+        return;
+
+    if (cache->missQueueOccupancy() > maxOccupancy) {
+        pfThrottled++;
+        DPRINTF(HWPrefetch, "Miss queues busy, not prefetching.\n");
+        return;
+    }
+
+    // Round strides up to at least one cache line
+    int stride = entry->stride;
+    if (std::abs(stride) < (int)blkSize)
+        stride = (stride < 0) ? -blkSize : blkSize;
+
+    for (int d = 1; d <= degree; d++) {
+        Addr new_addr = pkt_addr + d * stride;
+        Addr new_blk = new_addr & ~(Addr)(blkSize - 1);
+
+        if (!samePage(pkt_addr, new_addr)) {
+            pfSpanPage += degree - d + 1;
+            DPRINTF(HWPrefetch, "Ignoring page crossing prefetch.\n");
+            break;
+        }
+
+        // skip the lines this stream has asked for already
+        if (stride > 0 ? new_blk <= entry->frontier :
+                         new_blk >= entry->frontier)
+            continue;
+
+        DPRINTF(HWPrefetch, "Queuing prefetch to %#x.\n", new_addr);
+        addresses.push_back(new_addr);
+        entry->frontier = new_blk;
+    }
+}
+
+void
+StreamPrefetcher::prefetchUseful()
+{
+    QueuedPrefetcher::prefetchUseful();
+    epochUseful++;
+    updateDegree();
+}
+
+void
+StreamPrefetcher::prefetchLate()
+{
+    QueuedPrefetcher::prefetchLate();
+    epochLate++;
+    updateDegree();
+}
+
+void
+StreamPrefetcher::prefetchUnused()
+{
+    QueuedPrefetcher::prefetchUnused();
+    epochUnused++;
+    updateDegree();
+}
+
+void
+StreamPrefetcher::updateDegree()
+{
+    unsigned used = epochUseful + epochLate;
+    unsigned total = used + epochUnused;
+    if (total < epochLength)
+        return;
+
+    unsigned accuracy = 100 * used / total;
+    unsigned late = used ? 100 * epochLate / used : 0;
+
+    if (accuracy < lowAccuracy) {
+        if (degree > minDegree) {
+            degree--;
+            degreeDecreases++;
+        }
+    } else if (accuracy >= highAccuracy && late >= lateThreshold) {
+        if (degree < maxDegree) {
+            degree++;
+            degreeIncreases++;
+        }
+    }
+
+    DPRINTF(HWPrefetch, "Epoch: accuracy %d%%, late %d%%, degree %d\n",
+            accuracy, late, degree);
+
+    epochUseful = epochLate = epochUnused = 0;
+}
+
+void
+StreamPrefetcher::regStats()
+{
+    QueuedPrefetcher::regStats();
+
+    pfThrottled
+        .name(name() + ".pfThrottled")
+        .desc("number of confident accesses not prefetched for because "
+              "the miss queues were busy");
+
+    degreeIncreases
+        .name(name() + ".degreeIncreases")
+        .desc("number of epochs that raised the prefetch degree");
+
+    degreeDecreases
+        .name(name() + ".degreeDecreases")
+        .desc("number of epochs that lowered the prefetch degree");
+}
+
+StreamPrefetcher*
+StreamPrefetcherParams::create()
+{
+    return new StreamPrefetcher(this);
+}
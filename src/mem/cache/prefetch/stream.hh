@@ -0,0 +1,132 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a stream prefetcher throttled by its own accuracy.
+ *
+ * Streams are trained per PC like the stride prefetcher, in a flat
+ * set-associative table with LRU replacement. Each stream keeps a
+ * frontier, the last line it asked for, so a confident stream only
+ * queues the lines it has not requested yet. The cache reports
+ * prefetches that were useful, late or evicted unused; at the end of
+ * every epoch the degree is lowered when accuracy is poor and raised
+ * when accurate prefetches arrive late. No prefetches are generated
+ * while the miss queues of the cache are busier than a threshold.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_STREAM_HH__
+#define __MEM_CACHE_PREFETCH_STREAM_HH__
+
+#include <vector>
+
+#include "mem/cache/prefetch/queued.hh"
+#include "params/StreamPrefetcher.hh"
+
+class StreamPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    const int maxConf;
+    const int threshConf;
+    const int startConf;
+
+    const int tableSets;
+    const int tableAssoc;
+
+    const bool useMasterId;
+
+    const int minDegree;
+    const int maxDegree;
+
+    /** Prefetch outcomes per throttling decision */
+    const unsigned epochLength;
+    /** Accuracy (percent) below which the degree is lowered */
+    const unsigned lowAccuracy;
+    /** Accuracy (percent) above which late prefetches raise the degree */
+    const unsigned highAccuracy;
+    /** Share (percent) of late prefetches that raises the degree */
+    const unsigned lateThreshold;
+    /** Miss queue occupancy (percent) above which nothing is generated */
+    const unsigned maxOccupancy;
+
+    struct StreamEntry
+    {
+        StreamEntry() : pc(0), masterId(0), isSecure(false), valid(false),
+                        lastAddr(0), frontier(0), stride(0), confidence(0),
+                        lastUse(0)
+        { }
+
+        Addr pc;
+        MasterID masterId;
+        bool isSecure;
+        bool valid;
+        Addr lastAddr;
+        /** Last line prefetched for this stream */
+        Addr frontier;
+        int stride;
+        int confidence;
+        uint64_t lastUse;
+    };
+
+    /** Stream table, tableAssoc consecutive entries per set */
+    std::vector<StreamEntry> table;
+
+    /** Counter ordering table accesses for LRU replacement */
+    uint64_t useCount;
+
+    /** Prefetches queued per confident access */
+    int degree;
+
+    /** Outcomes seen in the current epoch */
+    unsigned epochUseful;
+    unsigned epochLate;
+    unsigned epochUnused;
+
+    Stats::Scalar pfThrottled;
+    Stats::Scalar degreeIncreases;
+    Stats::Scalar degreeDecreases;
+
+    /** Find the entry of a stream, or a victim for it if absent */
+    StreamEntry *lookup(Addr pc, MasterID master_id, bool is_secure,
+                        bool &hit);
+
+    /** Close the epoch if enough outcomes were seen */
+    void updateDegree();
+
+  public:
+    StreamPrefetcher(const StreamPrefetcherParams *p);
+
+    void calculatePrefetch(const PacketPtr &pkt, std::vector<Addr> &addresses);
+
+    void prefetchUseful();
+    void prefetchLate();
+    void prefetchUnused();
+
+    void regStats();
+};
+
+#endif // __MEM_CACHE_PREFETCH_STREAM_HH__
@@ -71,6 +71,31 @@ class RandomRepl(BaseSetAssoc):
     cxx_class = 'RandomRepl'
     cxx_header = "mem/cache/tags/random_repl.hh"
 
+class TreePLRU(BaseSetAssoc):
+    type = 'TreePLRU'
+    cxx_class = 'TreePLRU'
+    cxx_header = "mem/cache/tags/tree_plru.hh"
+
+class RRIPInsertion(Enum): vals = ['srrip', 'brrip', 'drrip']
+
+class RRIP(BaseSetAssoc):
+    type = 'RRIP'
+    cxx_class = 'RRIP'
+    cxx_header = "mem/cache/tags/rrip.hh"
+    insertion = Param.RRIPInsertion('srrip',
+        "Insertion policy: static, bimodal or dynamic (set dueling)")
+    rrpv_bits = Param.Unsigned(2, "Bits of re-reference prediction value")
+    bip_throttle = Param.Unsigned(32,
+        "Bimodal insertion uses a long interval once in this many misses")
+    leader_sets = Param.Unsigned(32, "Leader sets per policy for DRRIP")
+    psel_bits = Param.Unsigned(10, "Width of the DRRIP policy selector")
+
+class SectorTags(BaseSetAssoc):
+    type = 'SectorTags'
+    cxx_class = 'SectorTags'
+    cxx_header = "mem/cache/tags/sector_tags.hh"
+    sub_blocks = Param.Unsigned(4, "Cache blocks sharing each sector tag")
+
 class FALRU(BaseTags):
     type = 'FALRU'
     cxx_class = 'FALRU'
@@ -50,6 +50,7 @@
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/base.hh"
 #include "sim/sim_exit.hh"
+#include "sim/stats.hh"
 
 using namespace std;
 
@@ -100,6 +101,41 @@ BaseTags::regStats()
 
     avgRefs = totalRefs/sampledRefs;
 
+    residencyTicks
+        .name(name() + ".residency_ticks")
+        .desc("Total ticks valid blocks were resident between fill and"
+              " eviction")
+        ;
+
+    residencies
+        .name(name() + ".residencies")
+        .desc("Number of block residencies in residency_ticks")
+        ;
+
+    avgResidency
+        .name(name() + ".avg_residency")
+        .desc("Average ticks a block was resident")
+        ;
+
+    avgResidency = residencyTicks / residencies;
+
+    vulnerableDirty
+        .name(name() + ".vulnerable_dirty")
+        .desc("Byte-ticks the data of written blocks was going to be read")
+        ;
+
+    vulnerableClean
+        .name(name() + ".vulnerable_clean")
+        .desc("Byte-ticks the data of clean blocks was going to be read")
+        ;
+
+    avf
+        .name(name() + ".avf")
+        .desc("Architectural vulnerability factor of the data array")
+        ;
+
+    avf = (vulnerableDirty + vulnerableClean) / (simTicks * size);
+
     warmupCycle
         .name(name() + ".warmup_cycle")
         .desc("Cycle when the warmup percentage was hit.")
@@ -124,7 +124,7 @@ class BaseTags : public ClockedObject
     Stats::Vector occupanciesTaskId;
 
     /** Occupancy of each context/cpu using the cache */
-    Stats::Vector2d ageTaskId;
+    Stats::SparseVector2d ageTaskId;
 
     /** Occ % of each context/cpu using the cache */
     Stats::Formula percentOccsTaskId;
@@ -134,6 +134,23 @@ class BaseTags : public ClockedObject
     /** Number of data blocks consulted over all accesses. */
     Stats::Scalar dataAccesses;
 
+    /** Ticks valid blocks spent in the cache between fill and eviction,
+     *  for analytical AVF estimates */
+    Stats::Scalar residencyTicks;
+    /** Number of residencies (fills) in residencyTicks */
+    Stats::Scalar residencies;
+    /** Average residency of a block */
+    Stats::Formula avgResidency;
+
+    /** Byte-ticks that the contents of blocks written during their
+     *  residency (or filled by a writeback) were going to be read */
+    Stats::Scalar vulnerableDirty;
+    /** Byte-ticks that the contents of clean blocks were going to be
+     *  read */
+    Stats::Scalar vulnerableClean;
+    /** Fraction of the data array's byte-ticks that were vulnerable */
+    Stats::Formula avf;
+
     /**
      * @}
      */
@@ -81,12 +81,15 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
     // allocate data storage in one big chunk
     numBlocks = numSets * assoc;
     dataBlks = new uint8_t[numBlocks * blkSize];
+    tagArray = new Addr[numBlocks];
 
     unsigned blkIndex = 0;       // index into blks array
     for (unsigned i = 0; i < numSets; ++i) {
         sets[i].assoc = assoc;
 
         sets[i].blks = new BlkType*[assoc];
+        sets[i].ways = &blks[blkIndex];
+        sets[i].tags = &tagArray[blkIndex];
 
         // link in the data blocks
         for (unsigned j = 0; j < assoc; ++j) {
@@ -103,6 +106,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
             // Setting the tag to j is just to prevent long chains in the hash
             // table; won't matter because the block is invalid
             blk->tag = j;
+            tagArray[blk - blks] = j;
             blk->whenReady = 0;
             blk->isTouched = false;
             blk->size = blkSize;
@@ -115,6 +119,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
 BaseSetAssoc::~BaseSetAssoc()
 {
     delete [] dataBlks;
+    delete [] tagArray;
     delete [] blks;
     delete [] sets;
 }
@@ -160,19 +165,26 @@ BaseSetAssoc::cleanupRefs()
         if (blks[i].isValid()) {
             totalRefs += blks[i].refCount;
             ++sampledRefs;
+            endResidency(&blks[i]);
         }
     }
 }
 
+uint64_t
+BaseSetAssoc::hostMemUsage() const
+{
+    return (uint64_t)numBlocks * (sizeof(BlkType) + blkSize + sizeof(Addr)) +
+        (uint64_t)numSets * (sizeof(SetType) + assoc * sizeof(BlkType *));
+}
+
 void
 BaseSetAssoc::computeStats()
 {
     for (unsigned i = 0; i < ContextSwitchTaskId::NumTaskId; ++i) {
         occupanciesTaskId[i] = 0;
-        for (unsigned j = 0; j < 5; ++j) {
-            ageTaskId[i][j] = 0;
-        }
     }
+    // leaves the cells of task ids that never owned a block unallocated
+    ageTaskId.reset();
 
     for (unsigned i = 0; i < numSets * assoc; ++i) {
         if (blks[i].isValid()) {
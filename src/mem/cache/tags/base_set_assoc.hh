@@ -99,6 +99,8 @@ class BaseSetAssoc : public BaseTags
     BlkType *blks;
     /** The data blocks, 1 per cache block. */
     uint8_t *dataBlks;
+    /** The tag of each cache block, indexed like blks. */
+    Addr *tagArray;
 
     /** The amount to shift the address to get the set. */
     int setShift;
@@ -154,6 +156,7 @@ public:
         assert(blk);
         assert(blk->isValid());
         tagsInUse--;
+        endResidency(blk);
         assert(blk->srcMasterId < cache->system->maxMasters());
         occupancies[blk->srcMasterId]--;
         blk->srcMasterId = Request::invldMasterId;
@@ -221,6 +224,16 @@ public:
      * @param addr The addr to a find a replacement candidate for.
      * @return The candidate block.
      */
+    /**
+     * Resynchronise the tag array after blk->tag was changed behind the
+     * tag store's back (e.g. by the fault injector).
+     * @param blk The block whose tag changed.
+     */
+    void tagChanged(BlkType *blk)
+    {
+        tagArray[blk - blks] = blk->tag;
+    }
+
     BlkType* findVictim(Addr addr) const
     {
         BlkType *blk = NULL;
@@ -237,6 +250,19 @@ public:
         return blk;
     }
 
+    /**
+     * Find the other blocks that must leave the cache when the victim
+     * is replaced by the block at addr.  Only sectored tag stores have
+     * any.
+     * @param addr The address of the block being allocated.
+     * @param victim The block returned by findVictim().
+     * @param siblings The blocks to evict are appended here.
+     */
+    void evictionSiblings(Addr addr, const BlkType *victim,
+                          std::vector<BlkType *> &siblings) const
+    {
+    }
+
     /**
      * Insert the new block into the cache.
      * @param pkt Packet holding the address to update
@@ -268,6 +294,7 @@ public:
              blk->refCount = 0;
 
              // deal with evicted block
+             endResidency(blk);
              assert(blk->srcMasterId < cache->system->maxMasters());
              occupancies[blk->srcMasterId]--;
 
@@ -278,6 +305,7 @@ public:
 
          // Set tag for new block.  Caller is responsible for setting status.
          blk->tag = extractTag(addr);
+         tagArray[blk - blks] = blk->tag;
 
          // deal with what we are bringing in
          assert(master_id < cache->system->maxMasters());
@@ -285,12 +313,33 @@ public:
          blk->srcMasterId = master_id;
          blk->task_id = task_id;
          blk->tickInserted = curTick();
+         blk->startResidency();
 
          // We only need to write into one tag and one data block.
          tagAccesses += 1;
          dataAccesses += 1;
      }
 
+    /**
+     * Account the residency of a valid block which is leaving the cache
+     * (or is still in it when the simulation ends).  Dirty contents
+     * which were not written back are live to the end.
+     * @param blk The block.
+     */
+    void endResidency(const BlkType *blk)
+    {
+        residencyTicks += curTick() - blk->tickFilled;
+        ++residencies;
+
+        Tick ace = blk->aceTicks;
+        if (blk->isDirty())
+            ace += curTick() - blk->tickLive;
+        if (blk->tickLastWrite != MaxTick)
+            vulnerableDirty += ace * blkSize;
+        else
+            vulnerableClean += ace * blkSize;
+    }
+
     /**
      * Generate the tag from the given address.
      * @param addr The address to get the tag from.
@@ -363,6 +412,11 @@ public:
      */
     virtual void computeStats();
 
+    /**
+     * The blocks with their data and tags, and the sets.
+     */
+    virtual uint64_t hostMemUsage() const;
+
     /**
      * Visit each block in the tag store and apply a visitor to the
      * block.
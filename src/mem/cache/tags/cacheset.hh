@@ -65,6 +65,16 @@ class CacheSet
     /** Cache blocks in this set, maintained in LRU order 0 = MRU. */
     Blktype **blks;
 
+    /** The blocks of this set in way order; not reordered on access. */
+    Blktype *ways;
+
+    /**
+     * The tags of this set in way order, tags[i] == ways[i].tag.  Kept
+     * contiguous so a lookup compares tags without touching the blocks
+     * of the ways that cannot match.
+     */
+    Addr *tags;
+
     /**
      * Find a block matching the tag in this set.
      * @param way_id The id of the way that matches the tag.
@@ -112,8 +122,29 @@ template <class Blktype>
 Blktype*
 CacheSet<Blktype>::findBlk(Addr tag, bool is_secure) const
 {
-    int ignored_way_id;
-    return findBlk(tag, is_secure, ignored_way_id);
+    // Scan the whole tag array rather than stopping at the first hit,
+    // which keeps the compare loop free of data-dependent exits; the
+    // block state is only read for the ways whose tag matches.
+    Blktype *found = NULL;
+    int matches = 0;
+    for (int i = 0; i < assoc; ++i) {
+        if (tags[i] == tag) {
+            Blktype *blk = &ways[i];
+            if (blk->isValid() && blk->isSecure() == is_secure) {
+                found = blk;
+                ++matches;
+            }
+        }
+    }
+
+    // Several valid copies of a tag can only appear after an injected
+    // tag fault; return the most recently used one as the LRU-ordered
+    // search does.
+    if (matches > 1) {
+        int ignored_way_id;
+        return findBlk(tag, is_secure, ignored_way_id);
+    }
+    return found;
 }
 
 template <class Blktype>
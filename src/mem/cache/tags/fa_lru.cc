@@ -115,6 +115,14 @@ FALRU::~FALRU()
     delete[] blks;
 }
 
+uint64_t
+FALRU::hostMemUsage() const
+{
+    return (uint64_t)numBlocks * (sizeof(FALRUBlk) + blkSize) +
+        tagHash.size() * (sizeof(hash_t::value_type) + sizeof(void *)) +
+        tagHash.bucket_count() * sizeof(void *);
+}
+
 void
 FALRU::regStats()
 {
@@ -247,6 +255,21 @@ FALRU::insertBlock(PacketPtr pkt, FALRU::BlkType *blk)
 {
 }
 
+void
+FALRU::tagChanged(FALRU::BlkType *blk)
+{
+    // The old tag is gone, so look the block up by value; this is only
+    // used by the fault injector.
+    for (hash_t::iterator i = tagHash.begin(); i != tagHash.end(); ++i) {
+        if (i->second == blk) {
+            tagHash.erase(i);
+            break;
+        }
+    }
+    if (tagHash.find(blk->tag) == tagHash.end())
+        tagHash[blk->tag] = blk;
+}
+
 void
 FALRU::moveToHead(FALRUBlk *blk)
 {
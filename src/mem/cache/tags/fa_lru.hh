@@ -209,6 +209,22 @@ public:
 
     void insertBlock(PacketPtr pkt, BlkType *blk);
 
+    /**
+     * Blocks are replaced one at a time, so there are never other
+     * blocks to evict with a victim.
+     */
+    void evictionSiblings(Addr addr, const BlkType *victim,
+                          std::vector<BlkType *> &siblings) const
+    {
+    }
+
+    /**
+     * Rehash a block whose tag was changed behind the tag store's back
+     * (e.g. by the fault injector).
+     * @param blk The block whose tag changed.
+     */
+    void tagChanged(BlkType *blk);
+
     /**
      * Return the block size of this cache.
      * @return The block size.
@@ -292,6 +308,11 @@ public:
      */
     virtual std::string print() const { return ""; }
 
+    /**
+     * The blocks with their data, and the address hash table.
+     */
+    virtual uint64_t hostMemUsage() const;
+
     /**
      * Visit each block in the tag store and apply a visitor to the
      * block.
@@ -0,0 +1,198 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a re-reference interval prediction (RRIP) tag store.
+ */
+
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/random.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/tags/rrip.hh"
+#include "mem/cache/base.hh"
+
+RRIP::RRIP(const Params *p)
+    : BaseSetAssoc(p), insertion(p->insertion),
+      numRRPV(1 << p->rrpv_bits), maxRRPV(numRRPV - 1),
+      bipThrottle(p->bip_throttle), leaderStride(0),
+      pselMax((1 << p->psel_bits) - 1),
+      rrpvMasks(numSets * numRRPV, 0)
+{
+    if (assoc > 64)
+        fatal("%s: RRIP supports at most 64 ways\n", name());
+    if (p->rrpv_bits < 1 || p->rrpv_bits > 8)
+        fatal("%s: rrpv_bits must be between 1 and 8\n", name());
+    if (bipThrottle == 0)
+        fatal("%s: bip_throttle must be non-zero\n", name());
+    if (p->psel_bits < 1 || p->psel_bits > 31)
+        fatal("%s: psel_bits must be between 1 and 31\n", name());
+
+    psel = (pselMax + 1) / 2;
+
+    if (insertion == Enums::drrip) {
+        unsigned leaders = std::min<unsigned>(p->leader_sets, numSets / 2);
+        if (leaders == 0)
+            fatal("%s: DRRIP needs at least two sets\n", name());
+        leaderStride = numSets / leaders;
+    }
+
+    // every way starts out predicted as distant
+    uint64_t all_ways = assoc == 64 ? ~ULL(0) : (ULL(1) << assoc) - 1;
+    for (unsigned i = 0; i < numSets; ++i)
+        masks(i)[maxRRPV] = all_ways;
+}
+
+unsigned
+RRIP::highestRRPV(int set) const
+{
+    const uint64_t *m = masks(set);
+    unsigned rrpv = maxRRPV;
+    while (m[rrpv] == 0) {
+        assert(rrpv > 0);
+        --rrpv;
+    }
+    return rrpv;
+}
+
+void
+RRIP::setRRPV(int set, int way, unsigned rrpv)
+{
+    uint64_t *m = masks(set);
+    uint64_t bit = ULL(1) << way;
+    for (unsigned i = 0; i < numRRPV; ++i)
+        m[i] &= ~bit;
+    m[rrpv] |= bit;
+}
+
+void
+RRIP::age(int set)
+{
+    uint64_t *m = masks(set);
+    unsigned shift = maxRRPV - highestRRPV(set);
+    if (shift == 0)
+        return;
+
+    // the levels above the highest occupied one are empty, so nothing
+    // saturates
+    for (unsigned i = maxRRPV; i >= shift; --i)
+        m[i] = m[i - shift];
+    for (unsigned i = 0; i < shift; ++i)
+        m[i] = 0;
+}
+
+bool
+RRIP::useBimodal(int set) const
+{
+    switch (insertion) {
+      case Enums::srrip:
+        return false;
+      case Enums::brrip:
+        return true;
+      case Enums::drrip:
+        if (set % leaderStride == 0)
+            return false;
+        if (set % leaderStride == 1)
+            return true;
+        return psel > pselMax / 2;
+      default:
+        panic("Unknown RRIP insertion policy\n");
+    }
+}
+
+BaseSetAssoc::BlkType*
+RRIP::accessBlock(Addr addr, bool is_secure, Cycles &lat, int master_id)
+{
+    BlkType *blk = BaseSetAssoc::accessBlock(addr, is_secure, lat, master_id);
+
+    // hit priority: a re-referenced block is predicted near-immediate
+    if (blk != NULL)
+        setRRPV(blk->set, wayOf(blk), 0);
+
+    return blk;
+}
+
+BaseSetAssoc::BlkType*
+RRIP::findVictim(Addr addr) const
+{
+    BlkType *blk = BaseSetAssoc::findVictim(addr);
+
+    // if all blocks are valid, evict the first way with the largest
+    // RRPV; insertBlock() ages the set to match
+    if (blk->isValid()) {
+        int set = extractSet(addr);
+        int way = findLsbSet(masks(set)[highestRRPV(set)]);
+        blk = &sets[set].ways[way];
+
+        DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
+                set, regenerateBlkAddr(blk->tag, set));
+    }
+
+    return blk;
+}
+
+void
+RRIP::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    int set = blk->set;
+
+    if (blk->isValid())
+        age(set);
+
+    BaseSetAssoc::insertBlock(pkt, blk);
+
+    // a miss in a leader set votes against that set's policy
+    if (insertion == Enums::drrip) {
+        if (set % leaderStride == 0 && psel < pselMax)
+            ++psel;
+        else if (set % leaderStride == 1 && psel > 0)
+            --psel;
+    }
+
+    // bimodal insertion predicts a long interval only once in a while
+    unsigned rrpv = maxRRPV - 1;
+    if (useBimodal(set) && random_mt.random<unsigned>(0, bipThrottle - 1))
+        rrpv = maxRRPV;
+    setRRPV(set, wayOf(blk), rrpv);
+}
+
+void
+RRIP::invalidate(BlkType *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+
+    // should be evicted before valid blocks
+    setRRPV(blk->set, wayOf(blk), maxRRPV);
+}
+
+RRIP*
+RRIPParams::create()
+{
+    return new RRIP(this);
+}
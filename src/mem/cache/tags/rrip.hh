@@ -0,0 +1,116 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a re-reference interval prediction (RRIP) tag store.
+ * Every block has a re-reference prediction value (RRPV); hits set it
+ * to zero and the victim is a block with the largest RRPV.  Each set
+ * keeps one bit vector of ways per RRPV, so updates and the victim
+ * search cost a handful of word operations whatever the associativity.
+ * Insertion follows static (SRRIP), bimodal (BRRIP) or dynamic (DRRIP,
+ * set dueling between the two) policy.
+ */
+
+#ifndef __MEM_CACHE_TAGS_RRIP_HH__
+#define __MEM_CACHE_TAGS_RRIP_HH__
+
+#include <vector>
+
+#include "enums/RRIPInsertion.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "params/RRIP.hh"
+
+class RRIP : public BaseSetAssoc
+{
+  protected:
+    /** The insertion policy. */
+    const Enums::RRIPInsertion insertion;
+
+    /** Number of RRPVs, 2^rrpv_bits. */
+    const unsigned numRRPV;
+    /** The RRPV of a block that is predicted not to be re-referenced. */
+    const unsigned maxRRPV;
+
+    /** BRRIP inserts one block in this many with a long RRPV. */
+    const unsigned bipThrottle;
+
+    /** Distance between the leader sets of DRRIP. */
+    unsigned leaderStride;
+    /** Saturating counter choosing the policy of the DRRIP followers. */
+    unsigned psel;
+    /** Largest value of psel. */
+    const unsigned pselMax;
+
+    /**
+     * The ways of each set holding each RRPV; the bit vectors of set s
+     * start at rrpvMasks[s * numRRPV].
+     */
+    std::vector<uint64_t> rrpvMasks;
+
+    uint64_t *masks(int set) { return &rrpvMasks[set * numRRPV]; }
+    const uint64_t *masks(int set) const
+    { return &rrpvMasks[set * numRRPV]; }
+
+    /** Way of a block within its set. */
+    int wayOf(const BlkType *blk) const
+    { return blk - sets[blk->set].ways; }
+
+    /** Largest RRPV held by any way of the set. */
+    unsigned highestRRPV(int set) const;
+
+    /** Give a way a new RRPV. */
+    void setRRPV(int set, int way, unsigned rrpv);
+
+    /** Age every way of the set until one reaches maxRRPV. */
+    void age(int set);
+
+    /** Whether a miss in the set inserts with the bimodal policy. */
+    bool useBimodal(int set) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef RRIPParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    RRIP(const Params *p);
+
+    /**
+     * Destructor
+     */
+    ~RRIP() {}
+
+    BlkType* accessBlock(Addr addr, bool is_secure, Cycles &lat,
+                         int context_src);
+    BlkType* findVictim(Addr addr) const;
+    void insertBlock(PacketPtr pkt, BlkType *blk);
+    void invalidate(BlkType *blk);
+};
+
+#endif // __MEM_CACHE_TAGS_RRIP_HH__
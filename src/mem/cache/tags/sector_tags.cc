@@ -0,0 +1,148 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a sectored tag store.
+ */
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/tags/sector_tags.hh"
+#include "mem/cache/base.hh"
+
+SectorTags::SectorTags(const Params *p)
+    : BaseSetAssoc(p), subBlocks(p->sub_blocks),
+      subBits(isPowerOf2(p->sub_blocks) ? floorLog2(p->sub_blocks) : 0),
+      sectorTouch(numSets * assoc / std::max(p->sub_blocks, 1U), 0),
+      touchCount(0)
+{
+    if (subBlocks == 0 || !isPowerOf2(subBlocks))
+        fatal("%s: sub_blocks must be a non-zero power of 2\n", name());
+    if (numSets < subBlocks)
+        fatal("%s: %d sets of blocks cannot hold sectors of %d blocks\n",
+              name(), numSets, subBlocks);
+}
+
+bool
+SectorTags::sectorHolds(int sector_set, int way, Addr tag) const
+{
+    for (unsigned i = 0; i < subBlocks; ++i) {
+        const BlkType *blk = subBlock(sector_set, way, i);
+        if (blk->isValid() && blk->tag == tag)
+            return true;
+    }
+    return false;
+}
+
+bool
+SectorTags::sectorEmpty(int sector_set, int way) const
+{
+    for (unsigned i = 0; i < subBlocks; ++i) {
+        if (subBlock(sector_set, way, i)->isValid())
+            return false;
+    }
+    return true;
+}
+
+BaseSetAssoc::BlkType*
+SectorTags::accessBlock(Addr addr, bool is_secure, Cycles &lat,
+                        int master_id)
+{
+    BlkType *blk = BaseSetAssoc::accessBlock(addr, is_secure, lat, master_id);
+
+    if (blk != NULL)
+        touch(blk);
+
+    return blk;
+}
+
+BaseSetAssoc::BlkType*
+SectorTags::findVictim(Addr addr) const
+{
+    int set = extractSet(addr);
+    int sector_set = set >> subBits;
+    Addr tag = extractTag(addr);
+
+    // a sector already holding the tag only needs the missing sub-block
+    for (int i = 0; i < assoc; ++i) {
+        if (sectorHolds(sector_set, i, tag))
+            return &sets[set].ways[i];
+    }
+
+    // prefer to allocate an empty sector, then the least recently used
+    const uint64_t *touched = &sectorTouch[sector_set * assoc];
+    int way = 0;
+    for (int i = 0; i < assoc; ++i) {
+        if (sectorEmpty(sector_set, i))
+            return &sets[set].ways[i];
+        if (touched[i] < touched[way])
+            way = i;
+    }
+
+    BlkType *blk = &sets[set].ways[way];
+    DPRINTF(CacheRepl, "set %x: selecting sector of blk %x for "
+            "replacement\n", set, regenerateBlkAddr(blk->tag, set));
+    return blk;
+}
+
+void
+SectorTags::evictionSiblings(Addr addr, const BlkType *victim,
+                             std::vector<BlkType *> &siblings) const
+{
+    int sector_set = victim->set >> subBits;
+    int way = wayOf(victim);
+    Addr tag = extractTag(addr);
+
+    for (unsigned i = 0; i < subBlocks; ++i) {
+        BlkType *blk = subBlock(sector_set, way, i);
+        if (blk != victim && blk->isValid() && blk->tag != tag)
+            siblings.push_back(blk);
+    }
+}
+
+void
+SectorTags::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    BaseSetAssoc::insertBlock(pkt, blk);
+
+    touch(blk);
+}
+
+void
+SectorTags::invalidate(BlkType *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+}
+
+SectorTags*
+SectorTagsParams::create()
+{
+    return new SectorTags(this);
+}
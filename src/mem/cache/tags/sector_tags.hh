@@ -0,0 +1,108 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a sectored tag store.
+ * A sector of sub_blocks consecutive cache blocks shares one tag entry.
+ * Every block of a sector (a sub-block) keeps its own valid, dirty and
+ * coherence state, is filled on its own when it misses and is written
+ * back on its own when dirty.  Only allocating a sector for a new tag
+ * evicts the sub-blocks of the previous one.
+ *
+ * The sub-blocks of way w in sector set s live in way w of the block
+ * sets (s << log2(sub_blocks)) + i, so the block addressing is that of
+ * BaseSetAssoc, and a miss in a sector that holds the tag only fills
+ * the missing sub-block.  Sectors are replaced in LRU order.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+#define __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+
+#include <vector>
+
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "params/SectorTags.hh"
+
+class SectorTags : public BaseSetAssoc
+{
+  protected:
+    /** Number of blocks in a sector. */
+    const unsigned subBlocks;
+    /** log2(subBlocks). */
+    const unsigned subBits;
+
+    /** When each sector was last used, indexed by sector set * assoc. */
+    std::vector<uint64_t> sectorTouch;
+    /** Source of sectorTouch values. */
+    uint64_t touchCount;
+
+    /** Way of a block within its set, and thus within its sector set. */
+    int wayOf(const BlkType *blk) const
+    { return blk - sets[blk->set].ways; }
+
+    /** Sub-block of a sector. */
+    BlkType *subBlock(int sector_set, int way, unsigned sub) const
+    { return &sets[(sector_set << subBits) | sub].ways[way]; }
+
+    /** Whether a valid sub-block of the sector carries the tag. */
+    bool sectorHolds(int sector_set, int way, Addr tag) const;
+
+    /** Whether the sector has no valid sub-block. */
+    bool sectorEmpty(int sector_set, int way) const;
+
+    /** Mark the sector of a block as most recently used. */
+    void touch(const BlkType *blk)
+    {
+        int sector_set = blk->set >> subBits;
+        sectorTouch[sector_set * assoc + wayOf(blk)] = ++touchCount;
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef SectorTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    SectorTags(const Params *p);
+
+    /**
+     * Destructor
+     */
+    ~SectorTags() {}
+
+    BlkType* accessBlock(Addr addr, bool is_secure, Cycles &lat,
+                         int context_src);
+    BlkType* findVictim(Addr addr) const;
+    void evictionSiblings(Addr addr, const BlkType *victim,
+                          std::vector<BlkType *> &siblings) const;
+    void insertBlock(PacketPtr pkt, BlkType *blk);
+    void invalidate(BlkType *blk);
+};
+
+#endif // __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
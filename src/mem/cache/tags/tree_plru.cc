@@ -0,0 +1,118 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a tree pseudo-LRU tag store.
+ */
+
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/tags/tree_plru.hh"
+#include "mem/cache/base.hh"
+
+TreePLRU::TreePLRU(const Params *p)
+    : BaseSetAssoc(p), treeBits(numSets, 0),
+      levels(isPowerOf2(assoc) ? floorLog2(assoc) : 0)
+{
+    if (!isPowerOf2(assoc) || assoc > 64)
+        fatal("%s: tree PLRU needs a power of 2 associativity of at most "
+              "64\n", name());
+}
+
+void
+TreePLRU::touch(int set, int way, bool victim)
+{
+    uint64_t &bits = treeBits[set];
+    int node = 0;
+    for (int level = levels - 1; level >= 0; --level) {
+        uint64_t right = (way >> level) & 1;
+        // A set bit sends the victim search to the right subtree.
+        uint64_t point = victim ? right : !right;
+        bits = (bits & ~(ULL(1) << node)) | (point << node);
+        node = 2 * node + 1 + right;
+    }
+}
+
+BaseSetAssoc::BlkType*
+TreePLRU::accessBlock(Addr addr, bool is_secure, Cycles &lat, int master_id)
+{
+    BlkType *blk = BaseSetAssoc::accessBlock(addr, is_secure, lat, master_id);
+
+    if (blk != NULL)
+        touch(blk->set, wayOf(blk), false);
+
+    return blk;
+}
+
+BaseSetAssoc::BlkType*
+TreePLRU::findVictim(Addr addr) const
+{
+    BlkType *blk = BaseSetAssoc::findVictim(addr);
+
+    // if all blocks are valid, follow the tree to the PLRU way
+    if (blk->isValid()) {
+        int set = extractSet(addr);
+        uint64_t bits = treeBits[set];
+        int node = 0;
+        int way = 0;
+        for (int level = 0; level < levels; ++level) {
+            int right = (bits >> node) & 1;
+            way = (way << 1) | right;
+            node = 2 * node + 1 + right;
+        }
+        blk = &sets[set].ways[way];
+
+        DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
+                set, regenerateBlkAddr(blk->tag, set));
+    }
+
+    return blk;
+}
+
+void
+TreePLRU::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    BaseSetAssoc::insertBlock(pkt, blk);
+
+    touch(blk->set, wayOf(blk), false);
+}
+
+void
+TreePLRU::invalidate(BlkType *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+
+    // should be evicted before valid blocks
+    touch(blk->set, wayOf(blk), true);
+}
+
+TreePLRU*
+TreePLRUParams::create()
+{
+    return new TreePLRU(this);
+}
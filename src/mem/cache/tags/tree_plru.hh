@@ -0,0 +1,88 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a tree pseudo-LRU tag store.
+ * Each set keeps a binary tree of assoc - 1 bits.  Every internal node
+ * points at the half of the set that was used least recently, so both
+ * an update and the victim search walk log2(assoc) nodes instead of
+ * reordering the whole set like LRU does.
+ */
+
+#ifndef __MEM_CACHE_TAGS_TREE_PLRU_HH__
+#define __MEM_CACHE_TAGS_TREE_PLRU_HH__
+
+#include <vector>
+
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "params/TreePLRU.hh"
+
+class TreePLRU : public BaseSetAssoc
+{
+  protected:
+    /** Tree bits of each set; node n has children 2n + 1 and 2n + 2. */
+    std::vector<uint64_t> treeBits;
+
+    /** Number of tree levels, log2(assoc). */
+    const unsigned levels;
+
+    /** Way of a block within its set. */
+    int wayOf(const BlkType *blk) const
+    { return blk - sets[blk->set].ways; }
+
+    /**
+     * Point every node on the path to a way towards or away from it.
+     * @param set The set to update.
+     * @param way The way whose path is updated.
+     * @param victim True to make the way the next victim, false to
+     * mark it as most recently used.
+     */
+    void touch(int set, int way, bool victim);
+
+  public:
+    /** Convenience typedef. */
+    typedef TreePLRUParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    TreePLRU(const Params *p);
+
+    /**
+     * Destructor
+     */
+    ~TreePLRU() {}
+
+    BlkType* accessBlock(Addr addr, bool is_secure, Cycles &lat,
+                         int context_src);
+    BlkType* findVictim(Addr addr) const;
+    void insertBlock(PacketPtr pkt, BlkType *blk);
+    void invalidate(BlkType *blk);
+};
+
+#endif // __MEM_CACHE_TAGS_TREE_PLRU_HH__
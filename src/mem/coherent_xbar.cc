@@ -98,7 +98,7 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
     if (snoopFilter)
         snoopFilter->setSlavePorts(slavePorts);
 
-    clearPortCache();
+    clearRouteCache();
 }
 
 CoherentXBar::~CoherentXBar()
@@ -536,6 +536,20 @@ CoherentXBar::recvRetry(PortID master_port_id)
     reqLayers[master_port_id]->recvRetry();
 }
 
+bool
+CoherentXBar::recvBackdoorReq(Addr addr, MemBackdoor &backdoor,
+                              PortID slave_port_id)
+{
+    if (!system->bypassCaches()) {
+        for (const auto& p: snoopPorts) {
+            if (p != slavePorts[slave_port_id])
+                return false;
+        }
+    }
+
+    return forwardBackdoorReq(addr, backdoor);
+}
+
 Tick
 CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
 {
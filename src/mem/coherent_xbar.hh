@@ -122,6 +122,12 @@ class CoherentXBar : public BaseXBar
         virtual Tick recvAtomic(PacketPtr pkt)
         { return xbar.recvAtomic(pkt, id); }
 
+        /**
+         * When receiving a backdoor request, pass it to the crossbar.
+         */
+        virtual bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor)
+        { return xbar.recvBackdoorReq(addr, backdoor, id); }
+
         /**
          * When receiving a functional request, pass it to the crossbar.
          */
@@ -322,6 +328,13 @@ class CoherentXBar : public BaseXBar
       transaction.*/
     Tick recvAtomic(PacketPtr pkt, PortID slave_port_id);
 
+    /** Function called by the port when the crossbar is receiving a
+        backdoor request. Only granted when bypassing the caches or
+        nothing but the requester snoops, as accesses through the
+        backdoor snoop no one. */
+    bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor,
+                         PortID slave_port_id);
+
     /** Function called by the port when the crossbar is recieving an
         atomic snoop transaction.*/
     Tick recvAtomicSnoop(PacketPtr pkt, PortID master_port_id);
@@ -81,7 +81,8 @@ CommMonitor::CommMonitor(Params* params)
                                       (params->trace_compress ? ".gz" : ""));
         }
 
-        traceStream = new ProtoOutputStream(filename);
+        traceStream = new ProtoOutputStream(filename,
+                                            params->trace_background);
 
         // Create a protobuf message for the header and write it to
         // the stream
@@ -252,12 +253,12 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
 
         // Get sample of burst length
         if (!stats.disableBurstLengthHists) {
-            stats.readBurstLengthHist.sample(size);
+            stats.readBurstLengths.sample(size);
         }
 
         // Sample the masked address
         if (!stats.disableAddrDists) {
-            stats.readAddrDist.sample(addr & readAddrMask);
+            stats.readAddrs.sample(addr & readAddrMask);
         }
 
         // If it needs a response increment number of outstanding read
@@ -269,13 +270,13 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
         if (!stats.disableITTDists) {
             // Sample value of read-read inter transaction time
             if (stats.timeOfLastRead != 0) {
-                stats.ittReadRead.sample(curTick() - stats.timeOfLastRead);
+                stats.ittsReadRead.sample(curTick() - stats.timeOfLastRead);
             }
             stats.timeOfLastRead = curTick();
 
             // Sample value of req-req inter transaction time
             if (stats.timeOfLastReq != 0) {
-                stats.ittReqReq.sample(curTick() - stats.timeOfLastReq);
+                stats.ittsReqReq.sample(curTick() - stats.timeOfLastReq);
             }
             stats.timeOfLastReq = curTick();
         }
@@ -288,7 +289,7 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
         }
 
         if (!stats.disableBurstLengthHists) {
-            stats.writeBurstLengthHist.sample(size);
+            stats.writeBurstLengths.sample(size);
         }
 
         // Update the bandwidth stats on the request
@@ -299,7 +300,7 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
 
         // Sample the masked write address
         if (!stats.disableAddrDists) {
-            stats.writeAddrDist.sample(addr & writeAddrMask);
+            stats.writeAddrs.sample(addr & writeAddrMask);
         }
 
         if (!stats.disableOutstandingHists && expects_response) {
@@ -309,13 +310,13 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
         if (!stats.disableITTDists) {
             // Sample value of write-to-write inter transaction time
             if (stats.timeOfLastWrite != 0) {
-                stats.ittWriteWrite.sample(curTick() - stats.timeOfLastWrite);
+                stats.ittsWriteWrite.sample(curTick() - stats.timeOfLastWrite);
             }
             stats.timeOfLastWrite = curTick();
 
             // Sample value of req-to-req inter transaction time
             if (stats.timeOfLastReq != 0) {
-                stats.ittReqReq.sample(curTick() - stats.timeOfLastReq);
+                stats.ittsReqReq.sample(curTick() - stats.timeOfLastReq);
             }
             stats.timeOfLastReq = curTick();
         }
@@ -376,7 +377,7 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
         }
 
         if (!stats.disableLatencyHists) {
-            stats.readLatencyHist.sample(latency);
+            stats.readLatencies.sample(latency);
         }
 
         // Update the bandwidth stats based on responses for reads
@@ -394,7 +395,7 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
         }
 
         if (!stats.disableLatencyHists) {
-            stats.writeLatencyHist.sample(latency);
+            stats.writeLatencies.sample(latency);
         }
     } else if (successful) {
         DPRINTF(CommMonitor, "Received non read/write response\n");
@@ -570,6 +571,41 @@ CommMonitor::regStats()
         .name(name() + ".writeAddrDist")
         .desc("Write address distribution")
         .flags(stats.disableAddrDists ? nozero : pdf);
+
+    if (params()->lightweight_stats) {
+        registerDumpCallback(new MakeCallback<MonitorStats,
+                             &MonitorStats::flushSamples>(&stats));
+        registerResetCallback(new MakeCallback<MonitorStats,
+                              &MonitorStats::clearSamples>(&stats));
+    }
+}
+
+void
+CommMonitor::MonitorStats::flushSamples()
+{
+    readBurstLengths.flush();
+    writeBurstLengths.flush();
+    readLatencies.flush();
+    writeLatencies.flush();
+    ittsReadRead.flush();
+    ittsWriteWrite.flush();
+    ittsReqReq.flush();
+    readAddrs.flush();
+    writeAddrs.flush();
+}
+
+void
+CommMonitor::MonitorStats::clearSamples()
+{
+    readBurstLengths.clear();
+    writeBurstLengths.clear();
+    readLatencies.clear();
+    writeLatencies.clear();
+    ittsReadRead.clear();
+    ittsWriteWrite.clear();
+    ittsReqReq.clear();
+    readAddrs.clear();
+    writeAddrs.clear();
 }
 
 void
@@ -600,6 +636,9 @@ CommMonitor::samplePeriodic()
         }
     }
 
+    // pass on the per-packet samples buffered during the period
+    stats.flushSamples();
+
     // reset the sampled values
     stats.readTrans = 0;
     stats.writeTrans = 0;
@@ -41,6 +41,9 @@
 #ifndef __MEM_COMM_MONITOR_HH__
 #define __MEM_COMM_MONITOR_HH__
 
+#include <limits>
+#include <vector>
+
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "mem/mem_object.hh"
@@ -59,6 +62,12 @@
  * (read-read, write-write, read/write-read/write). Furthermore it allows
  * to capture the number of accesses to an address over time ("heat map").
  * All stats can be disabled from Python.
+ *
+ * With lightweight stats the per-packet samples are buffered as
+ * value and count pairs, and only passed on to the stats at the end of
+ * each sample period, or when the stats are dumped. The stats end up
+ * the same, but a run of equal values (such as burst lengths or
+ * masked addresses) costs a single update.
  */
 class CommMonitor : public MemObject
 {
@@ -269,6 +278,75 @@ class CommMonitor : public MemObject
 
     void recvRangeChange();
 
+    /**
+     * Fixed-size, direct-mapped table of samples waiting to be passed
+     * on to a stat, each with the number of times it was seen. A
+     * sample displaces a different value sharing its entry, and a
+     * table without entries passes every sample straight on.
+     */
+    template <class Stat>
+    class SampleBuffer
+    {
+
+      private:
+
+        struct Entry
+        {
+            uint64_t value;
+            int count;
+        };
+
+        /** The stat to pass the samples on to */
+        Stat& stat;
+
+        std::vector<Entry> entries;
+
+      public:
+
+        /**
+         * @param _stat Stat to pass the samples on to
+         * @param buffered Buffer the samples rather than passing each on
+         */
+        SampleBuffer(Stat& _stat, bool buffered)
+            : stat(_stat), entries(buffered ? 64 : 0, Entry{0, 0})
+        { }
+
+        void sample(uint64_t value)
+        {
+            if (entries.empty()) {
+                stat.sample(value);
+                return;
+            }
+
+            Entry& e = entries[(value ^ (value >> 6)) % entries.size()];
+            if (e.count != 0 && (e.value != value ||
+                                 e.count == std::numeric_limits<int>::max())) {
+                stat.sample(e.value, e.count);
+                e.count = 0;
+            }
+            e.value = value;
+            ++e.count;
+        }
+
+        /** Pass all buffered samples on to the stat */
+        void flush()
+        {
+            for (auto& e : entries) {
+                if (e.count != 0)
+                    stat.sample(e.value, e.count);
+                e.count = 0;
+            }
+        }
+
+        /** Drop all buffered samples */
+        void clear()
+        {
+            for (auto& e : entries)
+                e.count = 0;
+        }
+
+    };
+
     /** Stats declarations, all in a struct for convenience. */
     struct MonitorStats
     {
@@ -373,6 +451,20 @@ class CommMonitor : public MemObject
          */
         Stats::SparseHistogram writeAddrDist;
 
+        /**
+         * Buffers in front of the per-packet samples, which only hold
+         * on to them in lightweight mode.
+         */
+        SampleBuffer<Stats::Histogram> readBurstLengths;
+        SampleBuffer<Stats::Histogram> writeBurstLengths;
+        SampleBuffer<Stats::Histogram> readLatencies;
+        SampleBuffer<Stats::Histogram> writeLatencies;
+        SampleBuffer<Stats::Distribution> ittsReadRead;
+        SampleBuffer<Stats::Distribution> ittsWriteWrite;
+        SampleBuffer<Stats::Distribution> ittsReqReq;
+        SampleBuffer<Stats::SparseHistogram> readAddrs;
+        SampleBuffer<Stats::SparseHistogram> writeAddrs;
+
         /**
          * Create the monitor stats and initialise all the members
          * that are not statistics themselves, but used to control the
@@ -389,9 +481,25 @@ class CommMonitor : public MemObject
             outstandingReadReqs(0), outstandingWriteReqs(0),
             disableTransactionHists(params->disable_transaction_hists),
             readTrans(0), writeTrans(0),
-            disableAddrDists(params->disable_addr_dists)
+            disableAddrDists(params->disable_addr_dists),
+            readBurstLengths(readBurstLengthHist, params->lightweight_stats),
+            writeBurstLengths(writeBurstLengthHist,
+                              params->lightweight_stats),
+            readLatencies(readLatencyHist, params->lightweight_stats),
+            writeLatencies(writeLatencyHist, params->lightweight_stats),
+            ittsReadRead(ittReadRead, params->lightweight_stats),
+            ittsWriteWrite(ittWriteWrite, params->lightweight_stats),
+            ittsReqReq(ittReqReq, params->lightweight_stats),
+            readAddrs(readAddrDist, params->lightweight_stats),
+            writeAddrs(writeAddrDist, params->lightweight_stats)
         { }
 
+        /** Pass all buffered samples on to the stats */
+        void flushSamples();
+
+        /** Drop all buffered samples, as the stats are reset */
+        void clearSamples();
+
     };
 
     /** This function is called periodically at the end of each time bin */
@@ -43,7 +43,10 @@
  *          Omar Naji
  */
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
+#include "base/callback.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/DRAMPower.hh"
@@ -85,7 +88,8 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     tWR(p->tWR), tRTP(p->tRTP), tRFC(p->tRFC), tREFI(p->tREFI), tRRD(p->tRRD),
     tRRD_L(p->tRRD_L), tXAW(p->tXAW), activationLimit(p->activation_limit),
     memSchedPolicy(p->mem_sched_policy), addrMapping(p->addr_mapping),
-    pageMgmt(p->page_policy),
+    pageMgmt(p->page_policy), powerEval(p->power_eval),
+    idleRefreshBatch(p->idle_refresh_batch),
     maxAccessesPerRow(p->max_accesses_per_row),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
@@ -126,6 +130,13 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
         }
     }
 
+    // the per-bank view of the queues
+    readBanks.pkts.resize(ranksPerChannel * banksPerRank);
+    readBanks.rowHits.resize(ranksPerChannel * banksPerRank, 0);
+    writeBanks.pkts.resize(ranksPerChannel * banksPerRank);
+    writeBanks.rowHits.resize(ranksPerChannel * banksPerRank, 0);
+    nextPktSeq = 0;
+
     // perform a basic check of the write thresholds
     if (p->write_low_thresh_perc >= p->write_high_thresh_perc)
         fatal("Write buffer low threshold %d must be smaller than the "
@@ -472,7 +483,7 @@ DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
 
             DPRINTF(DRAM, "Adding to read queue\n");
 
-            readQueue.push_back(dram_pkt);
+            enqueue(readQueue, readBanks, dram_pkt);
 
             // Update stats
             avgRdQLen = readQueue.size() + respQueue.size();
@@ -585,7 +596,7 @@ DRAMCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pktCount)
 
             DPRINTF(DRAM, "Adding to write queue\n");
 
-            writeQueue.push_back(dram_pkt);
+            enqueue(writeQueue, writeBanks, dram_pkt);
 
             // Update stats
             avgWrQLen = writeQueue.size();
@@ -656,6 +667,11 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     }
     prevArrival = curTick();
 
+    // the ranks may have been refreshing in batches while idle
+    if (idleRefreshBatch) {
+        for (auto r : ranks)
+            r->endRefreshBatch();
+    }
 
     // Find out how many dram packets a pkt translates to
     // If the burst size is equal or larger than the pkt size, then a pkt
@@ -752,115 +768,155 @@ DRAMCtrl::processRespondEvent()
     }
 }
 
-bool
-DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
+void
+DRAMCtrl::enqueue(deque<DRAMPacket*>& queue, BankQueues& banks,
+                  DRAMPacket* dram_pkt)
+{
+    dram_pkt->seq = nextPktSeq++;
+    queue.push_back(dram_pkt);
+    banks.pkts[dram_pkt->bankId].push_back(dram_pkt);
+    if (dram_pkt->bankRef.openRow == dram_pkt->row)
+        ++banks.rowHits[dram_pkt->bankId];
+}
+
+void
+DRAMCtrl::dequeue(deque<DRAMPacket*>& queue, BankQueues& banks,
+                  DRAMPacket* dram_pkt)
 {
-    // This method does the arbitration between requests. The chosen
-    // packet is simply moved to the head of the queue. The other
-    // methods know that this is the place to look. For example, with
-    // FCFS, this method does nothing
+    // the packet to issue is generally close to the head of both
+    auto i = std::find(queue.begin(), queue.end(), dram_pkt);
+    assert(i != queue.end());
+    queue.erase(i);
+
+    deque<DRAMPacket*>& bank_pkts = banks.pkts[dram_pkt->bankId];
+    auto b = std::find(bank_pkts.begin(), bank_pkts.end(), dram_pkt);
+    assert(b != bank_pkts.end());
+    bank_pkts.erase(b);
+    if (dram_pkt->bankRef.openRow == dram_pkt->row) {
+        assert(banks.rowHits[dram_pkt->bankId] > 0);
+        --banks.rowHits[dram_pkt->bankId];
+    }
+}
+
+void
+DRAMCtrl::countRowHits(uint16_t bank_id)
+{
+    BankQueues* views[] = { &readBanks, &writeBanks };
+    for (auto banks : views) {
+        unsigned hits = 0;
+        for (const auto& p : banks->pkts[bank_id])
+            hits += p->bankRef.openRow == p->row;
+        banks->rowHits[bank_id] = hits;
+    }
+}
+
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::chooseNext(const deque<DRAMPacket*>& queue,
+                     const BankQueues& banks, bool switched_cmd_type)
+{
+    // This method does the arbitration between requests. For
+    // example, with FCFS, this method picks the oldest request to a
+    // rank which is available
     assert(!queue.empty());
 
-    // bool to indicate if a packet to an available rank is found
-    bool found_packet = false;
     if (queue.size() == 1) {
         DRAMPacket* dram_pkt = queue.front();
         // available rank corresponds to state refresh idle
         if (ranks[dram_pkt->rank]->isAvailable()) {
-            found_packet = true;
             DPRINTF(DRAM, "Single request, going to a free rank\n");
-        } else {
-            DPRINTF(DRAM, "Single request, going to a busy rank\n");
+            return dram_pkt;
         }
-        return found_packet;
+        DPRINTF(DRAM, "Single request, going to a busy rank\n");
+        return NULL;
     }
 
     if (memSchedPolicy == Enums::fcfs) {
-        // check if there is a packet going to a free rank
-        for(auto i = queue.begin(); i != queue.end() ; ++i) {
-            DRAMPacket* dram_pkt = *i;
-            if (ranks[dram_pkt->rank]->isAvailable()) {
-                queue.erase(i);
-                queue.push_front(dram_pkt);
-                found_packet = true;
-                break;
-            }
+        // the oldest packet going to a free rank is the oldest head
+        // of a bank queue of a free rank
+        DRAMPacket* selected_pkt = NULL;
+        for (const auto& bank_pkts : banks.pkts) {
+            if (bank_pkts.empty())
+                continue;
+            DRAMPacket* dram_pkt = bank_pkts.front();
+            if (dram_pkt->rankRef.isAvailable() &&
+                (!selected_pkt || dram_pkt->seq < selected_pkt->seq))
+                selected_pkt = dram_pkt;
         }
+        return selected_pkt;
     } else if (memSchedPolicy == Enums::frfcfs) {
-        found_packet = reorderQueue(queue, switched_cmd_type);
+        return reorderQueue(banks, switched_cmd_type);
     } else
         panic("No scheduling policy chosen\n");
-    return found_packet;
+    return NULL;
 }
 
-bool
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, bool switched_cmd_type)
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::reorderQueue(const BankQueues& banks, bool switched_cmd_type)
 {
-    // Only determine this when needed
-    uint64_t earliest_banks = 0;
-
     // Search for row hits first, if no row hit is found then schedule the
-    // packet to one of the earliest banks available
-    bool found_packet = false;
-    bool found_earliest_pkt = false;
-    bool found_prepped_diff_rank_pkt = false;
-    auto selected_pkt_it = queue.end();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-        // check if rank is busy. If this is the case jump to the next packet
-        // Check if it is a row hit
-        if (dram_pkt->rankRef.isAvailable()) {
-            if (bank.openRow == dram_pkt->row) {
-                if (dram_pkt->rank == activeRank || switched_cmd_type) {
-                    // FCFS within the hits, giving priority to commands
-                    // that access the same rank as the previous burst
-                    // to minimize bus turnaround delays
-                    // Only give rank prioity when command type is
-                    // not changing
-                    DPRINTF(DRAM, "Row buffer hit\n");
-                    selected_pkt_it = i;
-                    break;
-                } else if (!found_prepped_diff_rank_pkt) {
-                    // found row hit for command on different rank
-                    // than prev burst
-                    selected_pkt_it = i;
-                    found_prepped_diff_rank_pkt = true;
-                }
-            } else if (!found_earliest_pkt & !found_prepped_diff_rank_pkt) {
-                // packet going to a rank which is currently not waiting for a
-                // refresh, No row hit and
-                // haven't found an entry with a row hit to a new rank
-                if (earliest_banks == 0)
-                    // Determine entries with earliest bank prep delay
-                    // Function will give priority to commands that access the
-                    // same rank as previous burst and can prep
-                    // the bank seamlessly
-                    earliest_banks = minBankPrep(queue, switched_cmd_type);
-
-                // FCFS - Bank is first available bank
-                if (bits(earliest_banks, dram_pkt->bankId,
-                    dram_pkt->bankId)) {
-                    // Remember the packet to be scheduled to one of
-                    // the earliest banks available, FCFS amongst the
-                    // earliest banks
-                    selected_pkt_it = i;
-                    //if the packet found is going to a rank that is currently
-                    //not busy then update the found_packet to true
-                    found_earliest_pkt = true;
-                }
+    // packet to one of the earliest banks available. This picks the
+    // same packet as walking the whole queue in arrival order: the
+    // oldest row hit to the rank of the previous burst, else the oldest
+    // row hit to another rank, else the oldest packet to one of the
+    // earliest banks
+    DRAMPacket* same_rank_hit = NULL;
+    DRAMPacket* diff_rank_hit = NULL;
+    bool any_waiting = false;
+
+    for (size_t bank_id = 0; bank_id < banks.pkts.size(); ++bank_id) {
+        const deque<DRAMPacket*>& bank_pkts = banks.pkts[bank_id];
+        // skip banks with nothing queued, and ranks that are busy
+        if (bank_pkts.empty() || !bank_pkts.front()->rankRef.isAvailable())
+            continue;
+        any_waiting = true;
+        if (banks.rowHits[bank_id] == 0)
+            continue;
+
+        // FCFS within the hits of the bank
+        DRAMPacket* hit = NULL;
+        for (const auto& p : bank_pkts) {
+            if (p->bankRef.openRow == p->row) {
+                hit = p;
+                break;
             }
         }
+        assert(hit);
+
+        // giving priority to commands that access the same rank as
+        // the previous burst to minimize bus turnaround delays; only
+        // give rank prioity when command type is not changing
+        DRAMPacket*& best = (hit->rank == activeRank || switched_cmd_type) ?
+            same_rank_hit : diff_rank_hit;
+        if (!best || hit->seq < best->seq)
+            best = hit;
     }
 
-    if (selected_pkt_it != queue.end()) {
-        DRAMPacket* selected_pkt = *selected_pkt_it;
-        queue.erase(selected_pkt_it);
-        queue.push_front(selected_pkt);
-        found_packet = true;
+    if (same_rank_hit) {
+        DPRINTF(DRAM, "Row buffer hit\n");
+        return same_rank_hit;
+    }
+    if (diff_rank_hit || !any_waiting)
+        return diff_rank_hit;
+
+    // No row hits to an available rank, so every packet waiting for
+    // an available rank needs an activate. Determine the banks with
+    // the earliest bank prep delay; this gives priority to commands
+    // that access the same rank as previous burst and can prep the
+    // bank seamlessly
+    uint64_t earliest_banks = minBankPrep(banks, switched_cmd_type);
+
+    // FCFS amongst the earliest banks
+    DRAMPacket* selected_pkt = NULL;
+    for (size_t bank_id = 0; bank_id < banks.pkts.size(); ++bank_id) {
+        const deque<DRAMPacket*>& bank_pkts = banks.pkts[bank_id];
+        if (bank_pkts.empty() || !bits(earliest_banks, bank_id, bank_id))
+            continue;
+        DRAMPacket* dram_pkt = bank_pkts.front();
+        if (dram_pkt->rankRef.isAvailable() &&
+            (!selected_pkt || dram_pkt->seq < selected_pkt->seq))
+            selected_pkt = dram_pkt;
     }
-    return found_packet;
+    return selected_pkt;
 }
 
 void
@@ -906,6 +962,7 @@ DRAMCtrl::activateBank(Rank& rank_ref, Bank& bank_ref,
     // update the open row
     assert(bank_ref.openRow == Bank::NO_ROW);
     bank_ref.openRow = row;
+    countRowHits(rank_ref.rank * banksPerRank + bank_ref.bank);
 
     // start counting anew, this covers both the case when we
     // auto-precharged, and when this access is forced to
@@ -920,9 +977,9 @@ DRAMCtrl::activateBank(Rank& rank_ref, Bank& bank_ref,
             bank_ref.bank, rank_ref.rank, act_tick,
             ranks[rank_ref.rank]->numBanksActive);
 
-    rank_ref.power.powerlib.doCommand(MemCommand::ACT, bank_ref.bank,
-                                      divCeil(act_tick, tCK) -
-                                      timeStampOffset);
+    rank_ref.power.doCommand(MemCommand::ACT, bank_ref.bank,
+                             divCeil(act_tick, tCK) -
+                             timeStampOffset);
 
     DPRINTF(DRAMPower, "%llu,ACT,%d,%d\n", divCeil(act_tick, tCK) -
             timeStampOffset, bank_ref.bank, rank_ref.rank);
@@ -1007,6 +1064,7 @@ DRAMCtrl::prechargeBank(Rank& rank_ref, Bank& bank, Tick pre_at, bool trace)
     bytesPerActivate.sample(bank.bytesAccessed);
 
     bank.openRow = Bank::NO_ROW;
+    countRowHits(rank_ref.rank * banksPerRank + bank.bank);
 
     // no precharge allowed before this one
     bank.preAllowedAt = pre_at;
@@ -1024,9 +1082,8 @@ DRAMCtrl::prechargeBank(Rank& rank_ref, Bank& bank, Tick pre_at, bool trace)
 
     if (trace) {
 
-        rank_ref.power.powerlib.doCommand(MemCommand::PRE, bank.bank,
-                                                divCeil(pre_at, tCK) -
-                                                timeStampOffset);
+        rank_ref.power.doCommand(MemCommand::PRE, bank.bank,
+                                 divCeil(pre_at, tCK) - timeStampOffset);
         DPRINTF(DRAMPower, "%llu,PRE,%d,%d\n", divCeil(pre_at, tCK) -
                 timeStampOffset, bank.bank, rank_ref.rank);
     }
@@ -1158,29 +1215,15 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         // page, but closes it only if there are no row hits in the queue.
         // In this case, only force an auto precharge when there
         // are no same page hits in the queue
-        bool got_more_hits = false;
-        bool got_bank_conflict = false;
-
-        // either look at the read queue or write queue
-        const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
-            writeQueue;
-        auto p = queue.begin();
-        // make sure we are not considering the packet that we are
-        // currently dealing with (which is the head of the queue)
-        ++p;
-
-        // keep on looking until we have found required condition or
-        // reached the end
-        while (!(got_more_hits &&
-                 (got_bank_conflict || pageMgmt == Enums::close_adaptive)) &&
-               p != queue.end()) {
-            bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                (dram_pkt->bank == (*p)->bank);
-            bool same_row = dram_pkt->row == (*p)->row;
-            got_more_hits |= same_rank_bank && same_row;
-            got_bank_conflict |= same_rank_bank && !same_row;
-            ++p;
-        }
+        // either look at the read queue or write queue; the packet we
+        // are dealing with is still queued and hits the open row, so
+        // the row hit count of the bank tells us both
+        const BankQueues& banks = dram_pkt->isRead ? readBanks : writeBanks;
+        assert(bank.openRow == dram_pkt->row);
+        unsigned hits = banks.rowHits[dram_pkt->bankId];
+        assert(hits > 0);
+        bool got_more_hits = hits > 1;
+        bool got_bank_conflict = banks.pkts[dram_pkt->bankId].size() > hits;
 
         // auto pre-charge when either
         // 1) open_adaptive policy, we have not got any more hits, and
@@ -1213,9 +1256,9 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     DPRINTF(DRAM, "Access to %lld, ready at %lld bus busy until %lld.\n",
             dram_pkt->addr, dram_pkt->readyTime, busBusyUntil);
 
-    dram_pkt->rankRef.power.powerlib.doCommand(command, dram_pkt->bank,
-                                                 divCeil(cmd_at, tCK) -
-                                                 timeStampOffset);
+    dram_pkt->rankRef.power.doCommand(command, dram_pkt->bank,
+                                      divCeil(cmd_at, tCK) -
+                                      timeStampOffset);
 
     DPRINTF(DRAMPower, "%llu,%s,%d,%d\n", divCeil(cmd_at, tCK) -
             timeStampOffset, mem_cmd, dram_pkt->bank, dram_pkt->rank);
@@ -1322,22 +1365,18 @@ DRAMCtrl::processNextReqEvent()
                 return;
             }
         } else {
-            // bool to check if there is a read to a free rank
-            bool found_read = false;
-
-            // Figure out which read request goes next, and move it to the
-            // front of the read queue
-            found_read = chooseNext(readQueue, switched_cmd_type);
+            // Figure out which read request goes next
+            DRAMPacket* dram_pkt = chooseNext(readQueue, readBanks,
+                                              switched_cmd_type);
 
             // if no read to an available rank is found then return
             // at this point. There could be writes to the available ranks
             // which are above the required threshold. However, to
             // avoid adding more complexity to the code, return and wait
             // for a refresh event to kick things into action again.
-            if (!found_read)
+            if (!dram_pkt)
                 return;
 
-            DRAMPacket* dram_pkt = readQueue.front();
             assert(dram_pkt->rankRef.isAvailable());
             // here we get a bit creative and shift the bus busy time not
             // just the tWTR, but also a CAS latency to capture the fact
@@ -1351,7 +1390,7 @@ DRAMCtrl::processNextReqEvent()
             doDRAMAccess(dram_pkt);
 
             // At this point we're done dealing with the request
-            readQueue.pop_front();
+            dequeue(readQueue, readBanks, dram_pkt);
 
             // sanity check
             assert(dram_pkt->size <= burstSize);
@@ -1383,19 +1422,16 @@ DRAMCtrl::processNextReqEvent()
             busState = READ_TO_WRITE;
         }
     } else {
-        // bool to check if write to free rank is found
-        bool found_write = false;
-
-        found_write = chooseNext(writeQueue, switched_cmd_type);
+        DRAMPacket* dram_pkt = chooseNext(writeQueue, writeBanks,
+                                          switched_cmd_type);
 
         // if no writes to an available rank are found then return.
         // There could be reads to the available ranks. However, to avoid
         // adding more complexity to the code, return at this point and wait
         // for a refresh event to kick things into action again.
-        if (!found_write)
+        if (!dram_pkt)
             return;
 
-        DRAMPacket* dram_pkt = writeQueue.front();
         assert(dram_pkt->rankRef.isAvailable());
         // sanity check
         assert(dram_pkt->size <= burstSize);
@@ -1410,7 +1446,7 @@ DRAMCtrl::processNextReqEvent()
 
         doDRAMAccess(dram_pkt);
 
-        writeQueue.pop_front();
+        dequeue(writeQueue, writeBanks, dram_pkt);
         delete dram_pkt;
 
         // If we emptied the write queue, or got sufficiently below the
@@ -1446,7 +1482,7 @@ DRAMCtrl::processNextReqEvent()
 }
 
 uint64_t
-DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
+DRAMCtrl::minBankPrep(const BankQueues& banks,
                       bool switched_cmd_type) const
 {
     uint64_t bank_mask = 0;
@@ -1458,21 +1494,17 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     // Give precedence to commands that access same rank as previous command
     bool same_rank_match = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if(p->rankRef.isAvailable())
-            got_waiting[p->bankId] = true;
-    }
-
     for (int i = 0; i < ranksPerChannel; i++) {
+        // skip ranks that are refreshing altogether
+        if (!ranks[i]->isAvailable())
+            continue;
+
         for (int j = 0; j < banksPerRank; j++) {
             uint16_t bank_id = i * banksPerRank + j;
 
             // if we have waiting requests for the bank, and it is
             // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
+            if (!banks.pkts[bank_id].empty()) {
                 // make sure this rank is not currently refreshing.
                 assert(ranks[i]->isAvailable());
                 // simplistic approximation of when the bank can issue
@@ -1547,8 +1579,9 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
 DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p)
     : EventManager(&_memory), memory(_memory),
       pwrStateTrans(PWR_IDLE), pwrState(PWR_IDLE), pwrStateTick(0),
-      refreshState(REF_IDLE), refreshDueAt(0),
-      power(_p, false), numBanksActive(0),
+      refreshState(REF_IDLE), idleRefreshDue(MaxTick), refreshDueAt(0),
+      power(_p, false), powerFinalised(false), activeTicks(0),
+      numBanksActive(0),
       activateEvent(*this), prechargeEvent(*this),
       refreshEvent(*this), powerEvent(*this)
 { }
@@ -1569,6 +1602,56 @@ void
 DRAMCtrl::Rank::suspend()
 {
     deschedule(refreshEvent);
+    idleRefreshDue = MaxTick;
+}
+
+bool
+DRAMCtrl::Rank::canBatchRefresh() const
+{
+    return pwrState == PWR_IDLE && !powerEvent.scheduled() &&
+        numBanksActive == 0 && memory.readQueue.empty() &&
+        memory.writeQueue.empty() && !memory.nextReqEvent.scheduled() &&
+        System::allQuiesced();
+}
+
+void
+DRAMCtrl::Rank::catchUpRefresh()
+{
+    // with all banks precharged a refresh starts as soon as it is
+    // due, and the next one is due tREFI - tRP later, exactly as the
+    // state machine would have it
+    while (idleRefreshDue <= curTick()) {
+        Tick ref_done_at = idleRefreshDue + memory.tRFC;
+
+        pwrStateTime[PWR_IDLE] += idleRefreshDue - pwrStateTick;
+        pwrStateTime[PWR_REF] += memory.tRFC;
+        pwrStateTick = ref_done_at;
+
+        for (auto &b : banks) {
+            b.actAllowedAt = std::max(b.actAllowedAt, ref_done_at);
+        }
+
+        issueRefresh(idleRefreshDue);
+        ++memory.idleRefreshes;
+
+        refreshDueAt = idleRefreshDue;
+        idleRefreshDue += memory.tREFI - memory.tRP;
+    }
+}
+
+void
+DRAMCtrl::Rank::endRefreshBatch()
+{
+    if (idleRefreshDue == MaxTick)
+        return;
+
+    catchUpRefresh();
+
+    DPRINTF(DRAMState, "Ending refresh batch, next refresh at %llu\n",
+            idleRefreshDue);
+
+    reschedule(refreshEvent, idleRefreshDue);
+    idleRefreshDue = MaxTick;
 }
 
 void
@@ -1611,6 +1694,28 @@ DRAMCtrl::Rank::processPrechargeEvent()
 void
 DRAMCtrl::Rank::processRefreshEvent()
 {
+    // while nothing is going on, account for a batch of refreshes at
+    // a time rather than stepping through each of them
+    if (refreshState == REF_IDLE && memory.idleRefreshBatch &&
+        (idleRefreshDue != MaxTick || canBatchRefresh())) {
+        if (idleRefreshDue == MaxTick) {
+            DPRINTF(DRAMState, "System idle, batching refreshes\n");
+            idleRefreshDue = curTick();
+        }
+
+        catchUpRefresh();
+
+        if (canBatchRefresh()) {
+            schedule(refreshEvent, idleRefreshDue +
+                     (memory.idleRefreshBatch - 1) *
+                     (memory.tREFI - memory.tRP));
+        } else {
+            schedule(refreshEvent, idleRefreshDue);
+            idleRefreshDue = MaxTick;
+        }
+        return;
+    }
+
     // when first preparing the refresh, remember when it was due
     if (refreshState == REF_IDLE) {
         // remember when the refresh is due
@@ -1673,9 +1778,9 @@ DRAMCtrl::Rank::processRefreshEvent()
             }
 
             // precharge all banks in rank
-            power.powerlib.doCommand(MemCommand::PREA, 0,
-                                     divCeil(pre_at, memory.tCK) -
-                                     memory.timeStampOffset);
+            power.doCommand(MemCommand::PREA, 0,
+                            divCeil(pre_at, memory.tCK) -
+                            memory.timeStampOffset);
 
             DPRINTF(DRAMPower, "%llu,PREA,0,%d\n",
                     divCeil(pre_at, memory.tCK) -
@@ -1710,34 +1815,7 @@ DRAMCtrl::Rank::processRefreshEvent()
             b.actAllowedAt = ref_done_at;
         }
 
-        // at the moment this affects all ranks
-        power.powerlib.doCommand(MemCommand::REF, 0,
-                                 divCeil(curTick(), memory.tCK) -
-                                 memory.timeStampOffset);
-
-        // at the moment sort the list of commands and update the counters
-        // for DRAMPower libray when doing a refresh
-        sort(power.powerlib.cmdList.begin(),
-             power.powerlib.cmdList.end(), DRAMCtrl::sortTime);
-
-        // update the counters for DRAMPower, passing false to
-        // indicate that this is not the last command in the
-        // list. DRAMPower requires this information for the
-        // correct calculation of the background energy at the end
-        // of the simulation. Ideally we would want to call this
-        // function with true once at the end of the
-        // simulation. However, the discarded energy is extremly
-        // small and does not effect the final results.
-        power.powerlib.updateCounters(false);
-
-        // call the energy function
-        power.powerlib.calcEnergy();
-
-        // Update the stats
-        updatePowerStats();
-
-        DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(curTick(), memory.tCK) -
-                memory.timeStampOffset, rank);
+        issueRefresh(curTick());
 
         // make sure we did not wait so long that we cannot make up
         // for it
@@ -1761,6 +1839,44 @@ DRAMCtrl::Rank::processRefreshEvent()
     }
 }
 
+void
+DRAMCtrl::Rank::issueRefresh(Tick ref_at)
+{
+    // at the moment this affects all ranks
+    power.doCommand(MemCommand::REF, 0,
+                    divCeil(ref_at, memory.tCK) - memory.timeStampOffset);
+
+    if (memory.powerEval == Enums::refresh) {
+        // at the moment sort the list of commands and update the
+        // counters for DRAMPower libray when doing a refresh
+        sort(power.powerlib.cmdList.begin(),
+             power.powerlib.cmdList.end(), DRAMCtrl::sortTime);
+
+        // update the counters for DRAMPower, passing false to
+        // indicate that this is not the last command in the
+        // list. DRAMPower requires this information for the
+        // correct calculation of the background energy at the
+        // end of the simulation. Ideally we would want to call
+        // this function with true once at the end of the
+        // simulation. However, the discarded energy is extremly
+        // small and does not effect the final results.
+        power.powerlib.updateCounters(false);
+
+        // call the energy function
+        power.powerlib.calcEnergy();
+
+        // Update the stats
+        updatePowerStats();
+    } else {
+        // all banks are precharged, so no command issued from
+        // here on goes before the ones buffered so far
+        power.markOrdered();
+    }
+
+    DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(ref_at, memory.tCK) -
+            memory.timeStampOffset, rank);
+}
+
 void
 DRAMCtrl::Rank::schedulePowerEvent(PowerState pwr_state, Tick tick)
 {
@@ -1791,6 +1907,8 @@ DRAMCtrl::Rank::processPowerEvent()
 
     // update the accounting
     pwrStateTime[prev_state] += duration;
+    if (prev_state == PWR_ACT || prev_state == PWR_ACT_PDN)
+        activeTicks += duration;
 
     pwrState = pwrStateTrans;
     pwrStateTick = curTick();
@@ -1847,6 +1965,64 @@ DRAMCtrl::Rank::updatePowerStats()
     Data::MemoryPowerModel::Power rank_power =
         power.powerlib.getPower();
 
+    setPowerStats(energy, rank_power.average_power);
+}
+
+void
+DRAMCtrl::Rank::estimatePowerStats()
+{
+    // Like DRAMPower, count from the start of the simulation, and
+    // treat all the time without banks active (refreshes included) as
+    // precharged standby
+    Tick act_ticks = activeTicks;
+    if (pwrState == PWR_ACT || pwrState == PWR_ACT_PDN)
+        act_ticks += curTick() - pwrStateTick;
+
+    int64_t cycles = divCeil(curTick(), memory.tCK) - memory.timeStampOffset;
+    int64_t act_cycles = std::min<int64_t>(act_ticks / memory.tCK, cycles);
+    int64_t pre_cycles = cycles - act_cycles;
+    Data::MemoryPowerModel::Energy energy =
+        power.estimateEnergy(act_cycles, pre_cycles);
+
+    // energy in pJ over time in ns gives power in mW
+    double time_ns = (act_cycles + pre_cycles) * power.clkPeriod;
+    setPowerStats(energy, time_ns == 0 ? 0 : energy.total_energy / time_ns);
+}
+
+void
+DRAMCtrl::Rank::computePowerStats()
+{
+    switch (memory.powerEval) {
+      case Enums::dump:
+        power.evaluate(false);
+        updatePowerStats();
+        break;
+      case Enums::exit:
+        // once the full evaluation is done it stands
+        if (!powerFinalised)
+            estimatePowerStats();
+        break;
+      default:
+        // the stats are already updated at every refresh
+        break;
+    }
+}
+
+void
+DRAMCtrl::Rank::finalisePowerStats()
+{
+    if (memory.powerEval == Enums::refresh || powerFinalised)
+        return;
+
+    power.evaluate(true);
+    updatePowerStats();
+    powerFinalised = true;
+}
+
+void
+DRAMCtrl::Rank::setPowerStats(const Data::MemoryPowerModel::Energy& energy,
+                              double average_power)
+{
     actEnergy = energy.act_energy * memory.devicesPerRank;
     preEnergy = energy.pre_energy * memory.devicesPerRank;
     readEnergy = energy.read_energy * memory.devicesPerRank;
@@ -1855,7 +2031,7 @@ DRAMCtrl::Rank::updatePowerStats()
     actBackEnergy = energy.act_stdby_energy * memory.devicesPerRank;
     preBackEnergy = energy.pre_stdby_energy * memory.devicesPerRank;
     totalEnergy = energy.total_energy * memory.devicesPerRank;
-    averagePower = rank_power.average_power * memory.devicesPerRank;
+    averagePower = average_power * memory.devicesPerRank;
 }
 
 void
@@ -1908,6 +2084,21 @@ DRAMCtrl::Rank::regStats()
     averagePower
         .name(name() + ".averagePower")
         .desc("Core power per rank (mW)");
+
+    // batched refreshes are accounted for ahead of every dump
+    if (memory.idleRefreshBatch) {
+        registerDumpCallback(new MakeCallback<Rank,
+                             &Rank::catchUpRefresh>(this));
+    }
+
+    // deferred evaluations catch up ahead of every dump, and do the
+    // full evaluation at the end
+    if (memory.powerEval != Enums::refresh) {
+        registerDumpCallback(new MakeCallback<Rank,
+                             &Rank::computePowerStats>(this));
+        registerExitCallback(new MakeCallback<Rank,
+                             &Rank::finalisePowerStats>(this));
+    }
 }
 void
 DRAMCtrl::regStats()
@@ -2133,6 +2324,10 @@ DRAMCtrl::regStats()
         .precision(2);
     busUtil = (avgRdBW + avgWrBW) / peakBW * 100;
 
+    idleRefreshes
+        .name(name() + ".idleRefreshes")
+        .desc("Refreshes accounted for in batches while the system was idle");
+
     totGap
         .name(name() + ".totGap")
         .desc("Total gap between requests");
@@ -2267,6 +2462,16 @@ DRAMCtrl::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+bool
+DRAMCtrl::MemoryPort::recvBackdoorReq(Addr addr, MemBackdoor &backdoor)
+{
+    if (!memory.getBackdoor(backdoor))
+        return false;
+    // the same closed page latency as recvAtomic
+    backdoor.latency = memory.tRP + memory.tRCD + memory.tCL;
+    return true;
+}
+
 bool
 DRAMCtrl::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
@@ -56,6 +56,7 @@
 
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
+#include "enums/DRAMPowerEval.hh"
 #include "enums/MemSched.hh"
 #include "enums/PageManage.hh"
 #include "mem/abstract_mem.hh"
@@ -106,6 +107,8 @@ class DRAMCtrl : public AbstractMemory
 
         Tick recvAtomic(PacketPtr pkt);
 
+        bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         bool recvTimingReq(PacketPtr);
@@ -256,6 +259,12 @@ class DRAMCtrl : public AbstractMemory
          */
         RefreshState refreshState;
 
+        /**
+         * Due time of the next refresh not yet accounted for while
+         * the refreshes are batched, MaxTick when they are not
+         */
+        Tick idleRefreshDue;
+
         /**
          * Keep track of when a refresh is due.
          */
@@ -293,6 +302,21 @@ class DRAMCtrl : public AbstractMemory
          */
         void updatePowerStats();
 
+        /**
+         * Update the power stats with an estimate from the command
+         * counts and standby time, rather than from DRAMPower.
+         */
+        void estimatePowerStats();
+
+        /**
+         * Set the power stats from the energy of one device.
+         *
+         * @param energy Energy of each part
+         * @param average_power Average power (mW)
+         */
+        void setPowerStats(const Data::MemoryPowerModel::Energy& energy,
+                           double average_power);
+
         /**
          * Schedule a power state transition in the future, and
          * potentially override an already scheduled transition.
@@ -302,6 +326,22 @@ class DRAMCtrl : public AbstractMemory
          */
         void schedulePowerEvent(PowerState pwr_state, Tick tick);
 
+        /**
+         * Record a refresh command with DRAMPower, and with
+         * per-refresh power evaluation bring the power stats up to
+         * date.
+         *
+         * @param ref_at Tick when the refresh starts
+         */
+        void issueRefresh(Tick ref_at);
+
+        /**
+         * Check if the refreshes can be batched, which requires the
+         * whole system to be quiesced and the rank to have neither
+         * open banks nor requests.
+         */
+        bool canBatchRefresh() const;
+
       public:
 
         /**
@@ -314,6 +354,17 @@ class DRAMCtrl : public AbstractMemory
          */
         DRAMPower power;
 
+        /**
+         * The power stats hold the final DRAMPower evaluation
+         */
+        bool powerFinalised;
+
+        /**
+         * Time spent with any bank active, which unlike pwrStateTime
+         * is not reset with the stats
+         */
+        Tick activeTicks;
+
         /**
          * Vector of Banks. Each rank is made of several devices which in
          * term are made from several banks.
@@ -344,11 +395,36 @@ class DRAMCtrl : public AbstractMemory
          */
         void startup(Tick ref_tick);
 
+        /**
+         * Bring the power stats up to date ahead of a stats dump, as
+         * far as the power evaluation mode has them deferred.
+         */
+        void computePowerStats();
+
+        /**
+         * Do the full DRAMPower evaluation of all the commands at the
+         * end of the simulation, if it was deferred.
+         */
+        void finalisePowerStats();
+
         /**
          * Stop the refresh events.
          */
         void suspend();
 
+        /**
+         * Account for the batched refreshes that are due by now, as
+         * if each had gone through the refresh state machine.
+         */
+        void catchUpRefresh();
+
+        /**
+         * Stop batching the refreshes as a request arrives, having
+         * accounted for those due, so that the next one runs as
+         * normal.
+         */
+        void endRefreshBatch();
+
         /**
          * Check if the current rank is available for scheduling.
          *
@@ -459,13 +535,19 @@ class DRAMCtrl : public AbstractMemory
         Bank& bankRef;
         Rank& rankRef;
 
+        /**
+         * Arrival order of the packet in its queue, used to keep FCFS
+         * ordering between the per-bank queues
+         */
+        uint64_t seq;
+
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint32_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref, Rank& rank_ref)
             : entryTime(curTick()), readyTime(curTick()),
               pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-              bankRef(bank_ref), rankRef(rank_ref)
+              bankRef(bank_ref), rankRef(rank_ref), seq(0)
         { }
 
     };
@@ -565,43 +647,86 @@ class DRAMCtrl : public AbstractMemory
     DRAMPacket* decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned int size,
                            bool isRead);
 
+    /**
+     * Per-bank view of the read or the write queue. Every bank has
+     * its queued packets in arrival order, and a count of how many of
+     * them hit the row the bank has open, so the scheduler only looks
+     * at the banks that have work and only searches banks that have a
+     * row hit.
+     */
+    struct BankQueues {
+        /** Queued packets of each bank, indexed by bankId */
+        std::vector<std::deque<DRAMPacket*>> pkts;
+
+        /** Number of queued packets to the open row of each bank */
+        std::vector<unsigned> rowHits;
+    };
+
+    /**
+     * Add a packet to the tail of a queue and its bank queue.
+     *
+     * @param queue The read or write queue
+     * @param banks The per-bank view of the queue
+     * @param dram_pkt The packet to add
+     */
+    void enqueue(std::deque<DRAMPacket*>& queue, BankQueues& banks,
+                 DRAMPacket* dram_pkt);
+
+    /**
+     * Remove a packet from a queue and its bank queue.
+     *
+     * @param queue The read or write queue
+     * @param banks The per-bank view of the queue
+     * @param dram_pkt The packet to remove
+     */
+    void dequeue(std::deque<DRAMPacket*>& queue, BankQueues& banks,
+                 DRAMPacket* dram_pkt);
+
+    /**
+     * Recount the row hits of a bank after its open row changed.
+     *
+     * @param bank_id Index of the bank across all ranks
+     */
+    void countRowHits(uint16_t bank_id);
+
     /**
      * The memory schduler/arbiter - picks which request needs to
-     * go next, based on the specified policy such as FCFS or FR-FCFS
-     * and moves it to the head of the queue.
+     * go next, based on the specified policy such as FCFS or FR-FCFS.
      * Prioritizes accesses to the same rank as previous burst unless
      * controller is switching command type.
      *
      * @param queue Queued requests to consider
+     * @param banks The per-bank view of the queue
      * @param switched_cmd_type Command type is changing
-     * @return true if a packet is scheduled to a rank which is available else
-     * false
+     * @return The packet to issue, NULL if no packet goes to a rank
+     * which is available
      */
-    bool chooseNext(std::deque<DRAMPacket*>& queue, bool switched_cmd_type);
+    DRAMPacket* chooseNext(const std::deque<DRAMPacket*>& queue,
+                           const BankQueues& banks, bool switched_cmd_type);
 
     /**
-     * For FR-FCFS policy reorder the read/write queue depending on row buffer
+     * For FR-FCFS policy pick a packet depending on row buffer
      * hits and earliest banks available in DRAM
      * Prioritizes accesses to the same rank as previous burst unless
      * controller is switching command type.
      *
-     * @param queue Queued requests to consider
+     * @param banks The per-bank view of the queue to consider
      * @param switched_cmd_type Command type is changing
-     * @return true if a packet is scheduled to a rank which is available else
-     * false
+     * @return The packet to issue, NULL if no packet goes to a rank
+     * which is available
      */
-    bool reorderQueue(std::deque<DRAMPacket*>& queue, bool switched_cmd_type);
+    DRAMPacket* reorderQueue(const BankQueues& banks, bool switched_cmd_type);
 
     /**
      * Find which are the earliest banks ready to issue an activate
      * for the enqueued requests. Assumes maximum of 64 banks per DIMM
      * Also checks if the bank is already prepped.
      *
-     * @param queue Queued requests to consider
+     * @param banks The per-bank view of the queue to consider
      * @param switched_cmd_type Command type is changing
      * @return One-hot encoded mask of bank indices
      */
-    uint64_t minBankPrep(const std::deque<DRAMPacket*>& queue,
+    uint64_t minBankPrep(const BankQueues& banks,
                          bool switched_cmd_type) const;
 
     /**
@@ -642,6 +767,17 @@ class DRAMCtrl : public AbstractMemory
     std::deque<DRAMPacket*> readQueue;
     std::deque<DRAMPacket*> writeQueue;
 
+    /**
+     * The read and write queues split by bank
+     */
+    BankQueues readBanks;
+    BankQueues writeBanks;
+
+    /**
+     * Arrival order given to the next packet added to either queue
+     */
+    uint64_t nextPktSeq;
+
     /**
      * Response queue where read packets wait after we're done working
      * with them, but it's not time to send the response yet. The
@@ -722,6 +858,13 @@ class DRAMCtrl : public AbstractMemory
     Enums::MemSched memSchedPolicy;
     Enums::AddrMap addrMapping;
     Enums::PageManage pageMgmt;
+    Enums::DRAMPowerEval powerEval;
+
+    /**
+     * Number of refreshes accounted for per event while the system is
+     * idle, with zero disabling the batching.
+     */
+    const unsigned idleRefreshBatch;
 
     /**
      * Max column accesses (read and write) per row, before forefully
@@ -776,6 +919,7 @@ class DRAMCtrl : public AbstractMemory
     Stats::Scalar numRdRetry;
     Stats::Scalar numWrRetry;
     Stats::Scalar totGap;
+    Stats::Scalar idleRefreshes;
     Stats::Vector readPktSize;
     Stats::Vector writePktSize;
     Stats::Vector rdQLenPdf;
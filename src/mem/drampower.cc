@@ -37,6 +37,8 @@
  * Authors: Omar Naji
  */
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "mem/drampower.hh"
 #include "sim/core.hh"
@@ -44,8 +46,139 @@
 using namespace Data;
 
 DRAMPower::DRAMPower(const DRAMCtrlParams* p, bool include_io) :
-    powerlib(libDRAMPower(getMemSpec(p), include_io))
+    buffered(p->power_eval != Enums::refresh), orderedCommands(0),
+    numActs(0), numReads(0), numWrites(0), numRefs(0),
+    powerlib(libDRAMPower(getMemSpec(p), include_io)),
+    clkPeriod(p->tCK / (double)(SimClock::Int::ns))
+{
+    // the energy per command and per standby cycle for the estimate,
+    // as the model is linear in each of the counts
+    MemorySpecification mem_spec = getMemSpec(p);
+    CommandAnalysis counters(p->banks_per_rank);
+    MemoryPowerModel model;
+
+    counters.numberofacts = 1;
+    model.power_calc(mem_spec, counters, false);
+    actEnergy = model.energy.act_energy;
+
+    counters.numberofacts = 0;
+    counters.numberofpres = 1;
+    model.power_calc(mem_spec, counters, false);
+    preEnergy = model.energy.pre_energy;
+
+    counters.numberofpres = 0;
+    counters.numberofreads = 1;
+    model.power_calc(mem_spec, counters, false);
+    readEnergy = model.energy.read_energy;
+
+    counters.numberofreads = 0;
+    counters.numberofwrites = 1;
+    model.power_calc(mem_spec, counters, false);
+    writeEnergy = model.energy.write_energy;
+
+    counters.numberofwrites = 0;
+    counters.numberofrefs = 1;
+    model.power_calc(mem_spec, counters, false);
+    refEnergy = model.energy.ref_energy;
+
+    counters.numberofrefs = 0;
+    counters.actcycles = 1;
+    model.power_calc(mem_spec, counters, false);
+    actCycleEnergy = model.energy.act_stdby_energy;
+
+    counters.actcycles = 0;
+    counters.precycles = 1;
+    model.power_calc(mem_spec, counters, false);
+    preCycleEnergy = model.energy.pre_stdby_energy;
+}
+
+void
+DRAMPower::doCommand(MemCommand::cmds type, unsigned bank, int64_t timestamp)
+{
+    switch (type) {
+      case MemCommand::ACT:
+        ++numActs;
+        break;
+      case MemCommand::RD:
+      case MemCommand::RDA:
+        ++numReads;
+        break;
+      case MemCommand::WR:
+      case MemCommand::WRA:
+        ++numWrites;
+        break;
+      case MemCommand::REF:
+        ++numRefs;
+        break;
+      default:
+        break;
+    }
+
+    if (!buffered) {
+        powerlib.doCommand(type, bank, timestamp);
+        return;
+    }
+
+    assert(timestamp >= 0 && bank < 256 && type < 32);
+    commands.push_back(((uint64_t)timestamp << 13) |
+                       ((uint64_t)type << 8) | bank);
+}
+
+void
+DRAMPower::markOrdered()
+{
+    orderedCommands = commands.size();
+
+    // keep the buffer bounded on long runs
+    if (orderedCommands >= maxBuffered)
+        passCommands(orderedCommands, false);
+}
+
+void
+DRAMPower::passCommands(size_t count, bool last)
+{
+    assert(count <= commands.size());
+
+    std::sort(commands.begin(), commands.begin() + count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t c = commands[i];
+        powerlib.doCommand((MemCommand::cmds)((c >> 8) & 0x1f), c & 0xff,
+                           c >> 13);
+    }
+    commands.erase(commands.begin(), commands.begin() + count);
+    orderedCommands = count >= orderedCommands ? 0 : orderedCommands - count;
+
+    powerlib.updateCounters(last);
+}
+
+void
+DRAMPower::evaluate(bool last)
+{
+    if (buffered) {
+        size_t count = last ? commands.size() : orderedCommands;
+        if (count != 0 || last)
+            passCommands(count, last);
+    }
+
+    powerlib.calcEnergy();
+}
+
+MemoryPowerModel::Energy
+DRAMPower::estimateEnergy(int64_t act_cycles, int64_t pre_cycles) const
 {
+    // every activate is eventually followed by a precharge
+    MemoryPowerModel::Energy energy = MemoryPowerModel::Energy();
+    energy.act_energy = numActs * actEnergy;
+    energy.pre_energy = numActs * preEnergy;
+    energy.read_energy = numReads * readEnergy;
+    energy.write_energy = numWrites * writeEnergy;
+    energy.ref_energy = numRefs * refEnergy;
+    energy.act_stdby_energy = act_cycles * actCycleEnergy;
+    energy.pre_stdby_energy = pre_cycles * preCycleEnergy;
+    energy.total_energy = energy.act_energy + energy.pre_energy +
+        energy.read_energy + energy.write_energy + energy.ref_energy +
+        energy.act_stdby_energy + energy.pre_stdby_energy;
+    return energy;
 }
 
 Data::MemArchitectureSpec
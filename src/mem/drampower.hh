@@ -45,6 +45,8 @@
 #ifndef __MEM_DRAM_POWER_HH__
 #define __MEM_DRAM_POWER_HH__
 
+#include <vector>
+
 #include "libdrampower/LibDRAMPower.h"
 #include "params/DRAMCtrl.hh"
 
@@ -90,13 +92,101 @@ class DRAMPower
      */
     static Data::MemorySpecification getMemSpec(const DRAMCtrlParams* p);
 
+    /**
+     * Commands are buffered and passed on to DRAMPower in batches,
+     * rather than one at a time
+     */
+    const bool buffered;
+
+    /**
+     * Buffered commands, each packed as the timestamp shifted up by
+     * 13 bits, the command type shifted up by 8 bits, and the bank,
+     * so that sorting them sorts them by time
+     */
+    std::vector<uint64_t> commands;
+
+    /**
+     * Number of buffered commands that no later command precedes,
+     * and that can hence be passed on
+     */
+    size_t orderedCommands;
+
+    /** Ordered commands that are buffered before they are passed on */
+    static const size_t maxBuffered = 1 << 20;
+
+    /** Command counts for the estimate, in DRAMPower's terms */
+    int64_t numActs;
+    int64_t numReads;
+    int64_t numWrites;
+    int64_t numRefs;
+
+    /**
+     * Energy of a single command, and of a single cycle with any or
+     * no bank active, according to DRAMPower's model
+     */
+    double actEnergy;
+    double preEnergy;
+    double readEnergy;
+    double writeEnergy;
+    double refEnergy;
+    double actCycleEnergy;
+    double preCycleEnergy;
+
+    /**
+     * Sort the first buffered commands and pass them on to DRAMPower.
+     *
+     * @param count Number of commands to pass on
+     * @param last The final update, at the end of the simulation
+     */
+    void passCommands(size_t count, bool last);
+
  public:
 
     // Instance of DRAMPower Library
     libDRAMPower powerlib;
 
+    /** Clock period in ns, to turn cycles into time */
+    const double clkPeriod;
+
     DRAMPower(const DRAMCtrlParams* p, bool include_io);
 
+    /**
+     * Issue a command, which is passed on to DRAMPower straight away
+     * unless the evaluation is deferred.
+     *
+     * @param type Command type
+     * @param bank Bank the command targets
+     * @param timestamp Time of the command in DRAMPower clock cycles
+     */
+    void doCommand(Data::MemCommand::cmds type, unsigned bank,
+                   int64_t timestamp);
+
+    /**
+     * Note that none of the commands issued from here on will precede
+     * the ones issued so far, as is the case at a refresh.
+     */
+    void markOrdered();
+
+    /**
+     * Pass the buffered commands on to DRAMPower and calculate the
+     * energy.
+     *
+     * @param last Pass on every command as the final update, at the
+     *             end of the simulation
+     */
+    void evaluate(bool last);
+
+    /**
+     * Estimate the energy from the command counts and the time spent
+     * with banks active and precharged, without involving DRAMPower.
+     *
+     * @param act_cycles Cycles with any bank active
+     * @param pre_cycles Cycles with all banks precharged
+     * @return Energy with only the command and standby parts set
+     */
+    Data::MemoryPowerModel::Energy estimateEnergy(int64_t act_cycles,
+                                                  int64_t pre_cycles) const;
+
 };
 
 #endif //__MEM_DRAM_POWER_HH__
@@ -304,9 +304,7 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
             "completing read: serial = %d, complete = %d, "
             "addr = %#llx, size = %d\n", serial, complete, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        ByteTracker *tracker = getByteTracker(addr + i);
-
+    forEachByteTracker(addr, size, [&](ByteTracker *tracker, size_t i) {
         if (!tracker->completeRead(serial, complete, data[i])) {
             // Generate error message, and aggregate all failures for the bytes
             // considered in this transaction in one message.
@@ -329,7 +327,7 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
                              ? "" : "|");
             }
         }
-    }
+    });
 
     if (!result) {
         DPRINTF(MemChecker, "read of %#llx @ cycle %d failed:\n%s\n", addr,
@@ -342,8 +340,26 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
 void
 MemChecker::reset(Addr addr, size_t size)
 {
-    for (size_t i = 0; i < size; ++i) {
-        byte_trackers.erase(addr + i);
+    const Addr end = addr + size;
+    Addr a = addr;
+
+    while (a < end) {
+        const Addr line_addr = a & ~(LINE_SIZE - 1);
+        const Addr line_end = std::min(line_addr + LINE_SIZE, end);
+
+        auto it = line_trackers.find(line_addr);
+        if (it != line_trackers.end()) {
+            LineTracker &line = it->second;
+            for (; a < line_end; ++a) {
+                line.bytes[a - line_addr].reset();
+                line.mask &= ~(ULL(1) << (a - line_addr));
+            }
+
+            if (!line.mask)
+                line_trackers.erase(it);
+        }
+
+        a = line_end;
     }
 }
 
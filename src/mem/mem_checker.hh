@@ -41,8 +41,11 @@
 #ifndef __MEM_MEM_CHECKER_HH__
 #define __MEM_MEM_CHECKER_HH__
 
+#include <algorithm>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -199,13 +202,12 @@ class MemChecker : public SimObject
      * outstanding reads, the completed reads (and what they observed) and write
      * clusters (see WriteCluster).
      */
-    class ByteTracker : public Named
+    class ByteTracker
     {
       public:
 
-        ByteTracker(Addr addr = 0, const MemChecker *parent = NULL)
-            : Named((parent != NULL ? parent->name() : "") +
-                     csprintf(".ByteTracker@%#llx", addr))
+        ByteTracker(Addr _addr = 0, const MemChecker *_parent = NULL)
+            : addr(_addr), parent(_parent)
         {
             // The initial transaction has start == complete == TICK_INITIAL,
             // indicating that there has been no real write to this location;
@@ -223,6 +225,16 @@ class MemChecker : public SimObject
          */
         void startRead(Serial serial, Tick start);
 
+        /**
+         * Name used for debug output, which is only put together when
+         * needed rather than stored with every byte.
+         */
+        std::string name() const
+        {
+            return (parent != NULL ? parent->name() : "") +
+                csprintf(".ByteTracker@%#llx", addr);
+        }
+
         /**
          * Given a start and end time (of any read transaction), this function
          * iterates through all data that such a read is expected to see. The
@@ -345,6 +357,12 @@ class MemChecker : public SimObject
 
       private:
 
+        /** Address of the byte */
+        Addr addr;
+
+        /** Checker this tracker belongs to */
+        const MemChecker *parent;
+
         /**
          * Maintains a map of Serial -> Transaction for all outstanding reads.
          *
@@ -369,12 +387,43 @@ class MemChecker : public SimObject
         std::vector<uint8_t> _lastExpectedData;
     };
 
+    /**
+     * Size of the lines that byte trackers are grouped in, and that
+     * are sampled as a whole.
+     */
+    static const Addr LINE_SIZE = 64;
+
+    /**
+     * The LineTracker holds the byte trackers of a line, which are
+     * created as the bytes are touched, together with a mask of the
+     * bytes that have one. This costs a single lookup per line of an
+     * access rather than one per byte.
+     */
+    class LineTracker
+    {
+      public:
+        LineTracker() : mask(0) {}
+
+        /** Bit i is set if byte i has a tracker */
+        uint64_t mask;
+
+        /** Byte trackers, indexed by offset into the line */
+        std::unique_ptr<ByteTracker> bytes[LINE_SIZE];
+    };
+
   public:
 
     MemChecker(const MemCheckerParams *p)
         : SimObject(p),
-          nextSerial(SERIAL_INITIAL)
-    {}
+          nextSerial(SERIAL_INITIAL),
+          sampleRatio(p->sample_ratio),
+          sampleThreshold(sampleRatio ?
+                          std::numeric_limits<uint64_t>::max() / sampleRatio :
+                          0)
+    {
+        fatal_if(sampleRatio == 0, "%s: sample_ratio must be at least 1\n",
+                 name());
+    }
 
     virtual ~MemChecker() {}
 
@@ -449,7 +498,7 @@ class MemChecker : public SimObject
      * the reset with serial S.
      */
     void reset()
-    { byte_trackers.clear(); }
+    { line_trackers.clear(); }
 
     /**
      * Resets an address-range. This may be useful in case other unmonitored
@@ -474,17 +523,55 @@ class MemChecker : public SimObject
 
   private:
     /**
-     * Returns the instance of ByteTracker for the requested location.
+     * Is the line holding an address part of the sample?
+     */
+    bool sampled(Addr addr) const
+    {
+        if (sampleRatio == 1)
+            return true;
+
+        // Mix all the line address bits into the top ones (the 64-bit
+        // finalizer of MurmurHash3), so strided lines are not all in or
+        // all out of the sample
+        uint64_t h = addr / LINE_SIZE;
+        h ^= h >> 33;
+        h *= ULL(0xff51afd7ed558ccd);
+        h ^= h >> 33;
+        h *= ULL(0xc4ceb9fe1a85ec53);
+        h ^= h >> 33;
+        return h < sampleThreshold;
+    }
+
+    /**
+     * Calls f(tracker, i) with the ByteTracker of every sampled byte
+     * addr + i of a range, creating the trackers as needed.
      */
-    ByteTracker* getByteTracker(Addr addr)
+    template <typename F>
+    void forEachByteTracker(Addr addr, size_t size, F f)
     {
-        auto it = byte_trackers.find(addr);
-        if (it == byte_trackers.end()) {
-            it = byte_trackers.insert(
-                std::make_pair(addr, ByteTracker(addr, this))).first;
+        const Addr end = addr + size;
+        Addr a = addr;
+
+        while (a < end) {
+            const Addr line_addr = a & ~(LINE_SIZE - 1);
+            const Addr line_end = std::min(line_addr + LINE_SIZE, end);
+
+            if (!sampled(line_addr)) {
+                a = line_end;
+                continue;
+            }
+
+            LineTracker &line = line_trackers[line_addr];
+            for (; a < line_end; ++a) {
+                const Addr offset = a - line_addr;
+                if (!(line.mask & (ULL(1) << offset))) {
+                    line.bytes[offset].reset(new ByteTracker(a, this));
+                    line.mask |= ULL(1) << offset;
+                }
+                f(line.bytes[offset].get(), a - addr);
+            }
         }
-        return &it->second;
-    };
+    }
 
   private:
     /**
@@ -498,18 +585,24 @@ class MemChecker : public SimObject
      */
     Serial nextSerial;
 
+    /** Track one in this many lines */
+    const unsigned sampleRatio;
+
+    /** Lines whose hash is below this are in the sample */
+    const uint64_t sampleThreshold;
+
     /**
-     * Maintain a map of address --> byte-tracker. Per-byte entries are
-     * initialized as needed.
+     * Maintain a map of line address --> line-tracker. Per-byte
+     * trackers in a line are initialized as needed.
      *
      * The required space for this obviously grows with the number of distinct
      * addresses used for a particular workload. The used size is independent on
      * the number of nodes in the system, those may affect the size of per-byte
      * tracking information.
      *
-     * Access via getByteTracker()!
+     * Access via forEachByteTracker()!
      */
-    m5::hash_map<Addr, ByteTracker> byte_trackers;
+    m5::hash_map<Addr, LineTracker> line_trackers;
 };
 
 inline MemChecker::Serial
@@ -519,9 +612,9 @@ MemChecker::startRead(Tick start, Addr addr, size_t size)
             "starting read: serial = %d, start = %d, addr = %#llx, "
             "size = %d\n", nextSerial, start, addr , size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->startRead(nextSerial, start);
-    }
+    forEachByteTracker(addr, size, [&](ByteTracker *tracker, size_t i) {
+        tracker->startRead(nextSerial, start);
+    });
 
     return nextSerial++;
 }
@@ -533,9 +626,9 @@ MemChecker::startWrite(Tick start, Addr addr, size_t size, const uint8_t *data)
             "starting write: serial = %d, start = %d, addr = %#llx, "
             "size = %d\n", nextSerial, start, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->startWrite(nextSerial, start, data[i]);
-    }
+    forEachByteTracker(addr, size, [&](ByteTracker *tracker, size_t i) {
+        tracker->startWrite(nextSerial, start, data[i]);
+    });
 
     return nextSerial++;
 }
@@ -548,9 +641,9 @@ MemChecker::completeWrite(MemChecker::Serial serial, Tick complete,
             "completing write: serial = %d, complete = %d, "
             "addr = %#llx, size = %d\n", serial, complete, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->completeWrite(serial, complete);
-    }
+    forEachByteTracker(addr, size, [&](ByteTracker *tracker, size_t i) {
+        tracker->completeWrite(serial, complete);
+    });
 }
 
 inline void
@@ -560,9 +653,9 @@ MemChecker::abortWrite(MemChecker::Serial serial, Addr addr, size_t size)
             "aborting write: serial = %d, addr = %#llx, size = %d\n",
             serial, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->abortWrite(serial);
-    }
+    forEachByteTracker(addr, size, [&](ByteTracker *tracker, size_t i) {
+        tracker->abortWrite(serial);
+    });
 }
 
 #endif // __MEM_MEM_CHECKER_HH__
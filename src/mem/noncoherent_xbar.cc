@@ -88,7 +88,7 @@ NoncoherentXBar::NoncoherentXBar(const NoncoherentXBarParams *p)
                                            csprintf(".respLayer%d", i)));
     }
 
-    clearPortCache();
+    clearRouteCache();
 }
 
 NoncoherentXBar::~NoncoherentXBar()
@@ -114,6 +114,12 @@ class NoncoherentXBar : public BaseXBar
         virtual Tick recvAtomic(PacketPtr pkt)
         { return xbar.recvAtomic(pkt, id); }
 
+        /**
+         * When receiving a backdoor request, pass it to the crossbar.
+         */
+        virtual bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor)
+        { return xbar.recvBackdoorReq(addr, backdoor, id); }
+
         /**
          * When receiving a functional request, pass it to the crossbar.
          */
@@ -189,6 +195,12 @@ class NoncoherentXBar : public BaseXBar
       transaction.*/
     Tick recvAtomic(PacketPtr pkt, PortID slave_port_id);
 
+    /** Function called by the port when the crossbar is receiving a
+        backdoor request.*/
+    bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor,
+                         PortID slave_port_id)
+    { return forwardBackdoorReq(addr, backdoor); }
+
     /** Function called by the port when the crossbar is recieving a Functional
         transaction.*/
     void recvFunctional(PacketPtr pkt, PortID slave_port_id);
@@ -64,6 +64,7 @@
 #include "base/types.hh"
 #include "mem/request.hh"
 #include "sim/core.hh"
+#include "sim/event_pool.hh"
 
 class Packet;
 typedef Packet *PacketPtr;
@@ -256,7 +257,8 @@ class Packet : public Printable
     static const FlagsType STATIC_DATA            = 0x00001000;
     /// The data pointer points to a value that should be freed when
     /// the packet is destroyed. The pointer is assumed to be pointing
-    /// to an array, and delete [] is consequently called
+    /// to an array, and delete [] is consequently called, unless it
+    /// points to the packet's own inline storage (see allocate())
     static const FlagsType DYNAMIC_DATA           = 0x00002000;
     /// suppress the error if this packet encounters a functional
     /// access failure.
@@ -285,6 +287,15 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /**
+     * Storage used by allocate() for payloads of up to a typical
+     * cache line, which saves a heap allocation for the vast
+     * majority of packets. Larger payloads are still allocated from
+     * the heap.
+     */
+    static const unsigned InlineDataSize = 64;
+    uint8_t inlineData[InlineDataSize];
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -689,6 +700,23 @@ class Packet : public Printable
         return pkt;
     }
 
+    /**
+     * Packets are created and destroyed at a very high rate, so they
+     * are allocated from the EventPool free lists rather than from the
+     * general purpose heap.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(p, size);
+    }
+
     /**
      * clean up packet variables
      */
@@ -895,20 +923,27 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(DYNAMIC_DATA) && data != inlineData)
             delete [] data;
 
         flags.clear(STATIC_DATA|DYNAMIC_DATA);
         data = NULL;
     }
 
-    /** Allocate memory for the packet. */
+    /**
+     * Allocate memory for the packet. Small payloads use the inline
+     * storage, so the data pointer is only valid for as long as the
+     * packet itself.
+     */
     void
     allocate()
     {
         assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
         flags.set(DYNAMIC_DATA);
-        data = new uint8_t[getSize()];
+        if (getSize() <= InlineDataSize)
+            data = inlineData;
+        else
+            data = new uint8_t[getSize()];
     }
 
     /**
@@ -49,7 +49,8 @@
 using namespace std;
 
 PacketQueue::PacketQueue(EventManager& _em, const std::string& _label)
-    : em(_em), sendEvent(this), drainManager(NULL), label(_label),
+    : transmitList(maxDeferred), em(_em), sendEvent(this),
+      drainManager(NULL), label(_label),
       waitingOnRetry(false)
 {
 }
@@ -138,12 +139,12 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when, bool send_as_snoop)
         return;
     }
 
-    // this belongs in the middle somewhere, insertion sort
-    auto i = transmitList.begin();
-    ++i; // already checked for insertion at front
-    while (i != transmitList.end() && when >= i->tick)
-        ++i;
-    transmitList.insert(i, DeferredPacket(when, pkt, send_as_snoop));
+    // this belongs in the middle somewhere, insertion sort from the
+    // back, after any packets with the same tick
+    transmitList.push_back(DeferredPacket(when, pkt, send_as_snoop));
+    for (size_t i = transmitList.size() - 1;
+         i > 0 && transmitList[i - 1].tick > when; --i)
+        std::swap(transmitList[i - 1], transmitList[i]);
 }
 
 void PacketQueue::trySendTiming()
@@ -53,8 +53,7 @@
  * notifying the queue when a transfer ends.
  */
 
-#include <list>
-
+#include "base/circular_queue.hh"
 #include "mem/port.hh"
 #include "sim/drain.hh"
 #include "sim/eventq_impl.hh"
@@ -72,12 +71,20 @@ class PacketQueue : public Drainable
         Tick tick;      ///< The tick when the packet is ready to transmit
         PacketPtr pkt;  ///< Pointer to the packet to transmit
         bool sendAsSnoop; ///< Should it be sent as a snoop or not
+        DeferredPacket() : tick(0), pkt(NULL), sendAsSnoop(false)
+        {}
         DeferredPacket(Tick t, PacketPtr p, bool send_as_snoop)
             : tick(t), pkt(p), sendAsSnoop(send_as_snoop)
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    typedef CircularQueue<DeferredPacket> DeferredPacketList;
+
+    /**
+     * Capacity of the transmit list, which is fixed as the list is
+     * not allowed to grow beyond 100 packets.
+     */
+    static const size_t maxDeferred = 128;
 
     /** A list of outgoing timing response packets that haven't been
      * serviced yet. */
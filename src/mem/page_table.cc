@@ -37,7 +37,9 @@
  */
 #include <fstream>
 #include <map>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
@@ -237,3 +239,380 @@ FuncPageTable::unserialize(Checkpoint *cp, const std::string &section)
     }
 }
 
+
+RadixPageTable::RadixPageTable(const std::string &__name,
+                               uint64_t _pid, Addr _pageSize)
+        : PageTableBase(__name, _pid, _pageSize),
+          lastRegion(0), lastDir(NULL), pageShift(floorLog2(_pageSize)),
+          spanShift(pageShift + leafBits), regionShift(spanShift + dirBits)
+{
+    // the low bits of slots hold the flags
+    assert(pageSize > SlotReadOnly);
+}
+
+RadixPageTable::~RadixPageTable()
+{
+    clear();
+}
+
+void
+RadixPageTable::clear()
+{
+    for (auto &r : dirs) {
+        for (Addr i = 0; i < dirEntries; ++i)
+            delete [] r.second[i].leaf;
+        delete [] r.second;
+    }
+    dirs.clear();
+    lastDir = NULL;
+
+    pTableCache[0].valid = false;
+    pTableCache[1].valid = false;
+    pTableCache[2].valid = false;
+}
+
+RadixPageTable::DirEntry *
+RadixPageTable::findDirEntry(Addr vaddr, bool alloc)
+{
+    Addr region = vaddr >> regionShift;
+
+    if (!lastDir || lastRegion != region) {
+        DirMap::iterator i = dirs.find(region);
+        if (i == dirs.end()) {
+            if (!alloc)
+                return NULL;
+            i = dirs.insert(make_pair(region,
+                                      new DirEntry[dirEntries]())).first;
+        }
+        lastRegion = region;
+        lastDir = i->second;
+    }
+
+    return &lastDir[(vaddr >> spanShift) & (dirEntries - 1)];
+}
+
+Addr
+RadixPageTable::getSlot(Addr vaddr)
+{
+    DirEntry *d = findDirEntry(vaddr, false);
+    if (!d)
+        return 0;
+
+    Addr idx = (vaddr >> pageShift) & (leafEntries - 1);
+    if (d->huge)
+        return d->huge + (idx << pageShift);
+    return d->leaf ? d->leaf[idx] : 0;
+}
+
+void
+RadixPageTable::setSlot(Addr vaddr, Addr slot)
+{
+    DirEntry &d = *findDirEntry(vaddr, true);
+
+    if (!d.leaf) {
+        if (!d.huge && !slot)
+            return;
+
+        // split a huge mapping up into its pages
+        d.leaf = new Addr[leafEntries]();
+        d.used = 0;
+        if (d.huge) {
+            for (Addr i = 0; i < leafEntries; ++i)
+                d.leaf[i] = d.huge + (i << pageShift);
+            d.used = leafEntries;
+            d.huge = 0;
+        }
+    }
+
+    Addr &s = d.leaf[(vaddr >> pageShift) & (leafEntries - 1)];
+    if (s & SlotValid)
+        --d.used;
+    s = slot;
+    if (s & SlotValid)
+        ++d.used;
+
+    if (d.used == 0)
+        clearDirEntry(d);
+}
+
+void
+RadixPageTable::clearDirEntry(DirEntry &d)
+{
+    delete [] d.leaf;
+    d.leaf = NULL;
+    d.used = 0;
+    d.huge = 0;
+}
+
+void
+RadixPageTable::eraseCacheRange(Addr vaddr, int64_t size)
+{
+    for (int i = 0; i < 3; ++i) {
+        if (pTableCache[i].valid && pTableCache[i].vaddr >= vaddr &&
+            pTableCache[i].vaddr - vaddr < (Addr)size)
+            pTableCache[i].valid = false;
+    }
+}
+
+void
+RadixPageTable::mapSlots(Addr vaddr, Addr slot, int64_t size, bool clobber)
+{
+    const Addr span = ULL(1) << spanShift;
+
+    while (size > 0) {
+        if ((vaddr & (span - 1)) == 0 && size >= (int64_t)span) {
+            // a whole span is a single huge mapping
+            DirEntry &d = *findDirEntry(vaddr, true);
+            if (!clobber && (d.huge || d.leaf))
+                fatal("RadixPageTable::allocate: addr 0x%x already mapped",
+                      vaddr);
+            clearDirEntry(d);
+            d.huge = slot;
+
+            vaddr += span;
+            slot += span;
+            size -= span;
+        } else {
+            if (!clobber && (getSlot(vaddr) & SlotValid))
+                fatal("RadixPageTable::allocate: addr 0x%x already mapped",
+                      vaddr);
+            setSlot(vaddr, slot);
+
+            vaddr += pageSize;
+            slot += pageSize;
+            size -= pageSize;
+        }
+    }
+}
+
+void
+RadixPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
+{
+    // starting address must be page aligned
+    assert(pageOffset(vaddr) == 0);
+
+    DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr+ size);
+
+    Addr slot = pageAlign(paddr) | SlotValid |
+        (flags & Uncacheable ? SlotUncacheable : 0) |
+        (flags & ReadOnly ? SlotReadOnly : 0);
+
+    eraseCacheRange(vaddr, size);
+    mapSlots(vaddr, slot, size, flags & Clobber);
+}
+
+void
+RadixPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
+{
+    assert(pageOffset(vaddr) == 0);
+    assert(pageOffset(new_vaddr) == 0);
+
+    DPRINTF(MMU, "moving pages from vaddr %08p to %08p, size = %d\n", vaddr,
+            new_vaddr, size);
+
+    eraseCacheRange(vaddr, size);
+    eraseCacheRange(new_vaddr, size);
+
+    const Addr span = ULL(1) << spanShift;
+
+    while (size > 0) {
+        DirEntry *d = findDirEntry(vaddr, false);
+        if (d && d->huge && (vaddr & (span - 1)) == 0 &&
+            (new_vaddr & (span - 1)) == 0 && size >= (int64_t)span) {
+            // move a huge mapping as a whole
+            Addr huge = d->huge;
+            clearDirEntry(*d);
+            DirEntry &new_d = *findDirEntry(new_vaddr, true);
+            clearDirEntry(new_d);
+            new_d.huge = huge;
+
+            vaddr += span;
+            new_vaddr += span;
+            size -= span;
+        } else {
+            Addr slot = getSlot(vaddr);
+            assert(slot & SlotValid);
+            setSlot(vaddr, 0);
+            setSlot(new_vaddr, slot);
+
+            vaddr += pageSize;
+            new_vaddr += pageSize;
+            size -= pageSize;
+        }
+    }
+}
+
+void
+RadixPageTable::unmap(Addr vaddr, int64_t size)
+{
+    assert(pageOffset(vaddr) == 0);
+
+    DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr+ size);
+
+    eraseCacheRange(vaddr, size);
+
+    const Addr span = ULL(1) << spanShift;
+
+    while (size > 0) {
+        if ((vaddr & (span - 1)) == 0 && size >= (int64_t)span) {
+            DirEntry *d = findDirEntry(vaddr, false);
+            assert(d && (d->huge || d->used == leafEntries));
+            clearDirEntry(*d);
+
+            vaddr += span;
+            size -= span;
+        } else {
+            assert(getSlot(vaddr) & SlotValid);
+            setSlot(vaddr, 0);
+
+            vaddr += pageSize;
+            size -= pageSize;
+        }
+    }
+}
+
+bool
+RadixPageTable::isUnmapped(Addr vaddr, int64_t size)
+{
+    // starting address must be page aligned
+    assert(pageOffset(vaddr) == 0);
+
+    const Addr span = ULL(1) << spanShift;
+
+    while (size > 0) {
+        DirEntry *d = findDirEntry(vaddr, false);
+        if (!d || (!d->huge && !d->leaf)) {
+            // nothing mapped up to the end of the span
+            Addr next = (vaddr | (span - 1)) + 1;
+            size -= next - vaddr;
+            vaddr = next;
+            continue;
+        }
+
+        if (getSlot(vaddr) & SlotValid)
+            return false;
+
+        vaddr += pageSize;
+        size -= pageSize;
+    }
+
+    return true;
+}
+
+bool
+RadixPageTable::lookup(Addr vaddr, TheISA::TlbEntry &entry)
+{
+    Addr page_addr = pageAlign(vaddr);
+
+    if (pTableCache[0].valid && pTableCache[0].vaddr == page_addr) {
+        entry = pTableCache[0].entry;
+        return true;
+    }
+    if (pTableCache[1].valid && pTableCache[1].vaddr == page_addr) {
+        entry = pTableCache[1].entry;
+        return true;
+    }
+    if (pTableCache[2].valid && pTableCache[2].vaddr == page_addr) {
+        entry = pTableCache[2].entry;
+        return true;
+    }
+
+    Addr slot = getSlot(page_addr);
+    if (!(slot & SlotValid))
+        return false;
+
+    entry = TheISA::TlbEntry(pid, page_addr, pageAlign(slot),
+                             slot & SlotUncacheable, slot & SlotReadOnly);
+    updateCache(page_addr, entry);
+    return true;
+}
+
+void
+RadixPageTable::serialize(std::ostream &os)
+{
+    // runs of pages that are contiguous in both address spaces and
+    // have the same flags, in address order
+    vector<Addr> run_vaddr, run_paddr, run_flags;
+    vector<uint64_t> run_pages;
+
+    auto add_run = [&](Addr vaddr, Addr slot, uint64_t pages) {
+        Addr paddr = pageAlign(slot);
+        Addr flags = pageOffset(slot);
+        if (!run_vaddr.empty() && run_flags.back() == flags &&
+            run_vaddr.back() + (run_pages.back() << pageShift) == vaddr &&
+            run_paddr.back() + (run_pages.back() << pageShift) == paddr) {
+            run_pages.back() += pages;
+        } else {
+            run_vaddr.push_back(vaddr);
+            run_paddr.push_back(paddr);
+            run_flags.push_back(flags);
+            run_pages.push_back(pages);
+        }
+    };
+
+    vector<Addr> regions;
+    for (const auto &r : dirs)
+        regions.push_back(r.first);
+    sort(regions.begin(), regions.end());
+
+    for (Addr region : regions) {
+        const DirEntry *dir = dirs[region];
+        for (Addr i = 0; i < dirEntries; ++i) {
+            Addr base = (region << regionShift) | (i << spanShift);
+            if (dir[i].huge) {
+                add_run(base, dir[i].huge, leafEntries);
+            } else if (dir[i].leaf) {
+                for (Addr j = 0; j < leafEntries; ++j) {
+                    if (dir[i].leaf[j] & SlotValid)
+                        add_run(base | (j << pageShift), dir[i].leaf[j], 1);
+                }
+            }
+        }
+    }
+
+    arrayParamOut(os, "ptable.vaddr", run_vaddr);
+    arrayParamOut(os, "ptable.paddr", run_paddr);
+    arrayParamOut(os, "ptable.pages", run_pages);
+    arrayParamOut(os, "ptable.flags", run_flags);
+}
+
+void
+RadixPageTable::unserialize(Checkpoint *cp, const std::string &section)
+{
+    clear();
+
+    string size_str;
+    if (cp->find(section, "ptable.size", size_str)) {
+        // a checkpoint of a FuncPageTable, which holds a TLB entry
+        // per page that we can only take the physical page from
+        int count;
+        paramIn(cp, section, "ptable.size", count);
+
+        for (int i = 0; i < count; ++i) {
+            Addr vaddr;
+            TheISA::TlbEntry entry;
+            paramIn(cp, csprintf("%s.Entry%d", name(), i), "vaddr", vaddr);
+            entry.unserialize(cp, csprintf("%s.Entry%d", name(), i));
+            mapSlots(vaddr, entry.pageStart() | SlotValid, pageSize, true);
+        }
+        return;
+    }
+
+    vector<Addr> run_vaddr, run_paddr, run_flags;
+    vector<uint64_t> run_pages;
+    arrayParamIn(cp, section, "ptable.vaddr", run_vaddr);
+    arrayParamIn(cp, section, "ptable.paddr", run_paddr);
+    arrayParamIn(cp, section, "ptable.pages", run_pages);
+    arrayParamIn(cp, section, "ptable.flags", run_flags);
+
+    fatal_if(run_paddr.size() != run_vaddr.size() ||
+             run_pages.size() != run_vaddr.size() ||
+             run_flags.size() != run_vaddr.size(),
+             "Page table runs in checkpoint section %s don't match\n",
+             section);
+
+    for (size_t i = 0; i < run_vaddr.size(); ++i) {
+        mapSlots(run_vaddr[i], run_paddr[i] | run_flags[i] | SlotValid,
+                 run_pages[i] << pageShift, true);
+    }
+}
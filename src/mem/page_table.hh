@@ -244,6 +244,118 @@ class FuncPageTable : public PageTableBase
     void unserialize(Checkpoint *cp, const std::string &section);
 };
 
+/**
+ * Functional page table kept as a radix tree. The virtual address
+ * space is split into regions, found through a hash map, each with a
+ * flat directory of entries that each cover a span of pages. A
+ * directory entry either maps the whole span to contiguous physical
+ * pages (a huge mapping), or points to a flat leaf with a slot per
+ * page. Slots only hold the physical page and the mapping flags, and
+ * the TLB entries are created on lookup, so large mappings take
+ * little host memory and are cheap to set up and look up.
+ */
+class RadixPageTable : public PageTableBase
+{
+  private:
+    /** Bits of the virtual page number resolved by a leaf */
+    static const unsigned leafBits = 9;
+
+    /** Bits of the virtual page number resolved by a directory */
+    static const unsigned dirBits = 9;
+
+    static const Addr leafEntries = ULL(1) << leafBits;
+    static const Addr dirEntries = ULL(1) << dirBits;
+
+    /**
+     * Bits of a slot, which are kept below the page aligned physical
+     * address.
+     */
+    enum SlotFlags : Addr {
+        SlotValid       = 1,
+        SlotUncacheable = 2,
+        SlotReadOnly    = 4,
+    };
+
+    /** A directory entry, for a span of leafEntries pages */
+    struct DirEntry {
+        /** Slot of the first page of a huge mapping, or 0 */
+        Addr huge;
+        /** Leaf with a slot per page, or NULL */
+        Addr *leaf;
+        /** Valid slots in the leaf */
+        unsigned used;
+    };
+
+    /** Directories, by virtual region number */
+    typedef m5::hash_map<Addr, DirEntry *> DirMap;
+    DirMap dirs;
+
+    /** The last directory looked up, to skip the hash on lookups */
+    Addr lastRegion;
+    DirEntry *lastDir;
+
+    const unsigned pageShift;
+    const unsigned spanShift;
+    const unsigned regionShift;
+
+    /**
+     * Find the directory entry covering an address.
+     *
+     * @param vaddr Virtual address
+     * @param alloc Create the directory if there is none
+     * @return The entry, or NULL if there is no directory
+     */
+    DirEntry *findDirEntry(Addr vaddr, bool alloc);
+
+    /**
+     * Set the slot of a page, turning a huge mapping that covers it
+     * into a leaf, and dropping leaves that end up empty.
+     */
+    void setSlot(Addr vaddr, Addr slot);
+
+    /** The slot of a page, which is 0 for a page that isn't mapped */
+    Addr getSlot(Addr vaddr);
+
+    /** Drop the huge mapping or leaf of a directory entry */
+    void clearDirEntry(DirEntry &d);
+
+    /** Drop all the mappings */
+    void clear();
+
+    /** Invalidate the cached entries in a range of addresses */
+    void eraseCacheRange(Addr vaddr, int64_t size);
+
+    /** Map a run of pages from a slot of its first page */
+    void mapSlots(Addr vaddr, Addr slot, int64_t size, bool clobber);
+
+  public:
+
+    RadixPageTable(const std::string &__name, uint64_t _pid,
+                   Addr _pageSize = TheISA::PageBytes);
+
+    ~RadixPageTable();
+
+    void initState(ThreadContext* tc)
+    {
+    }
+
+    void map(Addr vaddr, Addr paddr, int64_t size,
+             uint64_t flags = 0);
+    void remap(Addr vaddr, int64_t size, Addr new_vaddr);
+    void unmap(Addr vaddr, int64_t size);
+    bool isUnmapped(Addr vaddr, int64_t size);
+    bool lookup(Addr vaddr, TheISA::TlbEntry &entry);
+
+    /**
+     * Serialize the mappings as runs of contiguous pages. Checkpoints
+     * of a FuncPageTable can be restored as well, although without
+     * their flags.
+     */
+    void serialize(std::ostream &os);
+
+    void unserialize(Checkpoint *cp, const std::string &section);
+};
+
 /**
  * Faux page table class indended to stop the usage of
  * an architectural page table, when there is none defined
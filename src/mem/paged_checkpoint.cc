@@ -0,0 +1,299 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/paged_checkpoint.hh"
+
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <unordered_map>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "base/trace.hh"
+#include "debug/Checkpoint.hh"
+
+namespace PagedCheckpoint {
+
+namespace {
+
+const char magic[8] = { 'g', 'e', 'm', '5', 'p', 'a', 'g', 'e' };
+const uint32_t version = 1;
+
+enum PageKind : uint8_t {
+    Zero,
+    Data,
+    Dup,
+    Parent
+};
+
+Digest
+digestPage(const uint8_t *page, size_t len, bool &zero)
+{
+    // Two independent multiplicative lanes over 64-bit words
+    uint64_t a = 0xcbf29ce484222325ULL;
+    uint64_t b = 0x9e3779b97f4a7c15ULL;
+    uint64_t any = 0;
+
+    size_t words = len / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        std::memcpy(&w, page + i * sizeof(uint64_t), sizeof(w));
+        any |= w;
+        a = (a ^ w) * 0x100000001b3ULL;
+        b = (b + w * 0xc2b2ae3d27d4eb4fULL);
+        b = ((b << 31) | (b >> 33)) * 0x165667b19e3779f9ULL;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < len; ++i) {
+        any |= page[i];
+        a = (a ^ page[i]) * 0x100000001b3ULL;
+        b = (b + page[i]) * 0x165667b19e3779f9ULL;
+    }
+
+    zero = any == 0;
+    return Digest{a ^ len, b};
+}
+
+void
+writeBytes(gzFile f, const std::string &path, const void *data, size_t len)
+{
+    if (gzwrite(f, data, len) != (int)len)
+        fatal("Write failed on paged memory checkpoint file '%s'\n", path);
+}
+
+void
+readBytes(gzFile f, const std::string &path, void *data, size_t len)
+{
+    if (gzread(f, data, len) != (int)len)
+        fatal("Paged memory checkpoint file '%s' is truncated\n", path);
+}
+
+bool
+fileExists(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+/**
+ * Find a parent store. Paths are recorded as absolute paths; if the
+ * checkpoints were moved, look for the parent's checkpoint directory
+ * next to the child's.
+ */
+std::string
+findParent(const std::string &child, const std::string &parent)
+{
+    if (fileExists(parent))
+        return parent;
+
+    std::string::size_type file_sep = parent.rfind('/');
+    std::string::size_type dir_sep = file_sep == std::string::npos ?
+        std::string::npos : parent.rfind('/', file_sep - 1);
+    std::string::size_type child_sep = child.rfind('/');
+    if (dir_sep != std::string::npos && child_sep != std::string::npos) {
+        std::string moved = child.substr(0, child_sep) + "/../" +
+            parent.substr(dir_sep + 1);
+        if (fileExists(moved))
+            return moved;
+    }
+
+    fatal("Can't find parent memory checkpoint '%s' of '%s'\n",
+          parent, child);
+}
+
+} // anonymous namespace
+
+void
+digestPages(const uint8_t *pmem, uint64_t size, unsigned page_size,
+            std::vector<Digest> &digests)
+{
+    uint64_t num_pages = divCeil(size, page_size);
+    digests.resize(num_pages);
+    for (uint64_t i = 0; i < num_pages; ++i) {
+        uint64_t offset = i * page_size;
+        bool zero;
+        digests[i] = digestPage(pmem + offset,
+                                std::min<uint64_t>(page_size, size - offset),
+                                zero);
+    }
+}
+
+void
+write(const std::string &path, const uint8_t *pmem, uint64_t size,
+      int level, const std::string &parent_path,
+      const std::vector<Digest> &parent,
+      const std::vector<bool> &untouched, std::vector<Digest> &digests)
+{
+    assert(parent_path.empty() == parent.empty());
+    assert(untouched.empty() || untouched.size() == divCeil(size,
+                                                          DefaultPageSize));
+
+    const uint32_t page_size = DefaultPageSize;
+    const uint64_t num_pages = divCeil(size, page_size);
+    if (!parent.empty() && parent.size() != num_pages)
+        fatal("Parent of memory checkpoint '%s' has %d pages, expected %d\n",
+              path, parent.size(), num_pages);
+
+    std::string mode = csprintf("wb%d", level);
+    gzFile f = gzopen(path.c_str(), mode.c_str());
+    if (f == NULL)
+        fatal("Can't open paged memory checkpoint file '%s'\n", path);
+
+    uint32_t parent_len = parent_path.size();
+    writeBytes(f, path, magic, sizeof(magic));
+    writeBytes(f, path, &version, sizeof(version));
+    writeBytes(f, path, &page_size, sizeof(page_size));
+    writeBytes(f, path, &num_pages, sizeof(num_pages));
+    writeBytes(f, path, &parent_len, sizeof(parent_len));
+    writeBytes(f, path, parent_path.data(), parent_len);
+
+    digests.resize(num_pages);
+
+    // Digest of a full page of zeros, for the untouched pages
+    const std::vector<uint8_t> zero_page(page_size, 0);
+    bool zero_digest_zero;
+    const Digest zero_digest = digestPage(&zero_page[0], page_size,
+                                          zero_digest_zero);
+
+    // First page holding each digest (lane a) that was stored as Data
+    std::unordered_map<uint64_t, uint64_t> stored;
+    uint64_t counts[4] = { 0, 0, 0, 0 };
+
+    for (uint64_t i = 0; i < num_pages; ++i) {
+        const uint64_t offset = i * page_size;
+        const size_t len = std::min<uint64_t>(page_size, size - offset);
+        const uint8_t *page = pmem + offset;
+
+        bool zero = true;
+        Digest digest = !untouched.empty() && untouched[i] &&
+            len == page_size ? zero_digest : digestPage(page, len, zero);
+        digests[i] = digest;
+
+        uint8_t kind;
+        uint64_t ref = 0;
+        if (!parent.empty() && parent[i] == digest) {
+            kind = Parent;
+        } else if (zero) {
+            kind = Zero;
+        } else {
+            auto it = stored.find(digest.a);
+            if (it != stored.end() && len == page_size &&
+                std::memcmp(pmem + it->second * page_size, page, len) == 0) {
+                kind = Dup;
+                ref = it->second;
+            } else {
+                kind = Data;
+                if (len == page_size)
+                    stored.emplace(digest.a, i);
+            }
+        }
+
+        ++counts[kind];
+        writeBytes(f, path, &kind, sizeof(kind));
+        if (kind == Data)
+            writeBytes(f, path, page, len);
+        else if (kind == Dup)
+            writeBytes(f, path, &ref, sizeof(ref));
+    }
+
+    if (gzclose(f))
+        fatal("Close failed on paged memory checkpoint file '%s'\n", path);
+
+    DPRINTF(Checkpoint, "Wrote %s: %d pages, %d zero, %d data, %d duplicate, "
+            "%d unchanged from parent\n", path, num_pages, counts[Zero],
+            counts[Data], counts[Dup], counts[Parent]);
+}
+
+void
+read(const std::string &path, uint8_t *pmem, uint64_t size)
+{
+    gzFile f = gzopen(path.c_str(), "rb");
+    if (f == NULL)
+        fatal("Can't open paged memory checkpoint file '%s'\n", path);
+
+    char file_magic[sizeof(magic)];
+    uint32_t file_version, page_size, parent_len;
+    uint64_t num_pages;
+    readBytes(f, path, file_magic, sizeof(file_magic));
+    if (std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+        fatal("'%s' is not a paged memory checkpoint file\n", path);
+    readBytes(f, path, &file_version, sizeof(file_version));
+    if (file_version != version)
+        fatal("Paged memory checkpoint '%s' has unsupported version %d\n",
+              path, file_version);
+    readBytes(f, path, &page_size, sizeof(page_size));
+    readBytes(f, path, &num_pages, sizeof(num_pages));
+    if (page_size == 0 || num_pages != divCeil(size, page_size))
+        fatal("Paged memory checkpoint '%s' doesn't match the memory size\n",
+              path);
+    readBytes(f, path, &parent_len, sizeof(parent_len));
+    std::string parent_path(parent_len, '\0');
+    readBytes(f, path, &parent_path[0], parent_len);
+
+    const bool has_parent = !parent_path.empty();
+    if (has_parent)
+        read(findParent(path, parent_path), pmem, size);
+
+    for (uint64_t i = 0; i < num_pages; ++i) {
+        const uint64_t offset = i * page_size;
+        const size_t len = std::min<uint64_t>(page_size, size - offset);
+
+        uint8_t kind;
+        readBytes(f, path, &kind, sizeof(kind));
+        switch (kind) {
+          case Zero:
+            std::memset(pmem + offset, 0, len);
+            break;
+          case Data:
+            readBytes(f, path, pmem + offset, len);
+            break;
+          case Dup: {
+              uint64_t ref;
+              readBytes(f, path, &ref, sizeof(ref));
+              if (ref >= i || len != page_size)
+                  fatal("Bad page reference in paged memory checkpoint "
+                        "'%s'\n", path);
+              std::memcpy(pmem + offset, pmem + ref * page_size, len);
+            }
+            break;
+          case Parent:
+            if (!has_parent)
+                fatal("Paged memory checkpoint '%s' refers to a missing "
+                      "parent\n", path);
+            break;
+          default:
+            fatal("Bad page kind %d in paged memory checkpoint '%s'\n",
+                  kind, path);
+        }
+    }
+
+    if (gzclose(f))
+        fatal("Close failed on paged memory checkpoint file '%s'\n", path);
+}
+
+} // namespace PagedCheckpoint
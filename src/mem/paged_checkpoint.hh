@@ -0,0 +1,109 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Paged checkpoint format for physical memory backing stores.
+ */
+
+#ifndef __MEM_PAGED_CHECKPOINT_HH__
+#define __MEM_PAGED_CHECKPOINT_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * A paged store file holds a backing store as a sequence of page
+ * records rather than one raw image, written through zlib at a
+ * configurable level (0 for no compression). Each page is one of:
+ *
+ * - Zero: all zero, nothing stored.
+ * - Data: stored verbatim.
+ * - Dup: identical to an earlier page of the same store, which is
+ *   referenced by index (compared byte for byte on writing).
+ * - Parent: unchanged from the same page of the parent store, for
+ *   incremental checkpoints.
+ *
+ * The file header names the parent store file, if any, so a chain of
+ * incremental checkpoints is restored by loading each ancestor first.
+ * Pages are matched against the parent by a 128-bit digest of their
+ * contents, recorded when the parent was restored, so no write
+ * tracking is needed in the memory system.
+ */
+namespace PagedCheckpoint {
+
+/** 128-bit digest of a page. */
+struct Digest
+{
+    uint64_t a;
+    uint64_t b;
+
+    bool operator==(const Digest &d) const { return a == d.a && b == d.b; }
+    bool operator!=(const Digest &d) const { return !(*this == d); }
+};
+
+/** Default page size of the format. */
+const unsigned DefaultPageSize = 4096;
+
+/** Compute the digest of every page of a store. */
+void digestPages(const uint8_t *pmem, uint64_t size, unsigned page_size,
+                 std::vector<Digest> &digests);
+
+/**
+ * Write a store.
+ *
+ * @param path File to write.
+ * @param pmem Contents of the store.
+ * @param size Size of the store in bytes.
+ * @param level zlib compression level, 0 to store uncompressed.
+ * @param parent_path Store file that Parent pages refer to, or empty.
+ * @param parent Page digests of the parent store. Must be empty if
+ *        parent_path is.
+ * @param untouched Flag per page that is known to be zero and need
+ *        not be read, or empty.
+ * @param digests Set to the page digests of the store written.
+ */
+void write(const std::string &path, const uint8_t *pmem, uint64_t size,
+           int level, const std::string &parent_path,
+           const std::vector<Digest> &parent,
+           const std::vector<bool> &untouched, std::vector<Digest> &digests);
+
+/**
+ * Restore a store, including any ancestors it is relative to.
+ *
+ * @param path File to read.
+ * @param pmem Backing store to fill, assumed zero on entry.
+ * @param size Size of the store in bytes.
+ */
+void read(const std::string &path, uint8_t *pmem, uint64_t size);
+
+} // namespace PagedCheckpoint
+
+#endif // __MEM_PAGED_CHECKPOINT_HH__
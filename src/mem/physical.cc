@@ -38,6 +38,7 @@
  */
 
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <fcntl.h>
@@ -47,9 +48,12 @@
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -72,9 +76,16 @@ using namespace std;
 
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
+                               bool mmap_using_noreserve,
+                               bool mmap_using_huge_pages,
+                               Enums::MemCheckpointFormat checkpoint_format,
+                               int checkpoint_level,
+                               bool incremental_checkpoints) :
     _name(_name), rangeCache(addrMap.end()), size(0),
-    mmapUsingNoReserve(mmap_using_noreserve)
+    mmapUsingNoReserve(mmap_using_noreserve),
+    mmapUsingHugePages(mmap_using_huge_pages),
+    checkpointFormat(checkpoint_format), checkpointLevel(checkpoint_level),
+    incrementalCheckpoints(incremental_checkpoints)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
@@ -172,7 +183,15 @@ PhysicalMemory::createBackingStore(AddrRange range,
         map_flags |= MAP_NORESERVE;
     }
 
-    uint8_t* pmem = (uint8_t*) mmap(NULL, range.size(),
+    // huge pages can only back the parts of the store that are
+    // aligned to them, so map a huge page extra and trim the
+    // mapping to a huge page boundary
+    const uint64_t huge_page_size = 2 * 1024 * 1024;
+    uint64_t map_size = range.size();
+    if (mmapUsingHugePages)
+        map_size += huge_page_size;
+
+    uint8_t* pmem = (uint8_t*) mmap(NULL, map_size,
                                     PROT_READ | PROT_WRITE,
                                     map_flags, -1, 0);
 
@@ -182,9 +201,28 @@ PhysicalMemory::createBackingStore(AddrRange range,
               range.to_string());
     }
 
+    if (mmapUsingHugePages) {
+        uint8_t* aligned = (uint8_t*) roundUp((Addr) pmem, huge_page_size);
+        if (aligned != pmem)
+            munmap(pmem, aligned - pmem);
+        if (aligned + range.size() != pmem + map_size)
+            munmap(aligned + range.size(),
+                   pmem + map_size - (aligned + range.size()));
+        pmem = aligned;
+
+#ifdef MADV_HUGEPAGE
+        if (madvise(pmem, range.size(), MADV_HUGEPAGE) != 0)
+            warn("Could not use huge pages for range %s: %s\n",
+                 range.to_string(), strerror(errno));
+#else
+        warn("Huge pages are not supported on this host\n");
+#endif
+    }
+
     // remember this backing store so we can checkpoint it and unmap
     // it appropriately
     backingStore.push_back(make_pair(range, pmem));
+    anonymousStore.push_back(true);
 
     // point the memories to their backing store
     for (const auto& m : _memories) {
@@ -201,6 +239,60 @@ PhysicalMemory::~PhysicalMemory()
         munmap((char*)s.second, s.first.size());
 }
 
+void
+PhysicalMemory::findUntouchedPages(unsigned int store_id, uint64_t page_size,
+                                   vector<bool>& untouched) const
+{
+    untouched.clear();
+
+#if defined(__linux__)
+    if (!anonymousStore[store_id])
+        return;
+
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // a pagemap entry per host page, with bit 63 set for pages that
+    // are present and bit 62 for pages that are swapped out; an
+    // anonymous page that is neither was never touched, and a page
+    // that was only read is present (as the host's zero page)
+    const uint64_t host_page_size = sysconf(_SC_PAGESIZE);
+    const Addr start = (Addr) backingStore[store_id].second;
+    const uint64_t size = backingStore[store_id].first.size();
+    const uint64_t num_host_pages = divCeil(size, host_page_size);
+    vector<bool> host_untouched(num_host_pages);
+
+    const uint64_t chunk = 4096;
+    vector<uint64_t> entries(chunk);
+    for (uint64_t i = 0; i < num_host_pages; i += chunk) {
+        uint64_t n = min(chunk, num_host_pages - i);
+        off_t offset = (start / host_page_size + i) * sizeof(uint64_t);
+        ssize_t bytes = n * sizeof(uint64_t);
+        if (pread(fd, &entries[0], bytes, offset) != bytes) {
+            close(fd);
+            return;
+        }
+        for (uint64_t j = 0; j < n; ++j)
+            host_untouched[i + j] = (entries[j] & (ULL(3) << 62)) == 0;
+    }
+    close(fd);
+
+    // a page is untouched if all the host pages it spans are
+    const uint64_t num_pages = divCeil(size, page_size);
+    untouched.resize(num_pages);
+    for (uint64_t i = 0; i < num_pages; ++i) {
+        uint64_t first = i * page_size / host_page_size;
+        uint64_t last = (min(size, (i + 1) * page_size) - 1) /
+            host_page_size;
+        bool all = true;
+        for (uint64_t h = first; all && h <= last; ++h)
+            all = host_untouched[h];
+        untouched[i] = all;
+    }
+#endif
+}
+
 bool
 PhysicalMemory::isMemAddr(Addr addr) const
 {
@@ -256,6 +348,23 @@ PhysicalMemory::getConfAddrRanges() const
     return ranges;
 }
 
+uint8_t *
+PhysicalMemory::toHostAddr(Addr addr, Addr size) const
+{
+    const auto& m = addrMap.find(addr);
+    if (m == addrMap.end())
+        return NULL;
+
+    // interleaved memories don't map the range to one contiguous
+    // part of the backing store, and null memories have none
+    const AddrRange &range = m->first;
+    uint8_t *pmem = m->second->backingStore();
+    if (range.interleaved() || !pmem || addr + size - 1 > range.end())
+        return NULL;
+
+    return pmem + addr - range.start();
+}
+
 void
 PhysicalMemory::access(PacketPtr pkt)
 {
@@ -322,6 +431,14 @@ void
 PhysicalMemory::serializeStore(ostream& os, unsigned int store_id,
                                AddrRange range, uint8_t* pmem)
 {
+    if (checkpointFormat == Enums::paged) {
+        serializeStorePaged(os, store_id, range, pmem);
+        return;
+    } else if (checkpointFormat == Enums::raw) {
+        serializeStoreRaw(os, store_id, range, pmem);
+        return;
+    }
+
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
     string filename = name() + ".store" + to_string(store_id) + ".pmem";
@@ -364,6 +481,110 @@ PhysicalMemory::serializeStore(ostream& os, unsigned int store_id,
 
 }
 
+void
+PhysicalMemory::serializeStorePaged(ostream& os, unsigned int store_id,
+                                    AddrRange range, uint8_t* pmem)
+{
+    string filename = name() + ".store" + to_string(store_id) + ".pages";
+    string format = "paged";
+    long range_size = range.size();
+
+    DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
+            filename, range_size);
+
+    SERIALIZE_SCALAR(store_id);
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
+
+    parentStore.resize(backingStore.size());
+    parentDigests.resize(backingStore.size());
+
+    static const vector<PagedCheckpoint::Digest> no_parent;
+    const bool relative = incrementalCheckpoints &&
+        !parentStore[store_id].empty();
+
+    string filepath = Checkpoint::dir() + "/" + filename;
+    vector<bool> untouched;
+    findUntouchedPages(store_id, PagedCheckpoint::DefaultPageSize, untouched);
+    vector<PagedCheckpoint::Digest> digests;
+    PagedCheckpoint::write(filepath, pmem, range.size(), checkpointLevel,
+                           relative ? parentStore[store_id] : "",
+                           relative ? parentDigests[store_id] : no_parent,
+                           untouched, digests);
+
+    if (incrementalCheckpoints) {
+        // the next checkpoint is relative to this one
+        char *resolved = realpath(filepath.c_str(), NULL);
+        if (!resolved)
+            fatal("Can't resolve path of '%s'\n", filepath);
+        parentStore[store_id] = resolved;
+        free(resolved);
+        parentDigests[store_id].swap(digests);
+    }
+}
+
+void
+PhysicalMemory::serializeStoreRaw(ostream& os, unsigned int store_id,
+                                  AddrRange range, uint8_t* pmem)
+{
+    string filename = name() + ".store" + to_string(store_id) + ".raw";
+    string format = "raw";
+    long range_size = range.size();
+
+    DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
+            filename, range_size);
+
+    SERIALIZE_SCALAR(store_id);
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
+
+    // remove any old image first rather than truncating it, as it
+    // may be mapped by this or another simulator
+    string filepath = Checkpoint::dir() + "/" + filename;
+    unlink(filepath.c_str());
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filename);
+
+    // zero pages are left as holes, so the image is sparse on disk,
+    // and pages that were never touched are not even looked at
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    vector<bool> untouched;
+    findUntouchedPages(store_id, page_size, untouched);
+    for (uint64_t offset = 0; offset < range.size(); offset += page_size) {
+        if (!untouched.empty() && untouched[offset / page_size])
+            continue;
+
+        uint64_t len = min(page_size, range.size() - offset);
+        const uint8_t *page = pmem + offset;
+        bool zero = page[0] == 0 && memcmp(page, page + 1, len - 1) == 0;
+        if (zero)
+            continue;
+
+        for (uint64_t done = 0; done < len; ) {
+            ssize_t ret = pwrite(fd, page + done, len - done, offset + done);
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s': %s\n", filename, strerror(errno));
+            }
+            done += ret;
+        }
+    }
+
+    if (ftruncate(fd, range.size()) != 0)
+        fatal("Can't size physical memory checkpoint file '%s'\n",
+              filename);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+}
+
 void
 PhysicalMemory::unserialize(Checkpoint* cp, const string& section)
 {
@@ -400,6 +621,19 @@ PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp->cptDir + "/" + filename;
 
+    string format;
+    if (cp->find(section, "format", format)) {
+        if (format == "paged") {
+            unserializeStorePaged(cp, section, store_id, filepath);
+            return;
+        } else if (format == "raw") {
+            unserializeStoreRaw(cp, section, store_id, filepath);
+            return;
+        }
+        fatal("Unknown format '%s' of physical memory checkpoint file "
+              "'%s'\n", format, filename);
+    }
+
     // mmap memoryfile
     gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
     if (compressed_mem == NULL)
@@ -447,3 +681,87 @@ PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
 }
+
+void
+PhysicalMemory::unserializeStorePaged(Checkpoint* cp, const string& section,
+                                      unsigned int store_id,
+                                      const string& filepath)
+{
+    uint8_t* pmem = backingStore[store_id].second;
+    AddrRange range = backingStore[store_id].first;
+
+    long range_size;
+    UNSERIALIZE_SCALAR(range_size);
+
+    DPRINTF(Checkpoint, "Unserializing paged physical memory %s with size "
+            "%d\n", filepath, range_size);
+
+    if (range_size != range.size())
+        fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+              range_size, range.size());
+
+    PagedCheckpoint::read(filepath, pmem, range.size());
+
+    if (incrementalCheckpoints) {
+        // checkpoints taken from here on are relative to this one
+        parentStore.resize(backingStore.size());
+        parentDigests.resize(backingStore.size());
+
+        char *resolved = realpath(filepath.c_str(), NULL);
+        if (!resolved)
+            fatal("Can't resolve path of '%s'\n", filepath);
+        parentStore[store_id] = resolved;
+        free(resolved);
+        PagedCheckpoint::digestPages(pmem, range.size(),
+                                     PagedCheckpoint::DefaultPageSize,
+                                     parentDigests[store_id]);
+    }
+}
+
+void
+PhysicalMemory::unserializeStoreRaw(Checkpoint* cp, const string& section,
+                                    unsigned int store_id,
+                                    const string& filepath)
+{
+    uint8_t* pmem = backingStore[store_id].second;
+    AddrRange range = backingStore[store_id].first;
+
+    long range_size;
+    UNSERIALIZE_SCALAR(range_size);
+
+    DPRINTF(Checkpoint, "Mapping raw physical memory %s with size %d\n",
+            filepath, range_size);
+
+    if (range_size != range.size())
+        fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+              range_size, range.size());
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size != range_size)
+        fatal("Physical memory checkpoint file '%s' doesn't match the "
+              "memory size\n", filepath);
+
+    // Replace the anonymous backing store with a private mapping of
+    // the image at the same address, so the memories keep pointing
+    // at it. Writes are copy-on-write and never reach the file.
+    int map_flags = MAP_PRIVATE | MAP_FIXED;
+    if (mmapUsingNoReserve)
+        map_flags |= MAP_NORESERVE;
+
+    void *mapped = mmap(pmem, range.size(), PROT_READ | PROT_WRITE,
+                        map_flags, fd, 0);
+    if (mapped == MAP_FAILED || mapped != pmem)
+        fatal("Could not mmap physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    // the mapping holds its own reference to the file
+    close(fd);
+
+    // unpopulated pages now read from the image
+    anonymousStore[store_id] = false;
+}
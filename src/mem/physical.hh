@@ -41,7 +41,9 @@
 #define __MEM_PHYSICAL_HH__
 
 #include "base/addr_range_map.hh"
+#include "enums/MemCheckpointFormat.hh"
 #include "mem/packet.hh"
+#include "mem/paged_checkpoint.hh"
 
 /**
  * Forward declaration to avoid header dependencies.
@@ -88,10 +90,31 @@ class PhysicalMemory : public Serializable
     // Let the user choose if we reserve swap space when calling mmap
     const bool mmapUsingNoReserve;
 
+    // Let the user choose if we ask for transparent huge pages
+    const bool mmapUsingHugePages;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<std::pair<AddrRange, uint8_t*>> backingStore;
 
+    // For each backing store, whether it is still an anonymous
+    // mapping (rather than a mapped raw image), so that pages the
+    // host never populated are known to be zero
+    std::vector<bool> anonymousStore;
+
+    // Format used to write the backing stores, and the zlib level
+    // used for paged stores
+    const Enums::MemCheckpointFormat checkpointFormat;
+    const int checkpointLevel;
+
+    // Write paged stores relative to the last one written or restored
+    const bool incrementalCheckpoints;
+
+    // For each backing store, the last paged store file written or
+    // restored and the digests of its pages
+    std::vector<std::string> parentStore;
+    std::vector<std::vector<PagedCheckpoint::Digest>> parentDigests;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -109,6 +132,20 @@ class PhysicalMemory : public Serializable
     void createBackingStore(AddrRange range,
                             const std::vector<AbstractMemory*>& _memories);
 
+    /**
+     * Find the pages of a backing store that were never touched, and
+     * hence are zero, without reading them (which would populate
+     * them). Only the host page tables are consulted, so nothing is
+     * found for stores that are not anonymous or on hosts that do
+     * not expose them.
+     *
+     * @param store_id The backing store to look at
+     * @param page_size Size of the pages to report on
+     * @param untouched Set to a flag per page, or left empty
+     */
+    void findUntouchedPages(unsigned int store_id, uint64_t page_size,
+                            std::vector<bool>& untouched) const;
+
   public:
 
     /**
@@ -116,7 +153,9 @@ class PhysicalMemory : public Serializable
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve, bool mmap_using_huge_pages,
+                   Enums::MemCheckpointFormat checkpoint_format,
+                   int checkpoint_level, bool incremental_checkpoints);
 
     /**
      * Unmap all the backing store we have used.
@@ -138,6 +177,17 @@ class PhysicalMemory : public Serializable
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Get a host pointer to a range of physical addresses, if the
+     * range falls in a single memory with a contiguous part of the
+     * backing store.
+     *
+     * @param addr A physical address
+     * @param size Size of the range in bytes
+     * @return Pointer into the backing store, or NULL
+     */
+    uint8_t *toHostAddr(Addr addr, Addr size) const;
+
     /**
      * Get the memory ranges for all memories that are to be reported
      * to the configuration table. The ranges are merged before they
@@ -209,6 +259,20 @@ class PhysicalMemory : public Serializable
     void serializeStore(std::ostream& os, unsigned int store_id,
                         AddrRange range, uint8_t* pmem);
 
+    /**
+     * Write a backing store in the paged format, relative to the last
+     * paged store written or restored if checkpoints are incremental.
+     */
+    void serializeStorePaged(std::ostream& os, unsigned int store_id,
+                             AddrRange range, uint8_t* pmem);
+
+    /**
+     * Write a backing store as an uncompressed image that can be
+     * mapped copy-on-write when restoring.
+     */
+    void serializeStoreRaw(std::ostream& os, unsigned int store_id,
+                           AddrRange range, uint8_t* pmem);
+
     /**
      * Unserialize the memories in the system. As with the
      * serialization, this action is independent of how the address
@@ -221,6 +285,22 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(Checkpoint* cp, const std::string& section);
 
+    /**
+     * Restore a backing store written by serializeStorePaged().
+     */
+    void unserializeStorePaged(Checkpoint* cp, const std::string& section,
+                               unsigned int store_id,
+                               const std::string& filepath);
+
+    /**
+     * Restore a backing store written by serializeStoreRaw() by
+     * mapping the image privately over the backing store, so pages
+     * are only read when first touched.
+     */
+    void unserializeStoreRaw(Checkpoint* cp, const std::string& section,
+                             unsigned int store_id,
+                             const std::string& filepath);
+
 };
 
 #endif //__MEM_PHYSICAL_HH__
@@ -168,6 +168,12 @@ MasterPort::sendAtomic(PacketPtr pkt)
     return _slavePort->recvAtomic(pkt);
 }
 
+bool
+MasterPort::sendBackdoorReq(Addr addr, MemBackdoor &backdoor)
+{
+    return _slavePort->recvBackdoorReq(addr, backdoor);
+}
+
 void
 MasterPort::sendFunctional(PacketPtr pkt)
 {
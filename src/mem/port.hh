@@ -51,6 +51,7 @@
 #define __MEM_PORT_HH__
 
 #include "base/addr_range.hh"
+#include "mem/backdoor.hh"
 #include "mem/packet.hh"
 
 class MemObject;
@@ -201,6 +202,16 @@ class MasterPort : public BaseMasterPort
      */
     Tick sendAtomic(PacketPtr pkt);
 
+    /**
+     * Ask the slave for a backdoor to the memory holding an address.
+     *
+     * @param addr Address the backdoor must cover
+     * @param backdoor Filled in if the request succeeds
+     *
+     * @return true if there is a backdoor for the address
+     */
+    bool sendBackdoorReq(Addr addr, MemBackdoor &backdoor);
+
     /**
      * Send a functional request packet, where the data is instantly
      * updated everywhere in the memory system, without affecting the
@@ -425,6 +436,16 @@ class SlavePort : public BaseSlavePort
      */
     virtual Tick recvAtomic(PacketPtr pkt) = 0;
 
+    /**
+     * Receive a backdoor request from the master port. Only memories,
+     * and objects that can forward the request without losing any
+     * side effects of an access, override this.
+     */
+    virtual bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor)
+    {
+        return false;
+    }
+
     /**
      * Receive a functional request packet from the master port.
      */
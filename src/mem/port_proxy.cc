@@ -39,10 +39,25 @@
 
 #include "base/chunk_generator.hh"
 #include "mem/port_proxy.hh"
+#include "sim/system.hh"
+
+uint8_t *
+PortProxy::directPtr(Addr addr, int size) const
+{
+    if (!_sys || size <= 0 || !_sys->directFunctionalAccess())
+        return NULL;
+
+    return _sys->getPhysMem().toHostAddr(addr, size);
+}
 
 void
 PortProxy::readBlob(Addr addr, uint8_t *p, int size) const
 {
+    if (uint8_t *host = directPtr(addr, size)) {
+        std::memcpy(p, host, size);
+        return;
+    }
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
         Request req(gen.addr(), gen.size(), 0, Request::funcMasterId);
@@ -56,6 +71,11 @@ PortProxy::readBlob(Addr addr, uint8_t *p, int size) const
 void
 PortProxy::writeBlob(Addr addr, const uint8_t *p, int size) const
 {
+    if (uint8_t *host = directPtr(addr, size)) {
+        std::memcpy(host, p, size);
+        return;
+    }
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
         Request req(gen.addr(), gen.size(), 0, Request::funcMasterId);
@@ -69,6 +89,11 @@ PortProxy::writeBlob(Addr addr, const uint8_t *p, int size) const
 void
 PortProxy::memsetBlob(Addr addr, uint8_t v, int size) const
 {
+    if (uint8_t *host = directPtr(addr, size)) {
+        std::memset(host, v, size);
+        return;
+    }
+
     // quick and dirty...
     uint8_t *buf = new uint8_t[size];
 
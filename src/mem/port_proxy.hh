@@ -67,6 +67,8 @@
 #include "mem/port.hh"
 #include "sim/byteswap.hh"
 
+class System;
+
 /**
  * This object is a proxy for a structural port, to be used for debug
  * accesses.
@@ -91,9 +93,24 @@ class PortProxy
     /** Granularity of any transactions issued through this proxy. */
     const unsigned int _cacheLineSize;
 
+    /**
+     * System whose memory the port leads to, if accesses are allowed
+     * to go straight to its backing store when nothing holds a copy.
+     */
+    System *const _sys;
+
+  protected:
+
+    /**
+     * Get a host pointer for an access that can bypass the memory
+     * system, or NULL if it needs functional packets.
+     */
+    uint8_t *directPtr(Addr addr, int size) const;
+
   public:
-    PortProxy(MasterPort &port, unsigned int cacheLineSize) :
-        _port(port), _cacheLineSize(cacheLineSize) { }
+    PortProxy(MasterPort &port, unsigned int cacheLineSize,
+              System *sys = NULL) :
+        _port(port), _cacheLineSize(cacheLineSize), _sys(sys) { }
     virtual ~PortProxy() { }
 
     /**
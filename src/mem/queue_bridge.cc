@@ -0,0 +1,230 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/queue_bridge.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/QueueBridge.hh"
+#include "sim/eventq_impl.hh"
+#include "sim/quantum.hh"
+
+QueueBridge::Channel::Channel(QueueBridge &_bridge, bool is_request,
+                              EventQueue *eq)
+    : EventManager(eq), bridge(_bridge), isRequest(is_request),
+      _name(_bridge.name() + (is_request ? ".req" : ".resp")),
+      waitingForRetry(false), deliverEvent(this), drainCallback(this)
+{
+    eq->registerAsyncCallback(&drainCallback);
+}
+
+void
+QueueBridge::Channel::post(PacketPtr pkt)
+{
+    Tick when = curTick() + bridge.delayTicks;
+
+    DPRINTF(QueueBridge, "%s: posting %s addr %#x for tick %d\n", name(),
+            pkt->cmdString(), pkt->getAddr(), when);
+
+    if (!inParallelMode) {
+        // Only one thread is running, hand the packet over directly
+        addReady(when, pkt);
+        return;
+    }
+
+    when = curTick() +
+        quantumController.crossQueue(bridge.delayTicks, simQuantum);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    mailbox.push_back(DeferredPacket(when, pkt));
+}
+
+void
+QueueBridge::Channel::drain()
+{
+    std::deque<DeferredPacket> posted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        posted.swap(mailbox);
+    }
+
+    for (auto &p : posted)
+        addReady(p.tick, p.pkt);
+}
+
+void
+QueueBridge::Channel::addReady(Tick when, PacketPtr pkt)
+{
+    // A packet can only be late if the simulation stopped mid-quantum
+    when = std::max(when, curTick());
+
+    if (ready.empty() || ready.back().tick <= when) {
+        ready.push_back(DeferredPacket(when, pkt));
+    } else {
+        auto pos = std::upper_bound(ready.begin(), ready.end(), when,
+            [](Tick t, const DeferredPacket &p) { return t < p.tick; });
+        ready.insert(pos, DeferredPacket(when, pkt));
+    }
+
+    scheduleDelivery();
+}
+
+void
+QueueBridge::Channel::scheduleDelivery()
+{
+    if (waitingForRetry || ready.empty())
+        return;
+
+    Tick when = std::max(ready.front().tick, curTick());
+    if (!deliverEvent.scheduled())
+        schedule(deliverEvent, when);
+    else if (deliverEvent.when() > when)
+        reschedule(deliverEvent, when);
+}
+
+void
+QueueBridge::Channel::deliver()
+{
+    while (!ready.empty() && ready.front().tick <= curTick()) {
+        PacketPtr pkt = ready.front().pkt;
+        bool sent = isRequest ? bridge.masterPort.sendTimingReq(pkt) :
+            bridge.slavePort.sendTimingResp(pkt);
+
+        if (!sent) {
+            DPRINTF(QueueBridge, "%s: %s addr %#x refused, waiting for "
+                    "retry\n", name(), pkt->cmdString(), pkt->getAddr());
+            waitingForRetry = true;
+            return;
+        }
+
+        ready.pop_front();
+    }
+
+    scheduleDelivery();
+}
+
+void
+QueueBridge::Channel::retry()
+{
+    assert(waitingForRetry);
+    waitingForRetry = false;
+    deliver();
+}
+
+QueueBridge::QueueBridge(Params *p)
+    : MemObject(p),
+      slaveQueue(getEventQueue(p->slave_eventq_index)),
+      masterQueue(getEventQueue(p->eventq_index)),
+      slavePort(name() + ".slave", *this),
+      masterPort(name() + ".master", *this),
+      delay(p->delay), delayTicks(0),
+      reqChannel(*this, true, masterQueue),
+      respChannel(*this, false, slaveQueue)
+{
+}
+
+void
+QueueBridge::init()
+{
+    if (!slavePort.isConnected() || !masterPort.isConnected())
+        fatal("Queue bridge %s is not connected on both sides.\n", name());
+
+    slavePort.sendRangeChange();
+
+    delayTicks = clockPeriod() * delay;
+    if (slaveQueue == masterQueue)
+        return;
+
+    limitSimQuantum(delayTicks, "Queue bridge " + name());
+}
+
+BaseMasterPort &
+QueueBridge::getMasterPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "master")
+        return masterPort;
+    else
+        return MemObject::getMasterPort(if_name, idx);
+}
+
+BaseSlavePort &
+QueueBridge::getSlavePort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "slave")
+        return slavePort;
+    else
+        return MemObject::getSlavePort(if_name, idx);
+}
+
+bool
+QueueBridge::BridgeSlavePort::recvTimingReq(PacketPtr pkt)
+{
+    bridge.reqChannel.post(pkt);
+    return true;
+}
+
+Tick
+QueueBridge::BridgeSlavePort::recvAtomic(PacketPtr pkt)
+{
+    if (!inParallelMode)
+        return bridge.masterPort.sendAtomic(pkt);
+
+    EventQueue::ScopedMigration migrate(bridge.masterQueue);
+    return bridge.masterPort.sendAtomic(pkt);
+}
+
+void
+QueueBridge::BridgeSlavePort::recvFunctional(PacketPtr pkt)
+{
+    if (!inParallelMode) {
+        bridge.masterPort.sendFunctional(pkt);
+        return;
+    }
+
+    EventQueue::ScopedMigration migrate(bridge.masterQueue);
+    bridge.masterPort.sendFunctional(pkt);
+}
+
+AddrRangeList
+QueueBridge::BridgeSlavePort::getAddrRanges() const
+{
+    return bridge.masterPort.getAddrRanges();
+}
+
+bool
+QueueBridge::BridgeMasterPort::recvTimingResp(PacketPtr pkt)
+{
+    bridge.respChannel.post(pkt);
+    return true;
+}
+
+QueueBridge *
+QueueBridgeParams::create()
+{
+    return new QueueBridge(this);
+}
@@ -0,0 +1,183 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Declaration of a bridge between ports serviced by different event
+ * queues.
+ */
+
+#ifndef __MEM_QUEUE_BRIDGE_HH__
+#define __MEM_QUEUE_BRIDGE_HH__
+
+#include <deque>
+#include <mutex>
+
+#include "base/callback.hh"
+#include "mem/mem_object.hh"
+#include "params/QueueBridge.hh"
+#include "sim/eventq.hh"
+
+/**
+ * A queue bridge connects a master on one event queue (typically a
+ * core's private cache, serviced by its own thread) to a slave on
+ * another (typically the shared crossbar). Timing packets crossing the
+ * bridge are delayed by a fixed latency, which must be at least the
+ * simulation quantum: a packet sent by one thread during a quantum is
+ * then always delivered by the other thread in a later quantum.
+ *
+ * Packets are posted to a mailbox by the sending thread and moved to
+ * the delivery queue by the receiving thread when it passes the
+ * quantum barrier. Mailboxes are drained in a fixed order, so runs are
+ * deterministic.
+ *
+ * The bridge does not forward snoops. Classic coherence needs snoops
+ * to complete in zero time, which is impossible across threads, so the
+ * caches on either side are not kept coherent. This is only correct
+ * for workloads that share no memory across the bridge (e.g.
+ * multi-programmed SE runs). Functional accesses are forwarded right
+ * away, after migrating to the other side's event queue.
+ */
+class QueueBridge : public MemObject
+{
+  private:
+    /**
+     * One direction through the bridge, delivering packets on the
+     * receiving side's event queue.
+     */
+    class Channel : public EventManager
+    {
+      private:
+        struct DeferredPacket
+        {
+            Tick tick;
+            PacketPtr pkt;
+
+            DeferredPacket(Tick t, PacketPtr p) : tick(t), pkt(p) {}
+        };
+
+        QueueBridge &bridge;
+        const bool isRequest;
+        const std::string _name;
+
+        /** Packets posted by the sending thread, protected by mutex. */
+        std::mutex mutex;
+        std::deque<DeferredPacket> mailbox;
+
+        /** Packets owned by the receiving thread, in delivery order. */
+        std::deque<DeferredPacket> ready;
+
+        /** Whether the receiving port refused a packet. */
+        bool waitingForRetry;
+
+        void deliver();
+        EventWrapper<Channel, &Channel::deliver> deliverEvent;
+
+        void addReady(Tick when, PacketPtr pkt);
+        void scheduleDelivery();
+
+      public:
+        Channel(QueueBridge &bridge, bool is_request, EventQueue *eq);
+
+        const std::string name() const { return _name; }
+
+        /** Accept a packet from the sending side. */
+        void post(PacketPtr pkt);
+
+        /** Move posted packets to the delivery queue. */
+        void drain();
+
+        /** The receiving port is ready for the refused packet. */
+        void retry();
+
+      private:
+        MakeCallback<Channel, &Channel::drain> drainCallback;
+    };
+
+    class BridgeSlavePort : public SlavePort
+    {
+      private:
+        QueueBridge &bridge;
+
+      public:
+        BridgeSlavePort(const std::string &name, QueueBridge &bridge)
+            : SlavePort(name, &bridge), bridge(bridge)
+        { }
+
+      protected:
+        bool recvTimingReq(PacketPtr pkt);
+        Tick recvAtomic(PacketPtr pkt);
+        void recvFunctional(PacketPtr pkt);
+        void recvRetry() { bridge.respChannel.retry(); }
+        AddrRangeList getAddrRanges() const;
+    };
+
+    class BridgeMasterPort : public MasterPort
+    {
+      private:
+        QueueBridge &bridge;
+
+      public:
+        BridgeMasterPort(const std::string &name, QueueBridge &bridge)
+            : MasterPort(name, &bridge), bridge(bridge)
+        { }
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt);
+        void recvRetry() { bridge.reqChannel.retry(); }
+        void recvRangeChange() { bridge.slavePort.sendRangeChange(); }
+    };
+
+    /** Event queues of the slave (requesting) and master sides. */
+    EventQueue *slaveQueue;
+    EventQueue *masterQueue;
+
+    BridgeSlavePort slavePort;
+    BridgeMasterPort masterPort;
+
+    /** Latency of a crossing. */
+    const Cycles delay;
+    Tick delayTicks;
+
+    Channel reqChannel;
+    Channel respChannel;
+
+  public:
+    typedef QueueBridgeParams Params;
+
+    QueueBridge(Params *p);
+
+    BaseMasterPort &getMasterPort(const std::string &if_name,
+                                  PortID idx = InvalidPortID);
+    BaseSlavePort &getSlavePort(const std::string &if_name,
+                                PortID idx = InvalidPortID);
+
+    void init();
+};
+
+#endif // __MEM_QUEUE_BRIDGE_HH__
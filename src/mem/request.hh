@@ -58,6 +58,7 @@
 #include "base/misc.hh"
 #include "base/types.hh"
 #include "sim/core.hh"
+#include "sim/event_pool.hh"
 
 /**
  * Special TaskIds that are used for per-context-switch stats dumps
@@ -338,6 +339,22 @@ class Request
 
     ~Request() {}
 
+    /**
+     * Requests are allocated for every memory transaction, so they
+     * come from the EventPool free lists, like packets.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(p, size);
+    }
+
     /**
      * Set up CPU and thread numbers.
      */
@@ -26,6 +26,9 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <functional>
+
 #include "mem/ruby/common/Consumer.hh"
 
 using namespace std;
@@ -39,15 +42,40 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
-    if (!alreadyScheduled(evt_time)) {
-        // This wakeup is not redundant
-        ConsumerEvent *evt = new ConsumerEvent(this);
-        em->schedule(evt, evt_time);
-        insertScheduledWakeupTime(evt_time);
+    if (!m_wakeup_event.scheduled()) {
+        em->schedule(m_wakeup_event, evt_time);
+    } else if (evt_time < m_wakeup_event.when()) {
+        // Move the event earlier, and keep the wakeup it was for
+        m_pending_wakeups.push_back(m_wakeup_event.when());
+        push_heap(m_pending_wakeups.begin(), m_pending_wakeups.end(),
+                  greater<Tick>());
+        em->reschedule(m_wakeup_event, evt_time);
+    } else if (evt_time > m_wakeup_event.when()) {
+        m_pending_wakeups.push_back(evt_time);
+        push_heap(m_pending_wakeups.begin(), m_pending_wakeups.end(),
+                  greater<Tick>());
+    }
+    // else this wakeup is redundant
+}
+
+void
+Consumer::processWakeup()
+{
+    // Drop the wakeups for this tick, and move on to the next one
+    // before waking up, which may ask for more wakeups
+    while (!m_pending_wakeups.empty() &&
+           m_pending_wakeups.front() <= curTick()) {
+        pop_heap(m_pending_wakeups.begin(), m_pending_wakeups.end(),
+                 greater<Tick>());
+        m_pending_wakeups.pop_back();
+    }
+
+    if (!m_pending_wakeups.empty()) {
+        em->schedule(m_wakeup_event, m_pending_wakeups.front());
+        pop_heap(m_pending_wakeups.begin(), m_pending_wakeups.end(),
+                 greater<Tick>());
+        m_pending_wakeups.pop_back();
     }
 
-    Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    wakeup();
 }
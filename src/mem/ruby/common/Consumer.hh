@@ -36,7 +36,7 @@
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -44,52 +44,64 @@ class Consumer
 {
   public:
     Consumer(ClockedObject *_em)
-        : em(_em)
+        : em(_em), m_wakeup_event(this)
     {
     }
 
     virtual
     ~Consumer()
-    { }
+    {
+        if (m_wakeup_event.scheduled())
+            em->deschedule(m_wakeup_event);
+    }
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
     virtual void storeEventInfo(int info) {}
 
-    bool
-    alreadyScheduled(Tick time)
-    {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
-    }
-
-    void
-    insertScheduledWakeupTime(Tick time)
-    {
-        m_scheduled_wakeups.insert(time);
-    }
-
     void scheduleEventAbsolute(Tick timeAbs);
 
+    //! The event queue the wakeups are scheduled on.
+    EventQueue *consumerQueue() const { return em->eventQueue(); }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    /**
+     * Run a scheduled wakeup, first moving the event on to the next
+     * pending wakeup time, if any.
+     */
+    void processWakeup();
+
     ClockedObject *em;
 
+    /**
+     * Wakeup times after the one the event is scheduled for, as a
+     * min-heap. Times may be repeated, and are dropped once they are
+     * not in the future anymore when the event runs.
+     */
+    std::vector<Tick> m_pending_wakeups;
+
     class ConsumerEvent : public Event
     {
       public:
           ConsumerEvent(Consumer* _consumer)
-              : Event(Default_Pri, AutoDelete), m_consumer_ptr(_consumer)
+              : Event(Default_Pri), m_consumer_ptr(_consumer)
           {
           }
 
-          void process() { m_consumer_ptr->wakeup(); }
+          void process() { m_consumer_ptr->processWakeup(); }
 
       private:
           Consumer* m_consumer_ptr;
     };
+
+    /**
+     * The one event of this consumer, which is always scheduled for
+     * the earliest requested wakeup.
+     */
+    ConsumerEvent m_wakeup_event;
 };
 
 inline std::ostream&
@@ -28,10 +28,15 @@
 
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/system/System.hh"
+#include "sim/event_pool.hh"
+
+// The blocks of messages come and go with every hop, so they are
+// taken from the EventPool rather than the general purpose heap
 
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t *>(
+        EventPool::allocate(RubySystem::getBlockSizeBytes()));
     memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
     m_alloc = true;
 }
@@ -39,11 +44,18 @@ DataBlock::DataBlock(const DataBlock &cp)
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t *>(
+        EventPool::allocate(RubySystem::getBlockSizeBytes()));
     m_alloc = true;
     clear();
 }
 
+void
+DataBlock::release()
+{
+    EventPool::release(m_data, RubySystem::getBlockSizeBytes());
+}
+
 void
 DataBlock::clear()
 {
@@ -77,6 +89,13 @@ DataBlock::getData(int offset, int len) const
     return &m_data[offset];
 }
 
+uint8_t*
+DataBlock::getDataMod(int offset)
+{
+    assert(offset < RubySystem::getBlockSizeBytes());
+    return &m_data[offset];
+}
+
 void
 DataBlock::setData(const uint8_t *data, int offset, int len)
 {
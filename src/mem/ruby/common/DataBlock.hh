@@ -48,7 +48,7 @@ class DataBlock
     ~DataBlock()
     {
         if (m_alloc)
-            delete [] m_data;
+            release();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -58,6 +58,7 @@ class DataBlock
     void clear();
     uint8_t getByte(int whichByte) const;
     const uint8_t *getData(int offset, int len) const;
+    uint8_t *getDataMod(int offset);
     void setByte(int whichByte, uint8_t data);
     void setData(const uint8_t *data, int offset, int len);
     void copyPartial(const DataBlock & dblk, int offset, int len);
@@ -66,6 +67,7 @@ class DataBlock
 
   private:
     void alloc();
+    void release();
     uint8_t *m_data;
     bool m_alloc;
 };
@@ -75,7 +77,7 @@ DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
     if (m_alloc) {
-        delete [] m_data;
+        release();
     }
     m_data = data;
     m_alloc = false;
@@ -45,8 +45,8 @@ NetDest::add(MachineID newElement)
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    assert(MachineType_NUM == netDest.getSize());
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].addSet(netDest.m_bits[i]);
     }
 }
@@ -69,8 +69,8 @@ NetDest::remove(MachineID oldElement)
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    assert(MachineType_NUM == netDest.getSize());
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].removeSet(netDest.m_bits[i]);
     }
 }
@@ -78,7 +78,7 @@ NetDest::removeNetDest(const NetDest& netDest)
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].clear();
     }
 }
@@ -107,7 +107,7 @@ NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
     dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         for (int j = 0; j < m_bits[i].getSize(); j++) {
             if (m_bits[i].isElement(j)) {
                 int id = MachineType_base_number((MachineType)i) + j;
@@ -122,7 +122,7 @@ int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         counter += m_bits[i].count();
     }
     return counter;
@@ -138,12 +138,11 @@ MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (int i = 0; i < MachineType_NUM; i++) {
+        if (!m_bits[i].isEmpty()) {
+            MachineID mach = {MachineType_from_base_level(i),
+                              m_bits[i].smallestElement()};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -152,12 +151,10 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    const Set &bits = m_bits[MachineType_base_level(machine)];
+    if (!bits.isEmpty()) {
+        MachineID mach = {machine, bits.smallestElement()};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -167,7 +164,7 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isBroadcast()) {
             return false;
         }
@@ -179,7 +176,7 @@ NetDest::isBroadcast() const
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isEmpty()) {
             return false;
         }
@@ -191,9 +188,9 @@ NetDest::isEmpty() const
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
+    assert(MachineType_NUM == orNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
     }
     return result;
@@ -203,9 +200,9 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
+    assert(MachineType_NUM == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
     }
     return result;
@@ -215,8 +212,8 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    assert(MachineType_NUM == other_netDest.getSize());
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
             return true;
         }
@@ -227,9 +224,9 @@ NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
+    assert(MachineType_NUM == test.getSize());
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isSuperset(test.m_bits[i])) {
             return false;
         }
@@ -246,10 +243,9 @@ NetDest::isElement(MachineID element) const
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
+    assert(MachineType_base_level(MachineType_NUM) == MachineType_NUM);
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].setSize(MachineType_base_count((MachineType)i));
     }
 }
@@ -257,9 +253,9 @@ NetDest::resize()
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         for (int j = 0; j < m_bits[i].getSize(); j++) {
             out << (bool) m_bits[i].isElement(j) << " ";
         }
@@ -271,8 +267,7 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
+    for (unsigned int i = 0; i < MachineType_NUM; ++i) {
         if (!m_bits[i].isEqual(n.m_bits[i]))
             return false;
     }
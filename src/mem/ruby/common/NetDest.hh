@@ -86,10 +86,25 @@ class NetDest
     std::vector<NodeID> getAllDest();
 
     MachineID smallestElement() const;
+
+    // Call f(MachineID) for each element, in order of machine type and
+    // then number
+    template <class F>
+    void
+    forEachElement(F f) const
+    {
+        for (int i = 0; i < MachineType_NUM; i++) {
+            MachineType type = MachineType_from_base_level(i);
+            m_bits[i].forEachElement([&](NodeID num) {
+                MachineID mach = {type, num};
+                f(mach);
+            });
+        }
+    }
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -103,13 +118,14 @@ class NetDest
     vecIndex(MachineID m) const
     {
         int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
+        assert(vec_index < MachineType_NUM);
         return vec_index;
     }
 
     NodeID bitIndex(NodeID index) const { return index; }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // a bit vector - i.e. Set - per machine type, held inline
+    Set m_bits[MachineType_NUM];
 };
 
 inline std::ostream&
@@ -32,81 +32,99 @@
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
+#include <cassert>
 #include <iostream>
-#include <limits>
 
+#include "base/types.hh"
+#include "config/number_bits_per_set.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
 /*
- * This defines the number of longs (32-bits on 32 bit machines,
- * 64-bit on 64-bit AMD machines) to use to hold the set...
- * the default is 4, allowing 128 or 256 different members
- * of the set.
- *
- * This should never need to be changed for correctness reasons,
- * though increasing it will increase performance for larger
- * set sizes at the cost of a (much) larger memory footprint
- *
+ * The bits of a set are held inline in NUMBER_BITS_PER_SET / 64 words,
+ * as set by the NUMBER_BITS_PER_SET build option, so that sets are
+ * cheap to copy and all operations are a loop over a handful of words
+ * with counts and searches done with popcount/ctz. The size of a set
+ * is still set at run time, and may not exceed NUMBER_BITS_PER_SET.
  */
-const int NUMBER_WORDS_PER_SET = 1;
-
 class Set
 {
   private:
-    int m_nSize;              // the number of bits in this set
-    int m_nArrayLen;          // the number of 32-bit words that are
-                              // held in the array
-
-    // Changed 5/24/05 for static allocation of array
-    // note that "long" corresponds to 32 bits on a 32-bit machine,
-    // 64 bits if the -m64 parameter is passed to g++, which it is
-    // for an AMD opteron under our configuration
+    static const int WORD_BITS = 64;
+    static const int NUM_WORDS =
+        (NUMBER_BITS_PER_SET + WORD_BITS - 1) / WORD_BITS;
 
-    long *m_p_nArray;      // an word array to hold the bits in the set
-    long m_p_nArray_Static[NUMBER_WORDS_PER_SET];
+    int m_nSize;              // the number of bits in this set
 
-    static const int LONG_BITS = std::numeric_limits<long>::digits + 1;
-    static const int INDEX_SHIFT = LONG_BITS == 64 ? 6 : 5;
-    static const int INDEX_MASK = (1 << INDEX_SHIFT) - 1;
+    // bits beyond m_nSize are always zero
+    uint64_t m_bits[NUM_WORDS];
 
-    void clearExcess();
+    static uint64_t
+    bitMask(NodeID index)
+    {
+        return ULL(1) << (index % WORD_BITS);
+    }
 
   public:
-    Set();
-    Set(int size);
-    Set(const Set& obj);
-    ~Set();
-
-    Set& operator=(const Set& obj);
+    Set() : m_nSize(0) { clear(); }
+    Set(int size) : m_nSize(0) { setSize(size); }
 
     void
     add(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] |=
-            (((unsigned long) 1) << (index & INDEX_MASK));
+        assert(index < m_nSize);
+        m_bits[index / WORD_BITS] |= bitMask(index);
     }
 
-    void addSet(const Set& set);
+    void
+    addSet(const Set& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_bits[i] |= set.m_bits[i];
+    }
 
     void
     remove(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] &=
-            ~(((unsigned long)1) << (index & INDEX_MASK));
+        assert(index < m_nSize);
+        m_bits[index / WORD_BITS] &= ~bitMask(index);
     }
 
-    void removeSet(const Set& set);
+    void
+    removeSet(const Set& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_bits[i] &= ~set.m_bits[i];
+    }
 
     void
     clear()
     {
-        for (int i = 0; i < m_nArrayLen; i++)
-            m_p_nArray[i] = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_bits[i] = 0;
     }
 
     void broadcast();
-    int count() const;
-    bool isEqual(const Set& set) const;
+
+    int
+    count() const
+    {
+        int counter = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            counter += __builtin_popcountll(m_bits[i]);
+        return counter;
+    }
+
+    bool
+    isEqual(const Set& set) const
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            if (m_bits[i] != set.m_bits[i])
+                return false;
+        return true;
+    }
 
     // return the logical OR of this set and orSet
     Set OR(const Set& orSet) const;
@@ -118,27 +136,54 @@ class Set
     bool
     intersectionIsEmpty(const Set& other_set) const
     {
-        for (int i = 0; i < m_nArrayLen; i++)
-            if (m_p_nArray[i] & other_set.m_p_nArray[i])
+        for (int i = 0; i < NUM_WORDS; i++)
+            if (m_bits[i] & other_set.m_bits[i])
+                return false;
+        return true;
+    }
+
+    bool
+    isSuperset(const Set& test) const
+    {
+        assert(m_nSize == test.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            if (test.m_bits[i] & ~m_bits[i])
                 return false;
         return true;
     }
 
-    bool isSuperset(const Set& test) const;
     bool isSubset(const Set& test) const { return test.isSuperset(*this); }
 
     bool
     isElement(NodeID element) const
     {
-        return (m_p_nArray[element>>INDEX_SHIFT] &
-            (((unsigned long)1) << (element & INDEX_MASK))) != 0;
+        return (m_bits[element / WORD_BITS] & bitMask(element)) != 0;
     }
 
-    bool isBroadcast() const;
-    bool isEmpty() const;
+    bool isBroadcast() const { return count() == m_nSize; }
+
+    bool
+    isEmpty() const
+    {
+        for (int i = 0; i < NUM_WORDS; i++)
+            if (m_bits[i])
+                return false;
+        return true;
+    }
 
     NodeID smallestElement() const;
 
+    // Call f(NodeID) for each element, in increasing order
+    template <class F>
+    void
+    forEachElement(F f) const
+    {
+        for (int i = 0; i < NUM_WORDS; i++) {
+            for (uint64_t bits = m_bits[i]; bits; bits &= bits - 1)
+                f(NodeID(i * WORD_BITS + __builtin_ctzll(bits)));
+        }
+    }
+
     void setSize(int size);
 
     NodeID
@@ -48,6 +48,25 @@ class AbstractBloomFilter
     virtual int getCount(const Address& addr) = 0;
     virtual int getTotalCount() = 0;
 
+    /**
+     * Set, or test, a batch of addresses at once.  Filters whose
+     * hashing benefits from working on several addresses override
+     * these; by default they go one address at a time.
+     */
+    virtual void
+    setBatch(const Address *addrs, int num_addrs)
+    {
+        for (int i = 0; i < num_addrs; i++)
+            set(addrs[i]);
+    }
+
+    virtual void
+    isSetBatch(const Address *addrs, int num_addrs, bool *results)
+    {
+        for (int i = 0; i < num_addrs; i++)
+            results[i] = isSet(addrs[i]);
+    }
+
     virtual void print(std::ostream& out) const = 0;
 
     virtual int getIndex(const Address& addr) = 0;
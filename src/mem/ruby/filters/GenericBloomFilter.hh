@@ -55,6 +55,11 @@ class GenericBloomFilter
 
     bool isSet(const Address& addr);
 
+    void setBatch(const Address *addrs, int num_addrs)
+    { m_filter->setBatch(addrs, num_addrs); }
+    void isSetBatch(const Address *addrs, int num_addrs, bool *results)
+    { m_filter->isSetBatch(addrs, num_addrs, results); }
+
     int getCount(const Address& addr);
 
     int getTotalCount();
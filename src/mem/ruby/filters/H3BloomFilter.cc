@@ -27,6 +27,7 @@
  */
 
 #include "base/intmath.hh"
+#include "base/misc.hh"
 #include "base/str.hh"
 #include "mem/ruby/filters/H3BloomFilter.hh"
 
@@ -399,6 +400,23 @@ H3BloomFilter::H3BloomFilter(string str)
     m_par_filter_size = m_filter_size / m_num_hashes;
     m_par_filter_size_bits = floorLog2(m_par_filter_size);
 
+    if (m_num_hashes < 1 || m_num_hashes > 16)
+        fatal("H3 Bloom filter supports 1 to 16 hashes, not %d\n",
+              m_num_hashes);
+
+    m_h3_bytes.assign(m_num_hashes * 8 * 256, 0);
+    for (int h = 0; h < m_num_hashes; h++) {
+        for (int byte = 0; byte < 8; byte++) {
+            int *table = &m_h3_bytes[(h * 8 + byte) * 256];
+            for (int v = 0; v < 256; v++) {
+                for (int bit = 0; bit < 8; bit++) {
+                    if (v & (1 << bit))
+                        table[v] ^= h3Row(byte * 8 + bit, h);
+                }
+            }
+        }
+    }
+
     m_filter.resize(m_filter_size);
     clear();
 }
@@ -465,6 +483,29 @@ H3BloomFilter::isSet(const Address& addr)
     return res;
 }
 
+// The batch versions go hash by hash over all of the addresses, so the
+// table lookups of different addresses are independent of each other.
+void
+H3BloomFilter::setBatch(const Address *addrs, int num_addrs)
+{
+    for (int i = 0; i < m_num_hashes; i++) {
+        for (int j = 0; j < num_addrs; j++)
+            m_filter[get_index(addrs[j], i)] = 1;
+    }
+}
+
+void
+H3BloomFilter::isSetBatch(const Address *addrs, int num_addrs, bool *results)
+{
+    for (int j = 0; j < num_addrs; j++)
+        results[j] = true;
+
+    for (int i = 0; i < m_num_hashes; i++) {
+        for (int j = 0; j < num_addrs; j++)
+            results[j] = results[j] && m_filter[get_index(addrs[j], i)];
+    }
+}
+
 int
 H3BloomFilter::getCount(const Address& addr)
 {
@@ -519,15 +560,21 @@ H3BloomFilter::get_index(const Address& addr, int i)
 }
 
 int
-H3BloomFilter::hash_H3(uint64 value, int index)
+H3BloomFilter::h3Row(int bit, int hashNumber)
+{
+    assert(bit >= 0 && bit < 64 && hashNumber >= 0 && hashNumber < 16);
+    return H3[bit][hashNumber];
+}
+
+int
+H3BloomFilter::hash_H3(uint64 value, int index) const
 {
-    uint64 mask = 1;
-    uint64 val = value;
+    const int *table = &m_h3_bytes[index * 8 * 256];
     int result = 0;
 
-    for (int i = 0; i < 64; i++) {
-        if(val&mask) result ^= H3[i][index];
-        val = val >> 1;
+    for (int byte = 0; byte < 8; byte++) {
+        result ^= table[byte * 256 + (value & 0xff)];
+        value >>= 8;
     }
     return result;
 }
@@ -50,10 +50,16 @@ class H3BloomFilter : public AbstractBloomFilter
     void unset(const Address& addr);
 
     bool isSet(const Address& addr);
+    void setBatch(const Address *addrs, int num_addrs);
+    void isSetBatch(const Address *addrs, int num_addrs, bool *results);
     int getCount(const Address& addr);
     int getTotalCount();
     void print(std::ostream& out) const;
 
+    //! The H3 row of an address bit for a hash: the hash of an address
+    //! is the XOR of the rows of its set bits
+    static int h3Row(int bit, int hashNumber);
+
     int getIndex(const Address& addr);
     int readBit(const int index);
     void writeBit(const int index, const int value);
@@ -67,7 +73,12 @@ class H3BloomFilter : public AbstractBloomFilter
   private:
     int get_index(const Address& addr, int hashNumber);
 
-    int hash_H3(uint64 value, int index);
+    int hash_H3(uint64 value, int index) const;
+
+    //! The H3 rows of each hash folded into one table per address byte,
+    //! [hash][byte][value], so a hash takes a lookup per byte instead of
+    //! a step per bit
+    std::vector<int> m_h3_bytes;
 
     std::vector<int> m_filter;
     int m_filter_size;
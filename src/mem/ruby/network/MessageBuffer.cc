@@ -35,13 +35,18 @@
 #include "debug/RubyQueue.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/system/System.hh"
+#include "sim/quantum.hh"
 
 using namespace std;
 using m5::stl_helpers::operator<<;
 
+std::atomic<int64_t> MessageBuffer::s_buffered_messages(0);
+
 MessageBuffer::MessageBuffer(const string &name)
     : m_time_last_time_size_checked(0), m_time_last_time_enqueue(0),
-    m_time_last_time_pop(0), m_last_arrival_time(0)
+    m_time_last_time_pop(0), m_last_arrival_time(0),
+    m_crossing_checked(false),
+    m_crosses_queues(false), m_receive_scheduled(false)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
@@ -59,7 +64,6 @@ MessageBuffer::MessageBuffer(const string &name)
     m_priority_rank = 0;
     m_name = name;
 
-    m_stall_msg_map.clear();
     m_input_link_id = 0;
     m_vnet_id = 0;
 }
@@ -69,7 +73,7 @@ MessageBuffer::getSize()
 {
     if (m_time_last_time_size_checked != m_receiver->curCycle()) {
         m_time_last_time_size_checked = m_receiver->curCycle();
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = m_msg_queue.size();
     }
 
     return m_size_last_time_size_checked;
@@ -92,7 +96,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n)
 
     if (m_time_last_time_pop < m_sender->clockEdge()) {
         // no pops this cycle - heap size is correct
-        current_size = m_prio_heap.size();
+        current_size = m_msg_queue.size();
     } else {
         if (m_time_last_time_enqueue < m_sender->curCycle()) {
             // no enqueues this cycle - m_size_at_cycle_start is correct
@@ -110,7 +114,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n)
     } else {
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
-                n, current_size, m_prio_heap.size(), m_max_size);
+                n, current_size, m_msg_queue.size(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -122,7 +126,7 @@ MessageBuffer::peek() const
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
     assert(isReady());
 
-    const Message* msg_ptr = m_prio_heap.front().m_msgptr.get();
+    const Message* msg_ptr = m_msg_queue.front().m_msgptr.get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -154,6 +158,7 @@ MessageBuffer::enqueue(MsgPtr message, Cycles delta)
 
     m_msg_counter++;
     m_msgs_this_cycle++;
+    s_buffered_messages++;
 
     // Calculate the arrival time of the message, that is, the first
     // cycle the message can be dequeued.
@@ -178,6 +183,9 @@ MessageBuffer::enqueue(MsgPtr message, Cycles delta)
         }
     }
 
+    if (!m_crossing_checked)
+        checkQueueCrossing();
+
     // Check the arrival time
     assert(arrival_time > current_time);
     if (m_strict_fifo) {
@@ -205,21 +213,84 @@ MessageBuffer::enqueue(MsgPtr message, Cycles delta)
     msg_ptr->updateDelayedTicks(m_sender->clockEdge());
     msg_ptr->setLastEnqueueTime(arrival_time);
 
-    // Insert the message into the priority heap
-    MessageBufferNode thisNode(arrival_time, m_msg_counter, message);
-    m_prio_heap.push_back(thisNode);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
-
     DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
             arrival_time, *(message.get()));
 
+    if (m_crosses_queues && inParallelMode) {
+        Tick latency = arrival_time - curTick();
+        if (latency < simQuantum && !quantumController.adaptive())
+            fatal("MessageBuffer %s crosses event queues, but a message "
+                  "was enqueued with a delay of %d ticks, shorter than the "
+                  "simulation quantum (%d ticks)\n", m_name,
+                  latency, simQuantum);
+
+        // An adaptive quantum may delay the message to its end
+        arrival_time = curTick() +
+            quantumController.crossQueue(latency, simQuantum);
+        msg_ptr->setLastEnqueueTime(arrival_time);
+
+        std::lock_guard<std::mutex> lock(m_posted_mutex);
+        m_posted.push_back(MessageBufferNode(arrival_time, m_msg_counter,
+                                             message));
+        if (!m_receive_scheduled) {
+            m_receive_scheduled = true;
+            m_receiver->eventQueue()->schedule(new ReceiveEvent(this),
+                                               curTick() + simQuantum,
+                                               true);
+        }
+        return;
+    }
+
+    // Insert the message into the queue
+    insertNode(MessageBufferNode(arrival_time, m_msg_counter, message));
+
     // Schedule the wakeup
     assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+void
+MessageBuffer::checkQueueCrossing()
+{
+    m_crossing_checked = true;
+    m_crosses_queues = m_receiver != NULL &&
+        m_sender->eventQueue() != m_receiver->eventQueue();
+    if (!m_crosses_queues)
+        return;
+
+    // The sender may not look at the receiver's side of the buffer,
+    // nor draw random delays from the shared generator
+    if (m_max_size != 0)
+        fatal("MessageBuffer %s crosses event queues and must be of "
+              "unlimited size\n", m_name);
+    if (RubySystem::getRandomization() && m_randomization)
+        fatal("MessageBuffer %s crosses event queues, which needs Ruby "
+              "randomization to be off\n", m_name);
+
+    DPRINTF(RubyQueue, "%s crosses event queues\n", m_name);
+}
+
+void
+MessageBuffer::receivePosted()
+{
+    std::vector<MessageBufferNode> posted;
+    {
+        std::lock_guard<std::mutex> lock(m_posted_mutex);
+        posted.swap(m_posted);
+        m_receive_scheduled = false;
+    }
+
+    // Messages are posted in order of message counter, and mostly of
+    // arrival time, so they mostly append to the queue
+    for (auto &node : posted) {
+        assert(node.m_time >= curTick());
+        insertNode(node);
+        m_consumer->scheduleEventAbsolute(node.m_time);
+    }
+    m_consumer->storeEventInfo(m_vnet_id);
+}
+
 Cycles
 MessageBuffer::dequeue()
 {
@@ -227,7 +298,7 @@ MessageBuffer::dequeue()
     assert(isReady());
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front().m_msgptr;
+    MsgPtr message = m_msg_queue.front().m_msgptr;
 
     // get the delay cycles
     message->updateDelayedTicks(m_receiver->clockEdge());
@@ -237,13 +308,12 @@ MessageBuffer::dequeue()
     // record previous size and time so the current buffer size isn't
     // adjusted until next cycle
     if (m_time_last_time_pop < m_receiver->clockEdge()) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = m_msg_queue.size();
         m_time_last_time_pop = m_receiver->clockEdge();
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
-    m_prio_heap.pop_back();
+    m_msg_queue.pop_front();
+    s_buffered_messages--;
 
     return delayCycles;
 }
@@ -251,7 +321,13 @@ MessageBuffer::dequeue()
 void
 MessageBuffer::clear()
 {
-    m_prio_heap.clear();
+    s_buffered_messages -= m_msg_queue.size();
+    m_msg_queue.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_posted_mutex);
+        s_buffered_messages -= m_posted.size();
+        m_posted.clear();
+    }
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = Cycles(0);
@@ -265,31 +341,42 @@ MessageBuffer::recycle()
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady());
-    MessageBufferNode node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
+    MessageBufferNode node = m_msg_queue.front();
+    m_msg_queue.pop_front();
 
     node.m_time = m_receiver->clockEdge(m_recycle_latency);
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
+    insertNode(node);
     m_consumer->
         scheduleEventAbsolute(m_receiver->clockEdge(m_recycle_latency));
 }
 
 void
-MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick nextTick)
+MessageBuffer::insertNode(const MessageBufferNode &node)
 {
-    while(!lt.empty()) {
-        m_msg_counter++;
-        MessageBufferNode msgNode(nextTick, m_msg_counter, lt.front());
+    if (m_msg_queue.empty() || node > m_msg_queue.back()) {
+        m_msg_queue.push_back(node);
+    } else {
+        // e.g. a recycled or reanalysed message
+        m_msg_queue.insert(upper_bound(m_msg_queue.begin(), m_msg_queue.end(),
+                                       node,
+                                       [](const MessageBufferNode &n,
+                                          const MessageBufferNode &e)
+                                       { return e > n; }),
+                           node);
+    }
+}
+
+void
+MessageBuffer::reanalyzeList(MsgPtr message, Tick nextTick)
+{
+    while (message) {
+        MsgPtr next = std::move(message->m_next_stalled);
 
-        m_prio_heap.push_back(msgNode);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MessageBufferNode>());
+        m_msg_counter++;
+        insertNode(MessageBufferNode(nextTick, m_msg_counter, message));
 
         m_consumer->scheduleEventAbsolute(nextTick);
-        lt.pop_front();
+        message = std::move(next);
     }
 }
 
@@ -297,15 +384,17 @@ void
 MessageBuffer::reanalyzeMessages(const Address& addr)
 {
     DPRINTF(RubyQueue, "ReanalyzeMessages\n");
-    assert(m_stall_msg_map.count(addr) > 0);
+    StallEntry *entry = m_stall_table.find(addr);
+    assert(entry);
     Tick nextTick = m_receiver->clockEdge(Cycles(1));
 
     //
     // Put all stalled messages associated with this address back on the
-    // prio heap
+    // queue
     //
-    reanalyzeList(m_stall_msg_map[addr], nextTick);
-    m_stall_msg_map.erase(addr);
+    MsgPtr head = std::move(entry->head);
+    m_stall_table.erase(addr);
+    reanalyzeList(std::move(head), nextTick);
 }
 
 void
@@ -315,14 +404,20 @@ MessageBuffer::reanalyzeAllMessages()
     Tick nextTick = m_receiver->clockEdge(Cycles(1));
 
     //
-    // Put all stalled messages associated with this address back on the
-    // prio heap
+    // Put all stalled messages back on the queue, in address order
     //
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end(); ++map_iter) {
-        reanalyzeList(map_iter->second, nextTick);
-    }
-    m_stall_msg_map.clear();
+    typedef OpenHashMap<Address, StallEntry>::Entry TableEntry;
+    vector<TableEntry *> entries;
+    for (auto &entry : m_stall_table)
+        entries.push_back(&entry);
+    sort(entries.begin(), entries.end(),
+         [](const TableEntry *a, const TableEntry *b)
+         { return a->key < b->key; });
+
+    for (auto entry : entries)
+        reanalyzeList(std::move(entry->value.head), nextTick);
+
+    m_stall_table.clear();
 }
 
 void
@@ -331,16 +426,23 @@ MessageBuffer::stallMessage(const Address& addr)
     DPRINTF(RubyQueue, "Stalling due to %s\n", addr);
     assert(isReady());
     assert(addr.getOffset() == 0);
-    MsgPtr message = m_prio_heap.front().m_msgptr;
+    MsgPtr message = m_msg_queue.front().m_msgptr;
 
+    // the message stays in the buffer
     dequeue();
+    s_buffered_messages++;
 
     //
     // Note: no event is scheduled to analyze the map at a later time.
     // Instead the controller is responsible to call reanalyzeMessages when
     // these addresses change state.
     //
-    (m_stall_msg_map[addr]).push_back(message);
+    StallEntry &entry = *m_stall_table.insert(addr).first;
+    if (entry.head)
+        entry.tail->m_next_stalled = message;
+    else
+        entry.head = message;
+    entry.tail = message.get();
 }
 
 void
@@ -351,41 +453,40 @@ MessageBuffer::print(ostream& out) const
         ccprintf(out, " consumer-yes ");
     }
 
-    vector<MessageBufferNode> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MessageBufferNode>());
-    ccprintf(out, "%s] %s", copy, m_name);
+    ccprintf(out, "%s] %s", m_msg_queue, m_name);
 }
 
 bool
 MessageBuffer::isReady() const
 {
-    return ((m_prio_heap.size() > 0) &&
-            (m_prio_heap.front().m_time <= m_receiver->clockEdge()));
+    return (!m_msg_queue.empty() &&
+            (m_msg_queue.front().m_time <= m_receiver->clockEdge()));
 }
 
 bool
 MessageBuffer::functionalRead(Packet *pkt)
 {
-    // Check the priority heap and read any messages that may
+    // Check the queue and read any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].m_msgptr.get();
+    for (unsigned int i = 0; i < m_msg_queue.size(); ++i) {
+        Message *msg = m_msg_queue[i].m_msgptr.get();
         if (msg->functionalRead(pkt)) return true;
     }
 
     // Read the messages in the stall queue that correspond
     // to the address in the packet.
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end();
-         ++map_iter) {
-
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
+    for (auto &entry : m_stall_table) {
+        for (Message *msg = entry.value.head.get(); msg != NULL;
+             msg = msg->m_next_stalled.get()) {
             if (msg->functionalRead(pkt)) return true;
         }
     }
+
+    // And the messages still to be received from another event queue
+    std::lock_guard<std::mutex> lock(m_posted_mutex);
+    for (auto &node : m_posted) {
+        if (node.m_msgptr->functionalRead(pkt)) return true;
+    }
     return false;
 }
 
@@ -394,10 +495,10 @@ MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the queue and write any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].m_msgptr.get();
+    for (unsigned int i = 0; i < m_msg_queue.size(); ++i) {
+        Message *msg = m_msg_queue[i].m_msgptr.get();
         if (msg->functionalWrite(pkt)) {
             num_functional_writes++;
         }
@@ -405,19 +506,21 @@ MessageBuffer::functionalWrite(Packet *pkt)
 
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end();
-         ++map_iter) {
-
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
+    for (auto &entry : m_stall_table) {
+        for (Message *msg = entry.value.head.get(); msg != NULL;
+             msg = msg->m_next_stalled.get()) {
             if (msg->functionalWrite(pkt)) {
                 num_functional_writes++;
             }
         }
     }
 
+    std::lock_guard<std::mutex> lock(m_posted_mutex);
+    for (auto &node : m_posted) {
+        if (node.m_msgptr->functionalWrite(pkt)) {
+            num_functional_writes++;
+        }
+    }
+
     return num_functional_writes;
 }
@@ -35,17 +35,22 @@
 #define __MEM_RUBY_BUFFERS_MESSAGEBUFFER_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "base/open_hash_map.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/MessageBufferNode.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 #include "mem/packet.hh"
+#include "sim/eventq.hh"
 
 class MessageBuffer
 {
@@ -67,11 +72,10 @@ class MessageBuffer
     void
     delayHead()
     {
-        MessageBufferNode node = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MessageBufferNode>());
-        m_prio_heap.pop_back();
-        enqueue(node.m_msgptr, Cycles(1));
+        MsgPtr message = m_msg_queue.front().m_msgptr;
+        m_msg_queue.pop_front();
+        s_buffered_messages--;
+        enqueue(message, Cycles(1));
     }
 
     bool areNSlotsAvailable(unsigned int n);
@@ -112,7 +116,7 @@ class MessageBuffer
     peekMsgPtr() const
     {
         assert(isReady());
-        return m_prio_heap.front().m_msgptr;
+        return m_msg_queue.front().m_msgptr;
     }
 
     void enqueue(MsgPtr message) { enqueue(message, Cycles(1)); }
@@ -123,7 +127,7 @@ class MessageBuffer
     Cycles dequeue();
 
     void recycle();
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return m_msg_queue.empty(); }
 
     void
     setOrdering(bool order)
@@ -154,8 +158,47 @@ class MessageBuffer
     // This required for debugging the code.
     uint32_t functionalWrite(Packet *pkt);
 
+    //! Whether any message buffer holds a message, queued, posted or
+    //! stalled.  When none does, functional writes need not search them.
+    static bool anyBuffered() { return s_buffered_messages != 0; }
+
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    // Stalled messages of one address, chained through the messages
+    struct StallEntry
+    {
+        StallEntry() : tail(NULL) {}
+
+        MsgPtr head;
+        Message *tail;
+    };
+
+    //! Insert a node in order of arrival time and message counter.
+    void insertNode(const MessageBufferNode &node);
+
+    //! Put a chain of stalled messages back on the queue.
+    void reanalyzeList(MsgPtr head, Tick);
+
+    //! Work out on the first enqueue whether the two ends are on
+    //! different event queues, and whether this buffer can be crossed.
+    void checkQueueCrossing();
+
+    //! Move the messages posted by the sending thread to the queue.
+    void receivePosted();
+
+    class ReceiveEvent : public PooledEvent<>
+    {
+      public:
+        ReceiveEvent(MessageBuffer *buffer)
+            : PooledEvent<>(Default_Pri, AutoDelete), m_buffer(buffer)
+        {
+        }
+
+        void process() { m_buffer->receivePosted(); }
+        const char *description() const { return "MessageBuffer receive"; }
+
+      private:
+        MessageBuffer *m_buffer;
+    };
 
   private:
     //added by SS
@@ -168,15 +211,30 @@ class MessageBuffer
 
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
-    std::vector<MessageBufferNode> m_prio_heap;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map< Address, std::list<MsgPtr> > StallMsgMapType;
+    // Messages sorted by arrival time and message counter. Messages
+    // mostly arrive in order, so that the messages of a tick form a
+    // FIFO run and are appended at the back.
+    std::deque<MessageBufferNode> m_msg_queue;
 
-    StallMsgMapType m_stall_msg_map;
+    // Open-addressed table of the stalled messages per address.
+    // Addresses are visited in sorted order when reanalysing them
+    // all, to keep a well-defined order.
+    OpenHashMap<Address, StallEntry> m_stall_table;
     std::string m_name;
 
+    // When the sender and the receiver are on different event queues,
+    // messages enqueued while the queues run in parallel are posted
+    // here by the sending thread. The receiving thread moves them to
+    // m_msg_queue at a receive event, of which one is scheduled per
+    // quantum that posts messages, one quantum ahead: every message
+    // arrives at least a quantum after it is enqueued, so none is late.
+    bool m_crossing_checked;
+    bool m_crosses_queues;
+    std::mutex m_posted_mutex;
+    std::vector<MessageBufferNode> m_posted;
+    bool m_receive_scheduled;
+
     unsigned int m_max_size;
     Cycles m_time_last_time_size_checked;
     unsigned int m_size_last_time_size_checked;
@@ -190,6 +248,9 @@ class MessageBuffer
     unsigned int m_size_at_cycle_start;
     unsigned int m_msgs_this_cycle;
 
+    //! Messages held by all the buffers
+    static std::atomic<int64_t> s_buffered_messages;
+
     int m_not_avail_count;  // count the # of times I didn't have N
                             // slots available
     uint64 m_msg_counter;
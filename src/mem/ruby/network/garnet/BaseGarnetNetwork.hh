@@ -36,6 +36,8 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_BASEGARNETNETWORK_HH__
 #define __MEM_RUBY_NETWORK_GARNET_BASEGARNETNETWORK_HH__
 
+#include <mutex>
+
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
@@ -53,18 +55,31 @@ class BaseGarnetNetwork : public Network
     bool isFaultModelEnabled() {return m_enable_fault_model;}
     FaultModel* fault_model;
 
-    void increment_injected_flits(int vnet) { m_flits_injected[vnet]++; }
-    void increment_received_flits(int vnet) { m_flits_received[vnet]++; }
+    void
+    increment_injected_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_injected[vnet]++;
+    }
+
+    void
+    increment_received_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_received[vnet]++;
+    }
 
     void
     increment_network_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_network_latency[vnet] += latency;
     }
 
     void
     increment_queueing_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_queueing_latency[vnet] += latency;
     }
 
@@ -83,6 +98,18 @@ class BaseGarnetNetwork : public Network
     virtual void collateStats() {}
 
   protected:
+    // The interfaces update the network-wide counters from the threads
+    // of their event queues, when the network spans several of them.
+    std::unique_lock<std::mutex>
+    statsLock()
+    {
+        if (inParallelMode)
+            return std::unique_lock<std::mutex>(m_stats_mutex);
+        return std::unique_lock<std::mutex>();
+    }
+
+    std::mutex m_stats_mutex;
+
     int m_ni_flit_size;
     int m_vcs_per_vnet;
     bool m_enable_fault_model;
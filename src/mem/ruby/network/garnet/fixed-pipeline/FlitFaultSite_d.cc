@@ -0,0 +1,56 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFaultSite_d.hh"
+#include "mem/ruby/system/System.hh"
+
+unsigned int
+FlitFaultSite_d::entryBits() const
+{
+    return m_drop ? 1 : RubySystem::getBlockSizeBytes() * 8;
+}
+
+void
+FlitFaultSite_d::flipBit(unsigned int index, unsigned int bit,
+                         unsigned int fault)
+{
+    m_armed |= uint64_t(1) << fault;
+    m_points[index]->armFault(m_drop, bit, fault, &m_applied);
+}
+
+std::string
+FlitFaultSite_d::outcome(unsigned int fault) const
+{
+    uint64_t bit = uint64_t(1) << fault;
+
+    if (!(m_armed & bit))
+        return "not_injected";
+    else if (!(m_applied & bit))
+        return "dormant";
+    else
+        return m_drop ? "dropped" : "corrupted";
+}
@@ -0,0 +1,74 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_SITE_D_HH__
+#define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_SITE_D_HH__
+
+#include <string>
+#include <vector>
+
+#include "cpu/fault_injector.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFault_d.hh"
+
+/**
+ * The routers or the links of a garnet network as a FaultInjector
+ * site, one entry per router or link.  In a corrupting site an entry is
+ * a data block wide and a flip arms the corruption of that bit of the
+ * next block through the router or link.  In a dropping site an entry
+ * is one bit wide and a flip arms the loss of the next packet.  A lost
+ * packet is discarded by its destination interface, which still returns
+ * the credits, so the network keeps flowing and only the coherence
+ * protocol sees the loss.
+ *
+ * The site classifies its own faults as dormant (armed but no flit came
+ * by before the end of simulation), corrupted or dropped.
+ */
+class FlitFaultSite_d : public FaultSite, public FaultTracker
+{
+  protected:
+    std::vector<FlitFaultPoint_d *> m_points;
+    bool m_drop;
+
+    /** Faults armed and applied so far, one bit per fault of the batch */
+    uint64_t m_armed;
+    uint64_t m_applied;
+
+  public:
+    FlitFaultSite_d(const std::vector<FlitFaultPoint_d *> &points,
+                    bool drop)
+        : m_points(points), m_drop(drop), m_armed(0), m_applied(0)
+    { }
+
+    unsigned int numEntries() const { return m_points.size(); }
+    unsigned int entryBits() const;
+    void flipBit(unsigned int index, unsigned int bit, unsigned int fault);
+
+    FaultTracker *tracker() { return this; }
+    std::string outcome(unsigned int fault) const;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_SITE_D_HH__
@@ -0,0 +1,61 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/trace.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFault_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/flit_d.hh"
+
+void
+FlitFaultPoint_d::armFault(bool drop, unsigned int bit, unsigned int fault,
+                           uint64_t *applied)
+{
+    m_fault_armed = true;
+    m_fault_drop = drop;
+    m_fault_bit = bit;
+    m_fault = fault;
+    m_fault_applied = applied;
+}
+
+void
+FlitFaultPoint_d::applyFault(flit_d *t_flit)
+{
+    if (m_fault_drop) {
+        DPRINTF(RubyNetwork, "Fault %d drops the packet of %s\n", m_fault,
+                *t_flit);
+        t_flit->set_dropped();
+    } else {
+        MsgPtr &msg = t_flit->get_msg_ptr();
+        if (!msg || !msg->flipDataBit(m_fault_bit))
+            return;
+        DPRINTF(RubyNetwork, "Fault %d flips data bit %d of %s\n", m_fault,
+                m_fault_bit, *t_flit);
+    }
+
+    *m_fault_applied |= uint64_t(1) << m_fault;
+    m_fault_armed = false;
+}
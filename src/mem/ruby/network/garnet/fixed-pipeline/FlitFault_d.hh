@@ -0,0 +1,69 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_D_HH__
+#define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_D_HH__
+
+#include <cstdint>
+
+class flit_d;
+
+/**
+ * A router or link into which a fault can be armed for the next flit
+ * through it: either the packet of the flit is dropped, or one bit of
+ * the data block it carries is inverted.  A corrupting fault stays
+ * armed until a flit carrying a data block comes by.  While nothing is
+ * armed a flit costs a single test of m_fault_armed.
+ */
+class FlitFaultPoint_d
+{
+  public:
+    FlitFaultPoint_d() : m_fault_armed(false) { }
+
+    /** Arm fault number fault of its batch.  Bit fault of *applied is
+     *  set once the fault reaches a flit */
+    void armFault(bool drop, unsigned int bit, unsigned int fault,
+                  uint64_t *applied);
+
+    void
+    checkFault(flit_d *t_flit)
+    {
+        if (m_fault_armed)
+            applyFault(t_flit);
+    }
+
+  private:
+    void applyFault(flit_d *t_flit);
+
+    bool m_fault_armed;
+    bool m_fault_drop;
+    unsigned int m_fault_bit;
+    unsigned int m_fault;
+    uint64_t *m_fault_applied;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_FLIT_FAULT_D_HH__
@@ -34,12 +34,15 @@
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/Global.hh"
 #include "mem/ruby/common/NetDest.hh"
+#include "config/the_isa.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/CreditLink_d.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFaultSite_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/GarnetLink_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/GarnetNetwork_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkInterface_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkLink_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/Router_d.hh"
+#include "sim/stats.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -50,6 +53,14 @@ GarnetNetwork_d::GarnetNetwork_d(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
 
+    // The per-bit figures are scaled to a flit here, once
+    int flit_bits = 8 * m_ni_flit_size;
+    m_buffer_read_energy = p->buffer_read_energy * flit_bits;
+    m_buffer_write_energy = p->buffer_write_energy * flit_bits;
+    m_crossbar_energy = p->crossbar_energy * flit_bits;
+    m_arbiter_energy = p->arbiter_energy;
+    m_link_energy = p->link_energy * flit_bits;
+
     m_vnet_type.resize(m_virtual_networks);
     for (int i = 0; i < m_vnet_type.size(); i++) {
         m_vnet_type[i] = NULL_VNET_; // default
@@ -104,6 +115,25 @@ GarnetNetwork_d::init()
             router->printFaultVector(cout);
         }
     }
+
+#if THE_ISA != NULL_ISA
+    // Make the routers and links available as fault injection targets
+    FaultInjector *injector = params()->fault_injector;
+    if (injector) {
+        vector<FlitFaultPoint_d *> routers(m_routers.begin(),
+                                          m_routers.end());
+        vector<FlitFaultPoint_d *> links(m_links.begin(), m_links.end());
+
+        injector->registerSite(name() + ".routers",
+                               new FlitFaultSite_d(routers, false));
+        injector->registerSite(name() + ".routers_drop",
+                               new FlitFaultSite_d(routers, true));
+        injector->registerSite(name() + ".links",
+                               new FlitFaultSite_d(links, false));
+        injector->registerSite(name() + ".links_drop",
+                               new FlitFaultSite_d(links, true));
+    }
+#endif
 }
 
 GarnetNetwork_d::~GarnetNetwork_d()
@@ -137,6 +167,9 @@ GarnetNetwork_d::makeInLink(NodeID src, SwitchID dest, BasicLink* link,
 
     m_routers[dest]->addInPort(net_link, credit_link);
     m_nis[src]->addOutPort(net_link, credit_link);
+
+    checkLinkQueues(link, net_link, credit_link, m_nis[src],
+                    m_routers[dest]);
 }
 
 /*
@@ -164,6 +197,9 @@ GarnetNetwork_d::makeOutLink(SwitchID src, NodeID dest, BasicLink* link,
     m_routers[src]->addOutPort(net_link, routing_table_entry,
                                          link->m_weight, credit_link);
     m_nis[dest]->addInPort(net_link, credit_link);
+
+    checkLinkQueues(link, net_link, credit_link, m_routers[src],
+                    m_nis[dest]);
 }
 
 /*
@@ -185,6 +221,27 @@ GarnetNetwork_d::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_routers[dest]->addInPort(net_link, credit_link);
     m_routers[src]->addOutPort(net_link, routing_table_entry,
                                          link->m_weight, credit_link);
+
+    checkLinkQueues(link, net_link, credit_link, m_routers[src],
+                    m_routers[dest]);
+}
+
+void
+GarnetNetwork_d::checkLinkQueues(BasicLink *link, NetworkLink_d *net_link,
+                                 CreditLink_d *credit_link,
+                                 ClockedObject *src, ClockedObject *dest)
+{
+    if (net_link->eventQueue() != src->eventQueue())
+        fatal("Link %s must be on the event queue of its source %s\n",
+              net_link->name(), src->name());
+    if (credit_link->eventQueue() != dest->eventQueue())
+        fatal("Credit link %s must be on the event queue of its source %s\n",
+              credit_link->name(), dest->name());
+
+    if (src->eventQueue() != dest->eventQueue()) {
+        limitSimQuantum(net_link->clockPeriod() * link->m_latency,
+                        "Link " + net_link->name());
+    }
 }
 
 void
@@ -218,12 +275,40 @@ GarnetNetwork_d::regStats()
         .name(name() + ".avg_vc_load")
         .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
         ;
+
+    m_link_traversals
+        .name(name() + ".link_traversals")
+        .desc("flits sent over the network links")
+        ;
+
+    m_link_dynamic_energy
+        .name(name() + ".link_dynamic_energy")
+        .desc("dynamic energy of the network links (pJ)")
+        ;
+    m_link_dynamic_energy = m_link_traversals * Stats::constant(m_link_energy);
+
+    m_dynamic_energy
+        .name(name() + ".dynamic_energy")
+        .desc("dynamic energy of the routers and links (pJ)")
+        ;
+    m_dynamic_energy = m_link_dynamic_energy;
+    for (int i = 0; i < m_routers.size(); i++)
+        m_dynamic_energy += m_routers[i]->getDynamicEnergy();
+
+    m_dynamic_power
+        .name(name() + ".dynamic_power")
+        .desc("average dynamic power of the routers and links (W)")
+        ;
+    m_dynamic_power = m_dynamic_energy * Stats::constant(1e-12) / simSeconds;
 }
 
 void
 GarnetNetwork_d::collateStats()
 {
+    m_link_traversals = 0;
     for (int i = 0; i < m_links.size(); i++) {
+        m_link_traversals += m_links[i]->getLinkUtilization();
+
         m_average_link_utilization +=
             (double(m_links[i]->getLinkUtilization())) /
             (double(curCycle() - g_ruby_start));
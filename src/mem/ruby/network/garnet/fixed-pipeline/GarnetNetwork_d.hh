@@ -44,12 +44,14 @@ class Router_d;
 class NetDest;
 class NetworkLink_d;
 class CreditLink_d;
+class CreditLink_d;
 
 class GarnetNetwork_d : public BaseGarnetNetwork
 {
   public:
     typedef GarnetNetwork_dParams Params;
     GarnetNetwork_d(const Params *p);
+    const Params *params() const { return (const Params *)_params; }
 
     ~GarnetNetwork_d();
     void init();
@@ -57,6 +59,13 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     int getBuffersPerDataVC() {return m_buffers_per_data_vc; }
     int getBuffersPerCtrlVC() {return m_buffers_per_ctrl_vc; }
 
+    // Energy of one instance of each router and link event, in pJ
+    double getBufferReadEnergy() const { return m_buffer_read_energy; }
+    double getBufferWriteEnergy() const { return m_buffer_write_energy; }
+    double getCrossbarEnergy() const { return m_crossbar_energy; }
+    double getArbiterEnergy() const { return m_arbiter_energy; }
+    double getLinkEnergy() const { return m_link_energy; }
+
     void collateStats();
     void regStats();
     void print(std::ostream& out) const;
@@ -84,6 +93,13 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     uint32_t functionalWrite(Packet *pkt);
 
   private:
+    // Check that a link runs on the event queue of its source and its
+    // credit link on that of its destination, and that a link across
+    // event queues is long enough to synchronize them.
+    void checkLinkQueues(BasicLink *link, NetworkLink_d *net_link,
+                         CreditLink_d *credit_link, ClockedObject *src,
+                         ClockedObject *dest);
+
     void checkNetworkAllocation(NodeID id, bool ordered, int network_num,
                                 std::string vnet_type);
 
@@ -99,9 +115,21 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     int m_buffers_per_data_vc;
     int m_buffers_per_ctrl_vc;
 
+    double m_buffer_read_energy;
+    double m_buffer_write_energy;
+    double m_crossbar_energy;
+    double m_arbiter_energy;
+    double m_link_energy;
+
     // Statistical variables for performance
     Stats::Scalar m_average_link_utilization;
     Stats::Vector m_average_vc_load;
+
+    // Statistical variables for power
+    Stats::Scalar m_link_traversals;
+    Stats::Formula m_link_dynamic_energy;
+    Stats::Formula m_dynamic_energy;
+    Stats::Formula m_dynamic_power;
 };
 
 inline std::ostream&
@@ -28,6 +28,7 @@
 # Authors: Steve Reinhardt
 #          Brad Beckmann
 
+from m5.defines import buildEnv
 from m5.params import *
 from m5.proxy import *
 from BaseGarnetNetwork import BaseGarnetNetwork
@@ -59,3 +60,25 @@ class GarnetNetwork_d(BaseGarnetNetwork):
     cxx_header = "mem/ruby/network/garnet/fixed-pipeline/GarnetNetwork_d.hh"
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
+
+    # Energy model evaluated from the router and link activity counts
+    # when the stats are dumped.  The defaults are rough figures for a
+    # 45nm process and should be calibrated for the design at hand.
+    buffer_read_energy = Param.Float(0.02,
+        "input buffer read energy (pJ per bit)")
+    buffer_write_energy = Param.Float(0.03,
+        "input buffer write energy (pJ per bit)")
+    crossbar_energy = Param.Float(0.01,
+        "crossbar traversal energy (pJ per bit per output port)")
+    arbiter_energy = Param.Float(0.5,
+        "vc or switch arbitration energy (pJ per arbitration)")
+    link_energy = Param.Float(0.1, "link traversal energy (pJ per bit)")
+
+    # The routers and links are registered with the injector as the
+    # sites <network>.routers and <network>.links, which corrupt a bit of
+    # the data block of the next flit through them, and
+    # <network>.routers_drop and <network>.links_drop, which lose the
+    # packet of the next flit
+    if buildEnv['TARGET_ISA'] != 'null':
+        fault_injector = Param.FaultInjector(NULL, "Fault injector to"
+            " register the routers and links with as fault sites")
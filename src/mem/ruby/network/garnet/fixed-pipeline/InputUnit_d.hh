@@ -58,6 +58,34 @@ class InputUnit_d : public Consumer
     set_vc_state(VC_state_type state, int vc, Cycles curTime)
     {
         m_vcs[vc]->set_state(state, curTime);
+        set_vc_active(vc, state != IDLE_);
+    }
+
+    // Whether any VC holds a packet, i.e. is not idle
+    inline bool has_active_vcs() const { return m_num_active_vcs > 0; }
+
+    // The lowest numbered active VC above vc, or -1 if there is none
+    inline int
+    next_active_vc(int vc) const
+    {
+        int next = vc + 1;
+        for (int w = next / 64; w < m_active_vcs.size(); w++) {
+            uint64_t bits = m_active_vcs[w];
+            if (w == next / 64)
+                bits &= ~ULL(0) << (next % 64);
+            if (bits)
+                return w * 64 + __builtin_ctzll(bits);
+        }
+        return -1;
+    }
+
+    // The active VC following vc in round robin order, which is vc
+    // itself if it is the only active one, or -1 if there is none
+    inline int
+    next_active_vc_wrapped(int vc) const
+    {
+        int next = next_active_vc(vc);
+        return next >= 0 ? next : next_active_vc(-1);
     }
 
     inline void
@@ -103,6 +131,7 @@ class InputUnit_d : public Consumer
     {
         m_vcs[vc]->set_outport(outport);
         m_vcs[vc]->set_state(VC_AB_, curTime);
+        set_vc_active(vc, true);
     }
 
     inline void
@@ -162,6 +191,20 @@ class InputUnit_d : public Consumer
     void resetStats();
 
   private:
+    inline void
+    set_vc_active(int vc, bool active)
+    {
+        uint64_t &word = m_active_vcs[vc / 64];
+        uint64_t mask = ULL(1) << (vc % 64);
+        if (active && !(word & mask)) {
+            word |= mask;
+            m_num_active_vcs++;
+        } else if (!active && (word & mask)) {
+            word &= ~mask;
+            m_num_active_vcs--;
+        }
+    }
+
     int m_id;
     int m_num_vcs;
     int m_vc_per_vnet;
@@ -174,6 +217,11 @@ class InputUnit_d : public Consumer
     // Virtual channels
     std::vector<VirtualChannel_d *> m_vcs;
 
+    // Bit mask of the VCs that are not idle, so that the allocators
+    // only look at those
+    std::vector<uint64_t> m_active_vcs;
+    int m_num_active_vcs;
+
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
@@ -53,6 +53,7 @@ NetworkInterface_d::NetworkInterface_d(const Params *p)
     m_vc_round_robin = 0;
     m_ni_buffers.resize(m_num_vcs);
     m_ni_enqueue_time.resize(m_num_vcs);
+    m_vc_dropped.resize(m_num_vcs, false);
     creditQueue = new flitBuffer_d();
 
     // instantiating the NI flit buffers
@@ -250,11 +251,19 @@ NetworkInterface_d::wakeup()
     if (inNetLink->isReady(curCycle())) {
         flit_d *t_flit = inNetLink->consumeLink();
         bool free_signal = false;
+        if (t_flit->is_dropped())
+            m_vc_dropped[t_flit->get_vc()] = true;
         if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
             free_signal = true;
 
-            outNode_ptr[t_flit->get_vnet()]->enqueue(
-                t_flit->get_msg_ptr(), Cycles(1));
+            if (m_vc_dropped[t_flit->get_vc()]) {
+                DPRINTF(RubyNetwork, "m_id: %d dropping %s\n", m_id,
+                        *t_flit->get_msg_ptr());
+                m_vc_dropped[t_flit->get_vc()] = false;
+            } else {
+                outNode_ptr[t_flit->get_vnet()]->enqueue(
+                    t_flit->get_msg_ptr(), Cycles(1));
+            }
         }
         // Simply send a credit back since we are not buffering
         // this flit in the NI
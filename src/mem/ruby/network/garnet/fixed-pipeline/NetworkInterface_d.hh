@@ -89,6 +89,10 @@ class NetworkInterface_d : public ClockedObject, public Consumer
     std::vector<flitBuffer_d *>   m_ni_buffers;
     std::vector<Cycles> m_ni_enqueue_time;
 
+    // Has a flit of the packet arriving on each vc been dropped by an
+    // injected fault?
+    std::vector<bool> m_vc_dropped;
+
     // The Message buffers that takes messages from the protocol
     std::vector<MessageBuffer *> inNode_ptr;
     // The Message buffers that provides messages to the protocol
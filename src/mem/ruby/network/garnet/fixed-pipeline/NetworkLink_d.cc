@@ -30,9 +30,11 @@
 
 #include "mem/ruby/network/garnet/fixed-pipeline/CreditLink_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/NetworkLink_d.hh"
+#include "sim/quantum.hh"
 
 NetworkLink_d::NetworkLink_d(const Params *p)
-    : ClockedObject(p), Consumer(this)
+    : ClockedObject(p), Consumer(this), m_crosses_queues(false),
+      m_receive_scheduled(false)
 {
     m_latency = p->link_latency;
     channel_width = p->channel_width;
@@ -55,6 +57,7 @@ void
 NetworkLink_d::setLinkConsumer(Consumer *consumer)
 {
     link_consumer = consumer;
+    m_crosses_queues = consumer->consumerQueue() != eventQueue();
 }
 
 void
@@ -68,14 +71,52 @@ NetworkLink_d::wakeup()
 {
     if (link_srcQueue->isReady(curCycle())) {
         flit_d *t_flit = link_srcQueue->getTopFlit();
+        checkFault(t_flit);
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        Tick arrival = clockEdge(m_latency);
+
+        if (m_crosses_queues && inParallelMode) {
+            Tick latency = arrival - curTick();
+            if (latency < simQuantum && !quantumController.adaptive())
+                fatal("Link %s crosses event queues, but its latency is "
+                      "shorter than the simulation quantum (%d ticks)\n",
+                      name(), simQuantum);
+            arrival = curTick() +
+                quantumController.crossQueue(latency, simQuantum);
+
+            std::lock_guard<std::mutex> lock(m_posted_mutex);
+            m_posted.push_back(std::make_pair(arrival, t_flit));
+            if (!m_receive_scheduled) {
+                m_receive_scheduled = true;
+                link_consumer->consumerQueue()->schedule(
+                    new ReceiveEvent(this), curTick() + simQuantum, true);
+            }
+        } else {
+            linkBuffer->insert(t_flit);
+            link_consumer->scheduleEventAbsolute(arrival);
+        }
+
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
     }
 }
 
+void
+NetworkLink_d::receivePosted()
+{
+    std::vector<std::pair<Tick, flit_d *> > posted;
+    {
+        std::lock_guard<std::mutex> lock(m_posted_mutex);
+        posted.swap(m_posted);
+        m_receive_scheduled = false;
+    }
+
+    for (auto &p : posted) {
+        linkBuffer->insert(p.second);
+        link_consumer->scheduleEventAbsolute(p.first);
+    }
+}
+
 NetworkLink_d *
 NetworkLink_dParams::create()
 {
@@ -91,5 +132,12 @@ CreditLink_dParams::create()
 uint32_t
 NetworkLink_d::functionalWrite(Packet *pkt)
 {
-    return linkBuffer->functionalWrite(pkt);
+    uint32_t num_functional_writes = linkBuffer->functionalWrite(pkt);
+
+    std::lock_guard<std::mutex> lock(m_posted_mutex);
+    for (auto &p : m_posted) {
+        if (p.second->functionalWrite(pkt))
+            num_functional_writes++;
+    }
+    return num_functional_writes;
 }
@@ -32,17 +32,21 @@
 #define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_NETWORK_LINK_D_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFault_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/flitBuffer_d.hh"
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
 #include "params/NetworkLink_d.hh"
 #include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
 
 class GarnetNetwork_d;
 
-class NetworkLink_d : public ClockedObject, public Consumer
+class NetworkLink_d : public ClockedObject, public Consumer,
+                      public FlitFaultPoint_d
 {
   public:
     typedef NetworkLink_dParams Params;
@@ -67,6 +71,24 @@ class NetworkLink_d : public ClockedObject, public Consumer
     uint32_t functionalWrite(Packet *);
 
   private:
+    //! Move the flits posted by the sending thread to the link buffer.
+    void receivePosted();
+
+    class ReceiveEvent : public PooledEvent<>
+    {
+      public:
+        ReceiveEvent(NetworkLink_d *link)
+            : PooledEvent<>(Default_Pri, AutoDelete), m_link(link)
+        {
+        }
+
+        void process() { m_link->receivePosted(); }
+        const char *description() const { return "NetworkLink receive"; }
+
+      private:
+        NetworkLink_d *m_link;
+    };
+
     int m_id;
     Cycles m_latency;
     int channel_width;
@@ -75,6 +97,16 @@ class NetworkLink_d : public ClockedObject, public Consumer
     Consumer *link_consumer;
     flitBuffer_d *link_srcQueue;
 
+    // A link runs on the event queue of its source. When its consumer
+    // is on a different queue, flits sent while the queues run in
+    // parallel are posted here and moved to the link buffer by the
+    // consumer's thread, a quantum later, which the link latency must
+    // cover.
+    bool m_crosses_queues;
+    std::mutex m_posted_mutex;
+    std::vector<std::pair<Tick, flit_d *> > m_posted;
+    bool m_receive_scheduled;
+
     // Statistical variables
     unsigned int m_link_utilized;
     std::vector<unsigned int> m_vc_load;
@@ -39,6 +39,7 @@
 #include "mem/ruby/network/garnet/fixed-pipeline/SWallocator_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/Switch_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/VCallocator_d.hh"
+#include "sim/stats.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -146,58 +147,72 @@ Router_d::update_sw_winner(int inport, flit_d *t_flit)
 void
 Router_d::regStats()
 {
-    m_buffer_reads
-        .name(name() + ".buffer_reads")
+    static const char *activity_names[NumActivities] = {
+        "buffer_reads", "buffer_writes", "crossbar_activity",
+        "sw_local_arbiter_activity", "sw_global_arbiter_activity",
+        "vc_local_arbiter_activity", "vc_global_arbiter_activity"
+    };
+
+    m_activity
+        .init(NumActivities)
+        .name(name() + ".activity")
+        .desc("router events counted for power computations")
         .flags(Stats::nozero)
-    ;
-
-    m_buffer_writes
-        .name(name() + ".buffer_writes")
-        .flags(Stats::nozero)
-    ;
-
-    m_crossbar_activity
-        .name(name() + ".crossbar_activity")
-        .flags(Stats::nozero)
-    ;
-
-    m_sw_local_arbiter_activity
-        .name(name() + ".sw_local_arbiter_activity")
-        .flags(Stats::nozero)
-    ;
-
-    m_sw_global_arbiter_activity
-        .name(name() + ".sw_global_arbiter_activity")
-        .flags(Stats::nozero)
-    ;
-
-    m_vc_local_arbiter_activity
-        .name(name() + ".vc_local_arbiter_activity")
-        .flags(Stats::nozero)
-    ;
-
-    m_vc_global_arbiter_activity
-        .name(name() + ".vc_global_arbiter_activity")
-        .flags(Stats::nozero)
-    ;
+        ;
+    for (int i = 0; i < NumActivities; i++)
+        m_activity.subname(i, activity_names[i]);
+
+    // A crossbar traversal drives wires spanning all the output ports
+    double buffer_read = m_network_ptr->getBufferReadEnergy();
+    double buffer_write = m_network_ptr->getBufferWriteEnergy();
+    double crossbar = m_network_ptr->getCrossbarEnergy() *
+        m_output_unit.size();
+    double arbiter = m_network_ptr->getArbiterEnergy();
+
+    m_dynamic_energy
+        .name(name() + ".dynamic_energy")
+        .desc("dynamic energy of the router (pJ)")
+        ;
+    m_dynamic_energy =
+        m_activity[BufferReads] * Stats::constant(buffer_read) +
+        m_activity[BufferWrites] * Stats::constant(buffer_write) +
+        m_activity[CrossbarActivity] * Stats::constant(crossbar) +
+        (m_activity[SwLocalArbiterActivity] +
+         m_activity[SwGlobalArbiterActivity] +
+         m_activity[VcLocalArbiterActivity] +
+         m_activity[VcGlobalArbiterActivity]) * Stats::constant(arbiter);
+
+    m_dynamic_power
+        .name(name() + ".dynamic_power")
+        .desc("average dynamic power of the router (W)")
+        ;
+    m_dynamic_power = m_dynamic_energy * Stats::constant(1e-12) / simSeconds;
 }
 
 void
 Router_d::collateStats()
 {
+    // The unit counters are running totals, so they replace what an
+    // earlier dump collated rather than add to it
+    double buffer_reads = 0, buffer_writes = 0;
+    double vc_local = 0, vc_global = 0;
     for (int j = 0; j < m_virtual_networks; j++) {
         for (int i = 0; i < m_input_unit.size(); i++) {
-            m_buffer_reads += m_input_unit[i]->get_buf_read_count(j);
-            m_buffer_writes += m_input_unit[i]->get_buf_write_count(j);
+            buffer_reads += m_input_unit[i]->get_buf_read_count(j);
+            buffer_writes += m_input_unit[i]->get_buf_write_count(j);
         }
 
-        m_vc_local_arbiter_activity  += m_vc_alloc->get_local_arbit_count(j);
-        m_vc_global_arbiter_activity += m_vc_alloc->get_global_arbit_count(j);
+        vc_local += m_vc_alloc->get_local_arbit_count(j);
+        vc_global += m_vc_alloc->get_global_arbit_count(j);
     }
 
-    m_sw_local_arbiter_activity = m_sw_alloc->get_local_arbit_count();
-    m_sw_global_arbiter_activity = m_sw_alloc->get_global_arbit_count();
-    m_crossbar_activity = m_switch->get_crossbar_count();
+    m_activity[BufferReads] = buffer_reads;
+    m_activity[BufferWrites] = buffer_writes;
+    m_activity[VcLocalArbiterActivity] = vc_local;
+    m_activity[VcGlobalArbiterActivity] = vc_global;
+    m_activity[SwLocalArbiterActivity] = m_sw_alloc->get_local_arbit_count();
+    m_activity[SwGlobalArbiterActivity] = m_sw_alloc->get_global_arbit_count();
+    m_activity[CrossbarActivity] = m_switch->get_crossbar_count();
 }
 
 void
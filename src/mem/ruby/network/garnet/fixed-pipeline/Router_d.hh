@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/garnet/fixed-pipeline/FlitFault_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/GarnetNetwork_d.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/flit_d.hh"
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
@@ -51,7 +52,7 @@ class SWallocator_d;
 class Switch_d;
 class FaultModel;
 
-class Router_d : public BasicRouter
+class Router_d : public BasicRouter, public FlitFaultPoint_d
 {
   public:
     typedef GarnetRouter_dParams Params;
@@ -93,6 +94,9 @@ class Router_d : public BasicRouter
     void collateStats();
     void resetStats();
 
+    const Stats::Formula &getDynamicEnergy() const
+    { return m_dynamic_energy; }
+
     bool get_fault_vector(int temperature, float fault_vector[]){ 
         return m_network_ptr->fault_model->fault_vector(m_id, temperature, 
                                                         fault_vector); 
@@ -116,17 +120,22 @@ class Router_d : public BasicRouter
     SWallocator_d *m_sw_alloc;
     Switch_d *m_switch;
 
-    // Statistical variables required for power computations
-    Stats::Scalar m_buffer_reads;
-    Stats::Scalar m_buffer_writes;
-
-    Stats::Scalar m_sw_local_arbiter_activity;
-    Stats::Scalar m_sw_global_arbiter_activity;
+    // Events counted for power computations, as m_activity indices
+    enum Activity {
+        BufferReads,
+        BufferWrites,
+        CrossbarActivity,
+        SwLocalArbiterActivity,
+        SwGlobalArbiterActivity,
+        VcLocalArbiterActivity,
+        VcGlobalArbiterActivity,
+        NumActivities
+    };
 
-    Stats::Scalar m_vc_local_arbiter_activity;
-    Stats::Scalar m_vc_global_arbiter_activity;
-
-    Stats::Scalar m_crossbar_activity;
+    // Statistical variables required for power computations
+    Stats::Vector m_activity;
+    Stats::Formula m_dynamic_energy;
+    Stats::Formula m_dynamic_power;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_ROUTER_D_HH__
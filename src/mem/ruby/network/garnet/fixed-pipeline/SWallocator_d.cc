@@ -104,28 +104,29 @@ SWallocator_d::arbitrate_inports()
 
         m_round_robin_inport[inport] = next_round_robin_invc;
 
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+        // Only the active vcs, after the round robin candidate, can
+        // have a request
+        int first_invc = m_input_unit[inport]->next_active_vc_wrapped(invc);
+        if (first_invc < 0)
+            continue;
 
-            if (!((m_router->get_net_ptr())->validVirtualNetwork(
-                get_vnet(invc))))
-                continue;
-
-            if (m_input_unit[inport]->need_stage(invc, ACTIVE_, SA_,
+        invc = first_invc;
+        do {
+            if ((m_router->get_net_ptr())->validVirtualNetwork(
+                    get_vnet(invc)) &&
+                m_input_unit[inport]->need_stage(invc, ACTIVE_, SA_,
                                                  m_router->curCycle()) &&
-                m_input_unit[inport]->has_credits(invc)) {
-
-                if (is_candidate_inport(inport, invc)) {
-                    int outport = m_input_unit[inport]->get_route(invc);
-                    m_local_arbiter_activity++;
-                    m_port_req[outport][inport] = true;
-                    m_vc_winners[outport][inport]= invc;
-                    break; // got one vc winner for this port
-                }
+                m_input_unit[inport]->has_credits(invc) &&
+                is_candidate_inport(inport, invc)) {
+                int outport = m_input_unit[inport]->get_route(invc);
+                m_local_arbiter_activity++;
+                m_port_req[outport][inport] = true;
+                m_vc_winners[outport][inport]= invc;
+                break; // got one vc winner for this port
             }
-        }
+
+            invc = m_input_unit[inport]->next_active_vc_wrapped(invc);
+        } while (invc != first_invc);
     }
 }
 
@@ -221,7 +222,8 @@ SWallocator_d::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        for (int j = m_input_unit[i]->next_active_vc(-1); j >= 0;
+             j = m_input_unit[i]->next_active_vc(j)) {
             if (m_input_unit[i]->need_stage(j, ACTIVE_, SA_, nextCycle)) {
                 scheduleEvent(Cycles(1));
                 return;
@@ -178,7 +178,9 @@ void
 VCallocator_d::arbitrate_invcs()
 {
     for (int inport_iter = 0; inport_iter < m_num_inports; inport_iter++) {
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        InputUnit_d *input_unit = m_input_unit[inport_iter];
+        for (int invc_iter = input_unit->next_active_vc(-1); invc_iter >= 0;
+             invc_iter = input_unit->next_active_vc(invc_iter)) {
             if (!((m_router->get_net_ptr())->validVirtualNetwork(
                 get_vnet(invc_iter))))
                 continue;
@@ -259,7 +261,8 @@ VCallocator_d::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        for (int j = m_input_unit[i]->next_active_vc(-1); j >= 0;
+             j = m_input_unit[i]->next_active_vc(j)) {
             if (m_input_unit[i]->need_stage(j, VC_AB_, VA_, nextCycle)) {
                 scheduleEvent(Cycles(1));
                 return;
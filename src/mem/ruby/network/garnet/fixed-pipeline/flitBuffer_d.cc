@@ -31,15 +31,26 @@
 #include "mem/ruby/network/garnet/fixed-pipeline/flitBuffer_d.hh"
 
 flitBuffer_d::flitBuffer_d()
+    : m_buffer(4)
 {
     max_size = INFINITE_;
 }
 
 flitBuffer_d::flitBuffer_d(int maximum_size)
+    : m_buffer(4)
 {
     max_size = maximum_size;
 }
 
+void
+flitBuffer_d::grow()
+{
+    CircularQueue<flit_d *> buffer(m_buffer.capacity() * 2);
+    for (size_t i = 0; i < m_buffer.size(); ++i)
+        buffer.push_back(m_buffer[i]);
+    m_buffer = buffer;
+}
+
 bool
 flitBuffer_d::isEmpty()
 {
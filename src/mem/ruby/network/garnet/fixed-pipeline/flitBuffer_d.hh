@@ -33,8 +33,8 @@
 
 #include <algorithm>
 #include <iostream>
-#include <vector>
 
+#include "base/circular_queue.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/flit_d.hh"
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
 
@@ -54,8 +54,7 @@ class flitBuffer_d
     getTopFlit()
     {
         flit_d *f = m_buffer.front();
-        std::pop_heap(m_buffer.begin(), m_buffer.end(), flit_d::greater);
-        m_buffer.pop_back();
+        m_buffer.pop_front();
         return f;
     }
 
@@ -68,14 +67,26 @@ class flitBuffer_d
     void
     insert(flit_d *flt)
     {
+        if (m_buffer.full())
+            grow();
+
+        // Flits almost always arrive in order of time, so the insertion
+        // ends at the back
         m_buffer.push_back(flt);
-        std::push_heap(m_buffer.begin(), m_buffer.end(), flit_d::greater);
+        for (size_t i = m_buffer.size() - 1;
+             i > 0 && flit_d::greater(m_buffer[i - 1], m_buffer[i]); --i) {
+            std::swap(m_buffer[i - 1], m_buffer[i]);
+        }
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    std::vector<flit_d *> m_buffer;
+    //! Double the capacity of the ring.
+    void grow();
+
+    // Flits in order of time and id, on a ring that grows as needed
+    CircularQueue<flit_d *> m_buffer;
     int max_size;
 };
 
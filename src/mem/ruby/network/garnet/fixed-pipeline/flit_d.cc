@@ -42,6 +42,7 @@ flit_d::flit_d(int id, int  vc, int vnet, int size, MsgPtr msg_ptr,
     m_vc = vc;
     m_stage.first = I_;
     m_stage.second = m_time;
+    m_dropped = false;
 
     if (size == 1) {
         m_type = HEAD_TAIL_;
@@ -61,6 +62,7 @@ flit_d::flit_d(int vc, bool is_free_signal, Cycles curTime)
     m_vc = vc;
     m_is_free_signal = is_free_signal;
     m_time = curTime;
+    m_dropped = false;
 }
 
 void
@@ -37,12 +37,31 @@
 #include "base/types.hh"
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
+#include "sim/event_pool.hh"
 
 class flit_d
 {
   public:
     flit_d(int id, int vc, int vnet, int size, MsgPtr msg_ptr, Cycles curTime);
     flit_d(int vc, bool is_free_signal, Cycles curTime);
+
+    /**
+     * Flits and credits are created and freed for every packet, mostly
+     * by different interfaces and routers, so they are drawn from the
+     * free lists of the EventPool rather than the heap.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(p, size);
+    }
+
     void set_outport(int port) { m_outport = port; }
     int get_outport() {return m_outport; }
     void print(std::ostream& out) const;
@@ -74,6 +93,10 @@ class flit_d
 
     std::pair<flit_stage, Cycles> get_stage() { return m_stage; }
 
+    // A dropped flit loses its packet at the destination interface
+    void set_dropped() { m_dropped = true; }
+    bool is_dropped() const { return m_dropped; }
+
     void set_delay(Cycles delay) { src_delay = delay; }
     Cycles get_delay() { return src_delay; }
 
@@ -102,6 +125,7 @@ class flit_d
     int m_outport;
     Cycles src_delay;
     std::pair<flit_stage, Cycles> m_stage;
+    bool m_dropped;
 };
 
 inline std::ostream&
@@ -99,9 +99,21 @@ PerfectSwitch::addOutPort(const vector<MessageBuffer*>& out,
     l.m_link = m_out.size();
     m_link_order.push_back(l);
 
+    // Destinations that no earlier link takes go down this one
+    int link = m_out.size();
+    routing_table_entry.forEachElement([&](MachineID mach) {
+        NodeID node = MachineType_base_number(mach.type) + mach.num;
+        if (m_dest_link.size() <= node)
+            m_dest_link.resize(node + 1, -1);
+        if (m_dest_link[node] < 0)
+            m_dest_link[node] = link;
+    });
+
     // Add to routing table
     m_out.push_back(out);
     m_routing_table.push_back(routing_table_entry);
+    m_link_dests.push_back(NetDest());
+    m_links_used.resize((m_out.size() + 63) / 64, 0);
 }
 
 PerfectSwitch::~PerfectSwitch()
@@ -130,10 +142,6 @@ PerfectSwitch::operateVnet(int vnet)
                 incoming = 0;
             }
 
-            // temporary vectors to store the routing results
-            vector<LinkID> output_links;
-            vector<NetDest> output_link_destinations;
-
             // Is there a message waiting?
             if (m_in[incoming].size() <= vnet) {
                 continue;
@@ -152,9 +160,8 @@ PerfectSwitch::operateVnet(int vnet)
                 net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
                 DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
 
-                output_links.clear();
-                output_link_destinations.clear();
-                NetDest msg_dsts = net_msg_ptr->getInternalDestination();
+                const NetDest &msg_dsts =
+                    net_msg_ptr->getInternalDestination();
 
                 // Unfortunately, the token-protocol sends some
                 // zero-destination messages, so this assert isn't valid
@@ -163,61 +170,33 @@ PerfectSwitch::operateVnet(int vnet)
                 assert(m_link_order.size() == m_routing_table.size());
                 assert(m_link_order.size() == m_out.size());
 
-                if (m_network_ptr->getAdaptiveRouting()) {
-                    if (m_network_ptr->isVNetOrdered(vnet)) {
-                        // Don't adaptively route
-                        for (int out = 0; out < m_out.size(); out++) {
-                            m_link_order[out].m_link = out;
-                            m_link_order[out].m_value = 0;
-                        }
-                    } else {
-                        // Find how clogged each link is
-                        for (int out = 0; out < m_out.size(); out++) {
-                            int out_queue_length = 0;
-                            for (int v = 0; v < m_virtual_networks; v++) {
-                                out_queue_length += m_out[out][v]->getSize();
-                            }
-                            int value =
-                                (out_queue_length << 8) |
-                                random_mt.random(0, 0xff);
-                            m_link_order[out].m_link = out;
-                            m_link_order[out].m_value = value;
+                if (m_network_ptr->getAdaptiveRouting() &&
+                    !m_network_ptr->isVNetOrdered(vnet)) {
+                    // Find how clogged each link is
+                    for (int out = 0; out < m_out.size(); out++) {
+                        int out_queue_length = 0;
+                        for (int v = 0; v < m_virtual_networks; v++) {
+                            out_queue_length += m_out[out][v]->getSize();
                         }
-
-                        // Look at the most empty link first
-                        sort(m_link_order.begin(), m_link_order.end());
+                        int value =
+                            (out_queue_length << 8) |
+                            random_mt.random(0, 0xff);
+                        m_link_order[out].m_link = out;
+                        m_link_order[out].m_value = value;
                     }
-                }
-
-                for (int i = 0; i < m_routing_table.size(); i++) {
-                    // pick the next link to look at
-                    int link = m_link_order[i].m_link;
-                    NetDest dst = m_routing_table[link];
-                    DPRINTF(RubyNetwork, "dst: %s\n", dst);
 
-                    if (!msg_dsts.intersectionIsNotEmpty(dst))
-                        continue;
+                    // Look at the most empty link first
+                    sort(m_link_order.begin(), m_link_order.end());
 
-                    // Remember what link we're using
-                    output_links.push_back(link);
-
-                    // Need to remember which destinations need this message in
-                    // another vector.  This Set is the intersection of the
-                    // routing_table entry and the current destination set.  The
-                    // intersection must not be empty, since we are inside "if"
-                    output_link_destinations.push_back(msg_dsts.AND(dst));
-
-                    // Next, we update the msg_destination not to include
-                    // those nodes that were already handled by this link
-                    msg_dsts.removeNetDest(dst);
+                    routeByLinkOrder(msg_dsts);
+                } else {
+                    routeByTable(msg_dsts);
                 }
 
-                assert(msg_dsts.count() == 0);
-
                 // Check for resources - for all outgoing queues
                 bool enough = true;
-                for (int i = 0; i < output_links.size(); i++) {
-                    int outgoing = output_links[i];
+                for (int i = 0; i < m_output_links.size(); i++) {
+                    int outgoing = m_output_links[i];
 
                     if (!m_out[outgoing][vnet]->areNSlotsAvailable(1))
                         enough = false;
@@ -236,37 +215,34 @@ PerfectSwitch::operateVnet(int vnet)
                     break; // go to next incoming port
                 }
 
-                MsgPtr unmodified_msg_ptr;
-
-                if (output_links.size() > 1) {
-                    // If we are sending this message down more than one link
-                    // (size>1), we need to make a copy of the message so each
-                    // branch can have a different internal destination we need
-                    // to create an unmodified MsgPtr because the MessageBuffer
-                    // enqueue func will modify the message
-
-                    // This magic line creates a private copy of the message
-                    unmodified_msg_ptr = msg_ptr->clone();
-                }
+                // If we are sending this message down more than one link
+                // (size>1), each branch needs a private copy of the
+                // message with its own internal destination, as the
+                // MessageBuffer enqueue func will modify the message. The
+                // copies are made from the unmodified message, which then
+                // goes down the last link itself.
+                MsgPtr unmodified_msg_ptr = msg_ptr;
 
                 // Dequeue msg
                 buffer->dequeue();
                 m_pending_message_count[vnet]--;
 
                 // Enqueue it - for all outgoing queues
-                for (int i=0; i<output_links.size(); i++) {
-                    int outgoing = output_links[i];
+                for (int i=0; i<m_output_links.size(); i++) {
+                    int outgoing = m_output_links[i];
 
-                    if (i > 0) {
+                    if (i < m_output_links.size() - 1) {
                         // create a private copy of the unmodified message
                         msg_ptr = unmodified_msg_ptr->clone();
+                    } else {
+                        msg_ptr = unmodified_msg_ptr;
                     }
 
                     // Change the internal destination set of the message so it
                     // knows which destinations this link is responsible for.
                     net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
                     net_msg_ptr->getInternalDestination() =
-                        output_link_destinations[i];
+                        m_output_link_destinations[i];
 
                     // Enqeue msg
                     DPRINTF(RubyNetwork, "Enqueuing net msg from "
@@ -280,6 +256,67 @@ PerfectSwitch::operateVnet(int vnet)
     }
 }
 
+void
+PerfectSwitch::routeByTable(const NetDest &msg_dsts)
+{
+    m_output_links.clear();
+    m_output_link_destinations.clear();
+
+    msg_dsts.forEachElement([&](MachineID mach) {
+        NodeID node = MachineType_base_number(mach.type) + mach.num;
+        assert(node < m_dest_link.size() && m_dest_link[node] >= 0);
+        int link = m_dest_link[node];
+
+        uint64_t &used = m_links_used[link / 64];
+        uint64_t mask = ULL(1) << (link % 64);
+        if (!(used & mask)) {
+            used |= mask;
+            m_link_dests[link].clear();
+        }
+        m_link_dests[link].add(mach);
+    });
+
+    for (int w = 0; w < m_links_used.size(); w++) {
+        for (; m_links_used[w]; m_links_used[w] &= m_links_used[w] - 1) {
+            int link = w * 64 + __builtin_ctzll(m_links_used[w]);
+            m_output_links.push_back(link);
+            m_output_link_destinations.push_back(m_link_dests[link]);
+        }
+    }
+}
+
+void
+PerfectSwitch::routeByLinkOrder(NetDest msg_dsts)
+{
+    m_output_links.clear();
+    m_output_link_destinations.clear();
+
+    for (int i = 0; i < m_routing_table.size(); i++) {
+        // pick the next link to look at
+        int link = m_link_order[i].m_link;
+        const NetDest &dst = m_routing_table[link];
+        DPRINTF(RubyNetwork, "dst: %s\n", dst);
+
+        if (!msg_dsts.intersectionIsNotEmpty(dst))
+            continue;
+
+        // Remember what link we're using
+        m_output_links.push_back(link);
+
+        // Need to remember which destinations need this message in
+        // another vector.  This Set is the intersection of the
+        // routing_table entry and the current destination set.  The
+        // intersection must not be empty, since we are inside "if"
+        m_output_link_destinations.push_back(msg_dsts.AND(dst));
+
+        // Next, we update the msg_destination not to include
+        // those nodes that were already handled by this link
+        msg_dsts.removeNetDest(dst);
+    }
+
+    assert(msg_dsts.count() == 0);
+}
+
 void
 PerfectSwitch::wakeup()
 {
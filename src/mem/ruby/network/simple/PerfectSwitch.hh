@@ -41,9 +41,9 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
 
 class MessageBuffer;
-class NetDest;
 class SimpleNetwork;
 class Switch;
 
@@ -86,6 +86,14 @@ class PerfectSwitch : public Consumer
 
     void operateVnet(int vnet);
 
+    //! Split the destinations of a message over the output links with
+    //! the routing table, in link order.
+    void routeByTable(const NetDest &msg_dsts);
+
+    //! Split the destinations of a message over the output links in
+    //! the order of m_link_order.
+    void routeByLinkOrder(NetDest msg_dsts);
+
     SwitchID m_switch_id;
 
     // vector of queues from the components
@@ -95,6 +103,21 @@ class PerfectSwitch : public Consumer
     std::vector<NetDest> m_routing_table;
     std::vector<LinkOrder> m_link_order;
 
+    // Unless routed adaptively, a destination always goes down the
+    // first output link whose routing table entry holds it. That link
+    // is precomputed per destination node, numbered across all machine
+    // types, as -1 if there is none.
+    std::vector<int> m_dest_link;
+
+    // Scratch state of routeByTable: the destinations gathered per
+    // link, and a bit mask of the links with any
+    std::vector<NetDest> m_link_dests;
+    std::vector<uint64_t> m_links_used;
+
+    // The routing result for the message at hand
+    std::vector<LinkID> m_output_links;
+    std::vector<NetDest> m_output_link_destinations;
+
     uint32_t m_virtual_networks;
     int m_round_robin_start;
     int m_wakeups_wo_switch;
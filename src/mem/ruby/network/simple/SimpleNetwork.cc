@@ -140,6 +140,12 @@ SimpleNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_switches[src]->addOutPort(queues, routing_table_entry,
                                 simple_link->m_latency,
                                 simple_link->m_bw_multiplier);
+
+    // Links between switches on different event queues bound the quantum
+    if (m_switches[src]->eventQueue() != m_switches[dest]->eventQueue()) {
+        limitSimQuantum(m_switches[src]->clockPeriod() *
+                        simple_link->m_latency, "Link " + link->name());
+    }
 }
 
 void
@@ -51,6 +51,8 @@ AccessTraceForAddress::print(std::ostream& out) const
         out << " " << m_total-m_user;
         out << " | " << m_sharing;
         out << " | " << m_touched_by.count();
+        if (m_overcount)
+            out << " | +" << m_overcount;
     } else {
         assert(m_total == 0);
         out << " " << (*m_histogram_ptr);
@@ -29,6 +29,7 @@
 #ifndef __MEM_RUBY_PROFILER_ACCESSTRACEFORADDRESS_HH__
 #define __MEM_RUBY_PROFILER_ACCESSTRACEFORADDRESS_HH__
 
+#include <cstddef>
 #include <iostream>
 
 #include "mem/protocol/RubyAccessMode.hh"
@@ -44,7 +45,8 @@ class AccessTraceForAddress
   public:
     AccessTraceForAddress()
         : m_loads(0), m_stores(0), m_atomics(0), m_total(0), m_user(0),
-          m_sharing(0), m_histogram_ptr(NULL)
+          m_sharing(0), m_histogram_ptr(NULL), m_overcount(0),
+          m_heap_index(0)
     { }
     ~AccessTraceForAddress();
 
@@ -52,6 +54,12 @@ class AccessTraceForAddress
     void update(RubyRequestType type, RubyAccessMode access_mode, NodeID cpu,
                 bool sharing_miss);
     int getTotal() const;
+    //! Count including the accesses possibly made to other addresses
+    uint64 getEstimate() const { return getTotal() + m_overcount; }
+    uint64 getOvercount() const { return m_overcount; }
+    void setOvercount(uint64 overcount) { m_overcount = overcount; }
+    size_t getHeapIndex() const { return m_heap_index; }
+    void setHeapIndex(size_t index) { m_heap_index = index; }
     int getSharing() const { return m_sharing; }
     int getTouchedBy() const { return m_touched_by.count(); }
     const Address& getAddress() const { return m_addr; }
@@ -63,7 +71,7 @@ class AccessTraceForAddress
     less_equal(const AccessTraceForAddress* n1,
         const AccessTraceForAddress* n2)
     {
-        return n1->getTotal() <= n2->getTotal();
+        return n1->getEstimate() <= n2->getEstimate();
     }
 
   private:
@@ -76,6 +84,10 @@ class AccessTraceForAddress
     uint64 m_sharing;
     Set m_touched_by;
     Histogram* m_histogram_ptr;
+    //! Count inherited from the address this one replaced
+    uint64 m_overcount;
+    //! Position in the replacement heap of a bounded trace table
+    size_t m_heap_index;
 };
 
 inline std::ostream&
@@ -36,12 +36,33 @@
 
 using namespace std;
 typedef AddressProfiler::AddressMap AddressMap;
+typedef AddressProfiler::TraceTable TraceTable;
 
 using m5::stl_helpers::operator<<;
 
-// Helper functions
+void
+TraceTable::setSampling(unsigned sample_bits, size_t capacity)
+{
+    assert(sample_bits < 64);
+    assert(m_traces.empty());
+    m_sample_bits = sample_bits;
+    m_capacity = capacity;
+    m_heap.reserve(capacity);
+}
+
+bool
+TraceTable::sampled(const Address& addr) const
+{
+    if (m_sample_bits == 0)
+        return true;
+
+    // Fibonacci hashing, keeping the addresses in the first bucket
+    uint64_t h = addr.getAddress() * ULL(0x9e3779b97f4a7c15);
+    return (h >> (64 - m_sample_bits)) == 0;
+}
+
 AccessTraceForAddress&
-lookupTraceForAddress(const Address& addr, AddressMap& record_map)
+TraceTable::lookup(const Address& addr)
 {
     // we create a static default object here that is used to insert
     // since the insertion will create a copy of the object in the
@@ -49,24 +70,104 @@ lookupTraceForAddress(const Address& addr, AddressMap& record_map)
     // like it could hurt.
     static const AccessTraceForAddress dflt;
 
-    pair<AddressMap::iterator, bool> r =
-        record_map.insert(make_pair(addr, dflt));
-    AddressMap::iterator i = r.first;
-    AccessTraceForAddress &access_trace = i->second;
-    if (r.second) {
-        // there was nothing there and the insert succeed, so we need
-        // to actually set the address.
-        access_trace.setAddress(addr);
+    AddressMap::iterator i = m_traces.find(addr);
+    if (i != m_traces.end())
+        return i->second;
+
+    uint64 overcount = 0;
+    if (m_capacity && m_traces.size() == m_capacity) {
+        // replace the address with the lowest count, the new one takes
+        // its place at the root of the heap
+        overcount = m_heap[0]->getEstimate();
+        m_traces.erase(m_heap[0]->getAddress());
+        m_heap[0] = NULL;
+    }
+
+    AccessTraceForAddress &access_trace =
+        m_traces.insert(make_pair(addr, dflt)).first->second;
+    access_trace.setAddress(addr);
+    access_trace.setOvercount(overcount);
+
+    if (m_capacity) {
+        if (m_heap.size() < m_capacity) {
+            // a zero count rises to the top of the min-heap
+            m_heap.push_back(NULL);
+            for (size_t j = m_heap.size() - 1; j > 0; j = (j - 1) / 2) {
+                m_heap[j] = m_heap[(j - 1) / 2];
+                m_heap[j]->setHeapIndex(j);
+            }
+        }
+        m_heap[0] = &access_trace;
+        access_trace.setHeapIndex(0);
     }
 
     return access_trace;
 }
 
 void
-printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
+TraceTable::siftDown(size_t idx)
+{
+    // the count at idx has just grown
+    const size_t size = m_heap.size();
+    while (true) {
+        size_t smallest = idx;
+        size_t left = 2 * idx + 1;
+        size_t right = left + 1;
+        if (left < size &&
+            m_heap[left]->getEstimate() < m_heap[smallest]->getEstimate())
+            smallest = left;
+        if (right < size &&
+            m_heap[right]->getEstimate() < m_heap[smallest]->getEstimate())
+            smallest = right;
+        if (smallest == idx)
+            return;
+
+        swap(m_heap[idx], m_heap[smallest]);
+        m_heap[idx]->setHeapIndex(idx);
+        m_heap[smallest]->setHeapIndex(smallest);
+        idx = smallest;
+    }
+}
+
+void
+TraceTable::update(const Address& addr, RubyRequestType type,
+                   RubyAccessMode access_mode, NodeID id, bool sharing_miss)
+{
+    if (!sampled(addr))
+        return;
+
+    AccessTraceForAddress &access_trace = lookup(addr);
+    access_trace.update(type, access_mode, id, sharing_miss);
+    if (m_capacity)
+        siftDown(access_trace.getHeapIndex());
+}
+
+void
+TraceTable::addSample(const Address& addr, int value)
+{
+    if (!sampled(addr))
+        return;
+
+    AccessTraceForAddress &access_trace = lookup(addr);
+    access_trace.addSample(value);
+    if (m_capacity)
+        siftDown(access_trace.getHeapIndex());
+}
+
+void
+TraceTable::clear()
+{
+    m_traces.clear();
+    m_heap.clear();
+}
+
+// Helper functions
+void
+printSorted(ostream& out, int num_of_sequencers, const TraceTable &table,
             string description)
 {
     const int records_printed = 100;
+    const AddressMap &record_map = table.traces();
 
     uint64 misses = 0;
     std::vector<const AccessTraceForAddress *> sorted;
@@ -82,6 +183,9 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
 
     out << "Total_entries_" << description << ": " << record_map.size()
         << endl;
+    if (table.sampleBits())
+        out << "Sampled_addresses_" << description << ": 1 in "
+            << (ULL(1) << table.sampleBits()) << endl;
     if (g_system_ptr->getProfiler()->getAllInstructions())
         out << "Total_Instructions_" << description << ": " << misses << endl;
     else
@@ -126,6 +230,7 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
         remaining_records_log.add(record->getTotal());
         m_touched_vec[record->getTouchedBy()]++;
         m_touched_weighted_vec[record->getTouchedBy()] += record->getTotal();
+        counter++;
     }
     out << endl;
     out << "all_records_" << description << ": "
@@ -165,6 +270,15 @@ AddressProfiler::setAllInstructions(bool all_instructions)
     m_all_instructions = all_instructions;
 }
 
+void
+AddressProfiler::setSampling(unsigned sample_bits, size_t capacity)
+{
+    m_dataAccessTrace.setSampling(sample_bits, capacity);
+    m_macroBlockAccessTrace.setSampling(sample_bits, capacity);
+    m_programCounterAccessTrace.setSampling(sample_bits, capacity);
+    m_retryProfileMap.setSampling(sample_bits, capacity);
+}
+
 void
 AddressProfiler::printStats(ostream& out) const
 {
@@ -291,27 +405,27 @@ AddressProfiler::addTraceSample(Address data_addr, Address pc_addr,
 
         // record data address trace info
         data_addr.makeLineAddress();
-        lookupTraceForAddress(data_addr, m_dataAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_dataAccessTrace.update(data_addr, type, access_mode, id,
+                                 sharing_miss);
 
         // record macro data address trace info
 
         // 6 for datablock, 4 to make it 16x more coarse
         Address macro_addr(data_addr.maskLowOrderBits(10));
-        lookupTraceForAddress(macro_addr, m_macroBlockAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_macroBlockAccessTrace.update(macro_addr, type, access_mode, id,
+                                       sharing_miss);
 
         // record program counter address trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_programCounterAccessTrace.update(pc_addr, type, access_mode, id,
+                                           sharing_miss);
     }
 
     if (m_all_instructions) {
         // This code is used if the address profiler is an
         // all-instructions profiler record program counter address
         // trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_programCounterAccessTrace.update(pc_addr, type, access_mode, id,
+                                           sharing_miss);
     }
 }
 
@@ -326,6 +440,6 @@ AddressProfiler::profileRetry(const Address& data_addr, AccessType type,
         m_retryProfileHistoWrite.add(count);
     }
     if (count > 1) {
-        lookupTraceForAddress(data_addr, m_retryProfileMap).addSample(count);
+        m_retryProfileMap.addSample(data_addr, count);
     }
 }
@@ -30,6 +30,7 @@
 #define __MEM_RUBY_PROFILER_ADDRESSPROFILER_HH__
 
 #include <iostream>
+#include <vector>
 
 #include "base/hashmap.hh"
 #include "mem/protocol/AccessType.hh"
@@ -46,6 +47,41 @@ class AddressProfiler
   public:
     typedef m5::hash_map<Address, AccessTraceForAddress> AddressMap;
 
+    /**
+     * Access traces of a set of addresses.  The table can profile only
+     * the addresses whose hash falls in one of 2^sample_bits buckets,
+     * and can hold at most a capacity of them, counting the heavy
+     * hitters with the space-saving algorithm: a new address replaces
+     * the one with the lowest count and inherits that count as its
+     * possible overcount.
+     */
+    class TraceTable
+    {
+      public:
+        TraceTable() : m_sample_bits(0), m_capacity(0) {}
+
+        void setSampling(unsigned sample_bits, size_t capacity);
+        void update(const Address& addr, RubyRequestType type,
+                    RubyAccessMode access_mode, NodeID id,
+                    bool sharing_miss);
+        void addSample(const Address& addr, int value);
+        void clear();
+
+        const AddressMap& traces() const { return m_traces; }
+        unsigned sampleBits() const { return m_sample_bits; }
+
+      private:
+        bool sampled(const Address& addr) const;
+        AccessTraceForAddress& lookup(const Address& addr);
+        void siftDown(size_t idx);
+
+        unsigned m_sample_bits;
+        size_t m_capacity;
+        AddressMap m_traces;
+        //! Min-heap on the estimated count, when bounded
+        std::vector<AccessTraceForAddress *> m_heap;
+    };
+
   public:
     AddressProfiler(int num_of_sequencers);
     ~AddressProfiler();
@@ -67,6 +103,7 @@ class AddressProfiler
     //added by SS
     void setHotLines(bool hot_lines);
     void setAllInstructions(bool all_instructions);
+    void setSampling(unsigned sample_bits, size_t capacity);
     void regStats(const std::string &name) {}
     void collateStats() {}
 
@@ -77,10 +114,10 @@ class AddressProfiler
 
     int64 m_sharing_miss_counter;
 
-    AddressMap m_dataAccessTrace;
-    AddressMap m_macroBlockAccessTrace;
-    AddressMap m_programCounterAccessTrace;
-    AddressMap m_retryProfileMap;
+    TraceTable m_dataAccessTrace;
+    TraceTable m_macroBlockAccessTrace;
+    TraceTable m_programCounterAccessTrace;
+    TraceTable m_retryProfileMap;
     Histogram m_retryProfileHisto;
     Histogram m_retryProfileHistoWrite;
     Histogram m_retryProfileHistoRead;
@@ -94,12 +131,8 @@ class AddressProfiler
     int m_num_of_sequencers;
 };
 
-AccessTraceForAddress& lookupTraceForAddress(const Address& addr,
-                                             AddressProfiler::AddressMap&
-                                             record_map);
-
 void printSorted(std::ostream& out, int num_of_sequencers,
-                 const AddressProfiler::AddressMap &record_map,
+                 const AddressProfiler::TraceTable &table,
                  std::string description);
 
 inline std::ostream&
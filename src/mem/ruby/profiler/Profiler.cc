@@ -69,11 +69,15 @@ Profiler::Profiler(const RubySystemParams *p)
     m_address_profiler_ptr = new AddressProfiler(p->num_of_sequencers);
     m_address_profiler_ptr->setHotLines(m_hot_lines);
     m_address_profiler_ptr->setAllInstructions(m_all_instructions);
+    m_address_profiler_ptr->setSampling(p->hot_lines_sample_bits,
+                                        p->hot_lines_entries);
 
     if (m_all_instructions) {
         m_inst_profiler_ptr = new AddressProfiler(p->num_of_sequencers);
         m_inst_profiler_ptr->setHotLines(m_hot_lines);
         m_inst_profiler_ptr->setAllInstructions(m_all_instructions);
+        m_inst_profiler_ptr->setSampling(p->hot_lines_sample_bits,
+                                         p->hot_lines_entries);
     }
 }
 
@@ -202,21 +202,38 @@ AbstractController::getMasterPort(const std::string &if_name,
     return memoryPort;
 }
 
-void
-AbstractController::queueMemoryRead(const MachineID &id, Address addr,
-                                    Cycles latency)
+PacketPtr
+AbstractController::makeMemoryPacket(const MachineID &id, Address addr,
+                                     bool write, int offset, int size,
+                                     const DataBlock *block)
 {
-    RequestPtr req = new Request(addr.getAddress(),
-                                 RubySystem::getBlockSizeBytes(), 0,
-                                 m_masterId);
+    RequestPtr req = new Request(addr.getAddress(), size, 0, m_masterId);
+    PacketPtr pkt = write ? Packet::createWrite(req) : Packet::createRead(req);
 
-    PacketPtr pkt = Packet::createRead(req);
-    uint8_t *newData = new uint8_t[RubySystem::getBlockSizeBytes()];
-    pkt->dataDynamic(newData);
+    std::shared_ptr<MemoryMsg> msg = makeMessage<MemoryMsg>(clockEdge());
+    (*msg).m_Addr = addr;
+    (*msg).m_Sender = m_machineID;
+    (*msg).m_OriginalRequestorMachId = id;
+    if (write) {
+        (*msg).m_Type = MemoryRequestType_MEMORY_WB;
+        (*msg).m_MessageSize = MessageSizeType_Writeback_Control;
+        (*msg).m_DataBlk.copyPartial(*block, offset, size);
+    } else {
+        (*msg).m_Type = MemoryRequestType_MEMORY_READ;
+        (*msg).m_MessageSize = MessageSizeType_Response_Data;
+    }
+    pkt->dataStatic((*msg).m_DataBlk.getDataMod(offset));
 
-    SenderState *s = new SenderState(id);
-    pkt->pushSenderState(s);
+    pkt->pushSenderState(new SenderState(id, msg));
+    return pkt;
+}
 
+void
+AbstractController::queueMemoryRead(const MachineID &id, Address addr,
+                                    Cycles latency)
+{
+    PacketPtr pkt = makeMemoryPacket(id, addr, false, 0,
+                                     RubySystem::getBlockSizeBytes(), NULL);
     memoryPort.schedTimingReq(pkt, clockEdge(latency));
 }
 
@@ -224,20 +241,8 @@ void
 AbstractController::queueMemoryWrite(const MachineID &id, Address addr,
                                      Cycles latency, const DataBlock &block)
 {
-    RequestPtr req = new Request(addr.getAddress(),
-                                 RubySystem::getBlockSizeBytes(), 0,
-                                 m_masterId);
-
-    PacketPtr pkt = Packet::createWrite(req);
-    uint8_t *newData = new uint8_t[RubySystem::getBlockSizeBytes()];
-    pkt->dataDynamic(newData);
-    memcpy(newData, block.getData(0, RubySystem::getBlockSizeBytes()),
-           RubySystem::getBlockSizeBytes());
-
-    SenderState *s = new SenderState(id);
-    pkt->pushSenderState(s);
-
-    // Create a block and copy data from the block.
+    PacketPtr pkt = makeMemoryPacket(id, addr, true, 0,
+                                     RubySystem::getBlockSizeBytes(), &block);
     memoryPort.schedTimingReq(pkt, clockEdge(latency));
 }
 
@@ -246,19 +251,8 @@ AbstractController::queueMemoryWritePartial(const MachineID &id, Address addr,
                                             Cycles latency,
                                             const DataBlock &block, int size)
 {
-    RequestPtr req = new Request(addr.getAddress(),
-                                 RubySystem::getBlockSizeBytes(), 0,
-                                 m_masterId);
-
-    PacketPtr pkt = Packet::createWrite(req);
-    uint8_t *newData = new uint8_t[size];
-    pkt->dataDynamic(newData);
-    memcpy(newData, block.getData(addr.getOffset(), size), size);
-
-    SenderState *s = new SenderState(id);
-    pkt->pushSenderState(s);
-
-    // Create a block and copy data from the block.
+    PacketPtr pkt = makeMemoryPacket(id, addr, true, addr.getOffset(), size,
+                                     &block);
     memoryPort.schedTimingReq(pkt, clockEdge(latency));
 }
 
@@ -290,29 +284,16 @@ void
 AbstractController::recvTimingResp(PacketPtr pkt)
 {
     assert(pkt->isResponse());
+    if (!pkt->isRead() && !pkt->isWrite())
+        panic("Incorrect packet type received from memory controller!");
 
-    std::shared_ptr<MemoryMsg> msg = std::make_shared<MemoryMsg>(clockEdge());
-    (*msg).m_Addr.setAddress(pkt->getAddr());
-    (*msg).m_Sender = m_machineID;
-
-    SenderState *s = dynamic_cast<SenderState *>(pkt->senderState);
-    (*msg).m_OriginalRequestorMachId = s->id;
+    // The data already sits in the message built with the request
+    SenderState *s = safe_cast<SenderState *>(pkt->popSenderState());
+    std::shared_ptr<MemoryMsg> msg = s->msg;
     delete s;
 
-    if (pkt->isRead()) {
-        (*msg).m_Type = MemoryRequestType_MEMORY_READ;
-        (*msg).m_MessageSize = MessageSizeType_Response_Data;
-
-        // Copy data from the packet
-        (*msg).m_DataBlk.setData(pkt->getPtr<uint8_t>(), 0,
-                                 RubySystem::getBlockSizeBytes());
-    } else if (pkt->isWrite()) {
-        (*msg).m_Type = MemoryRequestType_MEMORY_WB;
-        (*msg).m_MessageSize = MessageSizeType_Writeback_Control;
-    } else {
-        panic("Incorrect packet type received from memory controller!");
-    }
-
+    msg->setTime(clockEdge());
+    msg->setLastEnqueueTime(clockEdge());
     m_responseFromMemory_ptr->enqueue(msg);
     delete pkt;
 }
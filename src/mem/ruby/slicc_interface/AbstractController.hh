@@ -47,6 +47,7 @@
 #include "params/RubyController.hh"
 #include "mem/mem_object.hh"
 
+class MemoryMsg;
 class Network;
 
 class AbstractController : public MemObject, public Consumer
@@ -210,9 +211,19 @@ class AbstractController : public MemObject, public Consumer
         // Id of the machine from which the request originated.
         MachineID id;
 
-        SenderState(MachineID _id) : id(_id)
+        // The response, built when the request is sent.  The packet
+        // data lives in its data block, so memory reads and writes it
+        // in place and no copy is made when the response comes back.
+        std::shared_ptr<MemoryMsg> msg;
+
+        SenderState(MachineID _id, const std::shared_ptr<MemoryMsg> &_msg)
+            : id(_id), msg(_msg)
         {}
     };
+
+    PacketPtr makeMemoryPacket(const MachineID &id, Address addr,
+                               bool write, int offset, int size,
+                               const DataBlock *block);
 };
 
 #endif // __MEM_RUBY_SLICC_INTERFACE_ABSTRACTCONTROLLER_HH__
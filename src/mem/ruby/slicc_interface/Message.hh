@@ -31,12 +31,26 @@
 
 #include <iostream>
 #include <memory>
+#include <utility>
 
 #include "mem/packet.hh"
+#include "sim/event_pool.hh"
 
 class Message;
 typedef std::shared_ptr<Message> MsgPtr;
 
+/**
+ * Create a message together with its reference count in one slot of
+ * the EventPool, as messages are created and freed for every hop.
+ */
+template <class T, class... Args>
+inline std::shared_ptr<T>
+makeMessage(Args&&... args)
+{
+    return std::allocate_shared<T>(EventPoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
 class Message
 {
   public:
@@ -71,6 +85,13 @@ class Message
     virtual bool functionalWrite(Packet *pkt) = 0;
     //{ fatal("Write functional access not implemented!"); }
 
+    /**
+     * Invert one bit of the data block carried by the message, for
+     * network fault injection.  Returns false if the message has no
+     * data block.
+     */
+    virtual bool flipDataBit(unsigned int bit) { return false; }
+
     //! Update the delay this message has experienced so far.
     void updateDelayedTicks(Tick curTime)
     {
@@ -90,6 +111,10 @@ class Message
     Tick m_time;
     Tick m_LastEnqueueTime; // my last enqueue time
     Tick m_DelayedTicks; // my delayed cycles
+
+    // next message stalled on the same address in a MessageBuffer
+    friend class MessageBuffer;
+    MsgPtr m_next_stalled;
 };
 
 inline std::ostream&
@@ -29,6 +29,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "mem/ruby/structures/BankedArray.hh"
 #include "mem/ruby/system/System.hh"
@@ -75,6 +77,20 @@ BankedArray::tryAccess(int64 idx)
     return true;
 }
 
+Tick
+BankedArray::nextFreeTick(int64 idx)
+{
+    if (accessLatency == 0)
+        return curTick();
+
+    unsigned int bank = mapIndexToBank(idx);
+    assert(bank < banks);
+
+    // the bank is busy up to and including endAccess
+    Tick next = busyBanks[bank].endAccess + g_system_ptr->clockPeriod();
+    return std::max(next, curTick());
+}
+
 unsigned int
 BankedArray::mapIndexToBank(int64 idx)
 {
@@ -67,6 +67,9 @@ class BankedArray
     // This is so we don't get aliasing on blocks being replaced
     bool tryAccess(int64 idx);
 
+    // The first tick at which the bank of idx takes a new access
+    Tick nextFreeTick(int64 idx);
+
 };
 
 #endif
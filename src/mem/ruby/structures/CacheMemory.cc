@@ -37,6 +37,8 @@
 
 using namespace std;
 
+const physical_address_t CacheMemory::invalidTag;
+
 ostream&
 operator<<(ostream& out, const CacheMemory& obj)
 {
@@ -63,6 +65,7 @@ CacheMemory::CacheMemory(const Params *p)
     m_start_index_bit = p->start_index_bit;
     m_is_instruction_only_cache = p->is_icache;
     m_resource_stalls = p->resourceStalls;
+    m_resource_free_tick = 0;
 }
 
 void
@@ -83,13 +86,8 @@ CacheMemory::init()
     else
         assert(false);
 
-    m_cache.resize(m_cache_num_sets);
-    for (int i = 0; i < m_cache_num_sets; i++) {
-        m_cache[i].resize(m_cache_assoc);
-        for (int j = 0; j < m_cache_assoc; j++) {
-            m_cache[i][j] = NULL;
-        }
-    }
+    m_cache.resize(m_cache_num_sets * m_cache_assoc, NULL);
+    m_tags.resize(m_cache_num_sets * m_cache_assoc, invalidTag);
 }
 
 CacheMemory::~CacheMemory()
@@ -98,7 +96,7 @@ CacheMemory::~CacheMemory()
         delete m_replacementPolicy_ptr;
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            delete m_cache[i][j];
+            delete m_cache[i * m_cache_assoc + j];
         }
     }
 }
@@ -117,13 +115,11 @@ CacheMemory::addressToCacheSet(const Address& address) const
 int
 CacheMemory::findTagInSet(int64 cacheSet, const Address& tag) const
 {
-    assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
+    int loc = findTagInSetIgnorePermissions(cacheSet, tag);
+    if (loc != -1 &&
+        m_cache[cacheSet * m_cache_assoc + loc]->m_Permission !=
+        AccessPermission_NotPresent)
+        return loc;
     return -1; // Not found
 }
 
@@ -134,10 +130,14 @@ CacheMemory::findTagInSetIgnorePermissions(int64 cacheSet,
                                            const Address& tag) const
 {
     assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
+    // search the tags of the set, which are contiguous, with a simple
+    // loop the compiler can vectorise
+    const physical_address_t *tags = &m_tags[cacheSet * m_cache_assoc];
+    const physical_address_t addr = tag.getAddress();
+    for (int i = 0; i < m_cache_assoc; i++) {
+        if (tags[i] == addr)
+            return i;
+    }
     return -1; // Not found
 }
 
@@ -151,7 +151,7 @@ CacheMemory::tryCacheAccess(const Address& address, RubyRequestType type,
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = m_cache[cacheSet * m_cache_assoc + loc];
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
         data_ptr = &(entry->getDataBlk());
 
@@ -179,11 +179,11 @@ CacheMemory::testCacheAccess(const Address& address, RubyRequestType type,
 
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = m_cache[cacheSet * m_cache_assoc + loc];
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
         data_ptr = &(entry->getDataBlk());
 
-        return m_cache[cacheSet][loc]->m_Permission !=
+        return m_cache[cacheSet * m_cache_assoc + loc]->m_Permission !=
             AccessPermission_NotPresent;
     }
 
@@ -219,7 +219,7 @@ CacheMemory::cacheAvail(const Address& address) const
     int64 cacheSet = addressToCacheSet(address);
 
     for (int i = 0; i < m_cache_assoc; i++) {
-        AbstractCacheEntry* entry = m_cache[cacheSet][i];
+        AbstractCacheEntry* entry = m_cache[cacheSet * m_cache_assoc + i];
         if (entry != NULL) {
             if (entry->m_Address == address ||
                 entry->m_Permission == AccessPermission_NotPresent) {
@@ -243,7 +243,15 @@ CacheMemory::allocate(const Address& address, AbstractCacheEntry* entry)
 
     // Find the first open slot
     int64 cacheSet = addressToCacheSet(address);
-    std::vector<AbstractCacheEntry*> &set = m_cache[cacheSet];
+    AbstractCacheEntry **set = &m_cache[cacheSet * m_cache_assoc];
+    physical_address_t *tags = &m_tags[cacheSet * m_cache_assoc];
+
+    // drop the tag of a stale entry for this address, so the tag
+    // search finds the new entry
+    int stale = findTagInSetIgnorePermissions(cacheSet, address);
+    if (stale != -1)
+        tags[stale] = invalidTag;
+
     for (int i = 0; i < m_cache_assoc; i++) {
         if (!set[i] || set[i]->m_Permission == AccessPermission_NotPresent) {
             set[i] = entry;  // Init entry
@@ -252,7 +260,7 @@ CacheMemory::allocate(const Address& address, AbstractCacheEntry* entry)
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            tags[i] = address.getAddress();
 
             m_replacementPolicy_ptr->touch(cacheSet, i, curTick());
 
@@ -271,9 +279,9 @@ CacheMemory::deallocate(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
-        delete m_cache[cacheSet][loc];
-        m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        delete m_cache[cacheSet * m_cache_assoc + loc];
+        m_cache[cacheSet * m_cache_assoc + loc] = NULL;
+        m_tags[cacheSet * m_cache_assoc + loc] = invalidTag;
     }
 }
 
@@ -285,8 +293,8 @@ CacheMemory::cacheProbe(const Address& address) const
     assert(!cacheAvail(address));
 
     int64 cacheSet = addressToCacheSet(address);
-    return m_cache[cacheSet][m_replacementPolicy_ptr->getVictim(cacheSet)]->
-        m_Address;
+    int loc = m_replacementPolicy_ptr->getVictim(cacheSet);
+    return m_cache[cacheSet * m_cache_assoc + loc]->m_Address;
 }
 
 // looks an address up in the cache
@@ -297,7 +305,7 @@ CacheMemory::lookup(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if(loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return m_cache[cacheSet * m_cache_assoc + loc];
 }
 
 // looks an address up in the cache
@@ -308,7 +316,7 @@ CacheMemory::lookup(const Address& address) const
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if(loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return m_cache[cacheSet * m_cache_assoc + loc];
 }
 
 // Sets the most recently used bit for a cache block
@@ -331,8 +339,9 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
 
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
-                AccessPermission perm = m_cache[i][j]->m_Permission;
+            AbstractCacheEntry *entry = m_cache[i * m_cache_assoc + j];
+            if (entry != NULL) {
+                AccessPermission perm = entry->m_Permission;
                 RubyRequestType request_type = RubyRequestType_NULL;
                 if (perm == AccessPermission_Read_Only) {
                     if (m_is_instruction_only_cache) {
@@ -345,10 +354,10 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
                 }
 
                 if (request_type != RubyRequestType_NULL) {
-                    tr->addRecord(cntrl, m_cache[i][j]->m_Address.getAddress(),
+                    tr->addRecord(cntrl, entry->m_Address.getAddress(),
                                   0, request_type,
                                   m_replacementPolicy_ptr->getLastAccess(i, j),
-                                  m_cache[i][j]->getDataBlk());
+                                  entry->getDataBlk());
                     warmedUpBlocks++;
                 }
             }
@@ -367,10 +376,11 @@ CacheMemory::print(ostream& out) const
     out << "Cache dump: " << name() << endl;
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
+            const AbstractCacheEntry *entry = m_cache[i * m_cache_assoc + j];
+            if (entry != NULL) {
                 out << "  Index: " << i
                     << " way: " << j
-                    << " entry: " << *m_cache[i][j] << endl;
+                    << " entry: " << *entry << endl;
             } else {
                 out << "  Index: " << i
                     << " way: " << j
@@ -394,7 +404,7 @@ CacheMemory::setLocked(const Address& address, int context)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->m_locked = context;
+    m_cache[cacheSet * m_cache_assoc + loc]->m_locked = context;
 }
 
 void
@@ -405,7 +415,7 @@ CacheMemory::clearLocked(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->m_locked = -1;
+    m_cache[cacheSet * m_cache_assoc + loc]->m_locked = -1;
 }
 
 bool
@@ -415,9 +425,10 @@ CacheMemory::isLocked(const Address& address, int context)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
+    const AbstractCacheEntry *entry = m_cache[cacheSet * m_cache_assoc + loc];
     DPRINTF(RubyCache, "Testing Lock for addr: %llx cur %d con %d\n",
-            address, m_cache[cacheSet][loc]->m_locked, context);
-    return m_cache[cacheSet][loc]->m_locked == context;
+            address, entry->m_locked, context);
+    return entry->m_locked == context;
 }
 
 void
@@ -540,26 +551,32 @@ CacheMemory::checkResourceAvailable(CacheResourceType res, Address addr)
         return true;
     }
 
+    BankedArray *array;
     if (res == CacheResourceType_TagArray) {
+        array = &tagArray;
         if (tagArray.tryAccess(addressToCacheSet(addr))) return true;
         else {
             DPRINTF(RubyResourceStalls,
                     "Tag array stall on addr %s in set %d\n",
                     addr, addressToCacheSet(addr));
             numTagArrayStalls++;
-            return false;
         }
     } else if (res == CacheResourceType_DataArray) {
+        array = &dataArray;
         if (dataArray.tryAccess(addressToCacheSet(addr))) return true;
         else {
             DPRINTF(RubyResourceStalls,
                     "Data array stall on addr %s in set %d\n",
                     addr, addressToCacheSet(addr));
             numDataArrayStalls++;
-            return false;
         }
     } else {
         assert(false);
         return true;
     }
+
+    Tick free = array->nextFreeTick(addressToCacheSet(addr));
+    if (m_resource_free_tick == 0 || free < m_resource_free_tick)
+        m_resource_free_tick = free;
+    return false;
 }
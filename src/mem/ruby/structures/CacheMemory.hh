@@ -110,6 +110,19 @@ class CacheMemory : public SimObject
     bool checkResourceAvailable(CacheResourceType res, Address addr);
     void recordRequestType(CacheRequestType requestType);
 
+    /**
+     * Earliest tick at which a bank that failed checkResourceAvailable
+     * since the last call frees up, or 0 if none failed.  The
+     * controller schedules its retry for then rather than polling.
+     */
+    Tick
+    takeResourceFreeTick()
+    {
+        Tick t = m_resource_free_tick;
+        m_resource_free_tick = 0;
+        return t;
+    }
+
   public:
     Stats::Scalar m_demand_hits;
     Stats::Scalar m_demand_misses;
@@ -149,10 +162,14 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    m5::hash_map<Address, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // Entries and their line addresses, indexed by
+    // set * associativity + way, so the tags of a set are contiguous
+    // and searched without hashing.
+    std::vector<AbstractCacheEntry*> m_cache;
+    std::vector<physical_address_t> m_tags;
+
+    // Tag of a way that holds no line, as line addresses are aligned
+    static const physical_address_t invalidTag = ~physical_address_t(0);
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
@@ -166,6 +183,7 @@ class CacheMemory : public SimObject
     int m_cache_assoc;
     int m_start_index_bit;
     bool m_resource_stalls;
+    Tick m_resource_free_tick;
 };
 
 std::ostream& operator<<(std::ostream& out, const CacheMemory& obj);
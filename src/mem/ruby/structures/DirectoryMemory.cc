@@ -47,6 +47,8 @@ DirectoryMemory::DirectoryMemory(const Params *p)
     m_size_bytes = p->size;
     m_size_bits = floorLog2(m_size_bytes);
     m_num_entries = 0;
+    m_num_pages = 0;
+    m_num_allocated = 0;
     m_numa_high_bit = p->numa_high_bit;
 }
 
@@ -54,9 +56,8 @@ void
 DirectoryMemory::init()
 {
     m_num_entries = m_size_bytes / RubySystem::getBlockSizeBytes();
-    m_entries = new AbstractEntry*[m_num_entries];
-    for (int i = 0; i < m_num_entries; i++)
-        m_entries[i] = NULL;
+    m_entry_pages.assign((m_num_entries + EntryPageSize - 1) >> EntryPageBits,
+                         NULL);
 
     m_num_directories++;
     m_num_directories_bits = ceilLog2(m_num_directories);
@@ -71,12 +72,14 @@ DirectoryMemory::init()
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    for (uint64 i = 0; i < m_num_entries; i++) {
-        if (m_entries[i] != NULL) {
-            delete m_entries[i];
-        }
+    for (auto page : m_entry_pages) {
+        if (page == NULL)
+            continue;
+
+        for (uint64 i = 0; i < EntryPageSize; i++)
+            delete page[i];
+        delete [] page;
     }
-    delete [] m_entries;
 }
 
 uint64
@@ -119,7 +122,8 @@ DirectoryMemory::lookup(PhysAddress address)
 
     uint64_t idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
-    return m_entries[idx];
+    AbstractEntry **page = m_entry_pages[idx >> EntryPageBits];
+    return page ? page[idx & (EntryPageSize - 1)] : NULL;
 }
 
 AbstractEntry*
@@ -132,11 +136,28 @@ DirectoryMemory::allocate(const PhysAddress& address, AbstractEntry* entry)
     idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
     entry->changePermission(AccessPermission_Read_Only);
-    m_entries[idx] = entry;
+
+    AbstractEntry **&page = m_entry_pages[idx >> EntryPageBits];
+    if (page == NULL) {
+        page = new AbstractEntry*[EntryPageSize]();
+        m_num_pages++;
+    }
+    if (page[idx & (EntryPageSize - 1)] == NULL)
+        m_num_allocated++;
+    page[idx & (EntryPageSize - 1)] = entry;
 
     return entry;
 }
 
+uint64_t
+DirectoryMemory::hostMemUsage() const
+{
+    return m_entry_pages.capacity() * sizeof(AbstractEntry **) +
+        m_num_pages * EntryPageSize * sizeof(AbstractEntry *) +
+        m_num_allocated *
+        (sizeof(AbstractEntry) + RubySystem::getBlockSizeBytes());
+}
+
 void
 DirectoryMemory::print(ostream& out) const
 {
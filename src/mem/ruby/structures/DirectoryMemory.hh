@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "mem/protocol/DirectoryRequestType.hh"
 #include "mem/ruby/common/Address.hh"
@@ -60,14 +61,27 @@ class DirectoryMemory : public SimObject
     void print(std::ostream& out) const;
     void recordRequestType(DirectoryRequestType requestType);
 
+    // The entry pages and the entries, each counted as a block of
+    // data as that is what most of them hold.
+    uint64_t hostMemUsage() const;
+
   private:
     // Private copy constructor and assignment operator
     DirectoryMemory(const DirectoryMemory& obj);
     DirectoryMemory& operator=(const DirectoryMemory& obj);
 
   private:
+    //! log2 of the number of entries in a page of the entry table
+    static const int EntryPageBits = 12;
+    static const uint64 EntryPageSize = ULL(1) << EntryPageBits;
+
     const std::string m_name;
-    AbstractEntry **m_entries;
+    // Two level table of the entries.  A page is allocated the first
+    // time one of its blocks is, so the host memory taken grows with
+    // the footprint touched rather than the size of the directory.
+    std::vector<AbstractEntry **> m_entry_pages;
+    uint64 m_num_pages;
+    uint64 m_num_allocated;
     // int m_size;  // # of memory module blocks this directory is
                     // responsible for
     uint64 m_size_bytes;
@@ -30,17 +30,29 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
+#include <vector>
 
-#include "base/hashmap.hh"
+#include "base/open_hash_map.hh"
 #include "mem/ruby/common/Address.hh"
 
+/**
+ * The TBEs of a controller, whose number is fixed by the protocol.
+ * The entries are allocated up front and found through an open
+ * addressed index sized for all of them, so neither allocating nor
+ * deallocating a TBE touches the heap.  An entry does not move while
+ * it is allocated.
+ */
 template<class ENTRY>
 class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_entries(number_of_TBEs), m_index(number_of_TBEs),
+          m_number_of_TBEs(number_of_TBEs)
     {
+        m_free.reserve(number_of_TBEs);
+        for (int i = number_of_TBEs - 1; i >= 0; i--)
+            m_free.push_back(i);
     }
 
     bool isPresent(const Address& address) const;
@@ -49,7 +61,7 @@ class TBETable
     bool
     areNSlotsAvailable(int n) const
     {
-        return (m_number_of_TBEs - m_map.size()) >= n;
+        return (int)m_free.size() >= n;
     }
 
     ENTRY* lookup(const Address& address);
@@ -63,7 +75,11 @@ class TBETable
     TBETable& operator=(const TBETable& obj);
 
     // Data Members (m_prefix)
-    m5::hash_map<Address, ENTRY> m_map;
+    std::vector<ENTRY> m_entries;
+    std::vector<int> m_free;
+
+    // Entry numbers by address
+    OpenHashMap<Address, int> m_index;
 
   private:
     int m_number_of_TBEs;
@@ -83,8 +99,7 @@ inline bool
 TBETable<ENTRY>::isPresent(const Address& address) const
 {
     assert(address == line_address(address));
-    assert(m_map.size() <= m_number_of_TBEs);
-    return !!m_map.count(address);
+    return m_index.find(address) != NULL;
 }
 
 template<class ENTRY>
@@ -92,8 +107,12 @@ inline void
 TBETable<ENTRY>::allocate(const Address& address)
 {
     assert(!isPresent(address));
-    assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    assert(!m_free.empty());
+
+    int entry = m_free.back();
+    m_free.pop_back();
+    m_entries[entry] = ENTRY();
+    *m_index.insert(address).first = entry;
 }
 
 template<class ENTRY>
@@ -101,8 +120,8 @@ inline void
 TBETable<ENTRY>::deallocate(const Address& address)
 {
     assert(isPresent(address));
-    assert(m_map.size() > 0);
-    m_map.erase(address);
+    m_free.push_back(*m_index.find(address));
+    m_index.erase(address);
 }
 
 // looks an address up in the cache
@@ -110,8 +129,8 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(const Address& address)
 {
-  if(m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    int *entry = m_index.find(address);
+    return entry ? &m_entries[*entry] : NULL;
 }
 
 
@@ -52,11 +52,11 @@ CacheRecorder::CacheRecorder()
 CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              uint64_t uncompressed_trace_size,
                              std::vector<Sequencer*>& seq_map,
-                             uint64_t block_size_bytes)
+                             uint64_t block_size_bytes, bool parallel_fetch)
     : m_uncompressed_trace(uncompressed_trace),
       m_uncompressed_trace_size(uncompressed_trace_size),
-      m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0), m_block_size_bytes(block_size_bytes)
+      m_seq_map(seq_map), m_records_flushed(0),
+      m_block_size_bytes(block_size_bytes)
 {
     if (m_uncompressed_trace != NULL) {
         if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
@@ -67,6 +67,35 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                     m_block_size_bytes, RubySystem::getBlockSizeBytes());
         }
     }
+
+    if (!parallel_fetch)
+        m_fetch_streams.resize(1);
+
+    // Split the trace by the sequencer replaying each record, keeping the
+    // trace order within a sequencer.  Controllers without a sequencer of
+    // their own share one, and so share its stream.
+    uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    for (uint64_t offset = 0;
+         offset + record_size <= m_uncompressed_trace_size;
+         offset += record_size) {
+        TraceRecord* rec = (TraceRecord*)(m_uncompressed_trace + offset);
+        assert(rec->m_cntrl_id < (int)m_seq_map.size());
+        Sequencer* seq = m_seq_map[rec->m_cntrl_id];
+        assert(seq != NULL);
+
+        int stream = 0;
+        if (parallel_fetch) {
+            auto s = m_stream_of_seq.find(seq);
+            if (s == m_stream_of_seq.end()) {
+                stream = m_fetch_streams.size();
+                m_fetch_streams.resize(stream + 1);
+                m_stream_of_seq[seq] = stream;
+            } else {
+                stream = s->second;
+            }
+        }
+        m_fetch_streams[stream].records.push_back(rec);
+    }
 }
 
 CacheRecorder::~CacheRecorder()
@@ -99,11 +128,36 @@ CacheRecorder::enqueueNextFlushRequest()
 }
 
 void
-CacheRecorder::enqueueNextFetchRequest()
+CacheRecorder::startFetchRequests()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    DPRINTF(RubyCacheTrace, "Replaying the cache trace on %d stream(s)\n",
+            m_fetch_streams.size());
+    for (auto &stream : m_fetch_streams)
+        issueNextFetch(stream);
+}
+
+void
+CacheRecorder::enqueueNextFetchRequest(Sequencer* seq)
+{
+    int stream = 0;
+    if (!m_stream_of_seq.empty()) {
+        auto s = m_stream_of_seq.find(seq);
+        assert(s != m_stream_of_seq.end());
+        stream = s->second;
+    }
+
+    FetchStream &fetch = m_fetch_streams[stream];
+    assert(fetch.pending > 0);
+    if (--fetch.pending == 0)
+        issueNextFetch(fetch);
+}
+
+void
+CacheRecorder::issueNextFetch(FetchStream& stream)
+{
+    if (stream.next < stream.records.size()) {
+        TraceRecord* traceRecord = stream.records[stream.next];
+        stream.next++;
 
         DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
 
@@ -132,11 +186,9 @@ CacheRecorder::enqueueNextFetchRequest()
 
             Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
             assert(m_sequencer_ptr != NULL);
+            stream.pending++;
             m_sequencer_ptr->makeRequest(pkt);
         }
-
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
-        m_records_read++;
     }
 }
 
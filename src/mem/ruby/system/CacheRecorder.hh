@@ -35,6 +35,7 @@
 #ifndef __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 #define __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 
+#include <map>
 #include <vector>
 
 #include "base/hashmap.hh"
@@ -73,7 +74,7 @@ class CacheRecorder
     CacheRecorder(uint8_t* uncompressed_trace,
                   uint64_t uncompressed_trace_size,
                   std::vector<Sequencer*>& SequencerMap,
-                  uint64_t block_size_bytes);
+                  uint64_t block_size_bytes, bool parallel_fetch = false);
     void addRecord(int cntrl, const physical_address_t data_addr,
                    const physical_address_t pc_addr,  RubyRequestType type,
                    Tick time, DataBlock& data);
@@ -91,25 +92,41 @@ class CacheRecorder
     void enqueueNextFlushRequest();
 
     /*!
-     * Function for fetching warming up the memory and the caches. It goes
+     * Functions for fetching warming up the memory and the caches. They go
      * through the recorded contents of the caches, as available in the
-     * checkpoint and issues fetch requests. Except for the first one, a
+     * checkpoint and issue fetch requests. Except for the first one, a
      * fetch request is issued only after the previous one has completed.
-     * It should be possible to use this with any protocol.
+     * With parallel fetch this holds per sequencer, so the sequencers
+     * replay their own records concurrently, otherwise it holds across
+     * the whole trace. It should be possible to use this with any
+     * protocol.
      */
-    void enqueueNextFetchRequest();
+    void startFetchRequests();
+    void enqueueNextFetchRequest(Sequencer* seq);
 
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    //! Records of the trace replayed in order, one at a time
+    struct FetchStream
+    {
+        FetchStream() : next(0), pending(0) {}
+        std::vector<TraceRecord*> records;
+        size_t next;
+        //! Requests of the current record still outstanding
+        int pending;
+    };
+
+    void issueNextFetch(FetchStream& stream);
+
     std::vector<TraceRecord*> m_records;
     uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
     std::vector<Sequencer*> m_seq_map;
-    uint64_t m_bytes_read;
-    uint64_t m_records_read;
+    std::vector<FetchStream> m_fetch_streams;
+    std::map<Sequencer*, int> m_stream_of_seq;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
 };
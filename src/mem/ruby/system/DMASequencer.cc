@@ -251,7 +251,7 @@ DMASequencer::makeRequest(PacketPtr pkt)
     active_request.pkt = pkt;
 
     std::shared_ptr<SequencerMsg> msg =
-        std::make_shared<SequencerMsg>(clockEdge());
+        makeMessage<SequencerMsg>(clockEdge());
     msg->getPhysicalAddress() = Address(paddr);
     msg->getLineAddress() = line_address(msg->getPhysicalAddress());
     msg->getType() = write ? SequencerRequestType_ST : SequencerRequestType_LD;
@@ -290,7 +290,7 @@ DMASequencer::issueNext()
     }
 
     std::shared_ptr<SequencerMsg> msg =
-        std::make_shared<SequencerMsg>(clockEdge());
+        makeMessage<SequencerMsg>(clockEdge());
     msg->getPhysicalAddress() = Address(active_request.start_paddr +
                                        active_request.bytes_completed);
 
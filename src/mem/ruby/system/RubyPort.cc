@@ -63,6 +63,9 @@ RubyPort::RubyPort(const Params *p)
 {
     assert(m_version != -1);
 
+    // Ruby holds copies of memory in its own caches
+    system->registerCachingAgent();
+
     // create the slave ports based on the number of connected ports
     for (size_t i = 0; i < p->port_slave_connection_count; ++i) {
         slave_ports.push_back(new MemSlavePort(csprintf("%s.slave%d", name(),
@@ -300,9 +303,12 @@ RubyPort::MemSlavePort::recvFunctional(PacketPtr pkt)
     bool accessSucceeded = false;
     bool needsResponse = pkt->needsResponse();
 
-    // Do the functional access on ruby memory
+    // Do the functional access on ruby memory.  When the attached
+    // physmem holds the official version of data, reads are served
+    // from it below and Ruby need not be searched.
     if (pkt->isRead()) {
-        accessSucceeded = ruby_system->functionalRead(pkt);
+        accessSucceeded = access_backing_store ||
+            ruby_system->functionalRead(pkt);
     } else if (pkt->isWrite()) {
         accessSucceeded = ruby_system->functionalWrite(pkt);
     } else {
@@ -41,9 +41,17 @@ class RubySystem(ClockedObject):
         "default cache block size; must be a power of two");
     memory_size_bits = Param.UInt32(64,
         "number of bits that a memory address requires");
+    parallel_warmup = Param.Bool(True,
+        "replay the checkpointed cache trace on all sequencers at once, "
+        "rather than one request at a time")
 
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
+    hot_lines_sample_bits = Param.UInt32(0,
+        "profile only one in 2^N addresses, picked by hash")
+    hot_lines_entries = Param.UInt32(0,
+        "most addresses kept by each address profile, counting the "
+        "heaviest hitters; 0 for no limit")
     num_of_sequencers = Param.Int("")
     phys_mem = Param.SimpleMemory(NULL, "")
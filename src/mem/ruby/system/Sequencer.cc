@@ -67,7 +67,15 @@ Sequencer::Sequencer(const Params *p)
     assert(m_instCache_ptr != NULL);
     assert(m_dataCache_ptr != NULL);
 
+    m_request_slots.resize(m_max_outstanding_requests);
+    m_free_slots.reserve(m_max_outstanding_requests);
+    for (int i = m_max_outstanding_requests - 1; i >= 0; --i)
+        m_free_slots.push_back(i);
+
+    m_request_index.reserve(m_max_outstanding_requests);
+
     m_usingNetworkTester = p->using_network_tester;
+    m_coalesce_requests = p->coalesce_requests;
 }
 
 Sequencer::~Sequencer()
@@ -85,39 +93,23 @@ Sequencer::wakeup()
     // Check across all outstanding requests
     int total_outstanding = 0;
 
-    RequestTable::iterator read = m_readRequestTable.begin();
-    RequestTable::iterator read_end = m_readRequestTable.end();
-    for (; read != read_end; ++read) {
-        SequencerRequest* request = read->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
+    for (const auto &slot : m_request_slots) {
+        const SequencerRequest* request = &slot.request;
+        if (!request->pkt)
             continue;
-
-        panic("Possible Deadlock detected. Aborting!\n"
-             "version: %d request.paddr: 0x%x m_readRequestTable: %d "
-             "current time: %u issue_time: %d difference: %d\n", m_version,
-             Address(request->pkt->getAddr()), m_readRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
-    }
-
-    RequestTable::iterator write = m_writeRequestTable.begin();
-    RequestTable::iterator write_end = m_writeRequestTable.end();
-    for (; write != write_end; ++write) {
-        SequencerRequest* request = write->second;
+        total_outstanding++;
         if (current_time - request->issue_time < m_deadlock_threshold)
             continue;
 
         panic("Possible Deadlock detected. Aborting!\n"
-             "version: %d request.paddr: 0x%x m_writeRequestTable: %d "
+             "version: %d request.paddr: 0x%x %s outstanding: %d "
              "current time: %u issue_time: %d difference: %d\n", m_version,
-             Address(request->pkt->getAddr()), m_writeRequestTable.size(),
+             Address(request->pkt->getAddr()),
+             slot.write ? "write" : "read", m_outstanding_count,
               current_time * clockPeriod(), request->issue_time * clockPeriod(),
               (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
     }
 
-    total_outstanding += m_writeRequestTable.size();
-    total_outstanding += m_readRequestTable.size();
-
     assert(m_outstanding_count == total_outstanding);
 
     if (m_outstanding_count > 0) {
@@ -205,13 +197,67 @@ Sequencer::printProgress(ostream& out) const
 #endif
 }
 
-// Insert the request on the correct request table.  Return true if
-// the entry was already present.
+bool
+Sequencer::isWriteRequest(RubyRequestType type)
+{
+    return (type == RubyRequestType_ST) ||
+           (type == RubyRequestType_RMW_Read) ||
+           (type == RubyRequestType_RMW_Write) ||
+           (type == RubyRequestType_Load_Linked) ||
+           (type == RubyRequestType_Store_Conditional) ||
+           (type == RubyRequestType_Locked_RMW_Read) ||
+           (type == RubyRequestType_Locked_RMW_Write) ||
+           (type == RubyRequestType_FLUSH);
+}
+
+// Whether a request of the given type may wait behind an outstanding
+// primary request to its line.  The primary's response must grant at
+// least the permission the request needs, and neither may carry
+// LL/SC, locking or flush semantics.
+bool
+Sequencer::canCoalesce(RubyRequestType primary, RubyRequestType type)
+{
+    switch (type) {
+      case RubyRequestType_LD:
+        return primary == RubyRequestType_LD || primary == RubyRequestType_ST;
+      case RubyRequestType_IFETCH:
+        return primary == RubyRequestType_IFETCH;
+      case RubyRequestType_ST:
+        return primary == RubyRequestType_ST;
+      default:
+        return false;
+    }
+}
+
+int
+Sequencer::findRequest(const Address& line_addr) const
+{
+    const int *slot = m_request_index.find(line_addr);
+    return slot ? *slot : -1;
+}
+
+void
+Sequencer::freeRequest(int slot)
+{
+    RequestSlot &entry = m_request_slots[slot];
+    m_request_index.erase(entry.line_addr);
+
+    entry.request = SequencerRequest();
+    entry.coalesced.clear();
+    m_free_slots.push_back(slot);
+    m_outstanding_count--;
+    assert(m_outstanding_count ==
+           m_request_slots.size() - m_free_slots.size());
+}
+
+// Insert the request on the request table.  Return Aliased if a request
+// for the line is already outstanding, or Issued if the request was
+// coalesced with it.
 RequestStatus
 Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
 {
     assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
+        (m_request_slots.size() - m_free_slots.size()));
 
     // See if we should schedule a deadlock check
     if (!deadlockCheckEvent.scheduled() &&
@@ -221,104 +267,74 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
 
     Address line_addr(pkt->getAddr());
     line_addr.makeLineAddress();
-    // Create a default entry, mapping the address to NULL, the cast is
-    // there to make gcc 4.4 happy
-    RequestTable::value_type default_entry(line_addr,
-                                           (SequencerRequest*) NULL);
-
-    if ((request_type == RubyRequestType_ST) ||
-        (request_type == RubyRequestType_RMW_Read) ||
-        (request_type == RubyRequestType_RMW_Write) ||
-        (request_type == RubyRequestType_Load_Linked) ||
-        (request_type == RubyRequestType_Store_Conditional) ||
-        (request_type == RubyRequestType_Locked_RMW_Read) ||
-        (request_type == RubyRequestType_Locked_RMW_Write) ||
-        (request_type == RubyRequestType_FLUSH)) {
-
-        // Check if there is any outstanding read request for the same
-        // cache line.
-        if (m_readRequestTable.count(line_addr) > 0) {
-            m_store_waiting_on_load++;
-            return RequestStatus_Aliased;
-        }
-
-        pair<RequestTable::iterator, bool> r =
-            m_writeRequestTable.insert(default_entry);
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
+    bool write = isWriteRequest(request_type);
+
+    int slot = findRequest(line_addr);
+    if (slot >= 0 && m_coalesce_requests &&
+        canCoalesce(m_request_slots[slot].request.m_type, request_type)) {
+        DPRINTF(RubySequencer, "Coalescing %s 0x%x with an outstanding "
+                "request\n", RubyRequestType_to_string(request_type),
+                pkt->getAddr());
+        m_request_slots[slot].coalesced.push_back(
+            SequencerRequest(pkt, request_type, curCycle()));
+        if (write)
+            m_coalesced_stores++;
+        else
+            m_coalesced_loads++;
+        return RequestStatus_Issued;
+    } else if (slot >= 0) {
+        // There is an outstanding request for the same cache line
+        if (write) {
+            if (m_request_slots[slot].write)
+                m_store_waiting_on_store++;
+            else
+                m_store_waiting_on_load++;
         } else {
-          // There is an outstanding write request for the cache line
-          m_store_waiting_on_store++;
-          return RequestStatus_Aliased;
-        }
-    } else {
-        // Check if there is any outstanding write request for the same
-        // cache line.
-        if (m_writeRequestTable.count(line_addr) > 0) {
-            m_load_waiting_on_store++;
-            return RequestStatus_Aliased;
+            if (m_request_slots[slot].write)
+                m_load_waiting_on_store++;
+            else
+                m_load_waiting_on_load++;
         }
+        return RequestStatus_Aliased;
+    }
 
-        pair<RequestTable::iterator, bool> r =
-            m_readRequestTable.insert(default_entry);
+    // makeRequest() refuses requests beyond m_max_outstanding_requests
+    assert(!m_free_slots.empty());
+    slot = m_free_slots.back();
+    m_free_slots.pop_back();
 
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
-        } else {
-            // There is an outstanding read request for the cache line
-            m_load_waiting_on_load++;
-            return RequestStatus_Aliased;
-        }
-    }
+    RequestSlot &entry = m_request_slots[slot];
+    entry.request = SequencerRequest(pkt, request_type, curCycle());
+    entry.line_addr = line_addr;
+    entry.write = write;
+
+    *m_request_index.insert(line_addr).first = slot;
+    m_outstanding_count++;
 
     m_outstandReqHist.sample(m_outstanding_count);
     assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
+        (m_request_slots.size() - m_free_slots.size()));
 
     return RequestStatus_Ready;
 }
 
-void
-Sequencer::markRemoved()
-{
-    m_outstanding_count--;
-    assert(m_outstanding_count ==
-           m_writeRequestTable.size() + m_readRequestTable.size());
-}
-
 void
 Sequencer::removeRequest(SequencerRequest* srequest)
 {
-    assert(m_outstanding_count ==
-           m_writeRequestTable.size() + m_readRequestTable.size());
-
     Address line_addr(srequest->pkt->getAddr());
     line_addr.makeLineAddress();
-    if ((srequest->m_type == RubyRequestType_ST) ||
-        (srequest->m_type == RubyRequestType_RMW_Read) ||
-        (srequest->m_type == RubyRequestType_RMW_Write) ||
-        (srequest->m_type == RubyRequestType_Load_Linked) ||
-        (srequest->m_type == RubyRequestType_Store_Conditional) ||
-        (srequest->m_type == RubyRequestType_Locked_RMW_Read) ||
-        (srequest->m_type == RubyRequestType_Locked_RMW_Write)) {
-        m_writeRequestTable.erase(line_addr);
-    } else {
-        m_readRequestTable.erase(line_addr);
-    }
 
-    markRemoved();
+    int slot = findRequest(line_addr);
+    assert(slot >= 0);
+    freeRequest(slot);
 }
 
 void
 Sequencer::invalidateSC(const Address& address)
 {
-    RequestTable::iterator i = m_writeRequestTable.find(address);
-    if (i != m_writeRequestTable.end()) {
-        SequencerRequest* request = i->second;
+    int slot = findRequest(address);
+    if (slot >= 0 && m_request_slots[slot].write) {
+        const SequencerRequest* request = &m_request_slots[slot].request;
         // The controller has lost the coherence permissions, hence the lock
         // on the cache line maintained by the cache should be cleared.
         if (request->m_type == RubyRequestType_Store_Conditional) {
@@ -426,14 +442,16 @@ Sequencer::writeCallback(const Address& address, DataBlock& data,
                          const Cycles firstResponseTime)
 {
     assert(address == line_address(address));
-    assert(m_writeRequestTable.count(line_address(address)));
 
-    RequestTable::iterator i = m_writeRequestTable.find(address);
-    assert(i != m_writeRequestTable.end());
-    SequencerRequest* request = i->second;
+    int slot = findRequest(address);
+    assert(slot >= 0 && m_request_slots[slot].write);
+    // copy the request out, the slot may be reused by hitCallback()
+    SequencerRequest req = m_request_slots[slot].request;
+    SequencerRequest* request = &req;
+    std::vector<SequencerRequest> coalesced;
+    coalesced.swap(m_request_slots[slot].coalesced);
 
-    m_writeRequestTable.erase(i);
-    markRemoved();
+    freeRequest(slot);
 
     assert((request->m_type == RubyRequestType_ST) ||
            (request->m_type == RubyRequestType_ATOMIC) ||
@@ -463,6 +481,16 @@ Sequencer::writeCallback(const Address& address, DataBlock& data,
 
     hitCallback(request, data, success, mach, externalHit,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
+
+    // Loads and stores that waited on the line complete in order, so a
+    // load sees the data of the stores before it.
+    for (auto &waiter : coalesced) {
+        if (!m_usingNetworkTester && waiter.m_type == RubyRequestType_ST)
+            handleLlsc(address, &waiter);
+        hitCallback(&waiter, data, true, mach, externalHit,
+                    initialRequestTime, forwardRequestTime,
+                    firstResponseTime);
+    }
 }
 
 void
@@ -473,20 +501,28 @@ Sequencer::readCallback(const Address& address, DataBlock& data,
                         Cycles firstResponseTime)
 {
     assert(address == line_address(address));
-    assert(m_readRequestTable.count(line_address(address)));
 
-    RequestTable::iterator i = m_readRequestTable.find(address);
-    assert(i != m_readRequestTable.end());
-    SequencerRequest* request = i->second;
+    int slot = findRequest(address);
+    assert(slot >= 0 && !m_request_slots[slot].write);
+    // copy the request out, the slot may be reused by hitCallback()
+    SequencerRequest req = m_request_slots[slot].request;
+    SequencerRequest* request = &req;
+    std::vector<SequencerRequest> coalesced;
+    coalesced.swap(m_request_slots[slot].coalesced);
 
-    m_readRequestTable.erase(i);
-    markRemoved();
+    freeRequest(slot);
 
     assert((request->m_type == RubyRequestType_LD) ||
            (request->m_type == RubyRequestType_IFETCH));
 
     hitCallback(request, data, true, mach, externalHit,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
+
+    for (auto &waiter : coalesced) {
+        hitCallback(&waiter, data, true, mach, externalHit,
+                    initialRequestTime, forwardRequestTime,
+                    firstResponseTime);
+    }
 }
 
 void
@@ -555,13 +591,11 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         testerSenderState->subBlock.mergeFrom(data);
     }
 
-    delete srequest;
-
     if (g_system_ptr->m_warmup_enabled) {
         assert(pkt->req);
         delete pkt->req;
         delete pkt;
-        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest();
+        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest(this);
     } else if (g_system_ptr->m_cooldown_enabled) {
         delete pkt;
         g_system_ptr->m_cache_recorder->enqueueNextFlushRequest();
@@ -573,7 +607,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
 bool
 Sequencer::empty() const
 {
-    return m_writeRequestTable.empty() && m_readRequestTable.empty();
+    return m_outstanding_count == 0;
 }
 
 RequestStatus
@@ -679,12 +713,12 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     // check if the packet has data as for example prefetch and flush
     // requests do not
     std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->isFlush() ?
-                                      nullptr : pkt->getPtr<uint8_t>(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id);
+        makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
+                                 pkt->isFlush() ?
+                                 nullptr : pkt->getPtr<uint8_t>(),
+                                 pkt->getSize(), pc, secondary_type,
+                                 RubyAccessMode_Supervisor, pkt,
+                                 PrefetchBit_No, proc_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -705,18 +739,10 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, latency);
 }
 
-template <class KEY, class VALUE>
 std::ostream &
-operator<<(ostream &out, const m5::hash_map<KEY, VALUE> &map)
+operator<<(ostream &out, const SequencerRequest &obj)
 {
-    typename m5::hash_map<KEY, VALUE>::const_iterator i = map.begin();
-    typename m5::hash_map<KEY, VALUE>::const_iterator end = map.end();
-
-    out << "[";
-    for (; i != end; ++i)
-        out << " " << i->first << "=" << i->second;
-    out << " ]";
-
+    out << RubyRequestType_to_string(obj.m_type) << "@" << obj.issue_time;
     return out;
 }
 
@@ -724,10 +750,16 @@ void
 Sequencer::print(ostream& out) const
 {
     out << "[Sequencer: " << m_version
-        << ", outstanding requests: " << m_outstanding_count
-        << ", read request table: " << m_readRequestTable
-        << ", write request table: " << m_writeRequestTable
-        << "]";
+        << ", outstanding requests: " << m_outstanding_count;
+    for (int write = 0; write < 2; ++write) {
+        out << (write ? ", write" : ", read") << " request table: [";
+        for (const auto &slot : m_request_slots) {
+            if (slot.request.pkt && slot.write == write)
+                out << " " << slot.line_addr << "=" << slot.request;
+        }
+        out << " ]";
+    }
+    out << "]";
 }
 
 // this can be called from setState whenever coherence permissions are
@@ -773,6 +805,14 @@ Sequencer::regStats()
         .name(name() + ".load_waiting_on_store")
         .desc("Number of times a load aliased with a pending store")
         .flags(Stats::nozero);
+    m_coalesced_loads
+        .name(name() + ".coalesced_loads")
+        .desc("Number of loads coalesced with a pending request")
+        .flags(Stats::nozero);
+    m_coalesced_stores
+        .name(name() + ".coalesced_stores")
+        .desc("Number of stores coalesced with a pending store")
+        .flags(Stats::nozero);
 
     // These statistical variables are not for display.
     // The profiler will collate these across different
@@ -30,8 +30,9 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
+#include <vector>
 
-#include "base/hashmap.hh"
+#include "base/open_hash_map.hh"
 #include "mem/protocol/MachineType.hh"
 #include "mem/protocol/RubyRequestType.hh"
 #include "mem/protocol/SequencerRequestType.hh"
@@ -46,6 +47,10 @@ struct SequencerRequest
     RubyRequestType m_type;
     Cycles issue_time;
 
+    SequencerRequest()
+        : pkt(NULL), m_type(RubyRequestType_NULL), issue_time(0)
+    {}
+
     SequencerRequest(PacketPtr _pkt, RubyRequestType _m_type,
                      Cycles _issue_time)
         : pkt(_pkt), m_type(_m_type), issue_time(_issue_time)
@@ -97,7 +102,6 @@ class Sequencer : public RubyPort
     void print(std::ostream& out) const;
     void checkCoherence(const Address& address);
 
-    void markRemoved();
     void removeRequest(SequencerRequest* request);
     void evictionCallback(const Address& address);
     void invalidateSC(const Address& address);
@@ -167,6 +171,10 @@ class Sequencer : public RubyPort
                            Cycles completionTime);
 
     RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type);
+    static bool isWriteRequest(RubyRequestType type);
+    static bool canCoalesce(RubyRequestType primary, RubyRequestType type);
+    int findRequest(const Address &line_addr) const;
+    void freeRequest(int slot);
     bool handleLlsc(const Address& address, SequencerRequest* request);
 
     // Private copy constructor and assignment operator
@@ -180,18 +188,36 @@ class Sequencer : public RubyPort
     CacheMemory* m_dataCache_ptr;
     CacheMemory* m_instCache_ptr;
 
-    typedef m5::hash_map<Address, SequencerRequest*> RequestTable;
-    RequestTable m_writeRequestTable;
-    RequestTable m_readRequestTable;
-    // Global outstanding request count, across all request tables
+    // Outstanding requests live inline in a fixed array of
+    // m_max_outstanding_requests slots.  A line has at most one request
+    // in flight, read or write, so a single open-addressed index keyed
+    // by line address serves both.  With coalescing, later compatible
+    // requests to the line wait in the slot and complete in program
+    // order behind the one in flight.
+    struct RequestSlot
+    {
+        SequencerRequest request;
+        Address line_addr;
+        bool write;
+        std::vector<SequencerRequest> coalesced;
+    };
+    std::vector<RequestSlot> m_request_slots;
+    std::vector<int> m_free_slots;
+    //! Slot numbers by line address, sized up front so it never grows
+    OpenHashMap<Address, int> m_request_index;
+    // Global outstanding request count, read and write
     int m_outstanding_count;
     bool m_deadlock_check_scheduled;
+    bool m_coalesce_requests;
 
     //! Counters for recording aliasing information.
     Stats::Scalar m_store_waiting_on_load;
     Stats::Scalar m_store_waiting_on_store;
     Stats::Scalar m_load_waiting_on_store;
     Stats::Scalar m_load_waiting_on_load;
+    //! Requests attached to an outstanding request for their line.
+    Stats::Scalar m_coalesced_loads;
+    Stats::Scalar m_coalesced_stores;
 
     bool m_usingNetworkTester;
 
@@ -68,6 +68,9 @@ class RubySequencer(RubyPort):
     deadlock_threshold = Param.Cycles(500000,
         "max outstanding cycles for a request before deadlock/livelock declared")
     using_network_tester = Param.Bool(False, "")
+    coalesce_requests = Param.Bool(False,
+        "attach loads and plain stores to an outstanding request for the "
+        "same line instead of returning them for a retry")
 
 class DMASequencer(MemObject):
     type = 'DMASequencer'
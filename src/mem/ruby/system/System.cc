@@ -63,6 +63,7 @@ RubySystem::RubySystem(const Params *p)
     assert(isPowerOf2(m_block_size_bytes));
     m_block_size_bits = floorLog2(m_block_size_bytes);
     m_memory_size_bits = p->memory_size_bits;
+    m_parallel_warmup = p->parallel_warmup;
 
     m_warmup_enabled = false;
     m_cooldown_enabled = false;
@@ -159,6 +160,11 @@ RubySystem::serialize(std::ostream &os)
     SERIALIZE_SCALAR(block_size_bytes);
 
     DPRINTF(RubyCacheTrace, "Recording Cache Trace\n");
+    // The flush runs the main event queue on its own
+    if (numMainEventQueues > 1)
+        fatal("Ruby can't checkpoint its caches with more than one event "
+              "queue\n");
+
     // Create the CacheRecorder and record the cache trace
     m_cache_recorder = new CacheRecorder(NULL, 0, sequencer_map,
                                          block_size_bytes);
@@ -268,7 +274,8 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
     }
 
     m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+                                         sequencer_map, block_size_bytes,
+                                         m_parallel_warmup);
 }
 
 void
@@ -292,6 +299,10 @@ RubySystem::startup()
     // state was checkpointed.
 
     if (m_warmup_enabled) {
+        if (numMainEventQueues > 1)
+            fatal("Ruby can't warm up its caches from a checkpoint with "
+                  "more than one event queue\n");
+
         // save the current tick value
         Tick curtick_original = curTick();
         // save the event queue head
@@ -322,7 +333,7 @@ void
 RubySystem::RubyEvent::process()
 {
     if (ruby_system->m_warmup_enabled) {
-        ruby_system->m_cache_recorder->enqueueNextFetchRequest();
+        ruby_system->m_cache_recorder->startFetchRequests();
     }  else if (ruby_system->m_cooldown_enabled) {
         ruby_system->m_cache_recorder->enqueueNextFlushRequest();
     }
@@ -352,24 +363,35 @@ RubySystem::functionalRead(PacketPtr pkt)
     unsigned int num_backing_store = 0;
     unsigned int num_invalid = 0;
 
+    // The controllers holding a readable copy and the backing store,
+    // noted while counting so that they are not looked up again
+    AbstractController *readable = NULL;
+    AbstractController *backing_store = NULL;
+
     // In this loop we count the number of controllers that have the given
     // address in read only, read write and busy states.
     for (unsigned int i = 0; i < num_controllers; ++i) {
         access_perm = m_abs_cntrl_vec[i]-> getAccessPermission(line_address);
-        if (access_perm == AccessPermission_Read_Only)
-            num_ro++;
-        else if (access_perm == AccessPermission_Read_Write)
-            num_rw++;
-        else if (access_perm == AccessPermission_Busy)
+        if (access_perm == AccessPermission_Read_Only ||
+            access_perm == AccessPermission_Read_Write) {
+            if (access_perm == AccessPermission_Read_Only)
+                num_ro++;
+            else
+                num_rw++;
+            if (!readable)
+                readable = m_abs_cntrl_vec[i];
+        } else if (access_perm == AccessPermission_Busy)
             num_busy++;
-        else if (access_perm == AccessPermission_Backing_Store)
+        else if (access_perm == AccessPermission_Backing_Store) {
             // See RubySlicc_Exports.sm for details, but Backing_Store is meant
             // to represent blocks in memory *for Broadcast/Snooping protocols*,
             // where memory has no idea whether it has an exclusive copy of data
             // or not.
             num_backing_store++;
-        else if (access_perm == AccessPermission_Invalid ||
-                 access_perm == AccessPermission_NotPresent)
+            if (!backing_store)
+                backing_store = m_abs_cntrl_vec[i];
+        } else if (access_perm == AccessPermission_Invalid ||
+                   access_perm == AccessPermission_NotPresent)
             num_invalid++;
     }
     assert(num_rw <= 1);
@@ -384,13 +406,8 @@ RubySystem::functionalRead(PacketPtr pkt)
     // it only if it's not in the cache hierarchy at all.
     if (num_invalid == (num_controllers - 1) && num_backing_store == 1) {
         DPRINTF(RubySystem, "only copy in Backing_Store memory, read from it\n");
-        for (unsigned int i = 0; i < num_controllers; ++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
-            if (access_perm == AccessPermission_Backing_Store) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
-                return true;
-            }
-        }
+        backing_store->functionalRead(line_address, pkt);
+        return true;
     } else if (num_ro > 0 || num_rw == 1) {
         // In Broadcast/Snoop protocols, this covers if you know the block
         // exists somewhere in the caching hierarchy, then you want to read any
@@ -398,17 +415,9 @@ RubySystem::functionalRead(PacketPtr pkt)
         // to read any valid readable copy of the block.
         DPRINTF(RubySystem, "num_busy = %d, num_ro = %d, num_rw = %d\n",
                 num_busy, num_ro, num_rw);
-        // In this loop, we try to figure which controller has a read only or
-        // a read write copy of the given address. Any valid copy would suffice
-        // for a functional read.
-        for (unsigned int i = 0;i < num_controllers;++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
-            if (access_perm == AccessPermission_Read_Only ||
-                access_perm == AccessPermission_Read_Write) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
-                return true;
-            }
-        }
+        // Any valid copy would suffice for a functional read.
+        readable->functionalRead(line_address, pkt);
+        return true;
     }
 
     return false;
@@ -430,9 +439,15 @@ RubySystem::functionalWrite(PacketPtr pkt)
 
     uint32_t M5_VAR_USED num_functional_writes = 0;
 
+    // Most functional writes, such as those loading the program, find
+    // every message buffer empty
+    bool search_buffers = MessageBuffer::anyBuffered();
+
     for (unsigned int i = 0; i < num_controllers;++i) {
-        num_functional_writes +=
-            m_abs_cntrl_vec[i]->functionalWriteBuffers(pkt);
+        if (search_buffers) {
+            num_functional_writes +=
+                m_abs_cntrl_vec[i]->functionalWriteBuffers(pkt);
+        }
 
         access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_addr);
         if (access_perm != AccessPermission_Invalid &&
@@ -125,6 +125,7 @@ class RubySystem : public ClockedObject
     static uint32_t m_block_size_bits;
     static uint32_t m_memory_size_bits;
     SimpleMemory *m_phys_mem;
+    bool m_parallel_warmup;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
@@ -42,7 +42,9 @@
  *          Andreas Hansson
  */
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "arch/isa_traits.hh"
 #include "base/chunk_generator.hh"
@@ -56,8 +58,9 @@ using namespace TheISA;
 
 SETranslatingPortProxy::SETranslatingPortProxy(MasterPort& port, Process *p,
                                            AllocType alloc)
-    : PortProxy(port, p->system->cacheLineSize()), pTable(p->pTable),
-      process(p), allocating(alloc)
+    : PortProxy(port, p->system->cacheLineSize(), p->system),
+      pTable(p->pTable),
+      process(p), allocating(alloc), observer(NULL)
 { }
 
 SETranslatingPortProxy::~SETranslatingPortProxy()
@@ -81,6 +84,31 @@ SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
     return true;
 }
 
+uint8_t *
+SETranslatingPortProxy::hostPtr(Addr addr, int size) const
+{
+    if (size <= 0)
+        return NULL;
+
+    Addr start = 0;
+    int prevSize = 0;
+
+    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
+        Addr paddr;
+
+        if (!pTable->translate(gen.addr(), paddr))
+            return NULL;
+
+        if (prevSize == 0)
+            start = paddr;
+        else if (paddr != start + prevSize)
+            return NULL;
+        prevSize += gen.size();
+    }
+
+    return directPtr(start, size);
+}
+
 void
 SETranslatingPortProxy::readBlob(Addr addr, uint8_t *p, int size) const
 {
@@ -114,6 +142,7 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
         }
 
         PortProxy::writeBlob(paddr, p + prevSize, gen.size());
+        notifyWrite(gen.addr(), p + prevSize, gen.size());
         prevSize += gen.size();
     }
 
@@ -145,6 +174,10 @@ SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t val, int size) const
         }
 
         PortProxy::memsetBlob(paddr, val, gen.size());
+        if (observer) {
+            std::vector<uint8_t> bytes(gen.size(), val);
+            notifyWrite(gen.addr(), &bytes[0], gen.size());
+        }
     }
 
     return true;
@@ -161,19 +194,19 @@ SETranslatingPortProxy::memsetBlob(Addr addr, uint8_t val, int size) const
 bool
 SETranslatingPortProxy::tryWriteString(Addr addr, const char *str) const
 {
-    uint8_t c;
-
-    Addr vaddr = addr;
+    const uint8_t *p = (const uint8_t *)str;
+    int size = std::strlen(str) + 1;
 
-    do {
-        c = *str++;
+    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(vaddr++, paddr))
+        if (!pTable->translate(gen.addr(), paddr))
             return false;
 
-        PortProxy::writeBlob(paddr, &c, 1);
-    } while (c);
+        PortProxy::writeBlob(paddr, p, gen.size());
+        notifyWrite(gen.addr(), p, gen.size());
+        p += gen.size();
+    }
 
     return true;
 }
@@ -188,21 +221,30 @@ SETranslatingPortProxy::writeString(Addr addr, const char *str) const
 bool
 SETranslatingPortProxy::tryReadString(std::string &str, Addr addr) const
 {
-    uint8_t c;
+    // read aligned chunks, which never cross a page, as the string
+    // may end right before a page that isn't mapped
+    uint8_t buf[64];
+    const int chunk_size = sizeof(buf);
 
     Addr vaddr = addr;
 
     while (true) {
         Addr paddr;
 
-        if (!pTable->translate(vaddr++, paddr))
+        if (!pTable->translate(vaddr, paddr))
             return false;
 
-        PortProxy::readBlob(paddr, &c, 1);
-        if (c == '\0')
+        int size = chunk_size - (vaddr & (chunk_size - 1));
+        PortProxy::readBlob(paddr, buf, size);
+
+        const uint8_t *end = (const uint8_t *)std::memchr(buf, '\0', size);
+        if (end) {
+            str.append((const char *)buf, end - buf);
             break;
+        }
 
-        str += c;
+        str.append((const char *)buf, size);
+        vaddr += size;
     }
 
     return true;
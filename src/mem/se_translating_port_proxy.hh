@@ -74,21 +74,58 @@ class SETranslatingPortProxy : public PortProxy
         NextPage
     };
 
+    /** Told of every write made to memory through a proxy */
+    class WriteObserver
+    {
+      public:
+        virtual ~WriteObserver() { }
+
+        /** size bytes from p have been written to virtual address addr */
+        virtual void proxyWrite(Addr addr, const uint8_t *p, int size) = 0;
+    };
+
   private:
     PageTableBase *pTable;
     Process *process;
     AllocType allocating;
+    WriteObserver *observer;
 
   public:
     SETranslatingPortProxy(MasterPort& port, Process* p, AllocType alloc);
     virtual ~SETranslatingPortProxy();
 
+    /** Tell observer of all writes from now on, NULL for none */
+    void setWriteObserver(WriteObserver *_observer) { observer = _observer; }
+
+    /**
+     * Tell the observer of a write made without the proxy, through a
+     * pointer from hostPtr().
+     */
+    void
+    notifyWrite(Addr addr, const uint8_t *p, int size) const
+    {
+        if (observer)
+            observer->proxyWrite(addr, p, size);
+    }
+
     bool tryReadBlob(Addr addr, uint8_t *p, int size) const;
     bool tryWriteBlob(Addr addr, const uint8_t *p, int size) const;
     bool tryMemsetBlob(Addr addr, uint8_t val, int size) const;
     bool tryWriteString(Addr addr, const char *str) const;
     bool tryReadString(std::string &str, Addr addr) const;
 
+    /**
+     * Get a host pointer to a range of virtual addresses, if every
+     * page of it is mapped, the pages are physically contiguous, and
+     * the memory can be accessed without going through the memory
+     * system.
+     *
+     * @param addr A virtual address
+     * @param size Size of the range in bytes
+     * @return Pointer into the backing store, or NULL
+     */
+    uint8_t *hostPtr(Addr addr, int size) const;
+
     virtual void readBlob(Addr addr, uint8_t *p, int size) const;
     virtual void writeBlob(Addr addr, const uint8_t *p, int size) const;
     virtual void memsetBlob(Addr addr, uint8_t val, int size) const;
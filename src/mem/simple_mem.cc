@@ -271,6 +271,15 @@ SimpleMemory::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+bool
+SimpleMemory::MemoryPort::recvBackdoorReq(Addr addr, MemBackdoor &backdoor)
+{
+    if (!memory.getBackdoor(backdoor))
+        return false;
+    backdoor.latency = memory.latency;
+    return true;
+}
+
 void
 SimpleMemory::MemoryPort::recvFunctional(PacketPtr pkt)
 {
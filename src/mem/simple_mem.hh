@@ -97,6 +97,8 @@ class SimpleMemory : public AbstractMemory
 
         Tick recvAtomic(PacketPtr pkt);
 
+        bool recvBackdoorReq(Addr addr, MemBackdoor &backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         bool recvTimingReq(PacketPtr pkt);
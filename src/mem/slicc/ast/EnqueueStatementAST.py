@@ -55,7 +55,7 @@ class EnqueueStatementAST(StatementAST):
 
         # Declare message
         code("std::shared_ptr<${{msg_type.ident}}> out_msg = "\
-             "std::make_shared<${{msg_type.ident}}>(clockEdge());")
+             "makeMessage<${{msg_type.ident}}>(clockEdge());")
 
         # The other statements
         t = self.statements.generate(code, None)
@@ -142,7 +142,7 @@ class FuncCallExprAST(ExprAST):
     }
 
     if (result == TransitionResult_ResourceStall) {
-        scheduleEvent(Cycles(1));
+        scheduleResourceRetry();
 
         // Cannot do anything with this transition, go check next doable transition (mostly likely of next port)
     }
@@ -38,13 +38,18 @@ import slicc.util as util
 from slicc.symbols import SymbolTable
 
 class SLICC(Grammar):
-    def __init__(self, filename, base_dir, verbose=False, traceback=False, **kwargs):
+    def __init__(self, filename, base_dir, verbose=False, traceback=False,
+                 transition_profile=None, **kwargs):
         self.protocol = None
         self.traceback = traceback
         self.verbose = verbose
         self.symtab = SymbolTable(self)
         self.base_dir = base_dir
 
+        self.transition_counts = {}
+        if transition_profile:
+            self.readTransitionProfile(transition_profile)
+
         try:
             self.decl_list = self.parse_file(filename, **kwargs)
         except ParseError, e:
@@ -52,6 +57,26 @@ class SLICC(Grammar):
                 sys.exit(str(e))
             raise
 
+    def readTransitionProfile(self, filename):
+        '''Sum up the transition counts of a gem5 stats file, given by
+        the lines <ruby>.<Machine>_Controller.<State>.<Event>[::total]'''
+        stat = re.compile(r'\.(\w+)_Controller\.(\w+)\.(\w+)'
+                          r'(::total)?\s+(\S+)')
+        for line in open(filename):
+            m = stat.search(line)
+            if not m:
+                continue
+
+            # skips the per-controller oneline entries, "| <count> ..."
+            try:
+                total = int(float(m.group(5)))
+            except ValueError:
+                continue
+
+            counts = self.transition_counts.setdefault(m.group(1), {})
+            key = (m.group(2), m.group(3))
+            counts[key] = counts.get(key, 0) + total
+
     def currentLocation(self):
         return util.Location(self.current_source, self.current_line,
                              no_warning=not self.verbose)
@@ -41,7 +41,6 @@ python_class_map = {
                     "WireBuffer": "RubyWireBuffer",
                     "Sequencer": "RubySequencer",
                     "DirectoryMemory": "RubyDirectoryMemory",
-                    "MemoryControl": "MemoryControl",
                     "DMASequencer": "DMASequencer",
                     "Prefetcher":"Prefetcher",
                     "Cycles":"Cycles",
@@ -284,6 +283,7 @@ class $c_ident : public AbstractController
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
     Sequencer* getSequencer() const;
+    void scheduleResourceRetry();
 
     int functionalWriteBuffers(PacketPtr&);
 
@@ -922,6 +922,29 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
+void
+$c_ident::scheduleResourceRetry()
+{
+    // A transition has just stalled on a resource.  If that was a busy
+    // cache bank, retry when it frees up; for other resources, such as
+    // a full message buffer, there is no such time and we poll.
+    Tick retry = clockEdge(Cycles(1));
+    Tick bank_free = 0;
+''')
+        code.indent()
+        for param in self.config_parameters:
+            if param.type_ast.type.ident == "CacheMemory":
+                code('''
+if (Tick t = m_${{param.ident}}_ptr->takeResourceFreeTick())
+    bank_free = bank_free ? std::min(bank_free, t) : t;
+''')
+        code.dedent()
+        code('''
+    if (bank_free > retry)
+        retry = clockEdge(ticksToCycles(bank_free - curTick()));
+    scheduleEventAbsolute(retry);
+}
+
 // Actions
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1100,11 +1123,101 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
+    def transitionBlocks(self):
+        '''Group the transitions by the code they run.  Returns a list of
+        (code, transitions) pairs, hottest first if the protocol was built
+        with a transition profile.'''
+
+        ident = self.ident
+
+        # This map will allow suppress generating duplicate code
+        cases = orderdict()
+
+        for trans in self.transitions:
+            # the next state comes from the transition table
+            case = self.symtab.codeFormatter()
+
+            actions = trans.actions
+            request_types = trans.request_types
+
+            # Check for resources
+            case_sorter = []
+            res = trans.resources
+            for key,val in res.iteritems():
+                val = '''
+if (!%s.areNSlotsAvailable(%s))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val)
+                case_sorter.append(val)
+
+            # Check all of the request_types for resource constraints
+            for request_type in request_types:
+                val = '''
+if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    return TransitionResult_ResourceStall;
+}
+''' % (self.ident, request_type.ident)
+                case_sorter.append(val)
+
+            # Emit the code sequences in a sorted order.  This makes the
+            # output deterministic (without this the output order can vary
+            # since Map's keys() on a vector of pointers is not deterministic
+            for c in sorted(case_sorter):
+                case("$c")
+
+            # Record access types for this transition
+            for request_type in request_types:
+                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+
+            # Figure out if we stall
+            stall = False
+            for action in actions:
+                if action.ident == "z_stall":
+                    stall = True
+                    break
+
+            if stall:
+                case('return TransitionResult_ProtocolStall;')
+            else:
+                if self.TBEType != None and self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
+                elif self.TBEType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, addr);')
+                elif self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
+                else:
+                    for action in actions:
+                        case('${{action.ident}}(addr);')
+                case('return TransitionResult_Valid;')
+
+            case = str(case)
+
+            # Look to see if this transition code is unique.
+            if case not in cases:
+                cases[case] = []
+
+            cases[case].append(trans)
+
+        blocks = list(cases.iteritems())
+        counts = self.symtab.slicc.transition_counts.get(ident)
+        if counts:
+            def weight(block):
+                return sum(counts.get((t.state.ident, t.event.ident), 0)
+                           for t in block[1])
+            # a stable sort, unprofiled blocks keep their order
+            blocks.sort(key=weight, reverse=True)
+
+        return blocks
+
     def printCSwitch(self, path):
         '''Output switch statement for transition table'''
 
         code = self.symtab.codeFormatter()
         ident = self.ident
+        blocks = self.transitionBlocks()
 
         code('''
 // Auto generated C++ code started by $__file__:$__line__
@@ -1128,6 +1241,41 @@ ${ident}_Controller::wakeup()
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
 
+namespace {
+
+// The code block and next state of each (state, event) pair, indexed by
+// HASH_FUN(state, event)
+struct TransitionEntry
+{
+    uint16_t block;
+    ${ident}_State next_state;
+};
+
+const uint16_t NoTransition = ${{len(blocks)}};
+
+const TransitionEntry transitionTable[] = {
+''')
+        code.indent()
+        block_of = {}
+        for i,(case,transitions) in enumerate(blocks):
+            for trans in transitions:
+                block_of[trans.state, trans.event] = (i, trans.nextState)
+        for state in self.states.itervalues():
+            for event in self.events.itervalues():
+                block, next_state = block_of.get((state, event),
+                                                 ('NoTransition', state))
+                code('{ $block, ${ident}_State_${{next_state.ident}} }, '
+                     '// ${{state.ident}}, ${{event.ident}}')
+        code.dedent()
+        code('''
+};
+
+static_assert(sizeof(transitionTable) / sizeof(transitionTable[0]) ==
+              ${ident}_State_NUM * ${ident}_Event_NUM,
+              "the transition table must cover every state and event");
+
+} // anonymous namespace
+
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
 ''')
@@ -1242,93 +1390,15 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         const Address& addr)
 {
-    switch(HASH_FUN(state, event)) {
-''')
-
-        # This map will allow suppress generating duplicate code
-        cases = orderdict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                ns_ident = trans.nextState.ident
-                case('next_state = ${ident}_State_${ns_ident};')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.iteritems():
-                val = '''
-if (!%s.areNSlotsAvailable(%s))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
-
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
-}
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
-
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+    const TransitionEntry &trans = transitionTable[HASH_FUN(state, event)];
+    next_state = trans.next_state;
 
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
-
-            case = str(case)
-
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
-
-            cases[case].append(case_string)
+    switch (trans.block) {
+''')
 
-        # Walk through all of the unique code blocks and spit out the
-        # corresponding case statement elements
-        for case,transitions in cases.iteritems():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
+        # The table maps every transition to its code block
+        for i,(case,transitions) in enumerate(blocks):
+            code('  case $i:')
             code('    $case\n')
 
         code('''
@@ -208,6 +208,11 @@ class Type(Symbol):
             code('#include "mem/protocol/$0.hh"', self["interface"])
             parent = " :  public %s" % self["interface"]
 
+        # Directory entries come from the pool, see below
+        is_dir_entry = self.get("interface") == "AbstractEntry"
+        if is_dir_entry:
+            code('#include "sim/event_pool.hh"')
+
         code('''
 $klass ${{self.c_ident}}$parent
 {
@@ -288,7 +293,20 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return makeMessage<${{self.c_ident}}>(*this);
+}
+''')
+            # Network fault injection corrupts the data block of a
+            # message under way
+            data = self.data_members.get("DataBlk")
+            if data and data.type.c_ident == "DataBlock":
+                code('''
+bool
+flipDataBit(unsigned int bit)
+{
+    m_DataBlk.setByte(bit / 8,
+                      m_DataBlk.getByte(bit / 8) ^ (1 << (bit % 8)));
+    return true;
 }
 ''')
         else:
@@ -298,6 +316,26 @@ clone() const
 {
      return new ${{self.c_ident}}(*this);
 }
+''')
+
+        if is_dir_entry:
+            code('''
+/**
+ * One directory entry is allocated per touched block and lives as long
+ * as the directory, so entries are carved from the EventPool slabs
+ * instead of carrying a heap allocation each.
+ */
+static void *
+operator new(size_t size)
+{
+    return EventPool::allocate(size);
+}
+
+static void
+operator delete(void *p, size_t size)
+{
+    EventPool::release(p, size);
+}
 ''')
 
         if not self.isGlobal:
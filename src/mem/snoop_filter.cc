@@ -48,6 +48,33 @@
 #include "mem/snoop_filter.hh"
 #include "sim/system.hh"
 
+SnoopFilter::SnoopItem &
+SnoopFilter::lookup(Addr line, bool &is_hit)
+{
+    std::pair<SnoopItem *, bool> res = table.insert(line);
+    is_hit = !res.second;
+
+    if (!is_hit && maxEntryCount && table.size() > maxEntryCount)
+        warn_once("%s: tracking more lines than max_capacity allows\n",
+                  name());
+    return *res.first;
+}
+
+void
+SnoopFilter::release(Addr line)
+{
+    const SnoopItem *item = table.find(line);
+    if (item && !item->requested && !item->holder)
+        table.erase(line);
+}
+
+bool
+SnoopFilter::isCached(Addr addr) const
+{
+    const SnoopItem *item = table.find(addr & ~Addr(linesize - 1));
+    return item && (item->holder || item->requested);
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
@@ -56,10 +83,8 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask req_port = portToMask(slave_port);
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
-    // Create a new element through operator[] and modify in-place
-    SnoopItem& sf_item = is_hit ? sf_it->second : cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     totRequests++;
@@ -94,6 +119,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__,  sf_item.requested, sf_item.holder);
     }
+    release(line_addr);
     return snoopSelected(maskToPortList(interested & ~req_port), lookupLatency);
 }
 
@@ -106,7 +132,8 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask req_port = portToMask(slave_port);
-    SnoopItem& sf_item  = cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x retry: %i\n",
             __func__, sf_item.requested, sf_item.holder, will_retry);
@@ -114,6 +141,7 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
     if (will_retry) {
         // Unmark a request that will come again.
         sf_item.requested &= ~req_port;
+        release(line_addr);
         return;
     }
 
@@ -136,6 +164,7 @@ SnoopFilter::updateRequest(const Packet* cpkt, const SlavePort& slave_port,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__,  sf_item.requested, sf_item.holder);
     }
+    release(line_addr);
 }
 
 std::pair<SnoopFilter::SnoopList, Cycles>
@@ -153,10 +182,8 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         return snoopAll(lookupLatency);
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
-    // Create a new element through operator[] and modify in-place
-    SnoopItem& sf_item = is_hit ? sf_it->second : cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
@@ -183,6 +210,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x interest: %x \n",
             __func__, sf_item.requested, sf_item.holder, interested);
 
+    release(line_addr);
     return snoopSelected(maskToPortList(interested), lookupLatency);
 }
 
@@ -198,7 +226,8 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
 
     assert(cpkt->isResponse());
     assert(cpkt->memInhibitAsserted());
@@ -232,6 +261,7 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     sf_item.requested &= ~req_mask;
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    release(line_addr);
 }
 
 void
@@ -243,7 +273,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
             cpkt->cmdString());
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
     SnoopMask rsp_mask M5_VAR_USED = portToMask(rsp_port);
 
     assert(cpkt->isResponse());
@@ -262,6 +293,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    release(line_addr);
 }
 
 void
@@ -272,7 +304,8 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
 
     Addr line_addr = cpkt->getAddr() & ~(linesize - 1);
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    bool is_hit;
+    SnoopItem& sf_item = lookup(line_addr, is_hit);
 
     assert(cpkt->isResponse());
 
@@ -290,6 +323,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
     sf_item.requested &= ~slave_mask;
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    release(line_addr);
 }
 
 void
@@ -46,8 +46,10 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <utility>
+#include <vector>
 
-#include "base/hashmap.hh"
+#include "base/intmath.hh"
+#include "base/open_hash_map.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "params/SnoopFilter.hh"
@@ -88,7 +90,10 @@ class SnoopFilter : public SimObject {
     typedef std::vector<SlavePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams *p) : SimObject(p),
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency)
+        table(InitialEntries, MaxLoad),
+        linesize(p->system->cacheLineSize()),
+        maxEntryCount(p->max_capacity / linesize),
+        lookupLatency(p->lookup_latency)
     {
     }
 
@@ -99,6 +104,9 @@ class SnoopFilter : public SimObject {
      * @param bus_slave_ports Vector of slave ports that the bus is attached to.
      */
     void setSlavePorts(const std::vector<SlavePort*>& bus_slave_ports) {
+        fatal_if(bus_slave_ports.size() > 8 * sizeof(SnoopMask),
+                 "%s: a snoop filter tracks at most %d ports\n", name(),
+                 8 * sizeof(SnoopMask));
         slavePorts = bus_slave_ports;
     }
 
@@ -170,6 +178,13 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const SlavePort& slave_port);
 
+    /**
+     * Is the line containing addr held or requested by a cache above
+     * the filter? Lets a DMA engine find the lines of a transfer that
+     * must be sent, and snooped, one by one rather than in a burst.
+     */
+    bool isCached(Addr addr) const;
+
     /**
      * Simple factory methods for standard return values for lookupRequest
      */
@@ -190,6 +205,12 @@ class SnoopFilter : public SimObject {
 
     virtual void regStats();
 
+    /** The table of tracked lines. */
+    virtual uint64_t hostMemUsage() const
+    {
+        return table.hostMemUsage();
+    }
+
   protected:
     typedef uint64_t SnoopMask;
    /**
@@ -221,12 +242,44 @@ class SnoopFilter : public SimObject {
     SnoopList maskToPortList(SnoopMask ports) const;
 
   private:
-    /** Simple hash set of cached addresses. */
-    m5::hash_map<Addr, SnoopItem> cachedLocations;
+    /** Lines the table holds before it first grows. */
+    static const size_t InitialEntries = 768;
+    /** Percentage of the table slots that may be used. */
+    static const unsigned MaxLoad = 75;
+
+    /**
+     * Find the entry of a line, adding one with no holders and no
+     * requests if it is not tracked yet.  References stay valid until
+     * the next call of lookup() or release().
+     *
+     * @param line   Line address.
+     * @param is_hit Set to whether the line was already tracked.
+     * @return The entry of the line.
+     */
+    SnoopItem &lookup(Addr line, bool &is_hit);
+
+    /**
+     * Stop tracking a line if nothing holds or requests it any more,
+     * so the table only holds live lines.
+     *
+     * @param line Line address.
+     */
+    void release(Addr line);
+
+    /**
+     * Tracked lines by line address.  The load is kept below 3/4 so
+     * that probes stay short.
+     */
+    OpenHashMap<Addr, SnoopItem> table;
     /** List of all attached slave ports. */
     SnoopList slavePorts;
     /** Cache line size. */
     const unsigned linesize;
+    /**
+     * Lines the filter can track, from the capacity of the caches
+     * above it; tracking more is reported once.
+     */
+    const size_t maxEntryCount;
     /** Latency for doing a lookup in the filter */
     const Cycles lookupLatency;
 
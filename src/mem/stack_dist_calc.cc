@@ -37,6 +37,8 @@
  * Authors: Kanishk Sugand
  */
 
+#include <limits>
+
 #include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/StackDist.hh"
@@ -44,9 +46,14 @@
 
 StackDistCalc::StackDistCalc(const StackDistCalcParams* p) :
     SimObject(p), index(0), verifyStack(p->verify),
+    sampleRatio(p->sample_ratio), sampleThreshold(0),
     disableLinearHists(p->disable_linear_hists),
     disableLogHists(p->disable_log_hists)
 {
+    fatal_if(sampleRatio == 0, "%s: sample_ratio must be at least 1\n",
+             name());
+    sampleThreshold = std::numeric_limits<uint64_t>::max() / sampleRatio;
+
     // Instantiate a new root and leaf layer
     // Map type variable, representing a layer in the tree
     IndexNodeMap tree_level;
@@ -97,11 +104,18 @@ StackDistCalc::update(const MemCmd& cmd, Addr addr)
     // only capturing read and write requests (which allocate in the
     // cache)
     if (cmd.isRead() || cmd.isWrite()) {
+        if (sampleRatio != 1 && !sampled(addr))
+            return;
+
         auto returnType = calcStackDistAndUpdate(addr);
 
         uint64_t stackDist = returnType.first;
 
         if (stackDist != Infinity) {
+            // Scale the distance among the tracked addresses up to
+            // one among all addresses
+            stackDist *= sampleRatio;
+
             // Sample the stack distance of the address in linear bins
             if (!disableLinearHists) {
                 if (cmd.isRead())
@@ -123,6 +137,21 @@ StackDistCalc::update(const MemCmd& cmd, Addr addr)
     }
 }
 
+bool
+StackDistCalc::sampled(Addr addr) const
+{
+    // Mix all the address bits into the top ones (the 64-bit
+    // finalizer of MurmurHash3), so neighbouring addresses land in
+    // unrelated parts of the hash space
+    uint64_t h = addr;
+    h ^= h >> 33;
+    h *= ULL(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= ULL(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h < sampleThreshold;
+}
+
 // The updateSum method is a recursive function which updates
 // the node sums till the root. It also deletes the nodes that
 // are not used anymore.
@@ -173,6 +173,15 @@
   *
   * A printStack(int numOfEntitiesToPrint) is provided to print top n entities
   * in both (tree and STL based dummy stack).
+  *
+  * Sampling: With a sample ratio N above 1, the calculator follows
+  * the SHARDS approach of Waldspurger et al.
+  * (https://www.usenix.org/node/188446). An address is only tracked
+  * if its hash falls below 1/N of the hash space, so every access to
+  * a tracked address is seen and all others are ignored. The stack
+  * distances measured among the tracked addresses are multiplied by
+  * N to estimate the full distances. This cuts the work per access,
+  * and the size of the tree, by about N.
   */
 class StackDistCalc : public SimObject
 {
@@ -431,6 +440,20 @@ class StackDistCalc : public SimObject
     // Flag to enable verification of stack. (Slows down the simulation)
     const bool verifyStack;
 
+    // Track one in sampleRatio addresses
+    const uint64_t sampleRatio;
+
+    // Addresses whose hash is below this are tracked
+    uint64_t sampleThreshold;
+
+    /**
+     * Determine if an address is tracked when sampling.
+     *
+     * @param addr The address to check
+     * @return true if the address is part of the sample
+     */
+    bool sampled(Addr addr) const;
+
     // Disable the linear histograms
     const bool disableLinearHists;
 
@@ -318,15 +318,27 @@ BaseXBar::findPort(Addr addr)
     assert(gotAllAddrRanges);
 
     // Check the cache
-    PortID dest_id = checkPortCache(addr);
+    PortID dest_id = checkRouteCache(addr);
     if (dest_id != InvalidPortID)
         return dest_id;
 
+    // Check the interleaved chunks, selecting the stripe from the
+    // address bits
+    for (const auto& m: intlvMaps) {
+        if (addr >= m.range.start() && addr <= m.range.end()) {
+            dest_id = m.ports[m.range.intlvSelect(addr)];
+            if (dest_id != InvalidPortID) {
+                updateRouteCache(addr, dest_id);
+                return dest_id;
+            }
+        }
+    }
+
     // Check the address map interval tree
     auto i = portMap.find(addr);
     if (i != portMap.end()) {
         dest_id = i->second;
-        updatePortCache(dest_id, i->first);
+        updateRouteCache(addr, dest_id);
         return dest_id;
     }
 
@@ -335,11 +347,13 @@ BaseXBar::findPort(Addr addr)
         if (defaultRange.contains(addr)) {
             DPRINTF(AddrRanges, "  found addr %#llx on default\n",
                     addr);
+            updateRouteCache(addr, defaultPortID);
             return defaultPortID;
         }
     } else if (defaultPortID != InvalidPortID) {
         DPRINTF(AddrRanges, "Unable to find destination for addr %#llx, "
                 "will use default port\n", addr);
+        updateRouteCache(addr, defaultPortID);
         return defaultPortID;
     }
 
@@ -502,13 +516,62 @@ BaseXBar::recvRangeChange(PortID master_port_id)
             }
         }
 
+        buildInterleaveMaps();
+
         // tell all our neighbouring master ports that our address
         // ranges have changed
         for (const auto& s: slavePorts)
             s->sendRangeChange();
     }
 
-    clearPortCache();
+    clearRouteCache();
+}
+
+void
+BaseXBar::clearRouteCache()
+{
+    for (auto& entry: routeCache)
+        entry.id = InvalidPortID;
+
+    // a block must not straddle the boundary of any range or stripe
+    routeBlockBits = maxRouteBlockBits;
+    auto align = [this](Addr boundary) {
+        routeBlockBits = std::min<unsigned>(routeBlockBits,
+                                            findLsbSet(boundary));
+    };
+
+    for (const auto& r: portMap) {
+        align(r.first.start());
+        align(r.first.end() + 1);
+        if (r.first.interleaved())
+            align(r.first.stripeGranularity());
+    }
+
+    if (useDefaultRange) {
+        align(defaultRange.start());
+        align(defaultRange.end() + 1);
+    }
+}
+
+void
+BaseXBar::buildInterleaveMaps()
+{
+    intlvMaps.clear();
+
+    // the stripes of a chunk are adjacent in the port map, so start
+    // a new chunk whenever a stripe does not merge with the last one
+    for (const auto& r: portMap) {
+        if (!r.first.interleaved())
+            continue;
+
+        if (intlvMaps.empty() || !intlvMaps.back().range.mergesWith(r.first)) {
+            intlvMaps.push_back(InterleaveMap());
+            intlvMaps.back().range = r.first;
+            intlvMaps.back().ports.assign(r.first.stripes(), InvalidPortID);
+        }
+
+        intlvMaps.back().ports[r.first.intlvMatchValue()] = r.second;
+    }
 }
 
 AddrRangeList
@@ -248,6 +248,24 @@ class BaseXBar : public MemObject
 
     AddrRangeMap<PortID> portMap;
 
+    /**
+     * A chunk of memory interleaved across ports, e.g. the channels
+     * of a multi-channel memory, with the port serving each
+     * interleaving value. Rebuilt from the port map whenever the
+     * ranges change, and used by findPort to pick the port from the
+     * interleaving bits directly instead of walking every stripe in
+     * the interval tree.
+     */
+    struct InterleaveMap {
+        AddrRange range;
+        std::vector<PortID> ports;
+    };
+
+    std::vector<InterleaveMap> intlvMaps;
+
+    /** Rebuild intlvMaps from portMap */
+    void buildInterleaveMaps();
+
     /**
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
@@ -277,53 +295,54 @@ class BaseXBar : public MemObject
      */
     PortID findPort(Addr addr);
 
-    // Cache for the findPort function storing recently used ports from portMap
-    struct PortCache {
-        bool valid;
+    /** Forward a backdoor request to the port responsible for addr */
+    bool forwardBackdoorReq(Addr addr, MemBackdoor &backdoor)
+    { return masterPorts[findPort(addr)]->sendBackdoorReq(addr, backdoor); }
+
+    /**
+     * Direct-mapped cache of routing decisions, indexed by address
+     * block. Blocks are small enough that no range boundary or
+     * interleaving stripe boundary falls inside one, so every address
+     * in a block goes to the same port.
+     */
+    struct RouteEntry {
+        Addr block;
         PortID id;
-        AddrRange range;
     };
 
-    PortCache portCache[3];
-
-    // Checks the cache and returns the id of the port that has the requested
-    // address within its range
-    inline PortID checkPortCache(Addr addr) const {
-        if (portCache[0].valid && portCache[0].range.contains(addr)) {
-            return portCache[0].id;
-        }
-        if (portCache[1].valid && portCache[1].range.contains(addr)) {
-            return portCache[1].id;
-        }
-        if (portCache[2].valid && portCache[2].range.contains(addr)) {
-            return portCache[2].id;
-        }
-
-        return InvalidPortID;
-    }
+    static const unsigned routeCacheSize = 64;
 
-    // Clears the earliest entry of the cache and inserts a new port entry
-    inline void updatePortCache(short id, const AddrRange& range) {
-        portCache[2].valid = portCache[1].valid;
-        portCache[2].id    = portCache[1].id;
-        portCache[2].range = portCache[1].range;
+    /** Largest route cache block, as log2 of its size in bytes */
+    static const unsigned maxRouteBlockBits = 12;
 
-        portCache[1].valid = portCache[0].valid;
-        portCache[1].id    = portCache[0].id;
-        portCache[1].range = portCache[0].range;
+    RouteEntry routeCache[routeCacheSize];
 
-        portCache[0].valid = true;
-        portCache[0].id    = id;
-        portCache[0].range = range;
+    /** Log2 of the route cache block size */
+    unsigned routeBlockBits;
+
+    /** The port addr was last routed to, or InvalidPortID */
+    PortID checkRouteCache(Addr addr) const
+    {
+        Addr block = addr >> routeBlockBits;
+        const RouteEntry &entry = routeCache[block % routeCacheSize];
+        return entry.block == block ? entry.id : InvalidPortID;
     }
 
-    // Clears the cache. Needs to be called in constructor.
-    inline void clearPortCache() {
-        portCache[2].valid = false;
-        portCache[1].valid = false;
-        portCache[0].valid = false;
+    /** Remember that addr is routed to port id */
+    void updateRouteCache(Addr addr, PortID id)
+    {
+        Addr block = addr >> routeBlockBits;
+        RouteEntry &entry = routeCache[block % routeCacheSize];
+        entry.block = block;
+        entry.id = id;
     }
 
+    /**
+     * Clear the route cache and pick its block size for the current
+     * ranges. Needs to be called in constructor.
+     */
+    void clearRouteCache();
+
     /**
      * Return the address ranges the crossbar is responsible for.
      *
@@ -43,9 +43,11 @@
 using namespace std;
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const string& filename) :
+ProtoOutputStream::ProtoOutputStream(const string& filename,
+                                     bool background) :
     fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL),
+    background(background), stopping(false)
 {
     if (!fileStream.good())
         panic("Could not open %s for writing\n", filename);
@@ -68,10 +70,29 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
 
     // Note that each type of stream (packet, instruction etc) should
     // add its own header and perform the appropriate checks
+
+    // From here on only the writer touches the zero-copy stream
+    if (background) {
+        batch.reserve(batchBytes);
+        writer = thread(&ProtoOutputStream::writeLoop, this);
+    }
 }
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    // Let the writer drain the queue before the streams go
+    if (background) {
+        if (!batch.empty())
+            handOff();
+
+        {
+            lock_guard<mutex> held(lock);
+            stopping = true;
+        }
+        queued.notify_one();
+        writer.join();
+    }
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL)
         delete gzipStream;
@@ -82,6 +103,21 @@ ProtoOutputStream::~ProtoOutputStream()
 void
 ProtoOutputStream::write(const Message& msg)
 {
+    if (background) {
+        // Serialise into the batch, and leave the compression and
+        // file output to the writer
+        {
+            io::StringOutputStream batchStream(&batch);
+            io::CodedOutputStream codedStream(&batchStream);
+            codedStream.WriteVarint32(msg.ByteSize());
+            msg.SerializeWithCachedSizes(&codedStream);
+        }
+
+        if (batch.size() >= batchBytes)
+            handOff();
+        return;
+    }
+
     // Due to the byte limit of the coded stream we create it for
     // every single mesage (based on forum discussions around the size
     // limitation)
@@ -94,10 +130,53 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
-ProtoInputStream::ProtoInputStream(const string& filename) :
+void
+ProtoOutputStream::handOff()
+{
+    unique_lock<mutex> held(lock);
+    dequeued.wait(held, [this] { return queue.size() < maxQueued; });
+
+    queue.push_back(string());
+    queue.back().swap(batch);
+    batch.reserve(batchBytes);
+
+    held.unlock();
+    queued.notify_one();
+}
+
+void
+ProtoOutputStream::writeLoop()
+{
+    unique_lock<mutex> held(lock);
+
+    while (true) {
+        queued.wait(held, [this] { return stopping || !queue.empty(); });
+
+        if (queue.empty())
+            return;
+
+        string data;
+        data.swap(queue.front());
+        queue.pop_front();
+        dequeued.notify_one();
+
+        // Compress and write without holding up the producer
+        held.unlock();
+        {
+            io::CodedOutputStream codedStream(zeroCopyStream);
+            codedStream.WriteRaw(data.data(), data.size());
+        }
+        held.lock();
+    }
+}
+
+ProtoInputStream::ProtoInputStream(const string& filename,
+                                   bool background) :
     fileStream(filename.c_str(), ios::in | ios::binary), fileName(filename),
     useGzip(false),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL),
+    background(background), exhausted(false), stopping(false),
+    readAhead(*this)
 {
     if (!fileStream.good())
         panic("Could not open %s for reading\n", filename);
@@ -112,6 +191,7 @@ ProtoInputStream::ProtoInputStream(const string& filename) :
     fileStream.seekg(0, ifstream::beg);
 
     createStreams();
+    startReader();
 }
 
 void
@@ -157,6 +237,7 @@ ProtoInputStream::destroyStreams()
 
 ProtoInputStream::~ProtoInputStream()
 {
+    stopReader();
     destroyStreams();
     fileStream.close();
 }
@@ -165,11 +246,133 @@ ProtoInputStream::~ProtoInputStream()
 void
 ProtoInputStream::reset()
 {
+    stopReader();
     destroyStreams();
     // seek to the start of the input file and clear any flags
     fileStream.clear();
     fileStream.seekg(0, ifstream::beg);
     createStreams();
+    startReader();
+}
+
+void
+ProtoInputStream::startReader()
+{
+    if (!background)
+        return;
+
+    // The magic number has been checked by now, and from here on
+    // only the reader touches the file streams
+    exhausted = false;
+    stopping = false;
+    reader = thread(&ProtoInputStream::readLoop, this);
+}
+
+void
+ProtoInputStream::stopReader()
+{
+    if (!background)
+        return;
+
+    {
+        lock_guard<mutex> held(lock);
+        stopping = true;
+    }
+    dequeued.notify_one();
+    reader.join();
+
+    queue.clear();
+    readAhead.clear();
+}
+
+void
+ProtoInputStream::readLoop()
+{
+    string chunk;
+    chunk.reserve(chunkBytes);
+    bool done = false;
+
+    while (!done) {
+        // Decompress outside the lock, the caller is parsing in the
+        // meantime
+        const void* data;
+        int size;
+        while (chunk.size() < chunkBytes) {
+            if (!zeroCopyStream->Next(&data, &size)) {
+                done = true;
+                break;
+            }
+            chunk.append(static_cast<const char*>(data), size);
+        }
+
+        unique_lock<mutex> held(lock);
+        dequeued.wait(held, [this] {
+                return stopping || queue.size() < maxQueued; });
+
+        if (stopping)
+            return;
+
+        if (!chunk.empty()) {
+            queue.push_back(string());
+            queue.back().swap(chunk);
+            chunk.reserve(chunkBytes);
+        }
+        exhausted = done;
+
+        held.unlock();
+        queued.notify_one();
+    }
+}
+
+bool
+ProtoInputStream::ReadAhead::Next(const void** data, int* size)
+{
+    if (position == chunk.size()) {
+        unique_lock<mutex> held(owner.lock);
+        owner.queued.wait(held, [this] {
+                return owner.exhausted || !owner.queue.empty(); });
+
+        if (owner.queue.empty())
+            return false;
+
+        chunk.swap(owner.queue.front());
+        owner.queue.pop_front();
+        position = 0;
+
+        held.unlock();
+        owner.dequeued.notify_one();
+    }
+
+    *data = chunk.data() + position;
+    *size = chunk.size() - position;
+    position = chunk.size();
+    total += *size;
+    return true;
+}
+
+void
+ProtoInputStream::ReadAhead::BackUp(int count)
+{
+    assert(count >= 0 && (size_t)count <= position);
+    position -= count;
+    total -= count;
+}
+
+bool
+ProtoInputStream::ReadAhead::Skip(int count)
+{
+    const void* data;
+    int size;
+    while (count > 0) {
+        if (!Next(&data, &size))
+            return false;
+        if (size > count) {
+            BackUp(size - count);
+            return true;
+        }
+        count -= size;
+    }
+    return true;
 }
 
 bool
@@ -182,7 +385,8 @@ ProtoInputStream::read(Message& msg)
     // Due to the byte limit of the coded stream we create it for
     // every single mesage (based on forum discussions around the size
     // limitation)
-    io::CodedInputStream codedStream(zeroCopyStream);
+    io::CodedInputStream codedStream(background ?
+                                     &readAhead : zeroCopyStream);
     if (codedStream.ReadVarint32(&size)) {
         io::CodedInputStream::Limit limit = codedStream.PushLimit(size);
         if (msg.ParseFromCodedStream(&codedStream)) {
@@ -51,7 +51,12 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -98,9 +103,14 @@ class ProtoOutputStream : public ProtoStream
      * Create an output stream for a given file name. If the filename
      * ends with .gz then the file will be compressed accordinly.
      *
+     * In background mode the messages are only serialised by the
+     * caller, and batches of them are compressed and written by a
+     * separate thread.
+     *
      * @param filename Path to the file to create or truncate
+     * @param background Compress and write on a background thread
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename, bool background = false);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -130,6 +140,47 @@ class ProtoOutputStream : public ProtoStream
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
+    /// Serialised messages are written by the writer thread
+    const bool background;
+
+    /// Bytes of serialised messages gathered before a hand off
+    static const size_t batchBytes = 64 * 1024;
+
+    /// Batches the writer may lag behind by before write() waits
+    static const size_t maxQueued = 16;
+
+    /// Messages serialised since the last hand off
+    std::string batch;
+
+    /// Batches waiting to be written, oldest first
+    std::deque<std::string> queue;
+
+    /// Tell the writer to finish
+    bool stopping;
+
+    /// Guards the queue and stopping
+    std::mutex lock;
+
+    /// Signalled when the queue gains a batch or stopping is set
+    std::condition_variable queued;
+
+    /// Signalled when the writer takes a batch off the queue
+    std::condition_variable dequeued;
+
+    std::thread writer;
+
+    /**
+     * Queue the current batch for the writer, waiting for it to catch
+     * up if it is too far behind.
+     */
+    void handOff();
+
+    /**
+     * The writer thread, which passes the queued batches on to the
+     * (possibly compressing) zero-copy stream.
+     */
+    void writeLoop();
+
 };
 
 /**
@@ -148,9 +199,13 @@ class ProtoInputStream : public ProtoStream
      * Create an input stream for a given file name. If the filename
      * ends with .gz then the file will be decompressed accordingly.
      *
+     * In background mode a separate thread reads and decompresses
+     * the file ahead of the caller, which only parses the messages.
+     *
      * @param filename Path to the file to read from
+     * @param background Read and decompress on a background thread
      */
-    ProtoInputStream(const std::string& filename);
+    ProtoInputStream(const std::string& filename, bool background = false);
 
     /**
      * Destruct the input stream, and also close the underlying file
@@ -183,6 +238,56 @@ class ProtoInputStream : public ProtoStream
      */
     void destroyStreams();
 
+    /**
+     * Start the reader thread on the freshly created streams.
+     */
+    void startReader();
+
+    /**
+     * Tell the reader thread to finish, wait for it, and drop
+     * whatever it had read ahead.
+     */
+    void stopReader();
+
+    /**
+     * The reader thread, which fills the queue with chunks of the
+     * (possibly decompressed) file.
+     */
+    void readLoop();
+
+    /**
+     * Zero-copy view of the chunks queued by the reader thread,
+     * handed to the coded streams in place of the file streams.
+     */
+    class ReadAhead : public google::protobuf::io::ZeroCopyInputStream
+    {
+      public:
+
+        ReadAhead(ProtoInputStream& _owner)
+            : owner(_owner), position(0), total(0) {}
+
+        bool Next(const void** data, int* size);
+        void BackUp(int count);
+        bool Skip(int count);
+        google::protobuf::int64 ByteCount() const { return total; }
+
+        /** Forget the current chunk, e.g. when the file is reset. */
+        void clear() { chunk.clear(); position = 0; total = 0; }
+
+      private:
+
+        ProtoInputStream& owner;
+
+        /// Chunk currently being parsed
+        std::string chunk;
+
+        /// Offset of the first unconsumed byte in the chunk
+        size_t position;
+
+        /// Bytes consumed since the stream was created or reset
+        google::protobuf::int64 total;
+    };
+
     /// Underlying file input stream
     std::ifstream fileStream;
 
@@ -201,6 +306,38 @@ class ProtoInputStream : public ProtoStream
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyInputStream* zeroCopyStream;
 
+    /// The file is read and decompressed by the reader thread
+    const bool background;
+
+    /// Bytes gathered from the file before a hand off
+    static const size_t chunkBytes = 64 * 1024;
+
+    /// Chunks the reader may run ahead by before it waits
+    static const size_t maxQueued = 16;
+
+    /// Chunks read ahead of the caller, oldest first
+    std::deque<std::string> queue;
+
+    /// Set by the reader once the file is exhausted
+    bool exhausted;
+
+    /// Tell the reader to finish
+    bool stopping;
+
+    /// Guards the queue, exhausted and stopping
+    std::mutex lock;
+
+    /// Signalled when the queue gains a chunk or exhausted is set
+    std::condition_variable queued;
+
+    /// Signalled when a chunk is taken off the queue or stopping is set
+    std::condition_variable dequeued;
+
+    std::thread reader;
+
+    /// What read() parses from in background mode
+    ReadAhead readAhead;
+
 };
 
 #endif //__PROTO_PROTOIO_HH
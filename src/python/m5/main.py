@@ -82,6 +82,21 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-columnar", metavar="FILE", default=None,
+        help="Also write statistics to FILE as a binary time series, one"
+        " row per dump, gzipped if FILE ends in .gz. Read with"
+        " util/stats_columnar.py")
+    option("--stats-prepare-threads", metavar="N", type='int', default=1,
+        help="Number of host threads used to prepare stats before a dump")
+    option("--campaign-dir", metavar="DIR", default=None,
+        help="Share output with the other runs of a campaign in DIR instead"
+        " of writing per-run files: the configuration is written once as"
+        " config-<hash>.ini/.json and the --campaign-stats of every dump"
+        " are appended to DIR/stats.bin, read with util/stats_columnar.py."
+        " No config or --stats-file is written to the output directory")
+    option("--campaign-stats", metavar="REGEX", action='append', default=[],
+        help="Record the stats whose names match REGEX from their start"
+        " with --campaign-dir, e.g. 'system.cpu.committedInsts'")
 
     # Configuration Options
     group("Configuration Options")
@@ -104,8 +119,20 @@ def parse_options():
         help="Start debug output at TIME (must be in ticks)")
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug [Default: %default]")
+    option("--debug-buffer", metavar="BYTES", type='int', default=0,
+        help="Buffer debug output in BYTES per simulation thread and write"
+        " (and compress, for a .gz --debug-file) it in a background thread"
+        " [Default: unbuffered]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
+    option("--debug-window", metavar="START[,STOP]", action='append',
+        default=[], help="Debug output only from START to STOP, each one of"
+        " tick:N, inst:N (committed instructions), sym:NAME (entry to"
+        " NAME) or fault (a fault injection), and STOP also +tick:N or"
+        " +inst:N after START. Repeat for more windows")
+    option("--debug-pretrigger", metavar="N", type='int', default=0,
+        help="Keep the last N debug messages from outside the"
+        " --debug-window windows and write them out as a window opens")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
 
@@ -197,6 +224,16 @@ def main(*args):
     if not os.path.isdir(options.outdir):
         os.makedirs(options.outdir)
 
+    if options.campaign_dir:
+        # Make the path survive the output directory changing under
+        # forked runs, and tolerate other runs creating it concurrently
+        options.campaign_dir = os.path.abspath(options.campaign_dir)
+        try:
+            os.makedirs(options.campaign_dir)
+        except OSError:
+            if not os.path.isdir(options.campaign_dir):
+                raise
+
     # These filenames are used only if the redirect_std* options are set
     stdout_file = os.path.join(options.outdir, options.stdout_file)
     stderr_file = os.path.join(options.outdir, options.stderr_file)
@@ -312,7 +349,14 @@ def main(*args):
     sys.path[0:0] = options.path
 
     # set stats options
-    stats.initText(options.stats_file)
+    if options.campaign_dir:
+        stats.initCampaign(os.path.join(options.campaign_dir, "stats.bin"),
+                           options.campaign_stats)
+    else:
+        stats.initText(options.stats_file)
+    if options.stats_columnar:
+        stats.initColumnar(options.stats_columnar)
+    stats.prepareThreads = options.stats_prepare_threads
 
     # set debugging options
     debug.setRemoteGDBPort(options.remote_gdb_port)
@@ -339,14 +383,28 @@ def main(*args):
             else:
                 debug.flags[flag].enable()
 
-    if options.debug_start:
+    if options.debug_window:
+        check_tracing()
+        if options.debug_start:
+            print >>sys.stderr, "--debug-start and --debug-window conflict"
+            sys.exit(1)
+    elif options.debug_start:
         check_tracing()
         e = event.create(trace.enable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_start)
     else:
         trace.enable()
 
-    trace.output(options.debug_file)
+    if options.debug_buffer:
+        trace.output_buffered(options.debug_file, options.debug_buffer)
+    else:
+        trace.output(options.debug_file)
+
+    for window in options.debug_window:
+        trace.window(window)
+    if options.debug_window:
+        trace.window_pretrigger(options.debug_pretrigger)
+        trace.start_windows()
 
     for ignore in options.debug_ignore:
         check_tracing()
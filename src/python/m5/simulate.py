@@ -66,6 +66,47 @@ _memory_modes = {
     "atomic_noncaching" : objects.params.atomic_noncaching,
     }
 
+# Hash of the configuration written to the campaign directory
+_configHash = None
+
+def configHash():
+    """The hash naming this run's configuration in the --campaign-dir,
+    or None outside campaign mode."""
+    return _configHash
+
+def _writeOnce(path, text):
+    """Write text to path unless another run already did.  The file is
+    renamed into place, so concurrent runs never see it half written."""
+    if os.path.exists(path):
+        return
+    tmp = "%s.%d" % (path, os.getpid())
+    f = file(tmp, 'w')
+    f.write(text)
+    f.close()
+    os.rename(tmp, path)
+
+def writeCampaignConfig(root, campaign_dir):
+    """Write the configuration to campaign_dir as config-<hash>.ini and
+    .json, once for all the runs sharing it, and tag the campaign stats
+    with the hash."""
+    global _configHash
+    import hashlib
+    import json
+    from cStringIO import StringIO
+
+    ini = StringIO()
+    for obj in sorted(root.descendants(), key=lambda o: o.path()):
+        obj.print_ini(ini)
+    ini = ini.getvalue()
+    _configHash = hashlib.sha1(ini).hexdigest()[:16]
+
+    base = os.path.join(campaign_dir, "config-%s" % _configHash)
+    _writeOnce(base + ".ini", ini)
+    _writeOnce(base + ".json",
+               json.dumps(root.get_config_as_dict(), indent=4))
+
+    stats.setCampaignTag(json.dumps({ "config" : _configHash }))
+
 # The final hook to generate .ini files.  Called from the user script
 # once the config is built.
 def instantiate(ckpt_dir=None):
@@ -86,14 +127,16 @@ def instantiate(ckpt_dir=None):
     # Unproxy in sorted order for determinism
     for obj in root.descendants(): obj.unproxyParams()
 
-    if options.dump_config:
+    if options.campaign_dir:
+        writeCampaignConfig(root, options.campaign_dir)
+    elif options.dump_config:
         ini_file = file(os.path.join(options.outdir, options.dump_config), 'w')
         # Print ini sections in sorted order for easier diffing
         for obj in sorted(root.descendants(), key=lambda o: o.path()):
             obj.print_ini(ini_file)
         ini_file.close()
 
-    if options.json_config:
+    if options.json_config and not options.campaign_dir:
         try:
             import json
             json_file = file(os.path.join(options.outdir, options.json_config), 'w')
@@ -103,7 +146,8 @@ def instantiate(ckpt_dir=None):
         except ImportError:
             pass
 
-    do_dot(root, options.outdir, options.dot_config)
+    if not options.campaign_dir:
+        do_dot(root, options.outdir, options.dot_config)
 
     # Initialize the global statistics
     stats.initSimStats()
@@ -173,6 +217,10 @@ def curTick():
 # Drain the system in preparation of a checkpoint or memory mode
 # switch.
 def drain(root):
+    drainObjects(list(root.descendants()))
+
+# Drain only the given objects, leaving the rest of the system running.
+def drainObjects(objs):
     # Try to drain all objects. Draining might not be completed unless
     # all objects return that they are drained on the first call. This
     # is because as objects drain they may cause other objects to no
@@ -180,7 +228,7 @@ def drain(root):
     def _drain():
         all_drained = False
         dm = internal.drain.createDrainManager()
-        unready_objs = sum(obj.drain(dm) for obj in root.descendants())
+        unready_objs = sum(obj.drain(dm) for obj in objs)
         # If we've got some objects that can't drain immediately, then simulate
         if unready_objs > 0:
             dm.setCount(unready_objs)
@@ -219,6 +267,203 @@ def checkpoint(dir):
     internal.core.serializeAll(dir)
     resume(root)
 
+fork_count = 0
+def fork(simout="%(parent)s.f%(fork_seq)i"):
+    """Fork the simulator process.
+
+    The system is drained and all output is flushed before forking so
+    that the child starts from a clean copy of the parent's state.  The
+    child moves its output to a new directory given by simout, which
+    may refer to the parent's output directory as %(parent)s, the
+    number of forks made so far as %(fork_seq)i and the child's process
+    ID as %(pid)i.  In --campaign-dir mode that directory is only
+    created once the child writes a file to it, which campaign runs
+    normally don't.  Both processes resume the system before returning.
+
+    Returns the process ID of the child in the parent and 0 in the child.
+    """
+    from m5 import options
+    global fork_count
+
+    root = objects.Root.getInstance()
+    if not isinstance(root, objects.Root):
+        raise TypeError, "Fork must be called on a root object."
+
+    drain(root)
+    sys.stdout.flush()
+    sys.stderr.flush()
+    internal.core.flushOutputDir()
+
+    pid = os.fork()
+    if pid == 0:
+        parent = options.outdir
+        options.outdir = simout % {
+            "parent" : parent,
+            "fork_seq" : fork_count,
+            "pid" : os.getpid(),
+            }
+        redirect = options.redirect_stdout or options.redirect_stderr
+        if (redirect or not options.campaign_dir) and \
+           not os.path.isdir(options.outdir):
+            os.makedirs(options.outdir)
+        internal.core.setOutputDir(options.outdir)
+
+        if options.redirect_stdout:
+            stdout_file = os.path.join(options.outdir, options.stdout_file)
+            redir_fd = os.open(stdout_file,
+                               os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+            os.dup2(redir_fd, sys.stdout.fileno())
+            if not options.redirect_stderr:
+                os.dup2(redir_fd, sys.stderr.fileno())
+        if options.redirect_stderr:
+            stderr_file = os.path.join(options.outdir, options.stderr_file)
+            redir_fd = os.open(stderr_file,
+                               os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+            os.dup2(redir_fd, sys.stderr.fileno())
+    else:
+        fork_count += 1
+
+    resume(root)
+    return pid
+
+def _runForkedChild(mutation, args):
+    """Apply a mutation in a forked child and simulate to completion.
+    The child exits with the exit code of the simulation, running the
+    normal exit handlers so that its stats are dumped."""
+    root = objects.Root.getInstance()
+    mutation(root, *args)
+    exit_event = simulate()
+    print 'Exiting @ tick %i because %s' % (curTick(), exit_event.getCause())
+    sys.exit(exit_event.getCode())
+
+def fork_at(tick, mutations, simout="%(parent)s.f%(fork_seq)i", jobs=None):
+    """Simulate up to tick and fork a child for each mutation.
+
+    Each mutation is a callable taking the root object.  A child
+    applies its mutation (e.g. retargets a fault) and runs to
+    completion with its output in simout (see fork()).  The children
+    share the parent's warmed up state copy-on-write, and at most jobs
+    of them run at once.  The parent stays at tick, so it can be used
+    for the next batch.
+
+    Returns the exit status of each child in order, or the exit event
+    if the simulation ended before tick.
+    """
+    if tick < curTick():
+        raise ValueError, "Can't fork at tick %d, already at tick %d" % \
+            (tick, curTick())
+    if tick > curTick():
+        exit_event = simulate(tick - curTick())
+        if exit_event.getCause() != "simulate() limit reached":
+            return exit_event
+
+    children = {}
+    statuses = [None] * len(mutations)
+    def reap(pid, status):
+        statuses[children.pop(pid)] = status
+
+    for seq, mutation in enumerate(mutations):
+        while jobs and len(children) >= jobs:
+            reap(*os.wait())
+        pid = fork(simout)
+        if pid == 0:
+            _runForkedChild(mutation, ())
+        children[pid] = seq
+
+    while children:
+        reap(*os.wait())
+    return statuses
+
+def serve_forks(path, mutations, simout="%(parent)s.f%(fork_seq)i"):
+    """Serve fork requests on a UNIX socket.
+
+    The parent simulator keeps its state while a controller tells it
+    to advance and to fork children from the current state.  Only the
+    named mutations in the mutations dict can be applied; each is a
+    callable taking the root object and the string arguments of the
+    request.  Requests are single lines and each gets a single line
+    reply starting with "ok" or "error":
+
+      fork NAME [ARG...]  fork a child applying mutation NAME;
+                          replies with its pid
+      run TICKS           advance the parent; replies with the tick
+                          and the cause of the exit event
+      tick                reply with the current tick
+      wait                wait for all children; replies with
+                          pid:status pairs
+      quit                stop serving and return
+
+    Returns the exit statuses of the children reaped, keyed by pid.
+    """
+    import socket
+
+    if os.path.exists(path):
+        os.unlink(path)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(path)
+    server.listen(1)
+    owner = os.getpid()
+
+    children = set()
+    statuses = {}
+    def wait_all():
+        done = []
+        while children:
+            pid, status = os.wait()
+            children.discard(pid)
+            statuses[pid] = status
+            done.append((pid, status))
+        return done
+
+    def handle(words):
+        cmd, args = words[0], words[1:]
+        if cmd == "fork":
+            if not args or args[0] not in mutations:
+                return "error unknown mutation"
+            # reap finished children so they don't pile up
+            for pid in list(children):
+                if os.waitpid(pid, os.WNOHANG)[0] == pid:
+                    children.discard(pid)
+            pid = fork(simout)
+            if pid == 0:
+                server.close()
+                conn.close()
+                _runForkedChild(mutations[args[0]], args[1:])
+            children.add(pid)
+            return "ok %d" % pid
+        elif cmd == "run" and len(args) == 1:
+            exit_event = simulate(long(args[0]))
+            return "ok %d %s" % (curTick(), exit_event.getCause())
+        elif cmd == "tick":
+            return "ok %d" % curTick()
+        elif cmd == "wait":
+            return "ok " + " ".join("%d:%d" % ps for ps in wait_all())
+        return "error bad request"
+
+    try:
+        while True:
+            conn, addr = server.accept()
+            for line in conn.makefile():
+                words = line.split()
+                if not words:
+                    continue
+                if words[0] == "quit":
+                    conn.sendall("ok\n")
+                    conn.close()
+                    wait_all()
+                    return statuses
+                try:
+                    reply = handle(words)
+                except ValueError, e:
+                    reply = "error %s" % e
+                conn.sendall(reply + "\n")
+            conn.close()
+    finally:
+        # children exit through here too, but the socket is the parent's
+        server.close()
+        if os.getpid() == owner and os.path.exists(path):
+            os.unlink(path)
+
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
         raise TypeError, "Parameter of type '%s'.  Must be type %s or %s." % \
@@ -229,7 +474,8 @@ def _changeMemoryMode(system, mode):
     else:
         print "System already in target mode. Memory mode unchanged."
 
-def switchCpus(system, cpuList, do_drain=True, verbose=True):
+def switchCpus(system, cpuList, do_drain=True, verbose=True,
+               drain_memory=True):
     """Switch CPUs in a system.
 
     By default, this method drains and resumes the system. This
@@ -238,6 +484,13 @@ def switchCpus(system, cpuList, do_drain=True, verbose=True):
     operations requiring a drained system are going to be performed in
     sequence.
 
+    With 'drain_memory' set to false, only the old CPUs are drained,
+    i.e. their pipelines are emptied, and the memory system keeps
+    running with any outstanding transactions, such as writebacks,
+    in flight. This is only possible when the old and new CPUs use
+    the same memory mode; otherwise the whole system is drained to
+    change the mode.
+
     Note: This method may switch the memory mode of the system if that
     is required by the CPUs. It may also flush all caches in the
     system.
@@ -293,7 +546,11 @@ def switchCpus(system, cpuList, do_drain=True, verbose=True):
     except KeyError:
         raise RuntimeError, "Invalid memory mode (%s)" % memory_mode_name
 
-    if do_drain:
+    fast_switch = do_drain and not drain_memory and \
+        system.getMemoryMode() == memory_mode
+    if fast_switch:
+        drainObjects(old_cpus)
+    elif do_drain:
         drain(system)
 
     # Now all of the CPUs are ready to be switched out
@@ -315,7 +572,10 @@ def switchCpus(system, cpuList, do_drain=True, verbose=True):
     for old_cpu, new_cpu in cpuList:
         new_cpu.takeOverFrom(old_cpu)
 
-    if do_drain:
+    if fast_switch:
+        for cpu in old_cpus + new_cpus:
+            cpu.drainResume()
+    elif do_drain:
         resume(system)
 
 from internal.core import disableAllListeners
@@ -27,6 +27,8 @@
 #
 # Authors: Nathan Binkert
 
+import re
+
 import m5
 
 from m5 import internal
@@ -39,6 +41,26 @@ def initText(filename, desc=True):
     output = internal.stats.initText(filename, desc)
     outputList.append(output)
 
+def initColumnar(filename):
+    output = internal.stats.initColumnar(filename)
+    outputList.append(output)
+
+# The campaign output and the regular expressions selecting its stats
+campaignOutput = None
+campaignPatterns = []
+campaignStats = []
+def initCampaign(filename, patterns):
+    '''Append the stats whose names match any of the patterns to the
+    campaign file filename at every dump (see Stats::Campaign)'''
+    global campaignOutput, campaignPatterns
+    campaignOutput = internal.stats.initCampaign(filename)
+    campaignPatterns = [ re.compile(p) for p in patterns ]
+    outputList.append(campaignOutput)
+
+def setCampaignTag(tag):
+    '''Identify the run in the campaign records it appends from now on'''
+    internal.stats.setCampaignTag(tag)
+
 def initSimStats():
     internal.stats.initSimStats()
     internal.stats.registerPythonStatsHandlers()
@@ -84,14 +106,19 @@ def enable():
         stats_dict[stat.name] = stat
         stat.enable()
 
+    campaignStats[:] = [ stat for stat in stats_list
+                         if any(p.match(stat.name) for p in campaignPatterns) ]
+
     internal.stats.enable();
 
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
-        stat.prepare()
+    internal.stats.prepareStats(False)
+
+# Number of host threads used to prepare stats at dump time
+prepareThreads = 1
 
 lastDump = 0
 def dump():
@@ -107,14 +134,28 @@ def dump():
 
     internal.stats.processDumpQueue()
 
-    prepare()
+    outputs = [ output for output in outputList if output.valid() ]
+
+    # Formula results can't change during the dump, so let formula nodes
+    # cache them instead of re-evaluating shared subtrees for every
+    # result()/total() call. Stats with a zero prereq only need to be
+    # prepared if some output actually reports them.
+    internal.stats.beginFormulaCache()
+    try:
+        skip_zero = all(output.skipsZeroPrereq() for output in outputs)
+        internal.stats.prepareStats(skip_zero, prepareThreads)
 
-    for output in outputList:
-        if output.valid():
+        for output in outputs:
             output.begin()
-            for stat in stats_list:
-                output.visit(stat)
+            if output is campaignOutput:
+                for stat in campaignStats:
+                    output.visit(stat)
+            else:
+                for stat in stats_list:
+                    output.visit(stat)
             output.end()
+    finally:
+        internal.stats.endFormulaCache()
 
 def reset():
     '''Reset all statistics to the base state'''
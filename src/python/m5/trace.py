@@ -29,7 +29,8 @@
 import internal
 import util
 
-from internal.trace import output, ignore
+from internal.trace import output, output_buffered, ignore, window, \
+    window_pretrigger, start_windows
 
 def disable():
     internal.trace.cvar.enabled = False
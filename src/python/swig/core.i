@@ -33,7 +33,6 @@
 
 %{
 #include "base/misc.hh"
-#include "base/random.hh"
 #include "base/socket.hh"
 #include "base/types.hh"
 #include "python/swig/pyobject.hh"
@@ -58,7 +57,7 @@ inline void disableAllListeners() { ListenSocket::disableAll(); }
 inline void
 seedRandom(uint64_t seed)
 {
-    random_mt.init(seed);
+    seedMainEventQueues(seed);
 }
 
 %}
@@ -69,6 +68,7 @@ seedRandom(uint64_t seed)
 %include "base/types.hh"
 
 void setOutputDir(const std::string &dir);
+void flushOutputDir();
 void doExitCleanup();
 void disableAllListeners();
 void seedRandom(uint64_t seed);
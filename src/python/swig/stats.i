@@ -36,6 +36,8 @@
 %include <stdint.i>
 
 %{
+#include "base/stats/campaign.hh"
+#include "base/stats/columnar.hh"
 #include "base/stats/text.hh"
 #include "base/stats/types.hh"
 #include "base/callback.hh"
@@ -136,6 +138,9 @@ template <class T> T cast_info(Info *info);
 
 void initSimStats();
 Output *initText(const std::string &filename, bool desc);
+Output *initColumnar(const std::string &filename);
+Output *initCampaign(const std::string &filename);
+void setCampaignTag(const std::string &tag);
 
 void registerPythonStatsHandlers();
 
@@ -148,6 +153,9 @@ void updateEvents();
 
 void processResetQueue();
 void processDumpQueue();
+void prepareStats(bool skip_zero_prereq, unsigned threads = 1);
+void beginFormulaCache();
+void endFormulaCache();
 void enable();
 bool enabled();
 
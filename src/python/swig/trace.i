@@ -31,9 +31,11 @@
 %module(package="m5.internal") trace
 
 %{
+#include "base/async_logger.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "base/output.hh"
+#include "sim/trace_window.hh"
 
 inline void
 output(const char *filename)
@@ -46,6 +48,12 @@ output(const char *filename)
     Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream));
 }
 
+inline void
+output_buffered(const char *filename, size_t buffer_bytes)
+{
+    Trace::setDebugLogger(new Trace::AsyncLogger(filename, buffer_bytes));
+}
+
 inline void
 ignore(const char *expr)
 {
@@ -54,9 +62,31 @@ ignore(const char *expr)
     Trace::getDebugLogger()->setIgnore(ignore);
 }
 
+inline void
+window(const char *spec)
+{
+    Trace::traceWindows.addWindow(spec);
+}
+
+inline void
+window_pretrigger(size_t events)
+{
+    Trace::traceWindows.setPreTrigger(events);
+}
+
+inline void
+start_windows()
+{
+    Trace::traceWindows.start();
+}
+
 using Trace::enabled;
 %}
 
 extern void output(const char *string);
+extern void output_buffered(const char *string, size_t buffer_bytes);
 extern void ignore(const char *expr);
+extern void window(const char *spec);
+extern void window_pretrigger(size_t events);
+extern void start_windows();
 extern bool enabled;
@@ -27,6 +27,7 @@
 # Authors: Nathan Binkert
 
 from m5.SimObject import SimObject
+from m5.defines import buildEnv
 from m5.params import *
 from m5.proxy import *
 
@@ -40,12 +41,19 @@ class Process(SimObject):
     system = Param.System(Parent.any, "system process will run on")
     useArchPT = Param.Bool('false', 'maintain an in-memory version of the page\
                             table in an architecture-specific format')
+    useRadixPT = Param.Bool(buildEnv['TARGET_ISA'] == 'arm', 'use a radix ' \
+                            'page table with flat leaves and huge mappings ' \
+                            'rather than a hash map (without useArchPT)')
     kvmInSE = Param.Bool('false', 'initialize the process for KvmCPU in SE')
     max_stack_size = Param.MemorySize('64MB', 'maximum size of the stack')
 
     @classmethod
     def export_methods(cls, code):
-        code('bool map(Addr vaddr, Addr paddr, int size, bool cacheable=true);')
+        code('''
+    bool map(Addr vaddr, Addr paddr, int size, bool cacheable=true);
+    uint64_t outputDigest() const;
+    uint64_t memoryDigest(Addr vaddr, Addr size);
+''')
 
 class EmulatedDriver(SimObject):
     type = 'EmulatedDriver'
@@ -68,4 +76,6 @@ class LiveProcess(Process):
     ppid = Param.Int(99, 'parent process id')
     simpoint = Param.UInt64(0, 'simulation point at which to start simulation')
     drivers = VectorParam.EmulatedDriver([], 'Available emulated drivers')
+    predecode = Param.Bool(False, 'decode the whole text segment into the '
+                           'decode cache at startup (ARM AArch64 only)')
 
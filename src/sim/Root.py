@@ -33,6 +33,9 @@ from m5.defines import buildEnv
 from m5.params import *
 from m5.util import fatal
 
+# Data structure used by the main event queues to keep pending events
+class EventQueueBackend(Enum): vals = ['LinkedList', 'TimingWheel']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -69,6 +72,43 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Adapt the quantum at run time, from the host time the threads of a
+    # multi-eventq simulation wait on each other and the latencies of the
+    # work crossing queues.  Work taking less than the quantum to cross
+    # is delayed to the end of the quantum, so sim_quantum_max bounds
+    # the timing error.  With sim_quantum_max above the shortest
+    # cross-queue latency the quantum follows host timing, and results
+    # change from run to run: the quanta chosen are then logged to
+    # quantum_log.txt, and sim_quantum_replay repeats them.
+    sim_quantum_adaptive = Param.Bool(False, "adapt the simulation quantum")
+    sim_quantum_min = Param.Tick(0, "shortest adaptive quantum, 0 for the "
+        "shortest cross-queue latency")
+    sim_quantum_max = Param.Tick(0, "longest adaptive quantum, 0 for the "
+        "shortest cross-queue latency, which delays no work")
+    sim_quantum_overhead = Param.Float(0.1, "share of host time the threads "
+        "may spend in quantum barriers before the quantum grows")
+    sim_quantum_replay = Param.String("", "quantum_log.txt of an earlier "
+        "run whose quanta are used instead of adapting, to reproduce it")
+
+    # Host threads for a multi-eventq simulation.  With fewer threads
+    # than event queues, the queues share a pool of worker threads that
+    # steal queues from each other within every quantum.
+    sim_threads = Param.Unsigned(0, "host threads simulating the event "
+        "queues, 0 for one per queue")
+
+    eventq_backend = Param.EventQueueBackend('LinkedList',
+            "data structure used by the main event queues")
+    eventq_wheel_slots = Param.Unsigned(4096,
+            "number of slots in the timing wheel backend")
+    eventq_wheel_granularity = Param.Tick(1000,
+            "ticks covered by each timing wheel slot")
+    eventq_profile = Param.Bool(False,
+            "write the host time spent per event owner and type to "
+            "eventq_profile.txt and eventq_profile.folded at exit")
+    host_mem_stats = Param.Bool(False,
+            "report the host memory taken by each object as hostMem "
+            "stats, and sorted by size in host_mem.txt at exit")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
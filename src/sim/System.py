@@ -39,6 +39,8 @@ from SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemCheckpointFormat(Enum): vals = ['gzip', 'paged', 'raw']
+
 class System(MemObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -66,6 +68,25 @@ class System(MemObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Ask the host for transparent huge pages for the backing store,
+    # which cuts host TLB misses when simulating large memories
+    mmap_using_huge_pages = Param.Bool(False, "Back the memory with " \
+                                           "transparent huge pages")
+
+    # Backing stores are either checkpointed as one gzip stream per
+    # store, or as a paged image with zero-page elision and page
+    # dedup. Incremental paged checkpoints only store the pages that
+    # differ from the last checkpoint taken or restored. Raw stores
+    # are uncompressed images that are mapped copy-on-write when
+    # restoring, so restore is close to instant and the image is
+    # shared through the page cache by concurrent runs.
+    mem_checkpoint_format = Param.MemCheckpointFormat('gzip',
+        "Format used to checkpoint the backing stores")
+    mem_checkpoint_compression = Param.Int(1, "zlib level (0-9) used " \
+                                               "for paged checkpoints")
+    mem_checkpoint_incremental = Param.Bool(False, "Make paged " \
+        "checkpoints relative to the previous one")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
@@ -98,6 +119,9 @@ class System(MemObject):
     load_addr_mask = Param.UInt64(0xffffffffff,
             "Address to mask loading binaries with")
     load_offset = Param.UInt64(0, "Address to offset loading binaries with")
+    roi_functions = VectorParam.String(["main", "FUNC*"], "Functions in the"
+        " region of interest: names, name prefixes ending in '*' or POSIX"
+        " extended regular expressions prefixed with 're:'")
 
     # Dynamic voltage and frequency handler for the system, disabled by default
     # Provide list of domains that need to be controlled by the handler
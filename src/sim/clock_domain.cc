@@ -50,8 +50,8 @@
 #include "params/DerivedClockDomain.hh"
 #include "params/SrcClockDomain.hh"
 #include "sim/clock_domain.hh"
+#include "sim/core.hh"
 #include "sim/voltage_domain.hh"
-#include "sim/clocked_object.hh"
 
 void
 ClockDomain::regStats()
@@ -67,6 +67,13 @@ ClockDomain::regStats()
         ;
 }
 
+void
+ClockDomain::setClockPeriod(Tick clock_period)
+{
+    changes.push_back(std::make_pair(curTick(), _clockPeriod));
+    _clockPeriod = clock_period;
+}
+
 double
 ClockDomain::voltage() const
 {
@@ -114,12 +121,8 @@ SrcClockDomain::clockPeriod(Tick clock_period)
         fatal("%s has a clock period of zero\n", name());
     }
 
-    // Align all members to the current tick
-    for (auto m = members.begin(); m != members.end(); ++m) {
-        (*m)->updateClockPeriod();
-    }
-
-    _clockPeriod = clock_period;
+    // Members realign to the new period lazily, see ClockedObject
+    setClockPeriod(clock_period);
 
     DPRINTF(ClockDomain,
             "Setting clock period to %d ticks for source clock %s\n",
@@ -205,14 +208,9 @@ DerivedClockDomain::DerivedClockDomain(const Params *p) :
 void
 DerivedClockDomain::updateClockPeriod()
 {
-    // Align all members to the current tick
-    for (auto m = members.begin(); m != members.end(); ++m) {
-        (*m)->updateClockPeriod();
-    }
-
     // recalculate the clock period, relying on the fact that changes
     // propagate downwards in the tree
-    _clockPeriod = parent.clockPeriod() * clockDivider;
+    setClockPeriod(parent.clockPeriod() * clockDivider);
 
     DPRINTF(ClockDomain,
             "Setting clock period to %d ticks for derived clock %s\n",
@@ -50,8 +50,11 @@
 #define __SIM_CLOCK_DOMAIN_HH__
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
+#include "base/types.hh"
 #include "params/ClockDomain.hh"
 #include "params/DerivedClockDomain.hh"
 #include "params/SrcClockDomain.hh"
@@ -62,13 +65,17 @@
  */
 class DerivedClockDomain;
 class VoltageDomain;
-class ClockedObject;
 
 /**
  * The ClockDomain provides clock to group of clocked objects bundled
  * under the same clock domain. The clock domains, in turn, are
  * grouped into voltage domains. The clock domains provide support for
  * a hierarchial structure with source and derived domains.
+ *
+ * The domain logs when its clock period changes and the period
+ * before each change. Members notice a new entry the next time they
+ * advance their cached clock and replay the changes they missed, so
+ * a change costs the same however many members the domain has.
  */
 class ClockDomain : public SimObject
 {
@@ -88,6 +95,19 @@ class ClockDomain : public SimObject
      */
     Tick _clockPeriod;
 
+    /**
+     * The tick of every clock period change and the period before it,
+     * in order
+     */
+    std::vector<std::pair<Tick, Tick>> changes;
+
+    /**
+     * Set the clock period from the current tick on. Each member runs
+     * the old period to its next edge, which becomes its first edge of
+     * the new one.
+     */
+    void setClockPeriod(Tick clock_period);
+
     /**
      * Voltage domain this clock domain belongs to
      */
@@ -99,19 +119,12 @@ class ClockDomain : public SimObject
      */
     std::vector<DerivedClockDomain*> children;
 
-    /**
-     * Pointers to members of this clock domain, so that when the clock
-     * period changes, we can update each member's tick.
-     */
-    std::vector<ClockedObject*> members;
-
   public:
 
     typedef ClockDomainParams Params;
     ClockDomain(const Params *p, VoltageDomain *voltage_domain) :
         SimObject(p),
-        _clockPeriod(0),
-        _voltageDomain(voltage_domain) {}
+        _clockPeriod(0), _voltageDomain(voltage_domain) {}
 
     void regStats();
 
@@ -123,16 +136,19 @@ class ClockDomain : public SimObject
     Tick clockPeriod() const { return _clockPeriod; }
 
     /**
-     * Register a ClockedObject to this ClockDomain.
+     * Get the number of clock period changes so far, which members
+     * compare against to see if their cached clock edge is stale.
+     */
+    uint64_t epoch() const { return changes.size(); }
+
+    /**
+     * Get a clock period change.
      *
-     * @param ClockedObject to add as a member
+     * @param epoch Number of the change, less than epoch()
+     * @return The tick of the change and the period before it
      */
-    void registerWithClockDomain(ClockedObject *c)
-    {
-        assert(c != NULL);
-        assert(std::find(members.begin(), members.end(), c) == members.end());
-        members.push_back(c);
-    }
+    const std::pair<Tick, Tick> &change(uint64_t epoch) const
+    { return changes[epoch]; }
 
     /**
      * Get the voltage domain.
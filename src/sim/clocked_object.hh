@@ -71,6 +71,10 @@ class ClockedObject : public SimObject
     // 'tick'
     mutable Cycles cycle;
 
+    // The number of clock domain period changes 'tick' and 'cycle'
+    // account for
+    mutable uint64_t epoch;
+
     /**
      * Prevent inadvertent use of the copy constructor and assignment
      * operator by making them private.
@@ -90,21 +94,52 @@ class ClockedObject : public SimObject
         if (tick >= curTick())
             return;
 
+        // the clock period has changed since tick was aligned, so
+        // first run each old period up to the change that ended it
+        if (epoch != clockDomain.epoch())
+            replayChanges();
+
+        advance(curTick(), clockPeriod());
+    }
+
+    /**
+     * Align cycle and tick to the first edge at or after a tick, for
+     * a given clock period.
+     */
+    void advance(Tick now, Tick period) const
+    {
+        if (tick >= now)
+            return;
+
         // optimise for the common case and see if the tick should be
         // advanced by a single clock period
-        tick += clockPeriod();
+        tick += period;
         ++cycle;
 
         // see if we are done at this point
-        if (tick >= curTick())
+        if (tick >= now)
             return;
 
         // if not, we have to recalculate the cycle and tick, we
         // perform the calculations in terms of relative cycles to
         // allow changes to the clock period in the future
-        Cycles elapsedCycles(divCeil(curTick() - tick, clockPeriod()));
+        Cycles elapsedCycles(divCeil(now - tick, period));
         cycle += elapsedCycles;
-        tick += elapsedCycles * clockPeriod();
+        tick += elapsedCycles * period;
+    }
+
+    /**
+     * Catch up with the clock period changes of the domain since the
+     * last update, as if they had been applied when they happened.
+     */
+    void replayChanges() const
+    {
+        for (; epoch < clockDomain.epoch(); ++epoch) {
+            const std::pair<Tick, Tick> &change = clockDomain.change(epoch);
+            // the initial period is set before any edge
+            if (change.second != 0)
+                advance(change.first, change.second);
+        }
     }
 
     /**
@@ -119,11 +154,9 @@ class ClockedObject : public SimObject
      * parameters.
      */
     ClockedObject(const ClockedObjectParams* p) :
-        SimObject(p), tick(0), cycle(0), clockDomain(*p->clk_domain)
+        SimObject(p), tick(0), cycle(0), epoch(0),
+        clockDomain(*p->clk_domain)
     {
-        // Register with the clock domain, so that if the clock domain
-        // frequency changes, we can update this object's tick.
-        clockDomain.registerWithClockDomain(this);
     }
 
     /**
@@ -141,19 +174,13 @@ class ClockedObject : public SimObject
         Cycles elapsedCycles(divCeil(curTick(), clockPeriod()));
         cycle = elapsedCycles;
         tick = elapsedCycles * clockPeriod();
+
+        // the earlier period changes no longer matter
+        epoch = clockDomain.epoch();
     }
 
   public:
 
-    /**
-     * Update the tick to the current tick.
-     *
-     */
-    inline void updateClockPeriod() const
-    {
-        update();
-    }
-
     /**
      * Determine the tick when a cycle begins, by default the current one, but
      * the argument also enables the caller to determine a future cycle. When
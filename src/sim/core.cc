@@ -98,6 +98,14 @@ setOutputDir(const string &dir)
     simout.setDirectory(dir);
 }
 
+void
+flushOutputDir()
+{
+    simout.flush();
+    cout.flush();
+    cerr.flush();
+}
+
 /**
  * Queue of C++ callbacks to invoke on simulator exit.
  */
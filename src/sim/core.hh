@@ -94,6 +94,7 @@ extern Tick ps; ///< picosecond
 void setClockFrequency(Tick ticksPerSecond);
 
 void setOutputDir(const std::string &dir);
+void flushOutputDir();
 
 class Callback;
 void registerExitCallback(Callback *callback);
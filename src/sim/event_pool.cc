@@ -1,5 +1,4 @@
 /*
- * Copyright (c) 1999 Mark D. Hill and David A. Wood
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,16 +25,20 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "mem/ruby/structures/MemoryNode.hh"
+#include "sim/event_pool.hh"
 
-using namespace std;
+__thread EventPool::FreeSlot *EventPool::freeLists[EventPool::NumClasses];
 
 void
-MemoryNode::print(ostream& out) const
+EventPool::refill(size_t size_class)
 {
-    out << "[";
-    out << m_time << ", ";
-    out << m_msg_counter << ", ";
-    out << pkt << "; ";
-    out << "]";
+    const size_t slot_size = (size_class + 1) * Granularity;
+    char *chunk = static_cast<char *>(::operator new(slot_size * ChunkSlots));
+
+    FreeSlot *&head = freeLists[size_class];
+    for (size_t i = 0; i < ChunkSlots; ++i) {
+        FreeSlot *slot = reinterpret_cast<FreeSlot *>(chunk + i * slot_size);
+        slot->next = head;
+        head = slot;
+    }
 }
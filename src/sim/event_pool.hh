@@ -0,0 +1,140 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Free list allocator for short-lived, dynamically allocated events and
+ * other per transaction objects (packets and requests).
+ */
+
+#ifndef __SIM_EVENT_POOL_HH__
+#define __SIM_EVENT_POOL_HH__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+/**
+ * Pool of fixed size slots used to allocate events that are created
+ * per transaction and freed with AutoDelete, as well as the packets and
+ * requests of memory transactions. Slots are kept in one free
+ * list per size class and per host thread; since an event queue is
+ * only ever serviced by one thread, this gives each queue its own free
+ * lists without any locking. Memory is taken from the heap in chunks
+ * and is reused, never returned. Objects larger than MaxSize fall back
+ * to the global operator new.
+ */
+class EventPool
+{
+  public:
+    /** Slot sizes are multiples of this many bytes. */
+    static const size_t Granularity = 16;
+    /** Largest object served from the pool. */
+    static const size_t MaxSize = 512;
+    /** Slots carved from each chunk taken from the heap. */
+    static const size_t ChunkSlots = 64;
+
+    static void *
+    allocate(size_t size)
+    {
+        if (size > MaxSize)
+            return ::operator new(size);
+
+        FreeSlot *&head = freeLists[sizeClass(size)];
+        if (!head)
+            refill(sizeClass(size));
+
+        FreeSlot *slot = head;
+        head = slot->next;
+        return slot;
+    }
+
+    static void
+    release(void *p, size_t size)
+    {
+        if (size > MaxSize) {
+            ::operator delete(p);
+            return;
+        }
+
+        FreeSlot *slot = static_cast<FreeSlot *>(p);
+        FreeSlot *&head = freeLists[sizeClass(size)];
+        slot->next = head;
+        head = slot;
+    }
+
+  private:
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    static const size_t NumClasses = MaxSize / Granularity;
+
+    static size_t sizeClass(size_t size) { return (size - 1) / Granularity; }
+
+    /** Add a chunk's worth of slots to the free list of a size class. */
+    static void refill(size_t size_class);
+
+    static __thread FreeSlot *freeLists[NumClasses];
+};
+
+/**
+ * Standard allocator drawing from the EventPool, for the nodes of
+ * containers that grow and shrink with every transaction.  It is
+ * stateless, so containers using it can splice and swap freely.
+ */
+template <class T>
+class EventPoolAllocator : public std::allocator<T>
+{
+  public:
+    template <class U>
+    struct rebind
+    {
+        typedef EventPoolAllocator<U> other;
+    };
+
+    EventPoolAllocator() { }
+    EventPoolAllocator(const EventPoolAllocator &) { }
+    template <class U>
+    EventPoolAllocator(const EventPoolAllocator<U> &) { }
+
+    T *
+    allocate(size_t n, const void *hint = 0)
+    {
+        return static_cast<T *>(EventPool::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, size_t n)
+    {
+        EventPool::release(p, n * sizeof(T));
+    }
+};
+
+#endif // __SIM_EVENT_POOL_HH__
@@ -0,0 +1,196 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/hashmap.hh"
+#include "base/output.hh"
+#include "sim/event_profile.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_exit.hh"
+
+namespace EventProfile
+{
+
+bool enabled = false;
+
+namespace
+{
+
+typedef std::pair<std::string, std::string> Key;
+
+/**
+ * Each thread servicing event queues keeps its own table, so there is
+ * no locking on the way, and the tables are merged at exit. Entries
+ * live in a map and never move, so the cache can point at them.
+ */
+struct Table
+{
+    std::map<Key, Entry> entries;
+    m5::hash_map<const Event *, Entry *> cache;
+};
+
+std::mutex tablesLock;
+std::vector<Table *> tables;
+__thread Table *localTable = NULL;
+
+/** Both clocks at enable(), to convert cycles to host seconds. */
+uint64_t startCycles;
+std::chrono::steady_clock::time_point startTime;
+
+Table &
+local()
+{
+    if (!localTable) {
+        localTable = new Table;
+        std::lock_guard<std::mutex> held(tablesLock);
+        tables.push_back(localTable);
+    }
+    return *localTable;
+}
+
+/**
+ * The owner of an event is its name up to the last dot, e.g. the
+ * CPU for system.cpu.wrapped_event. Events without an owner are
+ * named after their instance, and go together.
+ */
+std::string
+owner(const std::string &name)
+{
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos)
+        return name.substr(0, dot);
+    if (name.compare(0, 6, "Event_") == 0)
+        return "unowned";
+    return name;
+}
+
+void
+dump()
+{
+    uint64_t cycles = now() - startCycles;
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    double per_second = seconds > 0 ? cycles / seconds : 1;
+
+    std::map<Key, Entry> totals;
+    uint64_t total_cycles = 0;
+    {
+        std::lock_guard<std::mutex> held(tablesLock);
+        for (auto table : tables) {
+            for (auto &e : table->entries) {
+                Entry &total = totals[e.first];
+                total.cycles += e.second.cycles;
+                total.count += e.second.count;
+                total_cycles += e.second.cycles;
+            }
+        }
+    }
+
+    std::vector<std::pair<const Key *, const Entry *> > sorted;
+    for (auto &e : totals)
+        sorted.push_back(std::make_pair(&e.first, &e.second));
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<const Key *, const Entry *> &a,
+                 const std::pair<const Key *, const Entry *> &b)
+              { return a.second->cycles > b.second->cycles; });
+
+    std::ostream *summary = simout.create("eventq_profile.txt");
+    ccprintf(*summary, "# %d host cycles per second, %.2f%% of the time "
+             "spent in events\n", (uint64_t)per_second,
+             cycles ? 100.0 * total_cycles / cycles : 0.0);
+    ccprintf(*summary, "# %-14s %12s %10s %7s  %s\n", "cycles", "events",
+             "seconds", "share", "owner (description)");
+    for (auto &e : sorted) {
+        ccprintf(*summary, "%16d %12d %10.3f %6.2f%%  %s (%s)\n",
+                 e.second->cycles, e.second->count,
+                 e.second->cycles / per_second,
+                 total_cycles ? 100.0 * e.second->cycles / total_cycles : 0,
+                 e.first->first, e.first->second);
+    }
+    simout.close(summary);
+
+    // One stack per entry, from the outermost SimObject down to the
+    // description, as taken by flamegraph.pl
+    std::ostream *folded = simout.create("eventq_profile.folded");
+    for (auto &e : totals) {
+        std::string stack = e.first.first;
+        std::replace(stack.begin(), stack.end(), '.', ';');
+        ccprintf(*folded, "%s;%s %d\n", stack, e.first.second,
+                 e.second.cycles);
+    }
+    simout.close(folded);
+}
+
+class DumpCallback : public Callback
+{
+  public:
+    void process() { dump(); }
+};
+
+} // anonymous namespace
+
+void
+enable()
+{
+    if (enabled)
+        return;
+
+    enabled = true;
+    startCycles = now();
+    startTime = std::chrono::steady_clock::now();
+    registerExitCallback(new DumpCallback);
+}
+
+Entry *
+lookup(const Event *event)
+{
+    Table &table = local();
+    auto it = table.cache.find(event);
+    if (it != table.cache.end())
+        return it->second;
+
+    Entry *entry = &table.entries[Key(owner(event->name()),
+                                      event->description())];
+    table.cache[event] = entry;
+    return entry;
+}
+
+void
+forget(const Event *event)
+{
+    if (localTable)
+        localTable->cache.erase(event);
+}
+
+} // namespace EventProfile
@@ -0,0 +1,98 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Optional host-time profile of the event queues. While enabled, the
+ * host cycles spent processing every event are added up per event
+ * description and per owning SimObject, the owner being the event
+ * name up to its last dot. The totals are written to the output
+ * directory at exit, both as a summary and in the folded format
+ * taken by flame graph tools.
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+class Event;
+
+namespace EventProfile
+{
+
+/** Host time spent on the events of one owner and description. */
+struct Entry
+{
+    uint64_t cycles;
+    uint64_t count;
+
+    Entry() : cycles(0), count(0) {}
+};
+
+/** Set while profiling, checked on every event serviced. */
+extern bool enabled;
+
+/**
+ * Start profiling, and register the dump of the results at exit.
+ */
+void enable();
+
+/**
+ * Find the entry an event is accounted to. This has to happen
+ * before the event is processed, as processing may delete it.
+ */
+Entry *lookup(const Event *event);
+
+/**
+ * Forget whatever is cached about an event that goes away.
+ */
+void forget(const Event *event);
+
+/** Host cycle counter, or nanoseconds where there is none. */
+inline uint64_t
+now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+} // namespace EventProfile
+
+#endif // __SIM_EVENT_PROFILE_HH__
@@ -0,0 +1,191 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_wheel.hh"
+
+#include "base/compiler.hh"
+#include "base/intmath.hh"
+#include "base/misc.hh"
+
+EventWheel::EventWheel(unsigned num_slots, Tick _granularity)
+    : slots(ceilPow2(std::max(num_slots, 2U)), NULL),
+      mask(slots.size() - 1), granularity(_granularity),
+      cursor(0), wheelBins(0)
+{
+    if (granularity == 0)
+        fatal("Event queue timing wheel granularity must be non-zero\n");
+}
+
+void
+EventWheel::linkBin(Event *&list, Event *bin)
+{
+    if (!list || *bin < *list) {
+        bin->nextBin = list;
+        list = bin;
+        return;
+    }
+
+    Event *prev = list;
+    while (prev->nextBin && *prev->nextBin < *bin)
+        prev = prev->nextBin;
+
+    assert(!prev->nextBin || *prev->nextBin != *bin);
+    bin->nextBin = prev->nextBin;
+    prev->nextBin = bin;
+}
+
+void
+EventWheel::addBin(Event *bin)
+{
+    if (onWheel(bin->when())) {
+        linkBin(slotFor(bin->when()), bin);
+        ++wheelBins;
+    } else {
+        bin->nextBin = NULL;
+        bool inserted M5_VAR_USED = far.insert(bin).second;
+        assert(inserted);
+    }
+}
+
+void
+EventWheel::advance()
+{
+    if (!wheelBins) {
+        if (far.empty())
+            return;
+
+        // Nothing on the wheel: jump straight to the first overflow bin.
+        cursor = absSlot((*far.begin())->when());
+    } else {
+        while (!slots[cursor & mask])
+            ++cursor;
+    }
+
+    while (!far.empty() && onWheel((*far.begin())->when())) {
+        Event *bin = *far.begin();
+        far.erase(far.begin());
+        linkBin(slotFor(bin->when()), bin);
+        ++wheelBins;
+    }
+}
+
+void
+EventWheel::insert(Event *event)
+{
+    if (onWheel(event->when())) {
+        if (Event::insertInList(slotFor(event->when()), event))
+            ++wheelBins;
+    } else {
+        auto it = far.find(event);
+        if (it == far.end()) {
+            event->nextInBin = NULL;
+        } else {
+            // Push onto the existing bin's stack, like insertBefore().
+            event->nextInBin = *it;
+            far.erase(it);
+        }
+        event->nextBin = NULL;
+        far.insert(event);
+    }
+
+    if (!slots[cursor & mask])
+        advance();
+}
+
+void
+EventWheel::remove(Event *event)
+{
+    if (onWheel(event->when())) {
+        if (Event::removeFromList(slotFor(event->when()), event))
+            --wheelBins;
+    } else {
+        auto it = far.find(event);
+        if (it == far.end())
+            panic("event not found!");
+
+        Event *top = *it;
+        Event *new_top = Event::removeItem(event, top);
+        if (new_top != top) {
+            far.erase(it);
+            if (new_top)
+                far.insert(new_top);
+        }
+    }
+
+    if (!slots[cursor & mask])
+        advance();
+}
+
+void
+EventWheel::popFront()
+{
+    Event *&slot = slots[cursor & mask];
+    Event *top = slot;
+    assert(top);
+
+    if (top->nextInBin) {
+        top->nextInBin->nextBin = top->nextBin;
+        slot = top->nextInBin;
+    } else {
+        slot = top->nextBin;
+        --wheelBins;
+        if (!slot)
+            advance();
+    }
+}
+
+Event *
+EventWheel::release()
+{
+    Event *list = NULL;
+    Event **tail = &list;
+    forEachBin([&tail](Event *bin) {
+        *tail = bin;
+        tail = &bin->nextBin;
+    });
+    *tail = NULL;
+
+    std::fill(slots.begin(), slots.end(), (Event *)NULL);
+    far.clear();
+    wheelBins = 0;
+    return list;
+}
+
+void
+EventWheel::absorb(Event *list)
+{
+    assert(!front() && far.empty());
+
+    while (list) {
+        Event *bin = list;
+        list = list->nextBin;
+        addBin(bin);
+    }
+
+    if (!slots[cursor & mask])
+        advance();
+}
@@ -0,0 +1,155 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Timing wheel backend for EventQueue. Bins (events sharing a when and
+ * priority) close to the current time live in a circular array of
+ * slots, each slot holding a short sorted list of bins; bins beyond the
+ * wheel's horizon are kept in an ordered overflow set and migrate onto
+ * the wheel as time advances. Bins themselves are the same LIFO stacks
+ * (linked through Event::nextInBin) used by the linked list backend,
+ * so both backends service events in exactly the same order.
+ */
+
+#ifndef __SIM_EVENT_WHEEL_HH__
+#define __SIM_EVENT_WHEEL_HH__
+
+#include <set>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+class EventWheel
+{
+  private:
+    struct BinLess
+    {
+        bool
+        operator()(const Event *l, const Event *r) const
+        {
+            return *l < *r;
+        }
+    };
+
+    /** Top event of the first bin in each slot, or NULL. */
+    std::vector<Event *> slots;
+    /** Mask used to map an absolute slot number to a slot. */
+    const uint64_t mask;
+    /** Number of ticks covered by a slot. */
+    const Tick granularity;
+
+    /**
+     * Absolute slot number of the earliest bin. Whenever the wheel
+     * holds any bin, this slot is non-empty.
+     */
+    uint64_t cursor;
+    /** Number of bins currently on the wheel. */
+    size_t wheelBins;
+
+    /** Bins too far in the future for the wheel, keyed by their top. */
+    std::set<Event *, BinLess> far;
+
+    uint64_t absSlot(Tick when) const { return when / granularity; }
+
+    bool
+    onWheel(Tick when) const
+    {
+        return absSlot(when) < cursor + slots.size();
+    }
+
+    /**
+     * Slot holding bins for the given time. Times behind the cursor
+     * (events scheduled before the earliest pending one) share the
+     * cursor's slot, where the sorted slot list keeps them in order.
+     */
+    Event *&
+    slotFor(Tick when)
+    {
+        uint64_t slot = std::max(absSlot(when), cursor);
+        return slots[slot & mask];
+    }
+
+    /** Link a complete bin into the sorted bin list of a slot. */
+    static void linkBin(Event *&list, Event *bin);
+
+    /** Place a complete bin on the wheel or in the overflow set. */
+    void addBin(Event *bin);
+
+    /**
+     * Move the cursor to the next non-empty slot, pulling overflow
+     * bins onto the wheel as its horizon moves.
+     */
+    void advance();
+
+  public:
+    /**
+     * @param num_slots Number of slots, rounded up to a power of two.
+     * @param granularity Ticks covered by each slot.
+     */
+    EventWheel(unsigned num_slots, Tick granularity);
+
+    /** Top event of the earliest bin, or NULL if empty. */
+    Event *
+    front() const
+    {
+        return wheelBins ? slots[cursor & mask] : NULL;
+    }
+
+    void insert(Event *event);
+    void remove(Event *event);
+
+    /** Remove the event returned by front(). */
+    void popFront();
+
+    /**
+     * Empty the wheel, returning its contents as a linked list of bins
+     * in the format used by the linked list backend.
+     */
+    Event *release();
+
+    /** Insert all bins of a linked list of bins into an empty wheel. */
+    void absorb(Event *list);
+
+    /** Call f with the top event of every bin, in service order. */
+    template <class F>
+    void
+    forEachBin(F f) const
+    {
+        for (uint64_t i = 0; wheelBins && i < slots.size(); ++i) {
+            for (Event *bin = slots[(cursor + i) & mask]; bin;
+                 bin = bin->nextBin) {
+                f(bin);
+            }
+        }
+        for (auto bin : far)
+            f(bin);
+    }
+};
+
+#endif // __SIM_EVENT_WHEEL_HH__
@@ -43,12 +43,34 @@
 #include "cpu/smt.hh"
 #include "debug/Config.hh"
 #include "sim/core.hh"
+#include "sim/event_profile.hh"
+#include "sim/event_wheel.hh"
 #include "sim/eventq_impl.hh"
 
 using namespace std;
 
 Tick simQuantum = 0;
 
+//! Set once simQuantum has been picked by limitSimQuantum().
+static bool quantumFromLookahead = false;
+
+void
+limitSimQuantum(Tick lookahead, const std::string &who)
+{
+    if (lookahead == 0)
+        fatal("%s crosses event queues and needs a non-zero latency\n", who);
+
+    if (simQuantum == 0 || quantumFromLookahead) {
+        if (simQuantum == 0 || lookahead < simQuantum)
+            simQuantum = lookahead;
+        quantumFromLookahead = true;
+    } else if (simQuantum > lookahead) {
+        fatal("%s: latency of %d ticks across event queues is shorter than "
+              "the simulation quantum (%d ticks)\n", who, lookahead,
+              simQuantum);
+    }
+}
+
 //
 // Main Event Queues
 //
@@ -60,18 +82,48 @@ vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+static EventQueue::Backend mainBackend = EventQueue::LinkedList;
+static unsigned mainWheelSlots = 0;
+static Tick mainWheelGranularity = 0;
+static uint64_t mainRandomSeed = 5489;
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
     while (numMainEventQueues <= index) {
         numMainEventQueues++;
-        mainEventQueue.push_back(
-            new EventQueue(csprintf("MainEventQueue-%d", index)));
+        EventQueue *eq = new EventQueue(csprintf("MainEventQueue-%d", index));
+        eq->random().init(mainRandomSeed, index);
+        if (mainBackend != EventQueue::LinkedList)
+            eq->setBackend(mainBackend, mainWheelSlots, mainWheelGranularity);
+        mainEventQueue.push_back(eq);
     }
 
     return mainEventQueue[index];
 }
 
+void
+setMainEventQueueBackend(EventQueue::Backend backend, unsigned wheel_slots,
+                         Tick wheel_granularity)
+{
+    mainBackend = backend;
+    mainWheelSlots = wheel_slots;
+    mainWheelGranularity = wheel_granularity;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setBackend(backend, wheel_slots, wheel_granularity);
+}
+
+void
+seedMainEventQueues(uint64_t seed)
+{
+    mainRandomSeed = seed;
+    initRandom.init(seed);
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->random().init(seed, i);
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -80,6 +132,9 @@ Event::~Event()
 {
     assert(!scheduled());
     flags = 0;
+
+    if (EventProfile::enabled)
+        EventProfile::forget(this);
 }
 
 const std::string
@@ -114,19 +169,20 @@ Event::insertBefore(Event *event, Event *curr)
     return event;
 }
 
-void
-EventQueue::insert(Event *event)
+bool
+Event::insertInList(Event *&list, Event *event)
 {
     // Deal with the head case
-    if (!head || *event <= *head) {
-        head = Event::insertBefore(event, head);
-        return;
+    if (!list || *event <= *list) {
+        bool new_bin = !list || *event != *list;
+        list = Event::insertBefore(event, list);
+        return new_bin;
     }
 
     // Figure out either which 'in bin' list we are on, or where a new list
     // needs to be inserted
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = list;
+    Event *curr = list->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -134,7 +190,20 @@ EventQueue::insert(Event *event)
 
     // Note: this operation may render all nextBin pointers on the
     // prev 'in bin' list stale (except for the top one)
+    bool new_bin = !curr || *event != *curr;
     prev->nextBin = Event::insertBefore(event, curr);
+    return new_bin;
+}
+
+void
+EventQueue::insert(Event *event)
+{
+    if (wheel) {
+        wheel->insert(event);
+        head = wheel->front();
+    } else {
+        Event::insertInList(head, event);
+    }
 }
 
 Event *
@@ -168,24 +237,23 @@ Event::removeItem(Event *event, Event *top)
     return top;
 }
 
-void
-EventQueue::remove(Event *event)
+bool
+Event::removeFromList(Event *&list, Event *event)
 {
-    if (head == NULL)
+    if (list == NULL)
         panic("event not found!");
 
-    assert(event->queue == this);
-
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
-    if (*head == *event) {
-        head = Event::removeItem(event, head);
-        return;
+    if (*list == *event) {
+        bool empty_bin = event == list && !event->nextInBin;
+        list = Event::removeItem(event, list);
+        return empty_bin;
     }
 
     // Find the 'in bin' list that this event belongs on
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = list;
+    Event *curr = list->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -197,7 +265,22 @@ EventQueue::remove(Event *event)
     // curr points to the top item of the the correct 'in bin' list, when
     // we remove an item, it returns the new top item (which may be
     // unchanged)
+    bool empty_bin = event == curr && !event->nextInBin;
     prev->nextBin = Event::removeItem(event, curr);
+    return empty_bin;
+}
+
+void
+EventQueue::remove(Event *event)
+{
+    assert(event->queue == this);
+
+    if (wheel) {
+        wheel->remove(event);
+        head = wheel->front();
+    } else {
+        Event::removeFromList(head, event);
+    }
 }
 
 Event *
@@ -208,7 +291,10 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (wheel) {
+        wheel->popFront();
+        head = wheel->front();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -225,7 +311,16 @@ EventQueue::serviceOne()
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
 
-        event->process();
+        if (EventProfile::enabled) {
+            // Look the entry up first, processing may delete the event
+            EventProfile::Entry *entry = EventProfile::lookup(event);
+            uint64_t start = EventProfile::now();
+            event->process();
+            entry->cycles += EventProfile::now() - start;
+            entry->count++;
+        } else {
+            event->process();
+        }
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::AutoDelete) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -289,14 +384,25 @@ Event::unserialize(Checkpoint *cp, const string &section, EventQueue *eventq)
     }
 }
 
+template <class F>
+void
+EventQueue::forEachBin(F f) const
+{
+    if (wheel) {
+        wheel->forEachBin(f);
+    } else {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            f(bin);
+    }
+}
+
 void
 EventQueue::serialize(ostream &os)
 {
     std::list<Event *> eventPtrs;
 
     int numEvents = 0;
-    Event *nextBin = head;
-    while (nextBin) {
+    forEachBin([&](Event *nextBin) {
         Event *nextInBin = nextBin;
 
         while (nextInBin) {
@@ -307,9 +413,7 @@ EventQueue::serialize(ostream &os)
             }
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
-    }
+    });
 
     SERIALIZE_SCALAR(numEvents);
 
@@ -346,16 +450,13 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        forEachBin([](Event *nextBin) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
-        }
+        });
     }
 
     cprintf("============================================================\n");
@@ -368,26 +469,24 @@ EventQueue::debugVerify() const
 
     Tick time = 0;
     short priority = 0;
+    bool ok = true;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    forEachBin([&](Event *nextBin) {
         Event *nextInBin = nextBin;
-        while (nextInBin) {
+        while (ok && nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
                 nextInBin->dump();
-                return false;
+                ok = false;
             } else if (nextInBin->when() == time &&
                        nextInBin->priority() < priority) {
                 cprintf("priority inverted!");
                 nextInBin->dump();
-                return false;
-            }
-
-            if (map[reinterpret_cast<long>(nextInBin)]) {
+                ok = false;
+            } else if (map[reinterpret_cast<long>(nextInBin)]) {
                 cprintf("Node already seen");
                 nextInBin->dump();
-                return false;
+                ok = false;
             }
             map[reinterpret_cast<long>(nextInBin)] = true;
 
@@ -396,21 +495,49 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
+    });
 
-        nextBin = nextBin->nextBin;
-    }
-
-    return true;
+    return ok;
 }
 
 Event*
 EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
-    head = s;
+    if (wheel) {
+        // Hand out (and take back) the contents in the linked list
+        // format so callers can't tell which backend is in use.
+        t = wheel->release();
+        wheel->absorb(s);
+        head = wheel->front();
+    } else {
+        head = s;
+    }
     return t;
 }
 
+void
+EventQueue::setBackend(Backend backend, unsigned wheel_slots,
+                       Tick wheel_granularity)
+{
+    Event *list = wheel ? wheel->release() : head;
+    delete wheel;
+    wheel = NULL;
+
+    if (backend == TimingWheel) {
+        wheel = new EventWheel(wheel_slots, wheel_granularity);
+        wheel->absorb(list);
+        head = wheel->front();
+    } else {
+        head = list;
+    }
+}
+
+EventQueue::~EventQueue()
+{
+    delete wheel;
+}
+
 void
 dumpMainQueue()
 {
@@ -460,28 +587,42 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), wheel(NULL), _curTick(0), async_queue(NULL)
 {
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    Event *top = async_queue.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = top;
+    } while (!async_queue.compare_exchange_weak(top, event,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    // Take all pending events at once and reverse the stack so they are
+    // inserted in the order they were scheduled.
+    Event *stack = async_queue.exchange(NULL, std::memory_order_acquire);
+    Event *pending = NULL;
+    while (stack) {
+        Event *next = stack->nextBin;
+        stack->nextBin = pending;
+        pending = stack;
+        stack = next;
+    }
+
+    while (pending) {
+        Event *event = pending;
+        pending = pending->nextBin;
+        insert(event);
     }
 
-    async_queue_mutex.unlock();
+    asyncCallbacks.process();
 }
@@ -39,6 +39,7 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <iosfwd>
@@ -46,13 +47,17 @@
 #include <mutex>
 #include <string>
 
+#include "base/callback.hh"
 #include "base/flags.hh"
 #include "base/misc.hh"
+#include "base/random.hh"
 #include "base/types.hh"
 #include "debug/Event.hh"
+#include "sim/event_pool.hh"
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
+class EventWheel;
 class BaseGlobalEvent;
 
 //! Simulation Quantum for multiple eventq simulation.
@@ -62,6 +67,12 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Declare that an object passes work from one event queue to another
+//! with at least the given latency, which bounds the quantum. The
+//! quantum is picked as the shortest such latency, unless the
+//! configuration set one, which must then not be longer.
+void limitSimQuantum(Tick lookahead, const std::string &who);
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -86,7 +97,7 @@ extern bool inParallelMode;
 EventQueue *getEventQueue(uint32_t index);
 
 inline EventQueue *curEventQueue() { return _curEventQueue; }
-inline void curEventQueue(EventQueue *q) { _curEventQueue = q; }
+inline void curEventQueue(EventQueue *q);
 
 /**
  * Common base class for Event and GlobalEvent, so they can share flag
@@ -183,6 +194,7 @@ class EventBase
 class Event : public EventBase, public Serializable
 {
     friend class EventQueue;
+    friend class EventWheel;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -200,6 +212,13 @@ class Event : public EventBase, public Serializable
     static Event *insertBefore(Event *event, Event *curr);
     static Event *removeItem(Event *event, Event *last);
 
+    /**
+     * Insert into / remove from a sorted linked list of bins. These
+     * return true if a bin was created / emptied.
+     */
+    static bool insertInList(Event *&list, Event *event);
+    static bool removeFromList(Event *&list, Event *event);
+
     Tick _when;         //!< timestamp when event should be processed
     Priority _priority; //!< event priority
     Flags flags;
@@ -401,6 +420,33 @@ operator!=(const Event &l, const Event &r)
 {
     return l.when() != r.when() || l.priority() != r.priority();
 }
+
+/**
+ * Base for event types that are allocated dynamically and freed with
+ * AutoDelete at a high rate (e.g., one per memory transaction). Their
+ * instances are allocated from the EventPool free lists instead of the
+ * general purpose heap.
+ *
+ * class WritebackEvent : public PooledEvent<> { ... };
+ */
+template <class Base = Event>
+class PooledEvent : public Base
+{
+  public:
+    using Base::Base;
+
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(p, size);
+    }
+};
 #endif
 
 /**
@@ -446,13 +492,23 @@ class EventQueue : public Serializable
   private:
     std::string objName;
     Event *head;
+    //! Timing wheel holding the events, or NULL if they are kept in
+    //! the linked list starting at head. With a wheel, head caches the
+    //! wheel's front event.
+    EventWheel *wheel;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    std::mutex async_queue_mutex;
+    //! Random number stream of the objects serviced by this queue.
+    Random rng;
+
+    //! Events added by other threads to this event queue. This is a
+    //! lock-free stack linked through Event::nextBin (unused until the
+    //! event is inserted), pushed by any thread and taken as a whole by
+    //! the owning thread.
+    std::atomic<Event *> async_queue;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Callbacks run by handleAsyncInsertions().
+    CallbackQueue asyncCallbacks;
 
     /**
      * Lock protecting event handling.
@@ -488,7 +544,23 @@ class EventQueue : public Serializable
 
     EventQueue(const EventQueue &);
 
+    //! Call f with the top event of every bin, in service order.
+    template <class F>
+    void forEachBin(F f) const;
+
   public:
+    /**
+     * Data structure used to keep pending events. The linked list
+     * makes insertion linear in the number of distinct (when,
+     * priority) bins; the timing wheel makes it roughly constant for
+     * events within the wheel's horizon. Events are serviced in the
+     * same order with either backend.
+     */
+    enum Backend {
+        LinkedList,
+        TimingWheel
+    };
+
 #ifndef SWIG
     /**
      * Temporarily migrate execution to a different event queue.
@@ -553,6 +625,12 @@ class EventQueue : public Serializable
 
     EventQueue(const std::string &n);
 
+    //! Switch to a different backend, keeping all pending events.
+    //! wheel_slots and wheel_granularity (ticks per slot) size the
+    //! timing wheel.
+    void setBackend(Backend backend, unsigned wheel_slots = 4096,
+                    Tick wheel_granularity = 1000);
+
     virtual const std::string name() const { return objName; }
     void name(const std::string &st) { objName = st; }
 
@@ -572,6 +650,8 @@ class EventQueue : public Serializable
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() { return _curTick; }
 
+    Random &random() { return rng; }
+
     Event *serviceOne();
 
     // process all events up to the given timestamp.  we inline a
@@ -598,6 +678,14 @@ class EventQueue : public Serializable
     // return true if no events are queued
     bool empty() const { return head == NULL; }
 
+    // return the global event the next event is the local part of, if
+    // any
+    BaseGlobalEvent *
+    nextGlobalEvent() const
+    {
+        return empty() ? NULL : head->globalEvent();
+    }
+
     void dump() const;
 
     bool debugVerify() const;
@@ -605,6 +693,13 @@ class EventQueue : public Serializable
     //! Function for moving events from the async_queue to the main queue.
     void handleAsyncInsertions();
 
+    //! Register a callback to be run by handleAsyncInsertions(), on
+    //! the thread servicing this queue, once the asynchronous events
+    //! are inserted. Callbacks run in the order they were registered,
+    //! which lets cross-queue components hand over work between
+    //! quanta deterministically.
+    void registerAsyncCallback(Callback *cb) { asyncCallbacks.add(cb); }
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -651,11 +746,29 @@ class EventQueue : public Serializable
     virtual void unserialize(Checkpoint *cp, const std::string &section);
 #endif
 
-    virtual ~EventQueue() { }
+    virtual ~EventQueue();
 };
 
 void dumpMainQueue();
 
+//! Select the backend of all current and future main event queues.
+void setMainEventQueueBackend(EventQueue::Backend backend,
+                              unsigned wheel_slots, Tick wheel_granularity);
+
+//! Restart the random streams of all current and future main event
+//! queues from the given seed. Queue i draws from stream i, so runs
+//! are reproducible for a given seed and partitioning.
+void seedMainEventQueues(uint64_t seed);
+
+#ifndef SWIG
+inline void
+curEventQueue(EventQueue *q)
+{
+    _curEventQueue = q;
+    curRandom(q ? &q->random() : NULL);
+}
+#endif
+
 #ifndef SWIG
 class EventManager
 {
@@ -722,14 +835,14 @@ template <class T, void (T::* F)()>
 void
 DelayFunction(EventQueue *eventq, Tick when, T *object)
 {
-    class DelayEvent : public Event
+    class DelayEvent : public PooledEvent<>
     {
       private:
         T *object;
 
       public:
         DelayEvent(T *o)
-            : Event(Default_Pri, AutoDelete), object(o)
+            : PooledEvent<>(Default_Pri, AutoDelete), object(o)
         { }
         void process() { (object->*F)(); }
         const char *description() const { return "delay"; }
@@ -31,7 +31,11 @@
 
 #include "sim/global_event.hh"
 
+#include "sim/quantum.hh"
+
 std::mutex BaseGlobalEvent::globalQMutex;
+bool BaseGlobalEvent::pooled = false;
+bool BaseGlobalEvent::poolLeader = false;
 
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
     : barrier(numMainEventQueues),
@@ -140,6 +144,14 @@ GlobalEvent::BarrierEvent::process()
 void
 GlobalSyncEvent::BarrierEvent::process()
 {
+    // a pool accounts for its workers around the whole round, and
+    // inserts the async events once it hands the queue out again
+    QuantumController *controller = pooled ? NULL :
+        static_cast<GlobalSyncEvent *>(_globalEvent)->controller;
+
+    if (controller)
+        controller->arrive();
+
     // wait for all queues to arrive at barrier, then process event
     if (globalBarrier()) {
         _globalEvent->process();
@@ -148,12 +160,23 @@ GlobalSyncEvent::BarrierEvent::process()
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
     globalBarrier();
-    curEventQueue()->handleAsyncInsertions();
+    if (!pooled)
+        curEventQueue()->handleAsyncInsertions();
+
+    if (controller)
+        controller->depart();
 }
 
 void
 GlobalSyncEvent::process()
 {
+    if (controller) {
+        // the other threads wait at the barrier, so the quantum can
+        // change under them
+        repeat = controller->sync(repeat);
+        simQuantum = repeat;
+    }
+
     if (repeat) {
         schedule(curTick() + repeat);
     }
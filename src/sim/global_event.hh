@@ -56,6 +56,8 @@
  * synchronization operations.
  */
 
+class QuantumController;
+
 /**
  * Common base class for GlobalEvent and GlobalSyncEvent.
  */
@@ -99,6 +101,11 @@ class BaseGlobalEvent : public EventBase
             // locked when entering this method. We need to unlock it
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
+            if (pooled) {
+                // One thread services the barrier events of all
+                // queues in turn, see QueuePool.
+                return poolLeader;
+            }
             EventQueue::ScopedRelease release(curEventQueue());
             return _globalEvent->barrier.wait();
         }
@@ -115,6 +122,15 @@ class BaseGlobalEvent : public EventBase
     std::vector<BarrierEvent *> barrierEvent;
 
   public:
+    //! Set when a QueuePool runs the event queues. The pool leader
+    //! then services the barrier events of every queue on its own
+    //! thread, so globalBarrier() must not block.
+    static bool pooled;
+
+    //! Set by the pool leader while servicing the barrier event of
+    //! the last queue, which therefore performs the global event.
+    static bool poolLeader;
+
     BaseGlobalEvent(Priority p, Flags f);
 
     virtual ~BaseGlobalEvent();
@@ -219,11 +235,11 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     };
 
     GlobalSyncEvent(Priority p, Flags f)
-        : Base(p, f)
+        : Base(p, f), controller(NULL)
     { }
 
     GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f)
-        : Base(p, f), repeat(_repeat)
+        : Base(p, f), repeat(_repeat), controller(NULL)
     {
         schedule(when);
     }
@@ -233,6 +249,10 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     const char *description() const;
 
     Tick repeat;
+
+    /// If set, the event ends the quanta of simulate(): it measures
+    /// the barriers and lets the controller pick the next repeat.
+    QuantumController *controller;
 };
 
 
@@ -0,0 +1,88 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/guest_roi.hh"
+
+#include "base/misc.hh"
+#include "base/trace.hh"
+#include "debug/PseudoInst.hh"
+#include "sim/core.hh"
+
+GuestROI guestROI;
+
+GuestROI::Context &
+GuestROI::context(int ctx)
+{
+    assert(ctx >= 0);
+    if (ctx >= (int)contexts.size())
+        contexts.resize(ctx + 1);
+    return contexts[ctx];
+}
+
+void
+GuestROI::begin(int ctx, uint64_t id)
+{
+    Context &state = context(ctx);
+
+    DPRINTF(PseudoInst, "Context %d begins ROI %d at depth %d\n",
+            ctx, id, state.depth);
+
+    state.depth++;
+    state.roiId = id;
+}
+
+void
+GuestROI::end(int ctx, uint64_t id)
+{
+    Context &state = context(ctx);
+
+    if (state.depth == 0) {
+        warn("Context %d ends ROI %d outside of any region\n", ctx, id);
+        return;
+    }
+
+    if (id != state.roiId) {
+        warn("Context %d ends ROI %d inside ROI %d\n", ctx, id,
+             state.roiId);
+    }
+
+    DPRINTF(PseudoInst, "Context %d ends ROI %d\n", ctx, id);
+
+    state.depth--;
+}
+
+void
+GuestROI::armFault(int ctx, uint64_t id)
+{
+    Context &state = context(ctx);
+
+    DPRINTF(PseudoInst, "Context %d arms fault injection %d\n", ctx, id);
+
+    state.fiArmed = true;
+    state.fiId = id;
+    state.fiArmedAt = curTick();
+}
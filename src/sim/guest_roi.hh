@@ -0,0 +1,101 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_GUEST_ROI_HH__
+#define __SIM_GUEST_ROI_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Regions of interest and fault injection arming marked by the guest
+ * with the roi_begin, roi_end and fi_arm m5 ops rather than found by
+ * symbol in debugRegionMap.  Each context keeps a flag that the CPU
+ * models can test instead of looking up the PC, so workloads without
+ * symbols still have regions and tracking them costs nothing per cycle.
+ *
+ * The state is not checkpointed: a restored guest is outside any
+ * region until it marks one again.
+ */
+class GuestROI
+{
+  public:
+    /** Marker state of one context */
+    struct Context
+    {
+        /** Nesting depth of the regions begun and not yet ended */
+        unsigned depth;
+        /** ID of the last region begun */
+        uint64_t roiId;
+        /** Has fi_arm been executed */
+        bool fiArmed;
+        /** ID given to the last fi_arm */
+        uint64_t fiId;
+        /** When fi_arm was last executed */
+        Tick fiArmedAt;
+
+        Context() : depth(0), roiId(0), fiArmed(false), fiId(0),
+            fiArmedAt(0)
+        { }
+    };
+
+  protected:
+    /** By context id, grown as contexts execute markers */
+    std::vector<Context> contexts;
+
+    Context &context(int ctx);
+
+  public:
+    /** Enter region id */
+    void begin(int ctx, uint64_t id);
+
+    /** Leave region id, which should be the innermost one */
+    void end(int ctx, uint64_t id);
+
+    /** Allow fault injection from now on, id labels the trigger */
+    void armFault(int ctx, uint64_t id);
+
+    /** Is ctx inside a region of interest */
+    bool
+    inROI(int ctx) const
+    {
+        return ctx < contexts.size() && contexts[ctx].depth != 0;
+    }
+
+    /** Has fault injection been armed on ctx */
+    bool
+    fiArmed(int ctx) const
+    {
+        return ctx < contexts.size() && contexts[ctx].fiArmed;
+    }
+};
+
+/** The markers of all the simulated contexts */
+extern GuestROI guestROI;
+
+#endif // __SIM_GUEST_ROI_HH__
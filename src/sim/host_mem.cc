@@ -0,0 +1,142 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/hostinfo.hh"
+#include "base/loader/symtab.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "sim/host_mem.hh"
+#include "sim/sim_exit.hh"
+#include "sim/sim_object.hh"
+
+namespace HostMem
+{
+
+namespace
+{
+
+/** A SimObject or table being accounted for */
+struct Source
+{
+    std::string name;
+    std::function<uint64_t()> usage;
+};
+
+/** Fixed once registered, as the stats point at the functions */
+std::vector<Source> sources;
+
+uint64_t
+totalUsage()
+{
+    uint64_t total = 0;
+    for (auto &s : sources)
+        total += s.usage();
+    return total;
+}
+
+void
+dump()
+{
+    std::vector<std::pair<uint64_t, const std::string *> > sorted;
+    for (auto &s : sources) {
+        uint64_t bytes = s.usage();
+        if (bytes)
+            sorted.push_back(std::make_pair(bytes, &s.name));
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<uint64_t, const std::string *> &a,
+                 const std::pair<uint64_t, const std::string *> &b)
+              { return a.first > b.first; });
+
+    uint64_t total = totalUsage();
+
+    std::ostream *summary = simout.create("host_mem.txt");
+    ccprintf(*summary, "# %d bytes accounted to objects, of %d kB of "
+             "virtual memory in the process\n", total, memUsage());
+    ccprintf(*summary, "# %14s %7s  %s\n", "bytes", "share", "object");
+    for (auto &e : sorted) {
+        ccprintf(*summary, "%16d %6.2f%%  %s\n", e.first,
+                 100.0 * e.first / total, *e.second);
+    }
+    simout.close(summary);
+}
+
+class DumpCallback : public Callback
+{
+  public:
+    void process() { dump(); }
+};
+
+} // anonymous namespace
+
+void
+regStats()
+{
+    if (!sources.empty())
+        return;
+
+    for (auto obj : SimObject::simObjectList) {
+        sources.push_back(Source{obj->name(),
+                                 [obj]() { return obj->hostMemUsage(); }});
+    }
+
+    if (debugSymbolTable) {
+        SymbolTable *symtab = debugSymbolTable;
+        sources.push_back(Source{"debugSymbolTable",
+                                 [symtab]() {
+                                     return symtab->hostMemUsage();
+                                 }});
+    }
+
+    for (auto &s : sources) {
+        Stats::Value *stat = new Stats::Value;
+        stat->functor(s.usage)
+            .name("hostMem." + s.name)
+            .desc("Bytes of host memory taken by the tables of the object")
+            .precision(0)
+            .flags(Stats::nozero)
+            ;
+    }
+
+    Stats::Value *total = new Stats::Value;
+    total->functor(totalUsage)
+        .name("hostMem.total")
+        .desc("Bytes of host memory accounted to objects")
+        .precision(0)
+        ;
+
+    registerExitCallback(new DumpCallback);
+}
+
+} // namespace HostMem
@@ -0,0 +1,57 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Optional accounting of the host memory taken by the simulated
+ * system. Every SimObject reports the size of its large tables
+ * through SimObject::hostMemUsage(), and the symbol table is counted
+ * on its own. The sizes are published as hostMem.<object> stats,
+ * which are only printed for objects that report something, and a
+ * summary sorted by size is written to the output directory at exit.
+ * The accounting is an estimate from the sizes of the tables, not a
+ * measure of the allocator, so it is only as complete as the objects
+ * that report.
+ */
+
+#ifndef __SIM_HOST_MEM_HH__
+#define __SIM_HOST_MEM_HH__
+
+namespace HostMem
+{
+
+/**
+ * Register the hostMem stats of all the SimObjects, and the summary
+ * at exit. Called from Root::regStats() when accounting was asked
+ * for, once every SimObject has been created.
+ */
+void regStats();
+
+} // namespace HostMem
+
+#endif // __SIM_HOST_MEM_HH__
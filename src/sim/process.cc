@@ -49,7 +49,9 @@
 #include <cstdio>
 #include <string>
 
+#include "base/chunk_generator.hh"
 #include "base/loader/object_file.hh"
+#include "base/loader/region_map.hh"
 #include "base/loader/symtab.hh"
 #include "base/intmath.hh"
 #include "base/statistics.hh"
@@ -92,6 +94,22 @@ using namespace TheISA;
 // current number of allocated processes
 int num_processes = 0;
 
+/** 64 bit FNV-1a, seeded with the hash so far */
+static uint64_t
+digestBytes(uint64_t hash, const void *bytes, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(bytes);
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= ULL(1099511628211);
+    }
+
+    return hash;
+}
+
+static const uint64_t digestSeed = ULL(14695981039346656037);
+
 template<class IntType>
 AuxVector<IntType>::AuxVector(IntType type, IntType val)
 {
@@ -110,8 +128,11 @@ Process::Process(ProcessParams * params)
       M5_pid(system->allocatePID()),
       useArchPT(params->useArchPT),
       kvmInSE(params->kvmInSE),
+      outputHash(digestSeed),
       pTable(useArchPT ?
         static_cast<PageTableBase *>(new ArchPageTable(name(), M5_pid, system)) :
+        params->useRadixPT ?
+        static_cast<PageTableBase *>(new RadixPageTable(name(), M5_pid)) :
         static_cast<PageTableBase *>(new FuncPageTable(name(), M5_pid)) ),
       initVirtMem(system->getSystemPort(), this,
                   SETranslatingPortProxy::Always)
@@ -507,6 +528,31 @@ Process::FdMap::unserialize(Checkpoint *cp, const std::string &section)
     UNSERIALIZE_SCALAR(fileOffset);
 }
 
+void
+Process::digestOutput(int tgt_fd, const void *buf, int size)
+{
+    if (tgt_fd == STDOUT_FILENO || tgt_fd == STDERR_FILENO)
+        outputHash = digestBytes(outputHash, buf, size);
+}
+
+uint64_t
+Process::memoryDigest(Addr vaddr, Addr size)
+{
+    uint64_t hash = digestSeed;
+    uint8_t page[TheISA::PageBytes];
+    const uint8_t unmapped = 0xff;
+
+    for (ChunkGenerator gen(vaddr, size, TheISA::PageBytes);
+         !gen.done(); gen.next()) {
+        if (initVirtMem.tryReadBlob(gen.addr(), page, gen.size()))
+            hash = digestBytes(hash, page, gen.size());
+        else
+            hash = digestBytes(hash, &unmapped, sizeof(unmapped));
+    }
+
+    return hash;
+}
+
 void
 Process::serialize(std::ostream &os)
 {
@@ -526,6 +572,7 @@ Process::serialize(std::ostream &os)
         fd_map[x].serialize(os);
     }
     SERIALIZE_SCALAR(M5_pid);
+    SERIALIZE_SCALAR(outputHash);
 
 }
 
@@ -547,6 +594,7 @@ Process::unserialize(Checkpoint *cp, const std::string &section)
     }
     fix_file_offsets();
     UNSERIALIZE_OPT_SCALAR(M5_pid);
+    UNSERIALIZE_OPT_SCALAR(outputHash);
     // The above returns a bool so that you could do something if you don't
     // find the param in the checkpoint if you wanted to, like set a default
     // but in this case we'll just stick with the instantianted value if not
@@ -589,6 +637,8 @@ LiveProcess::LiveProcess(LiveProcessParams *params, ObjectFile *_objFile)
             // didn't load any symbols
             delete debugSymbolTable;
             debugSymbolTable = NULL;
+        } else {
+            debugRegionMap.build(*debugSymbolTable);
         }
     }
 }
@@ -128,8 +128,11 @@ class Process : public SimObject
 
     // flag for using architecture specific page table
     bool useArchPT;
+
     // running KvmCPU in SE mode requires special initialization
     bool kvmInSE;
+    // digest of target output to stdout and stderr
+    uint64_t outputHash;
 
     PageTableBase* pTable;
 
@@ -233,6 +236,27 @@ class Process : public SimObject
      */
     bool map(Addr vaddr, Addr paddr, int size, bool cacheable = true);
 
+    /**
+     * Fold bytes the target wrote to one of its file descriptors into
+     * the output digest.  Only writes to the target's stdout and stderr
+     * are digested.
+     */
+    void digestOutput(int tgt_fd, const void *buf, int size);
+
+    /// FNV-1a digest of everything the target wrote to stdout and stderr.
+    uint64_t outputDigest() const { return outputHash; }
+
+    /**
+     * FNV-1a digest of a range of this process's virtual memory, used by
+     * the fault injection scripts to compare a run against its golden
+     * run.  Unmapped pages are digested as if they were a single marker
+     * byte so that they are distinguishable from zero-filled ones.
+     *
+     * @param vaddr The starting virtual address of the range.
+     * @param size The length of the range in bytes.
+     */
+    uint64_t memoryDigest(Addr vaddr, Addr size);
+
     void serialize(std::ostream &os);
     void unserialize(Checkpoint *cp, const std::string &section);
 };
@@ -54,6 +54,7 @@
 #include "arch/vtophys.hh"
 #include "arch/pseudo_inst.hh"
 #include "base/debug.hh"
+#include "base/loader/region_map.hh"
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
@@ -65,6 +66,7 @@
 #include "debug/WorkItems.hh"
 #include "params/BaseCPU.hh"
 #include "sim/full_system.hh"
+#include "sim/guest_roi.hh"
 #include "sim/process.hh"
 #include "sim/pseudo_inst.hh"
 #include "sim/serialize.hh"
@@ -192,10 +194,19 @@ pseudoInst(ThreadContext *tc, uint8_t func, uint8_t subfunc)
         workend(tc, args[0], args[1]);
         break;
 
+      case 0x56: // roi_begin_func
+        roibegin(tc, args[0]);
+        break;
+
+      case 0x57: // roi_end_func
+        roiend(tc, args[0]);
+        break;
+
+      case 0x58: // fi_arm_func
+        fiarm(tc, args[0]);
+        break;
+
       case 0x55: // annotate_func
-      case 0x56: // reserved2_func
-      case 0x57: // reserved3_func
-      case 0x58: // reserved4_func
       case 0x59: // reserved5_func
         warn("Unimplemented m5 op (0x%x)\n", func);
         break;
@@ -437,6 +448,7 @@ addsymbol(ThreadContext *tc, Addr addr, Addr symbolAddr)
 
     tc->getSystemPtr()->kernelSymtab->insert(addr,symbol);
     debugSymbolTable->insert(addr,symbol);
+    debugRegionMap.build(*debugSymbolTable);
 }
 
 uint64_t
@@ -717,4 +729,29 @@ workend(ThreadContext *tc, uint64_t workid, uint64_t threadid)
     }
 }
 
+//
+// The guest's own region of interest and fault injection markers,
+// which the CPU models can follow instead of the symbol table
+//
+void
+roibegin(ThreadContext *tc, uint64_t roiid)
+{
+    DPRINTF(PseudoInst, "PseudoInst::roibegin(%i)\n", roiid);
+    guestROI.begin(tc->contextId(), roiid);
+}
+
+void
+roiend(ThreadContext *tc, uint64_t roiid)
+{
+    DPRINTF(PseudoInst, "PseudoInst::roiend(%i)\n", roiid);
+    guestROI.end(tc->contextId(), roiid);
+}
+
+void
+fiarm(ThreadContext *tc, uint64_t fiid)
+{
+    DPRINTF(PseudoInst, "PseudoInst::fiarm(%i)\n", fiid);
+    guestROI.armFault(tc->contextId(), fiid);
+}
+
 } // namespace PseudoInst
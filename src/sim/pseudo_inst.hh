@@ -88,6 +88,9 @@ void debugbreak(ThreadContext *tc);
 void switchcpu(ThreadContext *tc);
 void workbegin(ThreadContext *tc, uint64_t workid, uint64_t threadid);
 void workend(ThreadContext *tc, uint64_t workid, uint64_t threadid);
+void roibegin(ThreadContext *tc, uint64_t roiid);
+void roiend(ThreadContext *tc, uint64_t roiid);
+void fiarm(ThreadContext *tc, uint64_t fiid);
 
 } // namespace PseudoInst
 
@@ -0,0 +1,271 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/quantum.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/trace.hh"
+#include "debug/Quantum.hh"
+
+QuantumController quantumController;
+
+//! Host times of the running thread, in ns.
+static __thread uint64_t threadDeparted = 0;
+static __thread uint64_t threadArrived = 0;
+
+//! Syncs the quantum is held for after work arrived late.
+static const unsigned lateHoldoff = 16;
+
+QuantumController::QuantumController()
+    : enabled(false), minQuantum(0), maxQuantum(0), safeQuantum(0),
+      targetOverhead(0), holdoff(0), syncCount(0), log(NULL),
+      replaying(false), minLatency(MaxTick), busyNs(0),
+      waitNs(0), late(0), lateTicks(0)
+{
+}
+
+uint64_t
+QuantumController::hostNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void
+QuantumController::enable(Tick min_quantum, Tick max_quantum,
+                          double target_overhead, const std::string &replay)
+{
+    if (max_quantum && min_quantum > max_quantum)
+        fatal("Adaptive quantum: sim_quantum_min (%d) is longer than "
+              "sim_quantum_max (%d)\n", min_quantum, max_quantum);
+    if (target_overhead <= 0 || target_overhead >= 1)
+        fatal("Adaptive quantum: the target overhead must be between 0 "
+              "and 1\n");
+
+    enabled = true;
+    minQuantum = min_quantum;
+    maxQuantum = max_quantum;
+    targetOverhead = target_overhead;
+
+    if (replay.empty())
+        return;
+
+    std::ifstream in(replay.c_str());
+    if (!in)
+        fatal("Adaptive quantum: cannot open the quantum log %s\n", replay);
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        uint64_t sync_number;
+        Tick q;
+        if (sscanf(line.c_str(), "%lu %lu", &sync_number, &q) != 2)
+            fatal("Adaptive quantum: bad line in %s: %s\n", replay, line);
+        replayQuanta.push_back(std::make_pair(sync_number, q));
+    }
+    replaying = true;
+    inform("Adaptive quantum: replaying %d quanta from %s\n",
+           replayQuanta.size(), replay);
+}
+
+void
+QuantumController::startThread()
+{
+    threadDeparted = hostNs();
+}
+
+void
+QuantumController::arrive()
+{
+    threadArrived = hostNs();
+    busyNs.fetch_add(threadArrived - threadDeparted,
+                     std::memory_order_relaxed);
+}
+
+void
+QuantumController::depart()
+{
+    threadDeparted = hostNs();
+    waitNs.fetch_add(threadDeparted - threadArrived,
+                     std::memory_order_relaxed);
+}
+
+Tick
+QuantumController::sync(Tick quantum)
+{
+    // Every thread has arrived, so the busy times of the quantum and
+    // the waits of the last sync are in
+    uint64_t busy = busyNs.exchange(0, std::memory_order_relaxed);
+    uint64_t wait = waitNs.exchange(0, std::memory_order_relaxed);
+    Tick latency = minLatency.exchange(MaxTick, std::memory_order_relaxed);
+
+    // The share of the threads' host time spent in barriers, waiting
+    // for the slowest thread or on the barrier itself. Both shrink
+    // relative to the work as the quantum grows.
+    double overhead = 0;
+    if (busy + wait)
+        overhead = double(wait) / (busy + wait);
+
+    syncs++;
+    quantumTicks += quantum;
+    if (minQuantumSeen.value() == 0 || quantum < minQuantumSeen.value())
+        minQuantumSeen = quantum;
+    if (quantum > maxQuantumSeen.value())
+        maxQuantumSeen = quantum;
+    threadBusy += busy / 1e9;
+    syncWait += wait / 1e9;
+    lateArrivals += late.exchange(0, std::memory_order_relaxed);
+    lateDelay += lateTicks.exchange(0, std::memory_order_relaxed);
+
+    if (!enabled)
+        return quantum;
+
+    syncCount++;
+
+    if (replaying) {
+        Tick next = quantum;
+        if (!replayQuanta.empty() &&
+            replayQuanta.front().first == syncCount) {
+            next = replayQuanta.front().second;
+            replayQuanta.pop_front();
+        }
+        return next;
+    }
+
+    if (safeQuantum == 0) {
+        safeQuantum = quantum;
+        if (maxQuantum == 0)
+            maxQuantum = safeQuantum;
+        if (minQuantum == 0 || minQuantum > maxQuantum)
+            minQuantum = std::min(safeQuantum, maxQuantum);
+
+        if (maxQuantum > safeQuantum) {
+            warn("Adaptive quantum: sim_quantum_max (%d) is longer than "
+                 "the shortest cross-queue latency (%d), so the quantum "
+                 "follows host timing and results are not reproducible. "
+                 "The quanta are logged to quantum_log.txt for "
+                 "sim_quantum_replay.\n", maxQuantum, safeQuantum);
+            log = simout.create("quantum_log.txt");
+            ccprintf(*log, "# sync quantum\n");
+        }
+    }
+
+    Tick next = quantum;
+    if (latency < quantum) {
+        // Work crossed queues faster than the quantum and was delayed,
+        // fall back to a quantum it fits in
+        next = latency;
+        holdoff = lateHoldoff;
+    } else if (holdoff) {
+        holdoff--;
+    } else if (overhead > targetOverhead) {
+        next = quantum * 2;
+    } else if (overhead < targetOverhead / 4 && quantum > safeQuantum) {
+        // Cheap barriers, buy back accuracy
+        next = std::max(quantum / 2, safeQuantum);
+    }
+    next = std::min(std::max(next, minQuantum), maxQuantum);
+
+    if (next != quantum) {
+        DPRINTF(Quantum, "Quantum %d -> %d ticks (overhead %.3f, "
+                "shortest latency %d)\n", quantum, next, overhead,
+                latency == MaxTick ? 0 : latency);
+        if (log) {
+            ccprintf(*log, "%d %d\n", syncCount, next);
+            log->flush();
+        }
+    }
+    return next;
+}
+
+void
+QuantumController::regStats(const std::string &name)
+{
+    using namespace Stats;
+
+    syncs
+        .name(name + ".syncs")
+        .desc("Synchronisations of the event queues at quantum ends")
+        ;
+
+    quantumTicks
+        .name(name + ".quantumTicks")
+        .desc("Ticks simulated in whole quanta")
+        ;
+
+    effectiveQuantum
+        .name(name + ".effectiveQuantum")
+        .desc("Mean simulation quantum (ticks)")
+        .precision(0)
+        ;
+    effectiveQuantum = quantumTicks / syncs;
+
+    minQuantumSeen
+        .name(name + ".minQuantum")
+        .desc("Shortest quantum used (ticks)")
+        ;
+
+    maxQuantumSeen
+        .name(name + ".maxQuantum")
+        .desc("Longest quantum used (ticks)")
+        ;
+
+    threadBusy
+        .name(name + ".threadBusy")
+        .desc("Host seconds the threads simulated for between barriers")
+        ;
+
+    syncWait
+        .name(name + ".syncWait")
+        .desc("Host seconds the threads waited in quantum barriers")
+        ;
+
+    syncOverhead
+        .name(name + ".syncOverhead")
+        .desc("Share of the threads' host time spent in quantum barriers")
+        ;
+    syncOverhead = syncWait / (syncWait + threadBusy);
+
+    lateArrivals
+        .name(name + ".lateArrivals")
+        .desc("Work crossing queues with a latency shorter than the "
+              "quantum, delayed to its end")
+        ;
+
+    lateDelay
+        .name(name + ".lateDelay")
+        .desc("Ticks that late work was delayed by in total")
+        ;
+}
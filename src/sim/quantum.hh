@@ -0,0 +1,166 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Run-time adaptation of the simulation quantum of a parallel,
+ * multi-event-queue simulation. A short quantum wastes host time in
+ * the barriers that end every quantum, a long one delays the work
+ * that crosses queues with a shorter latency to the end of the
+ * quantum. The controller measures both at every synchronisation and
+ * picks the next quantum within the bounds configured on Root.
+ *
+ * Once the quantum may grow past the shortest cross-queue latency,
+ * its length depends on host timing, and so does which work gets
+ * delayed: the simulated results are no longer reproducible. Every
+ * quantum chosen is then written to quantum_log.txt, which a later
+ * run can replay to get the same results.
+ */
+
+#ifndef __SIM_QUANTUM_HH__
+#define __SIM_QUANTUM_HH__
+
+#include <atomic>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+class QuantumController
+{
+  private:
+    /** Adapt the quantum, rather than only measure it */
+    bool enabled;
+
+    Tick minQuantum;
+    Tick maxQuantum;
+
+    /** The quantum picked from the cross-queue latencies, which delays
+     *  no work */
+    Tick safeQuantum;
+
+    /** Fraction of host time the threads may wait on each other */
+    double targetOverhead;
+
+    /** Quanta left before the quantum may grow again */
+    unsigned holdoff;
+
+    /** Syncs so far, which number the quanta of the log */
+    uint64_t syncCount;
+
+    /** Log of the quanta chosen, NULL until known to be needed */
+    std::ostream *log;
+
+    /** Replaying a log: the sync numbers and quanta still to apply */
+    bool replaying;
+    std::deque<std::pair<uint64_t, Tick> > replayQuanta;
+
+    /** Shortest cross-queue latency in the current quantum */
+    std::atomic<Tick> minLatency;
+
+    /** Host time the threads ran for in the current quantum, and
+     *  waited in the barriers of the last sync, in ns */
+    std::atomic<uint64_t> busyNs;
+    std::atomic<uint64_t> waitNs;
+
+    /** Work delayed to the end of a quantum, and by how much */
+    std::atomic<uint64_t> late;
+    std::atomic<uint64_t> lateTicks;
+
+    Stats::Scalar syncs;
+    Stats::Scalar quantumTicks;
+    Stats::Formula effectiveQuantum;
+    Stats::Scalar minQuantumSeen;
+    Stats::Scalar maxQuantumSeen;
+    Stats::Scalar threadBusy;
+    Stats::Scalar syncWait;
+    Stats::Formula syncOverhead;
+    Stats::Scalar lateArrivals;
+    Stats::Scalar lateDelay;
+
+    static uint64_t hostNs();
+
+  public:
+    QuantumController();
+
+    /**
+     * Adapt the quantum between min_quantum and max_quantum, growing
+     * it while the threads spend more than target_overhead of their
+     * host time waiting on each other. A max_quantum of 0 keeps the
+     * quantum at most the shortest cross-queue latency, so that no
+     * work is ever delayed. A non-empty replay names a quantum log of
+     * an earlier run, whose quanta are used instead of measuring.
+     */
+    void enable(Tick min_quantum, Tick max_quantum, double target_overhead,
+                const std::string &replay);
+    bool adaptive() const { return enabled; }
+
+    /**
+     * Work crossing to another queue at the current tick, latency
+     * ticks before it is due there. Returns the latency it takes: the
+     * given one, or the quantum if that is longer.
+     */
+    Tick
+    crossQueue(Tick latency, Tick quantum)
+    {
+        Tick seen = minLatency.load(std::memory_order_relaxed);
+        while (latency < seen &&
+               !minLatency.compare_exchange_weak(seen, latency,
+                   std::memory_order_relaxed))
+            ;
+
+        if (latency >= quantum)
+            return latency;
+
+        late.fetch_add(1, std::memory_order_relaxed);
+        lateTicks.fetch_add(quantum - latency, std::memory_order_relaxed);
+        return quantum;
+    }
+
+    /** The running thread enters the simulation loop */
+    void startThread();
+
+    /** The running thread arrives at, or leaves, a quantum barrier */
+    void arrive();
+    void depart();
+
+    /**
+     * Account for the quantum that just ended on all threads, and pick
+     * the next. Called by one thread while the others wait.
+     */
+    Tick sync(Tick quantum);
+
+    void regStats(const std::string &name);
+};
+
+extern QuantumController quantumController;
+
+#endif // __SIM_QUANTUM_HH__
@@ -0,0 +1,187 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/queue_pool.hh"
+
+#include "base/misc.hh"
+#include "sim/eventq_impl.hh"
+#include "sim/global_event.hh"
+#include "sim/quantum.hh"
+#include "sim/simulate.hh"
+
+QueuePool::QueuePool(unsigned threads)
+    : numWorkers(threads), workers(threads), barrier(threads),
+      done(false), exitEvent(NULL), failed(false)
+{
+    assert(numWorkers > 0);
+
+    // The barrier events of every queue are serviced on one thread
+    BaseGlobalEvent::pooled = true;
+
+    for (unsigned i = 1; i < numWorkers; i++)
+        this->threads.push_back(
+            new std::thread(&QueuePool::workerLoop, this, i));
+}
+
+void
+QueuePool::fill()
+{
+    // Only called while the other workers wait on the barrier
+    for (uint32_t i = 0; i < numMainEventQueues; i++)
+        workers[i % numWorkers].queues.push_back(mainEventQueue[i]);
+}
+
+EventQueue *
+QueuePool::take(unsigned self)
+{
+    {
+        std::lock_guard<std::mutex> lock(workers[self].lock);
+        std::deque<EventQueue *> &own = workers[self].queues;
+        if (!own.empty()) {
+            EventQueue *q = own.front();
+            own.pop_front();
+            return q;
+        }
+    }
+
+    for (unsigned i = 1; i < numWorkers; i++) {
+        Worker &victim = workers[(self + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.queues.empty()) {
+            EventQueue *q = victim.queues.back();
+            victim.queues.pop_back();
+            return q;
+        }
+    }
+
+    return NULL;
+}
+
+void
+QueuePool::runQueue(EventQueue *q)
+{
+    curEventQueue(q);
+    q->handleAsyncInsertions();
+
+    while (!failed) {
+        // there is always at least the global event ending the
+        // quantum in the queue
+        assert(!q->empty());
+        assert(curTick() <= q->nextTick() &&
+               "event scheduled in the past");
+
+        if (!serviceAsyncEvents(q)) {
+            failed = true;
+            return;
+        }
+
+        if (q->nextGlobalEvent())
+            return;
+
+        // Local exit events are only used with a single queue, which
+        // never runs on a pool.
+        q->serviceOne();
+    }
+}
+
+void
+QueuePool::syncQueues()
+{
+    if (failed) {
+        // drop the queues the workers gave up on
+        for (unsigned i = 0; i < numWorkers; i++)
+            workers[i].queues.clear();
+        done = true;
+        return;
+    }
+
+    BaseGlobalEvent *global = mainEventQueue[0]->nextGlobalEvent();
+    for (uint32_t i = 0; i < numMainEventQueues; i++) {
+        EventQueue *q = mainEventQueue[i];
+        curEventQueue(q);
+
+        // All queues see the global events in the same total order,
+        // see BaseGlobalEvent::schedule()
+        if (!global || q->nextGlobalEvent() != global)
+            panic("Event queue %d is not at the global event of "
+                  "queue 0\n", i);
+
+        // The last queue performs the global event, once the others
+        // have left it
+        BaseGlobalEvent::poolLeader = i == numMainEventQueues - 1;
+        Event *exit_event = q->serviceOne();
+        if (i == 0)
+            exitEvent = exit_event;
+    }
+    BaseGlobalEvent::poolLeader = false;
+
+    done = exitEvent != NULL;
+    if (!done)
+        fill();
+}
+
+bool
+QueuePool::round(unsigned self)
+{
+    while (EventQueue *q = take(self))
+        runQueue(q);
+
+    quantumController.arrive();
+    if (barrier.wait())
+        syncQueues();
+    barrier.wait();
+    quantumController.depart();
+
+    return done;
+}
+
+void
+QueuePool::workerLoop(unsigned self)
+{
+    while (true) {
+        barrier.wait();
+        quantumController.startThread();
+        while (!round(self)) {}
+    }
+}
+
+Event *
+QueuePool::run()
+{
+    done = false;
+    exitEvent = NULL;
+    failed = false;
+    fill();
+
+    // the other workers wait on the barrier to enter the loop
+    barrier.wait();
+    quantumController.startThread();
+    while (!round(0)) {}
+
+    curEventQueue(mainEventQueue[0]);
+    return failed ? NULL : exitEvent;
+}
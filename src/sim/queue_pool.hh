@@ -0,0 +1,109 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * A fixed pool of host threads simulating more main event queues than
+ * there are threads. Every quantum, the queues are dealt out to the
+ * workers round-robin; a worker runs each of its queues up to the
+ * global event that ends the quantum and, once its own queues are
+ * done, steals queues that other workers have not started yet.
+ */
+
+#ifndef __SIM_QUEUE_POOL_HH__
+#define __SIM_QUEUE_POOL_HH__
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/barrier.hh"
+
+class Event;
+class EventQueue;
+
+class QueuePool
+{
+  private:
+    /// The queues a worker has yet to run this quantum. The owner
+    /// takes them from the front, thieves from the back.
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<EventQueue *> queues;
+    };
+
+    const unsigned numWorkers;
+    std::vector<Worker> workers;
+
+    /// Host threads other than the one calling run()
+    std::vector<std::thread *> threads;
+
+    /// Barrier for entering the simulation loop and ending a quantum
+    Barrier barrier;
+
+    /// Set once a global exit event ended the simulation loop
+    bool done;
+    /// The local part of that exit event on queue 0
+    Event *exitEvent;
+    /// Set if an asynchronous exception aborted the simulation loop
+    std::atomic<bool> failed;
+
+    /// Deal the queues out to the workers for the next quantum.
+    void fill();
+
+    /// Get the next queue for worker self to run, NULL if none is left.
+    EventQueue *take(unsigned self);
+
+    /// Run q up to its next global event.
+    void runQueue(EventQueue *q);
+
+    /// Service the global event at the head of every queue, on the
+    /// thread that arrived at the barrier last.
+    void syncQueues();
+
+    /// Simulate one quantum on worker self.
+    /// @return true if the simulation loop exits
+    bool round(unsigned self);
+
+    void workerLoop(unsigned self);
+
+  public:
+    QueuePool(unsigned threads);
+
+    /**
+     * Simulate on all workers, the calling thread being worker 0, until
+     * a global exit event.
+     * @return The local exit event on queue 0, NULL on an exception
+     */
+    Event *run();
+};
+
+#endif // __SIM_QUEUE_POOL_HH__
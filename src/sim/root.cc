@@ -35,8 +35,12 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/TimeSync.hh"
+#include "sim/event_profile.hh"
 #include "sim/full_system.hh"
+#include "sim/host_mem.hh"
+#include "sim/quantum.hh"
 #include "sim/root.hh"
+#include "sim/simulate.hh"
 
 Root *Root::_root = NULL;
 
@@ -114,6 +118,31 @@ Root::Root(RootParams *p) : SimObject(p), _enabled(false),
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    if (p->sim_quantum_adaptive) {
+        quantumController.enable(p->sim_quantum_min, p->sim_quantum_max,
+                                 p->sim_quantum_overhead,
+                                 p->sim_quantum_replay);
+    }
+    simThreads = p->sim_threads;
+
+    if (p->eventq_backend == Enums::TimingWheel) {
+        setMainEventQueueBackend(EventQueue::TimingWheel,
+                                 p->eventq_wheel_slots,
+                                 p->eventq_wheel_granularity);
+    }
+
+    if (p->eventq_profile)
+        EventProfile::enable();
+}
+
+void
+Root::regStats()
+{
+    SimObject::regStats();
+    quantumController.regStats(name() + ".quantum");
+
+    if (params()->host_mem_stats)
+        HostMem::regStats();
 }
 
 void
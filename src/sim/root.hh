@@ -112,6 +112,8 @@ class Root : public SimObject
      */
     void initState();
 
+    void regStats();
+
     virtual void serialize(std::ostream &os);
     virtual void unserialize(Checkpoint *cp, const std::string &section);
 
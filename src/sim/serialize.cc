@@ -449,6 +449,11 @@ Globals::serialize(ostream &os)
         nameOut(os, "MainEventQueue");
         mainEventQueue[i]->serialize(os);
     }
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        nameOut(os, csprintf("%s.random%d", name(), i));
+        mainEventQueue[i]->random().serialize(os);
+    }
 }
 
 void
@@ -461,6 +466,8 @@ Globals::unserialize(Checkpoint *cp, const std::string &section)
     for (uint32_t i = 0; i < numMainEventQueues; ++i) {
         mainEventQueue[i]->setCurTick(tick);
         mainEventQueue[i]->unserialize(cp, "MainEventQueue");
+        mainEventQueue[i]->random().unserialize(
+            cp, csprintf("%s.random%d", name(), i));
     }
 }
 
@@ -82,8 +82,15 @@ class ProbeManager;
  * SimObject.py). This has the effect of calling the method on the
  * parent node <i>before</i> its children.
  */
+namespace HostMem
+{
+void regStats();
+}
+
 class SimObject : public EventManager, public Serializable, public Drainable
 {
+    friend void HostMem::regStats();
+
   private:
     typedef std::vector<SimObject *> SimObjectList;
 
@@ -145,6 +152,13 @@ class SimObject : public EventManager, public Serializable, public Drainable
      */
     virtual void resetStats();
 
+    /**
+     * Host memory taken by the tables of this object, in bytes, for
+     * the optional hostMem stats. Only tables that can grow large are
+     * worth counting, so by default there are none.
+     */
+    virtual uint64_t hostMemUsage() const { return 0; }
+
     /**
      * Register probe points for this object.
      */
@@ -39,10 +39,13 @@
 #include "base/types.hh"
 #include "sim/async.hh"
 #include "sim/eventq_impl.hh"
+#include "sim/queue_pool.hh"
+#include "sim/quantum.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 #include "sim/simulate.hh"
 #include "sim/stat_control.hh"
+#include "sim/telemetry.hh"
 
 //! Mutex for handling async events.
 std::mutex asyncEventMutex;
@@ -51,6 +54,8 @@ std::mutex asyncEventMutex;
 //! simulation loop.
 Barrier *threadBarrier;
 
+unsigned simThreads = 0;
+
 //! forward declaration
 Event *doSimLoop(EventQueue *);
 
@@ -84,8 +89,14 @@ simulate(Tick num_cycles)
     // instantiated sim objects.
     static bool threads_initialized = false;
     static std::vector<std::thread *> threads;
+    static QueuePool *pool = NULL;
 
-    if (!threads_initialized) {
+    if (!threads_initialized && simThreads &&
+        simThreads < numMainEventQueues) {
+        // Fewer host threads than queues, share them out
+        pool = new QueuePool(simThreads);
+        threads_initialized = true;
+    } else if (!threads_initialized) {
         threadBarrier = new Barrier(numMainEventQueues);
 
         // the main thread (the one we're currently running on)
@@ -116,15 +127,21 @@ simulate(Tick num_cycles)
 
         quantum_event = new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
                             EventBase::Progress_Event_Pri, 0);
+        quantum_event->controller = &quantumController;
 
         inParallelMode = true;
     }
 
-    // all subordinate (created) threads should be waiting on the
-    // barrier; the arrival of the main thread here will satisfy the
-    // barrier, and all threads will enter doSimLoop in parallel
-    threadBarrier->wait();
-    Event *local_event = doSimLoop(mainEventQueue[0]);
+    Event *local_event;
+    if (pool) {
+        local_event = pool->run();
+    } else {
+        // all subordinate (created) threads should be waiting on the
+        // barrier; the arrival of the main thread here will satisfy the
+        // barrier, and all threads will enter doSimLoop in parallel
+        threadBarrier->wait();
+        local_event = doSimLoop(mainEventQueue[0]);
+    }
     assert(local_event != NULL);
 
     inParallelMode = false;
@@ -173,6 +190,44 @@ testAndClearAsyncEvent()
     return was_set;
 }
 
+bool
+serviceAsyncEvents(EventQueue *eventq)
+{
+    if (!async_event || !testAndClearAsyncEvent())
+        return true;
+
+    // Take the event queue lock in case any of the service
+    // routines want to schedule new events.
+    std::lock_guard<EventQueue> lock(*eventq);
+    if (async_statdump || async_statreset) {
+        Stats::schedStatEvent(async_statdump, async_statreset);
+        async_statdump = false;
+        async_statreset = false;
+    }
+
+    if (async_io) {
+        async_io = false;
+        pollQueue.service();
+    }
+
+    if (async_telemetry) {
+        async_telemetry = false;
+        Telemetry::serviceSample();
+    }
+
+    if (async_exit) {
+        async_exit = false;
+        exitSimLoop("user interrupt received");
+    }
+
+    if (async_exception) {
+        async_exception = false;
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * The main per-thread simulation loop. This loop is executed by all
  * simulation threads (the main thread and the subordinate threads) in
@@ -184,6 +239,7 @@ doSimLoop(EventQueue *eventq)
     // set the per thread current eventq pointer
     curEventQueue(eventq);
     eventq->handleAsyncInsertions();
+    quantumController.startThread();
 
     while (1) {
         // there should always be at least one event (the SimLoopExitEvent
@@ -192,31 +248,8 @@ doSimLoop(EventQueue *eventq)
         assert(curTick() <= eventq->nextTick() &&
                "event scheduled in the past");
 
-        if (async_event && testAndClearAsyncEvent()) {
-            // Take the event queue lock in case any of the service
-            // routines want to schedule new events.
-            std::lock_guard<EventQueue> lock(*eventq);
-            if (async_statdump || async_statreset) {
-                Stats::schedStatEvent(async_statdump, async_statreset);
-                async_statdump = false;
-                async_statreset = false;
-            }
-
-            if (async_io) {
-                async_io = false;
-                pollQueue.service();
-            }
-
-            if (async_exit) {
-                async_exit = false;
-                exitSimLoop("user interrupt received");
-            }
-
-            if (async_exception) {
-                async_exception = false;
-                return NULL;
-            }
-        }
+        if (!serviceAsyncEvents(eventq))
+            return NULL;
 
         Event *exit_event = eventq->serviceOne();
         if (exit_event != NULL) {
@@ -32,4 +32,20 @@
 #include "base/types.hh"
 #include "sim/sim_events.hh"
 
+class EventQueue;
+
 GlobalSimLoopExitEvent *simulate(Tick num_cycles = MaxTick);
+
+/**
+ * Host threads to simulate the main event queues on. With 0, or at
+ * least as many threads as queues, every queue gets a thread of its
+ * own, otherwise the queues share a QueuePool.
+ */
+extern unsigned simThreads;
+
+/**
+ * Handle pending asynchronous events (signals, I/O, stat dump
+ * requests) on behalf of eventq, if no other thread already is.
+ * @return false if the simulation loop must exit on an exception
+ */
+bool serviceAsyncEvents(EventQueue *eventq);
@@ -0,0 +1,146 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stats_region.hh"
+
+#include <ostream>
+
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "base/stats/text.hh"
+#include "sim/sim_exit.hh"
+
+StatsRegionController *StatsRegionController::active = NULL;
+
+StatsRegionController::StatsRegionController(const Params *p) :
+    SimObject(p),
+    fileName(p->file_name),
+    currentFunc(-1),
+    resetCallback(this),
+    exitCallback(this)
+{
+    if (active)
+        fatal("%s: only one StatsRegionController is allowed\n", name());
+    active = this;
+
+    Stats::registerResetCallback(&resetCallback);
+    registerExitCallback(&exitCallback);
+}
+
+StatsRegionController::~StatsRegionController()
+{
+    if (active == this)
+        active = NULL;
+}
+
+void
+StatsRegionController::closeRegion()
+{
+    snapshot.take(currentValues);
+
+    std::vector<double> &total = totals[currentFunc];
+    total.resize(currentValues.size(), 0.0);
+
+    for (size_t i = 0; i < currentValues.size(); i++)
+        total[i] += currentValues[i] - entryValues[i];
+
+    entryValues.swap(currentValues);
+}
+
+void
+StatsRegionController::switchRegion(unsigned int func_id)
+{
+    if (currentFunc >= 0)
+        closeRegion();
+    else
+        snapshot.take(entryValues);
+
+    if (func_id >= entries.size()) {
+        entries.resize(func_id + 1, 0);
+        totals.resize(func_id + 1);
+    }
+
+    currentFunc = func_id;
+    entries[func_id]++;
+}
+
+void
+StatsRegionController::statsReset()
+{
+    for (auto i = totals.begin(); i != totals.end(); ++i)
+        i->clear();
+    entries.assign(entries.size(), 0);
+
+    if (currentFunc >= 0) {
+        snapshot.take(entryValues);
+        entries[currentFunc] = 1;
+    }
+}
+
+void
+StatsRegionController::writeStats()
+{
+    if (currentFunc < 0)
+        return;
+
+    closeRegion();
+
+    std::ostream *os = simout.create(fileName);
+    const std::vector<std::string> &names = snapshot.names();
+
+    ccprintf(*os, "\n---------- Begin Region Statistics ----------\n");
+
+    for (unsigned int func_id = 0; func_id < entries.size(); func_id++) {
+        if (!entries[func_id])
+            continue;
+
+        std::string prefix = "region." +
+            debugRegionMap.funcName(func_id) + ".";
+        const std::vector<double> &total = totals[func_id];
+
+        ccprintf(*os, "%-60s %12d # Times the region was entered\n",
+            prefix + "entries", entries[func_id]);
+
+        for (size_t i = 0; i < total.size(); i++) {
+            if (total[i] != 0.0) {
+                ccprintf(*os, "%-60s %12s\n", prefix + names[i],
+                    Stats::ValueToString(total[i], 6));
+            }
+        }
+    }
+
+    ccprintf(*os, "\n---------- End Region Statistics   ----------\n");
+    simout.close(os);
+}
+
+StatsRegionController *
+StatsRegionControllerParams::create()
+{
+    return new StatsRegionController(this);
+}
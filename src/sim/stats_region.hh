@@ -0,0 +1,123 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_STATS_REGION_HH__
+#define __SIM_STATS_REGION_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/loader/region_map.hh"
+#include "base/stats/snapshot.hh"
+#include "base/types.hh"
+#include "params/StatsRegionController.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Per-region statistics without dumping or resetting the stats.  Each
+ * committed instruction's region of interest function is looked up in
+ * debugRegionMap and, when it changes, a snapshot of all the stats is
+ * taken and its difference from the snapshot taken on entering the
+ * region left is added to that region's totals.  The regions are the
+ * System's roi_functions, with everything else as "other", so a region
+ * boundary costs a copy of the stats values rather than a dump.
+ *
+ * Commits of all CPUs are attributed to the one current region, so this
+ * is meant for single-CPU workloads.  Totals cover the time since the
+ * last stats reset and are written to file_name at exit.
+ */
+class StatsRegionController : public SimObject
+{
+  protected:
+    std::string fileName;
+
+    Stats::Snapshot snapshot;
+
+    /** Snapshot at entry to the current region */
+    std::vector<double> entryValues;
+
+    /** Scratch snapshot */
+    std::vector<double> currentValues;
+
+    /** Sums of the stats differences, by function ID */
+    std::vector<std::vector<double> > totals;
+
+    /** Times each region was entered, by function ID */
+    std::vector<Counter> entries;
+
+    /** Function ID of the current region, -1 before the first commit */
+    int currentFunc;
+
+    /** Move the region of the last commit into func_id */
+    void switchRegion(unsigned int func_id);
+
+    /** Add the stats differences of the current region to its totals
+     *  and start it again from now */
+    void closeRegion();
+
+    /** Start again from the reset stats */
+    void statsReset();
+
+    /** Write the totals of all regions */
+    void writeStats();
+
+    MakeCallback<StatsRegionController, &StatsRegionController::statsReset>
+        resetCallback;
+    MakeCallback<StatsRegionController, &StatsRegionController::writeStats>
+        exitCallback;
+
+  public:
+    typedef StatsRegionControllerParams Params;
+
+    StatsRegionController(const Params *p);
+    ~StatsRegionController();
+
+    /** Account a committed instruction */
+    void
+    commit(Addr pc)
+    {
+        unsigned int func_id = debugRegionMap.funcId(pc);
+
+        if (int(func_id) != currentFunc)
+            switchRegion(func_id);
+    }
+
+    /** The controller of the simulation, if there is one */
+    static StatsRegionController *active;
+};
+
+/** Call at each instruction commit, this costs a test unless there is a
+ *  StatsRegionController */
+inline void
+statsRegionCommit(Addr pc)
+{
+    if (StatsRegionController::active)
+        StatsRegionController::active->commit(pc);
+}
+
+#endif // __SIM_STATS_REGION_HH__
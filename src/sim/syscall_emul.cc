@@ -231,7 +231,7 @@ readFunc(SyscallDesc *desc, int num, LiveProcess *p, ThreadContext *tc)
     assert(fd >= 0);
     Addr bufPtr = p->getSyscallArg(tc, index);
     int nbytes = p->getSyscallArg(tc, index);
-    BufferArg bufArg(bufPtr, nbytes);
+    BufferArg bufArg(bufPtr, nbytes, tc->getMemProxy());
 
     int bytes_read = read(fd, bufArg.bufferPtr(), nbytes);
 
@@ -245,14 +245,17 @@ SyscallReturn
 writeFunc(SyscallDesc *desc, int num, LiveProcess *p, ThreadContext *tc)
 {
     int index = 0;
-    int fd = p->sim_fd(p->getSyscallArg(tc, index));
+    int tgt_fd = p->getSyscallArg(tc, index);
+    int fd = p->sim_fd(tgt_fd);
     Addr bufPtr = p->getSyscallArg(tc, index);
     int nbytes = p->getSyscallArg(tc, index);
-    BufferArg bufArg(bufPtr, nbytes);
+    BufferArg bufArg(bufPtr, nbytes, tc->getMemProxy());
 
     bufArg.copyIn(tc->getMemProxy());
 
     int bytes_written = write(fd, bufArg.bufferPtr(), nbytes);
+    if (bytes_written > 0)
+        p->digestOutput(tgt_fd, bufArg.bufferPtr(), bytes_written);
 
     fsync(fd);
 
@@ -1149,8 +1149,13 @@ writevFunc(SyscallDesc *desc, int callnum, LiveProcess *process,
 
     int result = writev(process->sim_fd(fd), hiov, count);
 
-    for (size_t i = 0; i < count; ++i)
+    size_t undigested = result > 0 ? result : 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t len = std::min(hiov[i].iov_len, undigested);
+        process->digestOutput(fd, hiov[i].iov_base, len);
+        undigested -= len;
         delete [] (char *)hiov[i].iov_base;
+    }
 
     if (result < 0)
         return -errno;
@@ -52,6 +52,11 @@
  * appropriate size and tracks the user-space address.  The copyIn()
  * and copyOut() methods copy the user-space buffer to and from the
  * simulator-space buffer, respectively.
+ *
+ * When constructed with a port proxy, the buffer may instead point
+ * straight at the backing store of the target memory, in which case
+ * copyIn() has nothing to do and copyOut() only tells the proxy's
+ * write observer of the write.
  */
 class BaseBufferArg {
 
@@ -62,22 +67,28 @@ class BaseBufferArg {
      * target address 'addr'.
      */
     BaseBufferArg(Addr _addr, int _size)
-        : addr(_addr), size(_size), bufPtr(new uint8_t[size])
-    {
-        // clear out buffer: in case we only partially populate this,
-        // and then do a copyOut(), we want to make sure we don't
-        // introduce any random junk into the simulated address space
-        memset(bufPtr, 0, size);
-    }
+        : addr(_addr), size(_size), hostPtr(NULL), bufPtr(alloc(size))
+    { }
+
+    /**
+     * Represent the memory at target address 'addr', using it in
+     * place if the proxy can map all of it into simulator space, and
+     * allocating a buffer otherwise.
+     */
+    BaseBufferArg(Addr _addr, int _size, SETranslatingPortProxy &memproxy)
+        : addr(_addr), size(_size), hostPtr(memproxy.hostPtr(addr, size)),
+          bufPtr(hostPtr ? hostPtr : alloc(size))
+    { }
 
-    ~BaseBufferArg() { delete [] bufPtr; }
+    ~BaseBufferArg() { if (!hostPtr) delete [] bufPtr; }
 
     /**
      * copy data into simulator space (read from target memory)
      */
     bool copyIn(SETranslatingPortProxy &memproxy)
     {
-        memproxy.readBlob(addr, bufPtr, size);
+        if (!hostPtr)
+            memproxy.readBlob(addr, bufPtr, size);
         return true;    // no EFAULT detection for now
     }
 
@@ -86,13 +97,28 @@ class BaseBufferArg {
      */
     bool copyOut(SETranslatingPortProxy &memproxy)
     {
-        memproxy.writeBlob(addr, bufPtr, size);
+        if (!hostPtr)
+            memproxy.writeBlob(addr, bufPtr, size);
+        else
+            memproxy.notifyWrite(addr, bufPtr, size);
         return true;    // no EFAULT detection for now
     }
 
+  private:
+    static uint8_t *alloc(int size)
+    {
+        uint8_t *buf = new uint8_t[size];
+        // clear out buffer: in case we only partially populate this,
+        // and then do a copyOut(), we want to make sure we don't
+        // introduce any random junk into the simulated address space
+        memset(buf, 0, size);
+        return buf;
+    }
+
   protected:
     const Addr addr;        ///< address of buffer in target address space
     const int size;         ///< buffer size
+    uint8_t * const hostPtr; ///< target memory in simulator space, or NULL
     uint8_t * const bufPtr; ///< pointer to buffer in simulator space
 };
 
@@ -109,6 +135,14 @@ class BufferArg : public BaseBufferArg
      */
     BufferArg(Addr _addr, int _size) : BaseBufferArg(_addr, _size) { }
 
+    /**
+     * Represent the memory at target address 'addr', using it in
+     * place where possible.
+     */
+    BufferArg(Addr _addr, int _size, SETranslatingPortProxy &memproxy)
+        : BaseBufferArg(_addr, _size, memproxy)
+    { }
+
     /**
      * Return a pointer to the internal simulator-space buffer.
      */
@@ -48,6 +48,7 @@
 #include "arch/remote_gdb.hh"
 #include "arch/utility.hh"
 #include "base/loader/object_file.hh"
+#include "base/loader/region_map.hh"
 #include "base/loader/symtab.hh"
 #include "base/str.hh"
 #include "base/trace.hh"
@@ -82,14 +83,19 @@ System::System(Params *p)
       _numContexts(0),
       pagePtr(0),
       init_param(p->init_param),
-      physProxy(_systemPort, p->cache_line_size),
+      physProxy(_systemPort, p->cache_line_size, this),
       kernelSymtab(nullptr),
       kernel(nullptr),
       loadAddrMask(p->load_addr_mask),
       loadAddrOffset(p->load_offset),
       nextPID(0),
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->mmap_using_huge_pages,
+              p->mem_checkpoint_format,
+              p->mem_checkpoint_compression,
+              p->mem_checkpoint_incremental),
       memoryMode(p->mem_mode),
+      numCachingAgents(0),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
       workItemsEnd(0),
@@ -101,6 +107,9 @@ System::System(Params *p)
     // add self to global system list
     systemList.push_back(this);
 
+    // the region of interest must be known before any symbols are loaded
+    debugRegionMap.setROIPatterns(p->roi_functions);
+
     if (FullSystem) {
         kernelSymtab = new SymbolTable;
         if (!debugSymbolTable)
@@ -151,6 +160,8 @@ System::System(Params *p)
             if (!kernel->loadLocalSymbols(debugSymbolTable))
                 fatal("could not load kernel local symbols\n");
 
+            debugRegionMap.build(*debugSymbolTable);
+
             // Loading only needs to happen once and after memory system is
             // connected so it will happen in initState()
         }
@@ -267,6 +278,18 @@ System::numRunningContexts()
     return running;
 }
 
+bool
+System::allQuiesced()
+{
+    for (auto sys : systemList) {
+        for (auto tc : sys->threadContexts) {
+            if (tc->status() == ThreadContext::Active)
+                return false;
+        }
+    }
+    return true;
+}
+
 void
 System::initState()
 {
@@ -399,6 +422,15 @@ System::unserialize(Checkpoint *cp, const string &section)
     physmem.unserialize(cp, csprintf("%s.physmem", name()));
 }
 
+uint64_t
+System::hostMemUsage() const
+{
+    uint64_t bytes = 0;
+    for (auto &store : physmem.getBackingStore())
+        bytes += store.first.size();
+    return bytes;
+}
+
 void
 System::regStats()
 {
@@ -163,6 +163,23 @@ class System : public MemObject
     bool bypassCaches() const {
         return memoryMode == Enums::atomic_noncaching;
     }
+
+    /**
+     * Register an object that can hold copies of memory, e.g. a
+     * cache, which rules out functional accesses going straight to
+     * the backing store.
+     */
+    void registerCachingAgent() { ++numCachingAgents; }
+
+    /**
+     * Can functional accesses go straight to the backing store? This
+     * is the case when the caches are bypassed, or in atomic mode if
+     * nothing can hold a copy of the memory.
+     */
+    bool directFunctionalAccess() const {
+        return bypassCaches() ||
+            (isAtomicMode() && numCachingAgents == 0);
+    }
     /** @} */
 
     /** @{ */
@@ -212,6 +229,10 @@ class System : public MemObject
      * system.  These threads could be Active or Suspended. */
     int numRunningContexts();
 
+    /** Return true if no thread context of any system is active, as
+     * when every core has quiesced waiting for an interrupt. */
+    static bool allQuiesced();
+
     Addr pagePtr;
 
     uint64_t init_param;
@@ -298,6 +319,9 @@ class System : public MemObject
 
     Enums::MemoryMode memoryMode;
 
+    /** Number of objects that can hold copies of memory */
+    unsigned numCachingAgents;
+
     const unsigned int _cacheLineSize;
 
     uint64_t workItemsBegin;
@@ -335,6 +359,10 @@ class System : public MemObject
     }
 
     virtual void regStats();
+
+    /** The backing store of the physical memory, as reserved. */
+    virtual uint64_t hostMemUsage() const;
+
     /**
      * Called by pseudo_inst to track the number of work items started by this
      * system.
@@ -0,0 +1,236 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/hostinfo.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/socket.hh"
+#include "cpu/base.hh"
+#include "sim/async.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+#include "sim/telemetry.hh"
+
+Telemetry *Telemetry::instance = NULL;
+
+Telemetry::Telemetry(const Params *p)
+    : SimObject(p),
+      socketPath(simout.resolve(p->socket)),
+      interval(p->interval),
+      statNames(p->stats),
+      statsFound(false),
+      listenFd(-1),
+      lastInsts(0),
+      stopping(false)
+{
+    if (instance != NULL)
+        fatal("Only one Telemetry object is supported\n");
+    instance = this;
+
+    if (p->interval <= 0)
+        fatal("%s: the interval must be positive\n", name());
+
+    sockaddr_un addr;
+    if (socketPath.size() >= sizeof(addr.sun_path))
+        fatal("%s: socket path %s is too long\n", name(), socketPath);
+}
+
+void
+Telemetry::startup()
+{
+    if (ListenSocket::allDisabled()) {
+        warn("%s: listeners are disabled, not publishing telemetry\n",
+             name());
+        return;
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        panic("%s: can't create socket: %s\n", name(), strerror(errno));
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    // A stale socket from an earlier run in the same directory
+    unlink(socketPath.c_str());
+
+    if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, 16) < 0) {
+        warn("%s: can't listen on %s: %s\n", name(), socketPath,
+             strerror(errno));
+        close(listenFd);
+        listenFd = -1;
+        return;
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+
+    inform("%s: publishing telemetry on %s\n", name(), socketPath);
+
+    startTime = lastTime = sampleTime = Clock::now();
+    registerExitCallback(new MakeCallback<Telemetry, &Telemetry::stop>(this));
+    server = std::thread(&Telemetry::serveLoop, this);
+}
+
+void
+Telemetry::serviceSample()
+{
+    if (instance)
+        instance->sample();
+}
+
+void
+Telemetry::findStats()
+{
+    Stats::NameMapType &names = Stats::nameMap();
+    for (auto &name : statNames) {
+        auto it = names.find(name);
+        if (it == names.end() ||
+            (!dynamic_cast<const Stats::ScalarInfo *>(it->second) &&
+             !dynamic_cast<const Stats::VectorInfo *>(it->second))) {
+            warn("%s: no scalar or vector stat %s\n", this->name(), name);
+            continue;
+        }
+        stats.push_back(it->second);
+    }
+    statsFound = true;
+}
+
+void
+Telemetry::sample()
+{
+    if (!statsFound)
+        findStats();
+
+    Clock::time_point now = Clock::now();
+    Counter insts = BaseCPU::numSimulatedInsts();
+    double elapsed = std::chrono::duration<double>(now - lastTime).count();
+    double mips = elapsed > 0 ? (insts - lastInsts) / elapsed / 1e6 : 0;
+    lastTime = now;
+    lastInsts = insts;
+
+    std::string fields = csprintf("\"tick\": %d, \"sim_insts\": %d, "
+        "\"sim_ops\": %d, \"host_seconds\": %.3f, \"host_mips\": %.3f, "
+        "\"host_mem\": %d", curTick(), (uint64_t)insts,
+        (uint64_t)BaseCPU::numSimulatedOps(),
+        std::chrono::duration<double>(now - startTime).count(), mips,
+        memUsage());
+
+    // Vectors and formulae go in as their total
+    for (auto info : stats) {
+        auto scalar = dynamic_cast<const Stats::ScalarInfo *>(info);
+        double value = scalar ? scalar->value() :
+            static_cast<const Stats::VectorInfo *>(info)->total();
+        fields += csprintf(", \"%s\": %g", info->name, value);
+    }
+
+    std::lock_guard<std::mutex> held(lock);
+    sampleFields.swap(fields);
+    sampleTime = now;
+}
+
+void
+Telemetry::publish()
+{
+    int fd;
+    while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        clients.push_back(fd);
+    }
+
+    std::string line;
+    {
+        std::lock_guard<std::mutex> held(lock);
+        if (sampleFields.empty())
+            return;
+        line = csprintf("{%s, \"age\": %.3f}\n", sampleFields,
+            std::chrono::duration<double>(Clock::now() - sampleTime).count());
+    }
+
+    // Drop clients that went away or can't keep up, rather than
+    // sending them a partial line
+    for (auto it = clients.begin(); it != clients.end(); ) {
+        ssize_t sent = send(*it, line.data(), line.size(), MSG_NOSIGNAL);
+        if (sent != (ssize_t)line.size()) {
+            close(*it);
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+Telemetry::serveLoop()
+{
+    std::unique_lock<std::mutex> held(lock);
+    while (!wakeup.wait_for(held, interval, [this] { return stopping; })) {
+        // Ask the simulation loop for the next sample, and send out
+        // the last one meanwhile
+        async_telemetry = true;
+        async_event = true;
+
+        held.unlock();
+        publish();
+        held.lock();
+    }
+}
+
+void
+Telemetry::stop()
+{
+    {
+        std::lock_guard<std::mutex> held(lock);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    server.join();
+
+    for (auto fd : clients)
+        close(fd);
+    clients.clear();
+    close(listenFd);
+    unlink(socketPath.c_str());
+}
+
+Telemetry *
+TelemetryParams::create()
+{
+    return new Telemetry(this);
+}
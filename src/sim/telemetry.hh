@@ -0,0 +1,125 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_TELEMETRY_HH__
+#define __SIM_TELEMETRY_HH__
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "params/Telemetry.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Progress of a running simulation, published on a UNIX domain socket
+ * in the output directory. A server thread wakes up every interval
+ * (host seconds) and asks the simulation loop for a sample through
+ * the async event flags, so the stats are only ever read from a
+ * simulation thread, between events. It then sends every connected
+ * client the latest sample as a line of JSON: the current tick,
+ * instructions and ops simulated, host seconds, host MIPS over the
+ * last interval, host memory, any extra stats asked for by name, and
+ * the age of the sample. The age keeps growing while the simulation
+ * is stuck in an event, which is how a client tells a hang from a
+ * slow run.
+ */
+class Telemetry : public SimObject
+{
+  public:
+    typedef TelemetryParams Params;
+
+    Telemetry(const Params *p);
+
+    void startup();
+
+    /**
+     * Take a sample, from the simulation loop on async_telemetry.
+     */
+    static void serviceSample();
+
+  private:
+    /** The one telemetry object, asked for samples */
+    static Telemetry *instance;
+
+    /** Socket path, resolved in the output directory */
+    const std::string socketPath;
+
+    /** Host seconds between samples */
+    const std::chrono::duration<double> interval;
+
+    /** Extra stats in every sample, by name */
+    const std::vector<std::string> statNames;
+
+    /** The extra stats, found on the first sample */
+    std::vector<const Stats::Info *> stats;
+    bool statsFound;
+
+    int listenFd;
+
+    /** Connected clients, only touched by the server thread */
+    std::vector<int> clients;
+
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point startTime;
+
+    /** For the host MIPS of the last interval */
+    Clock::time_point lastTime;
+    Counter lastInsts;
+
+    /** Guards everything below it */
+    std::mutex lock;
+
+    /** Fields of the latest sample, without the braces */
+    std::string sampleFields;
+    Clock::time_point sampleTime;
+
+    bool stopping;
+    std::condition_variable wakeup;
+    std::thread server;
+
+    /** Find the extra stats by name */
+    void findStats();
+
+    void sample();
+
+    /** Accept new clients and send them the latest sample */
+    void publish();
+
+    /** The server thread */
+    void serveLoop();
+
+    /** Stop the server and remove the socket, on exit */
+    void stop();
+};
+
+#endif // __SIM_TELEMETRY_HH__
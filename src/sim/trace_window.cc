@@ -0,0 +1,389 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/trace_window.hh"
+
+#include "base/loader/symtab.hh"
+#include "base/misc.hh"
+#include "base/str.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+
+namespace Trace {
+
+TraceWindows traceWindows;
+
+RingLogger::RingLogger(Logger *target_, size_t size) :
+    target(target_),
+    ring(size),
+    next(0),
+    full(false),
+    capturing(false),
+    streambuf(*this),
+    ringStream(&streambuf)
+{ }
+
+RingLogger::~RingLogger()
+{
+    delete target;
+}
+
+std::streambuf::int_type
+RingLogger::RingStreambuf::overflow(int_type c)
+{
+    if (c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    line += traits_type::to_char_type(c);
+    if (c == '\n') {
+        logger.keep(line);
+        line.clear();
+    }
+
+    return c;
+}
+
+void
+RingLogger::keep(const std::string &message)
+{
+    ring[next] = message;
+    next++;
+    if (next == ring.size()) {
+        next = 0;
+        full = true;
+    }
+}
+
+void
+RingLogger::setCapturing(bool capture)
+{
+    if (capturing && !capture) {
+        std::ostream &stream = target->getOstream();
+        size_t first = full ? next : 0;
+        size_t count = full ? ring.size() : next;
+
+        for (size_t i = 0; i < count; i++) {
+            std::string &message = ring[(first + i) % ring.size()];
+            stream << message;
+            message.clear();
+        }
+        stream.flush();
+
+        next = 0;
+        full = false;
+    }
+
+    capturing = capture;
+}
+
+void
+RingLogger::logMessage(Tick when, const std::string &name,
+                       const std::string &message)
+{
+    if (!capturing) {
+        target->logMessage(when, name, message);
+        return;
+    }
+
+    std::string formatted;
+
+    if (when != MaxTick)
+        formatted = csprintf("%7d: ", when);
+    if (!name.empty())
+        formatted += name + ": ";
+    formatted += message;
+
+    keep(formatted);
+}
+
+/** Opens or closes a window at a tick */
+class TraceWindowEvent : public Event
+{
+  protected:
+    TraceWindows &windows;
+    unsigned int index;
+    bool openWindow;
+
+  public:
+    TraceWindowEvent(TraceWindows &windows_, unsigned int index_,
+        bool open_window) :
+        Event(Debug_Enable_Pri, AutoDelete),
+        windows(windows_), index(index_), openWindow(open_window)
+    { }
+
+    void
+    process()
+    {
+        if (openWindow)
+            windows.openWindow(index);
+        else
+            windows.closeWindow(index);
+    }
+
+    const char *description() const { return "trace window"; }
+};
+
+TraceWindows::TraceWindows() :
+    numOpen(0),
+    numInsts(0),
+    symbolsResolved(false),
+    preTrigger(0),
+    ring(NULL),
+    watchCommits(false)
+{ }
+
+TraceWindows::Trigger
+TraceWindows::parseTrigger(const std::string &spec, bool is_stop)
+{
+    Trigger trigger;
+    std::string kind = spec;
+    std::string value;
+    size_t colon = spec.find(':');
+
+    if (colon != std::string::npos) {
+        kind = spec.substr(0, colon);
+        value = spec.substr(colon + 1);
+    }
+
+    if (is_stop && startswith(kind, "+")) {
+        trigger.relative = true;
+        kind = kind.substr(1);
+    }
+
+    if (kind == "tick") {
+        trigger.kind = TickTrigger;
+    } else if (kind == "inst") {
+        trigger.kind = InstTrigger;
+    } else if (kind == "sym" && !trigger.relative && value != "") {
+        trigger.kind = SymbolTrigger;
+        trigger.symbol = value;
+        return trigger;
+    } else if (kind == "fault" && !trigger.relative && value == "") {
+        trigger.kind = FaultTrigger;
+        return trigger;
+    } else {
+        fatal("Bad trace window trigger: %s\n", spec);
+    }
+
+    if (!to_number(value, trigger.value))
+        fatal("Bad trace window trigger: %s\n", spec);
+
+    return trigger;
+}
+
+void
+TraceWindows::addWindow(const std::string &spec)
+{
+    Window window;
+    size_t comma = spec.find(',');
+
+    window.start = parseTrigger(spec.substr(0, comma), false);
+    if (comma != std::string::npos)
+        window.stop = parseTrigger(spec.substr(comma + 1), true);
+
+    windows.push_back(window);
+}
+
+void
+TraceWindows::schedule(unsigned int index, bool open_window, Tick when)
+{
+    EventQueue *queue = curEventQueue();
+
+    /* Before the simulation starts, from Python */
+    if (!queue)
+        queue = getEventQueue(0);
+
+    queue->schedule(new TraceWindowEvent(*this, index, open_window), when);
+}
+
+void
+TraceWindows::start()
+{
+    if (windows.empty())
+        return;
+
+    if (preTrigger) {
+        ring = new RingLogger(getDebugLogger(), preTrigger);
+        setDebugLogger(ring);
+        ring->setCapturing(true);
+    }
+    Trace::enabled = ring != NULL;
+
+    for (unsigned int i = 0; i < windows.size(); i++) {
+        const Window &window = windows[i];
+
+        if (window.start.kind == TickTrigger)
+            schedule(i, true, window.start.value);
+        if (window.stop.kind == TickTrigger && !window.stop.relative)
+            schedule(i, false, window.stop.value);
+    }
+
+    updateWatching();
+}
+
+void
+TraceWindows::updateWatching()
+{
+    watchCommits = false;
+
+    for (auto i = windows.begin(); i != windows.end(); ++i) {
+        if (i->done)
+            continue;
+
+        TriggerKind start = i->start.kind;
+        TriggerKind stop = i->stop.kind;
+
+        if (start == InstTrigger || start == SymbolTrigger ||
+            stop == InstTrigger || stop == SymbolTrigger)
+        {
+            watchCommits = true;
+        }
+    }
+}
+
+void
+TraceWindows::resolveSymbols()
+{
+    for (auto i = windows.begin(); i != windows.end(); ++i) {
+        Trigger *triggers[] = { &i->start, &i->stop };
+
+        for (Trigger *trigger : triggers) {
+            if (trigger->kind == SymbolTrigger &&
+                (!debugSymbolTable || !debugSymbolTable->findAddress(
+                    trigger->symbol, trigger->value)))
+            {
+                fatal("Trace window symbol not found: %s\n",
+                    trigger->symbol);
+            }
+        }
+    }
+
+    symbolsResolved = true;
+}
+
+void
+TraceWindows::openWindow(unsigned int index)
+{
+    Window &window = windows[index];
+
+    if (window.open || window.done)
+        return;
+
+    window.open = true;
+    window.openInsts = numInsts;
+
+    if (numOpen == 0) {
+        if (ring)
+            ring->setCapturing(false);
+        Trace::enabled = true;
+    }
+    numOpen++;
+
+    if (window.stop.kind == TickTrigger && window.stop.relative)
+        schedule(index, false, curTick() + window.stop.value);
+}
+
+void
+TraceWindows::closeWindow(unsigned int index)
+{
+    Window &window = windows[index];
+
+    if (window.done)
+        return;
+
+    /* A stop before the start cancels the window */
+    window.done = true;
+    updateWatching();
+
+    if (!window.open)
+        return;
+
+    window.open = false;
+
+    numOpen--;
+    if (numOpen == 0) {
+        if (ring)
+            ring->setCapturing(true);
+        else
+            Trace::enabled = false;
+    }
+}
+
+void
+TraceWindows::commitInst(Addr pc)
+{
+    if (!symbolsResolved)
+        resolveSymbols();
+
+    numInsts++;
+
+    for (unsigned int i = 0; i < windows.size(); i++) {
+        Window &window = windows[i];
+
+        if (window.done)
+            continue;
+
+        if (!window.open) {
+            const Trigger &start = window.start;
+            const Trigger &stop = window.stop;
+
+            if (stop.kind == InstTrigger && !stop.relative &&
+                numInsts >= stop.value)
+            {
+                closeWindow(i);
+            } else if ((start.kind == InstTrigger &&
+                numInsts >= start.value) ||
+                (start.kind == SymbolTrigger && pc == start.value))
+            {
+                openWindow(i);
+            }
+        } else {
+            const Trigger &stop = window.stop;
+            uint64_t insts = numInsts -
+                (stop.relative ? window.openInsts : 0);
+
+            if ((stop.kind == InstTrigger && insts >= stop.value) ||
+                (stop.kind == SymbolTrigger && pc == stop.value))
+            {
+                closeWindow(i);
+            }
+        }
+    }
+}
+
+void
+TraceWindows::fault()
+{
+    for (unsigned int i = 0; i < windows.size(); i++) {
+        if (windows[i].open && windows[i].stop.kind == FaultTrigger)
+            closeWindow(i);
+        else if (windows[i].start.kind == FaultTrigger)
+            openWindow(i);
+    }
+}
+
+} // namespace Trace
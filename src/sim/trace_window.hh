@@ -0,0 +1,232 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Trace windows: turning debug output on and off during a run on
+ * ticks, committed instruction counts, entry to a symbol or an injected
+ * fault, with an optional pre-trigger ring of the debug messages from
+ * just before each window opens.
+ */
+
+#ifndef __SIM_TRACE_WINDOW_HH__
+#define __SIM_TRACE_WINDOW_HH__
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "base/trace.hh"
+#include "base/types.hh"
+
+namespace Trace {
+
+/** Logger which passes messages on to another logger or, while
+ *  capturing, keeps only the last few of them in a ring to write out
+ *  when capturing stops.  Messages are kept formatted as
+ *  OstreamLogger would write them */
+class RingLogger : public Logger
+{
+  protected:
+    /** streambuf which gathers lines written to getOstream into ring
+     *  entries */
+    class RingStreambuf : public std::streambuf
+    {
+      protected:
+        RingLogger &logger;
+
+        /** The line being written */
+        std::string line;
+
+      public:
+        RingStreambuf(RingLogger &logger_) : logger(logger_) { }
+
+      protected:
+        int_type overflow(int_type c) M5_ATTR_OVERRIDE;
+    };
+
+    /** The logger messages are passed to, owned by this logger */
+    Logger *target;
+
+    /** The last messages, with the oldest at ring[next] once full */
+    std::vector<std::string> ring;
+    size_t next;
+    bool full;
+
+    bool capturing;
+
+    RingStreambuf streambuf;
+    std::ostream ringStream;
+
+    /** Add a message to the ring, overwriting the oldest one */
+    void keep(const std::string &message);
+
+  public:
+    RingLogger(Logger *target_, size_t size);
+
+    ~RingLogger();
+
+    /** Start keeping messages in the ring, or stop and write the ring
+     *  out to the target */
+    void setCapturing(bool capture);
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) M5_ATTR_OVERRIDE;
+
+    std::ostream &getOstream() M5_ATTR_OVERRIDE
+    { return capturing ? ringStream : target->getOstream(); }
+
+    void flush() M5_ATTR_OVERRIDE { target->flush(); }
+};
+
+/** The trace windows of a run.  Each window opens once, on its start
+ *  trigger, and closes on its stop trigger, if it has one.  Debug
+ *  output is enabled only while at least one window is open.  The
+ *  windows are given as START[,STOP] with triggers:
+ *
+ *  tick:N   at tick N
+ *  inst:N   at the Nth committed instruction (micro-ops count
+ *           separately) of all the CPUs
+ *  sym:NAME on committing the first instruction of symbol NAME
+ *  fault    when a fault is injected
+ *  +tick:N  (STOP only) N ticks after the window opened
+ *  +inst:N  (STOP only) N instructions after the window opened */
+class TraceWindows
+{
+  public:
+    enum TriggerKind
+    {
+        NoTrigger,
+        TickTrigger,
+        InstTrigger,
+        SymbolTrigger,
+        FaultTrigger
+    };
+
+    struct Trigger
+    {
+        TriggerKind kind;
+        /** Counted from the window opening rather than the run start */
+        bool relative;
+        /** Tick, instruction count or, once resolved, symbol address */
+        uint64_t value;
+        std::string symbol;
+
+        Trigger() : kind(NoTrigger), relative(false), value(0) { }
+    };
+
+    struct Window
+    {
+        Trigger start;
+        Trigger stop;
+        bool open;
+        bool done;
+        /** Instruction count at opening, for +inst stops */
+        uint64_t openInsts;
+
+        Window() : open(false), done(false), openInsts(0) { }
+    };
+
+  protected:
+    std::vector<Window> windows;
+
+    /** Number of windows now open */
+    unsigned int numOpen;
+
+    /** Instructions committed while watching commits */
+    uint64_t numInsts;
+
+    bool symbolsResolved;
+
+    /** Messages to keep from before windows open */
+    size_t preTrigger;
+
+    /** The logger keeping them, if preTrigger */
+    RingLogger *ring;
+
+    /** Parse one trigger, fatal if it isn't valid */
+    Trigger parseTrigger(const std::string &spec, bool is_stop);
+
+    /** Look up the addresses of sym: triggers */
+    void resolveSymbols();
+
+    /** Whether any window still needs commitInst calls */
+    void updateWatching();
+
+    /** Schedule a window to open or close at a tick */
+    void schedule(unsigned int index, bool open_window, Tick when);
+
+  public:
+    /** Set when commitInst must be called for each committed
+     *  instruction */
+    bool watchCommits;
+
+    TraceWindows();
+
+    /** Add a window from its START[,STOP] description */
+    void addWindow(const std::string &spec);
+
+    /** Keep the last events debug messages from outside windows */
+    void setPreTrigger(size_t events) { preTrigger = events; }
+
+    /** Take over Trace::enabled and schedule the tick triggers.  Called
+     *  once the windows are added and the debug logger chosen */
+    void start();
+
+    void openWindow(unsigned int index);
+    void closeWindow(unsigned int index);
+
+    /** Count a committed instruction and act on its triggers */
+    void commitInst(Addr pc);
+
+    /** Act on the fault triggers as a fault is injected */
+    void fault();
+};
+
+extern TraceWindows traceWindows;
+
+/** Call at each instruction commit, this costs a test unless a window
+ *  has instruction count or symbol triggers */
+inline void
+windowCommit(Addr pc)
+{
+    if (traceWindows.watchCommits)
+        traceWindows.commitInst(pc);
+}
+
+/** Call as each fault is injected */
+inline void
+windowFault()
+{
+    traceWindows.fault();
+}
+
+} // namespace Trace
+
+#endif // __SIM_TRACE_WINDOW_HH__
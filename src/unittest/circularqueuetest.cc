@@ -0,0 +1,150 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+
+#include "base/circular_queue.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+int
+main()
+{
+    CircularQueue<int> q(4);
+
+    setCase("empty queue");
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.full());
+    EXPECT_EQ(q.size(), 0);
+    EXPECT_EQ(q.capacity(), 4);
+    EXPECT_TRUE(q.begin() == q.end());
+
+    setCase("full queue");
+    for (int i = 0; i < 4; ++i)
+        q.push_back(i);
+    EXPECT_TRUE(q.full());
+    EXPECT_FALSE(q.empty());
+    EXPECT_EQ(q.size(), 4);
+    EXPECT_EQ(q.front(), 0);
+    EXPECT_EQ(q.back(), 3);
+
+    setCase("wrap at the tail");
+    // Each round pops one slot and reuses it, so after the loop the
+    // head has gone round the storage several times.
+    for (int i = 4; i < 11; ++i) {
+        EXPECT_EQ(q.front(), i - 4);
+        q.pop_front();
+        EXPECT_FALSE(q.full());
+        q.push_back(i);
+        EXPECT_TRUE(q.full());
+    }
+    EXPECT_EQ(q.front(), 7);
+    EXPECT_EQ(q.back(), 10);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(q[i], 7 + i);
+
+    setCase("wrap at the head");
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.begin() == q.end());
+    q.push_front(1);
+    q.push_front(0);
+    q.push_back(2);
+    EXPECT_EQ(q.size(), 3);
+    EXPECT_EQ(q[0], 0);
+    EXPECT_EQ(q[1], 1);
+    EXPECT_EQ(q[2], 2);
+    q.pop_back();
+    EXPECT_EQ(q.back(), 1);
+    q.pop_front();
+    q.pop_front();
+    EXPECT_TRUE(q.empty());
+
+    setCase("iterator arithmetic");
+    for (int i = 0; i < 4; ++i)
+        q.push_back(10 + i);
+    q.pop_front();
+    q.push_back(14);
+    CircularQueue<int>::iterator it = q.begin();
+    EXPECT_EQ(*it, 11);
+    ++it;
+    EXPECT_EQ(*it, 12);
+    it++;
+    EXPECT_EQ(*it, 13);
+    --it;
+    EXPECT_EQ(*it, 12);
+    it--;
+    EXPECT_TRUE(it == q.begin());
+    int count = 0;
+    for (it = q.begin(); it != q.end(); ++it)
+        EXPECT_EQ(*it, 11 + count++);
+    EXPECT_EQ(count, 4);
+    it = q.end();
+    --it;
+    EXPECT_EQ(*it, 14);
+    count = 0;
+    for (it = q.end(); it != q.begin(); ++count)
+        --it;
+    EXPECT_EQ(count, 4);
+
+    setCase("iterator stability");
+    it = q.begin();
+    ++it;
+    CircularQueue<int>::iterator end = q.end();
+    q.pop_back();
+    q.pop_front();
+    EXPECT_EQ(*it, 12);
+    EXPECT_TRUE(end == q.end());
+    q.push_back(20);
+    q.push_front(21);
+    EXPECT_EQ(*it, 12);
+    EXPECT_TRUE(end == q.end());
+    --it;
+    EXPECT_EQ(*it, 21);
+
+    setCase("resize");
+    q.clear();
+    q.resize(2);
+    EXPECT_EQ(q.capacity(), 2);
+    q.push_back(1);
+    q.push_back(2);
+    EXPECT_TRUE(q.full());
+    q.pop_front();
+    q.push_back(3);
+    EXPECT_EQ(q[0], 2);
+    EXPECT_EQ(q[1], 3);
+
+    CircularQueue<string> s(3);
+    s.push_back("a");
+    s.push_back("b");
+    s.pop_front();
+    EXPECT_EQ(s.front(), "b");
+
+    return UnitTest::printResults();
+}
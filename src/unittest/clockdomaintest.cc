@@ -0,0 +1,199 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/philox.hh"
+#include "params/DerivedClockDomain.hh"
+#include "params/SrcClockDomain.hh"
+#include "params/VoltageDomain.hh"
+#include "sim/clock_domain.hh"
+#include "sim/clocked_object.hh"
+#include "sim/voltage_domain.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+class TestObject : public ClockedObject
+{
+  public:
+    TestObject(const ClockedObjectParams *p) : ClockedObject(p) { }
+
+    using ClockedObject::resetClock;
+};
+
+/**
+ * The clock of an object as it was kept before clocked objects
+ * realigned lazily: the domain brought every member up to the current
+ * tick with the old period before changing it.
+ */
+struct EagerClock
+{
+    Tick period;
+    Tick tick;
+    uint64_t cycle;
+
+    EagerClock(Tick p) : period(p), tick(0), cycle(0) { }
+
+    void
+    update(Tick now)
+    {
+        if (tick >= now)
+            return;
+        tick += period;
+        ++cycle;
+        if (tick >= now)
+            return;
+        uint64_t elapsed = divCeil(now - tick, period);
+        cycle += elapsed;
+        tick += elapsed * period;
+    }
+
+    void
+    change(Tick now, Tick p)
+    {
+        update(now);
+        period = p;
+    }
+
+    void
+    reset(Tick now)
+    {
+        cycle = divCeil(now, period);
+        tick = cycle * period;
+    }
+};
+
+int
+main()
+{
+    EventQueue *eq = getEventQueue(0);
+    curEventQueue(eq);
+
+    VoltageDomainParams vp;
+    vp.name = "voltage";
+    vp.eventq_index = 0;
+    vp.voltage.push_back(1.0);
+    VoltageDomain vdom(&vp);
+
+    SrcClockDomainParams sp;
+    sp.name = "src";
+    sp.eventq_index = 0;
+    sp.clock.push_back(1000);
+    sp.domain_id = SrcClockDomain::emptyDomainID;
+    sp.init_perf_level = 0;
+    sp.voltage_domain = &vdom;
+    SrcClockDomain src(&sp);
+
+    const unsigned divider = 3;
+    DerivedClockDomainParams dp;
+    dp.name = "derived";
+    dp.eventq_index = 0;
+    dp.clk_divider = divider;
+    dp.clk_domain = &src;
+    DerivedClockDomain derived(&dp);
+
+    // even objects are in the source domain, odd ones in the derived
+    const int num_objects = 8;
+    vector<ClockedObjectParams> params(num_objects);
+    vector<TestObject *> objects;
+    vector<EagerClock> models;
+    for (int i = 0; i < num_objects; i++) {
+        params[i].name = csprintf("object%d", i);
+        params[i].eventq_index = 0;
+        params[i].clk_domain = i % 2 ? (ClockDomain *)&derived : &src;
+        objects.push_back(new TestObject(&params[i]));
+        models.push_back(EagerClock(i % 2 ? divider * 1000 : 1000));
+    }
+
+    setCase("fixed period");
+    eq->setCurTick(0);
+    EXPECT_EQ(objects[0]->clockEdge(), 0);
+    eq->setCurTick(1);
+    EXPECT_EQ(objects[0]->clockEdge(), 1000);
+    EXPECT_EQ(objects[0]->curCycle(), 1);
+    EXPECT_EQ(objects[1]->clockEdge(), 3000);
+    EXPECT_EQ(objects[1]->curCycle(), 1);
+
+    setCase("period change");
+    eq->setCurTick(2500);
+    src.clockPeriod(500);
+    eq->setCurTick(3100);
+    // the old period runs to 3000, then edges are 500 ticks apart
+    EXPECT_EQ(objects[0]->clockEdge(), 3500);
+    EXPECT_EQ(objects[0]->curCycle(), 4);
+    EXPECT_EQ(objects[1]->clockEdge(), 4500);
+    EXPECT_EQ(objects[1]->curCycle(), 2);
+    src.clockPeriod(1000);
+
+    setCase("random changes and queries");
+    // Compare against the eager scheme over random period changes,
+    // clock resets and queries, at random and often repeated ticks.
+    Philox rng(1, 0);
+    Tick now = 3100;
+    bool same = true;
+    unsigned changes = 0;
+    for (int i = 0; i < num_objects; i++) {
+        objects[i]->resetClock();
+        models[i].reset(now);
+    }
+    for (int op = 0; op < 200000 && same; op++) {
+        if (rng.next() % 2)
+            now += rng.next() % 3 ? rng.next() % 1500 : rng.next() % 50000;
+        eq->setCurTick(now);
+
+        unsigned action = rng.next() % 64;
+        if (action == 0) {
+            Tick period = 100 + rng.next() % 3000;
+            for (int i = 0; i < num_objects; i++)
+                models[i].change(now, i % 2 ? divider * period : period);
+            src.clockPeriod(period);
+            ++changes;
+        } else if (action == 1) {
+            int i = rng.next() % num_objects;
+            objects[i]->resetClock();
+            models[i].reset(now);
+        } else {
+            int i = rng.next() % num_objects;
+            Cycles ahead(rng.next() % 4);
+            models[i].update(now);
+            same = objects[i]->clockEdge(ahead) ==
+                models[i].tick + ahead * models[i].period &&
+                objects[i]->curCycle() == models[i].cycle &&
+                objects[i]->clockPeriod() == models[i].period;
+        }
+    }
+    EXPECT_TRUE(same);
+    EXPECT_TRUE(changes > 1000);
+
+    for (auto o : objects)
+        delete o;
+
+    return UnitTest::printResults();
+}
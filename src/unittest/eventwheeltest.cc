@@ -0,0 +1,187 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vector>
+
+#include "base/philox.hh"
+#include "sim/eventq_impl.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+/** Logs its number to the service order of its queue. */
+class LogEvent : public Event
+{
+  private:
+    int id;
+    vector<int> &order;
+
+  public:
+    LogEvent(int _id, Priority prio, vector<int> &_order)
+        : Event(prio), id(_id), order(_order)
+    { }
+
+    void process() { order.push_back(id); }
+};
+
+/** A queue with its own copy of the events. */
+struct TestQueue
+{
+    EventQueue eq;
+    vector<LogEvent *> events;
+    vector<int> order;
+
+    TestQueue(const char *name, const vector<Event::Priority> &prios)
+        : eq(name)
+    {
+        for (int i = 0; i < prios.size(); i++)
+            events.push_back(new LogEvent(i, prios[i], order));
+    }
+
+    ~TestQueue()
+    {
+        for (auto e : events)
+            delete e;
+    }
+};
+
+/**
+ * Apply the same random schedules, deschedules, reschedules and
+ * services to every queue, and check that the queues agree on the
+ * next tick and service the same events in the same order.
+ */
+static bool
+randomRun(vector<TestQueue *> &queues, uint64_t seed, unsigned ops,
+          unsigned switch_at = ~0U)
+{
+    Philox rng(seed, 0);
+    const int num_events = queues[0]->events.size();
+    TestQueue &ref = *queues[0];
+
+    for (unsigned op = 0; op < ops; op++) {
+        int i = rng.next() % num_events;
+        // mostly near events, some beyond the horizon of the wheels,
+        // and many sharing a tick
+        Tick delay = rng.next() % 4 ? rng.next() % 200 :
+            rng.next() % 20000;
+        delay -= delay % 5;
+        Tick when = ref.eq.getCurTick() + delay;
+        unsigned action = rng.next() % 4;
+
+        for (auto q : queues) {
+            Event *e = q->events[i];
+            if (!e->scheduled())
+                q->eq.schedule(e, when);
+            else if (action == 0)
+                q->eq.deschedule(e);
+            else
+                q->eq.reschedule(e, when);
+        }
+
+        if (op == switch_at) {
+            queues.back()->eq.setBackend(EventQueue::TimingWheel, 16, 10);
+        }
+
+        if (rng.next() % 3 == 0) {
+            bool empty = ref.eq.empty();
+            Tick next = empty ? 0 : ref.eq.nextTick();
+            for (auto q : queues) {
+                if (q->eq.empty() != empty)
+                    return false;
+                if (!empty) {
+                    if (q->eq.nextTick() != next)
+                        return false;
+                    q->eq.serviceOne();
+                }
+            }
+        }
+    }
+
+    for (auto q : queues) {
+        while (!q->eq.empty())
+            q->eq.serviceOne();
+        if (q->order != ref.order)
+            return false;
+    }
+    return true;
+}
+
+int
+main()
+{
+    const Event::Priority levels[] = {
+        Event::Minimum_Pri, Event::Default_Pri - 1, Event::Default_Pri,
+        Event::Default_Pri + 1, Event::Maximum_Pri
+    };
+
+    vector<Event::Priority> same(3, Event::Default_Pri);
+    vector<Event::Priority> prios;
+    Philox rng(7, 0);
+    for (int i = 0; i < 300; i++)
+        prios.push_back(levels[rng.next() % 5]);
+
+    setCase("bin order");
+    {
+        // events of one tick and priority run in LIFO order
+        TestQueue list("list", same), wheel("wheel", same);
+        wheel.eq.setBackend(EventQueue::TimingWheel, 16, 10);
+        for (auto q : { &list, &wheel }) {
+            for (int i = 0; i < 3; i++)
+                q->eq.schedule(q->events[i], 100);
+            while (!q->eq.empty())
+                q->eq.serviceOne();
+        }
+        vector<int> lifo = { 2, 1, 0 };
+        EXPECT_TRUE(list.order == lifo);
+        EXPECT_TRUE(wheel.order == lifo);
+        EXPECT_EQ(wheel.eq.getCurTick(), 100);
+    }
+
+    setCase("random operations");
+    {
+        TestQueue list("list", prios), wheel("wheel", prios),
+            small("small", prios);
+        wheel.eq.setBackend(EventQueue::TimingWheel);
+        // a horizon of 160 ticks sends many events to the overflow set
+        small.eq.setBackend(EventQueue::TimingWheel, 16, 10);
+        vector<TestQueue *> queues = { &list, &wheel, &small };
+        EXPECT_TRUE(randomRun(queues, 1, 50000));
+        EXPECT_EQ(list.order.size(), wheel.order.size());
+        EXPECT_TRUE(list.order.size() > 10000);
+    }
+
+    setCase("backend switch");
+    {
+        // the last queue moves its pending events onto a wheel
+        TestQueue list("list", prios), later("later", prios);
+        vector<TestQueue *> queues = { &list, &later };
+        EXPECT_TRUE(randomRun(queues, 2, 20000, 10000));
+    }
+
+    return UnitTest::printResults();
+}
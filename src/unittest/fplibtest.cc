@@ -0,0 +1,183 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include "arch/arm/insts/fplib.hh"
+#include "base/philox.hh"
+#include "unittest/unittest.hh"
+
+using namespace ArmISA;
+using UnitTest::setCase;
+
+/** Field widths of a binary floating point format. */
+template <class T>
+struct Format;
+
+template <>
+struct Format<uint32_t>
+{
+    static const int ExpBits = 8;
+    static const int MantBits = 23;
+};
+
+template <>
+struct Format<uint64_t>
+{
+    static const int ExpBits = 11;
+    static const int MantBits = 52;
+};
+
+template <class T>
+static T
+randomBits(Philox &rng)
+{
+    return (T)(((uint64_t)rng.next() << 32) | rng.next());
+}
+
+/**
+ * A random operand. Most have exponents close to the bias, where the
+ * host path is taken, and the rest are either near the ends of the
+ * exponent range or are random bit patterns (zeros, denormals,
+ * infinities and NaNs included).
+ */
+template <class T>
+static T
+randomOperand(Philox &rng)
+{
+    const int exp_bits = Format<T>::ExpBits;
+    const int mant_bits = Format<T>::MantBits;
+    const int max_exp = (1 << exp_bits) - 1;
+    const int bias = max_exp >> 1;
+
+    T bits = randomBits<T>(rng);
+    T sign = bits & (T)1 << (exp_bits + mant_bits);
+    T mant = bits & (((T)1 << mant_bits) - 1);
+    int exp;
+    switch (rng.next() % 8) {
+      case 0:
+        return bits;
+      case 1:
+        exp = rng.next() % 4;
+        break;
+      case 2:
+        exp = max_exp - rng.next() % 4;
+        break;
+      default:
+        exp = bias - bias / 4 + rng.next() % (bias / 2);
+        break;
+    }
+    return sign | (T)exp << mant_bits | mant;
+}
+
+/** A second operand, sometimes close to the first to cancel in sums. */
+template <class T>
+static T
+randomSecond(Philox &rng, T first)
+{
+    if (rng.next() % 4 == 0)
+        return first ^ (randomBits<T>(rng) & 0xff) ^
+            (T)(rng.next() % 2) << (sizeof(T) * 8 - 1);
+    return randomOperand<T>(rng);
+}
+
+/** A random FPSCR, rounding to nearest three times in four. */
+static FPSCR
+randomFpscr(Philox &rng)
+{
+    FPSCR fpscr = 0;
+    fpscr.fz = rng.next() % 2;
+    fpscr.dn = rng.next() % 2;
+    fpscr.rMode = rng.next() % 4 == 0 ? rng.next() % 4 : 0;
+    if (rng.next() % 2)
+        fpscr = (uint32_t)fpscr | (rng.next() & FpscrExcMask);
+    return fpscr;
+}
+
+typedef enum { Add, Sub, Mul, Div } Op;
+
+template <class T>
+static T
+apply(Op op, T a, T b, FPSCR &fpscr)
+{
+    switch (op) {
+      case Add:
+        return fplibAdd<T>(a, b, fpscr);
+      case Sub:
+        return fplibSub<T>(a, b, fpscr);
+      case Mul:
+        return fplibMul<T>(a, b, fpscr);
+      default:
+        return fplibDiv<T>(a, b, fpscr);
+    }
+}
+
+/**
+ * Count the random operands on which the host path and the software
+ * routines differ in the result or in any FPSCR bit.
+ */
+template <class T>
+static int
+mismatches(Op op, uint64_t seed)
+{
+    Philox rng(seed, op);
+    int count = 0;
+    for (int i = 0; i < 1 << 18; i++) {
+        T a = randomOperand<T>(rng);
+        T b = randomSecond<T>(rng, a);
+        FPSCR host = randomFpscr(rng);
+        FPSCR soft = host;
+
+        fplibHostArith = true;
+        T host_result = apply<T>(op, a, b, host);
+        fplibHostArith = false;
+        T soft_result = apply<T>(op, a, b, soft);
+
+        if (host_result != soft_result || (uint32_t)host != (uint32_t)soft)
+            count++;
+    }
+    fplibHostArith = true;
+    return count;
+}
+
+int
+main()
+{
+    setCase("single precision");
+    EXPECT_EQ(mismatches<uint32_t>(Add, 1), 0);
+    EXPECT_EQ(mismatches<uint32_t>(Sub, 1), 0);
+    EXPECT_EQ(mismatches<uint32_t>(Mul, 1), 0);
+    EXPECT_EQ(mismatches<uint32_t>(Div, 1), 0);
+
+    setCase("double precision");
+    EXPECT_EQ(mismatches<uint64_t>(Add, 2), 0);
+    EXPECT_EQ(mismatches<uint64_t>(Sub, 2), 0);
+    EXPECT_EQ(mismatches<uint64_t>(Mul, 2), 0);
+    EXPECT_EQ(mismatches<uint64_t>(Div, 2), 0);
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,148 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/philox.hh"
+#include "mem/ruby/filters/H3BloomFilter.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+/** The H3 hash as it was computed before the byte tables, bit by bit. */
+static int
+bitLoopHash(uint64 value, int hash)
+{
+    int result = 0;
+    for (int i = 0; i < 64; i++) {
+        if (value & 1)
+            result ^= H3BloomFilter::h3Row(i, hash);
+        value >>= 1;
+    }
+    return result;
+}
+
+/** The bits the bit loop sets for an address. */
+static set<int>
+bitLoopIndices(const Address &addr, int size, int hashes, bool parallel)
+{
+    set<int> indices;
+    int par_size = size / hashes;
+    for (int i = 0; i < hashes; i++) {
+        int y = bitLoopHash(addr.getLineAddress(), i);
+        indices.insert(parallel ? y % par_size + i * par_size : y % size);
+    }
+    return indices;
+}
+
+/** The bits of a filter that are set. */
+static set<int>
+setBits(const H3BloomFilter &filter, int size)
+{
+    set<int> indices;
+    for (int i = 0; i < size; i++) {
+        if (filter[i])
+            indices.insert(i);
+    }
+    return indices;
+}
+
+/**
+ * Check on random addresses that a filter sets the bits the bit loop
+ * gives, one address at a time and in batches.
+ */
+static bool
+matchesBitLoop(int size, int hashes, bool parallel, uint64_t seed)
+{
+    string config = csprintf("%d_%d_%s", size, hashes,
+                             parallel ? "Parallel" : "Regular");
+    H3BloomFilter filter(config), batch(config);
+    Philox rng(seed, 0);
+
+    for (int round = 0; round < 200; round++) {
+        filter.clear();
+        batch.clear();
+
+        vector<Address> addrs;
+        set<int> expected;
+        for (int i = 0; i < 8; i++) {
+            uint64_t a = (uint64_t(rng.next()) << 32) | rng.next();
+            addrs.push_back(Address(a));
+
+            filter.set(addrs.back());
+            set<int> bits = bitLoopIndices(addrs.back(), size, hashes,
+                                           parallel);
+            expected.insert(bits.begin(), bits.end());
+            if (setBits(filter, size) != expected)
+                return false;
+        }
+
+        batch.setBatch(&addrs[0], addrs.size());
+        if (setBits(batch, size) != expected)
+            return false;
+
+        // half of the probes are fresh addresses
+        vector<Address> probes(addrs);
+        for (int i = 0; i < 8; i++)
+            probes.push_back(Address((uint64_t(rng.next()) << 32) |
+                                     rng.next()));
+        bool results[16];
+        batch.isSetBatch(&probes[0], probes.size(), results);
+        for (int i = 0; i < 16; i++) {
+            if (results[i] != filter.isSet(probes[i]))
+                return false;
+            if (i < 8 && !results[i])
+                return false;
+        }
+    }
+    return true;
+}
+
+int
+main()
+{
+    setCase("bit loop");
+    for (int hash = 0; hash < 16; hash++) {
+        EXPECT_EQ(bitLoopHash(0, hash), 0);
+        EXPECT_EQ(bitLoopHash(1, hash), H3BloomFilter::h3Row(0, hash));
+    }
+
+    setCase("regular filters");
+    EXPECT_TRUE(matchesBitLoop(1024, 1, false, 1));
+    EXPECT_TRUE(matchesBitLoop(4096, 4, false, 2));
+    EXPECT_TRUE(matchesBitLoop(65536, 16, false, 3));
+
+    setCase("parallel filters");
+    EXPECT_TRUE(matchesBitLoop(1024, 2, true, 4));
+    EXPECT_TRUE(matchesBitLoop(65536, 16, true, 5));
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,207 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <map>
+
+#include "base/open_hash_map.hh"
+#include "base/philox.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+/**
+ * Sends every key to the last slot, whatever the size of the map, so
+ * that probes are long and wrap round the array: the hash is the
+ * inverse of the Fibonacci multiplier times 2^64 - 1.
+ */
+struct SameHash
+{
+    size_t
+    operator()(uint64_t key) const
+    {
+        const uint64_t mult = ULL(0x9e3779b97f4a7c15);
+        uint64_t inv = mult;
+        for (int i = 0; i < 5; i++)
+            inv *= 2 - mult * inv;
+        return inv * ~ULL(0);
+    }
+};
+
+/** Whether map holds exactly the entries of ref. */
+template <class Map>
+static bool
+sameEntries(const Map &map, const std::map<uint64_t, int> &ref)
+{
+    if (map.size() != ref.size())
+        return false;
+
+    size_t visited = 0;
+    for (auto it = map.begin(); it != map.end(); ++it, ++visited) {
+        auto r = ref.find(it->key);
+        if (r == ref.end() || r->second != it->value)
+            return false;
+    }
+    if (visited != ref.size())
+        return false;
+
+    for (auto &r : ref) {
+        const int *value = map.find(r.first);
+        if (!value || *value != r.second)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Apply the same random inserts, updates and erases to map and to a
+ * std::map, comparing them as they go.
+ */
+template <class Map>
+static bool
+randomOps(Map &map, uint64_t seed, unsigned keys, unsigned ops)
+{
+    Philox rng(seed, 0);
+    std::map<uint64_t, int> ref;
+
+    for (unsigned i = 0; i < ops; i++) {
+        // line aligned keys, as the users of the map have
+        uint64_t key = uint64_t(rng.next() % keys) << 6;
+        switch (rng.next() % 3) {
+          case 0: {
+            auto res = map.insert(key);
+            if (res.second != !ref.count(key))
+                return false;
+            *res.first = i;
+            ref[key] = i;
+            break;
+          }
+          case 1:
+            if (map.erase(key) != (ref.erase(key) != 0))
+                return false;
+            break;
+          default: {
+            const int *value = map.find(key);
+            auto r = ref.find(key);
+            if ((value != NULL) != (r != ref.end()) ||
+                (value && *value != r->second)) {
+                return false;
+            }
+          }
+        }
+
+        if (i % 64 == 0 && !sameEntries(map, ref))
+            return false;
+    }
+    return sameEntries(map, ref);
+}
+
+int
+main()
+{
+    setCase("empty map");
+    OpenHashMap<uint64_t, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.slotCount(), 0);
+    EXPECT_TRUE(m.find(0x40) == NULL);
+    EXPECT_FALSE(m.erase(0x40));
+    EXPECT_TRUE(m.begin() == m.end());
+
+    setCase("insert and find");
+    auto res = m.insert(0x40);
+    EXPECT_TRUE(res.second);
+    EXPECT_EQ(*res.first, 0);
+    *res.first = 7;
+    res = m.insert(0x40);
+    EXPECT_FALSE(res.second);
+    EXPECT_EQ(*res.first, 7);
+    EXPECT_EQ(m.size(), 1);
+    EXPECT_EQ(m.slotCount(), 16);
+    EXPECT_EQ(*m.find(0x40), 7);
+    EXPECT_TRUE(m.find(0x80) == NULL);
+
+    setCase("growth");
+    for (uint64_t k = 1; k <= 100; k++)
+        *m.insert(k << 6).first = k;
+    EXPECT_EQ(m.size(), 100);
+    EXPECT_EQ(m.slotCount(), 256);
+    bool found = true;
+    for (uint64_t k = 1; k <= 100; k++)
+        found &= m.find(k << 6) && *m.find(k << 6) == (int)k;
+    EXPECT_TRUE(found);
+
+    setCase("erase and clear");
+    EXPECT_TRUE(m.erase(0x40));
+    EXPECT_FALSE(m.erase(0x40));
+    EXPECT_TRUE(m.find(0x40) == NULL);
+    EXPECT_EQ(m.size(), 99);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.slotCount(), 256);
+    EXPECT_TRUE(m.begin() == m.end());
+
+    setCase("reserve");
+    OpenHashMap<uint64_t, int> r(768, 75);
+    EXPECT_EQ(r.slotCount(), 1024);
+    for (uint64_t k = 0; k < 768; k++)
+        r.insert(k << 6);
+    EXPECT_EQ(r.slotCount(), 1024);
+    r.insert(768 << 6);
+    EXPECT_EQ(r.slotCount(), 2048);
+
+    setCase("one probe sequence");
+    // every key collides in the last slot, so erasing from the middle
+    // of the cluster has to shift the later keys back round the array
+    OpenHashMap<uint64_t, int, SameHash> s(8);
+    std::map<uint64_t, int> ref;
+    for (uint64_t k = 0; k < 8; k++) {
+        *s.insert(k).first = k;
+        ref[k] = k;
+    }
+    EXPECT_EQ(s.begin()->key, 1);
+    s.erase(3);
+    ref.erase(3);
+    s.erase(0);
+    ref.erase(0);
+    EXPECT_TRUE(sameEntries(s, ref));
+    *s.insert(3).first = 30;
+    ref[3] = 30;
+    EXPECT_TRUE(sameEntries(s, ref));
+
+    setCase("random operations");
+    OpenHashMap<uint64_t, int> dense;
+    EXPECT_TRUE(randomOps(dense, 1, 64, 20000));
+    OpenHashMap<uint64_t, int> sparse(0, 75);
+    EXPECT_TRUE(randomOps(sparse, 2, 5000, 20000));
+    OpenHashMap<uint64_t, int> fixed(512);
+    EXPECT_TRUE(randomOps(fixed, 3, 512, 20000));
+    EXPECT_EQ(fixed.slotCount(), 1024);
+    OpenHashMap<uint64_t, int, SameHash> colliding;
+    EXPECT_TRUE(randomOps(colliding, 4, 100, 5000));
+
+    return UnitTest::printResults();
+}
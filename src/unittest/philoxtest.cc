@@ -0,0 +1,99 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/philox.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+static Philox::Block
+block(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    Philox::Block blk = {{ a, b, c, d }};
+    return blk;
+}
+
+static bool
+equal(const Philox::Block &a, const Philox::Block &b)
+{
+    for (int i = 0; i < 4; i++) {
+        if (a.v[i] != b.v[i])
+            return false;
+    }
+    return true;
+}
+
+int
+main()
+{
+    // Known answers from the Random123 distribution
+    setCase("known answers");
+    EXPECT_TRUE(equal(Philox::generate(block(0, 0, 0, 0), 0),
+                      block(0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8)));
+    const uint32_t ones = 0xffffffff;
+    EXPECT_TRUE(equal(Philox::generate(block(ones, ones, ones, ones),
+                                       ULL(0xffffffffffffffff)),
+                      block(0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd)));
+    EXPECT_TRUE(equal(Philox::generate(block(0x243f6a88, 0x85a308d3,
+                                             0x13198a2e, 0x03707344),
+                                       ULL(0x299f31d0a4093822)),
+                      block(0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1)));
+
+    setCase("reproducible streams");
+    Philox a(42, 7), b(42, 7), c(42, 8), d(43, 7);
+    bool diff_stream = false, diff_key = false;
+    for (int i = 0; i < 100; i++) {
+        uint32_t va = a.next();
+        EXPECT_EQ(va, b.next());
+        diff_stream |= va != c.next();
+        diff_key |= va != d.next();
+    }
+    EXPECT_TRUE(diff_stream);
+    EXPECT_TRUE(diff_key);
+
+    setCase("reseeding");
+    a.seed(42, 7);
+    b.seed(42, 7);
+    a.next();
+    a.seed(42, 7);
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(a.next(), b.next());
+
+    setCase("bounded");
+    Philox r(1, 2);
+    int counts[6] = { 0 };
+    for (int i = 0; i < 6000; i++) {
+        uint32_t v = r.random(6);
+        EXPECT_TRUE(v < 6);
+        if (v < 6)
+            counts[v]++;
+    }
+    for (int i = 0; i < 6; i++)
+        EXPECT_TRUE(counts[i] > 800 && counts[i] < 1200);
+
+    return UnitTest::printResults();
+}
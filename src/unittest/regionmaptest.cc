@@ -0,0 +1,128 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/loader/region_map.hh"
+#include "base/loader/symtab.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+int
+main()
+{
+    SymbolTable symtab;
+    symtab.insert(0x1000, "_start");
+    symtab.insert(0x1100, "main");
+    symtab.insert(0x1200, "FUNC_kernel");
+    symtab.insert(0x1300, "printf");
+    symtab.insert(0x1400, "FUNCTIONAL");
+
+    RegionMap map;
+
+    setCase("empty map");
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.lookup(0x1100) == NULL);
+    EXPECT_FALSE(map.inROI(0x1100));
+    EXPECT_EQ(map.name(0x1100), "");
+
+    map.build(symtab);
+
+    setCase("lookup");
+    EXPECT_EQ(map.size(), 5);
+    EXPECT_TRUE(map.lookup(0xfff) == NULL);
+    EXPECT_EQ(map.name(0x1000), "_start");
+    EXPECT_EQ(map.name(0x10fc), "_start");
+    EXPECT_EQ(map.name(0x1100), "main");
+    EXPECT_EQ(map.name(0x1204), "FUNC_kernel");
+    EXPECT_EQ(map.name(0x12ff), "FUNC_kernel");
+    EXPECT_EQ(map.name(0x1300), "printf");
+    EXPECT_EQ(map.name(0xffffffff), "FUNCTIONAL");
+
+    setCase("agrees with findNearestSymbol");
+    for (Addr addr = 0x1000; addr < 0x1500; addr += 4) {
+        string symbol;
+        Addr sym_addr;
+        symtab.findNearestSymbol(addr, symbol, sym_addr);
+        EXPECT_EQ(map.name(addr), symbol);
+        EXPECT_EQ(map.lookup(addr)->start, sym_addr);
+    }
+
+    setCase("region of interest");
+    EXPECT_FALSE(map.inROI(0x1000));
+    EXPECT_TRUE(map.inROI(0x1100));
+    EXPECT_TRUE(map.inROI(0x1200));
+    EXPECT_FALSE(map.inROI(0x1300));
+    EXPECT_TRUE(map.inROI(0x1400));
+    EXPECT_EQ(map.tags(0x1104), RegionMap::TagMain | RegionMap::TagROI);
+    EXPECT_EQ(map.tags(0x1204), RegionMap::TagFunc | RegionMap::TagROI);
+    EXPECT_EQ(map.tags(0x1304), 0);
+    EXPECT_EQ(map.tags(0xf00), 0);
+    EXPECT_TRUE(map.lookup(0x1100)->isMain());
+
+    setCase("dense indices");
+    EXPECT_EQ(map.indexOf(map.lookup(0x1000)), 0);
+    EXPECT_EQ(map.indexOf(map.lookup(0x1400)), 4);
+    EXPECT_EQ(map[2].start, 0x1200);
+    EXPECT_EQ(map[2].end, 0x1300);
+
+    setCase("function ids");
+    EXPECT_EQ(map.numFuncIds(), 4);
+    EXPECT_EQ(map.funcId(0x1000), RegionMap::otherFuncId);
+    EXPECT_EQ(map.funcId(0x1304), RegionMap::otherFuncId);
+    EXPECT_EQ(map.funcName(map.funcId(0x1104)), "main");
+    EXPECT_EQ(map.funcName(map.funcId(0x1204)), "FUNC_kernel");
+    EXPECT_EQ(map.funcName(map.funcId(0x1404)), "FUNCTIONAL");
+    EXPECT_EQ(map.funcName(RegionMap::otherFuncId), "other");
+
+    setCase("region of interest patterns");
+    vector<string> patterns;
+    patterns.push_back("printf");
+    patterns.push_back("re:^FUNC_[a-z]+$");
+    map.setROIPatterns(patterns);
+    map.build(symtab);
+    EXPECT_FALSE(map.inROI(0x1100));
+    EXPECT_TRUE(map.inROI(0x1200));
+    EXPECT_TRUE(map.inROI(0x1300));
+    EXPECT_FALSE(map.inROI(0x1400));
+    EXPECT_TRUE(map.lookup(0x1100)->isMain());
+    EXPECT_EQ(map.numFuncIds(), 3);
+
+    patterns.clear();
+    patterns.push_back("main");
+    patterns.push_back("FUNC*");
+    map.setROIPatterns(patterns);
+
+    setCase("rebuild");
+    symtab.insert(0x1180, "FUNC_inner");
+    map.build(symtab);
+    EXPECT_EQ(map.size(), 6);
+    EXPECT_EQ(map.name(0x1184), "FUNC_inner");
+    EXPECT_EQ(map.lookup(0x1104)->end, 0x1180);
+
+    return UnitTest::printResults();
+}
@@ -100,6 +100,8 @@ struct StatTest
     Histogram h11;
     Histogram h12;
     SparseHistogram sh1;
+    SparseVector2d sv1;
+    SparseDistribution sd1;
 
     Vector s19;
     Vector s20;
@@ -343,6 +345,20 @@ StatTest::init()
         .desc("this is sparse histogram 1")
         ;
 
+    sv1
+        .init(100, 100)
+        .name("SparseVector2d1")
+        .desc("this is sparse 2d vector 1")
+        .flags(total | nozero)
+        ;
+
+    sd1
+        .init(0, 99999, 1)
+        .name("SparseDistribution1")
+        .desc("this is sparse distribution 1")
+        .flags(nozero)
+        ;
+
     f1
         .name("Formula1")
         .desc("this is formula 1")
@@ -674,6 +690,11 @@ StatTest::run()
         sh1.sample(random() % 10000);
     }
 
+    for (int i = 0; i < 100; i++) {
+        sv1[i][99 - i] += i;
+        sd1.sample(i * i);
+    }
+
     s19[0] = 1;
     s19[1] = 100000;
     s20[0] = 100000;
@@ -0,0 +1,128 @@
+/*
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <map>
+
+#include "base/philox.hh"
+#include "mem/ruby/structures/TBETable.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+struct TestTBE
+{
+    TestTBE() : data(0) { }
+    int data;
+};
+
+/** What the TBE of an address holds and where it lives. */
+struct RefTBE
+{
+    int data;
+    TestTBE *entry;
+};
+
+/**
+ * Apply random allocations, lookups and deallocations to a TBETable and
+ * to a std::map, checking that they agree and that TBEs do not move
+ * while allocated.
+ */
+static bool
+randomOps(int num_tbes, uint64_t seed, unsigned lines, unsigned ops)
+{
+    TBETable<TestTBE> table(num_tbes);
+    map<Address, RefTBE> ref;
+    Philox rng(seed, 0);
+
+    for (unsigned i = 0; i < ops; i++) {
+        Address addr(uint64_t(rng.next() % lines) << 6);
+        auto r = ref.find(addr);
+        if (table.isPresent(addr) != (r != ref.end()))
+            return false;
+        if (table.areNSlotsAvailable(1) != ((int)ref.size() < num_tbes))
+            return false;
+
+        if (r == ref.end()) {
+            if (table.lookup(addr) || !table.areNSlotsAvailable(1))
+                continue;
+            table.allocate(addr);
+            TestTBE *tbe = table.lookup(addr);
+            // allocating resets the entry
+            if (!tbe || tbe->data != 0)
+                return false;
+            tbe->data = i;
+            RefTBE e = { (int)i, tbe };
+            ref[addr] = e;
+        } else if (rng.next() % 2) {
+            TestTBE *tbe = table.lookup(addr);
+            if (tbe != r->second.entry || tbe->data != r->second.data)
+                return false;
+            table.deallocate(addr);
+            ref.erase(r);
+        }
+    }
+
+    for (auto &r : ref) {
+        TestTBE *tbe = table.lookup(r.first);
+        if (tbe != r.second.entry || tbe->data != r.second.data)
+            return false;
+    }
+    return true;
+}
+
+int
+main()
+{
+    setCase("allocate and deallocate");
+    TBETable<TestTBE> table(2);
+    Address a(0x1000), b(0x2000), c(0x3000);
+    EXPECT_FALSE(table.isPresent(a));
+    EXPECT_TRUE(table.lookup(a) == NULL);
+    EXPECT_TRUE(table.areNSlotsAvailable(2));
+    table.allocate(a);
+    table.lookup(a)->data = 1;
+    table.allocate(b);
+    EXPECT_TRUE(table.isPresent(a));
+    EXPECT_TRUE(table.isPresent(b));
+    EXPECT_FALSE(table.isPresent(c));
+    EXPECT_FALSE(table.areNSlotsAvailable(1));
+    EXPECT_EQ(table.lookup(a)->data, 1);
+    table.deallocate(a);
+    EXPECT_FALSE(table.isPresent(a));
+    EXPECT_TRUE(table.areNSlotsAvailable(1));
+    table.allocate(c);
+    EXPECT_EQ(table.lookup(c)->data, 0);
+    EXPECT_TRUE(table.isPresent(b));
+
+    setCase("random operations");
+    EXPECT_TRUE(randomOps(1, 1, 4, 10000));
+    EXPECT_TRUE(randomOps(16, 2, 24, 50000));
+    EXPECT_TRUE(randomOps(256, 3, 1000, 100000));
+
+    return UnitTest::printResults();
+}
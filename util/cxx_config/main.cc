@@ -83,6 +83,9 @@ usage(const std::string &prog_name)
         "    -v <object> <param> <values> -- set a vector parameter from"
         " a comma\n"
         "                                    separated values string\n"
+        "    -o <object>.<param>=<value>  -- set a parameter, in the form"
+        " used\n"
+        "                                    by per-run overrides\n"
         "    -d <flag>                    -- set a debug flag (-<flag>\n"
         "                                    clear a flag)\n"
         "    -s <dir> <ticks>             -- save checkpoint to dir after"
@@ -92,6 +95,15 @@ usage(const std::string &prog_name)
         "    -c <from> <to> <ticks>       -- switch from cpu 'from' to cpu"
         " 'to' after\n"
         "                                    the given number of ticks\n"
+        "    -t <ticks>                   -- stop after the given number"
+        " of ticks\n"
+        "    -q                           -- don't dump the event queue\n"
+        "\n"
+        "The exit code is the one the simulation exited with, so a"
+        " campaign\n"
+        "can run the same config.ini many times with different overrides"
+        "\n"
+        "and no Python start-up cost.\n"
         "\n"
         );
 
@@ -141,6 +153,8 @@ main(int argc, char **argv)
     std::string to_cpu = "";
     Tick pre_run_time = 1000000;
     Tick pre_switch_time = 1000000;
+    Tick max_ticks = MaxTick;
+    bool dump_events = true;
 
     try {
         while (arg_ptr < argc) {
@@ -163,6 +177,25 @@ main(int argc, char **argv)
                 config_manager->setParamVector(argv[arg_ptr],
                     argv[arg_ptr + 1], values);
                 arg_ptr += 3;
+            } else if (option == "-o") {
+                if (num_args < 1)
+                    usage(prog_name);
+                std::string assignment(argv[arg_ptr]);
+                size_t eq = assignment.find('=');
+                size_t dot = assignment.rfind('.', eq);
+                if (eq == std::string::npos || dot == std::string::npos)
+                    usage(prog_name);
+                config_manager->setParam(assignment.substr(0, dot),
+                    assignment.substr(dot + 1, eq - dot - 1),
+                    assignment.substr(eq + 1));
+                arg_ptr++;
+            } else if (option == "-t") {
+                if (num_args < 1)
+                    usage(prog_name);
+                std::istringstream(argv[arg_ptr]) >> max_ticks;
+                arg_ptr++;
+            } else if (option == "-q") {
+                dump_events = false;
             } else if (option == "-d") {
                 if (num_args < 1)
                     usage(prog_name);
@@ -208,7 +241,8 @@ main(int argc, char **argv)
     }
 
     CxxConfig::statsEnable();
-    getEventQueue(0)->dump();
+    if (dump_events)
+        getEventQueue(0)->dump();
 
     try {
         config_manager->instantiate();
@@ -302,12 +336,13 @@ main(int argc, char **argv)
         std::cerr << "Switched CPU\n";
     }
 
-    exit_event = simulate();
+    exit_event = simulate(max_ticks - curTick());
 
     std::cerr << "Exit at tick " << curTick()
         << ", cause: " << exit_event->getCause() << '\n';
 
-    getEventQueue(0)->dump();
+    if (dump_events)
+        getEventQueue(0)->dump();
 
 #if TRY_CLEAN_DELETE
     config_manager->deleteObjects();
@@ -315,5 +350,5 @@ main(int argc, char **argv)
 
     delete config_manager;
 
-    return EXIT_SUCCESS;
+    return exit_event->getCode();
 }
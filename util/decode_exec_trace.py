@@ -0,0 +1,280 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script decodes the binary execution traces written by ExeTracer
+# when its binary_file parameter (--exec-trace-binary) is set, undoing
+# the delta encoding of the pc, tick, sequence number and memory address
+# fields. It assumes that protoc has been executed and already generated
+# the Python package for the exec messages. This can be done manually
+# using:
+# protoc --python_out=. exec.proto
+#
+# The first run over a trace writes <trace>.idx listing the file offset
+# of every keyframe with its record number, tick and sequence number.
+# The --record, --tick and --seq options use the index to start decoding
+# at the last keyframe before the requested point rather than at the
+# start of the trace, and --count stops after that many records.
+
+import optparse
+import os
+import protolib
+import sys
+
+# Import the exec proto definitions
+try:
+    import exec_pb2
+except:
+    print "Did not find protobuf exec definitions, attempting to generate"
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/exec.proto'])
+    if not error:
+        print "Generated exec proto definitions"
+
+        try:
+            import google.protobuf
+        except:
+            print "Please install Python protobuf module"
+            exit(-1)
+
+        import exec_pb2
+    else:
+        print "Failed to import exec proto definitions"
+        exit(-1)
+
+class Keyframe(object):
+    """Where a keyframe is in the trace and the absolute values it
+    starts from"""
+    def __init__(self, record, offset, tick, seq_num):
+        self.record = record
+        self.offset = offset
+        self.tick = tick
+        self.seq_num = seq_num
+
+class Decoder(object):
+    """Undoes the delta encoding of ExecInst records, filling in the
+    absolute pc, tick, seq_num and mem_addr attributes"""
+    def __init__(self):
+        self.pc = 0
+        self.tick = 0
+        self.seq_num = 0
+        self.mem_addr = 0
+
+    def decode(self, inst):
+        if inst.keyframe:
+            self.pc = 0
+            self.tick = 0
+            self.seq_num = 0
+            self.mem_addr = 0
+        self.pc += inst.pc
+        self.tick += inst.tick
+        if inst.HasField('seq_num'):
+            self.seq_num += inst.seq_num
+        if inst.HasField('mem_addr'):
+            self.mem_addr += inst.mem_addr
+
+def openTrace(file_name):
+    """Open a trace, check its magic number and return the file and its
+    header"""
+    proto_in = protolib.openFileRd(file_name)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", file_name
+        exit(-1)
+
+    header = exec_pb2.ExecHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    if header.ver != 0:
+        print "Warning: file version newer than decoder:", header.ver
+        print "This decoder may not understand how to decode this file"
+
+    return proto_in, header
+
+def buildIndex(file_name, index_name):
+    """Scan the whole trace for its keyframes and write them to
+    index_name"""
+    proto_in, header = openTrace(file_name)
+    inst = exec_pb2.ExecInst()
+    decoder = Decoder()
+    keyframes = []
+    record = 0
+
+    offset = proto_in.tell()
+    while protolib.decodeMessage(proto_in, inst):
+        decoder.decode(inst)
+        if inst.keyframe:
+            keyframes.append(Keyframe(record, offset, decoder.tick,
+                                      decoder.seq_num))
+        record += 1
+        offset = proto_in.tell()
+
+    proto_in.close()
+
+    try:
+        index_out = open(index_name, 'w')
+        for k in keyframes:
+            index_out.write('%d %d %d %d\n' %
+                            (k.record, k.offset, k.tick, k.seq_num))
+        index_out.close()
+    except IOError:
+        print "Failed to write index", index_name
+
+    return keyframes
+
+def loadIndex(file_name):
+    """Read the trace's index, building it if it is missing or older
+    than the trace"""
+    index_name = file_name + '.idx'
+
+    if not os.path.exists(index_name) or \
+       os.path.getmtime(index_name) < os.path.getmtime(file_name):
+        return buildIndex(file_name, index_name)
+
+    keyframes = []
+    for line in open(index_name):
+        record, offset, tick, seq_num = map(int, line.split())
+        keyframes.append(Keyframe(record, offset, tick, seq_num))
+    return keyframes
+
+def findKeyframe(keyframes, key, value):
+    """The last keyframe whose attribute key is not past value"""
+    lo, hi = 0, len(keyframes)
+    while lo < hi:
+        mid = (lo + hi) / 2
+        if getattr(keyframes[mid], key) <= value:
+            lo = mid + 1
+        else:
+            hi = mid
+    return keyframes[lo - 1] if lo > 0 else None
+
+def formatRegs(regs):
+    return ' '.join(('%d=%#x' % (r.reg, r.value)) if r.HasField('value')
+                    else ('%d=?' % r.reg) for r in regs)
+
+def main():
+    parser = optparse.OptionParser(
+        usage="%prog [options] <binary trace> <ASCII output>")
+    parser.add_option("--record", type="long", default=None,
+                      help="Start at this record number")
+    parser.add_option("--tick", type="long", default=None,
+                      help="Start at the first record at or after this tick")
+    parser.add_option("--seq", type="long", default=None,
+                      help="Start at the first record with at least this"
+                      " sequence number")
+    parser.add_option("--count", type="long", default=None,
+                      help="Stop after decoding this many records")
+    (options, args) = parser.parse_args()
+
+    if len(args) != 2:
+        parser.print_usage()
+        exit(-1)
+
+    try:
+        ascii_out = open(args[1], 'w')
+    except IOError:
+        print "Failed to open ", args[1], " for writing"
+        exit(-1)
+
+    # Pick the keyframe to start decoding at
+    start = None
+    if options.record is not None:
+        start = ('record', options.record)
+    elif options.tick is not None:
+        start = ('tick', options.tick)
+    elif options.seq is not None:
+        start = ('seq_num', options.seq)
+
+    proto_in, header = openTrace(args[0])
+
+    print "Object id:", header.obj_id
+    print "Tick frequency:", header.tick_freq
+    print "Keyframe interval:", header.keyframe_interval
+
+    record = 0
+    if start:
+        keyframe = findKeyframe(loadIndex(args[0]), *start)
+        if keyframe:
+            proto_in.seek(keyframe.offset)
+            record = keyframe.record
+
+    inst = exec_pb2.ExecInst()
+    decoder = Decoder()
+    num_insts = 0
+
+    # Decode the inst messages until we hit the end of the file or the
+    # requested count
+    while protolib.decodeMessage(proto_in, inst):
+        decoder.decode(inst)
+        record += 1
+
+        if start:
+            key, value = start
+            if key == 'record':
+                current = record - 1
+            else:
+                current = getattr(decoder, key)
+            if current < value:
+                continue
+            start = None
+
+        if options.count is not None and num_insts >= options.count:
+            break
+
+        ascii_out.write('%-20d: %8d cpu%d %#016x' %
+                        (decoder.tick, decoder.seq_num, inst.cpuid,
+                         decoder.pc))
+        if inst.HasField('upc'):
+            ascii_out.write('.%-2d' % inst.upc)
+        else:
+            ascii_out.write('   ')
+        ascii_out.write(' %#010x op %2d' % (inst.inst, inst.op_class))
+        if inst.predicate_false:
+            ascii_out.write(' predicated false')
+        if len(inst.src):
+            ascii_out.write(' src %s' % formatRegs(inst.src))
+        if len(inst.dest):
+            ascii_out.write(' dest %s' % formatRegs(inst.dest))
+        if inst.HasField('mem_addr'):
+            ascii_out.write(' mem %#x/%d' % (decoder.mem_addr,
+                                             inst.mem_size))
+        if inst.HasField('data'):
+            ascii_out.write(' D=%#018x' % inst.data)
+        ascii_out.write('\n')
+        num_insts += 1
+
+    print "Decoded instructions:", num_insts
+
+    # We're done
+    ascii_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
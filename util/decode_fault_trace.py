@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script is used to dump protobuf fault traces (see the faultTrace
+# parameter of MinorCPU) to ASCII format. It assumes that protoc has been
+# executed and already generated the Python package for the fault
+# messages. This can be done manually using:
+# protoc --python_out=. fault.proto
+# The ASCII trace format uses one line per event:
+# <tick>: <seqnum> <pc> <structure> <kind> reg <reg> <old value> -> <new value>
+
+import protolib
+import sys
+
+# Import the fault proto definitions
+try:
+    import fault_pb2
+except:
+    print "Did not find protobuf fault definitions, attempting to generate"
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/fault.proto'])
+    if not error:
+        print "Generated fault proto definitions"
+
+        try:
+            import google.protobuf
+        except:
+            print "Please install Python protobuf module"
+            exit(-1)
+
+        import fault_pb2
+    else:
+        print "Failed to import fault proto definitions"
+        exit(-1)
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: ", sys.argv[0], " <protobuf input> <ASCII output>"
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        ascii_out = open(sys.argv[2], 'w')
+    except IOError:
+        print "Failed to open ", sys.argv[2], " for writing"
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", sys.argv[1]
+        exit(-1)
+
+    print "Parsing fault trace header"
+
+    header = fault_pb2.FaultHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print "Object id:", header.obj_id
+    print "Tick frequency:", header.tick_freq
+
+    if header.ver != 0:
+        print "Warning: file version newer than decoder:", header.ver
+        print "This decoder may not understand how to decode this file"
+
+    print "Parsing fault events"
+
+    structures = fault_pb2._FAULTEVENT_STRUCTURE.values_by_number
+    kinds = fault_pb2._FAULTEVENT_KIND.values_by_number
+
+    num_events = 0
+    event = fault_pb2.FaultEvent()
+
+    # Decode the event messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, event):
+        ascii_out.write('%-20d: %8d %#016x %-10s %-9s reg %4d %#x -> %#x\n' %
+                        (event.tick, event.seq_num, event.pc,
+                         structures[event.structure].name,
+                         kinds[event.kind].name, event.reg,
+                         event.old_value, event.new_value))
+        num_events += 1
+
+    print "Parsed events:", num_events
+
+    # We're done
+    ascii_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
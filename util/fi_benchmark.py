@@ -0,0 +1,191 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# Measure what the fault injection hooks cost in host time.
+#
+# The same workload is run in three modes:
+#
+#   stock     a simulator without the hooks (--stock), if given
+#   disarmed  the simulator with the hooks, no fault armed
+#   armed     the same, with a MinorCPU fault armed at a target the
+#             run never reaches, so every hook is live but nothing is
+#             injected
+#
+# Each run keeps the event queue host-time profile (--eventq-profile),
+# and the report gives the host time of each mode, its change over the
+# previous mode, and the SimObjects whose events account for most of
+# that change.  The hooks run inside the events of the CPU stages, so
+# the breakdown is by owner of the events; a new hook shows up as a
+# change in the time of the objects it is called from.  The stock
+# simulator must accept the same command line; gem5.opt is this tree
+# with the hooks compiled out.
+#
+# Example, fastest of three runs per mode:
+#
+#   fi_benchmark.py -r 3 --stock build/ARM/gem5.opt -- \
+#       build/ARM/gem5.fi configs/example/se.py --cpu-type=minor -c prog
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+# one line of eventq_profile.txt
+profile_line = re.compile(r'^\s*(\d+)\s+(\d+)\s+([\d.]+)\s+([\d.]+)%\s+'
+                          r'(.*) \((.*)\)$')
+
+def read_profile(outdir):
+    """Host seconds spent on the events of each SimObject"""
+    owners = {}
+    path = os.path.join(outdir, "eventq_profile.txt")
+    if not os.path.exists(path):
+        return owners
+    for line in open(path):
+        match = profile_line.match(line)
+        if match:
+            owner = match.group(5)
+            owners[owner] = owners.get(owner, 0.0) + float(match.group(3))
+    return owners
+
+def host_seconds(outdir):
+    """The simulator's own measure, which leaves out the start up"""
+    path = os.path.join(outdir, "stats.txt")
+    if not os.path.exists(path):
+        return None
+    for line in open(path):
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] == "host_seconds":
+            return float(fields[1])
+    return None
+
+def run(args, mode, gem5, extra, n):
+    outdir = os.path.join(args.workdir, "%s%d" % (mode, n))
+    cmd = [gem5, "--outdir=%s" % outdir] + args.command[1:] + \
+        ["--eventq-profile"] + extra
+    log = open(outdir + ".log", "w")
+    start = time.time()
+    status = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+    wall = time.time() - start
+    log.close()
+    if status != 0:
+        sys.exit("%s run failed, see %s.log" % (mode, outdir))
+
+    seconds = host_seconds(outdir)
+    return { "mode" : mode,
+             "outdir" : outdir,
+             "wall_seconds" : wall,
+             "host_seconds" : seconds if seconds is not None else wall,
+             "owners" : read_profile(outdir) }
+
+def report(runs, top):
+    print "%-10s %10s %10s" % ("mode", "seconds", "change")
+    previous = None
+    for r in runs:
+        change = ""
+        if previous:
+            change = "%+9.1f%%" % (100.0 *
+                (r["host_seconds"] - previous["host_seconds"]) /
+                max(previous["host_seconds"], 1e-6))
+        print "%-10s %9.2fs %10s" % (r["mode"], r["host_seconds"], change)
+        previous = r
+
+    for before, after in zip(runs, runs[1:]):
+        owners = set(before["owners"]) | set(after["owners"])
+        deltas = sorted(((after["owners"].get(o, 0.0) -
+                          before["owners"].get(o, 0.0), o) for o in owners),
+                        reverse=True)
+        print
+        print "%s -> %s, largest changes by SimObject:" % \
+            (before["mode"], after["mode"])
+        for delta, owner in deltas[:top]:
+            print "  %+9.3fs  %s" % (delta, owner)
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure the host-time cost of the fault injection"
+        " hooks")
+    parser.add_argument("command", nargs=argparse.REMAINDER,
+                        help="Simulator command line, after --")
+    parser.add_argument("--stock", default=None,
+                        help="Simulator binary without the hooks, taking"
+                        " the same command line")
+    parser.add_argument("-r", "--repeat", type=int, default=1,
+                        help="Runs per mode, the fastest is kept")
+    parser.add_argument("--late-target", type=long, default=2 ** 62,
+                        help="--FItarget of the armed mode, beyond the end"
+                        " of the run")
+    parser.add_argument("--target-reg", type=long, default=100,
+                        help="--FItargetReg of the armed mode")
+    parser.add_argument("--top", type=int, default=10,
+                        help="SimObjects listed per change")
+    parser.add_argument("-d", "--workdir", default="fi_benchmark",
+                        help="Directory for the runs' output and the"
+                        " results")
+    args = parser.parse_args()
+
+    if args.command and args.command[0] == "--":
+        args.command = args.command[1:]
+    if not args.command:
+        parser.error("no simulator command line given")
+    if args.repeat < 1:
+        parser.error("need at least one run per mode")
+
+    args.workdir = os.path.abspath(args.workdir)
+    if not os.path.exists(args.workdir):
+        os.makedirs(args.workdir)
+
+    modes = []
+    if args.stock:
+        modes.append(("stock", args.stock, []))
+    modes.append(("disarmed", args.command[0], []))
+    modes.append(("armed", args.command[0],
+                  ["--FItarget", str(args.late_target),
+                   "--FItargetReg", str(args.target_reg)]))
+
+    runs = []
+    for mode, gem5, extra in modes:
+        best = None
+        for n in range(args.repeat):
+            r = run(args, mode, gem5, extra, n)
+            if best is None or r["host_seconds"] < best["host_seconds"]:
+                best = r
+        runs.append(best)
+
+    results = os.path.join(args.workdir, "results.json")
+    f = open(results, "w")
+    json.dump(runs, f, indent=4, sort_keys=True)
+    f.write("\n")
+    f.close()
+
+    report(runs, args.top)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run a fault injection campaign on a pool of simulator workers.
+#
+# The campaign file (see parseFICampaign in configs/common/Simulation.py)
+# is copied into a work queue that the workers pull faults from through
+# --fi-campaign-queue.  Each worker pays for Python start-up,
+# configuration and the fault-free prefix (or checkpoint restore) once,
+# then forks one injection run per fault it claims, so the workers stay
+# busy however the faults' run times differ.  Every run appends its
+# outcome record (see configs/common/FIOutcome.py) to one results file,
+# which is summarised when the campaign ends.  With --stats the runs
+# create no files either: the workers write the configuration once and
+# append the chosen stats of every run to stats.bin in the working
+# directory (see --campaign-dir).
+#
+# Example, four local workers and two on each of two hosts sharing the
+# working directory:
+#
+#   fi_campaign.py -w 4 campaign.txt -- build/ARM/gem5.fi \
+#       configs/example/se.py -c prog --fi-signature golden.json
+#   fi_campaign.py -w 2 --hosts node1,node2 campaign.txt -- ...
+
+import argparse
+import json
+import os
+import pipes
+import shutil
+import subprocess
+import sys
+
+def start_worker(args, host, n, queue, results):
+    outdir = os.path.join(args.workdir, "worker%d" % n)
+    gem5 = args.command[0]
+    cmd = [gem5, "--outdir=%s" % outdir]
+    if args.campaign_output:
+        cmd += ["--campaign-dir=%s" % args.workdir] + \
+            ["--campaign-stats=%s" % s for s in args.stats]
+    cmd += args.command[1:] + \
+        ["--fi-campaign", queue, "--fi-campaign-queue",
+         "--fi-results", results]
+    log = open(outdir + ".log", "w")
+
+    if host:
+        cmd = ["ssh", host, "cd %s && %s" % (pipes.quote(os.getcwd()),
+                                           " ".join(map(pipes.quote, cmd)))]
+    return subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT)
+
+def summarise(results):
+    counts = {}
+    outcomes = set()
+    for line in open(results):
+        record = json.loads(line)
+        structure = record["structure"] or "minor_regs"
+        outcome = record["outcome"]
+        outcomes.add(outcome)
+        counts.setdefault(structure, {})
+        counts[structure][outcome] = counts[structure].get(outcome, 0) + 1
+
+    outcomes = sorted(outcomes)
+    print "%-20s %8s" % ("structure", "runs") + \
+        "".join(" %8s" % o for o in outcomes)
+    for structure in sorted(counts):
+        runs = sum(counts[structure].values())
+        print "%-20s %8d" % (structure, runs) + \
+            "".join(" %8d" % counts[structure].get(o, 0) for o in outcomes)
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Run a fault injection campaign on a pool of"
+        " simulator workers")
+    parser.add_argument("campaign", help="Campaign file of faults")
+    parser.add_argument("command", nargs=argparse.REMAINDER,
+                        help="Simulator command line, after --")
+    parser.add_argument("-w", "--workers", type=int, default=1,
+                        help="Workers per host")
+    parser.add_argument("--hosts", default=None,
+                        help="Comma separated hosts to run workers on over"
+                        " ssh, all sharing the working directory. Workers"
+                        " run locally by default")
+    parser.add_argument("-d", "--workdir", default="fi_campaign",
+                        help="Directory for the queue, results and the"
+                        " workers' output")
+    parser.add_argument("--campaign-output", action="store_true",
+                        default=False,
+                        help="Run the workers with --campaign-dir in the"
+                        " working directory, so that runs create no files"
+                        " of their own")
+    parser.add_argument("--stats", metavar="REGEX", action="append",
+                        default=[],
+                        help="Stats to append to stats.bin in the working"
+                        " directory for every run, implies"
+                        " --campaign-output")
+    args = parser.parse_args()
+
+    if args.command and args.command[0] == "--":
+        args.command = args.command[1:]
+    if not args.command:
+        parser.error("no simulator command line given")
+    if args.workers < 1:
+        parser.error("need at least one worker per host")
+    if args.stats:
+        args.campaign_output = True
+
+    args.workdir = os.path.abspath(args.workdir)
+    if os.path.exists(args.workdir):
+        sys.exit("%s exists, not overwriting a previous campaign" %
+                 args.workdir)
+    os.makedirs(args.workdir)
+
+    queue = os.path.join(args.workdir, "queue.txt")
+    results = os.path.join(args.workdir, "results.jsonl")
+    shutil.copyfile(args.campaign, queue)
+
+    hosts = args.hosts.split(",") if args.hosts else [None]
+    workers = []
+    for host in hosts:
+        for i in range(args.workers):
+            workers.append(start_worker(args, host, len(workers), queue,
+                                        results))
+
+    failed = 0
+    for n, worker in enumerate(workers):
+        if worker.wait() != 0:
+            print >>sys.stderr, "worker %d failed, see %s" % \
+                (n, os.path.join(args.workdir, "worker%d.log" % n))
+            failed += 1
+
+    if os.path.exists(results):
+        summarise(results)
+    else:
+        print >>sys.stderr, "no runs recorded in %s" % results
+        failed += 1
+
+    sys.exit(1 if failed else 0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,250 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Plan a statistically sized fault injection campaign.
+#
+# Faults are sampled uniformly over (instruction, entry, bit) of each
+# structure.  Every entry of a structure is a stratum; the samples of a
+# structure are shared out between its entries by Neyman allocation, so
+# entries which are rarely vulnerable get few samples.  The
+# vulnerability of each register entry is first estimated from the ACE
+# summary of the golden run (--ace-analysis), other entries are assumed
+# to be the worst case, 0.5.  The plan is sized so that the structure's
+# AVF estimate has the requested error margin at the requested
+# confidence.
+#
+# Passing the results of earlier rounds (see configs/common/FIOutcome.py)
+# replaces the priors by the measured outcomes and plans only the
+# samples still missing, if any.  The campaign converges when every
+# structure meets the margin; the planner exits with status 0 then and
+# with status 2 while more samples are planned:
+#
+#   fi_plan.py -s golden.json -a ace_summary.bin -S int_regs:34:64 \
+#       -S rob:40:64 -o round0.txt
+#   fi_campaign.py -d round0 round0.txt -- ...
+#   fi_plan.py ... -r round0/results.jsonl --round 1 -o round1.txt
+#
+# The output is a campaign file of '<seqnum> <index> <structure> <bit>'
+# lines for --fi-campaign.  Sampled seqnums are uniform over the golden
+# run's committed instruction count; squashed instructions also take
+# execute seqnums, so late instructions are slightly undersampled.
+
+import argparse
+import json
+import math
+import random
+import struct
+import sys
+
+# Register files in the order AceAnalysis numbers their registers
+ACE_REG_FILES = ("int_regs", "float_regs", "cc_regs")
+
+FAILURES = ("sdc", "crash", "hang", "detected")
+
+def z_score(confidence):
+    """Two-sided standard normal quantile, by bisection of erf."""
+
+    lo, hi = 0.0, 10.0
+    while hi - lo > 1e-9:
+        mid = (lo + hi) / 2
+        if math.erf(mid / math.sqrt(2)) < confidence:
+            lo = mid
+        else:
+            hi = mid
+    return lo
+
+def read_ace(filename):
+    """(cycles, per register ACE cycles) of an ACE summary file."""
+
+    data = open(filename, "rb").read()
+    if data[:4] != "ACE1":
+        sys.exit("%s is not an ACE summary" % filename)
+    num_regs, num_funcs, cycles = struct.unpack_from("<IIQ", data, 4)
+    ace = struct.unpack_from("<%dQ" % num_regs, data, 20)
+    return cycles, ace
+
+class Structure(object):
+    def __init__(self, spec):
+        try:
+            name, entries, bits = spec.split(":")
+            self.name = name
+            self.entries = int(entries)
+            self.bits = int(bits)
+        except ValueError:
+            sys.exit("bad structure '%s', expected <name>:<entries>:<bits>"
+                     % spec)
+        self.prior = [0.5] * self.entries
+        self.samples = [0] * self.entries
+        self.failures = [0] * self.entries
+
+    def estimate(self, h, min_samples):
+        """Vulnerability estimate of entry h: measured once it has
+        enough samples, the prior before."""
+
+        if self.samples[h] >= min_samples:
+            return float(self.failures[h]) / self.samples[h]
+        return self.prior[h]
+
+    def deviations(self, floor, min_samples):
+        devs = []
+        for h in range(self.entries):
+            p = min(max(self.estimate(h, min_samples), floor), 1 - floor)
+            devs.append(math.sqrt(p * (1 - p)))
+        return devs
+
+    def avf(self):
+        """Stratified AVF estimate and its standard error, None while
+        some stratum has no samples."""
+
+        if 0 in self.samples:
+            return None
+        weight = 1.0 / self.entries
+        avf = 0.0
+        var = 0.0
+        for h in range(self.entries):
+            p = float(self.failures[h]) / self.samples[h]
+            avf += weight * p
+            var += weight * weight * p * (1 - p) / self.samples[h]
+        return avf, math.sqrt(var)
+
+    def plan(self, args, z, population):
+        """Samples still needed per entry to reach the margin."""
+
+        devs = self.deviations(args.floor, args.min_samples)
+        total_dev = sum(devs)
+        if total_dev == 0:
+            return [0] * self.entries
+        weight = 1.0 / self.entries
+
+        # n = (sum W_h S_h)^2 z^2 / e^2, with the finite population
+        # correction of the whole structure
+        n0 = (weight * total_dev * z / args.margin) ** 2
+        n = n0 / (1 + (n0 - 1) / population)
+
+        needed = []
+        for h in range(self.entries):
+            n_h = max(int(math.ceil(n * devs[h] / total_dev)),
+                      args.min_samples)
+            needed.append(max(n_h - self.samples[h], 0))
+        return needed
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Plan a fault injection campaign for a target"
+        " confidence interval")
+    parser.add_argument("-s", "--signature", required=True,
+                        help="Golden run signature (--fi-signature)")
+    parser.add_argument("-a", "--ace", default=None,
+                        help="ACE summary of the golden run, for the"
+                        " register file priors")
+    parser.add_argument("-S", "--structure", action="append", default=[],
+                        help="<name>:<entries>:<bits> of a structure to"
+                        " inject into, may be repeated")
+    parser.add_argument("-m", "--margin", type=float, default=0.01,
+                        help="Error margin of each structure's AVF")
+    parser.add_argument("-c", "--confidence", type=float, default=0.95,
+                        help="Confidence of the margin")
+    parser.add_argument("-r", "--results", action="append", default=[],
+                        help="Results of earlier rounds, may be repeated")
+    parser.add_argument("--min-samples", type=int, default=2,
+                        help="Samples per entry before its measured"
+                        " vulnerability replaces the prior")
+    parser.add_argument("--floor", type=float, default=0.01,
+                        help="Lowest vulnerability assumed for an entry,"
+                        " so that no entry goes unsampled")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--round", type=int, default=0,
+                        help="Planning round, seeds distinct samples")
+    parser.add_argument("-o", "--output", default=None,
+                        help="Campaign file to write, stdout by default")
+    args = parser.parse_args()
+
+    if not args.structure:
+        parser.error("no structures given")
+    if not 0 < args.margin < 1 or not 0 < args.confidence < 1:
+        parser.error("margin and confidence must be in (0, 1)")
+
+    insts = json.load(open(args.signature))["insts"]
+    structures = [Structure(spec) for spec in args.structure]
+    by_name = dict((s.name, s) for s in structures)
+
+    if args.ace:
+        cycles, ace = read_ace(args.ace)
+        base = 0
+        for name in ACE_REG_FILES:
+            if name in by_name:
+                s = by_name[name]
+                for h in range(min(s.entries, len(ace) - base)):
+                    s.prior[h] = float(ace[base + h]) / max(cycles, 1)
+                base += s.entries
+
+    for filename in args.results:
+        for line in open(filename):
+            record = json.loads(line)
+            s = by_name.get(record.get("structure"))
+            index = record.get("index")
+            if s is None or index is None or not 0 <= index < s.entries:
+                continue
+            s.samples[index] += 1
+            if record["outcome"] in FAILURES:
+                s.failures[index] += 1
+
+    z = z_score(args.confidence)
+    rng = random.Random("%d.%d" % (args.seed, args.round))
+    out = open(args.output, "w") if args.output else sys.stdout
+    converged = True
+
+    print >>sys.stderr, "%-16s %8s %8s %8s %8s" % \
+        ("structure", "samples", "avf", "margin", "planned")
+    for s in structures:
+        estimate = s.avf()
+        population = insts * s.entries * s.bits
+        needed = s.plan(args, z, population)
+
+        if estimate and z * estimate[1] <= args.margin:
+            needed = [0] * s.entries
+        if sum(needed):
+            converged = False
+
+        for h in range(s.entries):
+            for i in range(needed[h]):
+                print >>out, "%d %d %s %d" % (rng.randint(1, insts), h,
+                                              s.name,
+                                              rng.randrange(s.bits))
+
+        print >>sys.stderr, "%-16s %8d %8s %8s %8d" % \
+            (s.name, sum(s.samples),
+             "%.4f" % estimate[0] if estimate else "-",
+             "%.4f" % (z * estimate[1]) if estimate else "-",
+             sum(needed))
+
+    if converged:
+        print >>sys.stderr, "converged"
+    sys.exit(0 if converged else 2)
+
+if __name__ == "__main__":
+    main()
@@ -61,6 +61,9 @@ void m5_addsymbol(uint64_t addr, char *symbol);
 void m5_panic(void);
 void m5_work_begin(uint64_t workid, uint64_t threadid);
 void m5_work_end(uint64_t workid, uint64_t threadid);
+void m5_roi_begin(uint64_t roiid);
+void m5_roi_end(uint64_t roiid);
+void m5_fi_arm(uint64_t fiid);
 
 // These operations are for critical path annotation
 void m5a_bsm(char *sm, const void *id, int flags);
@@ -37,13 +37,18 @@
 #
 # Authors: Giacomo Gabrielli
 
-# Pipeline activity viewer for the O3 CPU model.
+# Pipeline activity viewer for the O3 CPU model.  Reads either the
+# O3PipeView debug trace or a binary timeline from the O3PipeTimeline or
+# MinorPipeTimeline probe listeners; only the requested window of a
+# binary timeline is read.
 
 import optparse
 import os
 import sys
 import copy
 
+import pipe_timeline
+
 # Temporary storage for instructions. The queue is filled in out-of-order
 # until it reaches 'max_threshold' number of instructions. It is then
 # sorted out and instructions are printed out until their number drops to
@@ -131,7 +136,8 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
             if fields[1] == 'fetch':
                 if ((stop_tick > 0 and int(fields[2]) > stop_tick+insts['tick_drift']) or
                     (stop_sn > 0 and int(fields[5]) > (stop_sn+insts['max_threshold']))):
-                    print_insts(outfile, cycle_time, width, color, timestamps, 0)
+                    print_insts(outfile, cycle_time, width, color, timestamps,
+                                store_completions, 0)
                     return
                 (curr_inst['pc'], curr_inst['upc']) = fields[3:5]
                 curr_inst['sn'] = int(fields[5])
@@ -305,7 +311,7 @@ def validate_range(my_range):
 
 def main():
     # Parse options
-    usage = ('%prog [OPTION]... TRACE_FILE')
+    usage = ('%prog [OPTION]... TRACE_FILE|TIMELINE_FILE')
     parser = optparse.OptionParser(usage=usage)
     parser.add_option(
         '-o',
@@ -361,12 +367,17 @@ def main():
         sys.exit(1)
     # Process trace
     print 'Processing trace... ',
-    with open(args[0], 'r') as trace:
-        with open(options.outfile, 'w') as out:
-            process_trace(trace, out, options.cycle_time, options.width,
-                          options.color, options.timestamps,
-                          options.only_committed, options.store_completions,
-                          *(tick_range + inst_range))
+    if pipe_timeline.is_timeline(args[0]):
+        timeline = pipe_timeline.PipeTimeline(args[0])
+        trace = pipe_timeline.PipeViewTrace(
+            timeline, timeline.window(*(tick_range + inst_range)))
+    else:
+        trace = open(args[0], 'r')
+    with open(options.outfile, 'w') as out:
+        process_trace(trace, out, options.cycle_time, options.width,
+                      options.color, options.timestamps,
+                      options.only_committed, options.store_completions,
+                      *(tick_range + inst_range))
     print 'done!'
 
 
@@ -0,0 +1,216 @@
+#! /usr/bin/env python
+
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Reader for the binary pipeline timelines written by the O3PipeTimeline
+# and MinorPipeTimeline probe listeners.  The records are mmap'd rather
+# than read, and a sequence number sorted index of them is kept beside
+# the timeline (<timeline>.idx) so any window of instructions can be
+# found with a binary search instead of a scan of the whole file.
+#
+# Run on its own this converts a timeline, or a window of it, to the
+# O3PipeView text that o3-pipeview.py reads.
+
+import mmap
+import optparse
+import os
+import struct
+import sys
+
+MAGIC = 'gem5ptl\0'
+VERSION = 1
+
+HEADER = struct.Struct('<8sIIIIQQQ128s')
+RECORD = struct.Struct('<QQHHIQ7iI')
+STRING_LEN = struct.Struct('<I')
+INDEX_ENTRY = struct.Struct('<QQ')
+SEQ_NUM = struct.Struct('<Q')
+
+# The stages o3-pipeview.py knows, in the order it prints them
+PIPEVIEW_STAGES = ['decode', 'rename', 'dispatch', 'issue', 'complete']
+
+def is_timeline(filename):
+    with open(filename, 'rb') as f:
+        return f.read(len(MAGIC)) == MAGIC
+
+class PipeTimeline(object):
+    def __init__(self, filename):
+        self.file = open(filename, 'rb')
+        self.map = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+
+        (magic, version, record_size, num_stages, _, self.frequency,
+         num_records, strings_offset, stages) = \
+            HEADER.unpack_from(self.map, 0)
+        if magic != MAGIC:
+            raise ValueError('%s is not a pipeline timeline' % filename)
+        if version != VERSION or record_size != RECORD.size:
+            raise ValueError('%s is a version %d timeline, expected %d' %
+                             (filename, version, VERSION))
+
+        self.stages = [stages[i * 16:(i + 1) * 16].rstrip('\0')
+                       for i in range(num_stages)]
+
+        # A timeline whose simulation didn't exit cleanly has no string
+        # table, and only as many records as made it to the file
+        self.strings = []
+        if strings_offset:
+            self.num_records = num_records
+            (count,) = STRING_LEN.unpack_from(self.map, strings_offset)
+            pos = strings_offset + STRING_LEN.size
+            for i in xrange(count):
+                (length,) = STRING_LEN.unpack_from(self.map, pos)
+                pos += STRING_LEN.size
+                self.strings.append(self.map[pos:pos + length])
+                pos += length
+        else:
+            self.num_records = (len(self.map) - HEADER.size) / RECORD.size
+
+        self.index = self.open_index(filename + '.idx')
+
+    def open_index(self, index_name):
+        """mmap the sequence number index, building it first if it is
+        missing or older than the timeline"""
+        if (not os.path.exists(index_name) or
+            os.path.getmtime(index_name) < os.path.getmtime(self.file.name)
+            or os.path.getsize(index_name) !=
+                self.num_records * INDEX_ENTRY.size):
+            entries = [(SEQ_NUM.unpack_from(self.map, self.offset(i))[0], i)
+                       for i in xrange(self.num_records)]
+            entries.sort()
+            with open(index_name, 'wb') as index:
+                for entry in entries:
+                    index.write(INDEX_ENTRY.pack(*entry))
+
+        if self.num_records == 0:
+            return None
+        with open(index_name, 'rb') as index:
+            return mmap.mmap(index.fileno(), 0, access=mmap.ACCESS_READ)
+
+    def offset(self, record):
+        return HEADER.size + record * RECORD.size
+
+    def __len__(self):
+        return self.num_records
+
+    def entry(self, pos):
+        """The sequence number and record number of the pos'th
+        instruction in sequence number order"""
+        return INDEX_ENTRY.unpack_from(self.index, pos * INDEX_ENTRY.size)
+
+    def __getitem__(self, pos):
+        """The pos'th instruction in sequence number order as a dict of
+        its pc, upc, sn, disasm and the tick of each stage it reached"""
+        fields = RECORD.unpack_from(self.map,
+                                    self.offset(self.entry(pos)[1]))
+        (seq_num, pc, upc, flags, disasm, fetch) = fields[:6]
+        inst = {
+            'sn': seq_num,
+            'pc': pc,
+            'upc': upc,
+            'disasm': (self.strings[disasm] if disasm < len(self.strings)
+                       else '?'),
+            self.stages[0]: fetch
+            }
+        for name, delta in zip(self.stages[1:], fields[6:]):
+            inst[name] = 0 if delta == -1 else fetch + delta
+        return inst
+
+    def bisect(self, key, value):
+        """The position of the first instruction whose key(pos) is not
+        less than value"""
+        lo, hi = 0, self.num_records
+        while lo < hi:
+            mid = (lo + hi) / 2
+            if key(mid) < value:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+    def window(self, start_tick=0, stop_tick=-1, start_sn=0, stop_sn=-1):
+        """The positions of the instructions fetched in the tick range
+        and within the sequence number range.  Sequence numbers are
+        handed out in fetch order so both are ranges of the index"""
+        fetch_tick = lambda pos: self[pos]['fetch']
+        seq_num = lambda pos: self.entry(pos)[0]
+        start = max(self.bisect(fetch_tick, start_tick),
+                    self.bisect(seq_num, start_sn))
+        stop = self.num_records
+        if stop_tick >= 0:
+            stop = min(stop, self.bisect(fetch_tick, stop_tick + 1))
+        if stop_sn >= 0:
+            stop = min(stop, self.bisect(seq_num, stop_sn + 1))
+        return xrange(start, max(start, stop))
+
+    def pipeview_lines(self, positions):
+        """O3PipeView trace lines for the instructions at positions"""
+        for pos in positions:
+            inst = self[pos]
+            yield 'O3PipeView:fetch:%d:0x%08x:%d:%d:%s\n' % (
+                inst['fetch'], inst['pc'], inst['upc'], inst['sn'],
+                inst['disasm'])
+            for stage in PIPEVIEW_STAGES:
+                yield 'O3PipeView:%s:%d\n' % (stage, inst.get(stage, 0))
+            yield 'O3PipeView:retire:%d:store:%d\n' % (
+                inst.get('retire', 0), inst.get('store', 0))
+
+class PipeViewTrace(object):
+    """A file-like view of a timeline window as O3PipeView text"""
+    def __init__(self, timeline, positions):
+        self.lines = timeline.pipeview_lines(positions)
+
+    def readline(self):
+        return next(self.lines, '')
+
+def main():
+    usage = ('%prog [OPTION]... TIMELINE_FILE')
+    parser = optparse.OptionParser(usage=usage)
+    parser.add_option(
+        '-t',
+        dest='tick_range',
+        default='0:-1',
+        help="tick range (default: '%default'; -1 == inf.)")
+    parser.add_option(
+        '-i',
+        dest='inst_range',
+        default='0:-1',
+        help="instruction range (default: '%default'; -1 == inf.)")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.error('incorrect number of arguments')
+    try:
+        tick_range = [int(i) for i in options.tick_range.split(':')]
+        inst_range = [int(i) for i in options.inst_range.split(':')]
+    except ValueError:
+        parser.error('invalid range')
+
+    timeline = PipeTimeline(args[0])
+    window = timeline.window(*(tick_range + inst_range))
+    for line in timeline.pipeview_lines(window):
+        sys.stdout.write(line)
+
+if __name__ == '__main__':
+    main()
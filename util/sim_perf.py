@@ -0,0 +1,227 @@
+#!/usr/bin/env python
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Measure how fast gem5 simulates a fixed set of SE workloads, and
+# catch changes that slow it down. Each workload is run through the
+# regression scripts in tests/, so the configurations are exactly
+# those of the regressions. The host time, simulated instruction rate
+# and host memory of every run are written to a JSON file. Given the
+# JSON file of an earlier run, the script reports the relative change
+# for each workload and fails if any of them got slower than the
+# threshold.
+#
+# For example, to compare a change against its parent:
+#
+#   util/sim_perf.py -o before.json build/ARM/gem5.fast
+#   (apply the change and rebuild)
+#   util/sim_perf.py -o after.json -c before.json build/ARM/gem5.fast
+#
+# The long workloads need the SPEC binaries, found through
+# M5_TEST_PROGS as for the regressions, and are skipped without them.
+# With --perf every run is recorded with perf, so the host time can
+# be broken down by function afterwards.
+
+import json
+import optparse
+import os
+import platform
+import subprocess
+import sys
+import time
+
+progname = os.path.basename(sys.argv[0])
+tests_root = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                          os.pardir, 'tests')
+
+default_tests = 'quick/se/00.hello,' \
+                'long/se/10.mcf,' \
+                'long/se/20.parser,' \
+                'long/se/60.bzip2,' \
+                'long/se/70.twolf'
+
+default_configs = 'simple-atomic,' \
+                  'simple-timing,' \
+                  'simple-timing-ruby,' \
+                  'minor-timing,' \
+                  'o3-timing'
+
+optparser = optparse.OptionParser(usage='%prog [options] gem5-binary')
+add_option = optparser.add_option
+add_option('--tests', default=default_tests,
+           help="comma-separated workloads to run (default: '%default')")
+add_option('--configs', default=default_configs,
+           help="comma-separated configurations to run each workload " \
+           "with (default: '%default')")
+add_option('--isa', default='arm',
+           help="ISA of the workload binaries (default: '%default')")
+add_option('-r', '--repeat', type='int', default=1, metavar='N',
+           help='run each workload N times and keep the fastest')
+add_option('-d', '--out-dir', default='m5perf', metavar='DIR',
+           help="directory for the simulation output (default: '%default')")
+add_option('-o', '--output', default='sim_perf.json', metavar='FILE',
+           help="JSON file to write the results to (default: '%default')")
+add_option('-c', '--compare', default='', metavar='FILE',
+           help='JSON file of an earlier run to compare against')
+add_option('-t', '--threshold', type='float', default=5.0, metavar='PCT',
+           help='slowdown in percent that counts as a regression ' \
+           '(default: %default)')
+add_option('--perf', action='store_true', default=False,
+           help='record every run with perf in its output directory')
+
+(options, args) = optparser.parse_args()
+
+if len(args) != 1:
+    optparser.error('expecting the gem5 binary to run')
+
+gem5 = os.path.abspath(args[0])
+
+# split a comma-separated list, but return an empty list if given the
+# empty string
+def split_str(s):
+    if not s:
+        return []
+    return s.split(',')
+
+# statistics of the first dump that go in the results
+stat_names = ('host_seconds', 'sim_insts', 'sim_ops', 'sim_seconds')
+
+def read_stats(path):
+    stats = {}
+    try:
+        f = open(path)
+    except IOError:
+        return stats
+    for line in f:
+        if line.startswith('---------- End Simulation Statistics'):
+            break
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in stat_names:
+            stats[fields[0]] = float(fields[1])
+    f.close()
+    return stats
+
+def run(test, config):
+    # the regression script works out the workload and configuration
+    # from the last six components of the output directory
+    out_dir = os.path.join(options.out_dir, test, options.isa, 'linux',
+                           config)
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+
+    cmd = [ gem5, '-d', out_dir, '-re',
+            os.path.join(tests_root, 'run.py'), out_dir ]
+    if options.perf:
+        cmd = [ 'perf', 'record', '-g', '-o',
+                os.path.join(out_dir, 'perf.data') ] + cmd
+
+    start = time.time()
+    proc = subprocess.Popen(cmd)
+    (pid, status, usage) = os.wait4(proc.pid, 0)
+    wall = time.time() - start
+
+    result = { 'test' : test, 'config' : config }
+    code = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    if code == 2:
+        result['status'] = 'skipped'
+        return result
+    elif code != 0:
+        result['status'] = 'failed'
+        return result
+
+    stats = read_stats(os.path.join(out_dir, 'stats.txt'))
+    result['status'] = 'ok'
+    result['wall_seconds'] = wall
+    # the simulator's own measure leaves out the start up
+    result['host_seconds'] = stats.get('host_seconds', wall)
+    result['sim_insts'] = int(stats.get('sim_insts', 0))
+    result['sim_ops'] = int(stats.get('sim_ops', 0))
+    result['sim_seconds'] = stats.get('sim_seconds', 0.0)
+    result['mips'] = result['sim_insts'] / 1e6 / \
+                     max(result['host_seconds'], 1e-6)
+    # peak resident set size of the simulator in kB
+    result['host_mem_kb'] = usage.ru_maxrss
+    return result
+
+def git_revision():
+    try:
+        return subprocess.check_output(['git', 'rev-parse', 'HEAD'],
+                                       cwd=tests_root).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ''
+
+results = []
+for test in split_str(options.tests):
+    for config in split_str(options.configs):
+        best = None
+        for i in range(max(options.repeat, 1)):
+            result = run(test, config)
+            if result['status'] != 'ok':
+                best = result
+                break
+            if best is None or result['host_seconds'] < best['host_seconds']:
+                best = result
+        print "%s: %s/%s %s" % (progname, test, config, best['status'])
+        results.append(best)
+
+report = {
+    'gem5' : gem5,
+    'revision' : git_revision(),
+    'host' : platform.node(),
+    'date' : time.strftime('%Y-%m-%d %H:%M:%S'),
+    'results' : results,
+    }
+
+f = open(options.output, 'w')
+json.dump(report, f, indent=4, sort_keys=True)
+f.write('\n')
+f.close()
+
+if not options.compare:
+    sys.exit(0)
+
+f = open(options.compare)
+baseline = dict(((r['test'], r['config']), r)
+                for r in json.load(f)['results'] if r['status'] == 'ok')
+f.close()
+
+regressed = False
+print "%-32s %-24s %10s %10s %8s" % ('test', 'config', 'before', 'after',
+                                     'change')
+for r in results:
+    old = baseline.get((r['test'], r['config']))
+    if r['status'] != 'ok' or old is None:
+        continue
+    change = 100.0 * (r['host_seconds'] - old['host_seconds']) / \
+             max(old['host_seconds'], 1e-6)
+    flag = ''
+    if change > options.threshold:
+        flag = ' <--'
+        regressed = True
+    print "%-32s %-24s %9.2fs %9.2fs %+7.1f%%%s" % \
+          (r['test'], r['config'], old['host_seconds'], r['host_seconds'],
+           change, flag)
+
+sys.exit(1 if regressed else 0)
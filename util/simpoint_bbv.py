@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script reads the binary SimPoint basic block vectors written by
+# the SimPoint probe when its binary parameter is set (--simpoint-binary
+# in the example configs). The file may optionally be gzip compressed.
+# It can either be imported and used through read_bbvs(), which yields
+# one list of (basic block id, count) pairs per interval, or run to
+# convert a binary file into the text format expected by SimPoint 3.2:
+#   simpoint_bbv.py <binary BBV input> <text BBV output>
+#
+# The binary format is an 8 byte magic number ("gem5BBV" followed by a
+# format version of 1), followed by one record per interval. A record
+# is the number of basic blocks executed in the interval followed by
+# that many (id, count) pairs. All integers are 64-bit little endian.
+
+import gzip
+import struct
+import sys
+
+MAGIC = "gem5BBV\x01"
+
+def open_bbv(path):
+    """Open a binary BBV file, transparently handling compression."""
+    if path.endswith(".gz"):
+        return gzip.open(path, "rb")
+    return open(path, "rb")
+
+def read_bbvs(path):
+    """Yield the BBV of each interval as a list of (id, count) pairs."""
+    bbv_in = open_bbv(path)
+    if bbv_in.read(len(MAGIC)) != MAGIC:
+        raise ValueError("%s is not a binary BBV file" % path)
+
+    while True:
+        header = bbv_in.read(8)
+        if not header:
+            break
+        if len(header) != 8:
+            raise ValueError("%s: truncated interval record" % path)
+        num, = struct.unpack("<Q", header)
+        data = bbv_in.read(16 * num)
+        if len(data) != 16 * num:
+            raise ValueError("%s: truncated interval record" % path)
+        values = struct.unpack("<%dQ" % (2 * num), data)
+        yield zip(values[0::2], values[1::2])
+
+    bbv_in.close()
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: ", sys.argv[0], " <binary BBV input> <text BBV output>"
+        exit(-1)
+
+    try:
+        text_out = open(sys.argv[2], 'w')
+    except IOError:
+        print "Failed to open ", sys.argv[2], " for writing"
+        exit(-1)
+
+    for bbv in read_bbvs(sys.argv[1]):
+        text_out.write("T")
+        for bb_id, count in bbv:
+            text_out.write(":%d:%d " % (bb_id, count))
+        text_out.write("\n")
+
+    text_out.close()
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,223 @@
+#!/usr/bin/env python
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Reader for the time-series statistics written by gem5's --stats-columnar
+# (src/base/stats/columnar.hh describes the format).  As a module:
+#
+#   import stats_columnar
+#   run = stats_columnar.load('m5out/stats.cols')
+#   run.ticks                       # the tick of each dump
+#   run.values('system.cpu.ipc')    # one value per dump
+#   run.values('system.cpu.op_class', 'IntAlu')
+#   run.rows('system.cpu.op_class') # one array of the vector per dump
+#
+# and from the command line it lists the stats of a file or writes chosen
+# stats as CSV, one row per dump.  The shared stats.bin of --campaign-dir
+# (src/base/stats/campaign.hh) holds one single row file per dump, read
+# with load_campaign(), and is written as CSV with a tag column.
+
+import array
+import gzip
+import optparse
+import struct
+import sys
+from cStringIO import StringIO
+
+KINDS = ('scalar', 'vector', 'dist', 'vectordist', 'vector2d', 'formula',
+         'sparsehist')
+
+class Entry(object):
+    def __init__(self, name, kind, labels, offset):
+        self.name = name
+        self.kind = kind
+        self.labels = labels
+        # Index of the entry's first value in a row, after the tick
+        self.offset = offset
+
+class Run(object):
+    """The schema and values of one columnar stats file"""
+    def __init__(self, entries, row_width, data):
+        self.entries = entries
+        self.byName = dict((e.name, e) for e in entries)
+        self.rowWidth = row_width
+        self.data = data
+        self.stride = row_width + 1
+        self.numRows = len(data) / self.stride
+        self.ticks = [ long(t) for t in data[0::self.stride] ]
+
+    def names(self):
+        return [ e.name for e in self.entries ]
+
+    def entry(self, name):
+        if name not in self.byName:
+            raise KeyError("no stat %s" % name)
+        return self.byName[name]
+
+    def values(self, name, label=None):
+        """The value of a stat, or of one labelled element of it, at each
+        dump"""
+        e = self.entry(name)
+        index = 0
+        if label is not None:
+            index = e.labels.index(label)
+        start = 1 + e.offset + index
+        return self.data[start::self.stride]
+
+    def rows(self, name):
+        """All the values of a stat at each dump"""
+        e = self.entry(name)
+        width = len(e.labels)
+        return [ self.data[r * self.stride + 1 + e.offset:
+                           r * self.stride + 1 + e.offset + width]
+                 for r in xrange(self.numRows) ]
+
+def _open(filename):
+    if filename.endswith('.gz'):
+        return gzip.open(filename, 'rb')
+    return open(filename, 'rb')
+
+def _readString(f):
+    (length,) = struct.unpack('=I', f.read(4))
+    return f.read(length)
+
+def _parse(f, filename):
+    if f.read(8) != 'gem5cols':
+        raise IOError("%s is not a columnar stats file" % filename)
+
+    version, num_entries, row_width = struct.unpack('=III', f.read(12))
+    if version != 1:
+        raise IOError("%s has unknown version %d" % (filename, version))
+
+    entries = []
+    offset = 0
+    for i in xrange(num_entries):
+        name = _readString(f)
+        kind, width = struct.unpack('=BI', f.read(5))
+        labels = [ _readString(f) for j in xrange(width) ]
+        entries.append(Entry(name, KINDS[kind], labels, offset))
+        offset += width
+
+    # All the rows in one go
+    data = array.array('d')
+    data.fromstring(f.read())
+
+    # Drop a partly written last row
+    stride = row_width + 1
+    del data[len(data) - len(data) % stride:]
+
+    return Run(entries, row_width, data)
+
+def load(filename):
+    f = _open(filename)
+    run = _parse(f, filename)
+    f.close()
+    return run
+
+def is_campaign(filename):
+    f = _open(filename)
+    magic = f.read(8)
+    f.close()
+    return magic == 'gem5camp'
+
+def load_campaign(filename):
+    """The (tag, run) records of a campaign stats file, in the order
+    they were appended.  Each run holds the one dump of the record."""
+    f = _open(filename)
+    records = []
+    while True:
+        magic = f.read(8)
+        if not magic:
+            break
+        if magic != 'gem5camp':
+            raise IOError("%s: bad campaign record" % filename)
+        tag = _readString(f)
+        blob = _readString(f)
+        records.append((tag, _parse(StringIO(blob), filename)))
+    f.close()
+    return records
+
+def main():
+    parser = optparse.OptionParser(
+        usage="%prog [options] <columnar stats> [stat[:label]...]")
+    parser.add_option("--list", action="store_true", default=False,
+                      help="List the stats and their labels")
+    (options, args) = parser.parse_args()
+
+    if len(args) < 1:
+        parser.print_usage()
+        sys.exit(1)
+
+    if is_campaign(args[0]):
+        campaign_main(options, args)
+        return
+
+    run = load(args[0])
+
+    if options.list or len(args) == 1:
+        for e in run.entries:
+            print "%-60s %-10s %s" % (e.name, e.kind,
+                                      ' '.join(l for l in e.labels if l))
+        return
+
+    columns = []
+    for spec in args[1:]:
+        name, _, label = spec.partition(':')
+        e = run.entry(name)
+        labels = [ label ] if label else e.labels
+        for l in labels:
+            header = name + (':' + l if l else '')
+            columns.append((header, run.values(name, l)))
+
+    print ','.join(['tick'] + [ h for h, v in columns ])
+    for r in xrange(run.numRows):
+        print ','.join([ str(run.ticks[r]) ] +
+                       [ repr(v[r]) for h, v in columns ])
+
+def campaign_main(options, args):
+    records = load_campaign(args[0])
+
+    if options.list or len(args) == 1:
+        names = set()
+        for tag, run in records:
+            names.update(run.names())
+        for name in sorted(names):
+            print name
+        return
+
+    specs = [ spec.partition(':') for spec in args[1:] ]
+    print ','.join(['tag', 'tick'] + args[1:])
+    for tag, run in records:
+        row = [ '"%s"' % tag.replace('"', '""'), str(run.ticks[0]) ]
+        for name, _, label in specs:
+            if name in run.byName:
+                row.append(repr(run.values(name, label or None)[0]))
+            else:
+                row.append('')
+        print ','.join(row)
+
+if __name__ == "__main__":
+    main()